@@ -0,0 +1,229 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/*****************************************************************************
+ *
+ *  Filename:      a2dp_shm_ring.h
+ *
+ *  Description:   Shared-memory PCM ring between the A2DP audio HAL (writer)
+ *                 and the stack's A2DP source media task (reader).
+ *
+ *                 The ring lives in an anonymous memfd created by the HAL and
+ *                 handed to the stack over the A2DP control socket. Both
+ *                 sides map the same pages, so PCM crosses processes without
+ *                 the write+read copy pair of the UIPC data socket. The
+ *                 layout is a single-producer/single-consumer byte ring with
+ *                 free-running 32-bit positions; the writer blocks on a futex
+ *                 when the ring is full and the reader wakes it after
+ *                 consuming.
+ *
+ *                 Header-only so both the HAL library and the stack can use
+ *                 it without a shared build target.
+ *
+ *****************************************************************************/
+
+#ifndef A2DP_SHM_RING_H
+#define A2DP_SHM_RING_H
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <linux/memfd.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+
+#define A2DP_SHM_RING_MAGIC 0x52506d68 /* 'hmPR' */
+#define A2DP_SHM_RING_VERSION 1
+
+/* Control block at the start of the shared mapping; PCM data follows. */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t data_size; /* Bytes of PCM area following this header */
+  /* Free-running byte counters; used = write_pos - read_pos. */
+  std::atomic<uint32_t> write_pos;
+  std::atomic<uint32_t> read_pos;
+  /* Bumped by the reader after consuming; futex word the writer waits on. */
+  std::atomic<uint32_t> space_seq;
+} a2dp_shm_ring_hdr_t;
+
+/* Per-process view of a mapped ring. */
+typedef struct {
+  a2dp_shm_ring_hdr_t* hdr;
+  uint8_t* data;
+  size_t map_size;
+} a2dp_shm_ring_t;
+
+static inline int a2dp_shm_ring_futex(std::atomic<uint32_t>* word, int op,
+                                      uint32_t value,
+                                      const struct timespec* timeout) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value,
+                 timeout, NULL, 0);
+}
+
+/*
+ * Create the backing memfd for a ring with |data_size| bytes of PCM storage.
+ * Returns the file descriptor, or -1 on failure.
+ */
+static inline int a2dp_shm_ring_create(uint32_t data_size) {
+  int fd = syscall(SYS_memfd_create, "a2dp-pcm-ring", MFD_CLOEXEC);
+  if (fd < 0) return -1;
+  if (ftruncate(fd, sizeof(a2dp_shm_ring_hdr_t) + data_size) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/*
+ * Map the ring backed by |fd|. The creating side passes |initialize| true to
+ * set up the control block; the attaching side passes false and the header
+ * is validated against the mapping. The caller keeps ownership of |fd| and
+ * may close it once this returns; the mapping stays valid.
+ * Returns NULL on failure.
+ */
+static inline a2dp_shm_ring_t* a2dp_shm_ring_attach(int fd, bool initialize) {
+  struct stat st;
+  if (fstat(fd, &st) != 0) return NULL;
+  size_t map_size = st.st_size;
+  if (map_size <= sizeof(a2dp_shm_ring_hdr_t)) return NULL;
+
+  void* base =
+      mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) return NULL;
+
+  a2dp_shm_ring_hdr_t* hdr = static_cast<a2dp_shm_ring_hdr_t*>(base);
+  if (initialize) {
+    memset(base, 0, sizeof(*hdr));
+    hdr->data_size = map_size - sizeof(*hdr);
+    hdr->version = A2DP_SHM_RING_VERSION;
+    hdr->magic = A2DP_SHM_RING_MAGIC;
+  } else if (hdr->magic != A2DP_SHM_RING_MAGIC ||
+             hdr->version != A2DP_SHM_RING_VERSION ||
+             hdr->data_size != map_size - sizeof(*hdr)) {
+    munmap(base, map_size);
+    return NULL;
+  }
+
+  a2dp_shm_ring_t* ring =
+      static_cast<a2dp_shm_ring_t*>(calloc(1, sizeof(a2dp_shm_ring_t)));
+  if (ring == NULL) {
+    munmap(base, map_size);
+    return NULL;
+  }
+  ring->hdr = hdr;
+  ring->data = static_cast<uint8_t*>(base) + sizeof(*hdr);
+  ring->map_size = map_size;
+  return ring;
+}
+
+/*
+ * Unmap |ring| and free the local view. The shared pages stay alive for the
+ * other side until it detaches too.
+ */
+static inline void a2dp_shm_ring_detach(a2dp_shm_ring_t* ring) {
+  if (ring == NULL) return;
+  munmap(ring->hdr, ring->map_size);
+  free(ring);
+}
+
+static inline void a2dp_shm_ring_copy_in(a2dp_shm_ring_t* ring, uint32_t pos,
+                                         const uint8_t* src, uint32_t length) {
+  uint32_t offset = pos % ring->hdr->data_size;
+  uint32_t tail_room = ring->hdr->data_size - offset;
+  if (length <= tail_room) {
+    memcpy(ring->data + offset, src, length);
+  } else {
+    memcpy(ring->data + offset, src, tail_room);
+    memcpy(ring->data, src + tail_room, length - tail_room);
+  }
+}
+
+static inline void a2dp_shm_ring_copy_out(a2dp_shm_ring_t* ring, uint32_t pos,
+                                          uint8_t* dst, uint32_t length) {
+  uint32_t offset = pos % ring->hdr->data_size;
+  uint32_t tail_room = ring->hdr->data_size - offset;
+  if (length <= tail_room) {
+    memcpy(dst, ring->data + offset, length);
+  } else {
+    memcpy(dst, ring->data + offset, tail_room);
+    memcpy(dst + tail_room, ring->data, length - tail_room);
+  }
+}
+
+/*
+ * Write |length| bytes into the ring, blocking on the futex while the ring
+ * is full, up to |timeout_ms| in total. Returns the number of bytes written,
+ * which is less than |length| only on timeout.
+ */
+static inline uint32_t a2dp_shm_ring_write(a2dp_shm_ring_t* ring,
+                                           const uint8_t* src, uint32_t length,
+                                           int timeout_ms) {
+  a2dp_shm_ring_hdr_t* hdr = ring->hdr;
+  uint32_t written = 0;
+  while (written < length) {
+    uint32_t space_seq = hdr->space_seq.load(std::memory_order_relaxed);
+    uint32_t write_pos = hdr->write_pos.load(std::memory_order_relaxed);
+    uint32_t used = write_pos - hdr->read_pos.load(std::memory_order_acquire);
+    uint32_t free_space = hdr->data_size - used;
+    if (free_space == 0) {
+      if (timeout_ms <= 0) break;
+      /* Wait in bounded slices so a vanished reader cannot block forever. */
+      int slice_ms = timeout_ms < 100 ? timeout_ms : 100;
+      struct timespec timeout = {slice_ms / 1000,
+                                 (slice_ms % 1000) * 1000000L};
+      a2dp_shm_ring_futex(&hdr->space_seq, FUTEX_WAIT, space_seq, &timeout);
+      timeout_ms -= slice_ms;
+      continue;
+    }
+    uint32_t chunk = length - written;
+    if (chunk > free_space) chunk = free_space;
+    a2dp_shm_ring_copy_in(ring, write_pos, src + written, chunk);
+    hdr->write_pos.store(write_pos + chunk, std::memory_order_release);
+    written += chunk;
+  }
+  return written;
+}
+
+/*
+ * Read up to |length| bytes from the ring without blocking and wake a writer
+ * waiting for space. Returns the number of bytes read; 0 when the ring is
+ * empty.
+ */
+static inline uint32_t a2dp_shm_ring_read(a2dp_shm_ring_t* ring, uint8_t* dst,
+                                          uint32_t length) {
+  a2dp_shm_ring_hdr_t* hdr = ring->hdr;
+  uint32_t read_pos = hdr->read_pos.load(std::memory_order_relaxed);
+  uint32_t used = hdr->write_pos.load(std::memory_order_acquire) - read_pos;
+  if (used == 0) return 0;
+  uint32_t chunk = length < used ? length : used;
+  a2dp_shm_ring_copy_out(ring, read_pos, dst, chunk);
+  hdr->read_pos.store(read_pos + chunk, std::memory_order_release);
+  hdr->space_seq.fetch_add(1, std::memory_order_release);
+  a2dp_shm_ring_futex(&hdr->space_seq, FUTEX_WAKE, 1, NULL);
+  return chunk;
+}
+
+#endif /* A2DP_SHM_RING_H */
@@ -88,6 +88,7 @@ typedef enum {
   A2DP_CTRL_CMD_OFFLOAD_START,
   A2DP_CTRL_GET_PRESENTATION_POSITION,
   A2DP_CTRL_CMD_STREAM_OPEN,
+  A2DP_CTRL_CMD_OPEN_SHM_RING,
 } tA2DP_CTRL_CMD;
 
 typedef enum {
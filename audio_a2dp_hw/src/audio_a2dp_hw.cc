@@ -49,6 +49,7 @@
 #include "osi/include/properties.h"
 #include "osi/include/socket_utils/sockets.h"
 
+#include "a2dp_shm_ring.h"
 #include "audio_a2dp_hw.h"
 
 static char a2dp_hal_imp[PROPERTY_VALUE_MAX] = "false";
@@ -125,6 +126,9 @@ struct a2dp_stream_common {
   std::recursive_mutex* mutex;  // See note below on mutex acquisition order.
   int ctrl_fd;
   int audio_fd;
+  /* Shared-memory PCM ring negotiated with the stack; NULL when the stream
+   * falls back to writing PCM over the audio_fd socket. */
+  a2dp_shm_ring_t* shm_ring;
   size_t buffer_sz;
   struct a2dp_config cfg;
   a2dp_state_t state;
@@ -442,6 +446,35 @@ static int a2dp_ctrl_send(struct a2dp_stream_common* common, const void* buffer,
   return length;
 }
 
+// Sends file descriptor |fd| for stream |common| over the control channel
+// as SCM_RIGHTS ancillary data. On success returns 0, otherwise -1.
+static int a2dp_ctrl_send_fd(struct a2dp_stream_common* common, int fd) {
+  char payload = 0;
+  struct iovec iov = {&payload, sizeof(payload)};
+  char cmsg_buf[CMSG_SPACE(sizeof(int))] = {};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = cmsg_buf;
+  msg.msg_controllen = sizeof(cmsg_buf);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+  ssize_t sent;
+  OSI_NO_INTR(sent = sendmsg(common->ctrl_fd, &msg, MSG_NOSIGNAL));
+  if (sent <= 0) {
+    ERROR("send fd failed: error(%s)", strerror(errno));
+    skt_disconnect(common->ctrl_fd);
+    common->ctrl_fd = AUDIO_SKT_DISCONNECTED;
+    return -1;
+  }
+  return 0;
+}
+
 static int a2dp_command(struct a2dp_stream_common* common, tA2DP_CTRL_CMD cmd) {
   char ack;
 
@@ -897,6 +930,7 @@ static void a2dp_stream_common_init(struct a2dp_stream_common* common) {
 
   common->ctrl_fd = AUDIO_SKT_DISCONNECTED;
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  common->shm_ring = NULL;
   common->state = AUDIO_A2DP_STATE_STOPPED;
 
   /* manages max capacity of socket pipe */
@@ -910,6 +944,59 @@ static void a2dp_stream_common_destroy(struct a2dp_stream_common* common) {
   common->mutex = NULL;
 }
 
+/* Negotiate the shared-memory PCM ring with the stack. The HAL creates the
+ * memfd, passes it over the control channel and waits for the stack to map
+ * it. Any failure leaves common->shm_ring NULL and the stream keeps using
+ * the audio_fd socket; the stream works either way. */
+static void a2dp_setup_shm_ring(struct a2dp_stream_common* common) {
+  if (common->shm_ring != NULL) return;
+
+  if (a2dp_command(common, A2DP_CTRL_CMD_OPEN_SHM_RING) != 0) {
+    INFO("stack declined shared-memory ring, using socket data path");
+    return;
+  }
+
+  /* Same headroom as the socket pipe: buffer_sz covers
+   * AUDIO_STREAM_OUTPUT_BUFFER_PERIODS write periods. */
+  uint32_t data_size = common->buffer_sz;
+  int fd = a2dp_shm_ring_create(data_size);
+  if (fd < 0) {
+    ERROR("failed to create shared-memory ring (%s)", strerror(errno));
+    data_size = 0;
+    a2dp_ctrl_send(common, &data_size, sizeof(data_size));
+    return;
+  }
+
+  a2dp_shm_ring_t* ring = a2dp_shm_ring_attach(fd, true /* initialize */);
+  if (ring == NULL) {
+    ERROR("failed to map shared-memory ring (%s)", strerror(errno));
+    close(fd);
+    data_size = 0;
+    a2dp_ctrl_send(common, &data_size, sizeof(data_size));
+    return;
+  }
+
+  char result = 0;
+  if (a2dp_ctrl_send(common, &data_size, sizeof(data_size)) < 0 ||
+      a2dp_ctrl_send_fd(common, fd) < 0 ||
+      a2dp_ctrl_receive(common, &result, sizeof(result)) < 0 || result == 0) {
+    ERROR("shared-memory ring handshake failed, using socket data path");
+    close(fd);
+    a2dp_shm_ring_detach(ring);
+    return;
+  }
+  close(fd);
+
+  common->shm_ring = ring;
+  INFO("shared-memory ring established (sz %u)", data_size);
+}
+
+static void a2dp_teardown_shm_ring(struct a2dp_stream_common* common) {
+  if (common->shm_ring == NULL) return;
+  a2dp_shm_ring_detach(common->shm_ring);
+  common->shm_ring = NULL;
+}
+
 static int start_audio_datapath(struct a2dp_stream_common* common) {
   INFO("state %d", common->state);
 
@@ -978,6 +1065,7 @@ static int stop_audio_datapath(struct a2dp_stream_common* common) {
   common->state = (a2dp_state_t)AUDIO_A2DP_STATE_STOPPED;
 
   /* disconnect audio path */
+  a2dp_teardown_shm_ring(common);
   skt_disconnect(common->audio_fd);
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
 
@@ -998,6 +1086,7 @@ static int suspend_audio_datapath(struct a2dp_stream_common* common,
     common->state = AUDIO_A2DP_STATE_SUSPENDED;
 
   /* disconnect audio path */
+  a2dp_teardown_shm_ring(common);
   skt_disconnect(common->audio_fd);
 
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
@@ -1032,6 +1121,9 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
     if (start_audio_datapath(&out->common) < 0) {
       goto finish;
     }
+    /* Output only: the stack reads PCM from the ring in place of the data
+     * socket. Input streams keep reading from their socket. */
+    a2dp_setup_shm_ring(&out->common);
   } else if (out->common.state != AUDIO_A2DP_STATE_STARTED) {
     ERROR("stream not in stopped or standby");
     goto finish;
@@ -1051,7 +1143,15 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
   }
 
   lock.unlock();
-  sent = skt_write(out->common.audio_fd, buffer, write_bytes);
+  if (out->common.shm_ring != NULL) {
+    uint32_t written =
+        a2dp_shm_ring_write(out->common.shm_ring, (const uint8_t*)buffer,
+                            write_bytes, SOCK_SEND_TIMEOUT_MS);
+    sent = (written == write_bytes) ? (int)written : -1;
+    if (sent == -1) WARN("ring write timeout, wrote %u bytes", written);
+  } else {
+    sent = skt_write(out->common.audio_fd, buffer, write_bytes);
+  }
   lock.lock();
 
   if (sent == -1) {
@@ -1061,6 +1161,7 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
       ERROR("ignore data write failure");
     }
 
+    a2dp_teardown_shm_ring(&out->common);
     skt_disconnect(out->common.audio_fd);
     out->common.audio_fd = AUDIO_SKT_DISCONNECTED;
     if ((out->common.state != AUDIO_A2DP_STATE_SUSPENDED) &&
@@ -402,6 +402,9 @@ bool init(bluetooth::common::MessageLoopThread* message_loop) {
 void cleanup() {
   if (!is_hal_2_0_enabled()) return;
   end_session();
+  // The client interfaces are deleted below; no session call may remain in
+  // flight on the session thread when they go away.
+  BluetoothAudioSinkClientInterface::DrainSessionThread();
 
   auto a2dp_sink = active_hal_interface->GetTransportInstance();
   static_cast<A2dpTransport*>(a2dp_sink)->ResetPendingCmd();
@@ -460,12 +463,29 @@ bool setup_codec() {
   return active_hal_interface->UpdateAudioConfig(audio_config);
 }
 
+static void on_session_start_complete(int status) {
+  if (status != 0) {
+    LOG(ERROR) << __func__ << ": cannot start audio session, status="
+               << status;
+  }
+}
+
+static void on_session_end_complete(int status) {
+  if (status != 0) {
+    LOG(ERROR) << __func__ << ": cannot end audio session, status="
+               << status;
+  }
+}
+
 void start_session() {
   if (!is_hal_2_0_enabled()) {
     LOG(ERROR) << __func__ << ": BluetoothAudio HAL is not enabled";
     return;
   }
-  active_hal_interface->StartSession();
+  // The blocking startSession() call runs on the audio session thread;
+  // its result comes back as an event instead of stalling the caller.
+  active_hal_interface->StartSessionAsync(
+      base::BindOnce(on_session_start_complete));
 }
 
 void end_session() {
@@ -473,7 +493,8 @@ void end_session() {
     LOG(ERROR) << __func__ << ": BluetoothAudio HAL is not enabled";
     return;
   }
-  active_hal_interface->EndSession();
+  active_hal_interface->EndSessionAsync(
+      base::BindOnce(on_session_end_complete));
   static_cast<A2dpTransport*>(active_hal_interface->GetTransportInstance())
       ->ResetPendingCmd();
   static_cast<A2dpTransport*>(active_hal_interface->GetTransportInstance())
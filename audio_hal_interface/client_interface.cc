@@ -40,6 +40,16 @@ using ::bluetooth::common::StopWatchLegacy;
 using DataMQ = ::android::hardware::MessageQueue<
     uint8_t, ::android::hardware::kSynchronizedReadWrite>;
 
+// All asynchronous session calls run on this dedicated thread so that a
+// blocking startSession() / endSession() transaction can never stall the
+// thread that requested it.
+static common::MessageLoopThread* get_session_thread() {
+  static common::MessageLoopThread session_thread("bt_audio_session");
+  static std::once_flag started;
+  std::call_once(started, []() { session_thread.StartUp(); });
+  return &session_thread;
+}
+
 static constexpr int kDefaultDataReadTimeoutMs = 10;      // 10 ms
 static constexpr int kDefaultDataWriteTimeoutMs = 10;     // 10 ms
 static constexpr int kDefaultDataReadPollIntervalMs = 1;  // non-blocking poll
@@ -744,6 +754,46 @@ int BluetoothAudioClientInterface::EndSession() {
   return 0;
 }
 
+void BluetoothAudioClientInterface::StartSessionAsync(
+    SessionResultCallback result_cb) {
+  get_session_thread()->DoInThread(
+      FROM_HERE,
+      base::BindOnce(
+          [](BluetoothAudioClientInterface* client_interface,
+             SessionResultCallback result_cb) {
+            int status = client_interface->StartSession();
+            if (result_cb) std::move(result_cb).Run(status);
+          },
+          base::Unretained(this), std::move(result_cb)));
+}
+
+void BluetoothAudioClientInterface::EndSessionAsync(
+    SessionResultCallback result_cb) {
+  get_session_thread()->DoInThread(
+      FROM_HERE,
+      base::BindOnce(
+          [](BluetoothAudioClientInterface* client_interface,
+             SessionResultCallback result_cb) {
+            int status = client_interface->EndSession();
+            if (result_cb) std::move(result_cb).Run(status);
+          },
+          base::Unretained(this), std::move(result_cb)));
+}
+
+void BluetoothAudioClientInterface::DrainSessionThread() {
+  std::promise<void> drained;
+  auto drained_future = drained.get_future();
+  if (!get_session_thread()->DoInThread(
+          FROM_HERE,
+          base::BindOnce(
+              [](std::promise<void> drained) { drained.set_value(); },
+              std::move(drained)))) {
+    LOG(ERROR) << __func__ << ": session thread is not running";
+    return;
+  }
+  drained_future.wait();
+}
+
 void BluetoothAudioClientInterface::FlushAudioData() {
   size_t size = mDataMQ->availableToRead();
   uint8_t p_buf[size];
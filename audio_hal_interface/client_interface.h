@@ -213,6 +213,24 @@ class BluetoothAudioClientInterface {
 
   int EndSession();
 
+  // Carries the result of an asynchronous session call; |status| is the
+  // value the matching synchronous call would have returned. Invoked on the
+  // dedicated session thread.
+  using SessionResultCallback = base::OnceCallback<void(int status)>;
+
+  // Same as StartSession() / EndSession(), but the blocking HIDL
+  // transaction runs on a dedicated session thread so a laggy audio HAL
+  // cannot stall the calling thread. Calls posted through these entry
+  // points are executed in order. |result_cb| may be null when the caller
+  // does not care about the result.
+  void StartSessionAsync(SessionResultCallback result_cb);
+  void EndSessionAsync(SessionResultCallback result_cb);
+
+  // Blocks until every asynchronous session call posted so far has
+  // finished. Must be called before deleting a client interface that may
+  // still have calls in flight.
+  static void DrainSessionThread();
+
   bool UpdateAudioConfig(const AudioConfiguration& audioConfig);
   bool UpdateAudioConfig_2_1(const AudioConfiguration_2_1& audioConfig_2_1);
 
@@ -368,6 +368,7 @@ void bta_ag_rfc_close(tBTA_AG_SCB* p_scb,
   /* Clear these flags upon SLC teardown */
   p_scb->codec_updated = false;
   p_scb->codec_fallback = false;
+  p_scb->codec_cache_reused = false;
   p_scb->codec_msbc_settings = BTA_AG_SCO_MSBC_SETTINGS_T2;
   p_scb->role = 0;
   p_scb->post_sco = BTA_AG_POST_SCO_NONE;
@@ -24,6 +24,7 @@
 #define LOG_TAG "bta_ag_at"
 
 #include <cstdint>
+#include <cstring>
 
 #include "bt_target.h"  // Must be first to define build configuration:
 
@@ -37,6 +38,91 @@
  *  Constants
  ****************************************************************************/
 
+/* Number of dispatch buckets: 'A'-'Z' for basic commands plus 'A'-'Z' for
+ * the character following the '+' in extended commands */
+#define BTA_AG_AT_IDX_BUCKETS 52
+
+/* Largest command table the dispatch index can hold */
+#define BTA_AG_AT_IDX_MAX_CMDS 64
+
+/* Empty bucket / end-of-chain marker */
+#define BTA_AG_AT_IDX_NONE 0xFF
+
+/* First-character dispatch index over one AT command table. Extended
+ * commands ("+XXX") are keyed by the character after the '+' so the dense
+ * "+B" and "+C" HFP groups do not all land in a single '+' bucket.
+ * Entries within a bucket keep their table order and entries in different
+ * buckets can never match the same input, so a lookup finds exactly the
+ * entry the former full-table walk would have found. */
+typedef struct {
+  const tBTA_AG_AT_CMD* p_tbl; /* table this index was built for */
+  uint8_t num_cmds;            /* index of the end-of-table marker */
+  uint8_t head[BTA_AG_AT_IDX_BUCKETS];
+  uint8_t next[BTA_AG_AT_IDX_MAX_CMDS];
+} tBTA_AG_AT_IDX;
+
+/* One cached index per parser table (HSP and HFP) */
+static tBTA_AG_AT_IDX bta_ag_at_idx_cache[2];
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_at_idx_key
+ *
+ * Description      Map a command string (or unparsed input) to its dispatch
+ *                  bucket, derived from the first character, or the second
+ *                  one for extended "+XXX" commands.
+ *
+ * Returns          Bucket number, or -1 if the string cannot match any
+ *                  command table entry.
+ *
+ ******************************************************************************/
+static int bta_ag_at_idx_key(const char* p_cmd) {
+  char c = (p_cmd[0] == '+') ? p_cmd[1] : p_cmd[0];
+  if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+  if (c < 'A' || c > 'Z') return -1;
+  return (c - 'A') + ((p_cmd[0] == '+') ? 26 : 0);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_at_idx_get
+ *
+ * Description      Return the dispatch index for a command table, building
+ *                  and caching it on first use.
+ *
+ * Returns          Pointer to the index, or NULL if the table cannot be
+ *                  indexed (caller falls back to the full table walk).
+ *
+ ******************************************************************************/
+static const tBTA_AG_AT_IDX* bta_ag_at_idx_get(const tBTA_AG_AT_CMD* p_tbl) {
+  tBTA_AG_AT_IDX* p_idx = nullptr;
+  for (tBTA_AG_AT_IDX& idx : bta_ag_at_idx_cache) {
+    if (idx.p_tbl == p_tbl) return &idx;
+    if (idx.p_tbl == nullptr && p_idx == nullptr) p_idx = &idx;
+  }
+  if (p_idx == nullptr) return nullptr;
+
+  uint8_t tail[BTA_AG_AT_IDX_BUCKETS];
+  memset(p_idx->head, BTA_AG_AT_IDX_NONE, sizeof(p_idx->head));
+  memset(p_idx->next, BTA_AG_AT_IDX_NONE, sizeof(p_idx->next));
+  memset(tail, BTA_AG_AT_IDX_NONE, sizeof(tail));
+
+  uint16_t i;
+  for (i = 0; p_tbl[i].p_cmd[0] != 0; i++) {
+    int key = bta_ag_at_idx_key(p_tbl[i].p_cmd);
+    if (i >= BTA_AG_AT_IDX_MAX_CMDS || key < 0) return nullptr;
+    if (p_idx->head[key] == BTA_AG_AT_IDX_NONE) {
+      p_idx->head[key] = i;
+    } else {
+      p_idx->next[tail[key]] = i;
+    }
+    tail[key] = i;
+  }
+  p_idx->num_cmds = i;
+  p_idx->p_tbl = p_tbl;
+  return p_idx;
+}
+
 /******************************************************************************
  *
  * Function         bta_ag_at_init
@@ -86,10 +172,27 @@ void bta_ag_process_at(tBTA_AG_AT_CB* p_cb, char* p_end) {
   uint8_t arg_type;
   char* p_arg;
   int16_t int_arg = 0;
-  /* loop through at command table looking for match */
-  for (idx = 0; p_cb->p_at_tbl[idx].p_cmd[0] != 0; idx++) {
-    if (!utl_strucmp(p_cb->p_at_tbl[idx].p_cmd, p_cb->p_cmd_buf)) {
-      break;
+  /* look the command up through the first-character dispatch index; fall
+   * back to the full table walk if the table cannot be indexed */
+  const tBTA_AG_AT_IDX* p_idx = bta_ag_at_idx_get(p_cb->p_at_tbl);
+  if (p_idx != nullptr) {
+    int key = bta_ag_at_idx_key(p_cb->p_cmd_buf);
+    idx = p_idx->num_cmds;
+    if (key >= 0) {
+      for (uint8_t i = p_idx->head[key]; i != BTA_AG_AT_IDX_NONE;
+           i = p_idx->next[i]) {
+        if (!utl_strucmp(p_cb->p_at_tbl[i].p_cmd, p_cb->p_cmd_buf)) {
+          idx = i;
+          break;
+        }
+      }
+    }
+  } else {
+    /* loop through at command table looking for match */
+    for (idx = 0; p_cb->p_at_tbl[idx].p_cmd[0] != 0; idx++) {
+      if (!utl_strucmp(p_cb->p_at_tbl[idx].p_cmd, p_cb->p_cmd_buf)) {
+        break;
+      }
     }
   }
 
@@ -177,7 +280,7 @@ void bta_ag_process_at(tBTA_AG_AT_CB* p_cb, char* p_end) {
  *
  *****************************************************************************/
 void bta_ag_at_parse(tBTA_AG_AT_CB* p_cb, char* p_buf, uint16_t len) {
-  int i = 0;
+  size_t i = 0;
   char* p_save;
 
   if (p_cb->p_cmd_buf == nullptr) {
@@ -185,40 +288,65 @@ void bta_ag_at_parse(tBTA_AG_AT_CB* p_cb, char* p_buf, uint16_t len) {
     p_cb->cmd_pos = 0;
   }
 
-  for (i = 0; i < len;) {
-    while (p_cb->cmd_pos < p_cb->cmd_max_len - 1 && i < len) {
-      /* Skip null characters between AT commands. */
-      if ((p_cb->cmd_pos == 0) && (p_buf[i] == 0)) {
-        i++;
-        continue;
+  while (i < len) {
+    /* Skip null characters between AT commands. */
+    if (p_cb->cmd_pos == 0) {
+      while (i < len && p_buf[i] == 0) i++;
+      if (i == len) break;
+    }
+
+    /* Find the nearest delimiter in the unread input with memchr rather
+     * than inspecting the stream one byte at a time; each search is
+     * bounded by the previous find, so the closest one wins. */
+    static const char delims[] = {'\r', '\n', 0x1A, 0x1B};
+    size_t delim_off = len - i;
+    char delim = 0;
+    for (char d : delims) {
+      const char* p = (const char*)memchr(p_buf + i, d, delim_off);
+      if (p != nullptr) {
+        delim_off = p - (p_buf + i);
+        delim = d;
       }
+    }
 
-      p_cb->p_cmd_buf[p_cb->cmd_pos] = p_buf[i++];
-      if (p_cb->p_cmd_buf[p_cb->cmd_pos] == '\r' ||
-          p_cb->p_cmd_buf[p_cb->cmd_pos] == '\n') {
-        p_cb->p_cmd_buf[p_cb->cmd_pos] = 0;
-        if ((p_cb->cmd_pos > 2) &&
-            (p_cb->p_cmd_buf[0] == 'A' || p_cb->p_cmd_buf[0] == 'a') &&
-            (p_cb->p_cmd_buf[1] == 'T' || p_cb->p_cmd_buf[1] == 't')) {
-          p_save = p_cb->p_cmd_buf;
-          char* p_end = p_cb->p_cmd_buf + p_cb->cmd_pos;
-          p_cb->p_cmd_buf += 2;
-          bta_ag_process_at(p_cb, p_end);
-          p_cb->p_cmd_buf = p_save;
-        }
+    /* Copy everything up to the delimiter in one pass, bounded by the
+     * space left in the command buffer. */
+    size_t space = (size_t)(p_cb->cmd_max_len - 1) - p_cb->cmd_pos;
+    size_t copy_n = (delim_off < space) ? delim_off : space;
+    memcpy(p_cb->p_cmd_buf + p_cb->cmd_pos, p_buf + i, copy_n);
+    p_cb->cmd_pos += copy_n;
+    i += copy_n;
 
-        p_cb->cmd_pos = 0;
+    if (copy_n < delim_off || delim == 0 ||
+        p_cb->cmd_pos >= p_cb->cmd_max_len - 1) {
+      /* Either the command buffer filled up before a delimiter (discard
+       * the oversized fragment, as before), or the input ran out with a
+       * command still in flight. */
+      if (i < len) p_cb->cmd_pos = 0;
+      continue;
+    }
 
-      } else if (p_cb->p_cmd_buf[p_cb->cmd_pos] == 0x1A ||
-                 p_cb->p_cmd_buf[p_cb->cmd_pos] == 0x1B) {
-        p_cb->p_cmd_buf[++p_cb->cmd_pos] = 0;
-        (*p_cb->p_err_cback)((tBTA_AG_SCB*)p_cb->p_user, true, p_cb->p_cmd_buf);
-        p_cb->cmd_pos = 0;
-      } else {
-        ++p_cb->cmd_pos;
+    /* Consume the delimiter */
+    i++;
+    if (delim == '\r' || delim == '\n') {
+      p_cb->p_cmd_buf[p_cb->cmd_pos] = 0;
+      if ((p_cb->cmd_pos > 2) &&
+          (p_cb->p_cmd_buf[0] == 'A' || p_cb->p_cmd_buf[0] == 'a') &&
+          (p_cb->p_cmd_buf[1] == 'T' || p_cb->p_cmd_buf[1] == 't')) {
+        p_save = p_cb->p_cmd_buf;
+        char* p_end = p_cb->p_cmd_buf + p_cb->cmd_pos;
+        p_cb->p_cmd_buf += 2;
+        bta_ag_process_at(p_cb, p_end);
+        p_cb->p_cmd_buf = p_save;
       }
-    }
 
-    if (i < len) p_cb->cmd_pos = 0;
+      p_cb->cmd_pos = 0;
+    } else {
+      /* 0x1A/0x1B: hand the terminated fragment to the error callback */
+      p_cb->p_cmd_buf[p_cb->cmd_pos] = delim;
+      p_cb->p_cmd_buf[++p_cb->cmd_pos] = 0;
+      (*p_cb->p_err_cback)((tBTA_AG_SCB*)p_cb->p_user, true, p_cb->p_cmd_buf);
+      p_cb->cmd_pos = 0;
+    }
   }
 }
@@ -29,6 +29,7 @@
 #include "bt_trace.h"   // Legacy trace logging
 
 #include "bta/ag/bta_ag_int.h"
+#include "btif/include/btif_config.h"
 #include "device/include/controller.h"
 #include "device/include/esco_parameters.h"
 #include "main/shim/dumpsys.h"
@@ -110,6 +111,7 @@ bool bta_ag_sco_is_active_device(const RawAddress& bd_addr) {
 }
 
 static void bta_ag_create_pending_sco(tBTA_AG_SCB* p_scb, bool is_local);
+static void bta_ag_cached_codec_remove(const RawAddress& addr);
 
 /*******************************************************************************
  *
@@ -196,6 +198,13 @@ static void bta_ag_sco_disc_cback(uint16_t sco_idx) {
        * 'Safe setting' first. If T1 also fails, try CVSD */
       if (bta_ag_sco_is_opening(bta_ag_cb.sco.p_curr_scb)) {
         bta_ag_cb.sco.p_curr_scb->state = BTA_AG_SCO_CODEC_ST;
+        if (bta_ag_cb.sco.p_curr_scb->codec_cache_reused) {
+          /* The cached codec did not take; drop it so the retry goes
+           * through the full AT+BCS exchange again. */
+          bta_ag_cb.sco.p_curr_scb->codec_cache_reused = false;
+          bta_ag_cached_codec_remove(bta_ag_cb.sco.p_curr_scb->peer_addr);
+          bta_ag_cb.sco.p_curr_scb->codec_updated = true;
+        }
         if (bta_ag_cb.sco.p_curr_scb->codec_msbc_settings ==
             BTA_AG_SCO_MSBC_SETTINGS_T2) {
           APPL_TRACE_WARNING(
@@ -540,6 +549,61 @@ static void bta_ag_codec_negotiation_timer_cback(void* data) {
   bta_ag_cback_sco(p_scb, BTA_AG_AUDIO_CLOSE_EVT);
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_ag_cached_codec_get
+ *
+ * Description      Read the codec the peer accepted on a previous service
+ *                  level connection, persisted through btif_config.
+ *
+ * Returns          Cached codec, or BTA_AG_CODEC_NONE if none stored.
+ *
+ ******************************************************************************/
+static tBTA_AG_PEER_CODEC bta_ag_cached_codec_get(const RawAddress& addr) {
+  int codec = BTA_AG_CODEC_NONE;
+  if (!btif_config_get_int(addr.ToString(), HFP_NEGOTIATED_CODEC_CONFIG_KEY,
+                           &codec)) {
+    return BTA_AG_CODEC_NONE;
+  }
+  return static_cast<tBTA_AG_PEER_CODEC>(codec);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_cached_codec_store
+ *
+ * Description      Persist the codec in use after audio came up, so the next
+ *                  service level connection can skip the AT+BCS exchange.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_ag_cached_codec_store(const RawAddress& addr,
+                                      tBTA_AG_PEER_CODEC codec) {
+  if (bta_ag_cached_codec_get(addr) == codec) return;
+  if (btif_config_set_int(addr.ToString(), HFP_NEGOTIATED_CODEC_CONFIG_KEY,
+                          codec)) {
+    btif_config_save();
+  } else {
+    APPL_TRACE_WARNING("%s: Failed to store negotiated codec for %s", __func__,
+                       addr.ToString().c_str());
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_cached_codec_remove
+ *
+ * Description      Drop the persisted codec after a failed eSCO attempt that
+ *                  reused it, forcing full renegotiation on the retry.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_ag_cached_codec_remove(const RawAddress& addr) {
+  btif_config_remove(addr.ToString(), HFP_NEGOTIATED_CODEC_CONFIG_KEY);
+}
+
 /*******************************************************************************
  *
  * Function         bta_ag_codec_negotiate
@@ -578,6 +642,19 @@ void bta_ag_codec_negotiate(tBTA_AG_SCB* p_scb) {
 
   if ((p_scb->codec_updated || p_scb->codec_fallback) &&
       (p_scb->peer_features & BTA_AG_PEER_FEAT_CODEC)) {
+    tBTA_AG_PEER_CODEC cached_codec = bta_ag_cached_codec_get(p_scb->peer_addr);
+    if (!p_scb->codec_fallback && cached_codec != BTA_AG_CODEC_NONE &&
+        cached_codec == p_scb->sco_codec &&
+        (p_scb->peer_codecs & cached_codec)) {
+      /* The peer accepted this codec on a previous connection; bring audio up
+       * with the same settings right away instead of repeating the AT+BCS
+       * round trip. A failed eSCO attempt drops the cache and renegotiates. */
+      LOG_INFO("Reusing cached codec %d for device %s", cached_codec,
+               p_scb->peer_addr.ToString().c_str());
+      p_scb->codec_cache_reused = true;
+      bta_ag_sco_codec_nego(p_scb, true);
+      return;
+    }
     LOG_INFO("Starting codec negotiation");
     /* Change the power mode to Active until SCO open is completed. */
     bta_sys_busy(BTA_ID_AG, p_scb->app_id, p_scb->peer_addr);
@@ -1257,6 +1334,12 @@ void bta_ag_sco_conn_open(tBTA_AG_SCB* p_scb,
   /* call app callback */
   bta_ag_cback_sco(p_scb, BTA_AG_AUDIO_OPEN_EVT);
 
+  /* remember the codec that worked for fast setup on the next connection */
+  if (p_scb->inuse_codec != BTA_AG_CODEC_NONE) {
+    bta_ag_cached_codec_store(p_scb->peer_addr, p_scb->inuse_codec);
+  }
+  p_scb->codec_cache_reused = false;
+
   /* reset to mSBC T2 settings as the preferred */
   p_scb->codec_msbc_settings = BTA_AG_SCO_MSBC_SETTINGS_T2;
 }
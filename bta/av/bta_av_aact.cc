@@ -468,10 +468,10 @@ void bta_av_sink_data_cback(uint8_t handle, BT_HDR* p_pkt, uint32_t time_stamp,
     return;
   }
   p_pkt->event = BTA_AV_SINK_MEDIA_DATA_EVT;
+  /* The buffer is loaned to the application callback, which either queues
+   * it for the decoder or frees it; no copy is made on the way up */
   p_scb->seps[p_scb->sep_idx].p_app_sink_data_cback(
       p_scb->PeerAddress(), BTA_AV_SINK_MEDIA_DATA_EVT, (tBTA_AV_MEDIA*)p_pkt);
-  /* Free the buffer: a copy of the packet has been delivered */
-  osi_free(p_pkt);
 }
 
 /*******************************************************************************
@@ -29,7 +29,6 @@
 #include "bt_target.h"  // Must be first to define build configuration
 
 #include "bta/av/bta_av_int.h"
-#include "osi/include/allocator.h"
 #include "osi/include/compat.h"
 #include "osi/include/log.h"
 
@@ -54,7 +53,7 @@ static const tBTA_SYS_REG bta_av_reg = {bta_av_hdl_event, BTA_AvDisable};
  ******************************************************************************/
 void BTA_AvEnable(tBTA_AV_FEAT features, tBTA_AV_CBACK* p_cback) {
   tBTA_AV_API_ENABLE* p_buf =
-      (tBTA_AV_API_ENABLE*)osi_malloc(sizeof(tBTA_AV_API_ENABLE));
+      (tBTA_AV_API_ENABLE*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_ENABLE));
 
   /* register with BTA system manager */
   bta_sys_register(BTA_ID_AV, &bta_av_reg);
@@ -76,7 +75,7 @@ void BTA_AvEnable(tBTA_AV_FEAT features, tBTA_AV_CBACK* p_cback) {
  *
  ******************************************************************************/
 void BTA_AvDisable(void) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   bta_sys_deregister(BTA_ID_AV);
   p_buf->event = BTA_AV_API_DISABLE_EVT;
@@ -101,7 +100,7 @@ void BTA_AvRegister(tBTA_AV_CHNL chnl, const char* p_service_name,
                     uint8_t app_id, tBTA_AV_SINK_DATA_CBACK* p_sink_data_cback,
                     uint16_t service_uuid) {
   tBTA_AV_API_REG* p_buf =
-      (tBTA_AV_API_REG*)osi_malloc(sizeof(tBTA_AV_API_REG));
+      (tBTA_AV_API_REG*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_REG));
 
   p_buf->hdr.layer_specific = chnl;
   p_buf->hdr.event = BTA_AV_API_REGISTER_EVT;
@@ -126,7 +125,7 @@ void BTA_AvRegister(tBTA_AV_CHNL chnl, const char* p_service_name,
  *
  ******************************************************************************/
 void BTA_AvDeregister(tBTA_AV_HNDL hndl) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->layer_specific = hndl;
   p_buf->event = BTA_AV_API_DEREGISTER_EVT;
@@ -152,7 +151,7 @@ void BTA_AvOpen(const RawAddress& bd_addr, tBTA_AV_HNDL handle, bool use_rc,
            uuid);
 
   tBTA_AV_API_OPEN* p_buf =
-      (tBTA_AV_API_OPEN*)osi_malloc(sizeof(tBTA_AV_API_OPEN));
+      (tBTA_AV_API_OPEN*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_OPEN));
 
   p_buf->hdr.event = BTA_AV_API_OPEN_EVT;
   p_buf->hdr.layer_specific = handle;
@@ -176,7 +175,7 @@ void BTA_AvOpen(const RawAddress& bd_addr, tBTA_AV_HNDL handle, bool use_rc,
 void BTA_AvClose(tBTA_AV_HNDL handle) {
   LOG_INFO("%s: bta_handle:0x%x", __func__, handle);
 
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_AV_API_CLOSE_EVT;
   p_buf->layer_specific = handle;
@@ -197,7 +196,7 @@ void BTA_AvDisconnect(tBTA_AV_HNDL handle) {
   LOG_INFO("%s: bta_handle=0x%x", __func__, handle);
 
   tBTA_AV_API_DISCNT* p_buf =
-      (tBTA_AV_API_DISCNT*)osi_malloc(sizeof(tBTA_AV_API_DISCNT));
+      (tBTA_AV_API_DISCNT*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_DISCNT));
 
   p_buf->hdr.event = BTA_AV_API_DISCONNECT_EVT;
   p_buf->hdr.layer_specific = handle;
@@ -217,7 +216,7 @@ void BTA_AvDisconnect(tBTA_AV_HNDL handle) {
 void BTA_AvStart(tBTA_AV_HNDL handle) {
   LOG_INFO("Starting audio/video stream data transfer bta_handle:%hhu", handle);
 
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_AV_API_START_EVT;
   p_buf->layer_specific = handle;
@@ -237,7 +236,7 @@ void BTA_AvStart(tBTA_AV_HNDL handle) {
 void BTA_AvOffloadStart(tBTA_AV_HNDL hndl) {
   LOG_INFO("%s: bta_handle=0x%x", __func__, hndl);
 
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_AV_API_OFFLOAD_START_EVT;
   p_buf->layer_specific = hndl;
@@ -255,8 +254,8 @@ void BTA_AvOffloadStart(tBTA_AV_HNDL hndl) {
  *
  ******************************************************************************/
 void BTA_AvOffloadStartRsp(tBTA_AV_HNDL hndl, tBTA_AV_STATUS status) {
-  tBTA_AV_API_STATUS_RSP* p_buf =
-      (tBTA_AV_API_STATUS_RSP*)osi_malloc(sizeof(tBTA_AV_API_STATUS_RSP));
+  tBTA_AV_API_STATUS_RSP* p_buf = (tBTA_AV_API_STATUS_RSP*)bta_sys_msg_alloc(
+      sizeof(tBTA_AV_API_STATUS_RSP));
 
   p_buf->hdr.event = BTA_AV_API_OFFLOAD_START_RSP_EVT;
   p_buf->hdr.layer_specific = hndl;
@@ -281,7 +280,7 @@ void BTA_AvStop(tBTA_AV_HNDL handle, bool suspend) {
            logbool(suspend).c_str());
 
   tBTA_AV_API_STOP* p_buf =
-      (tBTA_AV_API_STOP*)osi_malloc(sizeof(tBTA_AV_API_STOP));
+      (tBTA_AV_API_STOP*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_STOP));
 
   p_buf->hdr.event = BTA_AV_API_STOP_EVT;
   p_buf->hdr.layer_specific = handle;
@@ -311,8 +310,8 @@ void BTA_AvReconfig(tBTA_AV_HNDL hndl, bool suspend, uint8_t sep_info_idx,
   LOG_INFO("%s: bta_handle=0x%x suspend=%s sep_info_idx=%d", __func__, hndl,
            logbool(suspend).c_str(), sep_info_idx);
 
-  tBTA_AV_API_RCFG* p_buf =
-      (tBTA_AV_API_RCFG*)osi_malloc(sizeof(tBTA_AV_API_RCFG) + num_protect);
+  tBTA_AV_API_RCFG* p_buf = (tBTA_AV_API_RCFG*)bta_sys_msg_alloc(
+      sizeof(tBTA_AV_API_RCFG) + num_protect);
 
   p_buf->hdr.layer_specific = hndl;
   p_buf->hdr.event = BTA_AV_API_RECONFIG_EVT;
@@ -337,7 +336,7 @@ void BTA_AvReconfig(tBTA_AV_HNDL hndl, bool suspend, uint8_t sep_info_idx,
  *
  ******************************************************************************/
 void BTA_AvProtectReq(tBTA_AV_HNDL hndl, uint8_t* p_data, uint16_t len) {
-  tBTA_AV_API_PROTECT_REQ* p_buf = (tBTA_AV_API_PROTECT_REQ*)osi_malloc(
+  tBTA_AV_API_PROTECT_REQ* p_buf = (tBTA_AV_API_PROTECT_REQ*)bta_sys_msg_alloc(
       sizeof(tBTA_AV_API_PROTECT_REQ) + len);
 
   p_buf->hdr.layer_specific = hndl;
@@ -367,7 +366,7 @@ void BTA_AvProtectReq(tBTA_AV_HNDL hndl, uint8_t* p_data, uint16_t len) {
  ******************************************************************************/
 void BTA_AvProtectRsp(tBTA_AV_HNDL hndl, uint8_t error_code, uint8_t* p_data,
                       uint16_t len) {
-  tBTA_AV_API_PROTECT_RSP* p_buf = (tBTA_AV_API_PROTECT_RSP*)osi_malloc(
+  tBTA_AV_API_PROTECT_RSP* p_buf = (tBTA_AV_API_PROTECT_RSP*)bta_sys_msg_alloc(
       sizeof(tBTA_AV_API_PROTECT_RSP) + len);
 
   p_buf->hdr.layer_specific = hndl;
@@ -396,8 +395,8 @@ void BTA_AvProtectRsp(tBTA_AV_HNDL hndl, uint8_t error_code, uint8_t* p_data,
  ******************************************************************************/
 void BTA_AvRemoteCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_RC rc_id,
                      tBTA_AV_STATE key_state) {
-  tBTA_AV_API_REMOTE_CMD* p_buf =
-      (tBTA_AV_API_REMOTE_CMD*)osi_malloc(sizeof(tBTA_AV_API_REMOTE_CMD));
+  tBTA_AV_API_REMOTE_CMD* p_buf = (tBTA_AV_API_REMOTE_CMD*)bta_sys_msg_alloc(
+      sizeof(tBTA_AV_API_REMOTE_CMD));
 
   p_buf->hdr.event = BTA_AV_API_REMOTE_CMD_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -424,7 +423,7 @@ void BTA_AvRemoteCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_RC rc_id,
 void BTA_AvRemoteVendorUniqueCmd(uint8_t rc_handle, uint8_t label,
                                  tBTA_AV_STATE key_state, uint8_t* p_msg,
                                  uint8_t buf_len) {
-  tBTA_AV_API_REMOTE_CMD* p_buf = (tBTA_AV_API_REMOTE_CMD*)osi_malloc(
+  tBTA_AV_API_REMOTE_CMD* p_buf = (tBTA_AV_API_REMOTE_CMD*)bta_sys_msg_alloc(
       sizeof(tBTA_AV_API_REMOTE_CMD) + buf_len);
 
   p_buf->label = label;
@@ -456,7 +455,7 @@ void BTA_AvRemoteVendorUniqueCmd(uint8_t rc_handle, uint8_t label,
 void BTA_AvVendorCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE cmd_code,
                      uint8_t* p_data, uint16_t len) {
   tBTA_AV_API_VENDOR* p_buf =
-      (tBTA_AV_API_VENDOR*)osi_malloc(sizeof(tBTA_AV_API_VENDOR) + len);
+      (tBTA_AV_API_VENDOR*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_VENDOR) + len);
 
   p_buf->hdr.event = BTA_AV_API_VENDOR_CMD_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -491,7 +490,7 @@ void BTA_AvVendorCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE cmd_code,
 void BTA_AvVendorRsp(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE rsp_code,
                      uint8_t* p_data, uint16_t len, uint32_t company_id) {
   tBTA_AV_API_VENDOR* p_buf =
-      (tBTA_AV_API_VENDOR*)osi_malloc(sizeof(tBTA_AV_API_VENDOR) + len);
+      (tBTA_AV_API_VENDOR*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_VENDOR) + len);
 
   p_buf->hdr.event = BTA_AV_API_VENDOR_RSP_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -526,7 +525,7 @@ void BTA_AvVendorRsp(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE rsp_code,
  ******************************************************************************/
 void BTA_AvOpenRc(tBTA_AV_HNDL handle) {
   tBTA_AV_API_OPEN_RC* p_buf =
-      (tBTA_AV_API_OPEN_RC*)osi_malloc(sizeof(tBTA_AV_API_OPEN_RC));
+      (tBTA_AV_API_OPEN_RC*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_OPEN_RC));
 
   p_buf->hdr.event = BTA_AV_API_RC_OPEN_EVT;
   p_buf->hdr.layer_specific = handle;
@@ -545,7 +544,7 @@ void BTA_AvOpenRc(tBTA_AV_HNDL handle) {
  ******************************************************************************/
 void BTA_AvCloseRc(uint8_t rc_handle) {
   tBTA_AV_API_CLOSE_RC* p_buf =
-      (tBTA_AV_API_CLOSE_RC*)osi_malloc(sizeof(tBTA_AV_API_CLOSE_RC));
+      (tBTA_AV_API_CLOSE_RC*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_CLOSE_RC));
 
   p_buf->hdr.event = BTA_AV_API_RC_CLOSE_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -569,7 +568,7 @@ void BTA_AvCloseRc(uint8_t rc_handle) {
 void BTA_AvMetaRsp(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE rsp_code,
                    BT_HDR* p_pkt) {
   tBTA_AV_API_META_RSP* p_buf =
-      (tBTA_AV_API_META_RSP*)osi_malloc(sizeof(tBTA_AV_API_META_RSP));
+      (tBTA_AV_API_META_RSP*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_META_RSP));
 
   p_buf->hdr.event = BTA_AV_API_META_RSP_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -601,7 +600,7 @@ void BTA_AvMetaRsp(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE rsp_code,
 void BTA_AvMetaCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_CMD cmd_code,
                    BT_HDR* p_pkt) {
   tBTA_AV_API_META_RSP* p_buf =
-      (tBTA_AV_API_META_RSP*)osi_malloc(sizeof(tBTA_AV_API_META_RSP));
+      (tBTA_AV_API_META_RSP*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_META_RSP));
 
   p_buf->hdr.event = BTA_AV_API_META_RSP_EVT;
   p_buf->hdr.layer_specific = rc_handle;
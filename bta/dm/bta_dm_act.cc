@@ -71,9 +71,16 @@ static void bta_dm_inq_cmpl_cb(void* p_result);
 static void bta_dm_service_search_remname_cback(const RawAddress& bd_addr,
                                                 DEV_CLASS dc, BD_NAME bd_name);
 static void bta_dm_remname_cback(void* p);
+static void bta_dm_remname_refresh_cback(void* p);
 static void bta_dm_find_services(const RawAddress& bd_addr);
 static void bta_dm_discover_next_device(void);
 static void bta_dm_sdp_callback(tSDP_STATUS sdp_status);
+static void bta_dm_sdp_prefetch_start(const tBTA_DM_API_DISCOVER* p_discover);
+static bool bta_dm_sdp_prefetch_take(const RawAddress& bd_addr,
+                                     const Uuid& uuid);
+static void bta_dm_sdp_prefetch_drop(const RawAddress& bd_addr);
+static void bta_dm_sdp_prefetch_clear(void);
+static void bta_dm_sdp_prefetch_cback(tSDP_RESULT sdp_result, void* user_data);
 static uint8_t bta_dm_pin_cback(const RawAddress& bd_addr, DEV_CLASS dev_class,
                                 BD_NAME bd_name, bool min_16_digit);
 static uint8_t bta_dm_new_link_key_cback(const RawAddress& bd_addr,
@@ -146,6 +153,24 @@ static void bta_dm_ctrl_features_rd_cmpl_cback(tHCI_STATUS result);
 #define BTA_DM_SWITCH_DELAY_TIMER_MS 500
 #endif
 
+/* Window over which service UUID changes are batched into a single EIR
+ * rebuild and controller write (in milliseconds) */
+#ifndef BTA_DM_EIR_COALESCE_TIMER_MS
+#define BTA_DM_EIR_COALESCE_TIMER_MS 200
+#endif
+
+/* Persisted remote names younger than this are served from the cache instead
+ * of a remote name request round trip (in seconds) */
+#ifndef BTA_DM_NAME_CACHE_TTL_S
+#define BTA_DM_NAME_CACHE_TTL_S (7 * 24 * 60 * 60)
+#endif
+
+/* Cached remote names older than this are still served, but a background
+ * remote name request is issued to re-arm their freshness (in seconds) */
+#ifndef BTA_DM_NAME_CACHE_REFRESH_S
+#define BTA_DM_NAME_CACHE_REFRESH_S (24 * 60 * 60)
+#endif
+
 namespace {
 
 // Time to wait after receiving shutdown request to delay the actual shutdown
@@ -245,6 +270,33 @@ const tBTM_APPL_INFO bta_security = {
 #define MAX_DISC_RAW_DATA_BUF (4096)
 uint8_t g_disc_raw_data_buf[MAX_DISC_RAW_DATA_BUF];
 
+/* Service discovery is serialized through bta_dm_search_cb, so when several
+ * devices connect at once each one waits for the whole name/SDP/GATT sequence
+ * of its predecessors. While a discovery is active, the SDP searches for
+ * queued BR/EDR peers are prefetched concurrently on their own ACL links into
+ * private discovery databases; bta_dm_find_services() then consumes the
+ * prefetched database instead of issuing a new request when the device's
+ * turn comes. */
+#ifndef BTA_DM_SDP_PREFETCH_MAX
+#define BTA_DM_SDP_PREFETCH_MAX 2
+#endif
+
+/* bta_dm_find_services() issues two searches per device for
+ * BTA_ALL_SERVICE_MASK: the RES service UUID, then the L2CAP protocol UUID */
+#define BTA_DM_SDP_PREFETCH_SEARCHES 2
+
+typedef struct {
+  bool in_use;
+  bool busy;        /* a prefetch request is outstanding on the link */
+  uint8_t num_done; /* number of searches completed so far */
+  RawAddress bd_addr;
+  Uuid uuid[BTA_DM_SDP_PREFETCH_SEARCHES];
+  tSDP_RESULT sdp_result[BTA_DM_SDP_PREFETCH_SEARCHES];
+  tSDP_DISCOVERY_DB* p_sdp_db[BTA_DM_SDP_PREFETCH_SEARCHES];
+} tBTA_DM_SDP_PREFETCH;
+
+static tBTA_DM_SDP_PREFETCH bta_dm_sdp_prefetch[BTA_DM_SDP_PREFETCH_MAX];
+
 extern DEV_CLASS local_device_default_class;
 
 // Stores the local Input/Output Capabilities of the Bluetooth device.
@@ -276,6 +328,7 @@ void bta_dm_init_cb(void) {
   memset(&bta_dm_cb, 0, sizeof(bta_dm_cb));
   bta_dm_cb.disable_timer = alarm_new("bta_dm.disable_timer");
   bta_dm_cb.switch_delay_timer = alarm_new("bta_dm.switch_delay_timer");
+  bta_dm_cb.eir_coalesce_timer = alarm_new("bta_dm.eir_coalesce_timer");
   for (size_t i = 0; i < BTA_DM_NUM_PM_TIMER; i++) {
     for (size_t j = 0; j < BTA_DM_PM_MODE_TIMER_MAX; j++) {
       bta_dm_cb.pm_timer[i].timer[j] = alarm_new("bta_dm.pm_timer");
@@ -300,6 +353,7 @@ void bta_dm_deinit_cb(void) {
    */
   alarm_free(bta_dm_cb.disable_timer);
   alarm_free(bta_dm_cb.switch_delay_timer);
+  alarm_free(bta_dm_cb.eir_coalesce_timer);
   for (size_t i = 0; i < BTA_DM_NUM_PM_TIMER; i++) {
     for (size_t j = 0; j < BTA_DM_PM_MODE_TIMER_MAX; j++) {
       alarm_free(bta_dm_cb.pm_timer[i].timer[j]);
@@ -923,6 +977,7 @@ void bta_dm_discover(tBTA_DM_MSG* p_data) {
  *
  ******************************************************************************/
 static void bta_dm_disable_search_and_disc(void) {
+  bta_dm_sdp_prefetch_clear();
   if (bta_dm_search_cb.state != BTA_DM_SEARCH_IDLE) bta_dm_search_cancel();
 }
 
@@ -935,6 +990,9 @@ static void bta_dm_disable_search_and_disc(void) {
  * Returns          true if started to get remote name
  *
  ******************************************************************************/
+/* Peer whose cached name is being refreshed in the background */
+static RawAddress bta_dm_name_refresh_bdaddr;
+
 static bool bta_dm_read_remote_device_name(const RawAddress& bd_addr,
                                            tBT_TRANSPORT transport) {
   tBTM_STATUS btm_status;
@@ -944,6 +1002,41 @@ static bool bta_dm_read_remote_device_name(const RawAddress& bd_addr,
   bta_dm_search_cb.peer_bdaddr = bd_addr;
   bta_dm_search_cb.peer_name[0] = 0;
 
+  /* Serve the name from the persistent cache while it is still fresh and
+   * save the remote name request round trip; an aging entry is still
+   * served, but a background request is issued to re-arm its freshness */
+  BD_NAME cached_name;
+  int name_age_s = 0;
+  if (transport == BT_TRANSPORT_BR_EDR &&
+      btif_storage_get_cached_remote_name(bd_addr, cached_name, &name_age_s) &&
+      name_age_s <= BTA_DM_NAME_CACHE_TTL_S) {
+    APPL_TRACE_DEBUG("%s: serving cached remote name, age %d s", __func__,
+                     name_age_s);
+
+    if (name_age_s > BTA_DM_NAME_CACHE_REFRESH_S) {
+      bta_dm_name_refresh_bdaddr = bd_addr;
+      btm_status = BTM_ReadRemoteDeviceName(
+          bd_addr, bta_dm_remname_refresh_cback, transport);
+      if (btm_status != BTM_CMD_STARTED) {
+        /* No refresh this time around; the cached name is served until the
+         * TTL expires and the next discovery tries again */
+        APPL_TRACE_DEBUG("%s: name refresh not started 0x%02X", __func__,
+                         btm_status);
+      }
+    }
+
+    tBTM_REMOTE_DEV_NAME rem_name;
+    rem_name.status = BTM_SUCCESS;
+    rem_name.bd_addr = bd_addr;
+    rem_name.length = strlcpy((char*)rem_name.remote_bd_name,
+                              (char*)cached_name, BD_NAME_LEN + 1);
+    if (rem_name.length > BD_NAME_LEN) {
+      rem_name.length = BD_NAME_LEN;
+    }
+    bta_dm_remname_cback(&rem_name);
+    return (true);
+  }
+
   btm_status =
       (bluetooth::shim::is_gd_security_enabled())
           ? bluetooth::shim::BTM_ReadRemoteDeviceName(
@@ -1284,6 +1377,9 @@ void bta_dm_sdp_result(tBTA_DM_MSG* p_data) {
 void bta_dm_search_cmpl() {
   bta_dm_search_set_state(BTA_DM_SEARCH_IDLE);
 
+  /* nothing prefetched for this device may outlive its discovery */
+  bta_dm_sdp_prefetch_drop(bta_dm_search_cb.peer_bdaddr);
+
   uint16_t conn_id = bta_dm_search_cb.conn_id;
 
   /* no BLE connection, i.e. Classic service discovery end */
@@ -1450,6 +1546,9 @@ void bta_dm_queue_disc(tBTA_DM_MSG* p_data) {
   memcpy(p_pending_discovery, p_data, sizeof(tBTA_DM_API_DISCOVER));
   fixed_queue_enqueue(bta_dm_search_cb.pending_discovery_queue,
                       p_pending_discovery);
+
+  /* overlap the SDP portion of the queued discovery with the active one */
+  bta_dm_sdp_prefetch_start(&p_data->discover);
 }
 
 /*******************************************************************************
@@ -1509,6 +1608,7 @@ bool bta_dm_is_search_request_queued() {
 void bta_dm_search_clear_queue() {
   osi_free_and_reset((void**)&bta_dm_search_cb.p_pending_search);
   fixed_queue_flush(bta_dm_search_cb.pending_discovery_queue, osi_free);
+  bta_dm_sdp_prefetch_clear();
 }
 
 /*******************************************************************************
@@ -1534,6 +1634,228 @@ void bta_dm_search_cancel_notify() {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_prefetch_find
+ *
+ * Description      Returns the prefetch context for a peer, if any
+ *
+ * Returns          Pointer to the context, or NULL
+ *
+ ******************************************************************************/
+static tBTA_DM_SDP_PREFETCH* bta_dm_sdp_prefetch_find(
+    const RawAddress& bd_addr) {
+  for (uint8_t xx = 0; xx < BTA_DM_SDP_PREFETCH_MAX; xx++) {
+    if (bta_dm_sdp_prefetch[xx].in_use &&
+        bta_dm_sdp_prefetch[xx].bd_addr == bd_addr)
+      return &bta_dm_sdp_prefetch[xx];
+  }
+  return NULL;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_prefetch_free
+ *
+ * Description      Releases a prefetch context, cancelling any outstanding
+ *                  search on its link
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_sdp_prefetch_free(tBTA_DM_SDP_PREFETCH* p_ctx) {
+  if (p_ctx->busy) {
+    /* the completion callback fires synchronously with SDP_CANCEL and is
+     * ignored because |busy| is already cleared */
+    p_ctx->busy = false;
+    SDP_CancelServiceSearch(p_ctx->p_sdp_db[p_ctx->num_done]);
+  }
+
+  for (uint8_t xx = 0; xx < BTA_DM_SDP_PREFETCH_SEARCHES; xx++)
+    osi_free_and_reset((void**)&p_ctx->p_sdp_db[xx]);
+
+  p_ctx->in_use = false;
+  p_ctx->num_done = 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_prefetch_drop
+ *
+ * Description      Releases the prefetch context for a peer, if any
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_sdp_prefetch_drop(const RawAddress& bd_addr) {
+  tBTA_DM_SDP_PREFETCH* p_ctx = bta_dm_sdp_prefetch_find(bd_addr);
+  if (p_ctx) bta_dm_sdp_prefetch_free(p_ctx);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_prefetch_clear
+ *
+ * Description      Releases all prefetch contexts; used when the pending
+ *                  discovery queue is flushed
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_sdp_prefetch_clear(void) {
+  for (uint8_t xx = 0; xx < BTA_DM_SDP_PREFETCH_MAX; xx++) {
+    if (bta_dm_sdp_prefetch[xx].in_use)
+      bta_dm_sdp_prefetch_free(&bta_dm_sdp_prefetch[xx]);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_prefetch_next
+ *
+ * Description      Issues the next prefetch search for a context. The
+ *                  discovery database and its raw data buffer are allocated
+ *                  as one block so that bta_dm_free_sdp_db() releases both
+ *                  after the database has been consumed.
+ *
+ * Returns          true if the request was started
+ *
+ ******************************************************************************/
+static bool bta_dm_sdp_prefetch_next(tBTA_DM_SDP_PREFETCH* p_ctx) {
+  uint8_t xx = p_ctx->num_done;
+
+  p_ctx->p_sdp_db[xx] = (tSDP_DISCOVERY_DB*)osi_malloc(BTA_DM_SDP_DB_SIZE +
+                                                       MAX_DISC_RAW_DATA_BUF);
+  SDP_InitDiscoveryDb(p_ctx->p_sdp_db[xx], BTA_DM_SDP_DB_SIZE, 1,
+                      &p_ctx->uuid[xx], 0, NULL);
+
+  uint8_t* p_raw = (uint8_t*)p_ctx->p_sdp_db[xx] + BTA_DM_SDP_DB_SIZE;
+  memset(p_raw, 0, MAX_DISC_RAW_DATA_BUF);
+  p_ctx->p_sdp_db[xx]->raw_data = p_raw;
+  p_ctx->p_sdp_db[xx]->raw_size = MAX_DISC_RAW_DATA_BUF;
+
+  if (!SDP_ServiceSearchAttributeRequest2(p_ctx->bd_addr, p_ctx->p_sdp_db[xx],
+                                          bta_dm_sdp_prefetch_cback, p_ctx)) {
+    osi_free_and_reset((void**)&p_ctx->p_sdp_db[xx]);
+    return false;
+  }
+
+  p_ctx->busy = true;
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_prefetch_cback
+ *
+ * Description      Callback from sdp with prefetch search status
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_sdp_prefetch_cback(tSDP_RESULT sdp_result, void* user_data) {
+  tBTA_DM_SDP_PREFETCH* p_ctx = (tBTA_DM_SDP_PREFETCH*)user_data;
+
+  /* a cancelled search is being released by bta_dm_sdp_prefetch_free() */
+  if (!p_ctx->in_use || !p_ctx->busy) return;
+
+  p_ctx->busy = false;
+  p_ctx->sdp_result[p_ctx->num_done] = sdp_result;
+  p_ctx->num_done++;
+
+  if (p_ctx->num_done < BTA_DM_SDP_PREFETCH_SEARCHES) {
+    if (!bta_dm_sdp_prefetch_next(p_ctx)) {
+      /* keep what was already fetched; the remaining searches will be done
+       * on the normal path */
+    }
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_prefetch_start
+ *
+ * Description      Starts prefetching the SDP searches for a queued discovery
+ *                  request if a context is available. LE discovery uses GATT,
+ *                  so only BR/EDR peers are prefetched.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_sdp_prefetch_start(const tBTA_DM_API_DISCOVER* p_discover) {
+  if (p_discover->transport != BT_TRANSPORT_BR_EDR) return;
+  if (bta_dm_sdp_prefetch_find(p_discover->bd_addr)) return;
+
+  tBTA_DM_SDP_PREFETCH* p_ctx = NULL;
+  for (uint8_t xx = 0; xx < BTA_DM_SDP_PREFETCH_MAX; xx++) {
+    if (!bta_dm_sdp_prefetch[xx].in_use) {
+      p_ctx = &bta_dm_sdp_prefetch[xx];
+      break;
+    }
+  }
+  if (p_ctx == NULL) return;
+
+  p_ctx->in_use = true;
+  p_ctx->busy = false;
+  p_ctx->num_done = 0;
+  p_ctx->bd_addr = p_discover->bd_addr;
+
+  /* mirror the search sequence bta_dm_find_services() issues for
+   * BTA_ALL_SERVICE_MASK */
+  p_ctx->uuid[0] = Uuid::From16Bit(bta_service_id_to_uuid_lkup_tbl[0]);
+  p_ctx->uuid[1] = Uuid::From16Bit(UUID_PROTOCOL_L2CAP);
+
+  if (!bta_dm_sdp_prefetch_next(p_ctx)) {
+    bta_dm_sdp_prefetch_free(p_ctx);
+    return;
+  }
+
+  LOG_INFO("%s prefetching SDP for %s", __func__,
+           p_discover->bd_addr.ToString().c_str());
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_prefetch_take
+ *
+ * Description      Serves a discovery search from the peer's prefetch context
+ *                  when the prefetched search matches the one about to be
+ *                  issued. On success the prefetched database is swapped into
+ *                  bta_dm_search_cb.p_sdp_db and the SDP result event is
+ *                  posted as if the request had just completed.
+ *
+ * Returns          true if the search was served from the prefetch context
+ *
+ ******************************************************************************/
+static bool bta_dm_sdp_prefetch_take(const RawAddress& bd_addr,
+                                     const Uuid& uuid) {
+  tBTA_DM_SDP_PREFETCH* p_ctx = bta_dm_sdp_prefetch_find(bd_addr);
+  if (!p_ctx) return false;
+
+  /* consumed slots are reset, so the first populated slot is the next one */
+  uint8_t xx;
+  for (xx = 0;
+       xx < BTA_DM_SDP_PREFETCH_SEARCHES && p_ctx->p_sdp_db[xx] == NULL; xx++)
+    ;
+
+  if (xx >= p_ctx->num_done || p_ctx->uuid[xx] != uuid) {
+    /* out of completed results, or the search pattern diverged; fall back
+     * to the normal path for the rest of this device's discovery */
+    bta_dm_sdp_prefetch_free(p_ctx);
+    return false;
+  }
+
+  osi_free(bta_dm_search_cb.p_sdp_db);
+  bta_dm_search_cb.p_sdp_db = p_ctx->p_sdp_db[xx];
+  p_ctx->p_sdp_db[xx] = NULL;
+
+  tSDP_RESULT sdp_result = p_ctx->sdp_result[xx];
+  if (xx == BTA_DM_SDP_PREFETCH_SEARCHES - 1) bta_dm_sdp_prefetch_free(p_ctx);
+
+  bta_dm_sdp_callback(sdp_result);
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         bta_dm_find_services
@@ -1590,6 +1912,12 @@ static void bta_dm_find_services(const RawAddress& bd_addr) {
 
       bta_dm_search_cb.p_sdp_db->raw_size = MAX_DISC_RAW_DATA_BUF;
 
+      if (bta_dm_sdp_prefetch_take(bd_addr, uuid)) {
+        /* served from the prefetched database; result event already posted */
+        bta_dm_search_cb.service_index++;
+        return;
+      }
+
       if (!SDP_ServiceSearchAttributeRequest(bd_addr, bta_dm_search_cb.p_sdp_db,
                                              &bta_dm_sdp_callback)) {
         /*
@@ -1953,6 +2281,35 @@ static void bta_dm_remname_cback(void* p) {
   bta_sys_sendmsg(p_msg);
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_dm_remname_refresh_cback
+ *
+ * Description      Remote name complete callback for a background refresh of
+ *                  an aging cached name. The ongoing discovery was already
+ *                  served from the cache, so the result is only re-persisted
+ *                  to move the freshness window forward.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_remname_refresh_cback(void* p) {
+  tBTM_REMOTE_DEV_NAME* p_remote_name = (tBTM_REMOTE_DEV_NAME*)p;
+
+  if (p_remote_name->status != BTM_SUCCESS ||
+      p_remote_name->remote_bd_name[0] == 0) {
+    APPL_TRACE_DEBUG("%s: name refresh failed, status %d", __func__,
+                     p_remote_name->status);
+    return;
+  }
+
+  bt_property_t prop;
+  prop.type = BT_PROPERTY_BDNAME;
+  prop.val = p_remote_name->remote_bd_name;
+  prop.len = strlen((char*)p_remote_name->remote_bd_name);
+  btif_storage_set_remote_device_property(&bta_dm_name_refresh_bdaddr, &prop);
+}
+
 /*******************************************************************************
  *
  * Function         bta_dm_pinname_cback
@@ -3147,6 +3504,39 @@ static void bta_dm_update_cust_uuid(uint8_t c_uu_idx, const Uuid& uuid, uint32_t
 #endif
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_dm_eir_coalesce_timer_cback
+ *
+ * Description      Deferred EIR rebuild; runs once after a burst of service
+ *                  UUID changes instead of once per change.
+ *
+ * Returns          None
+ *
+ ******************************************************************************/
+static void bta_dm_eir_coalesce_timer_cback(UNUSED_ATTR void* data) {
+  bta_dm_set_eir(NULL);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_defer_eir_update
+ *
+ * Description      Schedules a single EIR rebuild and controller write for
+ *                  all service UUID changes arriving within the coalesce
+ *                  window. Registering N services at startup then costs one
+ *                  EIR write instead of N.
+ *
+ * Returns          None
+ *
+ ******************************************************************************/
+static void bta_dm_defer_eir_update(void) {
+  if (alarm_is_scheduled(bta_dm_cb.eir_coalesce_timer)) return;
+  alarm_set_on_mloop(bta_dm_cb.eir_coalesce_timer,
+                     BTA_DM_EIR_COALESCE_TIMER_MS,
+                     bta_dm_eir_coalesce_timer_cback, NULL);
+}
+
 /*******************************************************************************
  *
  * Function         bta_dm_eir_update_cust_uuid
@@ -3170,7 +3560,7 @@ void bta_dm_eir_update_cust_uuid(const tBTA_CUSTOM_UUID& curr, bool adding) {
 
   /* Update EIR when UUIDs are changed */
   if (c_uu_idx <= BTA_EIR_SERVER_NUM_CUSTOM_UUID) {
-    bta_dm_set_eir(NULL);
+    bta_dm_defer_eir_update();
   }
 #endif
 }
@@ -3198,7 +3588,7 @@ void bta_dm_eir_update_uuid(uint16_t uuid16, bool adding) {
     BTM_RemoveEirService(bta_dm_cb.eir_uuid, uuid16);
   }
 
-  bta_dm_set_eir(NULL);
+  bta_dm_defer_eir_update();
 }
 #endif
 
@@ -123,6 +123,22 @@ void BTA_DmSearchCancel(void) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         BTA_DmSetInquiryPageYield
+ *
+ * Description      This function sets whether an active inquiry yields the
+ *                  radio to outgoing connection attempts and resumes with
+ *                  its remaining duration afterwards. Enabled by default.
+ *
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void BTA_DmSetInquiryPageYield(bool enable) {
+  do_in_main_thread(FROM_HERE, base::Bind(BTM_SetInquiryPageYield, enable));
+}
+
 /*******************************************************************************
  *
  * Function         BTA_DmDiscover
@@ -346,6 +346,7 @@ typedef struct {
 
   tBTA_DM_ENCRYPT_CBACK* p_encrypt_cback;
   alarm_t* switch_delay_timer;
+  alarm_t* eir_coalesce_timer;
 
 } tBTA_DM_CB;
 
@@ -488,6 +488,15 @@ void bta_gattc_conn(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
       if (bta_gattc_cache_load(p_clcb->p_srcb)) {
         p_clcb->p_srcb->state = BTA_GATTC_SERV_IDLE;
         bta_gattc_reset_discover_st(p_clcb->p_srcb, GATT_SUCCESS);
+
+        /* the loaded cache might be stale if the server changed its database
+         * while we were not connected. If the server supports robust caching,
+         * one Database Hash read confirms the cache instead of re-discovery */
+        if (bta_gattc_is_robust_caching_enabled() &&
+            p_clcb->p_srcb->gatt_database.HasDatabaseHash()) {
+          p_clcb->p_srcb->srvc_hdl_db_hash = true;
+          bta_gattc_sm_execute(p_clcb, BTA_GATTC_INT_DISCOVER_EVT, NULL);
+        }
       } else {
         p_clcb->p_srcb->state = BTA_GATTC_SERV_DISC;
         /* cache load failure, start discovery */
@@ -26,15 +26,26 @@
 #define LOG_TAG "bt_bta_gattc"
 
 #include <base/strings/stringprintf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "bt_target.h"  // Must be first to define build configuration
 
 #include "bta/gatt/bta_gattc_int.h"
 #include "bta/gatt/database.h"
 #include "osi/include/log.h"
+#include "osi/include/thread.h"
 #include "stack/btm/btm_sec.h"
 #include "stack/include/gatt_api.h"
 #include "types/bluetooth/uuid.h"
@@ -74,6 +85,12 @@ static void bta_gattc_read_ext_prop_desc_cmpl(tBTA_GATTC_CLCB* p_clcb,
 #define GATT_CACHE_PREFIX "/data/misc/bluetooth/gatt_cache_"
 #define GATT_CACHE_VERSION 6
 
+/* version + attribute count; StoredAttribute records follow at this offset */
+#define GATT_CACHE_HEADER_SIZE (2 * sizeof(uint16_t))
+
+static_assert(alignof(StoredAttribute) <= 2 * sizeof(uint16_t),
+              "StoredAttribute must be readable in place at the mmap offset");
+
 static void bta_gattc_generate_cache_file_name(char* buffer, size_t buffer_len,
                                                const RawAddress& bda) {
   snprintf(buffer, buffer_len, "%s%02x%02x%02x%02x%02x%02x", GATT_CACHE_PREFIX,
@@ -935,47 +952,112 @@ bool bta_gattc_cache_load(tBTA_GATTC_SERV* p_srcb) {
   char fname[255] = {0};
   bta_gattc_generate_cache_file_name(fname, sizeof(fname), p_srcb->server_bda);
 
-  FILE* fd = fopen(fname, "rb");
-  if (!fd) {
+  int fd = open(fname, O_RDONLY);
+  if (fd < 0) {
     LOG(ERROR) << __func__ << ": can't open GATT cache file " << fname
                << " for reading, error: " << strerror(errno);
     return false;
   }
 
-  uint16_t cache_ver = 0;
-  bool success = false;
-  uint16_t num_attr = 0;
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      (size_t)st.st_size < GATT_CACHE_HEADER_SIZE) {
+    LOG(ERROR) << __func__ << ": GATT cache file too short: " << fname;
+    close(fd);
+    return false;
+  }
 
-  if (fread(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__ << ": can't read GATT cache version from: " << fname;
-    goto done;
+  /* The cache file is a flat array of fixed-size StoredAttribute records
+   * behind a 4 byte header, so it can be mapped and deserialized in place
+   * with no intermediate copy. */
+  void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    LOG(ERROR) << __func__ << ": can't map GATT cache file " << fname
+               << ", error: " << strerror(errno);
+    return false;
   }
 
+  bool success = false;
+  uint16_t cache_ver;
+  uint16_t num_attr;
+  memcpy(&cache_ver, (uint8_t*)map, sizeof(uint16_t));
+  memcpy(&num_attr, (uint8_t*)map + sizeof(uint16_t), sizeof(uint16_t));
+
   if (cache_ver != GATT_CACHE_VERSION) {
     LOG(ERROR) << __func__ << ": wrong GATT cache version: " << fname;
-    goto done;
+  } else if ((size_t)st.st_size <
+             GATT_CACHE_HEADER_SIZE + num_attr * sizeof(StoredAttribute)) {
+    LOG(ERROR) << __func__ << ": truncated GATT cache file: " << fname;
+  } else {
+    const StoredAttribute* attr =
+        (const StoredAttribute*)((uint8_t*)map + GATT_CACHE_HEADER_SIZE);
+    p_srcb->gatt_database =
+        gatt::Database::Deserialize(attr, num_attr, &success);
   }
 
-  if (fread(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__
-               << ": can't read number of GATT attributes: " << fname;
-    goto done;
-  }
+  munmap(map, st.st_size);
+  return success;
+}
+
+/* Dirty cache images waiting for the background writer, keyed by file
+ * name. A re-discovery before the write happens just replaces the pending
+ * image, so only the newest database ever hits the disk. */
+static std::mutex gattc_cache_write_lock;
+static std::unordered_map<std::string, std::vector<uint8_t>>
+    gattc_pending_cache_writes;
+static thread_t* gattc_cache_writer_thread;
 
+/*******************************************************************************
+ *
+ * Function         bta_gattc_cache_write_worker
+ *
+ * Description      Runs on the cache writer thread. Takes the pending image
+ *                  for one file and writes it next to the target, then
+ *                  renames over it - a crash mid-write can never leave a
+ *                  torn cache, the loader sees either the old file or the
+ *                  new one.
+ *
+ * Parameter        context: heap-allocated file name, owned by the worker.
+ *
+ ******************************************************************************/
+static void bta_gattc_cache_write_worker(void* context) {
+  std::unique_ptr<std::string> fname(static_cast<std::string*>(context));
+
+  std::vector<uint8_t> data;
   {
-    std::vector<StoredAttribute> attr(num_attr);
+    std::lock_guard<std::mutex> lock(gattc_cache_write_lock);
+    auto it = gattc_pending_cache_writes.find(*fname);
+    /* may have been drained together with an earlier post */
+    if (it == gattc_pending_cache_writes.end()) return;
+    data = std::move(it->second);
+    gattc_pending_cache_writes.erase(it);
+  }
 
-    if (fread(attr.data(), sizeof(StoredAttribute), num_attr, fd) != num_attr) {
-      LOG(ERROR) << __func__ << "s: can't read GATT attributes: " << fname;
-      goto done;
-    }
+  std::string tmp_fname = *fname + ".tmp";
+  FILE* fd = fopen(tmp_fname.c_str(), "wb");
+  if (!fd) {
+    LOG(ERROR) << __func__
+               << ": can't open GATT cache file for writing: " << tmp_fname;
+    return;
+  }
 
-    p_srcb->gatt_database = gatt::Database::Deserialize(attr, &success);
+  if (fwrite(data.data(), 1, data.size(), fd) != data.size()) {
+    LOG(ERROR) << __func__ << ": can't write GATT cache file: " << tmp_fname;
+    fclose(fd);
+    unlink(tmp_fname.c_str());
+    return;
   }
 
-done:
+  /* make the data durable before the rename makes it visible */
+  (void)fsync(fileno(fd));
   fclose(fd);
-  return success;
+
+  if (rename(tmp_fname.c_str(), fname->c_str()) != 0) {
+    LOG(ERROR) << __func__ << ": can't rename GATT cache file " << tmp_fname
+               << ": " << strerror(errno);
+    unlink(tmp_fname.c_str());
+  }
 }
 
 /*******************************************************************************
@@ -983,7 +1065,10 @@ done:
  * Function         bta_gattc_cache_write
  *
  * Description      This callout function is executed by GATT when a server
- *                  cache is available to save.
+ *                  cache is available to save. The cache image is built
+ *                  here, but the disk I/O is deferred to a background
+ *                  writer thread so discovery completion is not taxed by
+ *                  flash latency right when the app starts its first reads.
  *
  * Parameter        server_bda: server bd address of this cache belongs to
  *                  attr: attributes to save.
@@ -995,35 +1080,32 @@ static void bta_gattc_cache_write(const RawAddress& server_bda,
   char fname[255] = {0};
   bta_gattc_generate_cache_file_name(fname, sizeof(fname), server_bda);
 
-  FILE* fd = fopen(fname, "wb");
-  if (!fd) {
-    LOG(ERROR) << __func__
-               << ": can't open GATT cache file for writing: " << fname;
-    return;
-  }
-
   uint16_t cache_ver = GATT_CACHE_VERSION;
-  if (fwrite(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__ << ": can't write GATT cache version: " << fname;
-    fclose(fd);
-    return;
-  }
-
   uint16_t num_attr = attr.size();
-  if (fwrite(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__
-               << ": can't write GATT cache attribute count: " << fname;
-    fclose(fd);
-    return;
-  }
+  std::vector<uint8_t> data(GATT_CACHE_HEADER_SIZE +
+                            num_attr * sizeof(StoredAttribute));
+  memcpy(data.data(), &cache_ver, sizeof(uint16_t));
+  memcpy(data.data() + sizeof(uint16_t), &num_attr, sizeof(uint16_t));
+  memcpy(data.data() + GATT_CACHE_HEADER_SIZE, attr.data(),
+         num_attr * sizeof(StoredAttribute));
 
-  if (fwrite(attr.data(), sizeof(StoredAttribute), num_attr, fd) != num_attr) {
-    LOG(ERROR) << __func__ << ": can't write GATT cache attributes: " << fname;
-    fclose(fd);
-    return;
+  {
+    std::lock_guard<std::mutex> lock(gattc_cache_write_lock);
+    if (gattc_cache_writer_thread == nullptr)
+      gattc_cache_writer_thread = thread_new("bta_gattc_cache");
+
+    bool already_pending = gattc_pending_cache_writes.count(fname) != 0;
+    gattc_pending_cache_writes[fname] = std::move(data);
+    /* the queued drain for this file will pick up the fresh image */
+    if (already_pending) return;
   }
 
-  fclose(fd);
+  if (gattc_cache_writer_thread == nullptr ||
+      !thread_post(gattc_cache_writer_thread, bta_gattc_cache_write_worker,
+                   new std::string(fname))) {
+    LOG(WARNING) << __func__ << ": no cache writer thread, writing in place";
+    bta_gattc_cache_write_worker(new std::string(fname));
+  }
 }
 
 /*******************************************************************************
@@ -34,243 +34,170 @@ using base::StringPrintf;
  * Constants and types
  ****************************************************************************/
 
-/* state machine action enumeration list */
-enum {
-  BTA_GATTC_OPEN,
-  BTA_GATTC_OPEN_FAIL,
-  BTA_GATTC_OPEN_ERROR,
-  BTA_GATTC_CANCEL_OPEN,
-  BTA_GATTC_CANCEL_OPEN_OK,
-  BTA_GATTC_CANCEL_OPEN_ERROR,
-  BTA_GATTC_CONN,
-  BTA_GATTC_START_DISCOVER,
-  BTA_GATTC_DISC_CMPL,
-  BTA_GATTC_Q_CMD,
-  BTA_GATTC_CLOSE,
-  BTA_GATTC_CLOSE_FAIL,
-  BTA_GATTC_READ,
-  BTA_GATTC_WRITE,
-  BTA_GATTC_OP_CMPL,
-  BTA_GATTC_SEARCH,
-  BTA_GATTC_FAIL,
-  BTA_GATTC_CONFIRM,
-  BTA_GATTC_EXEC,
-  BTA_GATTC_READ_MULTI,
-  BTA_GATTC_OP_CMPL_DURING_DISCOVERY,
-  BTA_GATTC_DISC_CLOSE,
-  BTA_GATTC_RESTART_DISCOVER,
-  BTA_GATTC_CFG_MTU,
-
-  BTA_GATTC_IGNORE
-};
 /* type for action functions */
 typedef void (*tBTA_GATTC_ACTION)(tBTA_GATTC_CLCB* p_clcb,
                                   const tBTA_GATTC_DATA* p_data);
 
-/* action function list */
-const tBTA_GATTC_ACTION bta_gattc_action[] = {
-    bta_gattc_open,                     /* BTA_GATTC_OPEN */
-    bta_gattc_open_fail,                /* BTA_GATTC_OPEN_FAIL */
-    bta_gattc_open_error,               /* BTA_GATTC_OPEN_ERROR */
-    bta_gattc_cancel_open,              /* BTA_GATTC_CANCEL_OPEN */
-    bta_gattc_cancel_open_ok,           /* BTA_GATTC_CANCEL_OPEN_OK */
-    bta_gattc_cancel_open_error,        /* BTA_GATTC_CANCEL_OPEN_ERROR */
-    bta_gattc_conn,                     /* BTA_GATTC_CONN */
-    bta_gattc_start_discover,           /* BTA_GATTC_START_DISCOVER */
-    bta_gattc_disc_cmpl,                /* BTA_GATTC_DISC_CMPL */
-    bta_gattc_q_cmd,                    /* BTA_GATTC_Q_CMD */
-    bta_gattc_close,                    /* BTA_GATTC_CLOSE */
-    bta_gattc_close_fail,               /* BTA_GATTC_CLOSE_FAIL */
-    bta_gattc_read,                     /* BTA_GATTC_READ */
-    bta_gattc_write,                    /* BTA_GATTC_WRITE */
-    bta_gattc_op_cmpl,                  /* BTA_GATTC_OP_CMPL */
-    bta_gattc_search,                   /* BTA_GATTC_SEARCH */
-    bta_gattc_fail,                     /* BTA_GATTC_FAIL */
-    bta_gattc_confirm,                  /* BTA_GATTC_CONFIRM */
-    bta_gattc_execute,                  /* BTA_GATTC_EXEC */
-    bta_gattc_read_multi,               /* BTA_GATTC_READ_MULTI */
-    bta_gattc_op_cmpl_during_discovery, /* BTA_GATTC_OP_CMPL_DURING_DISCOVERY */
-    bta_gattc_disc_close,               /* BTA_GATTC_DISC_CLOSE */
-    bta_gattc_restart_discover,         /* BTA_GATTC_RESTART_DISCOVER */
-    bta_gattc_cfg_mtu                   /* BTA_GATTC_CFG_MTU */
-};
-
-/* state table information */
-#define BTA_GATTC_ACTIONS 1    /* number of actions */
-#define BTA_GATTC_NEXT_STATE 1 /* position of next state */
-#define BTA_GATTC_NUM_COLS 2   /* number of columns in state tables */
-
-/* state table for idle state */
-static const uint8_t bta_gattc_st_idle[][BTA_GATTC_NUM_COLS] = {
-    /* Event                            Action 1                  Next state */
-    /* BTA_GATTC_API_OPEN_EVT           */ {BTA_GATTC_OPEN,
-                                            BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_INT_OPEN_FAIL_EVT      */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_API_CANCEL_OPEN_EVT    */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_INT_CANCEL_OPEN_OK_EVT */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_IDLE_ST},
-
-    /* BTA_GATTC_API_READ_EVT           */ {BTA_GATTC_FAIL, BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_API_WRITE_EVT          */ {BTA_GATTC_FAIL, BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_API_EXEC_EVT           */ {BTA_GATTC_FAIL, BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_API_CFG_MTU_EVT        */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_IDLE_ST},
-
-    /* BTA_GATTC_API_CLOSE_EVT          */ {BTA_GATTC_CLOSE_FAIL,
-                                            BTA_GATTC_IDLE_ST},
-
-    /* BTA_GATTC_API_SEARCH_EVT         */ {BTA_GATTC_FAIL, BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_API_CONFIRM_EVT        */ {BTA_GATTC_FAIL, BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_API_READ_MULTI_EVT     */ {BTA_GATTC_FAIL, BTA_GATTC_IDLE_ST},
-
-    /* BTA_GATTC_INT_CONN_EVT           */ {BTA_GATTC_CONN, BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_INT_DISCOVER_EVT       */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_DISCOVER_CMPL_EVT      */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_OP_CMPL_EVT            */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_INT_DISCONN_EVT       */ {BTA_GATTC_IGNORE, BTA_GATTC_IDLE_ST},
-
-};
-
-/* state table for wait for open state */
-static const uint8_t bta_gattc_st_w4_conn[][BTA_GATTC_NUM_COLS] = {
-    /* Event                            Action 1 Next state */
-    /* BTA_GATTC_API_OPEN_EVT           */ {BTA_GATTC_OPEN,
-                                            BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_INT_OPEN_FAIL_EVT      */ {BTA_GATTC_OPEN_FAIL,
-                                            BTA_GATTC_IDLE_ST},
-    /* BTA_GATTC_API_CANCEL_OPEN_EVT    */ {BTA_GATTC_CANCEL_OPEN,
-                                            BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_INT_CANCEL_OPEN_OK_EVT */ {BTA_GATTC_CANCEL_OPEN_OK,
-                                            BTA_GATTC_IDLE_ST},
-
-    /* BTA_GATTC_API_READ_EVT           */ {BTA_GATTC_FAIL,
-                                            BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_API_WRITE_EVT          */ {BTA_GATTC_FAIL,
-                                            BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_API_EXEC_EVT           */ {BTA_GATTC_FAIL,
-                                            BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_API_CFG_MTU_EVT        */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_W4_CONN_ST},
-
-    /* BTA_GATTC_API_CLOSE_EVT          */ {BTA_GATTC_CANCEL_OPEN,
-                                            BTA_GATTC_W4_CONN_ST},
-
-    /* BTA_GATTC_API_SEARCH_EVT         */ {BTA_GATTC_FAIL,
-                                            BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_API_CONFIRM_EVT        */ {BTA_GATTC_FAIL,
-                                            BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_API_READ_MULTI_EVT     */ {BTA_GATTC_FAIL,
-                                            BTA_GATTC_W4_CONN_ST},
-
-    /* BTA_GATTC_INT_CONN_EVT           */ {BTA_GATTC_CONN, BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_INT_DISCOVER_EVT       */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_DISCOVER_CMPL_EVT       */ {BTA_GATTC_IGNORE,
-                                             BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_OP_CMPL_EVT            */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_W4_CONN_ST},
-    /* BTA_GATTC_INT_DISCONN_EVT      */ {BTA_GATTC_OPEN_FAIL,
-                                          BTA_GATTC_IDLE_ST},
-
-};
-
-/* state table for open state */
-static const uint8_t bta_gattc_st_connected[][BTA_GATTC_NUM_COLS] = {
-    /* Event                            Action 1 Next state */
-    /* BTA_GATTC_API_OPEN_EVT           */ {BTA_GATTC_OPEN, BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_INT_OPEN_FAIL_EVT      */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_API_CANCEL_OPEN_EVT    */ {BTA_GATTC_CANCEL_OPEN_ERROR,
-                                            BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_INT_CANCEL_OPEN_OK_EVT */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_CONN_ST},
-
-    /* BTA_GATTC_API_READ_EVT           */ {BTA_GATTC_READ, BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_API_WRITE_EVT          */ {BTA_GATTC_WRITE, BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_API_EXEC_EVT           */ {BTA_GATTC_EXEC, BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_API_CFG_MTU_EVT        */ {BTA_GATTC_CFG_MTU,
-                                            BTA_GATTC_CONN_ST},
-
-    /* BTA_GATTC_API_CLOSE_EVT          */ {BTA_GATTC_CLOSE, BTA_GATTC_IDLE_ST},
-
-    /* BTA_GATTC_API_SEARCH_EVT         */ {BTA_GATTC_SEARCH,
-                                            BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_API_CONFIRM_EVT        */ {BTA_GATTC_CONFIRM,
-                                            BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_API_READ_MULTI_EVT     */ {BTA_GATTC_READ_MULTI,
-                                            BTA_GATTC_CONN_ST},
-
-    /* BTA_GATTC_INT_CONN_EVT           */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_INT_DISCOVER_EVT       */ {BTA_GATTC_START_DISCOVER,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_DISCOVER_CMPL_EVT       */ {BTA_GATTC_IGNORE,
-                                             BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_OP_CMPL_EVT            */ {BTA_GATTC_OP_CMPL,
-                                            BTA_GATTC_CONN_ST},
-
-    /* BTA_GATTC_INT_DISCONN_EVT        */ {BTA_GATTC_CLOSE, BTA_GATTC_IDLE_ST},
-
-};
-
-/* state table for discover state */
-static const uint8_t bta_gattc_st_discover[][BTA_GATTC_NUM_COLS] = {
-    /* Event                            Action 1 Next state */
-    /* BTA_GATTC_API_OPEN_EVT           */ {BTA_GATTC_OPEN,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_INT_OPEN_FAIL_EVT      */ {BTA_GATTC_IGNORE,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_API_CANCEL_OPEN_EVT    */ {BTA_GATTC_CANCEL_OPEN_ERROR,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_INT_CANCEL_OPEN_OK_EVT */ {BTA_GATTC_FAIL,
-                                            BTA_GATTC_DISCOVER_ST},
-
-    /* BTA_GATTC_API_READ_EVT           */ {BTA_GATTC_Q_CMD,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_API_WRITE_EVT          */ {BTA_GATTC_Q_CMD,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_API_EXEC_EVT           */ {BTA_GATTC_Q_CMD,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_API_CFG_MTU_EVT        */ {BTA_GATTC_Q_CMD,
-                                            BTA_GATTC_DISCOVER_ST},
-
-    /* BTA_GATTC_API_CLOSE_EVT          */ {BTA_GATTC_DISC_CLOSE,
-                                            BTA_GATTC_DISCOVER_ST},
-
-    /* BTA_GATTC_API_SEARCH_EVT         */ {BTA_GATTC_Q_CMD,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_API_CONFIRM_EVT        */ {BTA_GATTC_CONFIRM,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_API_READ_MULTI_EVT     */ {BTA_GATTC_Q_CMD,
-                                            BTA_GATTC_DISCOVER_ST},
-
-    /* BTA_GATTC_INT_CONN_EVT           */ {BTA_GATTC_CONN,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_INT_DISCOVER_EVT       */ {BTA_GATTC_RESTART_DISCOVER,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_DISCOVER_CMPL_EVT      */ {BTA_GATTC_DISC_CMPL,
-                                            BTA_GATTC_CONN_ST},
-    /* BTA_GATTC_OP_CMPL_EVT            */ {BTA_GATTC_OP_CMPL_DURING_DISCOVERY,
-                                            BTA_GATTC_DISCOVER_ST},
-    /* BTA_GATTC_INT_DISCONN_EVT        */ {BTA_GATTC_CLOSE, BTA_GATTC_IDLE_ST},
-
-};
+static bool bta_gattc_better_state_machine(tBTA_GATTC_CLCB* p_clcb,
+                                           uint16_t event,
+                                           const tBTA_GATTC_DATA* p_data) {
+  tBTA_GATTC_ACTION event_handler = nullptr;
+  switch (p_clcb->state) {
+    case BTA_GATTC_IDLE_ST:
+      switch (event) {
+        case BTA_GATTC_API_OPEN_EVT:
+          p_clcb->state = BTA_GATTC_W4_CONN_ST;
+          event_handler = &bta_gattc_open;
+          break;
+        case BTA_GATTC_API_READ_EVT:
+        case BTA_GATTC_API_WRITE_EVT:
+        case BTA_GATTC_API_EXEC_EVT:
+        case BTA_GATTC_API_SEARCH_EVT:
+        case BTA_GATTC_API_CONFIRM_EVT:
+        case BTA_GATTC_API_READ_MULTI_EVT:
+          event_handler = &bta_gattc_fail;
+          break;
+        case BTA_GATTC_API_CLOSE_EVT:
+          event_handler = &bta_gattc_close_fail;
+          break;
+        case BTA_GATTC_INT_CONN_EVT:
+          p_clcb->state = BTA_GATTC_CONN_ST;
+          event_handler = &bta_gattc_conn;
+          break;
+      }
+      break;
+    case BTA_GATTC_W4_CONN_ST:
+      switch (event) {
+        case BTA_GATTC_API_OPEN_EVT:
+          event_handler = &bta_gattc_open;
+          break;
+        case BTA_GATTC_INT_OPEN_FAIL_EVT:
+        case BTA_GATTC_INT_DISCONN_EVT:
+          p_clcb->state = BTA_GATTC_IDLE_ST;
+          event_handler = &bta_gattc_open_fail;
+          break;
+        case BTA_GATTC_API_CANCEL_OPEN_EVT:
+        case BTA_GATTC_API_CLOSE_EVT:
+          event_handler = &bta_gattc_cancel_open;
+          break;
+        case BTA_GATTC_INT_CANCEL_OPEN_OK_EVT:
+          p_clcb->state = BTA_GATTC_IDLE_ST;
+          event_handler = &bta_gattc_cancel_open_ok;
+          break;
+        case BTA_GATTC_API_READ_EVT:
+        case BTA_GATTC_API_WRITE_EVT:
+        case BTA_GATTC_API_EXEC_EVT:
+        case BTA_GATTC_API_SEARCH_EVT:
+        case BTA_GATTC_API_CONFIRM_EVT:
+        case BTA_GATTC_API_READ_MULTI_EVT:
+          event_handler = &bta_gattc_fail;
+          break;
+        case BTA_GATTC_INT_CONN_EVT:
+          p_clcb->state = BTA_GATTC_CONN_ST;
+          event_handler = &bta_gattc_conn;
+          break;
+      }
+      break;
+    case BTA_GATTC_CONN_ST:
+      switch (event) {
+        case BTA_GATTC_API_OPEN_EVT:
+          event_handler = &bta_gattc_open;
+          break;
+        case BTA_GATTC_API_CANCEL_OPEN_EVT:
+          event_handler = &bta_gattc_cancel_open_error;
+          break;
+        case BTA_GATTC_API_READ_EVT:
+          event_handler = &bta_gattc_read;
+          break;
+        case BTA_GATTC_API_WRITE_EVT:
+          event_handler = &bta_gattc_write;
+          break;
+        case BTA_GATTC_API_EXEC_EVT:
+          event_handler = &bta_gattc_execute;
+          break;
+        case BTA_GATTC_API_CFG_MTU_EVT:
+          event_handler = &bta_gattc_cfg_mtu;
+          break;
+        case BTA_GATTC_API_CLOSE_EVT:
+        case BTA_GATTC_INT_DISCONN_EVT:
+          p_clcb->state = BTA_GATTC_IDLE_ST;
+          event_handler = &bta_gattc_close;
+          break;
+        case BTA_GATTC_API_SEARCH_EVT:
+          event_handler = &bta_gattc_search;
+          break;
+        case BTA_GATTC_API_CONFIRM_EVT:
+          event_handler = &bta_gattc_confirm;
+          break;
+        case BTA_GATTC_API_READ_MULTI_EVT:
+          event_handler = &bta_gattc_read_multi;
+          break;
+        case BTA_GATTC_INT_DISCOVER_EVT:
+          p_clcb->state = BTA_GATTC_DISCOVER_ST;
+          event_handler = &bta_gattc_start_discover;
+          break;
+        case BTA_GATTC_OP_CMPL_EVT:
+          event_handler = &bta_gattc_op_cmpl;
+          break;
+      }
+      break;
+    case BTA_GATTC_DISCOVER_ST:
+      switch (event) {
+        case BTA_GATTC_API_OPEN_EVT:
+          event_handler = &bta_gattc_open;
+          break;
+        case BTA_GATTC_API_CANCEL_OPEN_EVT:
+          event_handler = &bta_gattc_cancel_open_error;
+          break;
+        case BTA_GATTC_INT_CANCEL_OPEN_OK_EVT:
+          event_handler = &bta_gattc_fail;
+          break;
+        case BTA_GATTC_API_READ_EVT:
+        case BTA_GATTC_API_WRITE_EVT:
+        case BTA_GATTC_API_EXEC_EVT:
+        case BTA_GATTC_API_CFG_MTU_EVT:
+        case BTA_GATTC_API_SEARCH_EVT:
+        case BTA_GATTC_API_READ_MULTI_EVT:
+          event_handler = &bta_gattc_q_cmd;
+          break;
+        case BTA_GATTC_API_CLOSE_EVT:
+          event_handler = &bta_gattc_disc_close;
+          break;
+        case BTA_GATTC_INT_DISCONN_EVT:
+          p_clcb->state = BTA_GATTC_IDLE_ST;
+          event_handler = &bta_gattc_close;
+          break;
+        case BTA_GATTC_API_CONFIRM_EVT:
+          event_handler = &bta_gattc_confirm;
+          break;
+        case BTA_GATTC_INT_CONN_EVT:
+          event_handler = &bta_gattc_conn;
+          break;
+        case BTA_GATTC_INT_DISCOVER_EVT:
+          event_handler = &bta_gattc_restart_discover;
+          break;
+        case BTA_GATTC_DISCOVER_CMPL_EVT:
+          p_clcb->state = BTA_GATTC_CONN_ST;
+          event_handler = &bta_gattc_disc_cmpl;
+          break;
+        case BTA_GATTC_OP_CMPL_EVT:
+          event_handler = &bta_gattc_op_cmpl_during_discovery;
+          break;
+      }
+      break;
+  }
 
-/* type for state table */
-typedef const uint8_t (*tBTA_GATTC_ST_TBL)[BTA_GATTC_NUM_COLS];
+  if (event_handler == nullptr) return true;
 
-/* state table */
-const tBTA_GATTC_ST_TBL bta_gattc_st_tbl[] = {
-    bta_gattc_st_idle,      /* BTA_GATTC_IDLE_ST */
-    bta_gattc_st_w4_conn,   /* BTA_GATTC_W4_CONN_ST */
-    bta_gattc_st_connected, /* BTA_GATTC_CONN_ST */
-    bta_gattc_st_discover   /* BTA_GATTC_DISCOVER_ST */
-};
+  (*event_handler)(p_clcb, p_data);
+  if (p_clcb->p_q_cmd == p_data) {
+    /* buffer is queued, don't free in the bta dispatcher.
+     * we free it ourselves when a completion event is received.
+     */
+    return false;
+  }
+  return true;
+}
 
 /*****************************************************************************
  * Global data
@@ -297,10 +224,6 @@ static const char* gattc_state_code(tBTA_GATTC_STATE state_code);
  ******************************************************************************/
 bool bta_gattc_sm_execute(tBTA_GATTC_CLCB* p_clcb, uint16_t event,
                           const tBTA_GATTC_DATA* p_data) {
-  tBTA_GATTC_ST_TBL state_table;
-  uint8_t action;
-  int i;
-  bool rt = true;
   tBTA_GATTC_STATE in_state = p_clcb->state;
   uint16_t in_event = event;
 #if (BTA_GATT_DEBUG == TRUE)
@@ -312,29 +235,7 @@ bool bta_gattc_sm_execute(tBTA_GATTC_CLCB* p_clcb, uint16_t event,
                           in_event);
 #endif
 
-  /* look up the state table for the current state */
-  state_table = bta_gattc_st_tbl[p_clcb->state];
-
-  event &= 0x00FF;
-
-  /* set next state */
-  p_clcb->state = state_table[event][BTA_GATTC_NEXT_STATE];
-
-  /* execute action functions */
-  for (i = 0; i < BTA_GATTC_ACTIONS; i++) {
-    action = state_table[event][i];
-    if (action != BTA_GATTC_IGNORE) {
-      (*bta_gattc_action[action])(p_clcb, p_data);
-      if (p_clcb->p_q_cmd == p_data) {
-        /* buffer is queued, don't free in the bta dispatcher.
-         * we free it ourselves when a completion event is received.
-         */
-        rt = false;
-      }
-    } else {
-      break;
-    }
-  }
+  bool rt = bta_gattc_better_state_machine(p_clcb, event, p_data);
 
 #if (BTA_GATT_DEBUG == TRUE)
   if (in_state != p_clcb->state) {
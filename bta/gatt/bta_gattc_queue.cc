@@ -19,6 +19,9 @@
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+
+#include "osi/include/tracepoint.h"
 
 using gatt_operation = BtaGattQueue::gatt_operation;
 
@@ -31,31 +34,79 @@ constexpr uint8_t GATT_CONFIG_MTU = 5;
 struct gatt_read_op_data {
   GATT_READ_OP_CB cb;
   void* cb_data;
+  /* callbacks of duplicate reads sharing this operation's response */
+  std::vector<std::pair<GATT_READ_OP_CB, void*>> extra_cbs;
 };
 
 std::unordered_map<uint16_t, std::list<gatt_operation>>
     BtaGattQueue::gatt_op_queue;
 std::unordered_set<uint16_t> BtaGattQueue::gatt_op_queue_executing;
+std::unordered_map<uint16_t, BtaGattQueue::gatt_in_flight_read>
+    BtaGattQueue::gatt_read_in_flight;
 
 void BtaGattQueue::mark_as_not_executing(uint16_t conn_id) {
+  TRACEPOINT(TRACE_GATT_OP_COMPLETE, conn_id, 0);
   gatt_op_queue_executing.erase(conn_id);
 }
 
+/* Attach a read of |handle| to an identical read already queued or on the
+ * air, so both callers share one response. Scans the queue newest to oldest;
+ * a write to the same handle in between forbids sharing the older read's
+ * response, as the duplicate must observe the written value. */
+bool BtaGattQueue::gatt_try_coalesce_read(uint16_t conn_id, uint8_t type,
+                                          uint16_t handle, GATT_READ_OP_CB cb,
+                                          void* cb_data) {
+  auto map_ptr = gatt_op_queue.find(conn_id);
+  if (map_ptr != gatt_op_queue.end()) {
+    for (auto it = map_ptr->second.rbegin(); it != map_ptr->second.rend();
+         ++it) {
+      if (it->handle != handle) continue;
+      if (it->type == type) {
+        it->extra_read_cbs.emplace_back(cb, cb_data);
+        return true;
+      }
+      return false;
+    }
+  }
+
+  auto in_flight = gatt_read_in_flight.find(conn_id);
+  if (in_flight == gatt_read_in_flight.end() ||
+      in_flight->second.type != type || in_flight->second.handle != handle) {
+    return false;
+  }
+
+  ((gatt_read_op_data*)in_flight->second.op_data)
+      ->extra_cbs.emplace_back(cb, cb_data);
+  return true;
+}
+
 void BtaGattQueue::gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                          uint16_t handle, uint16_t len,
                                          uint8_t* value, void* data) {
   gatt_read_op_data* tmp = (gatt_read_op_data*)data;
   GATT_READ_OP_CB tmp_cb = tmp->cb;
   void* tmp_cb_data = tmp->cb_data;
+  std::vector<std::pair<GATT_READ_OP_CB, void*>> extra_cbs =
+      std::move(tmp->extra_cbs);
 
-  osi_free(data);
+  delete tmp;
+
+  auto in_flight = gatt_read_in_flight.find(conn_id);
+  if (in_flight != gatt_read_in_flight.end() &&
+      in_flight->second.op_data == data) {
+    gatt_read_in_flight.erase(in_flight);
+  }
 
   mark_as_not_executing(conn_id);
   gatt_execute_next_op(conn_id);
 
   if (tmp_cb) {
     tmp_cb(conn_id, status, handle, len, value, tmp_cb_data);
-    return;
+  }
+  for (const auto& extra : extra_cbs) {
+    if (extra.first) {
+      extra.first(conn_id, status, handle, len, value, extra.second);
+    }
   }
 }
 
@@ -130,18 +181,20 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
   gatt_operation& op = gatt_ops.front();
 
   if (op.type == GATT_READ_CHAR) {
-    gatt_read_op_data* data =
-        (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
+    gatt_read_op_data* data = new gatt_read_op_data;
     data->cb = op.read_cb;
     data->cb_data = op.read_cb_data;
+    data->extra_cbs = std::move(op.extra_read_cbs);
+    gatt_read_in_flight[conn_id] = {op.type, op.handle, data};
     BTA_GATTC_ReadCharacteristic(conn_id, op.handle, GATT_AUTH_REQ_NONE,
                                  gatt_read_op_finished, data);
 
   } else if (op.type == GATT_READ_DESC) {
-    gatt_read_op_data* data =
-        (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
+    gatt_read_op_data* data = new gatt_read_op_data;
     data->cb = op.read_cb;
     data->cb_data = op.read_cb_data;
+    data->extra_cbs = std::move(op.extra_read_cbs);
+    gatt_read_in_flight[conn_id] = {op.type, op.handle, data};
     BTA_GATTC_ReadCharDescr(conn_id, op.handle, GATT_AUTH_REQ_NONE,
                             gatt_read_op_finished, data);
 
@@ -177,23 +230,32 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
 void BtaGattQueue::Clean(uint16_t conn_id) {
   gatt_op_queue.erase(conn_id);
   gatt_op_queue_executing.erase(conn_id);
+  gatt_read_in_flight.erase(conn_id);
 }
 
 void BtaGattQueue::ReadCharacteristic(uint16_t conn_id, uint16_t handle,
                                       GATT_READ_OP_CB cb, void* cb_data) {
+  if (gatt_try_coalesce_read(conn_id, GATT_READ_CHAR, handle, cb, cb_data))
+    return;
+
   gatt_op_queue[conn_id].push_back({.type = GATT_READ_CHAR,
                                     .handle = handle,
                                     .read_cb = cb,
                                     .read_cb_data = cb_data});
+  TRACEPOINT(TRACE_GATT_OP_ENQUEUE, conn_id, (GATT_READ_CHAR << 16) | handle);
   gatt_execute_next_op(conn_id);
 }
 
 void BtaGattQueue::ReadDescriptor(uint16_t conn_id, uint16_t handle,
                                   GATT_READ_OP_CB cb, void* cb_data) {
+  if (gatt_try_coalesce_read(conn_id, GATT_READ_DESC, handle, cb, cb_data))
+    return;
+
   gatt_op_queue[conn_id].push_back({.type = GATT_READ_DESC,
                                     .handle = handle,
                                     .read_cb = cb,
                                     .read_cb_data = cb_data});
+  TRACEPOINT(TRACE_GATT_OP_ENQUEUE, conn_id, (GATT_READ_DESC << 16) | handle);
   gatt_execute_next_op(conn_id);
 }
 
@@ -207,6 +269,7 @@ void BtaGattQueue::WriteCharacteristic(uint16_t conn_id, uint16_t handle,
                                     .write_cb_data = cb_data,
                                     .write_type = write_type,
                                     .value = std::move(value)});
+  TRACEPOINT(TRACE_GATT_OP_ENQUEUE, conn_id, (GATT_WRITE_CHAR << 16) | handle);
   gatt_execute_next_op(conn_id);
 }
 
@@ -220,6 +283,7 @@ void BtaGattQueue::WriteDescriptor(uint16_t conn_id, uint16_t handle,
                                     .write_cb_data = cb_data,
                                     .write_type = write_type,
                                     .value = std::move(value)});
+  TRACEPOINT(TRACE_GATT_OP_ENQUEUE, conn_id, (GATT_WRITE_DESC << 16) | handle);
   gatt_execute_next_op(conn_id);
 }
 
@@ -229,5 +293,6 @@ void BtaGattQueue::ConfigureMtu(uint16_t conn_id, uint16_t mtu) {
                                 static_cast<uint8_t>(mtu >> 8)};
   gatt_op_queue[conn_id].push_back({.type = GATT_CONFIG_MTU,
                                     .value = std::move(value)});
+  TRACEPOINT(TRACE_GATT_OP_ENQUEUE, conn_id, GATT_CONFIG_MTU << 16);
   gatt_execute_next_op(conn_id);
 }
@@ -135,11 +135,17 @@ std::vector<StoredAttribute> Database::Serialize() const {
 
 Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
                                bool* success) {
+  return Deserialize(nv_attr.data(), nv_attr.size(), success);
+}
+
+Database Database::Deserialize(const StoredAttribute* nv_attr, size_t num_attr,
+                               bool* success) {
   // clear reallocating
   Database result;
-  auto it = nv_attr.cbegin();
+  const StoredAttribute* it = nv_attr;
+  const StoredAttribute* end = nv_attr + num_attr;
 
-  for (; it != nv_attr.cend(); ++it) {
+  for (; it != end; ++it) {
     const auto& attr = *it;
     if (attr.type != PRIMARY_SERVICE && attr.type != SECONDARY_SERVICE) break;
     result.services.emplace_back(Service{
@@ -151,7 +157,7 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
   }
 
   auto current_service_it = result.services.begin();
-  for (; it != nv_attr.cend(); it++) {
+  for (; it != end; it++) {
     const auto& attr = *it;
 
     // go to the service this attribute belongs to; attributes are stored in
@@ -304,4 +310,16 @@ Octet16 Database::Hash() const {
   return crypto_toolbox::aes_cmac(Octet16{0}, serialized.data(),
                                   serialized.size());
 }
+
+bool Database::HasDatabaseHash() const {
+  for (const Service& service : services) {
+    for (const Characteristic& c : service.characteristics) {
+      if (UuidSize(c.uuid) == Uuid::kNumBytes16 &&
+          c.uuid.As16Bit() == GATT_UUID_DATABASE_HASH) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
 }  // namespace gatt
@@ -119,9 +119,18 @@ class Database {
   static Database Deserialize(const std::vector<gatt::StoredAttribute>& nv_attr,
                               bool* success);
 
+  /* Same as above, but reads the attributes in place - i.e. straight out of
+   * an mmap-ed cache file - without copying them into a vector first. */
+  static Database Deserialize(const gatt::StoredAttribute* nv_attr,
+                              size_t num_attr, bool* success);
+
   /* Return 128 bit unique identifier of this GATT database */
   Octet16 Hash() const;
 
+  /* Return true if the database contains the Database Hash characteristic,
+   * i.e. the server supports robust caching */
+  bool HasDatabaseHash() const;
+
   friend class DatabaseBuilder;
 
  private:
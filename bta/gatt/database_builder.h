@@ -38,10 +38,12 @@ class DatabaseBuilder {
   void AddDescriptor(uint16_t handle, const bluetooth::Uuid& uuid);
 
   /* Returns true if next service exploration started, false if there are no
-   * more services to explore. */
+   * more services to explore. Directly adjacent services are merged into a
+   * single exploration range to save round trips. */
   bool StartNextServiceExploration();
 
-  /* Return pair with start and end handle of the currently explored service.
+  /* Return pair with start and end handle of the currently explored service
+   * range - may cover multiple adjacent services.
    */
   const std::pair<uint16_t, uint16_t>& CurrentlyExploredService();
 
@@ -80,8 +82,8 @@ class DatabaseBuilder {
 
  private:
   Database database;
-  /* Start and end handle of service that is currently being discovered on the
-   * remote device */
+  /* Start and end handle of the service range that is currently being
+   * discovered on the remote device */
   std::pair<uint16_t, uint16_t> pending_service;
   /* Characteristic inside pending_service that is currently being explored */
   uint16_t pending_characteristic;
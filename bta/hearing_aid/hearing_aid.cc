@@ -29,6 +29,7 @@
 #include "bta/include/bta_gatt_api.h"
 #include "bta/include/bta_gatt_queue.h"
 #include "bta/include/bta_hearing_aid_api.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "embdrv/g722/g722_enc_dec.h"
 #include "osi/include/log.h"
@@ -70,6 +71,13 @@ constexpr uint8_t STATE_CHANGE_OTHER_SIDE_DISCONNECTED = 0x00;
 constexpr uint8_t STATE_CHANGE_OTHER_SIDE_CONNECTED = 0x01;
 constexpr uint8_t STATE_CHANGE_CONN_UPDATE = 0x02;
 
+// Thresholds on the credit stall EWMA (permille of wall time spent
+// congested) driving the adaptive thinning policy. Below RESUME the stream
+// goes back to full rate; above STOP even a thinned stream is unsustainable
+// and the audio source is stopped, as it always was before thinning existed.
+constexpr uint32_t STALL_EWMA_RESUME_PERMILLE = 50;
+constexpr uint32_t STALL_EWMA_STOP_PERMILLE = 400;
+
 // used to mark current_volume as not yet known, or possibly old
 constexpr int8_t VOLUME_UNKNOWN = 127;
 constexpr int8_t VOLUME_MIN = -127;
@@ -1218,6 +1226,9 @@ class HearingAidImpl : public HearingAid {
     // TODO: make those buffers static and global to prevent constant
     // reallocations
     // TODO: this should basically fit the encoded data, tune the size later
+    uint16_t left_to_flush = 0;
+    uint16_t right_to_flush = 0;
+
     std::vector<uint8_t> encoded_data_left;
     if (left) {
       // TODO: instead of a magic number, we need to figure out the correct
@@ -1229,11 +1240,11 @@ class HearingAidImpl : public HearingAid {
       encoded_data_left.resize(encoded_size);
 
       uint16_t cid = GAP_ConnGetL2CAPCid(left->gap_handle);
-      uint16_t packets_to_flush = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
-      if (packets_to_flush) {
-        VLOG(2) << left->address << " skipping " << packets_to_flush
+      left_to_flush = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
+      if (left_to_flush) {
+        VLOG(2) << left->address << " skipping " << left_to_flush
                 << " packets";
-        left->audio_stats.packet_flush_count += packets_to_flush;
+        left->audio_stats.packet_flush_count += left_to_flush;
         left->audio_stats.frame_flush_count++;
         hearingDevices.StartRssiLog();
       }
@@ -1253,11 +1264,11 @@ class HearingAidImpl : public HearingAid {
       encoded_data_right.resize(encoded_size);
 
       uint16_t cid = GAP_ConnGetL2CAPCid(right->gap_handle);
-      uint16_t packets_to_flush = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
-      if (packets_to_flush) {
-        VLOG(2) << right->address << " skipping " << packets_to_flush
+      right_to_flush = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
+      if (right_to_flush) {
+        VLOG(2) << right->address << " skipping " << right_to_flush
                 << " packets";
-        right->audio_stats.packet_flush_count += packets_to_flush;
+        right->audio_stats.packet_flush_count += right_to_flush;
         right->audio_stats.frame_flush_count++;
         hearingDevices.StartRssiLog();
       }
@@ -1266,6 +1277,18 @@ class HearingAidImpl : public HearingAid {
       check_and_do_rssi_read(right);
     }
 
+    /* A one-sided backlog means that ear just concealed audio its partner
+     * played - the audible symptom of the ears drifting apart. Both devices
+     * realign on the sequence counter below, but keep count of these events
+     * so dumpsys can attribute reported binaural artifacts to the weak ear.
+     */
+    if (left && right && ((left_to_flush == 0) != (right_to_flush == 0))) {
+      if (left_to_flush)
+        left->audio_stats.lone_flush_count++;
+      else
+        right->audio_stats.lone_flush_count++;
+    }
+
     size_t encoded_data_size =
         std::max(encoded_data_left.size(), encoded_data_right.size());
 
@@ -1297,6 +1320,17 @@ class HearingAidImpl : public HearingAid {
       return;
     }
 
+    if (hearingAid->stream_thinned) {
+      // Withhold every other packet so the channel's credit debt drains
+      // instead of deepening; G.722 conceals a 20ms gap far better than a
+      // full stream stop.
+      hearingAid->thin_phase = !hearingAid->thin_phase;
+      if (hearingAid->thin_phase) {
+        hearingAid->audio_stats.thin_drop_count++;
+        return;
+      }
+    }
+
     BT_HDR* audio_packet = malloc_l2cap_buf(packet_size + 1);
     uint8_t* p = get_l2cap_sdu_start_ptr(audio_packet);
     *p = seq_counter;
@@ -1338,6 +1372,7 @@ class HearingAidImpl : public HearingAid {
         hearingDevice->gap_handle = 0;
         hearingDevice->playback_started = false;
         hearingDevice->command_acked = false;
+        hearingDevice->stream_thinned = false;
         break;
       case GAP_EVT_CONN_DATA_AVAIL: {
         DVLOG(2) << "GAP_EVT_CONN_DATA_AVAIL";
@@ -1370,12 +1405,49 @@ class HearingAidImpl : public HearingAid {
         break;
       }
 
-      case GAP_EVT_TX_EMPTY:
+      case GAP_EVT_TX_EMPTY: {
         DVLOG(2) << "GAP_EVT_TX_EMPTY";
+
+        // An empty TX queue outside a congestion episode means the channel
+        // is healthy; decay the stall EWMA at most once a second so a
+        // thinned stream can earn its way back to full rate.
+        AudioStats* stats = &hearingDevice->audio_stats;
+        uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+        if (stats->congestion_start_ms == 0 &&
+            now_ms - stats->last_uncongested_ms >= 1000) {
+          stats->stall_ewma_permille -= stats->stall_ewma_permille / 4;
+          stats->last_uncongested_ms = now_ms;
+          if (hearingDevice->stream_thinned &&
+              stats->stall_ewma_permille <= STALL_EWMA_RESUME_PERMILLE) {
+            LOG(INFO) << __func__ << ": restoring full packet rate to "
+                      << hearingDevice->address
+                      << ", stall EWMA=" << stats->stall_ewma_permille;
+            hearingDevice->stream_thinned = false;
+          }
+        }
         break;
+      }
       case GAP_EVT_CONN_CONGESTED:
         DVLOG(2) << "GAP_EVT_CONN_CONGESTED";
 
+        hearingDevice->audio_stats.credit_stall_count++;
+        hearingDevice->audio_stats.congestion_start_ms =
+            bluetooth::common::time_get_os_boottime_ms();
+
+        if (!hearingDevice->stream_thinned &&
+            hearingDevice->audio_stats.stall_ewma_permille <
+                STALL_EWMA_STOP_PERMILLE) {
+          // First resort: halve the packet rate and let the credits drain,
+          // instead of tearing the whole stream down over one stall.
+          LOG(INFO) << __func__ << ": thinning stream to "
+                    << hearingDevice->address << ", stall EWMA="
+                    << hearingDevice->audio_stats.stall_ewma_permille;
+          hearingDevice->stream_thinned = true;
+          break;
+        }
+
+        // Already thinned, or chronically stalled - the link cannot sustain
+        // the stream at all.
         // TODO: make it into function
         HearingAidAudioSource::Stop();
         // TODO: kill the encoder only if all hearing aids are down.
@@ -1383,9 +1455,30 @@ class HearingAidImpl : public HearingAid {
         // encoder_state_left = nulllptr;
         // encoder_state_right = nulllptr;
         break;
-      case GAP_EVT_CONN_UNCONGESTED:
+      case GAP_EVT_CONN_UNCONGESTED: {
         DVLOG(2) << "GAP_EVT_CONN_UNCONGESTED";
+
+        AudioStats* stats = &hearingDevice->audio_stats;
+        if (stats->congestion_start_ms) {
+          uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+          uint64_t stall_ms = now_ms - stats->congestion_start_ms;
+          stats->credit_stall_ms_total += stall_ms;
+          stats->congestion_start_ms = 0;
+
+          // Fold the fraction of the window spent stalled into the EWMA.
+          uint64_t window_ms = stats->last_uncongested_ms
+                                   ? now_ms - stats->last_uncongested_ms
+                                   : stall_ms;
+          uint32_t sample_permille =
+              (window_ms >= stall_ms && window_ms != 0)
+                  ? (uint32_t)(stall_ms * 1000 / window_ms)
+                  : 1000;
+          stats->stall_ewma_permille =
+              (3 * stats->stall_ewma_permille + sample_permille) / 4;
+          stats->last_uncongested_ms = now_ms;
+        }
         break;
+      }
     }
   }
 
@@ -1444,7 +1537,17 @@ class HearingAidImpl : public HearingAid {
           << device.audio_stats.packet_flush_count
           << "\n    Frame counts (enqueued/flushed)                         : "
           << device.audio_stats.frame_send_count << " / "
-          << device.audio_stats.frame_flush_count << std::endl;
+          << device.audio_stats.frame_flush_count
+          << "\n    Lone flush events (binaural desync)                     : "
+          << device.audio_stats.lone_flush_count
+          << "\n    Credit stalls (count/total ms)                          : "
+          << device.audio_stats.credit_stall_count << " / "
+          << device.audio_stats.credit_stall_ms_total
+          << "\n    Stall EWMA permille / thinned packets                   : "
+          << device.audio_stats.stall_ewma_permille << " / "
+          << device.audio_stats.thin_drop_count
+          << (device.stream_thinned ? " (stream currently thinned)" : "")
+          << std::endl;
 
       DumpRssi(fd, device);
     }
@@ -1680,7 +1783,9 @@ class HearingAidImpl : public HearingAid {
       if (device->num_intervals_since_last_rssi_read >= PERIOD_TO_READ_RSSI_IN_INTERVALS) {
         device->num_intervals_since_last_rssi_read = 0;
         VLOG(1) << __func__ << ": device=" << device->address;
-        BTM_ReadRSSI(device->address, read_rssi_cb);
+        // One-shot through the shared poller; both ears and any other
+        // subsystem watching this link share a single HCI read
+        BTM_LinkMetricsSubscribe(device->address, 0, read_rssi_cb);
       }
     }
   }
@@ -166,20 +166,76 @@ static void bta_hf_client_stop_at_resp_timer(tBTA_HF_CLIENT_CB* client_cb) {
   alarm_cancel(client_cb->at_cb.resp_timer);
 }
 
+/* Whether a command may have other commands in flight around it. Safe
+ * commands are the independent setting/query ones: their responses are
+ * self-identifying and handling OK/ERROR for them neither sends further
+ * commands nor changes channel state. COPS and CNUM stay serial because
+ * their responses may be spoofed locally when there is no service. */
+static bool bta_hf_client_at_cmd_pipelinable(tBTA_HF_CLIENT_AT_CMD cmd) {
+  switch (cmd) {
+    case BTA_HF_CLIENT_AT_CLIP:
+    case BTA_HF_CLIENT_AT_CCWA:
+    case BTA_HF_CLIENT_AT_CMEE:
+    case BTA_HF_CLIENT_AT_BIA:
+    case BTA_HF_CLIENT_AT_CLCC:
+    case BTA_HF_CLIENT_AT_VGS:
+    case BTA_HF_CLIENT_AT_VGM:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/* Whether |cmd| can be written to the port now rather than queued */
+static bool bta_hf_client_at_tx_ready(tBTA_HF_CLIENT_CB* client_cb,
+                                      tBTA_HF_CLIENT_AT_CMD cmd) {
+  tBTA_HF_CLIENT_AT_CB* at_cb = &client_cb->at_cb;
+
+  if (alarm_is_scheduled(at_cb->hold_timer)) return false;
+
+  if (at_cb->current_cmd == BTA_HF_CLIENT_AT_NONE || !client_cb->svc_conn)
+    return true;
+
+  /* pipeline an independent command behind other independent commands;
+   * responses arrive in command order, so the oldest in-flight command
+   * is always the one being answered */
+  return at_cb->pipelined_cnt < BTA_HF_CLIENT_AT_PIPELINE_DEPTH &&
+         bta_hf_client_at_cmd_pipelinable(at_cb->current_cmd) &&
+         bta_hf_client_at_cmd_pipelinable(cmd);
+}
+
+/* Promote the oldest pipelined command to current after a response */
+static void bta_hf_client_at_pipeline_pop(tBTA_HF_CLIENT_CB* client_cb) {
+  tBTA_HF_CLIENT_AT_CB* at_cb = &client_cb->at_cb;
+
+  if (at_cb->pipelined_cnt == 0) return;
+
+  at_cb->current_cmd = at_cb->pipelined[0];
+  at_cb->pipelined_cnt--;
+  for (uint8_t i = 0; i < at_cb->pipelined_cnt; i++)
+    at_cb->pipelined[i] = at_cb->pipelined[i + 1];
+
+  /* keep the response timer covering the new oldest command */
+  bta_hf_client_start_at_resp_timer(client_cb);
+}
+
 static void bta_hf_client_send_at(tBTA_HF_CLIENT_CB* client_cb,
                                   tBTA_HF_CLIENT_AT_CMD cmd, const char* buf,
                                   uint16_t buf_len) {
   APPL_TRACE_DEBUG("%s", __func__);
-  if ((client_cb->at_cb.current_cmd == BTA_HF_CLIENT_AT_NONE ||
-       !client_cb->svc_conn) &&
-      !alarm_is_scheduled(client_cb->at_cb.hold_timer)) {
+  if (bta_hf_client_at_tx_ready(client_cb, cmd)) {
     uint16_t len;
 
 #ifdef BTA_HF_CLIENT_AT_DUMP
     APPL_TRACE_DEBUG("%s: %.*s", __func__, buf_len - 1, buf);
 #endif
 
-    client_cb->at_cb.current_cmd = cmd;
+    if (client_cb->at_cb.current_cmd == BTA_HF_CLIENT_AT_NONE ||
+        !client_cb->svc_conn) {
+      client_cb->at_cb.current_cmd = cmd;
+    } else {
+      client_cb->at_cb.pipelined[client_cb->at_cb.pipelined_cnt++] = cmd;
+    }
     /* Generate fake responses for these because they won't reliably work */
     if (!service_availability &&
         (cmd == BTA_HF_CLIENT_AT_CNUM || cmd == BTA_HF_CLIENT_AT_COPS)) {
@@ -201,11 +257,14 @@ static void bta_hf_client_send_at(tBTA_HF_CLIENT_CB* client_cb,
 }
 
 static void bta_hf_client_send_queued_at(tBTA_HF_CLIENT_CB* client_cb) {
-  tBTA_HF_CLIENT_AT_QCMD* cur = client_cb->at_cb.queued_cmd;
-
   APPL_TRACE_DEBUG("%s", __func__);
 
-  if (cur != NULL) {
+  /* drain as many queued commands as the pipeline allows */
+  while (client_cb->at_cb.queued_cmd != NULL) {
+    tBTA_HF_CLIENT_AT_QCMD* cur = client_cb->at_cb.queued_cmd;
+
+    if (!bta_hf_client_at_tx_ready(client_cb, cur->cmd)) break;
+
     client_cb->at_cb.queued_cmd = cur->next;
 
     bta_hf_client_send_at(client_cb, cur->cmd, cur->buf, cur->buf_len);
@@ -273,6 +332,7 @@ static void bta_hf_client_handle_ok(tBTA_HF_CLIENT_CB* client_cb) {
   }
 
   client_cb->at_cb.current_cmd = BTA_HF_CLIENT_AT_NONE;
+  bta_hf_client_at_pipeline_pop(client_cb);
 
   bta_hf_client_send_queued_at(client_cb);
 }
@@ -309,6 +369,7 @@ static void bta_hf_client_handle_error(tBTA_HF_CLIENT_CB* client_cb,
   }
 
   client_cb->at_cb.current_cmd = BTA_HF_CLIENT_AT_NONE;
+  bta_hf_client_at_pipeline_pop(client_cb);
 
   bta_hf_client_send_queued_at(client_cb);
 }
@@ -2188,6 +2249,7 @@ void bta_hf_client_at_reset(tBTA_HF_CLIENT_CB* client_cb) {
   }
 
   client_cb->at_cb.current_cmd = BTA_HF_CLIENT_AT_NONE;
+  client_cb->at_cb.pipelined_cnt = 0;
 }
 
 void bta_hf_client_send_at_cmd(tBTA_HF_CLIENT_DATA* p_data) {
@@ -44,12 +44,20 @@ typedef struct queued_at_cmd tBTA_HF_CLIENT_AT_QCMD;
 /* Maximum number of indicators */
 #define BTA_HF_CLIENT_AT_INDICATOR_COUNT 20
 
+/* Maximum number of AT commands in flight beyond the current one; only
+   independent commands are ever pipelined */
+#define BTA_HF_CLIENT_AT_PIPELINE_DEPTH 4
+
 /* AT command parsing control block */
 typedef struct {
   char buf[BTA_HF_CLIENT_AT_PARSER_MAX_LEN +
            1]; /* extra byte to always have \0 at the end */
   unsigned int offset;
   tBTA_HF_CLIENT_AT_CMD current_cmd;
+  /* commands in flight behind current_cmd, oldest first; responses on the
+     ordered RFCOMM channel complete them in the same order */
+  tBTA_HF_CLIENT_AT_CMD pipelined[BTA_HF_CLIENT_AT_PIPELINE_DEPTH];
+  uint8_t pipelined_cnt;
   tBTA_HF_CLIENT_AT_QCMD* queued_cmd;
   alarm_t* resp_timer; /* AT response timer */
   alarm_t* hold_timer; /* AT hold timer */
@@ -1116,9 +1116,24 @@ static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
     case HID_HDEV_EVT_CLOSE:
       sm_event = BTA_HH_INT_CLOSE_EVT;
       break;
-    case HID_HDEV_EVT_INTR_DATA:
+    case HID_HDEV_EVT_INTR_DATA: {
+      /* Fast path: once a device is fully connected, interrupt channel
+       * reports have no state machine work left to do; hand them straight
+       * to the co layer and skip the bta_sys message round trip. */
+      uint8_t idx = bta_hh_dev_handle_to_cb_idx(dev_handle);
+      if (idx != BTA_HH_IDX_INVALID && bta_hh_cb.kdev[idx].in_use &&
+          bta_hh_cb.kdev[idx].state == BTA_HH_CONN_ST && pdata != NULL) {
+        tBTA_HH_DEV_CB* p_cb = &bta_hh_cb.kdev[idx];
+        uint8_t* p_rpt = (uint8_t*)(pdata + 1) + pdata->offset;
+        bta_hh_co_data(dev_handle, p_rpt, pdata->len, p_cb->mode,
+                       p_cb->sub_class, p_cb->dscp_info.ctry_code, p_cb->addr,
+                       p_cb->app_id);
+        osi_free_and_reset((void**)&pdata);
+        return;
+      }
       sm_event = BTA_HH_INT_DATA_EVT;
       break;
+    }
     case HID_HDEV_EVT_HANDSHAKE:
       sm_event = BTA_HH_INT_HANDSK_EVT;
       break;
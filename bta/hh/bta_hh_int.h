@@ -158,10 +158,22 @@ typedef struct {
 #define BTA_HH_LE_RPT_MAX 20
 #endif
 
+/* resolved input report fast path entry: maps a characteristic value handle
+ * directly to its report entry so steady state input reports skip the GATT
+ * database walks; filled lazily on the first report from each characteristic
+ * and wiped together with the rest of the service cache */
+typedef struct {
+  uint16_t char_handle;
+  uint8_t rpt_index; /* index into report[] */
+  uint8_t app_id;
+} tBTA_HH_LE_RPT_FAST_PATH;
+
 typedef struct {
   bool in_use;
   uint8_t srvc_inst_id;
   tBTA_HH_LE_RPT report[BTA_HH_LE_RPT_MAX];
+  tBTA_HH_LE_RPT_FAST_PATH input_fast_path[BTA_HH_LE_RPT_MAX];
+  uint8_t input_fast_path_count;
 
   uint16_t proto_mode_handle;
   uint8_t control_point_handle;
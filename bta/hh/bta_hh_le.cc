@@ -1512,7 +1512,7 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
   tBTA_HH_DEV_CB* p_dev_cb = bta_hh_le_find_dev_cb_by_conn_id(p_data->conn_id);
   uint8_t app_id;
   uint8_t* p_buf;
-  tBTA_HH_LE_RPT* p_rpt;
+  tBTA_HH_LE_RPT* p_rpt = NULL;
 
   if (p_dev_cb == NULL) {
     APPL_TRACE_ERROR(
@@ -1521,35 +1521,56 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
     return;
   }
 
-  const gatt::Characteristic* p_char =
-      BTA_GATTC_GetCharacteristic(p_dev_cb->conn_id, p_data->handle);
-  if (p_char == NULL) {
-    APPL_TRACE_ERROR(
-        "%s: notification received for Unknown Characteristic, conn_id: "
-        "0x%04x, handle: 0x%04x",
-        __func__, p_dev_cb->conn_id, p_data->handle);
-    return;
+  /* fast path: reports from a characteristic seen before resolve without
+   * walking the GATT database */
+  tBTA_HH_LE_HID_SRVC* p_srvc = &p_dev_cb->hid_srvc;
+  for (uint8_t i = 0; i < p_srvc->input_fast_path_count; i++) {
+    if (p_srvc->input_fast_path[i].char_handle == p_data->handle) {
+      p_rpt = &p_srvc->report[p_srvc->input_fast_path[i].rpt_index];
+      app_id = p_srvc->input_fast_path[i].app_id;
+      break;
+    }
   }
 
-  app_id = p_dev_cb->app_id;
+  if (p_rpt == NULL) {
+    const gatt::Characteristic* p_char =
+        BTA_GATTC_GetCharacteristic(p_dev_cb->conn_id, p_data->handle);
+    if (p_char == NULL) {
+      APPL_TRACE_ERROR(
+          "%s: notification received for Unknown Characteristic, conn_id: "
+          "0x%04x, handle: 0x%04x",
+          __func__, p_dev_cb->conn_id, p_data->handle);
+      return;
+    }
 
-  const gatt::Service* p_svc =
-      BTA_GATTC_GetOwningService(p_dev_cb->conn_id, p_char->value_handle);
+    app_id = p_dev_cb->app_id;
 
-  p_rpt = bta_hh_le_find_report_entry(
-      p_dev_cb, p_svc->handle, p_char->uuid.As16Bit(), p_char->value_handle);
-  if (p_rpt == NULL) {
-    APPL_TRACE_ERROR(
-        "%s: notification received for Unknown Report, uuid: %s, handle: "
-        "0x%04x",
-        __func__, p_char->uuid.ToString().c_str(), p_char->value_handle);
-    return;
-  }
+    const gatt::Service* p_svc =
+        BTA_GATTC_GetOwningService(p_dev_cb->conn_id, p_char->value_handle);
+
+    p_rpt = bta_hh_le_find_report_entry(
+        p_dev_cb, p_svc->handle, p_char->uuid.As16Bit(), p_char->value_handle);
+    if (p_rpt == NULL) {
+      APPL_TRACE_ERROR(
+          "%s: notification received for Unknown Report, uuid: %s, handle: "
+          "0x%04x",
+          __func__, p_char->uuid.ToString().c_str(), p_char->value_handle);
+      return;
+    }
 
-  if (p_char->uuid == Uuid::From16Bit(GATT_UUID_HID_BT_MOUSE_INPUT))
-    app_id = BTA_HH_APP_ID_MI;
-  else if (p_char->uuid == Uuid::From16Bit(GATT_UUID_HID_BT_KB_INPUT))
-    app_id = BTA_HH_APP_ID_KB;
+    if (p_char->uuid == Uuid::From16Bit(GATT_UUID_HID_BT_MOUSE_INPUT))
+      app_id = BTA_HH_APP_ID_MI;
+    else if (p_char->uuid == Uuid::From16Bit(GATT_UUID_HID_BT_KB_INPUT))
+      app_id = BTA_HH_APP_ID_KB;
+
+    if (p_srvc->input_fast_path_count < BTA_HH_LE_RPT_MAX) {
+      tBTA_HH_LE_RPT_FAST_PATH* p_entry =
+          &p_srvc->input_fast_path[p_srvc->input_fast_path_count++];
+      p_entry->char_handle = p_data->handle;
+      p_entry->rpt_index = (uint8_t)(p_rpt - p_srvc->report);
+      p_entry->app_id = app_id;
+    }
+  }
 
   APPL_TRACE_DEBUG("Notification received on report ID: %d", p_rpt->rpt_id);
 
@@ -722,6 +722,20 @@ extern void BTA_DmSearch(tBTA_DM_SEARCH_CBACK* p_cback, bool is_bonding_or_sdp);
  ******************************************************************************/
 extern void BTA_DmSearchCancel(void);
 
+/*******************************************************************************
+ *
+ * Function         BTA_DmSetInquiryPageYield
+ *
+ * Description      This function sets whether an active inquiry yields the
+ *                  radio to outgoing connection attempts and resumes with
+ *                  its remaining duration afterwards. Enabled by default.
+ *
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+extern void BTA_DmSetInquiryPageYield(bool enable);
+
 /*******************************************************************************
  *
  * Function         BTA_DmDiscover
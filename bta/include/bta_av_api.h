@@ -365,6 +365,9 @@ typedef union {
 
 /* AV callback */
 typedef void(tBTA_AV_CBACK)(tBTA_AV_EVT event, tBTA_AV* p_data);
+/* For BTA_AV_SINK_MEDIA_DATA_EVT, |p_data| is the media BT_HDR loaned to the
+ * callback, which takes ownership and must queue or osi_free it. For other
+ * events |p_data| is only valid for the duration of the call. */
 typedef void(tBTA_AV_SINK_DATA_CBACK)(const RawAddress&, tBTA_AV_EVT event,
                                       tBTA_AV_MEDIA* p_data);
 
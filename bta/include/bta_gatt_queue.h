@@ -64,11 +64,24 @@ class BtaGattQueue {
     /* write-specific fields */
     tGATT_WRITE_TYPE write_type;
     std::vector<uint8_t> value;
+
+    /* extra callbacks of duplicate reads coalesced onto this operation */
+    std::vector<std::pair<GATT_READ_OP_CB, void*>> extra_read_cbs;
+  };
+
+  /* read currently on the air, eligible for duplicate coalescing */
+  struct gatt_in_flight_read {
+    uint8_t type;
+    uint16_t handle;
+    void* op_data;
   };
 
  private:
   static void mark_as_not_executing(uint16_t conn_id);
   static void gatt_execute_next_op(uint16_t conn_id);
+  static bool gatt_try_coalesce_read(uint16_t conn_id, uint8_t type,
+                                     uint16_t handle, GATT_READ_OP_CB cb,
+                                     void* cb_data);
   static void gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                     uint16_t handle, uint16_t len,
                                     uint8_t* value, void* data);
@@ -81,4 +94,6 @@ class BtaGattQueue {
   static std::unordered_map<uint16_t, std::list<gatt_operation>> gatt_op_queue;
   // contain connection ids that currently execute operations
   static std::unordered_set<uint16_t> gatt_op_queue_executing;
+  // maps connection id to the read operation currently on the air
+  static std::unordered_map<uint16_t, gatt_in_flight_read> gatt_read_in_flight;
 };
@@ -74,6 +74,26 @@ struct AudioStats {
   size_t packet_send_count;
   size_t frame_flush_count;
   size_t frame_send_count;
+  /* Frames where only this ear had queued packets to flush. The flushed ear
+   * conceals audio the other ear plays, so this counts binaural desync
+   * events. */
+  size_t lone_flush_count;
+  /* Credit stalls - CoC congestion episodes on this channel, and the time
+   * spent congested. A drifting ear stalls periodically while its partner
+   * does not. */
+  size_t credit_stall_count;
+  uint64_t credit_stall_ms_total;
+  /* Boottime ms when the current congestion episode started, 0 when the
+   * channel is not congested. */
+  uint64_t congestion_start_ms;
+  /* Exponential moving average (permille of wall time) this channel spends
+   * congested - the inverse proxy for its credit return rate - and the
+   * packets withheld while the stream was thinned to let credits recover. */
+  uint32_t stall_ewma_permille;
+  size_t thin_drop_count;
+  /* Boottime ms when the channel was last observed healthy; base of the
+   * congestion-free window the EWMA samples are computed over. */
+  uint64_t last_uncongested_ms;
   std::deque<rssi_log> rssi_history;
 
   AudioStats() { Reset(); }
@@ -83,6 +103,13 @@ struct AudioStats {
     packet_send_count = 0;
     frame_flush_count = 0;
     frame_send_count = 0;
+    lone_flush_count = 0;
+    credit_stall_count = 0;
+    credit_stall_ms_total = 0;
+    congestion_start_ms = 0;
+    stall_ewma_permille = 0;
+    thin_drop_count = 0;
+    last_uncongested_ms = 0;
   }
 };
 
@@ -145,6 +172,12 @@ struct HearingDevice {
    * ACKnowledged. */
   bool command_acked;
 
+  /* True while the audio stream is thinned to half packet rate so the CoC
+     credit debt can drain instead of deepening. thin_phase alternates to
+     pick which packets are withheld. */
+  bool stream_thinned;
+  bool thin_phase;
+
   /* When read_rssi_count is > 0, then read the rssi. The interval between rssi
      reads is tracked by num_intervals_since_last_rssi_read. */
   int read_rssi_count;
@@ -177,6 +210,8 @@ struct HearingDevice {
         codecs(codecs),
         playback_started(false),
         command_acked(false),
+        stream_thinned(false),
+        thin_phase(false),
         read_rssi_count(0) {}
 
   HearingDevice(const RawAddress& address, bool first_connection)
@@ -199,6 +234,8 @@ struct HearingDevice {
         codecs(0),
         playback_started(false),
         command_acked(false),
+        stream_thinned(false),
+        thin_phase(false),
         read_rssi_count(0) {}
 
   HearingDevice() : HearingDevice(RawAddress::kEmpty, false) {}
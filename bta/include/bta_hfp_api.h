@@ -30,6 +30,7 @@
 
 #define HFP_VERSION_CONFIG_KEY "HfpVersion"
 #define HFP_SDP_FEATURES_CONFIG_KEY "HfpSdpFeatures"
+#define HFP_NEGOTIATED_CODEC_CONFIG_KEY "HfpNegotiatedCodec"
 
 /* Default HFP Version */
 #ifndef BTA_HFP_VERSION
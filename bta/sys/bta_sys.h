@@ -208,6 +208,13 @@ extern void bta_sys_deregister(uint8_t id);
 extern bool bta_sys_is_register(uint8_t id);
 extern void bta_sys_sendmsg(void* p_msg);
 extern void bta_sys_sendmsg_delayed(void* p_msg, const base::TimeDelta& delay);
+extern void bta_sys_queue_dump(int fd);
+/* Event buffers allocated with bta_sys_msg_alloc are served from the size
+ * class pools and handed back to them automatically by bta_sys_event after
+ * the subsystem handler returns; a buffer kept past the handler must be
+ * released with bta_sys_msg_free instead of osi_free. */
+extern void* bta_sys_msg_alloc(size_t size);
+extern void bta_sys_msg_free(void* p_msg);
 extern void bta_sys_start_timer(alarm_t* alarm, uint64_t interval_ms,
                                 uint16_t event, uint16_t layer_specific);
 extern void bta_sys_disable();
@@ -25,16 +25,22 @@
 #define LOG_TAG "bt_bta_sys_main"
 
 #include <base/bind.h>
+#include <stdio.h>
+
 #include <cstring>
+#include <mutex>
+#include <queue>
 
 #include "bt_target.h"  // Must be first to define build configuration
 
 #include "bta/sys/bta_sys.h"
 #include "bta/sys/bta_sys_int.h"
+#include "common/time_util.h"
 #include "include/hardware/bluetooth.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
+#include "osi/include/pool_allocator.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/btu.h"  // do_in_main_thread
 
@@ -100,10 +106,44 @@ static void bta_sys_event(BT_HDR_RIGID* p_msg) {
   }
 
   if (freebuf) {
-    osi_free(p_msg);
+    bta_sys_msg_free(p_msg);
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_sys_msg_alloc
+ *
+ * Description      Allocate a BTA message buffer from the event size class
+ *                  pools, falling back to the heap for oversized requests.
+ *                  The buffer is handed back automatically by bta_sys_event
+ *                  once the subsystem handler has returned.
+ *
+ * Returns          pointer to a buffer of at least |size| bytes
+ *
+ ******************************************************************************/
+void* bta_sys_msg_alloc(size_t size) {
+  void* p_msg = pool_allocator_alloc(size);
+  if (p_msg == NULL) p_msg = osi_malloc(size);
+  return p_msg;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_sys_msg_free
+ *
+ * Description      Release a BTA message buffer to its originating
+ *                  allocator. Both pool-backed and osi_malloc-backed
+ *                  buffers are handled, so subsystems can migrate their
+ *                  event allocations to the pools incrementally.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_sys_msg_free(void* p_msg) {
+  if (!pool_allocator_free(p_msg)) osi_free(p_msg);
+}
+
 /*******************************************************************************
  *
  * Function         bta_sys_register
@@ -146,6 +186,168 @@ void bta_sys_deregister(uint8_t id) { bta_sys_cb.is_reg[id] = false; }
  ******************************************************************************/
 bool bta_sys_is_register(uint8_t id) { return bta_sys_cb.is_reg[id]; }
 
+/*******************************************************************************
+ *  Priority lanes for the BTA event path
+ *
+ *  do_in_main_thread() is a plain FIFO, so a storm of bulk profile events
+ *  (socket data, GATT traffic, SDP results) used to queue ahead of
+ *  latency-critical transitions such as an AV suspend. Messages are now
+ *  staged in three lanes and drained by a deficit scheduler posted to the
+ *  main thread: control messages always run first, while the media and
+ *  bulk lanes each spend a per-round quantum so neither starves outright.
+ ******************************************************************************/
+
+#define BTA_SYS_LANE_CONTROL 0
+#define BTA_SYS_LANE_MEDIA 1
+#define BTA_SYS_LANE_BULK 2
+#define BTA_SYS_NUM_LANES 3
+
+/* messages granted to the media/bulk lanes per scheduler round; the control
+ * lane is not metered */
+static const uint32_t bta_sys_lane_quantum[BTA_SYS_NUM_LANES] = {0, 8, 4};
+
+/* total messages run per drain pass before yielding the main thread */
+#define BTA_SYS_DRAIN_BUDGET 32
+
+typedef struct {
+  BT_HDR_RIGID* p_msg;
+  uint64_t enqueue_time_ms;
+} tBTA_SYS_QUEUED_MSG;
+
+static struct {
+  std::mutex lock;
+  std::queue<tBTA_SYS_QUEUED_MSG> msgs[BTA_SYS_NUM_LANES];
+  uint32_t deficit[BTA_SYS_NUM_LANES];
+  bool drain_scheduled; /* a drain task is posted or running */
+  struct {
+    uint32_t enqueued;
+    uint64_t total_delay_ms;
+    uint64_t max_delay_ms;
+  } stats[BTA_SYS_NUM_LANES];
+} bta_sys_lanes;
+
+static void bta_sys_drain_lanes();
+
+/* Maps the subsystem id carried in |event| to its scheduling lane */
+static uint8_t bta_sys_lane_for_event(uint16_t event) {
+  switch ((uint8_t)(event >> 8)) {
+    case BTA_ID_AG:
+    case BTA_ID_AV:
+    case BTA_ID_HS:
+      return BTA_SYS_LANE_MEDIA;
+    case BTA_ID_PAN:
+    case BTA_ID_JV:
+    case BTA_ID_GATTC:
+    case BTA_ID_GATTS:
+    case BTA_ID_SDP:
+      return BTA_SYS_LANE_BULK;
+    default:
+      return BTA_SYS_LANE_CONTROL;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_sys_drain_lanes
+ *
+ * Description      Runs queued BTA messages on the main thread: the control
+ *                  lane first, then deficit round-robin between the media
+ *                  and bulk lanes. Reposts itself while a backlog remains
+ *                  so one storm cannot monopolize the thread.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_sys_drain_lanes() {
+  for (uint32_t processed = 0; processed < BTA_SYS_DRAIN_BUDGET; processed++) {
+    BT_HDR_RIGID* p_msg = NULL;
+    {
+      std::lock_guard<std::mutex> lock(bta_sys_lanes.lock);
+
+      uint8_t lane = BTA_SYS_NUM_LANES;
+      if (!bta_sys_lanes.msgs[BTA_SYS_LANE_CONTROL].empty()) {
+        lane = BTA_SYS_LANE_CONTROL;
+      } else {
+        for (uint8_t i = BTA_SYS_LANE_MEDIA; i < BTA_SYS_NUM_LANES; i++) {
+          if (!bta_sys_lanes.msgs[i].empty() && bta_sys_lanes.deficit[i] > 0) {
+            lane = i;
+            break;
+          }
+        }
+        if (lane == BTA_SYS_NUM_LANES) {
+          /* deficits spent: start a new round */
+          bool pending = false;
+          for (uint8_t i = BTA_SYS_LANE_MEDIA; i < BTA_SYS_NUM_LANES; i++) {
+            bta_sys_lanes.deficit[i] = bta_sys_lane_quantum[i];
+            if (!bta_sys_lanes.msgs[i].empty()) pending = true;
+          }
+          if (!pending) break;
+          continue;
+        }
+      }
+
+      tBTA_SYS_QUEUED_MSG queued = bta_sys_lanes.msgs[lane].front();
+      bta_sys_lanes.msgs[lane].pop();
+      if (lane != BTA_SYS_LANE_CONTROL) bta_sys_lanes.deficit[lane]--;
+
+      uint64_t delay_ms = bluetooth::common::time_get_os_boottime_ms() -
+                          queued.enqueue_time_ms;
+      bta_sys_lanes.stats[lane].total_delay_ms += delay_ms;
+      if (delay_ms > bta_sys_lanes.stats[lane].max_delay_ms)
+        bta_sys_lanes.stats[lane].max_delay_ms = delay_ms;
+
+      p_msg = queued.p_msg;
+    }
+    if (p_msg == NULL) break;
+
+    bta_sys_event(p_msg);
+  }
+
+  bool repost = false;
+  {
+    std::lock_guard<std::mutex> lock(bta_sys_lanes.lock);
+    for (uint8_t i = 0; i < BTA_SYS_NUM_LANES; i++) {
+      if (!bta_sys_lanes.msgs[i].empty()) repost = true;
+    }
+    if (!repost) bta_sys_lanes.drain_scheduled = false;
+  }
+  if (repost &&
+      do_in_main_thread(FROM_HERE, base::Bind(&bta_sys_drain_lanes)) !=
+          BT_STATUS_SUCCESS) {
+    LOG(ERROR) << __func__ << ": do_in_main_thread failed";
+    std::lock_guard<std::mutex> lock(bta_sys_lanes.lock);
+    bta_sys_lanes.drain_scheduled = false;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_sys_queue_dump
+ *
+ * Description      Dump per-lane queue depth and queue-delay statistics.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_sys_queue_dump(int fd) {
+  static const char* lane_names[BTA_SYS_NUM_LANES] = {"control", "media",
+                                                      "bulk"};
+
+  dprintf(fd, "\nBTA event lanes:\n");
+  std::lock_guard<std::mutex> lock(bta_sys_lanes.lock);
+  for (uint8_t i = 0; i < BTA_SYS_NUM_LANES; i++) {
+    uint32_t enqueued = bta_sys_lanes.stats[i].enqueued;
+    uint64_t avg_delay_ms =
+        (enqueued != 0) ? bta_sys_lanes.stats[i].total_delay_ms / enqueued : 0;
+    dprintf(fd,
+            "  %-7s queued:%zu enqueued:%u avg_delay_ms:%llu "
+            "max_delay_ms:%llu\n",
+            lane_names[i], bta_sys_lanes.msgs[i].size(), enqueued,
+            (unsigned long long)avg_delay_ms,
+            (unsigned long long)bta_sys_lanes.stats[i].max_delay_ms);
+  }
+}
+
 /*******************************************************************************
  *
  * Function         bta_sys_sendmsg
@@ -162,11 +364,27 @@ bool bta_sys_is_register(uint8_t id) { return bta_sys_cb.is_reg[id]; }
  *
  ******************************************************************************/
 void bta_sys_sendmsg(void* p_msg) {
-  if (do_in_main_thread(
-          FROM_HERE,
-          base::Bind(&bta_sys_event, static_cast<BT_HDR_RIGID*>(p_msg))) !=
-      BT_STATUS_SUCCESS) {
+  uint8_t lane = bta_sys_lane_for_event(((BT_HDR_RIGID*)p_msg)->event);
+
+  bool post_drain = false;
+  {
+    std::lock_guard<std::mutex> lock(bta_sys_lanes.lock);
+    bta_sys_lanes.msgs[lane].push(
+        {static_cast<BT_HDR_RIGID*>(p_msg),
+         bluetooth::common::time_get_os_boottime_ms()});
+    bta_sys_lanes.stats[lane].enqueued++;
+    if (!bta_sys_lanes.drain_scheduled) {
+      bta_sys_lanes.drain_scheduled = true;
+      post_drain = true;
+    }
+  }
+
+  if (post_drain &&
+      do_in_main_thread(FROM_HERE, base::Bind(&bta_sys_drain_lanes)) !=
+          BT_STATUS_SUCCESS) {
     LOG(ERROR) << __func__ << ": do_in_main_thread failed";
+    std::lock_guard<std::mutex> lock(bta_sys_lanes.lock);
+    bta_sys_lanes.drain_scheduled = false;
   }
 }
 
@@ -191,7 +409,7 @@ void bta_sys_sendmsg_delayed(void* p_msg, const base::TimeDelta& delay) {
  ******************************************************************************/
 void bta_sys_start_timer(alarm_t* alarm, uint64_t interval_ms, uint16_t event,
                          uint16_t layer_specific) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = event;
   p_buf->layer_specific = layer_specific;
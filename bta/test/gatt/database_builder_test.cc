@@ -29,6 +29,11 @@ using bluetooth::Uuid;
 namespace gatt {
 
 namespace {
+/* EXPECT_EQ doesn't work well with static constexpr fields, need a variable
+ * with address */
+constexpr std::pair<uint16_t, uint16_t> EXPLORE_END =
+    DatabaseBuilder::EXPLORE_END;
+
 /* make_pair doesn't work well with ASSERT_EQ, have own helper instead */
 inline std::pair<uint16_t, uint16_t> make_pair_u16(uint16_t first,
                                                    uint16_t second) {
@@ -129,13 +134,10 @@ TEST(DatabaseBuilderTest, SecondaryServiceOutOfOrderTest) {
   EXPECT_TRUE(builder.StartNextServiceExploration());
   ASSERT_EQ(builder.CurrentlyExploredService(), make_pair_u16(0x0020, 0x002f));
 
-  /* Secondary service exploration */
+  /* Secondary service at 0x0040 is directly followed by primary service at
+   * 0x0050, both are explored as one range */
   EXPECT_TRUE(builder.StartNextServiceExploration());
-  ASSERT_EQ(builder.CurrentlyExploredService(), make_pair_u16(0x0040, 0x004f));
-
-  /* Back to primary service exploration */
-  EXPECT_TRUE(builder.StartNextServiceExploration());
-  ASSERT_EQ(builder.CurrentlyExploredService(), make_pair_u16(0x0050, 0x005f));
+  ASSERT_EQ(builder.CurrentlyExploredService(), make_pair_u16(0x0040, 0x005f));
 
   Database result = builder.Build();
 
@@ -176,4 +178,60 @@ TEST(DatabaseBuilderTest, SecondaryServiceOutOfOrderTest) {
   ASSERT_EQ(service, result.Services().end());
 }
 
+/* This test verifies that directly adjacent services are explored as a single
+ * handle range, and that services separated by a handle gap are not merged. */
+TEST(DatabaseBuilderTest, AdjacentServiceMergeTest) {
+  DatabaseBuilder builder;
+
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x0010, SERVICE_2_UUID, true);
+  builder.AddService(0x0011, 0x001f, SERVICE_3_UUID, true);
+  builder.AddService(0x0030, 0x003f, SERVICE_4_UUID, true);
+
+  /* First three services are adjacent - including the empty one - and form
+   * one exploration range */
+  EXPECT_TRUE(builder.StartNextServiceExploration());
+  ASSERT_EQ(builder.CurrentlyExploredService(), make_pair_u16(0x0001, 0x001f));
+
+  builder.AddCharacteristic(0x0002, 0x0003, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0012, 0x0013, SERVICE_1_CHAR_1_UUID, 0x02);
+
+  /* Descriptor ranges are still reported per service - first characteristic
+   * range must end at its service end handle, not bleed into the next one */
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(),
+            make_pair_u16(0x0004, 0x000f));
+  builder.AddDescriptor(0x0004, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(),
+            make_pair_u16(0x0014, 0x001f));
+  builder.AddDescriptor(0x0014, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(), EXPLORE_END);
+
+  /* Service behind the handle gap is explored on its own */
+  EXPECT_TRUE(builder.StartNextServiceExploration());
+  ASSERT_EQ(builder.CurrentlyExploredService(), make_pair_u16(0x0030, 0x003f));
+
+  EXPECT_FALSE(builder.StartNextServiceExploration());
+
+  Database result = builder.Build();
+
+  // verify characteristics and descriptors landed in the right services
+  auto service = result.Services().begin();
+  ASSERT_EQ(service->handle, 0x0001);
+  ASSERT_EQ(service->characteristics.size(), (size_t)1);
+  ASSERT_EQ(service->characteristics[0].declaration_handle, 0x0002);
+  ASSERT_EQ(service->characteristics[0].descriptors[0].handle, 0x0004);
+
+  service++;
+  ASSERT_EQ(service->handle, 0x0010);
+  ASSERT_TRUE(service->characteristics.empty());
+
+  service++;
+  ASSERT_EQ(service->handle, 0x0011);
+  ASSERT_EQ(service->characteristics.size(), (size_t)1);
+  ASSERT_EQ(service->characteristics[0].declaration_handle, 0x0012);
+  ASSERT_EQ(service->characteristics[0].descriptors[0].handle, 0x0014);
+}
+
 }  // namespace gatt
\ No newline at end of file
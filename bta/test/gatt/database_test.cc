@@ -95,6 +95,33 @@ TEST(GattDatabaseTest, serialize_deserialize_binary_test) {
   EXPECT_EQ(serialized[5].value.characteristic_extended_properties, 0x0001);
 }
 
+/* This test makes sure that deserializing a raw StoredAttribute array in
+ * place - as done when reading an mmap-ed cache file - gives the same result
+ * as the vector based overload */
+TEST(GattDatabaseTest, deserialize_in_place_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, false);
+  builder.AddIncludedService(0x0002, SERVICE_2_UUID, 0x0010, 0x001f);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddDescriptor(0x0005, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  Database db = builder.Build();
+  std::vector<StoredAttribute> serialized = db.Serialize();
+
+  bool success = false;
+  Database from_vector = Database::Deserialize(serialized, &success);
+  EXPECT_TRUE(success);
+
+  success = false;
+  Database in_place =
+      Database::Deserialize(serialized.data(), serialized.size(), &success);
+  EXPECT_TRUE(success);
+
+  EXPECT_EQ(from_vector.ToString(), in_place.ToString());
+  EXPECT_EQ(from_vector.Hash(), in_place.Hash());
+}
+
 /* This test makes sure that Service represented in StoredAttribute have proper
  * binary format. */
 TEST(GattCacheTest, stored_attribute_to_binary_service_test) {
@@ -256,6 +283,29 @@ TEST(GattDatabaseTest, hash_test) {
   EXPECT_EQ(hash, expected_hash);
 }
 
+/* This test verifies that the Database Hash characteristic is properly
+ * detected, it decides whether a reloaded cache can be validated with a
+ * single hash read. */
+TEST(GattDatabaseTest, has_database_hash_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x0005, Uuid::From16Bit(0x1800), true);
+  builder.AddService(0x0006, 0x000D, Uuid::From16Bit(0x1801), true);
+  builder.AddCharacteristic(0x0002, 0x0003, Uuid::From16Bit(0x2A00), 0x0A);
+  builder.AddCharacteristic(0x0007, 0x0008, Uuid::From16Bit(0x2A05), 0x20);
+
+  Database db = builder.Build();
+  EXPECT_FALSE(db.HasDatabaseHash());
+
+  builder.AddService(0x0001, 0x0005, Uuid::From16Bit(0x1800), true);
+  builder.AddService(0x0006, 0x000D, Uuid::From16Bit(0x1801), true);
+  builder.AddCharacteristic(0x0002, 0x0003, Uuid::From16Bit(0x2A00), 0x0A);
+  builder.AddCharacteristic(0x0007, 0x0008, Uuid::From16Bit(0x2A05), 0x20);
+  builder.AddCharacteristic(0x000C, 0x000D, Uuid::From16Bit(0x2B2A), 0x02);
+
+  db = builder.Build();
+  EXPECT_TRUE(db.HasDatabaseHash());
+}
+
 /* This test makes sure that Descriptor represented in StoredAttribute have
  * proper binary format. */
 TEST(GattCacheTest,
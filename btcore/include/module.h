@@ -57,3 +57,6 @@ void module_shut_down(const module_t* module);
 // Clean up the provided module. |module| may not be NULL.
 // If not initialized, does nothing.
 void module_clean_up(const module_t* module);
+
+// Dump the recorded per-module init/start_up durations to |fd|.
+void module_timing_dump(int fd);
@@ -22,10 +22,15 @@
 
 #include <base/logging.h>
 #include <dlfcn.h>
+#include <inttypes.h>
+#include <stdio.h>
 #include <string.h>
 
+#include <chrono>
 #include <mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "common/message_loop_thread.h"
 #include "osi/include/allocator.h"
@@ -42,14 +47,29 @@ typedef enum {
 
 static std::unordered_map<const module_t*, module_state_t> metadata;
 
+// Lifecycle durations per module, in bring-up order, so a slow stack-on can
+// be attributed to the module responsible in the debug dump
+typedef struct {
+  std::string name;
+  uint64_t init_ms;
+  uint64_t start_up_ms;
+} module_timing_t;
+static std::vector<module_timing_t> module_timings;
+
 // TODO(jamuraa): remove this lock after the startup sequence is clean
 static std::mutex metadata_mutex;
 
 static bool call_lifecycle_function(module_lifecycle_fn function);
 static module_state_t get_module_state(const module_t* module);
 static void set_module_state(const module_t* module, module_state_t state);
+static uint64_t now_ms(void);
+static void record_lifecycle_duration(const module_t* module, bool start_up,
+                                      uint64_t duration_ms);
 
-void module_management_start(void) {}
+void module_management_start(void) {
+  std::lock_guard<std::mutex> lock(metadata_mutex);
+  module_timings.clear();
+}
 
 void module_management_stop(void) { metadata.clear(); }
 
@@ -63,10 +83,12 @@ bool module_init(const module_t* module) {
   CHECK(module != NULL);
   CHECK(get_module_state(module) == MODULE_STATE_NONE);
 
+  const uint64_t start_time_ms = now_ms();
   if (!call_lifecycle_function(module->init)) {
     LOG_ERROR("%s Failed to initialize module \"%s\"", __func__, module->name);
     return false;
   }
+  record_lifecycle_duration(module, false, now_ms() - start_time_ms);
 
   set_module_state(module, MODULE_STATE_INITIALIZED);
   return true;
@@ -83,11 +105,15 @@ bool module_start_up(const module_t* module) {
         module->init == NULL);
 
   LOG_INFO("%s Starting module \"%s\"", __func__, module->name);
+  const uint64_t start_time_ms = now_ms();
   if (!call_lifecycle_function(module->start_up)) {
     LOG_ERROR("%s Failed to start up module \"%s\"", __func__, module->name);
     return false;
   }
-  LOG_INFO("%s Started module \"%s\"", __func__, module->name);
+  const uint64_t duration_ms = now_ms() - start_time_ms;
+  record_lifecycle_duration(module, true, duration_ms);
+  LOG_INFO("%s Started module \"%s\" in %" PRIu64 " ms", __func__, module->name,
+           duration_ms);
 
   set_module_state(module, MODULE_STATE_STARTED);
   return true;
@@ -129,6 +155,15 @@ void module_clean_up(const module_t* module) {
   set_module_state(module, MODULE_STATE_NONE);
 }
 
+void module_timing_dump(int fd) {
+  dprintf(fd, "\nBluetooth module lifecycle timings:\n");
+  std::lock_guard<std::mutex> lock(metadata_mutex);
+  for (const module_timing_t& timing : module_timings) {
+    dprintf(fd, "  %s: init %" PRIu64 " ms, start_up %" PRIu64 " ms\n",
+            timing.name.c_str(), timing.init_ms, timing.start_up_ms);
+  }
+}
+
 static bool call_lifecycle_function(module_lifecycle_fn function) {
   // A NULL lifecycle function means it isn't needed, so assume success
   if (!function) return true;
@@ -153,3 +188,26 @@ static void set_module_state(const module_t* module, module_state_t state) {
   std::lock_guard<std::mutex> lock(metadata_mutex);
   metadata[module] = state;
 }
+
+static uint64_t now_ms(void) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static void record_lifecycle_duration(const module_t* module, bool start_up,
+                                      uint64_t duration_ms) {
+  std::lock_guard<std::mutex> lock(metadata_mutex);
+  for (module_timing_t& timing : module_timings) {
+    if (timing.name == module->name) {
+      if (start_up) {
+        timing.start_up_ms = duration_ms;
+      } else {
+        timing.init_ms = duration_ms;
+      }
+      return;
+    }
+  }
+  module_timings.push_back({module->name, start_up ? 0 : duration_ms,
+                            start_up ? duration_ms : 0});
+}
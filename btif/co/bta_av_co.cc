@@ -23,6 +23,8 @@
  *
  ******************************************************************************/
 
+#include <string.h>
+
 #include <mutex>
 #include <vector>
 
@@ -32,6 +34,7 @@
 #include "bta/include/bta_av_ci.h"
 #include "btif/include/btif_a2dp_source.h"
 #include "btif/include/btif_av.h"
+#include "btif/include/btif_config.h"
 #include "include/hardware/bt_av.h"
 #include "osi/include/osi.h"  // UNUSED_ATTR
 #include "stack/include/a2dp_codec_api.h"
@@ -47,6 +50,11 @@
 #define BTA_AV_CO_AUDIO_INDEX_TO_HANDLE(index) \
   (((index) + 1) | BTA_AV_CHNL_AUDIO)
 
+// btif_config keys used to remember the codec configuration last negotiated
+// with a peer, so that a reconnection can skip the full codec selection scan.
+static const char BTA_AV_CO_LAST_CODEC_INDEX_KEY[] = "A2dpLastCodecIndex";
+static const char BTA_AV_CO_LAST_CODEC_CAPS_KEY[] = "A2dpLastCodecCaps";
+
 class BtaAvCoSep {
  public:
   BtaAvCoSep()
@@ -160,6 +168,7 @@ class BtaAvCo {
   BtaAvCo(bool content_protect_enabled)
       : active_peer_(nullptr),
         codec_config_{},
+        packet_interface_(nullptr),
         content_protect_enabled_(content_protect_enabled),
         content_protect_flag_(0) {
     Reset();
@@ -638,6 +647,30 @@ class BtaAvCo {
   const BtaAvCoSep* AttemptSourceCodecSelection(
       const A2dpCodecConfig& codec_config, BtaAvCoPeer* p_peer);
 
+  /**
+   * Attempt to select the Source codec configuration that was negotiated
+   * with a Sink peer on a previous connection.
+   *
+   * The cached configuration is reused only if the peer still reports the
+   * same capabilities for that codec, otherwise the caller must fall back
+   * to the full codec selection.
+   *
+   * @param p_peer the Sink peer to use
+   * @return a pointer to the corresponding SEP Sink entry on success,
+   * otherwise nullptr
+   */
+  const BtaAvCoSep* AttemptCachedSourceCodecSelection(BtaAvCoPeer* p_peer);
+
+  /**
+   * Save the Source codec configuration negotiated with a Sink peer so
+   * that a later reconnection can reuse it.
+   *
+   * @param p_peer the Sink peer to use
+   * @param p_sink the peer SEP Sink entry with the negotiated codec
+   */
+  void SaveLastNegotiatedSourceCodec(const BtaAvCoPeer* p_peer,
+                                     const BtaAvCoSep* p_sink);
+
   /**
    * Attempt to select Sink codec configuration for a Source peer.
    *
@@ -684,6 +717,10 @@ class BtaAvCo {
   BtaAvCoPeer peers_[BTA_AV_NUM_STRS];     // Connected peer information
   BtaAvCoPeer* active_peer_;               // The current active peer
   uint8_t codec_config_[AVDT_CODEC_SIZE];  // Current codec configuration
+  // Packet-path operations for the current codec configuration, resolved
+  // when the configuration is saved so the data path does not re-examine
+  // the codec information on every media packet
+  const tA2DP_PACKET_INTERFACE* packet_interface_;
   const bool content_protect_enabled_;     // True if Content Protect is enabled
   uint8_t content_protect_flag_;           // Content Protect flag
 };
@@ -761,6 +798,7 @@ void BtaAvCo::Reset() {
   active_peer_ = nullptr;
   content_protect_flag_ = 0;
   memset(codec_config_, 0, sizeof(codec_config_));
+  packet_interface_ = nullptr;
 
   if (ContentProtectEnabled()) {
     SetContentProtectFlag(AVDT_CP_SCMS_COPY_NEVER);
@@ -998,7 +1036,14 @@ tA2DP_STATUS BtaAvCo::ProcessSourceGetConfig(
                            __func__, p_peer->addr.ToString().c_str());
       }
     }
-    p_sink = SelectSourceCodec(p_peer);
+    // On reconnection, try to go straight to the codec configuration that
+    // was negotiated with this peer last time. Fall back to the full
+    // selection scan when the cached configuration is absent or stale.
+    p_sink = nullptr;
+    if (!btif_av_peer_prefers_mandatory_codec(p_peer->addr)) {
+      p_sink = AttemptCachedSourceCodecSelection(p_peer);
+    }
+    if (p_sink == nullptr) p_sink = SelectSourceCodec(p_peer);
     if (p_sink == nullptr) {
       APPL_TRACE_ERROR("%s: cannot set up codec for peer %s", __func__,
                        p_peer->addr.ToString().c_str());
@@ -1369,9 +1414,16 @@ BT_HDR* BtaAvCo::GetNextSourceDataPacket(const uint8_t* p_codec_info,
    * p_buf->layer_specific : number of audio frames in the packet
    * p_buf->word[0] : timestamp
    */
-  if (!A2DP_GetPacketTimestamp(p_codec_info, (const uint8_t*)(p_buf + 1),
-                               p_timestamp) ||
-      !A2DP_BuildCodecHeader(p_codec_info, p_buf, p_buf->layer_specific)) {
+  const tA2DP_PACKET_INTERFACE* packet_interface = packet_interface_;
+  if (packet_interface == nullptr) {
+    // Not resolved at configuration time; fall back to per-call lookup
+    packet_interface = A2DP_GetPacketInterface(p_codec_info);
+  }
+  if (packet_interface == nullptr ||
+      !packet_interface->get_packet_timestamp(
+          p_codec_info, (const uint8_t*)(p_buf + 1), p_timestamp) ||
+      !packet_interface->build_codec_header(p_codec_info, p_buf,
+                                            p_buf->layer_specific)) {
     APPL_TRACE_ERROR("%s: unsupported codec type (%d)", __func__,
                      A2DP_GetCodecType(p_codec_info));
   }
@@ -1426,6 +1478,7 @@ bool BtaAvCo::SetActivePeer(const RawAddress& peer_address) {
     // Reset the active peer;
     active_peer_ = nullptr;
     memset(codec_config_, 0, sizeof(codec_config_));
+    packet_interface_ = nullptr;
     return true;
   }
 
@@ -1437,6 +1490,7 @@ bool BtaAvCo::SetActivePeer(const RawAddress& peer_address) {
 
   active_peer_ = p_peer;
   memcpy(codec_config_, active_peer_->codec_config, AVDT_CODEC_SIZE);
+  packet_interface_ = A2DP_GetPacketInterface(codec_config_);
   LOG(INFO) << __func__ << ": codec = " << A2DP_CodecInfoString(codec_config_);
   // report the selected codec configuration of this new active peer.
   ReportSourceCodecState(active_peer_);
@@ -1883,10 +1937,61 @@ const BtaAvCoSep* BtaAvCo::AttemptSourceCodecSelection(
 
   SaveNewCodecConfig(p_peer, new_codec_config, p_sink->num_protect,
                      p_sink->protect_info);
+  SaveLastNegotiatedSourceCodec(p_peer, p_sink);
 
   return p_sink;
 }
 
+const BtaAvCoSep* BtaAvCo::AttemptCachedSourceCodecSelection(
+    BtaAvCoPeer* p_peer) {
+  const std::string section = p_peer->addr.ToString();
+  int codec_index;
+  uint8_t cached_caps[AVDT_CODEC_SIZE];
+  size_t length = sizeof(cached_caps);
+
+  if (!btif_config_get_int(section, BTA_AV_CO_LAST_CODEC_INDEX_KEY,
+                           &codec_index) ||
+      !btif_config_get_bin(section, BTA_AV_CO_LAST_CODEC_CAPS_KEY, cached_caps,
+                           &length) ||
+      length != AVDT_CODEC_SIZE) {
+    return nullptr;
+  }
+
+  // Update all selectable codecs.
+  // This is needed to update the selectable parameters for each codec.
+  // NOTE: The selectable codec info is used only for informational purpose.
+  UpdateAllSelectableSourceCodecs(p_peer);
+
+  for (const auto& iter : p_peer->GetCodecs()->orderedSourceCodecs()) {
+    if (iter->codecIndex() !=
+        static_cast<btav_a2dp_codec_index_t>(codec_index)) {
+      continue;
+    }
+    // Renegotiate from scratch if the peer's capabilities for the codec
+    // have changed since the configuration was cached.
+    const BtaAvCoSep* p_sink = FindPeerSink(
+        p_peer, static_cast<btav_a2dp_codec_index_t>(codec_index));
+    if (p_sink == nullptr ||
+        memcmp(p_sink->codec_caps, cached_caps, AVDT_CODEC_SIZE) != 0) {
+      VLOG(1) << __func__ << ": cached codec " << iter->name()
+              << " is stale for peer " << p_peer->addr.ToString();
+      return nullptr;
+    }
+    VLOG(1) << __func__ << ": reusing cached codec " << iter->name();
+    return AttemptSourceCodecSelection(*iter, p_peer);
+  }
+  return nullptr;
+}
+
+void BtaAvCo::SaveLastNegotiatedSourceCodec(const BtaAvCoPeer* p_peer,
+                                            const BtaAvCoSep* p_sink) {
+  const std::string section = p_peer->addr.ToString();
+  btif_config_set_int(section, BTA_AV_CO_LAST_CODEC_INDEX_KEY,
+                      A2DP_SourceCodecIndex(p_sink->codec_caps));
+  btif_config_set_bin(section, BTA_AV_CO_LAST_CODEC_CAPS_KEY,
+                      p_sink->codec_caps, AVDT_CODEC_SIZE);
+}
+
 const BtaAvCoSep* BtaAvCo::AttemptSinkCodecSelection(
     const A2dpCodecConfig& codec_config, BtaAvCoPeer* p_peer) {
   uint8_t new_codec_config[AVDT_CODEC_SIZE];
@@ -1995,6 +2100,7 @@ void BtaAvCo::SaveNewCodecConfig(BtaAvCoPeer* p_peer,
 
   memcpy(codec_config_, new_codec_config, sizeof(codec_config_));
   memcpy(p_peer->codec_config, new_codec_config, AVDT_CODEC_SIZE);
+  packet_interface_ = A2DP_GetPacketInterface(codec_config_);
 
   if (ContentProtectEnabled()) {
     // Check if this Sink supports SCMS
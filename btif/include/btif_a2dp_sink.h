@@ -116,9 +116,11 @@ bool btif_a2dp_sink_on_start(void);
 // If |enable| is true, the discarding is enabled, otherwise is disabled.
 void btif_a2dp_sink_set_rx_flush(bool enable);
 
-// Enqueue a buffer to the A2DP Sink queue. If the queue has reached its
-// maximum size |MAX_INPUT_A2DP_FRAME_QUEUE_SZ|, the oldest buffer is
-// removed from the queue.
+// Enqueue a buffer to the A2DP Sink queue. Ownership of |p_buf| is taken
+// over: it is either queued and freed after decoding, or freed right away
+// when the RX path is flushing. If the queue has reached its maximum size
+// |MAX_INPUT_A2DP_FRAME_QUEUE_SZ|, the oldest buffer is removed from the
+// queue.
 // |p_buf| is the buffer to enqueue.
 // Returns the number of buffers in the Sink queue after the enqueing.
 uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_buf);
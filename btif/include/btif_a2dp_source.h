@@ -120,6 +120,10 @@ void btif_a2dp_source_on_suspended(tBTA_AV_SUSPEND* p_av_suspend);
 // If |enable| is true, the discarding is enabled, otherwise is disabled.
 void btif_a2dp_source_set_tx_flush(bool enable);
 
+// Enable/disable the low-latency (game) mode: shallow TX queue,
+// single-frame packets and an aggressive automatic flush timeout.
+void btif_a2dp_source_set_low_latency_mode(bool enabled);
+
 // Get the next A2DP buffer to send.
 // Returns the next A2DP buffer to send if available, otherwise NULL.
 BT_HDR* btif_a2dp_source_audio_readbuf(void);
@@ -133,4 +137,16 @@ void btif_a2dp_source_debug_dump(int fd);
 void btif_a2dp_source_set_dynamic_audio_buffer_size(
     uint8_t dynamic_audio_buffer_size);
 
+// Map the shared-memory PCM ring created by the A2DP HAL and use it in place
+// of the UIPC data socket for reading audio.
+// |fd| is the ring file descriptor received over the control channel and
+// |data_size| is the expected size of the PCM area in bytes. The file
+// descriptor is closed regardless of the outcome.
+// Returns true if the ring was mapped successfully, otherwise false.
+bool btif_a2dp_source_shm_ring_attach(int fd, uint32_t data_size);
+
+// Unmap the shared-memory PCM ring (if any) and fall back to reading audio
+// from the UIPC data socket.
+void btif_a2dp_source_shm_ring_detach(void);
+
 #endif /* BTIF_A2DP_SOURCE_H */
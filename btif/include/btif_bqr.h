@@ -99,6 +99,30 @@ static constexpr uint8_t kLogDumpParamTotalLen = 3;
 static constexpr int8_t kCriWarnRssi = -80;
 // Warning criteria of the unused AFH channel count.
 static constexpr uint8_t kCriWarnUnusedCh = 55;
+// Time window within which a reported link quality degradation keeps
+// influencing the A2DP adaptive bit rate decision.
+static constexpr uint64_t kLinkQualityDegradedWindowMs = 5000;
+// Number of link quality events aggregated per link when computing the
+// sliding-window link quality score.
+static constexpr size_t kLinkQualityWindowSize = 10;
+// Best (and initial) link quality score.
+static constexpr uint8_t kMaxLinkQualityScore = 100;
+// Scores below this threshold mark the link as degraded for the A2DP
+// adaptive bit rate decision, in addition to the single-event criteria.
+static constexpr uint8_t kLinkQualityScoreWarnThreshold = 60;
+// Average RSSI (in dBm) at or above which no score penalty is applied.
+static constexpr int8_t kLinkQualityRssiGood = -60;
+// Average RSSI (in dBm) at or below which the full RSSI penalty is applied.
+static constexpr int8_t kLinkQualityRssiBad = -90;
+// Summed retransmission, no-RX and NAK increments per event at which the
+// full error penalty is applied.
+static constexpr uint32_t kLinkQualityErrorsPerEventWorst = 100;
+// A window whose newest event is older than this no longer describes the
+// link; such a link scores as perfect until new reports arrive.
+static constexpr uint64_t kLinkQualityStatsStaleMs = 30000;
+// Upper bound of concurrently tracked links; beyond it the least recently
+// updated link is evicted.
+static constexpr size_t kMaxTrackedLinks = 7;
 // The queue size of recording the BQR events.
 static constexpr uint8_t kBqrEventQueueSize = 25;
 // The Property of BQR event mask configuration.
@@ -113,6 +137,14 @@ static constexpr const char* kpLmpLlMessageTraceLogPath =
 // Path of the last LMP/LL message trace log file.
 static constexpr const char* kpLmpLlMessageTraceLastLogPath =
     "/data/misc/bluetooth/logs/lmp_ll_message_trace.log.last";
+// Path of the ring file preserving link quality events leaked off the
+// in-memory event queue.
+static constexpr const char* kpBqrSpillRingPath =
+    "/data/misc/bluetooth/logs/bqr_events_spill.ring";
+// Size of the spill ring data area; roughly two thousand events.
+static constexpr size_t kBqrSpillRingSize = 64 * 1024;
+// Spill appends beyond this per-second rate are discarded.
+static constexpr uint32_t kBqrSpillMaxRecordsPerSec = 20;
 // Path of the Bluetooth Multi-profile/Coex scheduling trace log file.
 static constexpr const char* kpBtSchedulingTraceLogPath =
     "/data/misc/bluetooth/logs/bt_scheduling_trace.log";
@@ -381,6 +413,63 @@ int OpenBtSchedulingTraceLogFile();
 // @param fd The file descriptor to use for dumping information.
 void DebugDump(int fd);
 
+// Check whether the controller reported a degraded link (an A2DP choppy
+// report, or RSSI below the warning level) within the last
+// kLinkQualityDegradedWindowMs.
+//
+// @return true if link quality was recently reported as degraded.
+bool LinkQualityIsDegraded();
+
+// Aggregate of the link quality events received on one link within the
+// sliding window.
+typedef struct {
+  // Number of events aggregated in the window.
+  size_t sample_count;
+  // Average RSSI (in dBm) over the window.
+  int8_t avg_rssi;
+  // Sum of the per-event retransmission count increments over the window.
+  uint32_t retransmission_count;
+  // Sum of the per-event no-RX count increments over the window.
+  uint32_t no_rx_count;
+  // Sum of the per-event NAK count increments over the window.
+  uint32_t nak_count;
+} LinkQualityWindowStats;
+
+// Callback invoked from the HCI event path when the sliding-window score of
+// a link drops below the threshold passed on registration.
+//
+// @param connection_handle Connection handle of the degraded link.
+// @param score The link quality score which crossed the threshold.
+using LinkQualityThresholdCb = void (*)(uint16_t connection_handle,
+                                        uint8_t score);
+
+// Get the sliding-window quality score of a link. The score starts from
+// kMaxLinkQualityScore and is lowered by the average RSSI and by the
+// retransmission/no-RX/NAK pressure over the last kLinkQualityWindowSize
+// link quality events.
+//
+// @param connection_handle Connection handle of the link.
+// @return the score in [0, kMaxLinkQualityScore]; kMaxLinkQualityScore if
+//   the link is unknown or its window is stale.
+uint8_t GetLinkQualityScore(uint16_t connection_handle);
+
+// Retrieve the raw sliding-window aggregates of a link.
+//
+// @param connection_handle Connection handle of the link.
+// @param p_stats Out parameter filled in on success.
+// @return true if the link is tracked and its window is not stale.
+bool GetLinkQualityWindowStats(uint16_t connection_handle,
+                               LinkQualityWindowStats* p_stats);
+
+// Register a callback invoked whenever the score of a link crosses from at
+// or above |score_threshold| to below it. Only one callback can be
+// registered at a time; passing nullptr unregisters.
+//
+// @param cb The callback to invoke, or nullptr.
+// @param score_threshold The score below which the callback fires.
+void RegisterLinkQualityThresholdCallback(LinkQualityThresholdCb cb,
+                                          uint8_t score_threshold);
+
 }  // namespace bqr
 }  // namespace bluetooth
 
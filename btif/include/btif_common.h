@@ -24,14 +24,22 @@
 
 #include <base/bind.h>
 #include <base/location.h>
+#include <base/time/time.h>
 #include <hardware/bluetooth.h>
 
 #include "abstract_message_loop.h"
 #include "bt_types.h"
 #include "bta/include/bta_api.h"
+#include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
 
+/* Attribute this module's allocations to btif in the memory ledger */
+#ifndef osi_malloc
+#define osi_malloc(size) osi_malloc_tagged((size), ALLOC_TAG_BTIF)
+#define osi_calloc(size) osi_calloc_tagged((size), ALLOC_TAG_BTIF)
+#endif
+
 /*******************************************************************************
  *  Constants & Macros
  ******************************************************************************/
@@ -153,6 +161,9 @@ typedef struct {
 extern bt_status_t do_in_jni_thread(base::OnceClosure task);
 extern bt_status_t do_in_jni_thread(const base::Location& from_here,
                                     base::OnceClosure task);
+extern bt_status_t do_in_jni_thread_delayed(const base::Location& from_here,
+                                            base::OnceClosure task,
+                                            const base::TimeDelta& delay);
 extern bool is_on_jni_thread();
 extern btbase::AbstractMessageLoop* get_jni_message_loop();
 /**
@@ -176,6 +187,10 @@ void btif_enable_service(tBTA_SERVICE_ID service_id);
 void btif_disable_service(tBTA_SERVICE_ID service_id);
 int btif_is_enabled(void);
 
+/* Checks the profile against the persist.bluetooth.profile_allowlist
+ * property; an empty or unset property allows every profile. */
+bool btif_is_profile_allowed(const char* profile_id);
+
 /**
  * BTIF_Events
  */
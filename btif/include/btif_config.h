@@ -24,6 +24,7 @@
 #include "bt_types.h"
 
 #include <list>
+#include <optional>
 #include <string>
 #include "osi/include/config.h"
 #include "types/ble_address_with_type.h"
@@ -41,6 +42,8 @@ static const std::string BT_CONFIG_KEY_SDP_DI_VENDOR_ID_SRC =
 static const std::string BT_CONFIG_KEY_REMOTE_VER_MFCT = "Manufacturer";
 static const std::string BT_CONFIG_KEY_REMOTE_VER_VER = "LmpVer";
 static const std::string BT_CONFIG_KEY_REMOTE_VER_SUBVER = "LmpSubVer";
+static const std::string BT_CONFIG_KEY_REMOTE_FEATURE_PAGES =
+    "LmpFeaturePages";
 
 bool btif_config_exist(const std::string& section, const std::string& key);
 bool btif_config_get_int(const std::string& section, const std::string& key,
@@ -64,6 +67,13 @@ bool btif_config_remove(const std::string& section, const std::string& key);
 size_t btif_config_get_bin_length(const std::string& section,
                                   const std::string& key);
 
+// Returns a copy of a whole persistent section under a single lock
+// acquisition, so callers decoding many keys can do one pass over the
+// entries instead of a keyed lookup per property. Returns std::nullopt when
+// the section does not exist or bulk access is unavailable (GD config shim);
+// callers are expected to fall back to the keyed getters then.
+std::optional<section_t> btif_config_get_section(const std::string& section);
+
 std::vector<RawAddress> btif_config_get_paired_devices();
 
 void btif_config_save(void);
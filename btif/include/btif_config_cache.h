@@ -33,6 +33,8 @@ class BtifConfigCache {
   void Init(std::unique_ptr<config_t> source);
   std::vector<std::string> GetPersistentSectionNames();
   config_t PersistentSectionCopy();
+  std::optional<section_t> PersistentSectionCopy(
+      const std::string& section_name);
   bool HasSection(const std::string& section_name);
   bool HasUnpairedSection(const std::string& section_name);
   bool HasPersistentSection(const std::string& section_name);
@@ -54,8 +56,20 @@ class BtifConfigCache {
   std::optional<bool> GetBool(const std::string& section_name,
                               const std::string& key);
 
+  // Incremental persistence support. Every mutation of a persistent section
+  // marks that section dirty; the saving code can fetch (and reset) the dirty
+  // set to journal only what changed since the last save. NeedsFullRewrite()
+  // reports changes - like a full cache reset - that section-level deltas
+  // cannot express.
+  bool NeedsFullRewrite() const;
+  std::unordered_set<std::string> TakeDirtySections();
+
  private:
+  void MarkDirty(const std::string& section_name);
+
   bluetooth::common::LegacyLruCache<std::string, section_t>
       unpaired_devices_cache_;
   config_t paired_devices_list_;
+  std::unordered_set<std::string> dirty_sections_;
+  bool needs_full_rewrite_ = false;
 };
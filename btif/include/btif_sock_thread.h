@@ -53,6 +53,15 @@ int btsock_thread_post_cmd(int handle, int cmd_type,
                            uint32_t user_id);
 int btsock_thread_create(btsock_signaled_cb callback,
                          btsock_cmd_cb cmd_callback);
+
+/* Create a pool of up to |shard_count| poll threads behind a single handle.
+ * Sockets are spread over the shards by user_id, so each socket keeps its
+ * events ordered on one thread while independent sockets poll in parallel. */
+int btsock_thread_create_pool(btsock_signaled_cb callback,
+                              btsock_cmd_cb cmd_callback, int shard_count);
 int btsock_thread_exit(int handle);
 
+/* Dump per-shard poll thread statistics (fd counts, dispatched signals). */
+void btsock_thread_dump(int fd);
+
 #endif
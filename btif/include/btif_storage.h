@@ -98,6 +98,22 @@ bt_status_t btif_storage_get_remote_device_property(
 bt_status_t btif_storage_set_remote_device_property(
     const RawAddress* remote_bd_addr, bt_property_t* property);
 
+/*******************************************************************************
+ *
+ * Function         btif_storage_get_cached_remote_name
+ *
+ * Description      BTIF storage API - Fetches the persisted remote device
+ *                  name and reports how long ago it was stored, so callers
+ *                  can decide whether a remote name request round trip is
+ *                  needed
+ *
+ * Returns          true if a name is cached for the device, in which case
+ *                  |bd_name| and |*p_age_seconds| are filled in
+ *
+ ******************************************************************************/
+bool btif_storage_get_cached_remote_name(const RawAddress& remote_bd_addr,
+                                         BD_NAME bd_name, int* p_age_seconds);
+
 /*******************************************************************************
  *
  * Function         btif_storage_get_io_caps
@@ -29,6 +29,10 @@ typedef struct {
   void (*clean_up_stack)(void);
 
   bool (*get_stack_is_running)(void);
+
+  // Re-parses |flags| on the management thread and publishes them without
+  // restarting the stack; see bluetooth::common::InitFlags::Reload.
+  void (*reload_init_flags_async)(const char** flags);
 } stack_manager_t;
 
 const stack_manager_t* stack_manager_get_interface();
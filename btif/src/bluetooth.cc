@@ -49,6 +49,8 @@
 #include "bt_utils.h"
 #include "bta/include/bta_hearing_aid_api.h"
 #include "bta/include/bta_hf_client_api.h"
+#include "bta/sys/bta_sys.h"
+#include "btcore/include/module.h"
 #include "btif/avrcp/avrcp_service.h"
 #include "btif_a2dp.h"
 #include "btif_activity_attribution.h"
@@ -62,6 +64,7 @@
 #include "btif_hf.h"
 #include "btif_keystore.h"
 #include "btif_metrics_logging.h"
+#include "btif_sock_thread.h"
 #include "btif_storage.h"
 #include "btsnoop.h"
 #include "btsnoop_mem.h"
@@ -69,19 +72,28 @@
 #include "common/metric_id_allocator.h"
 #include "common/metrics.h"
 #include "common/os_utils.h"
+#include "common/slo_monitor.h"
 #include "device/include/interop.h"
 #include "gd/common/init_flags.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
 #include "osi/include/alarm.h"
+#include "osi/include/allocation_ledger.h"
 #include "osi/include/allocation_tracker.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/pool_allocator.h"
+#include "osi/include/properties.h"
+#include "osi/include/thread.h"
+#include "osi/include/tracepoint.h"
 #include "osi/include/wakelock.h"
 #include "stack/gatt/connection_manager.h"
 #include "stack/include/avdt_api.h"
 #include "stack/include/btm_api.h"
+#include "stack/include/btm_ble_api.h"
+#include "stack/include/btm_iso_api.h"
 #include "stack/include/btu.h"
+#include "stack/include/l2c_api.h"
 #include "stack_manager.h"
 
 using bluetooth::hearing_aid::HearingAidInterface;
@@ -146,6 +158,32 @@ static bool is_profile(const char* p1, const char* p2) {
   return strlen(p1) == strlen(p2) && strncmp(p1, p2, strlen(p2)) == 0;
 }
 
+/*******************************************************************************
+ *
+ * Function         btif_is_profile_allowed
+ *
+ * Description      Checks |profile_id| against the comma-separated product
+ *                  allowlist in persist.bluetooth.profile_allowlist. Profiles
+ *                  outside the allowlist are never handed to the HAL client,
+ *                  so their btif init never runs and they stay unregistered
+ *                  with BTA. An empty or unset property allows every profile.
+ *
+ * Returns          true if the profile may be activated
+ *
+ ******************************************************************************/
+bool btif_is_profile_allowed(const char* profile_id) {
+  char allowlist[PROPERTY_VALUE_MAX] = "";
+  osi_property_get("persist.bluetooth.profile_allowlist", allowlist, "");
+  if (allowlist[0] == '\0') return true;
+
+  char* saveptr = NULL;
+  for (char* token = strtok_r(allowlist, ",", &saveptr); token != NULL;
+       token = strtok_r(NULL, ",", &saveptr)) {
+    if (is_profile(profile_id, token)) return true;
+  }
+  return false;
+}
+
 /*****************************************************************************
  *
  *   BLUETOOTH HAL INTERFACE FUNCTIONS
@@ -393,10 +431,23 @@ static void dump(int fd, const char** arguments) {
   stack_debug_avdtp_api_dump(fd);
   bluetooth::avrcp::AvrcpService::DebugDump(fd);
   btif_debug_config_dump(fd);
+  btsock_thread_dump(fd);
+  L2CA_LinkTxLatencyDump(fd);
+  L2CA_PoolUsageDump(fd);
+  btm_ble_multi_adv_dump(fd);
+  bta_sys_queue_dump(fd);
+  bluetooth::hci::IsoManager::GetInstance()->Dump(fd);
   BTA_HfClientDumpStatistics(fd);
   wakelock_debug_dump(fd);
+  module_timing_dump(fd);
   osi_allocator_debug_dump(fd);
+  allocation_ledger_debug_dump(fd);
+  pool_allocator_debug_dump(fd);
   alarm_debug_dump(fd);
+  tracepoint_debug_dump(fd);
+  get_main_thread()->DumpStatistics(fd);
+  thread_dump_all_cpu_stats(fd);
+  bluetooth::common::SloMonitor::GetInstance()->Dump(fd);
   HearingAid::DebugDump(fd);
   connection_manager::dump(fd);
   bluetooth::bqr::DebugDump(fd);
@@ -419,6 +470,11 @@ static const void* get_profile_interface(const char* profile_id) {
   /* sanity check */
   if (!interface_ready()) return NULL;
 
+  if (!btif_is_profile_allowed(profile_id)) {
+    LOG_INFO("%s: profile %s disabled by allowlist", __func__, profile_id);
+    return NULL;
+  }
+
   /* check for supported profile interfaces */
   if (is_profile(profile_id, BT_PROFILE_HANDSFREE_ID))
     return bluetooth::headset::GetInterface();
@@ -159,6 +159,7 @@ static void btif_a2dp_recv_ctrl_data(void) {
       break;
 
     case A2DP_CTRL_CMD_STOP:
+      btif_a2dp_source_shm_ring_detach();
       if (btif_av_get_peer_sep() == AVDT_TSEP_SNK &&
           !btif_a2dp_source_is_streaming()) {
         /* We are already stopped, just ack back */
@@ -170,6 +171,7 @@ static void btif_a2dp_recv_ctrl_data(void) {
       break;
 
     case A2DP_CTRL_CMD_SUSPEND:
+      btif_a2dp_source_shm_ring_detach();
       /* Local suspend */
       if (btif_av_stream_started_ready()) {
         btif_av_stream_suspend();
@@ -302,6 +304,39 @@ static void btif_a2dp_recv_ctrl_data(void) {
                 sizeof(nsec));
       break;
     }
+    case A2DP_CTRL_CMD_OPEN_SHM_RING: {
+      /* The ring replaces the data socket for source (audio out) only */
+      if (btif_av_get_peer_sep() != AVDT_TSEP_SNK) {
+        APPL_TRACE_WARNING("%s: A2DP command %s while peer is not a sink",
+                           __func__, audio_a2dp_hw_dump_ctrl_event(cmd));
+        btif_a2dp_command_ack(A2DP_CTRL_ACK_FAILURE);
+        break;
+      }
+      btif_a2dp_command_ack(A2DP_CTRL_ACK_SUCCESS);
+
+      uint32_t data_size = 0;
+      if (UIPC_Read(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, 0,
+                    reinterpret_cast<uint8_t*>(&data_size),
+                    sizeof(data_size)) != sizeof(data_size)) {
+        APPL_TRACE_ERROR("%s: Error reading ring size from audio HAL",
+                         __func__);
+        break;
+      }
+      if (data_size == 0) {
+        APPL_TRACE_ERROR("%s: audio HAL could not create the ring", __func__);
+        break;
+      }
+      int ring_fd = UIPC_RecvFd(*a2dp_uipc, UIPC_CH_ID_AV_CTRL);
+      if (ring_fd < 0) {
+        APPL_TRACE_ERROR("%s: Error receiving ring fd from audio HAL",
+                         __func__);
+        break;
+      }
+      uint8_t result = btif_a2dp_source_shm_ring_attach(ring_fd, data_size);
+      UIPC_Send(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, 0, &result, sizeof(result));
+      break;
+    }
+
     default:
       APPL_TRACE_ERROR("%s: UNSUPPORTED CMD (%d)", __func__, cmd);
       btif_a2dp_command_ack(A2DP_CTRL_ACK_FAILURE);
@@ -379,6 +414,7 @@ static void btif_a2dp_data_cb(UNUSED_ATTR tUIPC_CH_ID ch_id,
 
     case UIPC_CLOSE_EVT:
       APPL_TRACE_EVENT("%s: ## AUDIO PATH DETACHED ##", __func__);
+      btif_a2dp_source_shm_ring_detach();
       btif_a2dp_command_ack(A2DP_CTRL_ACK_SUCCESS);
       /*
        * Send stop request only if we are actively streaming and haven't
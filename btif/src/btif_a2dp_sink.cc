@@ -52,6 +52,16 @@ using LockGuard = std::lock_guard<std::mutex>;
 /* In case of A2DP Sink, we will delay start by 5 AVDTP Packets */
 #define MAX_A2DP_DELAYED_START_FRAME_COUNT 5
 
+/* Bounds for the adaptive jitter cushion - packets left queued after each
+ * decode tick to absorb RF jitter. The cushion grows on underrun and decays
+ * while the link is calm. */
+#define BTIF_SINK_MIN_RX_BACKLOG 2
+#define BTIF_SINK_MAX_RX_BACKLOG (MAX_INPUT_A2DP_FRAME_QUEUE_SZ / 2)
+
+/* Shrink the cushion by one packet after this many consecutive
+ * underrun-free decode ticks (250 ticks = 5 seconds). */
+#define BTIF_SINK_BACKLOG_DECAY_TICKS 250
+
 enum {
   BTIF_A2DP_SINK_STATE_OFF,
   BTIF_A2DP_SINK_STATE_STARTING_UP,
@@ -86,6 +96,10 @@ class BtifA2dpSinkControlBlock {
       : worker_thread(thread_name),
         rx_audio_queue(nullptr),
         rx_flush(false),
+        rx_target_backlog(MAX_A2DP_DELAYED_START_FRAME_COUNT),
+        rx_stable_tick_count(0),
+        rx_underrun_count(0),
+        rx_overflow_drop_count(0),
         decode_alarm(nullptr),
         sample_rate(0),
         channel_count(0),
@@ -104,6 +118,10 @@ class BtifA2dpSinkControlBlock {
     alarm_free(decode_alarm);
     decode_alarm = nullptr;
     rx_flush = false;
+    rx_target_backlog = MAX_A2DP_DELAYED_START_FRAME_COUNT;
+    rx_stable_tick_count = 0;
+    rx_underrun_count = 0;
+    rx_overflow_drop_count = 0;
     rx_focus_state = BTIF_A2DP_SINK_FOCUS_NOT_GRANTED;
     sample_rate = 0;
     channel_count = 0;
@@ -113,6 +131,10 @@ class BtifA2dpSinkControlBlock {
   MessageLoopThread worker_thread;
   fixed_queue_t* rx_audio_queue;
   bool rx_flush; /* discards any incoming data when true */
+  size_t rx_target_backlog;    /* jitter cushion kept queued, in packets */
+  int rx_stable_tick_count;    /* decode ticks since the last underrun */
+  size_t rx_underrun_count;    /* ticks that found the queue empty */
+  size_t rx_overflow_drop_count; /* oldest packets dropped on overflow */
   alarm_t* decode_alarm;
   tA2DP_SAMPLE_RATE sample_rate;
   tA2DP_BITS_PER_SAMPLE bits_per_sample;
@@ -508,8 +530,11 @@ static void btif_a2dp_sink_audio_handle_start_decoding() {
     LOG_ERROR("%s: unable to allocate decode alarm", __func__);
     return;
   }
-  alarm_set(btif_a2dp_sink_cb.decode_alarm, BTIF_SINK_MEDIA_TIME_TICK_MS,
-            btif_decode_alarm_cb, nullptr);
+  // Keep the decode tick off the shared default alarm thread so slow
+  // housekeeping callbacks elsewhere in the stack cannot stall it.
+  alarm_set_on_queue(btif_a2dp_sink_cb.decode_alarm,
+                     BTIF_SINK_MEDIA_TIME_TICK_MS, btif_decode_alarm_cb,
+                     nullptr, "alarm_av_callbacks");
 }
 
 static void btif_a2dp_sink_on_decode_complete(uint8_t* data, uint32_t len) {
@@ -539,6 +564,16 @@ static void btif_a2dp_sink_avk_handle_timer() {
   BT_HDR* p_msg;
   if (fixed_queue_is_empty(btif_a2dp_sink_cb.rx_audio_queue)) {
     APPL_TRACE_DEBUG("%s: empty queue", __func__);
+    /* The cushion drained completely; grow it so an RF jitter burst of the
+     * same size no longer starves the audio track. Ticks while flushed or
+     * without focus are not jitter and must not inflate the cushion. */
+    if (!btif_a2dp_sink_cb.rx_flush &&
+        btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_GRANTED) {
+      btif_a2dp_sink_cb.rx_underrun_count++;
+      btif_a2dp_sink_cb.rx_stable_tick_count = 0;
+      if (btif_a2dp_sink_cb.rx_target_backlog < BTIF_SINK_MAX_RX_BACKLOG)
+        btif_a2dp_sink_cb.rx_target_backlog++;
+    }
     return;
   }
 
@@ -555,7 +590,15 @@ static void btif_a2dp_sink_avk_handle_timer() {
   }
 
   APPL_TRACE_DEBUG("%s: process frames begin", __func__);
-  while (true) {
+  /* Decode down to the target cushion instead of draining the queue dry;
+   * what stays queued is the slack that rides out the next late batch of
+   * packets. Always decode at least one packet so the track keeps getting
+   * fed at the arrival rate while the cushion holds steady. */
+  size_t available = fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
+  size_t to_decode = (available > btif_a2dp_sink_cb.rx_target_backlog)
+                         ? available - btif_a2dp_sink_cb.rx_target_backlog
+                         : 1;
+  for (; to_decode > 0; to_decode--) {
     p_msg = (BT_HDR*)fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue);
     if (p_msg == NULL) {
       break;
@@ -567,6 +610,15 @@ static void btif_a2dp_sink_avk_handle_timer() {
     btif_a2dp_sink_handle_inc_media(p_msg);
     osi_free(p_msg);
   }
+
+  /* A long underrun-free stretch means the link is calm; give the latency
+   * back one packet at a time. */
+  if (++btif_a2dp_sink_cb.rx_stable_tick_count >=
+      BTIF_SINK_BACKLOG_DECAY_TICKS) {
+    btif_a2dp_sink_cb.rx_stable_tick_count = 0;
+    if (btif_a2dp_sink_cb.rx_target_backlog > BTIF_SINK_MIN_RX_BACKLOG)
+      btif_a2dp_sink_cb.rx_target_backlog--;
+  }
   APPL_TRACE_DEBUG("%s: process frames end", __func__);
 }
 
@@ -652,24 +704,24 @@ static void btif_a2dp_sink_decoder_update_event(
 
 uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
   LockGuard lock(g_mutex);
-  if (btif_a2dp_sink_cb.rx_flush) /* Flush enabled, do not enqueue */
+  if (btif_a2dp_sink_cb.rx_flush) { /* Flush enabled, do not enqueue */
+    osi_free(p_pkt);
     return fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
+  }
 
   if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) ==
       MAX_INPUT_A2DP_FRAME_QUEUE_SZ) {
-    uint8_t ret = fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
+    /* Keep the freshest audio on overflow: retire the oldest packet and
+     * still enqueue the new one below. */
     osi_free(fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue));
-    return ret;
+    btif_a2dp_sink_cb.rx_overflow_drop_count++;
   }
 
   BTIF_TRACE_VERBOSE("%s +", __func__);
-  /* Allocate and queue this buffer */
-  BT_HDR* p_msg =
-      reinterpret_cast<BT_HDR*>(osi_malloc(sizeof(*p_msg) + p_pkt->len));
-  memcpy(p_msg, p_pkt, sizeof(*p_msg));
-  p_msg->offset = 0;
-  memcpy(p_msg->data, p_pkt->data + p_pkt->offset, p_pkt->len);
-  fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_msg);
+  /* Queue the loaned AVDTP buffer as-is; the decoders consume the payload
+   * at |offset| and the buffer is freed after decoding, so no copy is
+   * needed at the full media bit rate. */
+  fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_pkt);
   if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) ==
       MAX_A2DP_DELAYED_START_FRAME_COUNT) {
     BTIF_TRACE_DEBUG("%s: Initiate decoding", __func__);
@@ -693,8 +745,21 @@ void btif_a2dp_sink_audio_rx_flush_req() {
       FROM_HERE, base::BindOnce(btif_a2dp_sink_command_ready, p_buf));
 }
 
-void btif_a2dp_sink_debug_dump(UNUSED_ATTR int fd) {
-  // Nothing to do
+void btif_a2dp_sink_debug_dump(int fd) {
+  LockGuard lock(g_mutex);
+  if (btif_a2dp_sink_state == BTIF_A2DP_SINK_STATE_OFF) return;
+
+  dprintf(fd, "\nA2DP Sink State:\n");
+  dprintf(fd, "  RxQueue:\n");
+  dprintf(fd,
+          "  Jitter cushion target (packets)                         : %zu\n",
+          btif_a2dp_sink_cb.rx_target_backlog);
+  dprintf(fd,
+          "  Underruns                                               : %zu\n",
+          btif_a2dp_sink_cb.rx_underrun_count);
+  dprintf(fd,
+          "  Overflow drops                                          : %zu\n",
+          btif_a2dp_sink_cb.rx_overflow_drop_count);
 }
 
 void btif_a2dp_sink_set_focus_state_req(btif_a2dp_sink_focus_state_t state) {
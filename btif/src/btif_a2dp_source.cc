@@ -27,8 +27,12 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <string.h>
+#include <unistd.h>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 
+#include "audio_a2dp_hw/include/a2dp_shm_ring.h"
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
 #include "audio_hal_interface/a2dp_encoding.h"
 #include "bt_common.h"
@@ -39,18 +43,22 @@
 #include "btif_a2dp_source.h"
 #include "btif_av.h"
 #include "btif_av_co.h"
+#include "btif_bqr.h"
 #include "btif_metrics_logging.h"
 #include "btif_util.h"
 #include "common/message_loop_thread.h"
 #include "common/metrics.h"
 #include "common/repeating_timer.h"
 #include "common/time_util.h"
-#include "osi/include/fixed_queue.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/tracepoint.h"
 #include "osi/include/wakelock.h"
+#include "device/include/controller.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/acl_api_types.h"
+#include "stack/include/btm_api.h"
+#include "stack/include/l2c_api.h"
 #include "uipc.h"
 
 using bluetooth::common::A2dpSessionMetrics;
@@ -66,6 +74,76 @@ extern std::unique_ptr<tUIPC_STATE> a2dp_uipc;
  */
 #define MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ (MAX_PCM_FRAME_NUM_PER_TICK * 2)
 
+/**
+ * Maximum number of encoder intervals coalesced into a single media alarm
+ * wakeup when the TX queue is fully drained. Two intervals halve the steady
+ * state wakeup rate and the resulting burst still fits within
+ * MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ.
+ */
+#define MAX_TX_BATCH_INTERVALS 2
+
+/**
+ * Number of slots in the TX packet ring. Must be a power of two and larger
+ * than the largest dynamic audio buffer size (bounded by uint8_t), so that
+ * a packet which passed the overflow check never finds the ring full.
+ */
+#define BTIF_A2DP_SOURCE_TX_RING_SZ 256
+
+/**
+ * Lock-free ring carrying encoded audio packets from the encoder on the
+ * A2DP source worker thread to the BTA AV data path.
+ *
+ * There is a single producer (btif_a2dp_source_enqueue_callback). The
+ * dequeue side claims slots with a compare-and-swap so that the exceptional
+ * flush and overflow paths, which drain the ring from the worker thread,
+ * are safe against the regular consumer on the stack main thread.
+ */
+class BtifA2dpSourceTxRing {
+ public:
+  BtifA2dpSourceTxRing() : head_(0), tail_(0) {}
+
+  size_t Length() const {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+  bool Enqueue(BT_HDR* p_buf) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >=
+        BTIF_A2DP_SOURCE_TX_RING_SZ) {
+      return false;
+    }
+    slots_[head & (BTIF_A2DP_SOURCE_TX_RING_SZ - 1)] = p_buf;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  BT_HDR* Dequeue() {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      if (tail == head_.load(std::memory_order_acquire)) return nullptr;
+      BT_HDR* p_buf = slots_[tail & (BTIF_A2DP_SOURCE_TX_RING_SZ - 1)];
+      // The producer cannot reuse the slot until tail_ moves past it, so
+      // p_buf is stable if the claim below succeeds.
+      if (tail_.compare_exchange_weak(tail, tail + 1,
+                                      std::memory_order_acq_rel)) {
+        return p_buf;
+      }
+    }
+  }
+
+  /* Remove and free all queued packets */
+  void Flush() {
+    BT_HDR* p_buf;
+    while ((p_buf = Dequeue()) != nullptr) osi_free(p_buf);
+  }
+
+ private:
+  std::atomic<size_t> head_;  // Next slot to fill, written by the producer
+  std::atomic<size_t> tail_;  // Next slot to drain, claimed by consumers
+  BT_HDR* slots_[BTIF_A2DP_SOURCE_TX_RING_SZ];
+};
+
 class SchedulingStats {
  public:
   SchedulingStats() { Reset(); }
@@ -136,6 +214,7 @@ class BtifMediaStats {
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
+    link_tx_latency_p95_ms = 0;
     codec_index = -1;
   }
 
@@ -166,6 +245,9 @@ class BtifMediaStats {
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
 
+  // Most recent p95 TX latency of the active link (in ms)
+  uint16_t link_tx_latency_p95_ms;
+
   int codec_index = -1;
 };
 
@@ -179,20 +261,22 @@ class BtifA2dpSource {
   };
 
   BtifA2dpSource()
-      : tx_audio_queue(nullptr),
-        tx_flush(false),
+      : tx_flush(false),
+        low_latency_mode(false),
         encoder_interface(nullptr),
         encoder_interval_ms(0),
+        tx_batch_intervals(1),
         state_(kStateOff) {}
 
   void Reset() {
-    fixed_queue_free(tx_audio_queue, nullptr);
-    tx_audio_queue = nullptr;
+    tx_audio_ring.Flush();
     tx_flush = false;
+    low_latency_mode = false;
     media_alarm.CancelAndWait();
     wakelock_release();
     encoder_interface = nullptr;
     encoder_interval_ms = 0;
+    tx_batch_intervals = 1;
     stats.Reset();
     accumulated_stats.Reset();
     state_ = kStateOff;
@@ -214,11 +298,13 @@ class BtifA2dpSource {
 
   void SetState(BtifA2dpSource::RunState state) { state_ = state; }
 
-  fixed_queue_t* tx_audio_queue;
+  BtifA2dpSourceTxRing tx_audio_ring;
   bool tx_flush; /* Discards any outgoing data when true */
+  bool low_latency_mode; /* Trades robustness for latency when true */
   RepeatingTimer media_alarm;
   const tA2DP_ENCODER_INTERFACE* encoder_interface;
   uint64_t encoder_interval_ms; /* Local copy of the encoder interval */
+  int tx_batch_intervals; /* Encoder intervals per media alarm wakeup */
   BtifMediaStats stats;
   BtifMediaStats accumulated_stats;
 
@@ -233,6 +319,40 @@ static BtifA2dpSource btif_a2dp_source_cb;
 static uint8_t btif_a2dp_source_dynamic_audio_buffer_size =
     MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ;
 
+/* Extra TX queue length reported to the codec's adaptive bit rate logic
+ * while the controller is flagging degraded link quality */
+#define BTIF_A2DP_SOURCE_BQR_DEGRADED_QUEUE_PENALTY 2
+
+/* Queueing latency (p95) above which audio packets are stale enough that
+ * the controller should flush rather than retransmit them, and the number
+ * of media timer ticks between re-evaluations of that policy */
+#define BTIF_A2DP_SOURCE_MAX_TX_LATENCY_MS 200
+#define BTIF_A2DP_SOURCE_FLUSH_POLICY_TICKS 50
+
+/* Low-latency (game) mode bounds, sized so the Bluetooth leg fits a <60 ms
+ * glass-to-ear budget: the TX queue is capped at one encoder tick worth of
+ * packets, wakeup coalescing is disabled and the adaptive flush policy is
+ * re-evaluated more often against a tighter latency ceiling */
+#define BTIF_A2DP_SOURCE_LOW_LATENCY_MAX_TX_LATENCY_MS 40
+#define BTIF_A2DP_SOURCE_LOW_LATENCY_FLUSH_POLICY_TICKS 5
+#define BTIF_A2DP_SOURCE_LOW_LATENCY_FRAME_QUEUE_SZ MAX_PCM_FRAME_NUM_PER_TICK
+
+/* Shared-memory PCM ring negotiated by the A2DP HAL over the control channel;
+ * nullptr when PCM is read from the UIPC data socket instead. Attach/detach
+ * run on the UIPC read thread while reads run on the media worker thread, so
+ * the pointer is guarded by its own mutex. */
+static a2dp_shm_ring_t* btif_a2dp_source_shm_ring = nullptr;
+static std::mutex btif_a2dp_source_shm_ring_mutex;
+
+/* Double-buffered statistics snapshot for dumpsys. The media worker merges
+ * the live session counters on top of the accumulated ones into the slot
+ * not currently exposed, then flips the index with release semantics. The
+ * dump path copies the exposed slot and formats from the copy, so taking a
+ * bugreport neither blocks nor races the audio path. A slot stays stable
+ * for at least one full publish cycle, far longer than the copy takes. */
+static BtifMediaStats btif_a2dp_source_stats_snapshot[2];
+static std::atomic<int> btif_a2dp_source_stats_snapshot_index{0};
+
 static void btif_a2dp_source_init_delayed(void);
 static void btif_a2dp_source_startup_delayed(void);
 static void btif_a2dp_source_start_session_delayed(
@@ -244,6 +364,7 @@ static void btif_a2dp_source_cleanup_delayed(void);
 static void btif_a2dp_source_audio_tx_start_event(void);
 static void btif_a2dp_source_audio_tx_stop_event(void);
 static void btif_a2dp_source_audio_tx_flush_event(void);
+static void btif_a2dp_source_set_low_latency_mode_event(bool enabled);
 // Set up the A2DP Source codec, and prepare the encoder.
 // The peer address is |peer_addr|.
 // This function should be called prior to starting A2DP streaming.
@@ -264,6 +385,9 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
 static void log_tstamps_us(const char* comment, uint64_t timestamp_us);
 static void update_scheduling_stats(SchedulingStats* stats, uint64_t now_us,
                                     uint64_t expected_delta);
+// Publish a merged copy of the statistics into the inactive snapshot slot.
+// Must be called on the media worker thread.
+static void btif_a2dp_source_publish_stats_snapshot(void);
 // Update the A2DP Source related metrics.
 // This function should be called before collecting the metrics.
 static void btif_a2dp_source_update_metrics(void);
@@ -308,6 +432,8 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
       dst->tx_queue_max_dropped_messages, src->tx_queue_max_dropped_messages);
   dst->tx_queue_dropouts += src->tx_queue_dropouts;
   dst->tx_queue_last_dropouts_us = src->tx_queue_last_dropouts_us;
+  if (src->link_tx_latency_p95_ms != 0)
+    dst->link_tx_latency_p95_ms = src->link_tx_latency_p95_ms;
   dst->media_read_total_underflow_bytes +=
       src->media_read_total_underflow_bytes;
   dst->media_read_total_underflow_count +=
@@ -321,6 +447,22 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
   src->Reset();
 }
 
+static void btif_a2dp_source_publish_stats_snapshot(void) {
+  int inactive =
+      btif_a2dp_source_stats_snapshot_index.load(std::memory_order_relaxed) ^
+      1;
+  BtifMediaStats* snapshot = &btif_a2dp_source_stats_snapshot[inactive];
+
+  *snapshot = btif_a2dp_source_cb.accumulated_stats;
+  // Merge a copy of the in-progress session on top; accumulating resets its
+  // source, so the live counters must not be passed in directly.
+  BtifMediaStats session = btif_a2dp_source_cb.stats;
+  btif_a2dp_source_accumulate_stats(&session, snapshot);
+
+  btif_a2dp_source_stats_snapshot_index.store(inactive,
+                                              std::memory_order_release);
+}
+
 bool btif_a2dp_source_init(void) {
   LOG_INFO("%s", __func__);
 
@@ -346,7 +488,6 @@ bool btif_a2dp_source_startup(void) {
 
   btif_a2dp_source_cb.Reset();
   btif_a2dp_source_cb.SetState(BtifA2dpSource::kStateStartingUp);
-  btif_a2dp_source_cb.tx_audio_queue = fixed_queue_new(SIZE_MAX);
 
   // Schedule the rest of the operations
   btif_a2dp_source_thread.DoInThread(
@@ -511,8 +652,7 @@ static void btif_a2dp_source_shutdown_delayed(void) {
   } else {
     btif_a2dp_control_cleanup();
   }
-  fixed_queue_free(btif_a2dp_source_cb.tx_audio_queue, nullptr);
-  btif_a2dp_source_cb.tx_audio_queue = nullptr;
+  btif_a2dp_source_cb.tx_audio_ring.Flush();
 
   btif_a2dp_source_cb.SetState(BtifA2dpSource::kStateOff);
 }
@@ -596,6 +736,12 @@ static void btif_a2dp_source_setup_codec_delayed(
   btif_a2dp_source_cb.encoder_interval_ms =
       btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms();
 
+  // Re-apply the low-latency mode to the freshly initialized encoder
+  if (btif_a2dp_source_cb.encoder_interface->set_low_latency_mode != nullptr) {
+    btif_a2dp_source_cb.encoder_interface->set_low_latency_mode(
+        btif_a2dp_source_cb.low_latency_mode);
+  }
+
   if (bluetooth::audio::a2dp::is_hal_2_0_enabled()) {
     bluetooth::audio::a2dp::setup_codec();
   }
@@ -769,6 +915,25 @@ void btif_a2dp_source_set_tx_flush(bool enable) {
   btif_a2dp_source_cb.tx_flush = enable;
 }
 
+void btif_a2dp_source_set_low_latency_mode(bool enabled) {
+  LOG_INFO("%s: enabled=%s state=%s", __func__,
+           (enabled) ? "true" : "false",
+           btif_a2dp_source_cb.StateStr().c_str());
+  btif_a2dp_source_thread.DoInThread(
+      FROM_HERE,
+      base::Bind(&btif_a2dp_source_set_low_latency_mode_event, enabled));
+}
+
+static void btif_a2dp_source_set_low_latency_mode_event(bool enabled) {
+  if (btif_a2dp_source_cb.low_latency_mode == enabled) return;
+  btif_a2dp_source_cb.low_latency_mode = enabled;
+  if (btif_a2dp_source_cb.encoder_interface != nullptr &&
+      btif_a2dp_source_cb.encoder_interface->set_low_latency_mode !=
+          nullptr) {
+    btif_a2dp_source_cb.encoder_interface->set_low_latency_mode(enabled);
+  }
+}
+
 static void btif_a2dp_source_audio_tx_start_event(void) {
   LOG_INFO(
       "%s: media_alarm is %s, streaming %s state=%s", __func__,
@@ -788,6 +953,7 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
 
   /* audio engine starting, reset tx suspended flag */
   btif_a2dp_source_cb.tx_flush = false;
+  btif_a2dp_source_cb.tx_batch_intervals = 1;
 
   wakelock_acquire();
   btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
@@ -810,6 +976,7 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
   if (codec_config != nullptr) {
     btif_a2dp_source_cb.stats.codec_index = codec_config->codecIndex();
   }
+  btif_a2dp_source_publish_stats_snapshot();
 }
 
 static void btif_a2dp_source_audio_tx_stop_event(void) {
@@ -826,6 +993,7 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
   btif_a2dp_source_update_metrics();
   btif_a2dp_source_accumulate_stats(&btif_a2dp_source_cb.stats,
                                     &btif_a2dp_source_cb.accumulated_stats);
+  btif_a2dp_source_publish_stats_snapshot();
 
   uint8_t p_buf[AUDIO_STREAM_OUTPUT_BUFFER_SZ * 2];
   uint16_t event;
@@ -835,8 +1003,15 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
     btif_a2dp_control_log_bytes_read(
         bluetooth::audio::a2dp::read(p_buf, sizeof(p_buf)));
   } else if (a2dp_uipc != nullptr) {
-    btif_a2dp_control_log_bytes_read(UIPC_Read(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO,
-                                               &event, p_buf, sizeof(p_buf)));
+    std::unique_lock<std::mutex> lock(btif_a2dp_source_shm_ring_mutex);
+    if (btif_a2dp_source_shm_ring != nullptr) {
+      btif_a2dp_control_log_bytes_read(
+          a2dp_shm_ring_read(btif_a2dp_source_shm_ring, p_buf, sizeof(p_buf)));
+    } else {
+      lock.unlock();
+      btif_a2dp_control_log_bytes_read(UIPC_Read(
+          *a2dp_uipc, UIPC_CH_ID_AV_AUDIO, &event, p_buf, sizeof(p_buf)));
+    }
   }
 
   /* Stop the timer first */
@@ -883,21 +1058,127 @@ static void btif_a2dp_source_audio_handle_timer(void) {
     return;
   }
   CHECK(btif_a2dp_source_cb.encoder_interface != nullptr);
-  size_t transmit_queue_length =
-      fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+  size_t transmit_queue_length = btif_a2dp_source_cb.tx_audio_ring.Length();
+  TRACEPOINT(TRACE_A2DP_ENCODE_TICK, transmit_queue_length, 0);
 #ifndef OS_GENERIC
   ATRACE_INT("btif TX queue", transmit_queue_length);
 #endif
   if (btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length !=
       nullptr) {
+    // Fold controller-side congestion into the queue length handed to the
+    // codec's adaptive bit rate logic. Our queue only starts to build once
+    // the controller ACL buffers are already full, so counting the packets
+    // parked in the controller beyond half the pool, plus any recent link
+    // quality warning from the BQR stream, lets the bit rate drop before
+    // audio piles up here.
+    size_t effective_queue_length = transmit_queue_length;
+    uint16_t acl_buffers_total =
+        controller_get_interface()->get_acl_buffer_count_classic();
+    uint16_t acl_buffers_used = L2CA_GetControllerAclBuffersUsed();
+    if (acl_buffers_total != 0 && acl_buffers_used > acl_buffers_total / 2) {
+      effective_queue_length += acl_buffers_used - acl_buffers_total / 2;
+    }
+    if (bluetooth::bqr::LinkQualityIsDegraded()) {
+      effective_queue_length += BTIF_A2DP_SOURCE_BQR_DEGRADED_QUEUE_PENALTY;
+    }
+    // Grade the penalty further by the sliding-window link quality score of
+    // the active link, so the bit rate backs off proportionally as the link
+    // deteriorates instead of waiting for a hard degradation report.
+    uint8_t link_score = bluetooth::bqr::GetLinkQualityScore(
+        BTM_GetHCIConnHandle(btif_av_source_active_peer(),
+                             BT_TRANSPORT_BR_EDR));
+    effective_queue_length +=
+        (bluetooth::bqr::kMaxLinkQualityScore - link_score) *
+        BTIF_A2DP_SOURCE_BQR_DEGRADED_QUEUE_PENALTY * 2 /
+        bluetooth::bqr::kMaxLinkQualityScore;
+#ifndef OS_GENERIC
+    ATRACE_INT("btif effective TX queue", effective_queue_length);
+#endif
     btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length(
-        transmit_queue_length);
+        effective_queue_length);
   }
-  btif_a2dp_source_cb.encoder_interface->send_frames(timestamp_us);
+  // Periodically re-evaluate the automatic flush timeout against the
+  // measured per-link TX latency; the underlying HCI write is cached, so
+  // a steady verdict costs nothing. Low-latency mode uses a tighter
+  // latency ceiling and re-evaluates more often.
+  static unsigned flush_policy_ticks = 0;
+  unsigned flush_policy_period =
+      btif_a2dp_source_cb.low_latency_mode
+          ? BTIF_A2DP_SOURCE_LOW_LATENCY_FLUSH_POLICY_TICKS
+          : BTIF_A2DP_SOURCE_FLUSH_POLICY_TICKS;
+  if (++flush_policy_ticks >= flush_policy_period) {
+    flush_policy_ticks = 0;
+    RawAddress peer_address = btif_av_source_active_peer();
+    btif_a2dp_source_cb.stats.link_tx_latency_p95_ms =
+        L2CA_GetTxLatencyMs(peer_address, 95);
+    BTM_SetAdaptiveFlushTimeout(
+        peer_address, btif_a2dp_source_cb.low_latency_mode
+                          ? BTIF_A2DP_SOURCE_LOW_LATENCY_MAX_TX_LATENCY_MS
+                          : BTIF_A2DP_SOURCE_MAX_TX_LATENCY_MS);
+  }
+
+  /* Pace the encoder off the alarm's nominal tick time instead of the
+   * sampled wall clock: the encoders budget frames from the time elapsed
+   * since their previous pass, so feeding them jitter-free timestamps
+   * keeps every tick at exactly one interval of frames. Catch-up bursts
+   * now only happen for genuinely lost ticks, not for late dispatch. */
+  btif_a2dp_source_cb.encoder_interface->send_frames(
+      btif_a2dp_source_cb.media_alarm.GetNominalTickTimeUs());
   bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
   update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
                           timestamp_us,
-                          btif_a2dp_source_cb.encoder_interval_ms * 1000);
+                          btif_a2dp_source_cb.encoder_interval_ms * 1000 *
+                              btif_a2dp_source_cb.tx_batch_intervals);
+
+  // Coalesce encoder intervals while the sink keeps the TX queue drained.
+  // The encoders scale the number of frames by the wall time elapsed since
+  // their last pass, so lengthening the period encodes a proportionally
+  // larger burst per wakeup; an empty queue before this pass means the
+  // previous burst was fully handed to L2CAP, i.e. the link has headroom.
+  // Any buffering drops back to per-interval wakeups to limit added latency.
+  // Low-latency mode never coalesces: the longer encode period itself
+  // delays the first frame of every burst.
+  int batch_intervals =
+      (transmit_queue_length == 0 && !btif_a2dp_source_cb.low_latency_mode)
+          ? MAX_TX_BATCH_INTERVALS
+          : 1;
+  if (batch_intervals != btif_a2dp_source_cb.tx_batch_intervals) {
+    btif_a2dp_source_cb.tx_batch_intervals = batch_intervals;
+    btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
+        btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
+        base::Bind(&btif_a2dp_source_audio_handle_timer),
+        base::TimeDelta::FromMilliseconds(
+            batch_intervals *
+            btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms()));
+  }
+
+  btif_a2dp_source_publish_stats_snapshot();
+}
+
+bool btif_a2dp_source_shm_ring_attach(int fd, uint32_t data_size) {
+  a2dp_shm_ring_t* ring = a2dp_shm_ring_attach(fd, false /* initialize */);
+  close(fd);
+  if (ring == nullptr || ring->hdr->data_size != data_size) {
+    LOG_ERROR("%s: cannot map shared-memory ring (size %u)", __func__,
+              data_size);
+    if (ring != nullptr) a2dp_shm_ring_detach(ring);
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(btif_a2dp_source_shm_ring_mutex);
+  if (btif_a2dp_source_shm_ring != nullptr)
+    a2dp_shm_ring_detach(btif_a2dp_source_shm_ring);
+  btif_a2dp_source_shm_ring = ring;
+  LOG_INFO("%s: shared-memory ring mapped (size %u)", __func__, data_size);
+  return true;
+}
+
+void btif_a2dp_source_shm_ring_detach(void) {
+  std::lock_guard<std::mutex> lock(btif_a2dp_source_shm_ring_mutex);
+  if (btif_a2dp_source_shm_ring == nullptr) return;
+  a2dp_shm_ring_detach(btif_a2dp_source_shm_ring);
+  btif_a2dp_source_shm_ring = nullptr;
+  LOG_INFO("%s: shared-memory ring unmapped", __func__);
 }
 
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
@@ -907,7 +1188,14 @@ static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
   if (bluetooth::audio::a2dp::is_hal_2_0_enabled()) {
     bytes_read = bluetooth::audio::a2dp::read(p_buf, len);
   } else if (a2dp_uipc != nullptr) {
-    bytes_read = UIPC_Read(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, &event, p_buf, len);
+    std::unique_lock<std::mutex> lock(btif_a2dp_source_shm_ring_mutex);
+    if (btif_a2dp_source_shm_ring != nullptr) {
+      bytes_read = a2dp_shm_ring_read(btif_a2dp_source_shm_ring, p_buf, len);
+    } else {
+      lock.unlock();
+      bytes_read =
+          UIPC_Read(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, &event, p_buf, len);
+    }
   }
 
   if (bytes_read < len) {
@@ -942,35 +1230,40 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
     LOG_VERBOSE("%s: tx suspended, discarded frame", __func__);
 
     btif_a2dp_source_cb.stats.tx_queue_total_flushed_messages +=
-        fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+        btif_a2dp_source_cb.tx_audio_ring.Length();
     btif_a2dp_source_cb.stats.tx_queue_last_flushed_us = now_us;
-    fixed_queue_flush(btif_a2dp_source_cb.tx_audio_queue, osi_free);
+    btif_a2dp_source_cb.tx_audio_ring.Flush();
 
     osi_free(p_buf);
     return false;
   }
 
-  // Check for TX queue overflow
+  // Check for TX queue overflow. Low-latency mode caps the queue to one
+  // encoder tick worth of packets: anything deeper is pure added latency.
   // TODO: Using frames_n here is probably wrong: should be "+ 1" instead.
-  if (fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue) + frames_n >
-      btif_a2dp_source_dynamic_audio_buffer_size) {
-    LOG_WARN("%s: TX queue buffer size now=%u adding=%u max=%d", __func__,
-             (uint32_t)fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue),
-             (uint32_t)frames_n, btif_a2dp_source_dynamic_audio_buffer_size);
+  size_t max_frame_queue_sz = btif_a2dp_source_dynamic_audio_buffer_size;
+  if (btif_a2dp_source_cb.low_latency_mode &&
+      max_frame_queue_sz > BTIF_A2DP_SOURCE_LOW_LATENCY_FRAME_QUEUE_SZ) {
+    max_frame_queue_sz = BTIF_A2DP_SOURCE_LOW_LATENCY_FRAME_QUEUE_SZ;
+  }
+  if (btif_a2dp_source_cb.tx_audio_ring.Length() + frames_n >
+      max_frame_queue_sz) {
+    LOG_WARN("%s: TX queue buffer size now=%u adding=%u max=%zu", __func__,
+             (uint32_t)btif_a2dp_source_cb.tx_audio_ring.Length(),
+             (uint32_t)frames_n, max_frame_queue_sz);
     // Keep track of drop-outs
     btif_a2dp_source_cb.stats.tx_queue_dropouts++;
     btif_a2dp_source_cb.stats.tx_queue_last_dropouts_us = now_us;
 
     // Flush all queued buffers
-    size_t drop_n = fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+    size_t drop_n = btif_a2dp_source_cb.tx_audio_ring.Length();
     btif_a2dp_source_cb.stats.tx_queue_max_dropped_messages = std::max(
         drop_n, btif_a2dp_source_cb.stats.tx_queue_max_dropped_messages);
     int num_dropped_encoded_bytes = 0;
     int num_dropped_encoded_frames = 0;
-    while (fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue)) {
+    while (btif_a2dp_source_cb.tx_audio_ring.Length()) {
       btif_a2dp_source_cb.stats.tx_queue_total_dropped_messages++;
-      void* p_data =
-          fixed_queue_try_dequeue(btif_a2dp_source_cb.tx_audio_queue);
+      void* p_data = btif_a2dp_source_cb.tx_audio_ring.Dequeue();
       if (p_data != nullptr) {
         auto p_dropped_buf = static_cast<BT_HDR*>(p_data);
         num_dropped_encoded_bytes += p_dropped_buf->len;
@@ -983,9 +1276,12 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                  num_dropped_encoded_frames,
                                  num_dropped_encoded_bytes);
 
-    // Request additional debug info if we had to flush buffers
+    // Request additional debug info if we had to flush buffers. The RSSI
+    // read goes through the shared poller so it cannot collide with other
+    // subsystems monitoring the same link.
     RawAddress peer_bda = btif_av_source_active_peer();
-    tBTM_STATUS status = BTM_ReadRSSI(peer_bda, btm_read_rssi_cb);
+    tBTM_STATUS status = BTM_LinkMetricsSubscribe(peer_bda, 0,
+                                                  btm_read_rssi_cb);
     if (status != BTM_CMD_STARTED) {
       LOG_WARN("%s: Cannot read RSSI: status %d", __func__, status);
     }
@@ -1008,7 +1304,14 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
       frames_n, btif_a2dp_source_cb.stats.tx_queue_max_frames_per_packet);
   CHECK(btif_a2dp_source_cb.encoder_interface != nullptr);
 
-  fixed_queue_enqueue(btif_a2dp_source_cb.tx_audio_queue, p_buf);
+  if (!btif_a2dp_source_cb.tx_audio_ring.Enqueue(p_buf)) {
+    // Cannot happen while the ring is sized above the largest dynamic
+    // audio buffer size; drop rather than block the encoder.
+    LOG_ERROR("%s: TX ring full, dropping packet", __func__);
+    btif_a2dp_source_cb.stats.tx_queue_total_dropped_messages++;
+    osi_free(p_buf);
+    return false;
+  }
 
   return true;
 }
@@ -1022,10 +1325,10 @@ static void btif_a2dp_source_audio_tx_flush_event(void) {
     btif_a2dp_source_cb.encoder_interface->feeding_flush();
 
   btif_a2dp_source_cb.stats.tx_queue_total_flushed_messages +=
-      fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+      btif_a2dp_source_cb.tx_audio_ring.Length();
   btif_a2dp_source_cb.stats.tx_queue_last_flushed_us =
       bluetooth::common::time_get_os_boottime_us();
-  fixed_queue_flush(btif_a2dp_source_cb.tx_audio_queue, osi_free);
+  btif_a2dp_source_cb.tx_audio_ring.Flush();
 
   if (!bluetooth::audio::a2dp::is_hal_2_0_enabled() && a2dp_uipc != nullptr) {
     UIPC_Ioctl(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, UIPC_REQ_RX_FLUSH, nullptr);
@@ -1042,8 +1345,7 @@ static bool btif_a2dp_source_audio_tx_flush_req(void) {
 
 BT_HDR* btif_a2dp_source_audio_readbuf(void) {
   uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
-  BT_HDR* p_buf =
-      (BT_HDR*)fixed_queue_try_dequeue(btif_a2dp_source_cb.tx_audio_queue);
+  BT_HDR* p_buf = btif_a2dp_source_cb.tx_audio_ring.Dequeue();
 
   btif_a2dp_source_cb.stats.tx_queue_total_readbuf_calls++;
   btif_a2dp_source_cb.stats.tx_queue_last_readbuf_us = now_us;
@@ -1062,7 +1364,7 @@ static void log_tstamps_us(const char* comment, uint64_t timestamp_us) {
   APPL_TRACE_DEBUG("%s: [%s] ts %08" PRIu64 ", diff : %08" PRIu64
                    ", queue sz %zu",
                    __func__, comment, timestamp_us, timestamp_us - prev_us,
-                   fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue));
+                   btif_a2dp_source_cb.tx_audio_ring.Length());
   prev_us = timestamp_us;
 }
 
@@ -1106,10 +1408,13 @@ static void update_scheduling_stats(SchedulingStats* stats, uint64_t now_us,
 }
 
 void btif_a2dp_source_debug_dump(int fd) {
-  btif_a2dp_source_accumulate_stats(&btif_a2dp_source_cb.stats,
-                                    &btif_a2dp_source_cb.accumulated_stats);
+  // Copy the published snapshot instead of touching the live counters; the
+  // slot only needs to stay stable for the duration of the copy, while the
+  // slow dprintf formatting below runs entirely on the local copy.
+  BtifMediaStats snapshot = btif_a2dp_source_stats_snapshot
+      [btif_a2dp_source_stats_snapshot_index.load(std::memory_order_acquire)];
   uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
-  BtifMediaStats* accumulated_stats = &btif_a2dp_source_cb.accumulated_stats;
+  BtifMediaStats* accumulated_stats = &snapshot;
   SchedulingStats* enqueue_stats = &accumulated_stats->tx_queue_enqueue_stats;
   SchedulingStats* dequeue_stats = &accumulated_stats->tx_queue_dequeue_stats;
   size_t ave_size;
@@ -1193,6 +1498,14 @@ void btif_a2dp_source_debug_dump(int fd) {
                     1000
               : 0);
 
+  dprintf(fd,
+          "  Low-latency mode                                        : %s\n",
+          btif_a2dp_source_cb.low_latency_mode ? "enabled" : "disabled");
+
+  dprintf(fd,
+          "  Link TX latency p95 in ms                               : %u\n",
+          accumulated_stats->link_tx_latency_p95_ms);
+
   //
   // TxQueue enqueue stats
   //
@@ -41,6 +41,7 @@
 #include "btif/include/btif_util.h"
 #include "btif_metrics_logging.h"
 #include "common/metrics.h"
+#include "common/slo_monitor.h"
 #include "common/state_machine.h"
 #include "hardware/bt_av.h"
 #include "include/hardware/bt_rc.h"
@@ -1875,6 +1876,8 @@ bool BtifAvStateMachine::StateOpened::ProcessEvent(uint32_t event,
                peer_.PeerAddress().ToString().c_str(),
                BtifAvEvent::EventName(event).c_str(),
                peer_.FlagsToString().c_str());
+      bluetooth::common::SloMonitor::GetInstance()->OperationBegin(
+          bluetooth::common::SloOperation::kA2dpStart, peer_.PeerAddress());
       BTA_AvStart(peer_.BtaHandle());
       peer_.SetFlags(BtifAvPeer::kFlagPendingStart);
       break;
@@ -1917,7 +1920,11 @@ bool BtifAvStateMachine::StateOpened::ProcessEvent(uint32_t event,
       }
 
       // Remain in Open state if status failed
-      if (p_av->start.status != BTA_AV_SUCCESS) return false;
+      if (p_av->start.status != BTA_AV_SUCCESS) {
+        bluetooth::common::SloMonitor::GetInstance()->OperationCancel(
+            bluetooth::common::SloOperation::kA2dpStart, peer_.PeerAddress());
+        return false;
+      }
 
       if (peer_.IsSource() && peer_.IsActivePeer()) {
         // Remove flush state, ready for streaming
@@ -2049,6 +2056,9 @@ void BtifAvStateMachine::StateStarted::OnEnter() {
   // We are again in started state, clear any remote suspend flags
   peer_.ClearFlags(BtifAvPeer::kFlagRemoteSuspend);
 
+  bluetooth::common::SloMonitor::GetInstance()->OperationEnd(
+      bluetooth::common::SloOperation::kA2dpStart, peer_.PeerAddress());
+
   btif_a2dp_sink_set_rx_flush(false);
 
   // Report that we have entered the Streaming stage. Usually, this should
@@ -2728,15 +2738,21 @@ static void bta_av_sink_media_callback(const RawAddress& peer_address,
 
   switch (event) {
     case BTA_AV_SINK_MEDIA_DATA_EVT: {
+      /* The media packet is loaned by AVDTP; either hand it to the sink
+       * RX queue or free it here. */
+      BT_HDR* p_pkt = (BT_HDR*)p_data;
+      bool enqueued = false;
       BtifAvPeer* peer = btif_av_sink_find_peer(peer_address);
       if (peer != nullptr && peer->IsActivePeer()) {
         int state = peer->StateMachine().StateId();
         if ((state == BtifAvStateMachine::kStateStarted) ||
             (state == BtifAvStateMachine::kStateOpened)) {
-          uint8_t queue_len = btif_a2dp_sink_enqueue_buf((BT_HDR*)p_data);
+          uint8_t queue_len = btif_a2dp_sink_enqueue_buf(p_pkt);
+          enqueued = true;
           BTIF_TRACE_DEBUG("%s: Packets in Sink queue %d", __func__, queue_len);
         }
       }
+      if (!enqueued) osi_free(p_pkt);
       break;
     }
     case BTA_AV_SINK_MEDIA_CFG_EVT: {
@@ -2837,6 +2853,19 @@ static void set_source_silence_peer_int(const RawAddress& peer_address,
   }
 }
 
+static void set_low_latency_mode_int(const RawAddress& peer_address,
+                                     bool enabled) {
+  BTIF_TRACE_EVENT("%s: peer_address=%s, enabled=%s", __func__,
+                   peer_address.ToString().c_str(),
+                   enabled ? "true" : "false");
+  if (peer_address != btif_av_source.ActivePeer()) {
+    BTIF_TRACE_WARNING("%s: Peer %s is not the active peer", __func__,
+                       peer_address.ToString().c_str());
+    return;
+  }
+  btif_a2dp_source_set_low_latency_mode(enabled);
+}
+
 // Set the active peer
 static void set_active_peer_int(uint8_t peer_sep,
                                 const RawAddress& peer_address,
@@ -2962,6 +2991,18 @@ static bt_status_t src_set_silence_sink(const RawAddress& peer_address,
                                                  peer_address, silence));
 }
 
+static bt_status_t src_set_low_latency_mode(const RawAddress& peer_address,
+                                            bool enabled) {
+  BTIF_TRACE_EVENT("%s: Peer %s", __func__, peer_address.ToString().c_str());
+  if (!btif_av_source.Enabled()) {
+    BTIF_TRACE_WARNING("%s: BTIF AV Source is not enabled", __func__);
+    return BT_STATUS_NOT_READY;
+  }
+
+  return do_in_main_thread(FROM_HERE, base::Bind(&set_low_latency_mode_int,
+                                                 peer_address, enabled));
+}
+
 static bt_status_t src_set_active_sink(const RawAddress& peer_address) {
   BTIF_TRACE_EVENT("%s: Peer %s", __func__, peer_address.ToString().c_str());
 
@@ -3035,6 +3076,7 @@ static const btav_source_interface_t bt_av_src_interface = {
     src_set_active_sink,
     codec_config_src,
     cleanup_src,
+    src_set_low_latency_mode,
 };
 
 static const btav_sink_interface_t bt_av_sink_interface = {
@@ -25,11 +25,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <mutex>
 #include <unordered_set>
 #include "device/include/controller.h"
 
 #include "btif_common.h"
 #include "btif_util.h"
+#include "common/time_util.h"
 #include "main/shim/le_scanning_manager.h"
 #include "main/shim/shim.h"
 
@@ -67,31 +69,108 @@ extern const btgatt_callbacks_t* bt_gatt_callbacks;
 
 namespace {
 
-// all access to this variable should be done on the jni thread
+// Dedup of scan results is two-tier; all access is done on the jni thread.
+// A small bloom filter screens each address first: once the nearby devices
+// have been seen, almost every report hits the filter and never touches the
+// exact set. Entries age out by generation rather than by count - the cache
+// keeps the current and the previous scan cycle, so a device quiet for two
+// cycles is reported again, independent of how busy the air is.
 std::set<RawAddress> remote_bdaddr_cache;
-std::queue<RawAddress> remote_bdaddr_cache_ordered;
+std::set<RawAddress> remote_bdaddr_cache_old;
 const size_t remote_bdaddr_cache_max_size = 1024;
+const uint64_t remote_bdaddr_cache_cycle_ms = 30 * 1000;
+uint64_t remote_bdaddr_cache_cycle_start_ms = 0;
+
+// 4096-bit filter, two probes per address; false positives only cost the
+// exact lookup that used to run unconditionally.
+uint64_t remote_bdaddr_bloom[64];
+
+uint32_t btif_address_bloom_hash(const RawAddress& p_bda) {
+  uint32_t hash = 5381;
+  for (int i = 0; i < 6; i++) hash = hash * 33 + p_bda.address[i];
+  return hash;
+}
+
+void btif_address_bloom_set(const RawAddress& p_bda) {
+  uint32_t hash = btif_address_bloom_hash(p_bda);
+  uint32_t bit1 = hash & 0xfff;
+  uint32_t bit2 = (hash >> 12) & 0xfff;
+  remote_bdaddr_bloom[bit1 >> 6] |= ((uint64_t)1 << (bit1 & 63));
+  remote_bdaddr_bloom[bit2 >> 6] |= ((uint64_t)1 << (bit2 & 63));
+}
+
+bool btif_address_bloom_test(const RawAddress& p_bda) {
+  uint32_t hash = btif_address_bloom_hash(p_bda);
+  uint32_t bit1 = hash & 0xfff;
+  uint32_t bit2 = (hash >> 12) & 0xfff;
+  return (remote_bdaddr_bloom[bit1 >> 6] & ((uint64_t)1 << (bit1 & 63))) &&
+         (remote_bdaddr_bloom[bit2 >> 6] & ((uint64_t)1 << (bit2 & 63)));
+}
+
+// Retire the current generation to |remote_bdaddr_cache_old| and rebuild the
+// bloom filter from the survivors, shedding bits set by entries that just
+// aged out completely.
+void btif_address_cache_rotate(uint64_t now_ms) {
+  remote_bdaddr_cache_old = std::move(remote_bdaddr_cache);
+  remote_bdaddr_cache.clear();
+  remote_bdaddr_cache_cycle_start_ms = now_ms;
+  memset(remote_bdaddr_bloom, 0, sizeof(remote_bdaddr_bloom));
+  for (const RawAddress& bda : remote_bdaddr_cache_old)
+    btif_address_bloom_set(bda);
+}
 
 void btif_address_cache_add(const RawAddress& p_bda, uint8_t addr_type) {
-  // Remove the oldest entries
-  while (remote_bdaddr_cache.size() >= remote_bdaddr_cache_max_size) {
-    const RawAddress& raw_address = remote_bdaddr_cache_ordered.front();
-    remote_bdaddr_cache.erase(raw_address);
-    remote_bdaddr_cache_ordered.pop();
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  if (now_ms - remote_bdaddr_cache_cycle_start_ms >=
+          remote_bdaddr_cache_cycle_ms ||
+      remote_bdaddr_cache.size() >= remote_bdaddr_cache_max_size) {
+    btif_address_cache_rotate(now_ms);
   }
+  btif_address_bloom_set(p_bda);
   remote_bdaddr_cache.insert(p_bda);
-  remote_bdaddr_cache_ordered.push(p_bda);
 }
 
 bool btif_address_cache_find(const RawAddress& p_bda) {
-  return (remote_bdaddr_cache.find(p_bda) != remote_bdaddr_cache.end());
+  if (!btif_address_bloom_test(p_bda)) return false;
+  return remote_bdaddr_cache.find(p_bda) != remote_bdaddr_cache.end() ||
+         remote_bdaddr_cache_old.find(p_bda) != remote_bdaddr_cache_old.end();
 }
 
 void btif_address_cache_init(void) {
   remote_bdaddr_cache.clear();
-  remote_bdaddr_cache_ordered = {};
+  remote_bdaddr_cache_old.clear();
+  memset(remote_bdaddr_bloom, 0, sizeof(remote_bdaddr_bloom));
+  remote_bdaddr_cache_cycle_start_ms =
+      bluetooth::common::time_get_os_boottime_ms();
 }
 
+// Scan reports are batched between the main thread and the JNI thread.
+// Posting one closure per advertising report makes the thread crossing
+// dominate during aggressive scans; instead reports are appended to
+// |pending_scan_reports| and a single drain task works through whatever
+// has accumulated by the time the JNI thread gets to run.
+struct scan_report_t {
+  RawAddress bd_addr;
+  tBT_DEVICE_TYPE device_type;
+  int8_t rssi;
+  tBLE_ADDR_TYPE ble_addr_type;
+  uint16_t ble_evt_type;
+  uint8_t ble_primary_phy;
+  uint8_t ble_secondary_phy;
+  uint8_t ble_advertising_sid;
+  int8_t ble_tx_power;
+  uint16_t ble_periodic_adv_int;
+  vector<uint8_t> value;
+  RawAddress original_bda;
+};
+
+std::mutex pending_scan_reports_mutex;
+std::vector<scan_report_t> pending_scan_reports;
+bool scan_report_drain_scheduled = false;
+// If the JNI thread falls this far behind, shed the oldest reports rather
+// than grow the batch without bound.
+const size_t max_pending_scan_reports = 128;
+
 void bta_batch_scan_threshold_cb(tBTM_BLE_REF_VALUE ref_value) {
   SCAN_CBACK_IN_JNI(batchscan_threshold_cb, ref_value);
 }
@@ -114,12 +193,13 @@ void bta_scan_results_cb_impl(RawAddress bd_addr, tBT_DEVICE_TYPE device_type,
   bt_device_type_t dev_type;
   bt_property_t properties;
 
-  const uint8_t* p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-      value, BTM_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
+  AdvertiseDataIndex value_index(value);
+  const uint8_t* p_eir_remote_name = value_index.GetFieldByType(
+      BTM_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
 
   if (p_eir_remote_name == NULL) {
-    p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-        value, BT_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
+    p_eir_remote_name = value_index.GetFieldByType(
+        BT_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
   }
 
   if ((addr_type != BLE_ADDR_RANDOM) || (p_eir_remote_name)) {
@@ -158,6 +238,62 @@ void bta_scan_results_cb_impl(RawAddress bd_addr, tBT_DEVICE_TYPE device_type,
             ble_tx_power, rssi, ble_periodic_adv_int, std::move(value), &original_bda);
 }
 
+// Runs on the JNI thread. Takes everything queued so far in one go; reports
+// that arrive while the batch is being processed schedule the next drain.
+void scan_report_drain() {
+  std::vector<scan_report_t> reports;
+  {
+    std::lock_guard<std::mutex> lock(pending_scan_reports_mutex);
+    reports.swap(pending_scan_reports);
+    scan_report_drain_scheduled = false;
+  }
+
+  for (scan_report_t& r : reports) {
+    bta_scan_results_cb_impl(r.bd_addr, r.device_type, r.rssi, r.ble_addr_type,
+                             r.ble_evt_type, r.ble_primary_phy,
+                             r.ble_secondary_phy, r.ble_advertising_sid,
+                             r.ble_tx_power, r.ble_periodic_adv_int,
+                             std::move(r.value), r.original_bda);
+  }
+}
+
+void scan_report_enqueue(scan_report_t report) {
+  bool schedule_drain = false;
+  {
+    std::lock_guard<std::mutex> lock(pending_scan_reports_mutex);
+
+    // At aggressive scan intervals the same frame is often seen again before
+    // the JNI thread has drained the previous copy. Coalesce repeats of the
+    // advertisement at the tail of the batch, keeping the newest RSSI.
+    if (!pending_scan_reports.empty()) {
+      scan_report_t& last = pending_scan_reports.back();
+      if (last.bd_addr == report.bd_addr &&
+          last.ble_evt_type == report.ble_evt_type &&
+          last.value == report.value) {
+        last.rssi = report.rssi;
+        return;
+      }
+    }
+
+    if (pending_scan_reports.size() >= max_pending_scan_reports) {
+      static size_t shed_scan_reports = 0;
+      if ((shed_scan_reports++ % 100) == 0) {
+        LOG_WARN("%s shed %zu scan reports - JNI thread is falling behind",
+                 __func__, shed_scan_reports);
+      }
+      pending_scan_reports.erase(pending_scan_reports.begin());
+    }
+
+    pending_scan_reports.push_back(std::move(report));
+    if (!scan_report_drain_scheduled) {
+      scan_report_drain_scheduled = true;
+      schedule_drain = true;
+    }
+  }
+
+  if (schedule_drain) do_in_jni_thread(Bind(&scan_report_drain));
+}
+
 void bta_scan_results_cb(tBTA_DM_SEARCH_EVT event, tBTA_DM_SEARCH* p_data) {
   uint8_t len;
 
@@ -184,11 +320,11 @@ void bta_scan_results_cb(tBTA_DM_SEARCH_EVT event, tBTA_DM_SEARCH* p_data) {
   }
 
   tBTA_DM_INQ_RES* r = &p_data->inq_res;
-  do_in_jni_thread(Bind(bta_scan_results_cb_impl, r->bd_addr, r->device_type,
-                        r->rssi, r->ble_addr_type, r->ble_evt_type,
-                        r->ble_primary_phy, r->ble_secondary_phy,
-                        r->ble_advertising_sid, r->ble_tx_power,
-                        r->ble_periodic_adv_int, std::move(value), r->original_bda));
+  scan_report_enqueue({r->bd_addr, r->device_type, r->rssi, r->ble_addr_type,
+                       r->ble_evt_type, r->ble_primary_phy,
+                       r->ble_secondary_phy, r->ble_advertising_sid,
+                       r->ble_tx_power, r->ble_periodic_adv_int,
+                       std::move(value), r->original_bda});
 }
 
 void bta_track_adv_event_cb(tBTM_BLE_TRACK_ADV_DATA* p_track_adv_data) {
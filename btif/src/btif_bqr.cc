@@ -22,11 +22,17 @@
 #endif
 #include <stdio.h>
 #include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 #include "btif_bqr.h"
 #include "btif_common.h"
 #include "btm_api.h"
+#include "common/circular_buffer.h"
 #include "common/leaky_bonded_queue.h"
+#include "common/spill_ring_file.h"
 #include "common/time_util.h"
 #include "osi/include/properties.h"
 
@@ -40,6 +46,172 @@ using std::chrono::system_clock;
 static std::unique_ptr<LeakyBondedQueue<BqrVseSubEvt>> kpBqrEventQueue(
     new LeakyBondedQueue<BqrVseSubEvt>(kBqrEventQueueSize));
 
+// Ring file that preserves the link quality events leaked off the event
+// queue, so incident investigation still has hours of history after the
+// in-memory queue rolled over.
+static std::unique_ptr<bluetooth::common::SpillRingFile> kpBqrSpillRing;
+
+// Compact little-endian serialization of a link quality event for the
+// spill ring; counters are the controller's running totals.
+static size_t SerializeLinkQualityEvent(const BqrVseSubEvt& event,
+                                        uint8_t* buf, size_t buf_len) {
+  const BqrLinkQualityEvent& lq = event.bqr_link_quality_event_;
+  uint8_t* p = buf;
+
+  if (buf_len < 48) return 0;
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  UINT32_TO_STREAM(p, (uint32_t)(now_ms & 0xffffffff));
+  UINT32_TO_STREAM(p, (uint32_t)(now_ms >> 32));
+  UINT8_TO_STREAM(p, lq.quality_report_id);
+  UINT8_TO_STREAM(p, lq.packet_types);
+  UINT16_TO_STREAM(p, lq.connection_handle);
+  UINT8_TO_STREAM(p, lq.connection_role);
+  INT8_TO_STREAM(p, lq.tx_power_level);
+  INT8_TO_STREAM(p, lq.rssi);
+  UINT8_TO_STREAM(p, lq.snr);
+  UINT8_TO_STREAM(p, lq.unused_afh_channel_count);
+  UINT8_TO_STREAM(p, lq.afh_select_unideal_channel_count);
+  UINT16_TO_STREAM(p, lq.lsto);
+  UINT32_TO_STREAM(p, lq.connection_piconet_clock);
+  UINT32_TO_STREAM(p, lq.retransmission_count);
+  UINT32_TO_STREAM(p, lq.no_rx_count);
+  UINT32_TO_STREAM(p, lq.nak_count);
+  UINT32_TO_STREAM(p, lq.flow_off_count);
+  UINT32_TO_STREAM(p, lq.buffer_overflow_bytes);
+  UINT32_TO_STREAM(p, lq.buffer_underflow_bytes);
+  return p - buf;
+}
+
+// When the controller last reported a degraded link; read from the A2DP
+// media task, written from the HCI event path.
+static std::atomic<uint64_t> last_degraded_timestamp_ms(0);
+
+// One entry of the per-link sliding window.
+typedef struct {
+  // RSSI reported by the event, in dBm.
+  int8_t rssi;
+  // Increments of the controller's running counters relative to the previous
+  // event on this link.
+  uint32_t retransmissions;
+  uint32_t no_rx;
+  uint32_t nak;
+} LinkQualitySample;
+
+// Sliding window of one link plus the running totals of the previous event,
+// needed to turn the controller's accumulated counters into per-event
+// increments.
+struct LinkQualityLinkStats {
+  LinkQualityLinkStats() : window(kLinkQualityWindowSize) {}
+  common::CircularBuffer<LinkQualitySample> window;
+  uint32_t prev_retransmission_count = 0;
+  uint32_t prev_no_rx_count = 0;
+  uint32_t prev_nak_count = 0;
+  uint64_t last_update_ms = 0;
+  uint8_t last_score = kMaxLinkQualityScore;
+};
+
+// Per-link sliding windows, keyed by connection handle. Written from the HCI
+// event path and queried from e.g. the A2DP media task, hence the mutex.
+static std::mutex link_stats_mutex;
+static std::unordered_map<uint16_t, std::unique_ptr<LinkQualityLinkStats>>
+    link_stats_map;
+static LinkQualityThresholdCb link_quality_threshold_cb = nullptr;
+static uint8_t link_quality_threshold = 0;
+
+// Derive the per-event increment of an accumulated controller counter. The
+// counters restart from zero when the controller resets them, e.g. on
+// reconnection with a reused handle.
+static uint32_t CounterIncrement(uint32_t current, uint32_t previous) {
+  return (current >= previous) ? (current - previous) : current;
+}
+
+static uint8_t ComputeLinkQualityScore(const LinkQualityLinkStats& stats) {
+  std::vector<LinkQualitySample> samples = stats.window.Pull();
+  if (samples.empty()) return kMaxLinkQualityScore;
+
+  int32_t rssi_sum = 0;
+  uint64_t error_sum = 0;
+  for (const LinkQualitySample& sample : samples) {
+    rssi_sum += sample.rssi;
+    error_sum += sample.retransmissions + sample.no_rx + sample.nak;
+  }
+  int32_t avg_rssi = rssi_sum / static_cast<int32_t>(samples.size());
+  uint32_t errors_per_event = static_cast<uint32_t>(
+      std::min<uint64_t>(error_sum / samples.size(), UINT32_MAX));
+
+  // Half of the score is carried by signal strength, the other half by the
+  // retransmission/no-RX/NAK pressure on the link.
+  uint32_t rssi_penalty = 0;
+  if (avg_rssi < kLinkQualityRssiGood) {
+    rssi_penalty = std::min<uint32_t>(
+        (kLinkQualityRssiGood - avg_rssi) * (kMaxLinkQualityScore / 2) /
+            (kLinkQualityRssiGood - kLinkQualityRssiBad),
+        kMaxLinkQualityScore / 2);
+  }
+  uint32_t error_penalty =
+      std::min<uint32_t>(errors_per_event * (kMaxLinkQualityScore / 2) /
+                             kLinkQualityErrorsPerEventWorst,
+                         kMaxLinkQualityScore / 2);
+  return static_cast<uint8_t>(kMaxLinkQualityScore - rssi_penalty -
+                              error_penalty);
+}
+
+// Fold one parsed link quality event into the sliding window of its link and
+// re-score the link.
+static void UpdateLinkQualityStats(const BqrLinkQualityEvent& event) {
+  LinkQualityThresholdCb threshold_cb = nullptr;
+  uint8_t score;
+  {
+    std::lock_guard<std::mutex> lock(link_stats_mutex);
+    auto it = link_stats_map.find(event.connection_handle);
+    if (it == link_stats_map.end()) {
+      if (link_stats_map.size() >= kMaxTrackedLinks) {
+        auto oldest = link_stats_map.begin();
+        for (auto candidate = link_stats_map.begin();
+             candidate != link_stats_map.end(); ++candidate) {
+          if (candidate->second->last_update_ms <
+              oldest->second->last_update_ms) {
+            oldest = candidate;
+          }
+        }
+        link_stats_map.erase(oldest);
+      }
+      it = link_stats_map
+               .emplace(event.connection_handle,
+                        std::make_unique<LinkQualityLinkStats>())
+               .first;
+    }
+
+    LinkQualityLinkStats& stats = *it->second;
+    LinkQualitySample sample = {};
+    sample.rssi = event.rssi;
+    sample.retransmissions = CounterIncrement(event.retransmission_count,
+                                              stats.prev_retransmission_count);
+    sample.no_rx = CounterIncrement(event.no_rx_count, stats.prev_no_rx_count);
+    sample.nak = CounterIncrement(event.nak_count, stats.prev_nak_count);
+    stats.window.Push(sample);
+    stats.prev_retransmission_count = event.retransmission_count;
+    stats.prev_no_rx_count = event.no_rx_count;
+    stats.prev_nak_count = event.nak_count;
+    stats.last_update_ms = bluetooth::common::time_get_os_boottime_ms();
+
+    score = ComputeLinkQualityScore(stats);
+    if (score < link_quality_threshold &&
+        stats.last_score >= link_quality_threshold) {
+      threshold_cb = link_quality_threshold_cb;
+    }
+    stats.last_score = score;
+  }
+
+  if (score < kLinkQualityScoreWarnThreshold) {
+    // A consistently poor window marks the link as degraded for the A2DP
+    // adaptive bit rate logic, like the single-event criteria do.
+    last_degraded_timestamp_ms = bluetooth::common::time_get_os_boottime_ms();
+  }
+  // Invoked outside the lock so the callback may query the score APIs.
+  if (threshold_cb != nullptr) threshold_cb(event.connection_handle, score);
+}
+
 void BqrVseSubEvt::ParseBqrLinkQualityEvt(uint8_t length,
                                           uint8_t* p_param_buf) {
   if (length < kLinkQualityParamTotalLen) {
@@ -248,6 +420,15 @@ void EnableBtQualityReport(bool is_enable) {
         static_cast<uint32_t>(atoi(bqr_prop_evtmask));
     bqr_config.minimum_report_interval_ms =
         static_cast<uint16_t>(atoi(bqr_prop_interval_ms));
+
+    if (kpBqrSpillRing == nullptr) {
+      kpBqrSpillRing = std::make_unique<bluetooth::common::SpillRingFile>(
+          kpBqrSpillRingPath, kBqrSpillRingSize, kBqrSpillMaxRecordsPerSec);
+      if (kpBqrSpillRing->Open()) {
+        kpBqrEventQueue->SetSpill(kpBqrSpillRing.get(),
+                                  SerializeLinkQualityEvent);
+      }
+    }
   } else {
     bqr_config.report_action = REPORT_ACTION_CLEAR;
     bqr_config.quality_event_mask = kQualityEventMaskAllOff;
@@ -387,6 +568,14 @@ void AddLinkQualityEventToQueue(uint8_t length, uint8_t* p_link_quality_event) {
   std::unique_ptr<BqrVseSubEvt> p_bqr_event = std::make_unique<BqrVseSubEvt>();
   p_bqr_event->ParseBqrLinkQualityEvt(length, p_link_quality_event);
 
+  UpdateLinkQualityStats(p_bqr_event->bqr_link_quality_event_);
+
+  if (p_bqr_event->bqr_link_quality_event_.quality_report_id ==
+          QUALITY_REPORT_ID_A2DP_AUDIO_CHOPPY ||
+      p_bqr_event->bqr_link_quality_event_.rssi < kCriWarnRssi) {
+    last_degraded_timestamp_ms = bluetooth::common::time_get_os_boottime_ms();
+  }
+
   LOG(WARNING) << *p_bqr_event;
   invoke_link_quality_report_cb(
       bluetooth::common::time_get_os_boottime_ms(),
@@ -500,7 +689,26 @@ int OpenBtSchedulingTraceLogFile() {
 }
 
 void DebugDump(int fd) {
+  {
+    std::lock_guard<std::mutex> lock(link_stats_mutex);
+    if (!link_stats_map.empty()) {
+      dprintf(fd, "\nBT Link Quality Scores: \n");
+      for (const auto& entry : link_stats_map) {
+        dprintf(fd, "  Handle 0x%04x: %d\n", entry.first,
+                entry.second->last_score);
+      }
+    }
+  }
+
   dprintf(fd, "\nBT Quality Report Events: \n");
+  dprintf(fd, "  Dropped from queue: %llu\n",
+          (unsigned long long)kpBqrEventQueue->DroppedCount());
+  if (kpBqrSpillRing != nullptr) {
+    dprintf(fd, "  Spilled to %s: %llu (rate limited: %llu)\n",
+            kpBqrSpillRingPath,
+            (unsigned long long)kpBqrSpillRing->RecordsWritten(),
+            (unsigned long long)kpBqrSpillRing->RecordsRateLimited());
+  }
 
   if (kpBqrEventQueue->Empty()) {
     dprintf(fd, "Event queue is empty.\n");
@@ -524,5 +732,60 @@ void DebugDump(int fd) {
   dprintf(fd, "\n");
 }
 
+bool LinkQualityIsDegraded() {
+  uint64_t last_degraded_ms = last_degraded_timestamp_ms;
+  if (last_degraded_ms == 0) return false;
+  return bluetooth::common::time_get_os_boottime_ms() - last_degraded_ms <=
+         kLinkQualityDegradedWindowMs;
+}
+
+uint8_t GetLinkQualityScore(uint16_t connection_handle) {
+  std::lock_guard<std::mutex> lock(link_stats_mutex);
+  auto it = link_stats_map.find(connection_handle);
+  if (it == link_stats_map.end()) return kMaxLinkQualityScore;
+  if (bluetooth::common::time_get_os_boottime_ms() -
+          it->second->last_update_ms >
+      kLinkQualityStatsStaleMs) {
+    return kMaxLinkQualityScore;
+  }
+  return it->second->last_score;
+}
+
+bool GetLinkQualityWindowStats(uint16_t connection_handle,
+                               LinkQualityWindowStats* p_stats) {
+  CHECK(p_stats != nullptr);
+  std::lock_guard<std::mutex> lock(link_stats_mutex);
+  auto it = link_stats_map.find(connection_handle);
+  if (it == link_stats_map.end()) return false;
+  if (bluetooth::common::time_get_os_boottime_ms() -
+          it->second->last_update_ms >
+      kLinkQualityStatsStaleMs) {
+    return false;
+  }
+
+  std::vector<LinkQualitySample> samples = it->second->window.Pull();
+  if (samples.empty()) return false;
+
+  *p_stats = {};
+  int32_t rssi_sum = 0;
+  for (const LinkQualitySample& sample : samples) {
+    rssi_sum += sample.rssi;
+    p_stats->retransmission_count += sample.retransmissions;
+    p_stats->no_rx_count += sample.no_rx;
+    p_stats->nak_count += sample.nak;
+  }
+  p_stats->sample_count = samples.size();
+  p_stats->avg_rssi =
+      static_cast<int8_t>(rssi_sum / static_cast<int32_t>(samples.size()));
+  return true;
+}
+
+void RegisterLinkQualityThresholdCallback(LinkQualityThresholdCb cb,
+                                          uint8_t score_threshold) {
+  std::lock_guard<std::mutex> lock(link_stats_mutex);
+  link_quality_threshold_cb = cb;
+  link_quality_threshold = score_threshold;
+}
+
 }  // namespace bqr
 }  // namespace bluetooth
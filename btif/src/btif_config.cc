@@ -22,8 +22,10 @@
 
 #include <base/logging.h>
 #include <openssl/rand.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <cctype>
 #include <cstdio>
 #include <cstring>
@@ -33,6 +35,7 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "btcore/include/module.h"
 #include "btif_api.h"
@@ -52,6 +55,7 @@
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
 #include "osi/include/properties.h"
+#include "osi/include/thread.h"
 #include "raw_address.h"
 
 #define BT_CONFIG_SOURCE_TAG_NUM 1010001
@@ -76,20 +80,32 @@ using bluetooth::common::MetricIdAllocator;
 #if defined(OS_GENERIC)
 static const char* CONFIG_FILE_PATH = "bt_config.conf";
 static const char* CONFIG_BACKUP_PATH = "bt_config.bak";
+static const char* CONFIG_JOURNAL_PATH = "bt_config.jrnl";
+static const char* CONFIG_SNAPSHOT_PATH = "bt_config.snapshot";
 static const char* CONFIG_LEGACY_FILE_PATH = "bt_config.xml";
 #else   // !defined(OS_GENERIC)
 static const char* CONFIG_FILE_PATH = "/data/misc/bluedroid/bt_config.conf";
 static const char* CONFIG_BACKUP_PATH = "/data/misc/bluedroid/bt_config.bak";
+static const char* CONFIG_JOURNAL_PATH = "/data/misc/bluedroid/bt_config.jrnl";
+static const char* CONFIG_SNAPSHOT_PATH =
+    "/data/misc/bluedroid/bt_config.snapshot";
 static const char* CONFIG_LEGACY_FILE_PATH =
     "/data/misc/bluedroid/bt_config.xml";
 #endif  // defined(OS_GENERIC)
 static const uint64_t CONFIG_SETTLE_PERIOD_MS = 3000;
+// journal size that triggers compaction into the main config file
+static const size_t CONFIG_JOURNAL_COMPACT_SIZE = 32 * 1024;
 
 static void timer_config_save_cb(void* data);
 static void btif_config_write(uint16_t event, char* p_param);
+static void btif_config_journal_replay(config_t* config);
+static bool btif_config_journal_append(
+    const std::unordered_set<std::string>& sections, bool durable);
 static bool is_factory_reset(void);
 static void delete_config_files(void);
 static std::unique_ptr<config_t> btif_config_open(const char* filename);
+static std::unique_ptr<config_t> btif_config_open_snapshot(void);
+static uint64_t btif_config_text_tag(void);
 
 // Key attestation
 static bool config_checksum_pass(int check_bit) {
@@ -123,6 +139,8 @@ static BluetoothKeystoreInterface* get_bluetooth_keystore_interface() {
   return bluetooth::bluetooth_keystore::getBluetoothKeystoreInterface();
 }
 
+static void btif_config_warm_encrypted_keys(void);
+
 // TODO(zachoverflow): Move these two functions out, because they are too
 // specific for this file
 // {grumpy-cat/no, monty-python/you-make-me-sad}
@@ -243,9 +261,59 @@ static void init_metric_id_allocator() {
 static std::recursive_mutex config_lock;  // protects operations on |config|.
 static alarm_t* config_timer;
 
+// Dedicated writer thread: all disk writes are funneled through it so
+// neither the timer callback nor the btif context blocks on flash I/O, and
+// queued writes retire in submission order.
+static thread_t* config_writer_thread;
+
+// True when a pending write carries bond-critical material (link keys);
+// only those writes are worth the cost of an fsync. Bulk property updates
+// ride the page cache.
+static std::atomic<bool> config_bond_critical_dirty{false};
+
+// Writer queue metrics, surfaced through btif_debug_config_dump.
+static std::atomic<uint32_t> config_write_queue_depth{0};
+static std::atomic<uint32_t> config_write_queue_max{0};
+static std::atomic<uint32_t> config_saves_coalesced{0};
+static std::atomic<uint32_t> config_fsync_count{0};
+
 // limited btif config cache capacity
 static BtifConfigCache btif_config_cache(TEMPORARY_SECTION_CAPACITY);
 
+// Warms the keystore decrypt cache off the hot path. Every encrypted value
+// otherwise costs a synchronous keymaster round trip the first time it is
+// read, which lands in the middle of stack bring-up or the first
+// reconnection to each bonded device. The prefixes are collected under the
+// config lock, then decrypted one by one on the jni thread so the keystore
+// work overlaps the rest of startup and later reads hit the in-process
+// cache.
+static void btif_config_warm_encrypted_keys(void) {
+  if (!is_common_criteria_mode()) return;
+
+  std::vector<std::string> prefixes;
+  {
+    std::unique_lock<std::recursive_mutex> lock(config_lock);
+    for (const auto& section : btif_config_cache.GetPersistentSectionNames()) {
+      for (int i = 0; i < ENCRYPT_KEY_NAME_LIST_SIZE; ++i) {
+        auto value =
+            btif_config_cache.GetString(section, encrypt_key_name_list[i]);
+        if (value && *value == ENCRYPTED_STR)
+          prefixes.push_back(section + "-" + encrypt_key_name_list[i]);
+      }
+    }
+  }
+  if (prefixes.empty()) return;
+
+  do_in_jni_thread(FROM_HERE,
+                   base::BindOnce(
+                       [](std::vector<std::string> prefixes) {
+                         for (const auto& prefix : prefixes) {
+                           get_bluetooth_keystore_interface()->get_key(prefix);
+                         }
+                       },
+                       std::move(prefixes)));
+}
+
 // Module lifecycle functions
 
 static future_t* init(void) {
@@ -264,7 +332,8 @@ static future_t* init(void) {
   std::string file_source;
 
   if (config_checksum_pass(CONFIG_FILE_COMPARE_PASS)) {
-    config = btif_config_open(CONFIG_FILE_PATH);
+    config = btif_config_open_snapshot();
+    if (!config) config = btif_config_open(CONFIG_FILE_PATH);
     btif_config_source = ORIGINAL;
   }
   if (!config) {
@@ -291,6 +360,9 @@ static future_t* init(void) {
     file_source = "Empty";
   }
 
+  // apply section deltas journaled since the file was last fully written
+  btif_config_journal_replay(config.get());
+
   // move persistent config data from btif_config file to btif config cache
   btif_config_cache.Init(std::move(config));
 
@@ -303,6 +375,9 @@ static future_t* init(void) {
     btif_config_cache.RemovePersistentSectionsWithKey("Restricted");
   }
 
+  // Start decrypting the protected values in the background
+  btif_config_warm_encrypted_keys();
+
   // Read or set config file creation timestamp
   auto time_str = btif_config_cache.GetString(INFO_SECTION, FILE_TIMESTAMP);
   if (!time_str) {
@@ -331,15 +406,23 @@ static future_t* init(void) {
     goto error;
   }
 
+  config_writer_thread = thread_new("bt_config_writer");
+  if (!config_writer_thread) {
+    LOG_ERROR("%s unable to create writer thread.", __func__);
+    goto error;
+  }
+
   LOG_EVENT_INT(BT_CONFIG_SOURCE_TAG_NUM, btif_config_source);
 
   return future_new_immediate(FUTURE_SUCCESS);
 
 error:
   alarm_free(config_timer);
+  thread_free(config_writer_thread);
   config.reset();
   btif_config_cache.Clear();
   config_timer = NULL;
+  config_writer_thread = NULL;
   btif_config_source = NOT_LOADED;
   return future_new_immediate(FUTURE_FAIL);
 }
@@ -356,6 +439,42 @@ static std::unique_ptr<config_t> btif_config_open(const char* filename) {
   return config;
 }
 
+/*******************************************************************************
+ *
+ * Function         btif_config_text_tag
+ *
+ * Description      Identify the current generation of the text config file
+ *                  so a snapshot written alongside it is rejected once
+ *                  anything else rewrites the file (downgrade to an image
+ *                  without snapshot support, restored backup, manual edit).
+ *
+ * Returns          A tag derived from the file's size and mtime, 0 if the
+ *                  file cannot be stat'ed.
+ *
+ ******************************************************************************/
+static uint64_t btif_config_text_tag(void) {
+  struct stat st;
+  if (stat(CONFIG_FILE_PATH, &st) != 0) return 0;
+  return (static_cast<uint64_t>(st.st_mtime) << 24) ^
+         static_cast<uint64_t>(st.st_size);
+}
+
+static std::unique_ptr<config_t> btif_config_open_snapshot(void) {
+  uint64_t tag = btif_config_text_tag();
+  if (tag == 0) return nullptr;
+
+  std::unique_ptr<config_t> config =
+      config_load_snapshot(CONFIG_SNAPSHOT_PATH, tag);
+  if (!config) return nullptr;
+
+  if (!config_has_section(*config, "Adapter")) {
+    LOG_ERROR("Snapshot is missing adapter section");
+    return nullptr;
+  }
+
+  return config;
+}
+
 static future_t* shut_down(void) {
   btif_config_flush();
   return future_new_immediate(FUTURE_SUCCESS);
@@ -371,6 +490,11 @@ static future_t* clean_up(void) {
   }
   btif_config_flush();
 
+  // Joins the writer; any queued work retires before the cache is cleared
+  // and before the timer it checks for goes away
+  thread_free(config_writer_thread);
+  config_writer_thread = NULL;
+
   alarm_free(config_timer);
   config_timer = NULL;
 
@@ -497,6 +621,7 @@ bool btif_config_set_str(const std::string& section, const std::string& key,
   }
   std::unique_lock<std::recursive_mutex> lock(config_lock);
   btif_config_cache.SetString(section, key, value);
+  if (btif_in_encrypt_key_name_list(key)) config_bond_critical_dirty = true;
   return true;
 }
 
@@ -621,11 +746,23 @@ bool btif_config_set_bin(const std::string& section, const std::string& key,
     std::unique_lock<std::recursive_mutex> lock(config_lock);
     btif_config_cache.SetString(section, key, value_str);
   }
+  if (btif_in_encrypt_key_name_list(key)) config_bond_critical_dirty = true;
 
   osi_free(str);
   return true;
 }
 
+std::optional<section_t> btif_config_get_section(const std::string& section) {
+  if (bluetooth::shim::is_any_gd_enabled()) {
+    CHECK(bluetooth::shim::is_gd_stack_started_up());
+    /* No bulk section access through the shim - callers fall back to the
+     * keyed getters. */
+    return std::nullopt;
+  }
+  std::unique_lock<std::recursive_mutex> lock(config_lock);
+  return btif_config_cache.PersistentSectionCopy(section);
+}
+
 std::vector<RawAddress> btif_config_get_paired_devices() {
   std::vector<std::string> names;
   if (bluetooth::shim::is_any_gd_enabled()) {
@@ -656,6 +793,7 @@ bool btif_config_remove(const std::string& section, const std::string& key) {
     get_bluetooth_keystore_interface()->set_encrypt_key_or_remove_key(
         section + "-" + key, "");
   }
+  if (btif_in_encrypt_key_name_list(key)) config_bond_critical_dirty = true;
   std::unique_lock<std::recursive_mutex> lock(config_lock);
   return btif_config_cache.RemoveKey(section, key);
 }
@@ -668,6 +806,7 @@ void btif_config_save(void) {
   }
   CHECK(config_timer != NULL);
 
+  if (alarm_is_scheduled(config_timer)) config_saves_coalesced++;
   alarm_set(config_timer, CONFIG_SETTLE_PERIOD_MS, timer_config_save_cb, NULL);
 }
 
@@ -699,25 +838,182 @@ bool btif_config_clear(void) {
   btif_config_cache.Clear();
   bool ret =
       config_save(btif_config_cache.PersistentSectionCopy(), CONFIG_FILE_PATH);
+  remove(CONFIG_JOURNAL_PATH);
+  remove(CONFIG_SNAPSHOT_PATH);
   btif_config_source = RESET;
 
   return ret;
 }
 
+static void config_writer_work(UNUSED_ATTR void* context) {
+  btif_config_write(0, NULL);
+  config_write_queue_depth--;
+}
+
 static void timer_config_save_cb(UNUSED_ATTR void* data) {
-  // Moving file I/O to btif context instead of timer callback because
-  // it usually takes a lot of time to be completed, introducing
-  // delays during A2DP playback causing blips or choppiness.
+  // Moving file I/O to the dedicated writer thread instead of the timer
+  // callback because it usually takes a lot of time to be completed,
+  // introducing delays during A2DP playback causing blips or choppiness.
+  uint32_t depth = ++config_write_queue_depth;
+  uint32_t max = config_write_queue_max.load();
+  while (depth > max &&
+         !config_write_queue_max.compare_exchange_weak(max, depth)) {
+  }
+
+  if (config_writer_thread != NULL &&
+      thread_post(config_writer_thread, config_writer_work, NULL)) {
+    return;
+  }
+
+  // No writer thread (e.g. shutdown race): fall back to the btif context
+  config_write_queue_depth--;
   btif_transfer_context(btif_config_write, 0, NULL, 0, NULL);
 }
 
+static size_t btif_config_journal_size(void) {
+  struct stat st;
+  if (stat(CONFIG_JOURNAL_PATH, &st) != 0) return 0;
+  return st.st_size;
+}
+
+/*******************************************************************************
+ *
+ * Function         btif_config_journal_replay
+ *
+ * Description      Apply the section deltas journaled since |config| was
+ *                  last written in full. Each journal record carries the
+ *                  complete state of one section, so replay simply replaces
+ *                  (or removes) that section. A torn record at the end of
+ *                  the journal - e.g. after a power cut - is ignored.
+ *
+ ******************************************************************************/
+static void btif_config_journal_replay(config_t* config) {
+  FILE* fp = fopen(CONFIG_JOURNAL_PATH, "rt");
+  if (!fp) return;
+
+  LOG_INFO("%s replaying config journal: %s", __func__, CONFIG_JOURNAL_PATH);
+
+  char line[1024];
+  std::string section;
+  std::vector<std::pair<std::string, std::string>> entries;
+  bool in_record = false;
+
+  while (fgets(line, sizeof(line), fp)) {
+    size_t len = strlen(line);
+    // an unterminated line is a torn tail; nothing after it is trustworthy
+    if (len == 0 || line[len - 1] != '\n') break;
+    line[len - 1] = '\0';
+
+    if (strncmp(line, "@DEL ", 5) == 0) {
+      config_remove_section(config, line + 5);
+    } else if (strncmp(line, "@SET ", 5) == 0) {
+      section = line + 5;
+      entries.clear();
+      in_record = true;
+    } else if (strcmp(line, "@END") == 0) {
+      if (in_record) {
+        config_remove_section(config, section);
+        for (const auto& entry : entries)
+          config_set_string(config, section, entry.first, entry.second);
+        in_record = false;
+      }
+    } else if (in_record) {
+      char* split = strstr(line, " = ");
+      if (split) {
+        *split = '\0';
+        entries.emplace_back(line, split + 3);
+      }
+    }
+  }
+
+  fclose(fp);
+}
+
+/*******************************************************************************
+ *
+ * Function         btif_config_journal_append
+ *
+ * Description      Append the current state of the given sections to the
+ *                  config journal, avoiding a rewrite of the whole config
+ *                  file. Sections that are no longer persistent become
+ *                  removal records.
+ *
+ * Returns          true if all records hit the disk, false otherwise (the
+ *                  caller should fall back to a full save). |durable| asks
+ *                  for an fsync; it is reserved for bond-critical records,
+ *                  bulk property updates just ride the page cache.
+ *
+ ******************************************************************************/
+static bool btif_config_journal_append(
+    const std::unordered_set<std::string>& sections, bool durable) {
+  FILE* fp = fopen(CONFIG_JOURNAL_PATH, "at");
+  if (!fp) {
+    LOG_ERROR("%s unable to open config journal: %s", __func__,
+              strerror(errno));
+    return false;
+  }
+
+  std::stringstream serialized;
+  for (const std::string& section_name : sections) {
+    auto section = btif_config_cache.PersistentSectionCopy(section_name);
+    if (section) {
+      serialized << "@SET " << section_name << std::endl;
+      for (const entry_t& entry : section->entries)
+        serialized << entry.key << " = " << entry.value << std::endl;
+      serialized << "@END" << std::endl;
+    } else {
+      serialized << "@DEL " << section_name << std::endl;
+    }
+  }
+
+  bool success = fprintf(fp, "%s", serialized.str().c_str()) >= 0;
+  success = success && fflush(fp) == 0;
+  if (success && durable) {
+    if (fsync(fileno(fp)) < 0) {
+      LOG_WARN("%s unable to fsync config journal: %s", __func__,
+               strerror(errno));
+    } else {
+      config_fsync_count++;
+    }
+  }
+
+  fclose(fp);
+  return success;
+}
+
 static void btif_config_write(UNUSED_ATTR uint16_t event,
                               UNUSED_ATTR char* p_param) {
   CHECK(config_timer != NULL);
 
   std::unique_lock<std::recursive_mutex> lock(config_lock);
+
+  // Journal section-level deltas when possible; they are much cheaper than
+  // rewriting every bonded device. Common criteria mode pins a hash of the
+  // whole file in the keystore, so it always takes the full rewrite path.
+  bool full_rewrite = btif_config_cache.NeedsFullRewrite() ||
+                      is_common_criteria_mode() ||
+                      btif_config_journal_size() > CONFIG_JOURNAL_COMPACT_SIZE;
+  auto dirty_sections = btif_config_cache.TakeDirtySections();
+  bool bond_critical = config_bond_critical_dirty.exchange(false);
+
+  if (!full_rewrite) {
+    if (dirty_sections.empty()) return;
+    if (btif_config_journal_append(dirty_sections, bond_critical)) return;
+    LOG_WARN("%s journal append failed; falling back to full save", __func__);
+  }
+
+  // Compaction: write the full state to the main file, then retire the
+  // journal. A crash in between only leaves stale-but-idempotent records.
   rename(CONFIG_FILE_PATH, CONFIG_BACKUP_PATH);
-  config_save(btif_config_cache.PersistentSectionCopy(), CONFIG_FILE_PATH);
+  config_t persistent = btif_config_cache.PersistentSectionCopy();
+  config_save(persistent, CONFIG_FILE_PATH);
+  remove(CONFIG_JOURNAL_PATH);
+
+  // Regenerate the snapshot against the file just written so the next boot
+  // skips the text parse; if tagging fails the snapshot is simply not
+  // refreshed and the next boot parses the text file.
+  uint64_t tag = btif_config_text_tag();
+  if (tag != 0) config_save_snapshot(persistent, CONFIG_SNAPSHOT_PATH, tag);
   if (is_common_criteria_mode()) {
     get_bluetooth_keystore_interface()->set_encrypt_key_or_remove_key(
         CONFIG_FILE_PREFIX, CONFIG_FILE_HASH);
@@ -764,6 +1060,11 @@ void btif_debug_config_dump(int fd) {
   dprintf(fd, "  Devices loaded: %zu\n", devices.size());
   dprintf(fd, "  File created/tagged: %s\n", btif_config_time_created);
   dprintf(fd, "  File source: %s\n", file_source->c_str());
+  dprintf(fd, "  Writer queue depth/max: %u / %u\n",
+          config_write_queue_depth.load(), config_write_queue_max.load());
+  dprintf(fd, "  Saves coalesced by settle timer: %u\n",
+          config_saves_coalesced.load());
+  dprintf(fd, "  Bond-critical fsyncs: %u\n", config_fsync_count.load());
 }
 
 static bool is_factory_reset(void) {
@@ -775,5 +1076,7 @@ static bool is_factory_reset(void) {
 static void delete_config_files(void) {
   remove(CONFIG_FILE_PATH);
   remove(CONFIG_BACKUP_PATH);
+  remove(CONFIG_JOURNAL_PATH);
+  remove(CONFIG_SNAPSHOT_PATH);
   osi_property_set("persist.bluetooth.factoryreset", "false");
 }
@@ -66,12 +66,17 @@ BtifConfigCache::~BtifConfigCache() { Clear(); }
 void BtifConfigCache::Clear() {
   unpaired_devices_cache_.Clear();
   paired_devices_list_.sections.clear();
+  // a wiped cache can't be expressed as section deltas
+  dirty_sections_.clear();
+  needs_full_rewrite_ = true;
 }
 
 void BtifConfigCache::Init(std::unique_ptr<config_t> source) {
   // get the config persistent data from btif_config file
   paired_devices_list_ = std::move(*source);
   source.reset();
+  dirty_sections_.clear();
+  needs_full_rewrite_ = false;
 }
 
 bool BtifConfigCache::HasPersistentSection(const std::string& section_name) {
@@ -105,6 +110,7 @@ void BtifConfigCache::RemovePersistentSectionsWithKey(const std::string& key) {
   for (auto it = paired_devices_list_.sections.begin();
        it != paired_devices_list_.sections.end();) {
     if (it->Has(key)) {
+      MarkDirty(it->name);
       it = paired_devices_list_.sections.erase(it);
       continue;
     }
@@ -135,6 +141,7 @@ bool BtifConfigCache::RemoveKey(const std::string& section_name,
     if (entry_iter == section_iter->entries.end()) {
       return false;
     }
+    MarkDirty(section_name);
     section_iter->entries.erase(entry_iter);
     if (section_iter->entries.empty()) {
       paired_devices_list_.sections.erase(section_iter);
@@ -163,6 +170,30 @@ config_t BtifConfigCache::PersistentSectionCopy() {
   return paired_devices_list_;
 }
 
+/* clone a single persistent section; std::nullopt when the section is not
+ * persistent (anymore) */
+std::optional<section_t> BtifConfigCache::PersistentSectionCopy(
+    const std::string& section_name) {
+  auto section_iter = paired_devices_list_.Find(section_name);
+  if (section_iter == paired_devices_list_.sections.end()) {
+    return std::nullopt;
+  }
+  return *section_iter;
+}
+
+bool BtifConfigCache::NeedsFullRewrite() const { return needs_full_rewrite_; }
+
+std::unordered_set<std::string> BtifConfigCache::TakeDirtySections() {
+  std::unordered_set<std::string> result;
+  result.swap(dirty_sections_);
+  needs_full_rewrite_ = false;
+  return result;
+}
+
+void BtifConfigCache::MarkDirty(const std::string& section_name) {
+  dirty_sections_.insert(section_name);
+}
+
 void BtifConfigCache::SetString(std::string section_name, std::string key,
                                 std::string value) {
   if (trim_new_line(section_name) || trim_new_line(key) ||
@@ -198,6 +229,7 @@ void BtifConfigCache::SetString(std::string section_name, std::string key,
       // when a unpaired section got the LinkKey, move this section to the
       // paired devices list
       paired_devices_list_.sections.emplace_back(std::move(section));
+      MarkDirty(section_name);
     } else {
       // update to the unpaired devices cache
       unpaired_devices_cache_.Put(section_name, section);
@@ -210,6 +242,7 @@ void BtifConfigCache::SetString(std::string section_name, std::string key,
       return;
     }
     section_found->Set(key, value);
+    MarkDirty(section_name);
   }
 }
 
@@ -167,6 +167,16 @@ bt_status_t do_in_jni_thread(base::OnceClosure task) {
   return do_in_jni_thread(FROM_HERE, std::move(task));
 }
 
+bt_status_t do_in_jni_thread_delayed(const base::Location& from_here,
+                                     base::OnceClosure task,
+                                     const base::TimeDelta& delay) {
+  if (!jni_thread.DoInThreadDelayed(from_here, std::move(task), delay)) {
+    LOG(ERROR) << __func__ << ": Post task to task runner failed!";
+    return BT_STATUS_FAIL;
+  }
+  return BT_STATUS_SUCCESS;
+}
+
 bool is_on_jni_thread() {
   return jni_thread.GetThreadId() == PlatformThread::CurrentId();
 }
@@ -295,11 +305,12 @@ void btif_enable_bluetooth_evt() {
 
   btif_dm_init(uid_set);
 
-  /* init rfcomm & l2cap api */
-  btif_sock_init(uid_set);
+  /* init rfcomm & l2cap api, unless the product allowlist rules the
+   * profile out entirely */
+  if (btif_is_profile_allowed(BT_PROFILE_SOCKETS_ID)) btif_sock_init(uid_set);
 
   /* init pan */
-  btif_pan_init();
+  if (btif_is_profile_allowed(BT_PROFILE_PAN_ID)) btif_pan_init();
 
   /* load did configuration */
   bte_load_did_conf(BTE_DID_CONF_FILE);
@@ -39,6 +39,7 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <list>
 #include <mutex>
 
 #include <bluetooth/uuid.h>
@@ -65,6 +66,7 @@
 #include "btif_util.h"
 #include "btu.h"
 #include "common/metrics.h"
+#include "common/slo_monitor.h"
 #include "device/include/controller.h"
 #include "device/include/interop.h"
 #include "internal_include/stack_config.h"
@@ -203,8 +205,21 @@ static size_t btif_events_end_index = 0;
  *****************************************************************************/
 static btif_dm_pairing_cb_t pairing_cb;
 static btif_dm_oob_cb_t oob_cb;
+
+/* Bonds requested while |pairing_cb| is still busy with another device.
+ * Bonding runs through a single pairing context shared with BTA and BTM, so
+ * only one bond can make progress at a time; queueing the rest lets a burst
+ * of create_bond requests (e.g. provisioning several accessories) run back
+ * to back instead of clobbering the context of the bond in flight. */
+typedef struct {
+  RawAddress bd_addr;
+  tBT_TRANSPORT transport;
+} btif_dm_pending_bond_t;
+static std::list<btif_dm_pending_bond_t> pending_bonds;
+
 static void btif_dm_cb_create_bond(const RawAddress bd_addr,
                                    tBT_TRANSPORT transport);
+static void btif_dm_start_next_bond();
 static void btif_update_remote_properties(const RawAddress& bd_addr,
                                           BD_NAME bd_name, DEV_CLASS dev_class,
                                           tBT_DEVICE_TYPE dev_type);
@@ -315,12 +330,12 @@ static bool check_eir_remote_name(tBTA_DM_SEARCH* p_search_data,
 
   /* Check EIR for remote name and services */
   if (p_search_data->inq_res.p_eir) {
-    p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-        p_search_data->inq_res.p_eir, p_search_data->inq_res.eir_len,
+    AdvertiseDataIndex eir_index(p_search_data->inq_res.p_eir,
+                                 p_search_data->inq_res.eir_len);
+    p_eir_remote_name = eir_index.GetFieldByType(
         BTM_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
     if (!p_eir_remote_name) {
-      p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-          p_search_data->inq_res.p_eir, p_search_data->inq_res.eir_len,
+      p_eir_remote_name = eir_index.GetFieldByType(
           BTM_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
     }
 
@@ -450,6 +465,17 @@ static void bond_state_changed(bt_status_t status, const RawAddress& bd_addr,
       " prev_state=%d, sdp_attempts = %d",
       state, pairing_cb.state, pairing_cb.sdp_attempts);
 
+  if (state == BT_BOND_STATE_BONDING) {
+    bluetooth::common::SloMonitor::GetInstance()->OperationBegin(
+        bluetooth::common::SloOperation::kPairing, bd_addr);
+  } else if (state == BT_BOND_STATE_BONDED) {
+    bluetooth::common::SloMonitor::GetInstance()->OperationEnd(
+        bluetooth::common::SloOperation::kPairing, bd_addr);
+  } else {
+    bluetooth::common::SloMonitor::GetInstance()->OperationCancel(
+        bluetooth::common::SloOperation::kPairing, bd_addr);
+  }
+
   if (state == BT_BOND_STATE_NONE) {
     forget_device_from_metric_id_allocator(bd_addr);
   } else if (state == BT_BOND_STATE_BONDED) {
@@ -473,6 +499,11 @@ static void bond_state_changed(bt_status_t status, const RawAddress& bd_addr,
     pairing_cb.bd_addr = bd_addr;
   } else {
     pairing_cb = {};
+    if (!pending_bonds.empty()) {
+      /* Kick off the next queued bond once the current event handler is done
+       * with the (now cleared) pairing context. */
+      do_in_jni_thread(base::BindOnce(btif_dm_start_next_bond));
+    }
   }
 }
 
@@ -644,6 +675,34 @@ static void btif_dm_cb_create_bond(const RawAddress bd_addr,
   pairing_cb.is_local_initiated = true;
 }
 
+/*******************************************************************************
+ *
+ * Function         btif_dm_start_next_bond
+ *
+ * Description      Starts the next queued bond, if any, now that the shared
+ *                  pairing context has been released
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void btif_dm_start_next_bond() {
+  if (pending_bonds.empty()) return;
+  if (is_bonding_or_sdp()) {
+    /* Another bond grabbed the pairing context first; it will drain the
+     * queue when it completes. */
+    return;
+  }
+
+  btif_dm_pending_bond_t next = pending_bonds.front();
+  pending_bonds.pop_front();
+
+  LOG_INFO("Starting queued bond to %s, %zu still pending",
+           PRIVATE_ADDRESS(next.bd_addr), pending_bonds.size());
+
+  pairing_cb.timeout_retries = NUM_TIMEOUT_RETRIES;
+  btif_dm_cb_create_bond(next.bd_addr, next.transport);
+}
+
 /*******************************************************************************
  *
  * Function         btif_dm_get_connection_state
@@ -1900,6 +1959,19 @@ void btif_dm_create_bond(const RawAddress bd_addr, int transport) {
   btif_stats_add_bond_event(bd_addr, BTIF_DM_FUNC_CREATE_BOND,
                             pairing_cb.state);
 
+  if (is_bonding_or_sdp() && bd_addr != pairing_cb.bd_addr) {
+    /* Another bond owns the pairing context; queue this one and start it as
+     * soon as the bond in flight completes. */
+    for (const btif_dm_pending_bond_t& pending : pending_bonds) {
+      if (pending.bd_addr == bd_addr) return;
+    }
+    LOG_INFO("Bond to %s in progress, queueing bond to %s",
+             PRIVATE_ADDRESS(pairing_cb.bd_addr), PRIVATE_ADDRESS(bd_addr));
+    pending_bonds.push_back(
+        {bd_addr, static_cast<tBT_TRANSPORT>(transport)});
+    return;
+  }
+
   pairing_cb.timeout_retries = NUM_TIMEOUT_RETRIES;
   btif_dm_cb_create_bond(bd_addr, transport);
 }
@@ -2017,6 +2089,16 @@ void btif_dm_cancel_bond(const RawAddress bd_addr) {
   btif_stats_add_bond_event(bd_addr, BTIF_DM_FUNC_CANCEL_BOND,
                             pairing_cb.state);
 
+  for (auto it = pending_bonds.begin(); it != pending_bonds.end(); ++it) {
+    if (it->bd_addr == bd_addr) {
+      /* The bond never started; just drop it from the queue. */
+      pending_bonds.erase(it);
+      invoke_bond_state_changed_cb(BT_STATUS_SUCCESS, bd_addr,
+                                   BT_BOND_STATE_NONE);
+      return;
+    }
+  }
+
   /* TODO:
   **  1. Restore scan modes
   **  2. special handling for HID devices
@@ -2074,6 +2156,10 @@ void btif_dm_remove_bond(const RawAddress bd_addr) {
   btif_stats_add_bond_event(bd_addr, BTIF_DM_FUNC_REMOVE_BOND,
                             pairing_cb.state);
 
+  pending_bonds.remove_if([&bd_addr](const btif_dm_pending_bond_t& pending) {
+    return pending.bd_addr == bd_addr;
+  });
+
   // special handling for HID devices
   // VUP needs to be sent if its a HID Device. The HID HOST module will check if
   // there is a valid hid connection with this bd_addr. If yes VUP will be
@@ -2681,7 +2767,9 @@ static void btif_dm_ble_auth_cmpl_evt(tBTA_DM_AUTH_CMPL* p_auth_cmpl) {
         break;
 
       case BTA_DM_AUTH_SMP_CONN_TOUT: {
-        if (btm_sec_is_a_bonded_dev(bd_addr)) {
+        /* running in btif context; query the published bond snapshot
+         * instead of reaching into the live stack records */
+        if (btm_sec_is_a_bonded_dev_snapshot(bd_addr)) {
           LOG(INFO) << __func__ << " Bonded device addr=" << bd_addr
                     << " timed out - will not remove the keys";
           // Don't send state change to upper layers - otherwise Java think we
@@ -3028,6 +3116,9 @@ void btif_ble_receiver_test(uint8_t rx_freq) {
 void btif_ble_test_end() { BTM_BleTestEnd(btif_dm_ble_test_end_cback); }
 
 void btif_dm_on_disable() {
+  /* drop bonds still waiting for the pairing context */
+  pending_bonds.clear();
+
   /* cancel any pending pairing requests */
   if (is_bonding_or_sdp()) {
     BTIF_TRACE_DEBUG("%s: Cancel pending pairing request", __func__);
@@ -33,7 +33,9 @@
 #include <hardware/bluetooth.h>
 #include <hardware/bt_gatt.h>
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "bta_api.h"
 #include "bta_gatt_api.h"
@@ -89,6 +91,37 @@ namespace {
 
 uint8_t rssi_request_client_if;
 
+/* Opt-in per-connection notification batching. All of this state is only
+ * touched on the JNI thread, where every GATT upcall is delivered. */
+constexpr int kNotifyBatchWindowMaxMs = 5;
+
+struct notify_batch_t {
+  int window_ms = 0;
+  bool flush_scheduled = false;
+  std::vector<btgatt_notify_params_t> pending;
+};
+
+std::map<int, notify_batch_t> notify_batchers;  // keyed by conn_id
+
+static void btif_gattc_flush_notify_batch(int conn_id) {
+  auto batcher = notify_batchers.find(conn_id);
+  if (batcher == notify_batchers.end()) return;
+  batcher->second.flush_scheduled = false;
+  if (batcher->second.pending.empty()) return;
+
+  std::vector<btgatt_notify_params_t> batch;
+  batch.swap(batcher->second.pending);
+  if (bt_gatt_callbacks && bt_gatt_callbacks->client->notify_batch_cb) {
+    HAL_CBACK(bt_gatt_callbacks, client->notify_batch_cb, conn_id,
+              batch.data(), (int)batch.size());
+  } else {
+    /* No batch upcall registered; deliver individually, in order. */
+    for (const auto& params : batch) {
+      HAL_CBACK(bt_gatt_callbacks, client->notify_cb, conn_id, params);
+    }
+  }
+}
+
 std::string bta_gattc_event_text(const tBTA_GATTC_EVT& event) {
   switch (event) {
     case BTA_GATTC_DEREG_EVT:
@@ -155,6 +188,24 @@ static void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
       data.is_notify = p_data->notify.is_notify;
       data.len = p_data->notify.len;
 
+      auto batcher = notify_batchers.find(p_data->notify.conn_id);
+      if (p_data->notify.is_notify && batcher != notify_batchers.end()) {
+        batcher->second.pending.push_back(data);
+        if (!batcher->second.flush_scheduled) {
+          batcher->second.flush_scheduled = true;
+          do_in_jni_thread_delayed(
+              FROM_HERE,
+              Bind(&btif_gattc_flush_notify_batch, p_data->notify.conn_id),
+              base::TimeDelta::FromMilliseconds(batcher->second.window_ms));
+        }
+        break;
+      }
+
+      /* Indications are acknowledged and latency sensitive; flush any batched
+       * notifications first so ordering is preserved. */
+      if (!p_data->notify.is_notify)
+        btif_gattc_flush_notify_batch(p_data->notify.conn_id);
+
       HAL_CBACK(bt_gatt_callbacks, client->notify_cb, p_data->notify.conn_id,
                 data);
 
@@ -182,6 +233,8 @@ static void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
     }
 
     case BTA_GATTC_CLOSE_EVT: {
+      btif_gattc_flush_notify_batch(p_data->close.conn_id);
+      notify_batchers.erase(p_data->close.conn_id);
       HAL_CBACK(bt_gatt_callbacks, client->close_cb, p_data->close.conn_id,
                 p_data->close.status, p_data->close.client_if,
                 p_data->close.remote_bda);
@@ -635,6 +688,24 @@ static bt_status_t btif_gattc_test_command(int command,
   return btif_gattc_test_command_impl(command, &params);
 }
 
+static void btif_gattc_set_notification_batching_impl(int conn_id,
+                                                      int window_ms) {
+  if (window_ms <= 0) {
+    btif_gattc_flush_notify_batch(conn_id);
+    notify_batchers.erase(conn_id);
+    return;
+  }
+  if (window_ms > kNotifyBatchWindowMaxMs) window_ms = kNotifyBatchWindowMaxMs;
+  notify_batchers[conn_id].window_ms = window_ms;
+}
+
+static bt_status_t btif_gattc_set_notification_batching(int conn_id,
+                                                        int window_ms) {
+  CHECK_BTGATT_INIT();
+  return do_in_jni_thread(Bind(&btif_gattc_set_notification_batching_impl,
+                               conn_id, window_ms));
+}
+
 }  // namespace
 
 const btgatt_client_interface_t btgattClientInterface = {
@@ -660,4 +731,5 @@ const btgatt_client_interface_t btgattClientInterface = {
     btif_gattc_set_preferred_phy,
     btif_gattc_read_phy,
     btif_gattc_test_command,
-    btif_gattc_get_gatt_db};
+    btif_gattc_get_gatt_db,
+    btif_gattc_set_notification_batching};
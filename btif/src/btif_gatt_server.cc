@@ -47,6 +47,7 @@
 #include "btif_gatt_util.h"
 #include "btif_storage.h"
 #include "osi/include/log.h"
+#include "osi/include/pool_allocator.h"
 #include "stack/include/btu.h"
 #include "types/bt_transport.h"
 
@@ -89,16 +90,37 @@ static void btapp_gatts_copy_req_data(uint16_t event, char* p_dest,
   // Copy basic structure first
   maybe_non_aligned_memcpy(p_dest_data, p_src_data, sizeof(*p_src_data));
 
-  // Allocate buffer for request data if necessary
+  // Allocate buffer for request data if necessary. The snapshots come from
+  // the size-class pools and the write events only copy the populated prefix
+  // of the attribute value, so a long write streaming prepared segments does
+  // not pay a full tGATTS_DATA malloc and copy per segment.
   switch (event) {
+    case BTA_GATTS_WRITE_CHARACTERISTIC_EVT:
+    case BTA_GATTS_WRITE_DESCRIPTOR_EVT: {
+      const tGATT_WRITE_REQ* p_src_req =
+          &p_src_data->req_data.p_data->write_req;
+      tGATTS_DATA* p_req =
+          (tGATTS_DATA*)allocator_pool.alloc(sizeof(tGATTS_DATA));
+      tGATT_WRITE_REQ* p_dest_req = &p_req->write_req;
+
+      p_dest_req->handle = p_src_req->handle;
+      p_dest_req->offset = p_src_req->offset;
+      p_dest_req->len = p_src_req->len;
+      p_dest_req->need_rsp = p_src_req->need_rsp;
+      p_dest_req->is_prep = p_src_req->is_prep;
+      p_dest_req->gatt_type = p_src_req->gatt_type;
+      memcpy(p_dest_req->value, p_src_req->value, p_src_req->len);
+
+      p_dest_data->req_data.p_data = p_req;
+      break;
+    }
+
     case BTA_GATTS_READ_CHARACTERISTIC_EVT:
     case BTA_GATTS_READ_DESCRIPTOR_EVT:
-    case BTA_GATTS_WRITE_CHARACTERISTIC_EVT:
-    case BTA_GATTS_WRITE_DESCRIPTOR_EVT:
     case BTA_GATTS_EXEC_WRITE_EVT:
     case BTA_GATTS_MTU_EVT:
       p_dest_data->req_data.p_data =
-          (tGATTS_DATA*)osi_malloc(sizeof(tGATTS_DATA));
+          (tGATTS_DATA*)allocator_pool.alloc(sizeof(tGATTS_DATA));
       memcpy(p_dest_data->req_data.p_data, p_src_data->req_data.p_data,
              sizeof(tGATTS_DATA));
       break;
@@ -116,7 +138,10 @@ static void btapp_gatts_free_req_data(uint16_t event, tBTA_GATTS* p_data) {
     case BTA_GATTS_WRITE_DESCRIPTOR_EVT:
     case BTA_GATTS_EXEC_WRITE_EVT:
     case BTA_GATTS_MTU_EVT:
-      if (p_data != NULL) osi_free_and_reset((void**)&p_data->req_data.p_data);
+      if (p_data != NULL && p_data->req_data.p_data != NULL) {
+        allocator_pool.free(p_data->req_data.p_data);
+        p_data->req_data.p_data = NULL;
+      }
       break;
 
     default:
@@ -35,7 +35,7 @@
 #include <linux/if_tun.h>
 #include <net/if.h>
 #include <sys/ioctl.h>
-#include <sys/poll.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "bt_target.h"  // Must be first to define build configuration
@@ -399,17 +399,22 @@ int btpan_tap_send(int tap_fd, const RawAddress& src, const RawAddress& dst,
     eth_hdr.h_dest = dst;
     eth_hdr.h_src = src;
     eth_hdr.h_proto = htons(proto);
-    char packet[TAP_MAX_PKT_WRITE_LEN + sizeof(tETH_HDR)];
-    memcpy(packet, &eth_hdr, sizeof(tETH_HDR));
     if (len > TAP_MAX_PKT_WRITE_LEN) {
       LOG_ERROR("btpan_tap_send eth packet size:%d is exceeded limit!", len);
       return -1;
     }
-    memcpy(packet + sizeof(tETH_HDR), buf, len);
 
-    /* Send data to network interface */
+    /* Hand the Ethernet header and the payload to the network interface
+     * in one vectored write instead of assembling the frame in a bounce
+     * buffer first. */
+    struct iovec iov[2];
+    iov[0].iov_base = &eth_hdr;
+    iov[0].iov_len = sizeof(tETH_HDR);
+    iov[1].iov_base = const_cast<char*>(buf);
+    iov[1].iov_len = len;
+
     ssize_t ret;
-    OSI_NO_INTR(ret = write(tap_fd, packet, len + sizeof(tETH_HDR)));
+    OSI_NO_INTR(ret = writev(tap_fd, iov, 2));
     BTIF_TRACE_DEBUG("ret:%d", ret);
     return (int)ret;
   }
@@ -646,10 +651,7 @@ static void bta_pan_callback(tBTA_PAN_EVT event, tBTA_PAN* p_data) {
                         sizeof(tBTA_PAN), NULL);
 }
 
-#define IS_EXCEPTION(e) ((e) & (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL))
 static void btu_exec_tap_fd_read(int fd) {
-  struct pollfd ufd;
-
   if (fd == INVALID_FD || fd != btpan_cb.tap_fd) return;
 
   // Don't occupy BTU context too long, avoid buffer overruns and
@@ -673,10 +675,14 @@ static void btu_exec_tap_fd_read(int fd) {
                              sizeof(btpan_cb.congest_packet)));
       switch (ret) {
         case -1:
-          BTIF_TRACE_ERROR("%s unable to read from driver: %s", __func__,
-                           strerror(errno));
+          if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            BTIF_TRACE_ERROR("%s unable to read from driver: %s", __func__,
+                             strerror(errno));
+          }
+          // The TAP fd is non-blocking, so EAGAIN just means the driver
+          // queue is drained; either way hand the fd back to the monitor
+          // thread and wait for the next readable notification.
           osi_free(buffer);
-          // add fd back to monitor thread to try it again later
           btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
           return;
         case 0:
@@ -715,14 +721,8 @@ static void btu_exec_tap_fd_read(int fd) {
       osi_free(buffer);
     }
 
-    // Bail out of the loop if reading from the TAP fd would block.
-    ufd.fd = fd;
-    ufd.events = POLLIN;
-    ufd.revents = 0;
-
-    int ret;
-    OSI_NO_INTR(ret = poll(&ufd, 1, 0));
-    if (ret <= 0 || IS_EXCEPTION(ufd.revents)) break;
+    // Keep draining until the non-blocking read above returns EAGAIN or
+    // the batch limit is reached; no need for a poll() syscall per frame.
   }
 
   if (btpan_cb.flow) {
@@ -49,6 +49,7 @@
 #include "osi/include/list.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "common/time_util.h"
 #include "osi/include/properties.h"
 #include "stack/include/avrc_api.h"
 
@@ -181,6 +182,16 @@ typedef struct {
   rc_transaction_t transaction[MAX_TRANSACTIONS_PER_SESSION];
 } rc_transaction_set_t;
 
+/* Sliding-window throttle for controller notification upcalls; see
+ * btif_rc_ctrl_pos_notif_allowed and btif_rc_ctrl_status_notif_allowed */
+typedef struct {
+  uint32_t last_play_pos;
+  uint64_t last_pos_forwarded_ms;
+  uint8_t last_play_status;
+  uint64_t last_status_forwarded_ms;
+  uint32_t suppressed_count;
+} btif_rc_notif_throttle_t;
+
 /* TODO : Merge btif_rc_reg_notifications_t and btif_rc_cmd_ctxt_t to a single
  * struct */
 typedef struct {
@@ -203,6 +214,7 @@ typedef struct {
   uint64_t rc_playing_uid;
   bool rc_procedure_complete;
   rc_transaction_set_t transaction_set;
+  btif_rc_notif_throttle_t rc_notif_throttle;
 } btif_rc_device_cb_t;
 
 typedef struct {
@@ -349,6 +361,13 @@ static void btif_rc_upstreams_rsp_evt(uint16_t event,
 
 static bool absolute_volume_disabled(void);
 
+static bool try_get_element_attr_from_cache(btrc_media_attr_t* p_attr_ids,
+                                            uint8_t num_attr,
+                                            btif_rc_device_cb_t* p_dev);
+static bt_status_t get_element_attr_rsp(const RawAddress& bd_addr,
+                                        uint8_t num_attr,
+                                        btrc_element_attr_val_t* p_attrs);
+
 /*****************************************************************************
  *  Static variables
  *****************************************************************************/
@@ -376,6 +395,18 @@ static const uint32_t media_attr_list_no_cover_art[] = {
 static const uint8_t media_attr_list_no_cover_art_size =
     sizeof(media_attr_list_no_cover_art)/sizeof(uint32_t);
 
+/* Cache of the current track's element attributes, filled from the most
+ * recent get_element_attr_rsp() and invalidated when the application
+ * reports a track change. Car kits poll GET_ELEMENT_ATTRIBUTES every
+ * second; serving repeat polls from here avoids waking the application
+ * for every request. */
+typedef struct {
+  bool valid;
+  uint8_t num_attrs;
+  btrc_element_attr_val_t attrs[BTRC_MAX_ELEM_ATTR_SIZE];
+} btif_rc_element_attr_cache_t;
+static btif_rc_element_attr_cache_t element_attr_cache;
+
 /*****************************************************************************
  *  Static functions
  *****************************************************************************/
@@ -425,6 +456,7 @@ void initialize_device(btif_rc_device_cb_t* p_dev) {
   p_dev->rc_features_processed = false;
   p_dev->rc_playing_uid = 0;
   p_dev->rc_procedure_complete = false;
+  memset(&p_dev->rc_notif_throttle, 0, sizeof(btif_rc_notif_throttle_t));
 
   // Leaving the value of the default constructor for the lbllock mutex is fine
   // but we still need to clear out the transaction label set
@@ -1526,6 +1558,10 @@ static void btif_rc_upstreams_evt(uint16_t event, tAVRC_COMMAND* pavrc_cmd,
         return;
       }
       fill_pdu_queue(IDX_GET_ELEMENT_ATTR_RSP, ctype, label, true, p_dev);
+      if (try_get_element_attr_from_cache(element_attrs, num_attr, p_dev)) {
+        /* Served from the current track cache, no application round trip */
+        break;
+      }
       HAL_CBACK(bt_rc_callbacks, get_element_attr_cb, num_attr, element_attrs,
                 p_dev->rc_addr);
     } break;
@@ -1878,6 +1914,47 @@ static bt_status_t get_play_status_rsp(const RawAddress& bd_addr,
   return BT_STATUS_SUCCESS;
 }
 
+/***************************************************************************
+ *
+ * Function         try_get_element_attr_from_cache
+ *
+ * Description      Answers a GET_ELEMENT_ATTRIBUTES request from the
+ *                      current track cache when every requested attribute
+ *                      is cached. Only done while this device has an
+ *                      interim track change notification outstanding, so
+ *                      the CHANGED response for a new track is guaranteed
+ *                      to invalidate the cache first.
+ *
+ * Returns          true if the response was sent from the cache
+ *
+ **************************************************************************/
+static bool try_get_element_attr_from_cache(btrc_media_attr_t* p_attr_ids,
+                                            uint8_t num_attr,
+                                            btif_rc_device_cb_t* p_dev) {
+  btrc_element_attr_val_t attrs[BTRC_MAX_ELEM_ATTR_SIZE];
+
+  if (!element_attr_cache.valid) return false;
+
+  if (!p_dev->rc_notif[BTRC_EVT_TRACK_CHANGE - 1].bNotify) return false;
+
+  for (int i = 0; i < num_attr; i++) {
+    bool found = false;
+    for (int j = 0; j < element_attr_cache.num_attrs; j++) {
+      if (element_attr_cache.attrs[j].attr_id == (uint32_t)p_attr_ids[i]) {
+        attrs[i] = element_attr_cache.attrs[j];
+        found = true;
+        break;
+      }
+    }
+    if (!found) return false;
+  }
+
+  BTIF_TRACE_DEBUG("%s: serving %d attributes from current track cache",
+                   __func__, num_attr);
+  get_element_attr_rsp(p_dev->rc_addr, num_attr, attrs);
+  return true;
+}
+
 /***************************************************************************
  *
  * Function         get_element_attr_rsp
@@ -1923,6 +2000,13 @@ static bt_status_t get_element_attr_rsp(const RawAddress& bd_addr,
           element_attrs[i].name.p_str);
     }
     avrc_rsp.get_play_status.status = AVRC_STS_NO_ERROR;
+
+    /* Remember the response so repeat polls for the same track can be
+     * answered without another application round trip */
+    element_attr_cache.num_attrs = num_attr;
+    memcpy(element_attr_cache.attrs, p_attrs,
+           num_attr * sizeof(btrc_element_attr_val_t));
+    element_attr_cache.valid = true;
   }
   avrc_rsp.get_attrs.num_attrs = num_attr;
   avrc_rsp.get_attrs.p_attrs = element_attrs;
@@ -1955,6 +2039,12 @@ static bt_status_t register_notification_rsp(
                    dump_rc_notification_event_id(event_id));
   std::unique_lock<std::mutex> lock(btif_rc_cb.lock);
 
+  if (event_id == BTRC_EVT_TRACK_CHANGE &&
+      type == BTRC_NOTIFICATION_TYPE_CHANGED) {
+    /* New track: the cached element attributes no longer apply */
+    element_attr_cache.valid = false;
+  }
+
   memset(&(avrc_rsp.reg_notif), 0, sizeof(tAVRC_REG_NOTIF_RSP));
 
   avrc_rsp.reg_notif.event_id = event_id;
@@ -3213,6 +3303,93 @@ bool rc_is_track_id_valid(tAVRC_UID uid) {
   }
 }
 
+/***************************************************************************
+ *
+ * Function         pos_notif_min_interval_ms
+ *
+ * Description      Minimum interval between play position upcalls forwarded
+ *                  per device. 0 disables the throttle.
+ *
+ * Returns          Interval in milliseconds
+ *
+ **************************************************************************/
+static uint32_t pos_notif_min_interval_ms(void) {
+  static int32_t interval_ms = -1;
+  if (interval_ms < 0) {
+    interval_ms = osi_property_get_int32(
+        "bluetooth.avrcp.ctrl.pos_update_min_interval_ms", 2000);
+  }
+  return (uint32_t)interval_ms;
+}
+
+/***************************************************************************
+ *
+ * Function         btif_rc_ctrl_pos_notif_allowed
+ *
+ * Description      Sliding-window duplicate suppression for play position
+ *                  upcalls: drop a position the app has already seen, and
+ *                  enforce a per-device minimum interval between forwarded
+ *                  positions. Peers sending 1Hz updates otherwise multiply
+ *                  JNI traffic per connected remote. A track change resets
+ *                  the window so the first position of a new track always
+ *                  goes through.
+ *
+ * Returns          true if the upcall should be forwarded
+ *
+ **************************************************************************/
+static bool btif_rc_ctrl_pos_notif_allowed(btif_rc_device_cb_t* p_dev,
+                                           uint32_t song_pos) {
+  btif_rc_notif_throttle_t* p_throttle = &p_dev->rc_notif_throttle;
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+
+  if (p_throttle->last_pos_forwarded_ms != 0 &&
+      pos_notif_min_interval_ms() != 0 &&
+      (song_pos == p_throttle->last_play_pos ||
+       now_ms - p_throttle->last_pos_forwarded_ms <
+           pos_notif_min_interval_ms())) {
+    p_throttle->suppressed_count++;
+    BTIF_TRACE_DEBUG("%s: suppressed pos %u for %s (total %u)", __func__,
+                     song_pos, p_dev->rc_addr.ToString().c_str(),
+                     p_throttle->suppressed_count);
+    return false;
+  }
+
+  p_throttle->last_play_pos = song_pos;
+  p_throttle->last_pos_forwarded_ms = now_ms;
+  return true;
+}
+
+/***************************************************************************
+ *
+ * Function         btif_rc_ctrl_status_notif_allowed
+ *
+ * Description      Suppress a play status upcall when the status did not
+ *                  change since the last forwarded one within the throttle
+ *                  window. The periodic play status poll otherwise reports
+ *                  an unchanged "playing" every cycle. Actual status
+ *                  changes always go through.
+ *
+ * Returns          true if the upcall should be forwarded
+ *
+ **************************************************************************/
+static bool btif_rc_ctrl_status_notif_allowed(btif_rc_device_cb_t* p_dev,
+                                              uint8_t play_status) {
+  btif_rc_notif_throttle_t* p_throttle = &p_dev->rc_notif_throttle;
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+
+  if (p_throttle->last_status_forwarded_ms != 0 &&
+      play_status == p_throttle->last_play_status &&
+      now_ms - p_throttle->last_status_forwarded_ms <
+          pos_notif_min_interval_ms()) {
+    p_throttle->suppressed_count++;
+    return false;
+  }
+
+  p_throttle->last_play_status = play_status;
+  p_throttle->last_status_forwarded_ms = now_ms;
+  return true;
+}
+
 /***************************************************************************
  *
  * Function         handle_notification_response
@@ -3266,6 +3443,9 @@ static void handle_notification_response(tBTA_AV_META_MSG* pmeta_msg,
         } else {
           uint8_t* p_data = p_rsp->param.track;
           BE_STREAM_TO_UINT64(p_dev->rc_playing_uid, p_data);
+          /* new track: the first updates bypass the notification throttle */
+          memset(&p_dev->rc_notif_throttle, 0,
+                 sizeof(btif_rc_notif_throttle_t));
           get_play_status_cmd(p_dev);
           get_metadata_attribute_cmd(attr_list_size, attr_list,
                                     p_dev);
@@ -3298,8 +3478,12 @@ static void handle_notification_response(tBTA_AV_META_MSG* pmeta_msg,
         break;
 
       case AVRC_EVT_PLAY_POS_CHANGED:
-        do_in_jni_thread(FROM_HERE, base::Bind(bt_rc_ctrl_callbacks->play_position_changed_cb, p_dev->rc_addr, 0,
-                                               p_rsp->param.play_pos));
+        if (btif_rc_ctrl_pos_notif_allowed(p_dev, p_rsp->param.play_pos)) {
+          do_in_jni_thread(
+              FROM_HERE,
+              base::Bind(bt_rc_ctrl_callbacks->play_position_changed_cb,
+                         p_dev->rc_addr, 0, p_rsp->param.play_pos));
+        }
 
         break;
       case AVRC_EVT_UIDS_CHANGE:
@@ -3380,6 +3564,9 @@ static void handle_notification_response(tBTA_AV_META_MSG* pmeta_msg,
         if (rc_is_track_id_valid(p_rsp->param.track) != true) {
           break;
         }
+        /* new track: the first updates bypass the notification throttle */
+        memset(&p_dev->rc_notif_throttle, 0,
+               sizeof(btif_rc_notif_throttle_t));
         get_metadata_attribute_cmd(attr_list_size, attr_list, p_dev);
         break;
 
@@ -3919,14 +4106,18 @@ static void handle_get_playstatus_response(tBTA_AV_META_MSG* pmeta_msg,
 
 
   if (p_rsp->status == AVRC_STS_NO_ERROR) {
-    do_in_jni_thread(
-        FROM_HERE,
-        base::Bind(bt_rc_ctrl_callbacks->play_status_changed_cb, p_dev->rc_addr,
-                   (btrc_play_status_t)p_rsp->play_status));
-    do_in_jni_thread(
-        FROM_HERE,
-        base::Bind(bt_rc_ctrl_callbacks->play_position_changed_cb,
-                   p_dev->rc_addr, p_rsp->song_len, p_rsp->song_pos));
+    if (btif_rc_ctrl_status_notif_allowed(p_dev, p_rsp->play_status)) {
+      do_in_jni_thread(
+          FROM_HERE,
+          base::Bind(bt_rc_ctrl_callbacks->play_status_changed_cb,
+                     p_dev->rc_addr, (btrc_play_status_t)p_rsp->play_status));
+    }
+    if (btif_rc_ctrl_pos_notif_allowed(p_dev, p_rsp->song_pos)) {
+      do_in_jni_thread(
+          FROM_HERE,
+          base::Bind(bt_rc_ctrl_callbacks->play_position_changed_cb,
+                     p_dev->rc_addr, p_rsp->song_len, p_rsp->song_pos));
+    }
   } else {
     BTIF_TRACE_ERROR("%s: Error in get play status procedure: %d", __func__,
                      p_rsp->status);
@@ -4510,6 +4701,7 @@ static void cleanup() {
     memset(&btif_rc_cb.rc_multi_cb[idx], 0,
            sizeof(btif_rc_cb.rc_multi_cb[idx]));
   }
+  element_attr_cache.valid = false;
 
   BTIF_TRACE_EVENT("%s: completed", __func__);
 }
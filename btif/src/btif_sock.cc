@@ -42,6 +42,11 @@
 
 using bluetooth::Uuid;
 
+/* Poll threads for the socket data plane. Sockets are spread over the shards
+ * by their slot id, so one saturated transfer no longer delays wakeups for
+ * every other socket. */
+#define BTSOCK_POLL_SHARDS 4
+
 static bt_status_t btsock_listen(btsock_type_t type, const char* service_name,
                                  const Uuid* uuid, int channel, int* sock_fd,
                                  int flags, int app_uid);
@@ -72,7 +77,8 @@ bt_status_t btif_sock_init(uid_set_t* uid_set) {
 
   bt_status_t status;
   btsock_thread_init();
-  thread_handle = btsock_thread_create(btsock_signaled, NULL);
+  thread_handle = btsock_thread_create_pool(btsock_signaled, NULL,
+                                            BTSOCK_POLL_SHARDS);
   if (thread_handle == -1) {
     LOG_ERROR("%s unable to create btsock_thread.", __func__);
     goto error;
@@ -64,12 +64,21 @@ typedef struct l2cap_socket {
   bool is_le_coc;                 // is le connection oriented channel?
   uint16_t rx_mtu;
   uint16_t tx_mtu;
+  // Bytes handed to BTA for transmission but not yet confirmed written.
+  // Bounds how far btsock_l2cap_signaled may read ahead of the ACL link.
+  unsigned tx_backlog_bytes;
   // Cumulative number of bytes transmitted on this socket
   int64_t tx_bytes;
   // Cumulative number of bytes received on this socket
   int64_t rx_bytes;
 } l2cap_socket;
 
+/* Stop draining the app socket once this many bytes are queued towards the
+ * stack. Needs to cover several SDUs so the L2CAP layer never idles between
+ * write-done events, while keeping the BT_HDR backlog bounded. When the
+ * watermark is smaller than the MTU one SDU per wakeup still goes through. */
+static const unsigned L2CAP_SOCK_TX_BACKLOG_WATERMARK = 32 * 1024;
+
 static void btsock_l2cap_server_listen(l2cap_socket* sock);
 
 static std::mutex state_lock;
@@ -583,6 +592,10 @@ static void on_l2cap_write_done(uint16_t len, uint32_t id) {
   }
 
   int app_uid = sock->app_uid;
+  if (sock->tx_backlog_bytes > len)
+    sock->tx_backlog_bytes -= len;
+  else
+    sock->tx_backlog_bytes = 0;
   if (!sock->outgoing_congest) {
     btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP, SOCK_THREAD_FD_RD,
                          sock->id);
@@ -863,30 +876,44 @@ void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id) {
            BluetoothSocket.write(...) guarantees that any packet send to this
            socket is broken into pieces no bigger than MTU bytes (as requested
            by BT spec). */
-        size = std::min(size, (int)sock->tx_mtu);
-
-        BT_HDR* buffer = malloc_l2cap_buf(size);
-        /* The socket is created with SOCK_SEQPACKET, hence we read one message
-         * at the time. */
-        ssize_t count;
-        OSI_NO_INTR(count = recv(fd, get_l2cap_sdu_start_ptr(buffer), size,
-                                 MSG_NOSIGNAL | MSG_DONTWAIT | MSG_TRUNC));
-        if (count > sock->tx_mtu) {
-          /* This can't happen thanks to check in BluetoothSocket.java but leave
-           * this in case this socket is ever used anywhere else*/
-          LOG(ERROR) << "recv more than MTU. Data will be lost: " << count;
-          count = sock->tx_mtu;
+        /* Drain as many messages as are pending in one wakeup instead of one
+           message per poll round trip; the per-socket backlog watermark keeps
+           the read-ahead bounded and congestion reports pause us entirely. */
+        while (size > 0 && !sock->outgoing_congest &&
+               sock->tx_backlog_bytes < L2CAP_SOCK_TX_BACKLOG_WATERMARK) {
+          int chunk = std::min(size, (int)sock->tx_mtu);
+
+          BT_HDR* buffer = malloc_l2cap_buf(chunk);
+          /* The socket is created with SOCK_SEQPACKET, hence we read one
+           * message at the time. */
+          ssize_t count;
+          OSI_NO_INTR(count = recv(fd, get_l2cap_sdu_start_ptr(buffer), chunk,
+                                   MSG_NOSIGNAL | MSG_DONTWAIT | MSG_TRUNC));
+          if (count <= 0) {
+            /* Nothing left despite what ioctl reported; wait for the next
+             * readiness signal. */
+            osi_free(buffer);
+            break;
+          }
+          if (count > sock->tx_mtu) {
+            /* This can't happen thanks to check in BluetoothSocket.java but
+             * leave this in case this socket is ever used anywhere else*/
+            LOG(ERROR) << "recv more than MTU. Data will be lost: " << count;
+            count = sock->tx_mtu;
+          }
+
+          /* When multiple packets smaller than MTU are flushed to the socket,
+             the size of the single packet read could be smaller than the ioctl
+             reported total size of awaiting packets. Hence, we adjust the
+             buffer length. */
+          buffer->len = count;
+          size -= count;
+          sock->tx_backlog_bytes += count;
+          DVLOG(2) << __func__ << ": bytes received from socket: " << count;
+
+          // will take care of freeing buffer
+          BTA_JvL2capWrite(sock->handle, PTR_TO_UINT(buffer), buffer, user_id);
         }
-
-        /* When multiple packets smaller than MTU are flushed to the socket, the
-           size of the single packet read could be smaller than the ioctl
-           reported total size of awaiting packets. Hence, we adjust the buffer
-           length. */
-        buffer->len = count;
-        DVLOG(2) << __func__ << ": bytes received from socket: " << count;
-
-        // will take care of freeing buffer
-        BTA_JvL2capWrite(sock->handle, PTR_TO_UINT(buffer), buffer, user_id);
       }
     } else
       drop_it = true;
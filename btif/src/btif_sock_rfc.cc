@@ -24,10 +24,12 @@
 #include <sys/types.h>
 #include <cstdint>
 #include <mutex>
+#include <string>
 
 #include "bt_target.h"  // Must be first to define build configuration
 
 #include "bta/include/bta_jv_api.h"
+#include "btif/include/btif_config.h"
 #include "btif/include/btif_metrics_logging.h"
 /* The JV interface can have only one user, hence we need to call a few
  * L2CAP functions from this file. */
@@ -37,6 +39,7 @@
 #include "btif/include/btif_sock_util.h"
 #include "btif/include/btif_uid.h"
 #include "include/hardware/bt_sock.h"
+#include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
 #include "osi/include/list.h"
@@ -56,13 +59,23 @@ using bluetooth::Uuid;
 // Maximum number of devices we can have an RFCOMM connection with.
 #define MAX_RFC_SESSION 7
 
+// Nagle-style TX coalescing: a small app write is held up to this long so
+// back-to-back writes share one RFCOMM frame. A full MTU of pending data
+// flushes immediately, and sockets opened with BTSOCK_FLAG_NO_COALESCE
+// bypass the hold entirely.
+#define RFC_COALESCE_FLUSH_MS 5
+
 typedef struct {
   int outgoing_congest : 1;
   int pending_sdp_request : 1;
   int doing_sdp_request : 1;
+  // Connecting on a cached SCN while SDP verification runs in parallel.
+  int warm_scn_connect : 1;
   int server : 1;
   int connected : 1;
   int closing : 1;
+  // Opted out of TX coalescing (BTSOCK_FLAG_NO_COALESCE).
+  int no_coalesce : 1;
 } flags_t;
 
 typedef struct {
@@ -86,6 +99,8 @@ typedef struct {
   int rfc_port_handle;
   int role;
   list_t* incoming_queue;
+  // Flush timer for coalesced outgoing data.
+  alarm_t* coalesce_timer;
   // Cumulative number of bytes transmitted on this socket
   int64_t tx_bytes;
   // Cumulative number of bytes received on this socket
@@ -119,6 +134,8 @@ bt_status_t btsock_rfc_init(int poll_thread_handle, uid_set_t* set) {
     rfc_slots[i].app_fd = INVALID_FD;
     rfc_slots[i].incoming_queue = list_new(osi_free);
     CHECK(rfc_slots[i].incoming_queue != NULL);
+    rfc_slots[i].coalesce_timer = alarm_new("btif_sock_rfc.coalesce_timer");
+    CHECK(rfc_slots[i].coalesce_timer != NULL);
   }
 
   BTA_JvEnable(jv_dm_cback);
@@ -137,6 +154,8 @@ void btsock_rfc_cleanup(void) {
     if (rfc_slots[i].id) cleanup_rfc_slot(&rfc_slots[i]);
     list_free(rfc_slots[i].incoming_queue);
     rfc_slots[i].incoming_queue = NULL;
+    alarm_free(rfc_slots[i].coalesce_timer);
+    rfc_slots[i].coalesce_timer = NULL;
   }
 }
 
@@ -175,6 +194,30 @@ static bool is_requesting_sdp(void) {
   return false;
 }
 
+// SCN cache for outgoing connections: remembers which server channel a
+// peer's service resolved to during a prior SDP lookup (persisted through
+// btif_config), so reconnects can bring up the RFCOMM session concurrently
+// with SDP verification instead of chaining the two.
+
+static std::string scn_cache_key(const Uuid& uuid) {
+  return std::string("RfcommCachedScn-") + uuid.ToString();
+}
+
+static int get_cached_scn(const RawAddress& addr, const Uuid& uuid) {
+  int scn = 0;
+  if (!btif_config_get_int(addr.ToString(), scn_cache_key(uuid), &scn))
+    return 0;
+  return (scn >= 1 && scn <= MAX_RFC_CHANNEL) ? scn : 0;
+}
+
+static void cache_scn(const RawAddress& addr, const Uuid& uuid, int scn) {
+  btif_config_set_int(addr.ToString(), scn_cache_key(uuid), scn);
+}
+
+static void remove_cached_scn(const RawAddress& addr, const Uuid& uuid) {
+  btif_config_remove(addr.ToString(), scn_cache_key(uuid));
+}
+
 static rfc_slot_t* alloc_rfc_slot(const RawAddress* addr, const char* name,
                                   const Uuid& uuid, int channel, int flags,
                                   bool server) {
@@ -224,6 +267,7 @@ static rfc_slot_t* alloc_rfc_slot(const RawAddress* addr, const char* name,
   }
   slot->id = rfc_slot_id;
   slot->f.server = server;
+  slot->f.no_coalesce = (flags & BTSOCK_FLAG_NO_COALESCE) != 0;
   slot->tx_bytes = 0;
   slot->rx_bytes = 0;
   return slot;
@@ -242,6 +286,7 @@ static rfc_slot_t* create_srv_accept_rfc_slot(rfc_slot_t* srv_rs,
 
   accept_rs->f.server = false;
   accept_rs->f.connected = true;
+  accept_rs->f.no_coalesce = srv_rs->f.no_coalesce;
   accept_rs->security = srv_rs->security;
   accept_rs->mtu = srv_rs->mtu;
   accept_rs->role = srv_rs->role;
@@ -358,6 +403,30 @@ bt_status_t btsock_rfc_connect(const RawAddress* bd_addr,
       return BT_STATUS_FAIL;
     }
   } else {
+    int cached_scn = get_cached_scn(*bd_addr, *service_uuid);
+    if (cached_scn != 0) {
+      // Warm path: start the RFCOMM session on the channel this service
+      // resolved to last time, and let SDP verify the cache in parallel
+      // instead of gating the connection on it.
+      slot->scn = cached_scn;
+      slot->f.warm_scn_connect = true;
+      tBTA_JV_STATUS ret =
+          BTA_JvRfcommConnect(slot->security, slot->role, slot->scn,
+                              slot->addr, rfcomm_cback, slot->id);
+      if (ret != BTA_JV_SUCCESS) {
+        LOG_ERROR("%s unable to initiate warm RFCOMM connection: %d",
+                  __func__, ret);
+        cleanup_rfc_slot(slot);
+        return BT_STATUS_FAIL;
+      }
+
+      if (!send_app_scn(slot)) {
+        LOG_ERROR("%s unable to send channel number.", __func__);
+        cleanup_rfc_slot(slot);
+        return BT_STATUS_FAIL;
+      }
+    }
+
     if (!is_requesting_sdp()) {
       BTA_JvStartDiscovery(*bd_addr, 1, service_uuid, slot->id);
       slot->f.pending_sdp_request = false;
@@ -399,6 +468,8 @@ static void free_rfc_slot_scn(rfc_slot_t* slot) {
 }
 
 static void cleanup_rfc_slot(rfc_slot_t* slot) {
+  alarm_cancel(slot->coalesce_timer);
+
   if (slot->fd != INVALID_FD) {
     shutdown(slot->fd, SHUT_RDWR);
     close(slot->fd);
@@ -531,6 +602,10 @@ static void on_cli_rfc_connect(tBTA_JV_RFCOMM_OPEN* p_open, uint32_t id) {
   if (!slot) return;
 
   if (p_open->status != BTA_JV_SUCCESS) {
+    // A failed warm connect means the cached channel went stale; forget it
+    // so the next attempt runs the full SDP lookup first.
+    if (slot->f.warm_scn_connect)
+      remove_cached_scn(slot->addr, slot->service_uuid);
     cleanup_rfc_slot(slot);
     return;
   }
@@ -665,16 +740,12 @@ static void jv_dm_cback(tBTA_JV_EVT event, tBTA_JV* p_data, uint32_t id) {
 
       if (rs && (new_scn != 0)) {
         rs->scn = new_scn;
-        /* BTA_JvCreateRecordByUser will only create a record if a UUID is
-         * specified,
-         * else it just allocate a RFC channel and start the RFCOMM thread -
-         * needed
-         * for the java
-         * layer to get a RFCOMM channel.
-         * If uuid is null the create_sdp_record() will be called from Java when
-         * it
-         * has received the RFCOMM and L2CAP channel numbers through the
-         * sockets.*/
+        /* A record is only created here if a UUID is specified, else we
+         * just allocated a RFC channel and start the RFCOMM thread - needed
+         * for the java layer to get a RFCOMM channel.
+         * If uuid is null the create_sdp_record() will be called from Java
+         * when it has received the RFCOMM and L2CAP channel numbers through
+         * the sockets.*/
 
         // Send channel ID to java layer
         if (!send_app_scn(rs)) {
@@ -683,9 +754,18 @@ static void jv_dm_cback(tBTA_JV_EVT event, tBTA_JV* p_data, uint32_t id) {
           cleanup_rfc_slot(rs);
         } else {
           if (rs->is_service_uuid_valid) {
-            // We already have data for SDP record, create it (RFC-only
-            // profiles)
-            BTA_JvCreateRecordByUser(rs->id);
+            // We already have data for the SDP record and this callback
+            // already runs in stack thread context, so publish the record
+            // directly instead of bouncing through BTA_JvCreateRecordByUser
+            // for an extra main-loop round trip per listener.
+            if (create_server_sdp_record(rs)) {
+              BTA_JvRfcommStartServer(rs->security, rs->role, rs->scn,
+                                      MAX_RFC_SESSION, rfcomm_cback, rs->id);
+            } else {
+              APPL_TRACE_ERROR(
+                  "jv_dm_cback: cannot start server, slot found:%p", rs);
+              cleanup_rfc_slot(rs);
+            }
           } else {
             APPL_TRACE_DEBUG(
                 "is_service_uuid_valid==false - don't set SDP-record, "
@@ -709,34 +789,30 @@ static void jv_dm_cback(tBTA_JV_EVT event, tBTA_JV* p_data, uint32_t id) {
       on_l2cap_psm_assigned(id, p_data->psm);
       break;
     }
-    case BTA_JV_CREATE_RECORD_EVT: {
-      std::unique_lock<std::recursive_mutex> lock(slot_lock);
-      rfc_slot_t* slot = find_rfc_slot_by_id(id);
-
-      if (slot && create_server_sdp_record(slot)) {
-        // Start the rfcomm server after sdp & channel # assigned.
-        BTA_JvRfcommStartServer(slot->security, slot->role, slot->scn,
-                                MAX_RFC_SESSION, rfcomm_cback, slot->id);
-      } else if (slot) {
-        APPL_TRACE_ERROR("jv_dm_cback: cannot start server, slot found:%p",
-                         slot);
-        cleanup_rfc_slot(slot);
-      }
-      break;
-    }
-
     case BTA_JV_DISCOVERY_COMP_EVT: {
       std::unique_lock<std::recursive_mutex> lock(slot_lock);
       rfc_slot_t* slot = find_rfc_slot_by_id(id);
       if (p_data->disc_comp.status == BTA_JV_SUCCESS && p_data->disc_comp.scn) {
         if (slot && slot->f.doing_sdp_request) {
-          // Establish the connection if we successfully looked up a channel
-          // number to connect to.
-          if (BTA_JvRfcommConnect(slot->security, slot->role,
-                                  p_data->disc_comp.scn, slot->addr,
-                                  rfcomm_cback, slot->id) == BTA_JV_SUCCESS) {
+          if (slot->f.warm_scn_connect) {
+            // The connection is already in flight on the cached channel;
+            // this lookup only reconciles the cache. On a mismatch the
+            // in-flight attempt will fail and the next connect picks up
+            // the fresh channel.
+            slot->f.doing_sdp_request = false;
+            slot->f.warm_scn_connect = false;
+            if (p_data->disc_comp.scn != slot->scn)
+              cache_scn(slot->addr, slot->service_uuid,
+                        p_data->disc_comp.scn);
+          } else if (BTA_JvRfcommConnect(slot->security, slot->role,
+                                         p_data->disc_comp.scn, slot->addr,
+                                         rfcomm_cback,
+                                         slot->id) == BTA_JV_SUCCESS) {
+            // Establish the connection if we successfully looked up a channel
+            // number to connect to. Remember the channel for warm reconnects.
             slot->scn = p_data->disc_comp.scn;
             slot->f.doing_sdp_request = false;
+            cache_scn(slot->addr, slot->service_uuid, p_data->disc_comp.scn);
             if (!send_app_scn(slot)) cleanup_rfc_slot(slot);
           } else {
             cleanup_rfc_slot(slot);
@@ -749,6 +825,14 @@ static void jv_dm_cback(tBTA_JV_EVT event, tBTA_JV* p_data, uint32_t id) {
               "request SDP record.",
               __func__, id);
         }
+      } else if (slot && slot->f.doing_sdp_request &&
+                 slot->f.warm_scn_connect) {
+        // SDP verification failed but a warm connection is still in flight;
+        // drop the cached mapping and let the RFCOMM result decide the
+        // slot's fate.
+        remove_cached_scn(slot->addr, slot->service_uuid);
+        slot->f.doing_sdp_request = false;
+        slot->f.warm_scn_connect = false;
       } else if (slot) {
         cleanup_rfc_slot(slot);
       }
@@ -829,6 +913,34 @@ static bool flush_incoming_que_on_wr_signal(rfc_slot_t* slot) {
   return true;
 }
 
+static void rfc_coalesce_flush_timeout(void* data) {
+  uint32_t id = (uintptr_t)data;
+  std::unique_lock<std::recursive_mutex> lock(slot_lock);
+  rfc_slot_t* slot = find_rfc_slot_by_id(id);
+  if (!slot || !slot->f.connected) return;
+  BTA_JvRfcommWrite(slot->rfc_handle, slot->id);
+}
+
+// Decides whether the pending app data should be held for coalescing
+// instead of being pushed to the stack right away. A hold arms the
+// per-socket flush timer, so the write goes out at the latest
+// RFC_COALESCE_FLUSH_MS after the first held byte; less than an MTU of
+// pending data is the only thing worth holding.
+static bool rfc_coalesce_hold(rfc_slot_t* slot, int sock_flags) {
+  if (slot->f.no_coalesce || (sock_flags & SOCK_THREAD_FD_EXCEPTION))
+    return false;
+
+  int pending = 0;
+  if (ioctl(slot->fd, FIONREAD, &pending) != 0) return false;
+  if (slot->mtu > 0 && pending >= slot->mtu) return false;
+
+  if (!alarm_is_scheduled(slot->coalesce_timer)) {
+    alarm_set_on_mloop(slot->coalesce_timer, RFC_COALESCE_FLUSH_MS,
+                       rfc_coalesce_flush_timeout, (void*)(uintptr_t)slot->id);
+  }
+  return true;
+}
+
 void btsock_rfc_signaled(UNUSED_ATTR int fd, int flags, uint32_t user_id) {
   bool need_close = false;
   std::unique_lock<std::recursive_mutex> lock(slot_lock);
@@ -842,7 +954,10 @@ void btsock_rfc_signaled(UNUSED_ATTR int fd, int flags, uint32_t user_id) {
       int size = 0;
       if (!(flags & SOCK_THREAD_FD_EXCEPTION) ||
           (ioctl(slot->fd, FIONREAD, &size) == 0 && size)) {
-        BTA_JvRfcommWrite(slot->rfc_handle, slot->id);
+        if (!rfc_coalesce_hold(slot, flags)) {
+          alarm_cancel(slot->coalesce_timer);
+          BTA_JvRfcommWrite(slot->rfc_handle, slot->id);
+        }
       }
     } else {
       LOG_ERROR(
@@ -66,6 +66,7 @@
 
 #define MAX_THREAD 8
 #define MAX_POLL 64
+#define MAX_SHARD 4
 #define POLL_EXCEPTION_EVENTS (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL)
 #define IS_EXCEPTION(e) ((e)&POLL_EXCEPTION_EVENTS)
 #define IS_READ(e) ((e)&POLLIN)
@@ -92,6 +93,11 @@ struct thread_slot_t {
   btsock_signaled_cb callback;
   btsock_cmd_cb cmd_callback;
   int used;
+  /* Shards of the pool fronted by this handle; shard_handles[0] is the
+   * handle itself. A plain thread has shard_count 1. */
+  int shard_count;
+  int shard_handles[MAX_SHARD];
+  uint64_t dispatch_count;  // signals delivered to the callback
 };
 static thread_slot_t ts[MAX_THREAD];
 
@@ -146,9 +152,17 @@ static void free_thread_slot(int h) {
   if (0 <= h && h < MAX_THREAD) {
     close_cmd_fd(h);
     ts[h].used = 0;
+    ts[h].shard_count = 0;
   } else
     APPL_TRACE_ERROR("invalid thread handle:%d", h);
 }
+
+/* map a socket to its shard; the same user_id always lands on the same
+ * thread, which keeps per-socket event ordering intact */
+static inline int resolve_shard(int h, uint32_t user_id) {
+  if (ts[h].shard_count <= 1) return h;
+  return ts[h].shard_handles[user_id % (uint32_t)ts[h].shard_count];
+}
 void btsock_thread_init() {
   static int initialized;
   if (!initialized) {
@@ -161,6 +175,8 @@ void btsock_thread_init() {
       ts[h].poll_count = 0;
       ts[h].callback = NULL;
       ts[h].cmd_callback = NULL;
+      ts[h].shard_count = 0;
+      ts[h].dispatch_count = 0;
     }
   }
 }
@@ -181,6 +197,24 @@ int btsock_thread_create(btsock_signaled_cb callback,
     ts[h].thread_id = thread;
     ts[h].callback = callback;
     ts[h].cmd_callback = cmd_callback;
+    ts[h].shard_count = 1;
+    ts[h].shard_handles[0] = h;
+    ts[h].dispatch_count = 0;
+  }
+  return h;
+}
+
+int btsock_thread_create_pool(btsock_signaled_cb callback,
+                              btsock_cmd_cb cmd_callback, int shard_count) {
+  if (shard_count > MAX_SHARD) shard_count = MAX_SHARD;
+  int h = btsock_thread_create(callback, cmd_callback);
+  if (h < 0) return h;
+  /* If a shard fails to come up just run with fewer of them; the pool
+   * degrades to the single thread behavior. */
+  for (int i = 1; i < shard_count; i++) {
+    int shard = btsock_thread_create(callback, cmd_callback);
+    if (shard < 0) break;
+    ts[h].shard_handles[ts[h].shard_count++] = shard;
   }
   return h;
 }
@@ -217,6 +251,7 @@ int btsock_thread_add_fd(int h, int fd, int type, int flags, uint32_t user_id) {
     APPL_TRACE_ERROR("invalid bt thread handle:%d", h);
     return false;
   }
+  h = resolve_shard(h, user_id);
   if (ts[h].cmd_fdw == -1) {
     APPL_TRACE_ERROR(
         "cmd socket is not created. socket thread may not initialized");
@@ -251,6 +286,20 @@ bool btsock_thread_remove_fd_and_close(int thread_handle, int fd) {
     return false;
   }
 
+  /* find the shard whose poll set owns the fd so only that thread closes it;
+   * fall back to the head shard which closes unknown fds as before */
+  bool shard_found = false;
+  for (int s = 1; s < ts[thread_handle].shard_count && !shard_found; s++) {
+    int shard = ts[thread_handle].shard_handles[s];
+    for (int i = 1; i < MAX_POLL; ++i) {
+      if (ts[shard].ps[i].pfd.fd == fd) {
+        thread_handle = shard;
+        shard_found = true;
+        break;
+      }
+    }
+  }
+
   sock_cmd_t cmd = {CMD_REMOVE_FD, fd, 0, 0, 0};
 
   ssize_t ret;
@@ -265,6 +314,7 @@ int btsock_thread_post_cmd(int h, int type, const unsigned char* data, int size,
     APPL_TRACE_ERROR("invalid bt thread handle:%d", h);
     return false;
   }
+  h = resolve_shard(h, user_id);
   if (ts[h].cmd_fdw == -1) {
     APPL_TRACE_ERROR(
         "cmd socket is not created. socket thread may not initialized");
@@ -302,16 +352,17 @@ int btsock_thread_wakeup(int h) {
   }
   sock_cmd_t cmd = {CMD_WAKEUP, 0, 0, 0, 0};
 
-  ssize_t ret;
-  OSI_NO_INTR(ret = send(ts[h].cmd_fdw, &cmd, sizeof(cmd), 0));
-
-  return ret == sizeof(cmd);
-}
-int btsock_thread_exit(int h) {
-  if (h < 0 || h >= MAX_THREAD) {
-    APPL_TRACE_ERROR("invalid bt thread slot:%d", h);
-    return false;
+  int result = true;
+  /* wake every shard; a plain thread is its own single shard */
+  for (int s = 0; s < ts[h].shard_count; s++) {
+    ssize_t ret;
+    OSI_NO_INTR(
+        ret = send(ts[ts[h].shard_handles[s]].cmd_fdw, &cmd, sizeof(cmd), 0));
+    if (ret != sizeof(cmd)) result = false;
   }
+  return result;
+}
+static int btsock_thread_exit_one(int h) {
   if (ts[h].cmd_fdw == -1) {
     APPL_TRACE_ERROR("cmd socket is not created");
     return false;
@@ -331,6 +382,31 @@ int btsock_thread_exit(int h) {
   }
   return false;
 }
+int btsock_thread_exit(int h) {
+  if (h < 0 || h >= MAX_THREAD) {
+    APPL_TRACE_ERROR("invalid bt thread slot:%d", h);
+    return false;
+  }
+  int result = true;
+  /* stop the extra shards first, then the head which owns the pool */
+  for (int s = ts[h].shard_count - 1; s >= 1; s--) {
+    if (!btsock_thread_exit_one(ts[h].shard_handles[s])) result = false;
+  }
+  if (!btsock_thread_exit_one(h)) result = false;
+  return result;
+}
+
+void btsock_thread_dump(int fd) {
+  dprintf(fd, "\nBTSOCK poll threads:\n");
+  std::unique_lock<std::recursive_mutex> lock(thread_slot_lock);
+  for (int h = 0; h < MAX_THREAD; h++) {
+    if (!ts[h].used) continue;
+    /* slot 0 of the poll set is the internal cmd fd */
+    dprintf(fd, "  thread: %d  sockets: %d  signals dispatched: %llu\n", h,
+            ts[h].poll_count > 0 ? ts[h].poll_count - 1 : 0,
+            (unsigned long long)ts[h].dispatch_count);
+  }
+}
 static void init_poll(int h) {
   int i;
   ts[h].poll_count = 0;
@@ -465,7 +541,10 @@ static void process_data_sock(int h, struct pollfd* pfds, int count) {
       } else if (flags)
         remove_poll(h, &ts[h].ps[ps_i],
                     flags);  // remove the monitor flags that already processed
-      if (flags) ts[h].callback(pfds[i].fd, type, flags, user_id);
+      if (flags) {
+        ts[h].dispatch_count++;
+        ts[h].callback(pfds[i].fd, type, flags, user_id);
+      }
     }
   }
 }
@@ -35,10 +35,15 @@
 #include <alloca.h>
 #include <base/logging.h>
 #include <ctype.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "bt_common.h"
 #include "bta_hd_api.h"
 #include "bta_hearing_aid_api.h"
@@ -48,6 +53,7 @@
 #include "btif_hd.h"
 #include "btif_hh.h"
 #include "btif_util.h"
+#include "common/worker_thread_pool.h"
 #include "device/include/controller.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
@@ -71,6 +77,7 @@ using bluetooth::Uuid;
 #define BTIF_STORAGE_PATH_REMOTE_DEVCLASS "DevClass"
 #define BTIF_STORAGE_PATH_REMOTE_DEVTYPE "DevType"
 #define BTIF_STORAGE_PATH_REMOTE_NAME "Name"
+#define BTIF_STORAGE_PATH_REMOTE_NAME_TIMESTAMP "NameTimestamp"
 
 //#define BTIF_STORAGE_PATH_REMOTE_LINKKEYS "remote_linkkeys"
 #define BTIF_STORAGE_PATH_REMOTE_ALIASE "Aliase"
@@ -210,6 +217,8 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       value[name_length] = '\0';
       if (remote_bd_addr) {
         btif_config_set_str(bdstr, BTIF_STORAGE_PATH_REMOTE_NAME, value);
+        btif_config_set_int(bdstr, BTIF_STORAGE_PATH_REMOTE_NAME_TIMESTAMP,
+                            (int)time(NULL));
       } else {
         btif_config_set_str("Adapter", BTIF_STORAGE_KEY_ADAPTER_NAME, value);
         btif_config_flush();
@@ -755,6 +764,40 @@ bt_status_t btif_storage_set_remote_device_property(
                                             : BT_STATUS_FAIL;
 }
 
+/*******************************************************************************
+ *
+ * Function         btif_storage_get_cached_remote_name
+ *
+ * Description      BTIF storage API - Fetches the persisted remote device
+ *                  name and reports how long ago it was stored, so callers
+ *                  can decide whether a remote name request round trip is
+ *                  needed. Entries stored before the timestamp was tracked
+ *                  are reported as arbitrarily old.
+ *
+ * Returns          true if a name is cached for the device, in which case
+ *                  |bd_name| and |*p_age_seconds| are filled in
+ *
+ ******************************************************************************/
+bool btif_storage_get_cached_remote_name(const RawAddress& remote_bd_addr,
+                                         BD_NAME bd_name, int* p_age_seconds) {
+  std::string bdstr = remote_bd_addr.ToString();
+  int len = BD_NAME_LEN + 1;
+  if (!btif_config_get_str(bdstr, BTIF_STORAGE_PATH_REMOTE_NAME,
+                           (char*)bd_name, &len) ||
+      len <= 1) {
+    return false;
+  }
+
+  int timestamp = 0;
+  if (btif_config_get_int(bdstr, BTIF_STORAGE_PATH_REMOTE_NAME_TIMESTAMP,
+                          &timestamp)) {
+    *p_age_seconds = (int)(time(NULL) - (time_t)timestamp);
+  } else {
+    *p_age_seconds = INT_MAX;
+  }
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         btif_storage_add_remote_device
@@ -898,6 +941,77 @@ static void remove_devices_with_sample_ltk() {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         btif_in_decode_remote_properties
+ *
+ * Description      Internal helper function to decode the cached remote
+ *                  device properties out of a single config section copy in
+ *                  one pass over its entries, instead of issuing a keyed
+ *                  config lookup (and config lock round trip) per property.
+ *
+ *                  Missing entries are reported the same way the keyed
+ *                  getters report them: strings and UUID lists with zero
+ *                  length, integers as 0.
+ *
+ * Returns          Number of properties filled into |remote_properties|
+ *
+ ******************************************************************************/
+static uint32_t btif_in_decode_remote_properties(
+    const section_t& section, bt_bdname_t* name, bt_bdname_t* alias,
+    uint32_t* cod, uint32_t* devtype, Uuid* remote_uuids,
+    bt_property_t* remote_properties) {
+  uint32_t num_props = 0;
+
+  bt_property_t* prop = &remote_properties[num_props++];
+  prop->type = BT_PROPERTY_BDNAME;
+  prop->val = name;
+  prop->len = 0;
+
+  prop = &remote_properties[num_props++];
+  prop->type = BT_PROPERTY_REMOTE_FRIENDLY_NAME;
+  prop->val = alias;
+  prop->len = 0;
+
+  *cod = 0;
+  prop = &remote_properties[num_props++];
+  prop->type = BT_PROPERTY_CLASS_OF_DEVICE;
+  prop->val = cod;
+  prop->len = sizeof(*cod);
+
+  *devtype = 0;
+  prop = &remote_properties[num_props++];
+  prop->type = BT_PROPERTY_TYPE_OF_DEVICE;
+  prop->val = devtype;
+  prop->len = sizeof(*devtype);
+
+  bt_property_t* uuids_prop = &remote_properties[num_props++];
+  uuids_prop->type = BT_PROPERTY_UUIDS;
+  uuids_prop->val = NULL;
+  uuids_prop->len = 0;
+
+  for (const entry_t& entry : section.entries) {
+    if (entry.key == BTIF_STORAGE_PATH_REMOTE_NAME) {
+      strlcpy((char*)name->name, entry.value.c_str(), sizeof(name->name));
+      remote_properties[0].len = strlen((char*)name->name);
+    } else if (entry.key == BTIF_STORAGE_PATH_REMOTE_ALIASE) {
+      strlcpy((char*)alias->name, entry.value.c_str(), sizeof(alias->name));
+      remote_properties[1].len = strlen((char*)alias->name);
+    } else if (entry.key == BTIF_STORAGE_PATH_REMOTE_DEVCLASS) {
+      *cod = (uint32_t)strtoul(entry.value.c_str(), NULL, 0);
+    } else if (entry.key == BTIF_STORAGE_PATH_REMOTE_DEVTYPE) {
+      *devtype = (uint32_t)strtoul(entry.value.c_str(), NULL, 0);
+    } else if (entry.key == BTIF_STORAGE_PATH_REMOTE_SERVICE) {
+      size_t num_uuids = btif_split_uuids_string(
+          entry.value.c_str(), remote_uuids, BT_MAX_NUM_UUIDS);
+      uuids_prop->val = remote_uuids;
+      uuids_prop->len = num_uuids * sizeof(Uuid);
+    }
+  }
+
+  return num_props;
+}
+
 /*******************************************************************************
  *
  * Function         btif_storage_load_bonded_devices
@@ -1003,29 +1117,40 @@ bt_status_t btif_storage_load_bonded_devices(void) {
       num_props = 0;
       p_remote_addr = &bonded_devices.devices[i];
       memset(remote_properties, 0, sizeof(remote_properties));
-      BTIF_STORAGE_GET_REMOTE_PROP(p_remote_addr, BT_PROPERTY_BDNAME, &name,
-                                   sizeof(name), remote_properties[num_props]);
-      num_props++;
 
-      BTIF_STORAGE_GET_REMOTE_PROP(p_remote_addr,
-                                   BT_PROPERTY_REMOTE_FRIENDLY_NAME, &alias,
-                                   sizeof(alias), remote_properties[num_props]);
-      num_props++;
-
-      BTIF_STORAGE_GET_REMOTE_PROP(p_remote_addr, BT_PROPERTY_CLASS_OF_DEVICE,
-                                   &cod, sizeof(cod),
-                                   remote_properties[num_props]);
-      num_props++;
-
-      BTIF_STORAGE_GET_REMOTE_PROP(p_remote_addr, BT_PROPERTY_TYPE_OF_DEVICE,
-                                   &devtype, sizeof(devtype),
-                                   remote_properties[num_props]);
-      num_props++;
-
-      BTIF_STORAGE_GET_REMOTE_PROP(p_remote_addr, BT_PROPERTY_UUIDS,
-                                   remote_uuids, sizeof(remote_uuids),
-                                   remote_properties[num_props]);
-      num_props++;
+      /* Decode everything out of one section copy; with many bonds the
+       * per-property keyed lookups dominate the adapter enable time. */
+      auto section = btif_config_get_section(p_remote_addr->ToString());
+      if (section) {
+        num_props = btif_in_decode_remote_properties(
+            *section, &name, &alias, &cod, &devtype, remote_uuids,
+            remote_properties);
+      } else {
+        BTIF_STORAGE_GET_REMOTE_PROP(p_remote_addr, BT_PROPERTY_BDNAME, &name,
+                                     sizeof(name),
+                                     remote_properties[num_props]);
+        num_props++;
+
+        BTIF_STORAGE_GET_REMOTE_PROP(
+            p_remote_addr, BT_PROPERTY_REMOTE_FRIENDLY_NAME, &alias,
+            sizeof(alias), remote_properties[num_props]);
+        num_props++;
+
+        BTIF_STORAGE_GET_REMOTE_PROP(p_remote_addr,
+                                     BT_PROPERTY_CLASS_OF_DEVICE, &cod,
+                                     sizeof(cod), remote_properties[num_props]);
+        num_props++;
+
+        BTIF_STORAGE_GET_REMOTE_PROP(p_remote_addr, BT_PROPERTY_TYPE_OF_DEVICE,
+                                     &devtype, sizeof(devtype),
+                                     remote_properties[num_props]);
+        num_props++;
+
+        BTIF_STORAGE_GET_REMOTE_PROP(p_remote_addr, BT_PROPERTY_UUIDS,
+                                     remote_uuids, sizeof(remote_uuids),
+                                     remote_properties[num_props]);
+        num_props++;
+      }
 
       btif_remote_properties_evt(BT_STATUS_SUCCESS, p_remote_addr, num_props,
                                  remote_properties);
@@ -1359,64 +1484,133 @@ bt_status_t btif_storage_add_hid_device_info(
  * Description      BTIF storage API - Loads hid info for all the bonded devices
  *                  from NVRAM and adds those devices  to the BTA_HH.
  *
+ *                  The descriptor loads run on a small worker pool and each
+ *                  device is handed to BTA_HH from the JNI thread as its
+ *                  attributes come in, so adapter enable does not stall on
+ *                  the number of bonded HID devices.
+ *
  * Returns          BT_STATUS_SUCCESS if successful, BT_STATUS_FAIL otherwise
  *
  ******************************************************************************/
-bt_status_t btif_storage_load_bonded_hid_info(void) {
-  for (const auto& bd_addr : btif_config_get_paired_devices()) {
-    auto name = bd_addr.ToString();
 
-    BTIF_TRACE_DEBUG("Remote device:%s", name.c_str());
+// One bonded HID device's stored attributes, read off the JNI thread.
+typedef struct {
+  RawAddress bd_addr;
+  bool valid;
+  uint16_t attr_mask;
+  uint8_t sub_class;
+  uint8_t app_id;
+  tBTA_HH_DEV_DSCP_INFO dscp_info;
+  std::vector<uint8_t> descriptor;
+} btif_hid_dev_info_t;
+
+static std::unique_ptr<bluetooth::common::WorkerThreadPool> hid_load_pool;
+static std::atomic<int> hid_load_pending(0);
+
+/* Runs on the JNI thread; hands one loaded device to BTA_HH and reports its
+ * readiness. The pool is retired once the last device has come in. */
+static void btif_storage_hid_dev_ready(btif_hid_dev_info_t* info) {
+  if (info->valid) {
+    if (!info->descriptor.empty()) {
+      info->dscp_info.descriptor.dl_len = (uint16_t)info->descriptor.size();
+      info->dscp_info.descriptor.dsc_list = info->descriptor.data();
+    }
+    if (btif_hh_add_added_dev(info->bd_addr, info->attr_mask)) {
+      BTA_HhAddDev(info->bd_addr, info->attr_mask, info->sub_class,
+                   info->app_id, info->dscp_info);
+    }
+    LOG_INFO("%s: bonded HID device %s ready", __func__,
+             info->bd_addr.ToString().c_str());
+  }
+  if (--hid_load_pending == 0 && hid_load_pool != nullptr) {
+    hid_load_pool->ShutDown();
+    hid_load_pool.reset();
+  }
+}
 
-    int value;
-    if (!btif_config_get_int(name, "HidAttrMask", &value)) continue;
-    uint16_t attr_mask = (uint16_t)value;
+/* Runs on a worker thread; reads one bonded device's HID attributes from
+ * storage and posts the result back to the JNI thread. */
+static void btif_storage_load_hid_dev(const RawAddress& bd_addr) {
+  btif_hid_dev_info_t* info = new btif_hid_dev_info_t();
+  auto name = bd_addr.ToString();
+  info->bd_addr = bd_addr;
+  info->valid = false;
+
+  BTIF_TRACE_DEBUG("Remote device:%s", name.c_str());
+
+  int value;
+  if (btif_config_get_int(name, "HidAttrMask", &value)) {
+    info->attr_mask = (uint16_t)value;
 
     if (btif_in_fetch_bonded_device(name) != BT_STATUS_SUCCESS) {
       btif_storage_remove_hid_info(bd_addr);
-      continue;
-    }
-
-    tBTA_HH_DEV_DSCP_INFO dscp_info;
-    memset(&dscp_info, 0, sizeof(dscp_info));
+    } else {
+      memset(&info->dscp_info, 0, sizeof(info->dscp_info));
 
-    btif_config_get_int(name, "HidSubClass", &value);
-    uint8_t sub_class = (uint8_t)value;
+      btif_config_get_int(name, "HidSubClass", &value);
+      info->sub_class = (uint8_t)value;
 
-    btif_config_get_int(name, "HidAppId", &value);
-    uint8_t app_id = (uint8_t)value;
+      btif_config_get_int(name, "HidAppId", &value);
+      info->app_id = (uint8_t)value;
 
-    btif_config_get_int(name, "HidVendorId", &value);
-    dscp_info.vendor_id = (uint16_t)value;
+      btif_config_get_int(name, "HidVendorId", &value);
+      info->dscp_info.vendor_id = (uint16_t)value;
 
-    btif_config_get_int(name, "HidProductId", &value);
-    dscp_info.product_id = (uint16_t)value;
+      btif_config_get_int(name, "HidProductId", &value);
+      info->dscp_info.product_id = (uint16_t)value;
 
-    btif_config_get_int(name, "HidVersion", &value);
-    dscp_info.version = (uint8_t)value;
+      btif_config_get_int(name, "HidVersion", &value);
+      info->dscp_info.version = (uint8_t)value;
 
-    btif_config_get_int(name, "HidCountryCode", &value);
-    dscp_info.ctry_code = (uint8_t)value;
+      btif_config_get_int(name, "HidCountryCode", &value);
+      info->dscp_info.ctry_code = (uint8_t)value;
 
-    value = 0;
-    btif_config_get_int(name, "HidSSRMaxLatency", &value);
-    dscp_info.ssr_max_latency = (uint16_t)value;
+      value = 0;
+      btif_config_get_int(name, "HidSSRMaxLatency", &value);
+      info->dscp_info.ssr_max_latency = (uint16_t)value;
 
-    value = 0;
-    btif_config_get_int(name, "HidSSRMinTimeout", &value);
-    dscp_info.ssr_min_tout = (uint16_t)value;
+      value = 0;
+      btif_config_get_int(name, "HidSSRMinTimeout", &value);
+      info->dscp_info.ssr_min_tout = (uint16_t)value;
 
-    size_t len = btif_config_get_bin_length(name, "HidDescriptor");
-    if (len > 0) {
-      dscp_info.descriptor.dl_len = (uint16_t)len;
-      dscp_info.descriptor.dsc_list = (uint8_t*)alloca(len);
-      btif_config_get_bin(name, "HidDescriptor",
-                          (uint8_t*)dscp_info.descriptor.dsc_list, &len);
+      size_t len = btif_config_get_bin_length(name, "HidDescriptor");
+      if (len > 0) {
+        info->descriptor.resize(len);
+        btif_config_get_bin(name, "HidDescriptor", info->descriptor.data(),
+                            &len);
+      }
+      info->valid = true;
     }
+  }
+
+  do_in_jni_thread(FROM_HERE, base::BindOnce(&btif_storage_hid_dev_ready,
+                                             base::Owned(info)));
+}
+
+bt_status_t btif_storage_load_bonded_hid_info(void) {
+  /* only the cheap per-device filter runs inline; the descriptor loads are
+   * spread over the pool */
+  std::vector<RawAddress> hid_devs;
+  for (const auto& bd_addr : btif_config_get_paired_devices()) {
+    int value;
+    if (btif_config_get_int(bd_addr.ToString(), "HidAttrMask", &value))
+      hid_devs.push_back(bd_addr);
+  }
+  if (hid_devs.empty()) return BT_STATUS_SUCCESS;
+
+  if (hid_load_pool == nullptr) {
+    hid_load_pool =
+        std::make_unique<bluetooth::common::WorkerThreadPool>("hid_load", 2);
+    hid_load_pool->StartUp();
+  }
 
-    // add extracted information to BTA HH
-    if (btif_hh_add_added_dev(bd_addr, attr_mask)) {
-      BTA_HhAddDev(bd_addr, attr_mask, sub_class, app_id, dscp_info);
+  hid_load_pending += hid_devs.size();
+  for (const auto& bd_addr : hid_devs) {
+    if (!hid_load_pool->ScheduleJob(
+            base::BindOnce(&btif_storage_load_hid_dev, bd_addr))) {
+      /* pool unavailable; load inline, the result still lands on the JNI
+       * thread through the same path */
+      btif_storage_load_hid_dev(bd_addr);
     }
   }
 
@@ -22,11 +22,17 @@
  *                 socket usage per app UID.
  *
  ******************************************************************************/
+#include <atomic>
 #include <mutex>
 
 #include "bt_common.h"
 #include "btif_uid.h"
 
+// Number of lock-free accounting slots. Must be a power of two. A UID hashes
+// into the table and claims a slot for the lifetime of the set, so this only
+// needs to cover the number of distinct apps using Bluetooth sockets.
+#define UID_SET_MAX_UID_SLOTS 64
+
 static std::mutex set_lock;
 
 typedef struct uid_set_node_t {
@@ -34,31 +40,75 @@ typedef struct uid_set_node_t {
   bt_uid_traffic_t data;
 } uid_set_node_t;
 
+// One open addressing slot. |app_uid| is -1 until a writer claims the slot
+// with a compare-and-swap, after which the slot belongs to that UID for the
+// lifetime of the set. The counters are independent relaxed atomics, so
+// accounting a data chunk is a couple of atomic adds without taking a lock.
+typedef struct {
+  std::atomic<int32_t> app_uid;
+  std::atomic<uint64_t> rx_bytes;
+  std::atomic<uint64_t> tx_bytes;
+} uid_set_slot_t;
+
 typedef struct uid_set_t {
-  uid_set_node_t* head;
+  uid_set_slot_t slots[UID_SET_MAX_UID_SLOTS];
+  // Overflow for the (unexpected) case of more live UIDs than slots.
+  // Only touched with set_lock held.
+  uid_set_node_t* overflow_head;
 } uid_set_t;
 
 uid_set_t* uid_set_create(void) {
   uid_set_t* set = (uid_set_t*)osi_calloc(sizeof(uid_set_t));
+  for (size_t i = 0; i < UID_SET_MAX_UID_SLOTS; i++) {
+    set->slots[i].app_uid.store(-1, std::memory_order_relaxed);
+  }
   return set;
 }
 
 void uid_set_destroy(uid_set_t* set) {
   std::unique_lock<std::mutex> guard(set_lock);
-  uid_set_node_t* node = set->head;
+  uid_set_node_t* node = set->overflow_head;
   while (node) {
     uid_set_node_t* temp = node;
     node = node->next;
     osi_free(temp);
   }
-  set->head = NULL;
+  set->overflow_head = NULL;
   osi_free(set);
 }
 
+// Finds the slot claimed by |app_uid|, claiming the first empty slot along
+// the probe sequence when the UID is seen for the first time. Returns NULL
+// if the table is full, in which case the caller falls back to the locked
+// overflow list.
+static uid_set_slot_t* uid_set_find_or_claim_slot(uid_set_t* set,
+                                                  int32_t app_uid) {
+  // Knuth multiplicative hash, folded to the table size.
+  uint32_t start =
+      ((uint32_t)app_uid * 2654435761u) & (UID_SET_MAX_UID_SLOTS - 1);
+
+  for (size_t i = 0; i < UID_SET_MAX_UID_SLOTS; i++) {
+    uid_set_slot_t* slot =
+        &set->slots[(start + i) & (UID_SET_MAX_UID_SLOTS - 1)];
+    int32_t uid = slot->app_uid.load(std::memory_order_acquire);
+    if (uid == app_uid) return slot;
+    if (uid == -1) {
+      int32_t expected = -1;
+      if (slot->app_uid.compare_exchange_strong(expected, app_uid,
+                                                std::memory_order_acq_rel)) {
+        return slot;
+      }
+      // Another writer claimed the slot first - possibly for the same UID.
+      if (expected == app_uid) return slot;
+    }
+  }
+  return NULL;
+}
+
 // Lock in uid_set_t must be held.
 static uid_set_node_t* uid_set_find_or_create_node(uid_set_t* set,
                                                    int32_t app_uid) {
-  uid_set_node_t* node = set->head;
+  uid_set_node_t* node = set->overflow_head;
   while (node && node->data.app_uid != app_uid) {
     node = node->next;
   }
@@ -66,8 +116,8 @@ static uid_set_node_t* uid_set_find_or_create_node(uid_set_t* set,
   if (!node) {
     node = (uid_set_node_t*)osi_calloc(sizeof(uid_set_node_t));
     node->data.app_uid = app_uid;
-    node->next = set->head;
-    set->head = node;
+    node->next = set->overflow_head;
+    set->overflow_head = node;
   }
   return node;
 }
@@ -75,6 +125,12 @@ static uid_set_node_t* uid_set_find_or_create_node(uid_set_t* set,
 void uid_set_add_tx(uid_set_t* set, int32_t app_uid, uint64_t bytes) {
   if (app_uid == -1 || bytes == 0) return;
 
+  uid_set_slot_t* slot = uid_set_find_or_claim_slot(set, app_uid);
+  if (slot) {
+    slot->tx_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    return;
+  }
+
   std::unique_lock<std::mutex> guard(set_lock);
   uid_set_node_t* node = uid_set_find_or_create_node(set, app_uid);
   node->data.tx_bytes += bytes;
@@ -83,6 +139,12 @@ void uid_set_add_tx(uid_set_t* set, int32_t app_uid, uint64_t bytes) {
 void uid_set_add_rx(uid_set_t* set, int32_t app_uid, uint64_t bytes) {
   if (app_uid == -1 || bytes == 0) return;
 
+  uid_set_slot_t* slot = uid_set_find_or_claim_slot(set, app_uid);
+  if (slot) {
+    slot->rx_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    return;
+  }
+
   std::unique_lock<std::mutex> guard(set_lock);
   uid_set_node_t* node = uid_set_find_or_create_node(set, app_uid);
   node->data.rx_bytes += bytes;
@@ -91,9 +153,15 @@ void uid_set_add_rx(uid_set_t* set, int32_t app_uid, uint64_t bytes) {
 bt_uid_traffic_t* uid_set_read_and_clear(uid_set_t* set) {
   std::unique_lock<std::mutex> guard(set_lock);
 
-  // Find the length
+  // Snapshot the claimed slots so a writer claiming a new slot during the
+  // read cannot grow past the allocation; it is reported next time around.
+  int32_t uids[UID_SET_MAX_UID_SLOTS];
   size_t len = 0;
-  uid_set_node_t* node = set->head;
+  for (size_t i = 0; i < UID_SET_MAX_UID_SLOTS; i++) {
+    uids[i] = set->slots[i].app_uid.load(std::memory_order_acquire);
+    if (uids[i] != -1) len++;
+  }
+  uid_set_node_t* node = set->overflow_head;
   while (node) {
     len++;
     node = node->next;
@@ -105,7 +173,20 @@ bt_uid_traffic_t* uid_set_read_and_clear(uid_set_t* set) {
       (bt_uid_traffic_t*)osi_calloc(sizeof(bt_uid_traffic_t) * (len + 1));
 
   bt_uid_traffic_t* data = result;
-  node = set->head;
+  for (size_t i = 0; i < UID_SET_MAX_UID_SLOTS; i++) {
+    if (uids[i] == -1) continue;
+
+    // Swap the counters out without stalling the writers; bytes accounted
+    // while the snapshot runs are picked up by the next read.
+    data->app_uid = uids[i];
+    data->rx_bytes =
+        set->slots[i].rx_bytes.exchange(0, std::memory_order_relaxed);
+    data->tx_bytes =
+        set->slots[i].tx_bytes.exchange(0, std::memory_order_relaxed);
+    data++;
+  }
+
+  node = set->overflow_head;
   while (node) {
     // Copy the data.
     *data = node->data;
@@ -32,6 +32,7 @@
 #include "btif_common.h"
 #include "common/message_loop_thread.h"
 #include "device/include/controller.h"
+#include "gd/common/init_flags.h"
 #include "hci/include/btsnoop.h"
 #include "main/shim/shim.h"
 #include "osi/include/log.h"
@@ -97,6 +98,7 @@ static void event_init_stack(void* context);
 static void event_start_up_stack(void* context);
 static void event_shut_down_stack(void* context);
 static void event_clean_up_stack(std::promise<void> promise);
+static void event_reload_init_flags(std::vector<std::string> flags);
 
 static void event_signal_stack_up(void* context);
 static void event_signal_stack_down(void* context);
@@ -149,6 +151,19 @@ static void clean_up_stack() {
 
 static bool get_stack_is_running() { return stack_is_running; }
 
+static void reload_init_flags_async(const char** flags) {
+  // Copy out of the caller's array; the reload runs on the management
+  // thread after this call returns.
+  std::vector<std::string> flags_copy;
+  while (flags != nullptr && *flags != nullptr) {
+    flags_copy.emplace_back(*flags);
+    flags++;
+  }
+  management_thread.DoInThread(
+      FROM_HERE,
+      base::BindOnce(event_reload_init_flags, std::move(flags_copy)));
+}
+
 // Internal functions
 
 #ifdef STATIC_LIBBLUETOOTH
@@ -432,6 +447,16 @@ static void event_signal_stack_down(UNUSED_ATTR void* context) {
   future_ready(stack_manager_get_hack_future(), FUTURE_SUCCESS);
 }
 
+static void event_reload_init_flags(std::vector<std::string> flags) {
+  std::vector<const char*> flag_ptrs;
+  flag_ptrs.reserve(flags.size() + 1);
+  for (const auto& flag : flags) {
+    flag_ptrs.push_back(flag.c_str());
+  }
+  flag_ptrs.push_back(nullptr);
+  bluetooth::common::InitFlags::Reload(flag_ptrs.data());
+}
+
 static void ensure_manager_initialized() {
   if (management_thread.IsRunning()) return;
 
@@ -442,9 +467,9 @@ static void ensure_manager_initialized() {
   }
 }
 
-static const stack_manager_t interface = {init_stack, start_up_stack_async,
-                                          shut_down_stack_async, clean_up_stack,
-                                          get_stack_is_running};
+static const stack_manager_t interface = {
+    init_stack,           start_up_stack_async, shut_down_stack_async,
+    clean_up_stack,       get_stack_is_running, reload_init_flags_async};
 
 const stack_manager_t* stack_manager_get_interface() {
   ensure_manager_initialized();
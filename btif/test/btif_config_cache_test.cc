@@ -525,4 +525,51 @@ TEST(BtifConfigCacheTest, test_PersistentSectionCopy_Init) {
   EXPECT_TRUE(std::filesystem::remove(kTestConfigFile));
 }
 
+/* Test the dirty section tracking used for incremental (journaled) saves:
+ * 1. only persistent sections become dirty; unpaired device updates do not
+ * 2. removing a key or a whole persistent section marks it dirty
+ * 3. TakeDirtySections() drains the dirty set
+ * 4. Clear() cannot be expressed as deltas and requests a full rewrite
+ */
+TEST(BtifConfigCacheTest, test_dirty_section_tracking) {
+  BtifConfigCache test_btif_config_cache(kCapacity);
+
+  // nothing dirty on a fresh cache
+  EXPECT_FALSE(test_btif_config_cache.NeedsFullRewrite());
+  EXPECT_TRUE(test_btif_config_cache.TakeDirtySections().empty());
+
+  // unpaired device section - not persistent, so not dirty
+  test_btif_config_cache.SetString(kBtAddr1, "Name", "Headset_1");
+  EXPECT_TRUE(test_btif_config_cache.TakeDirtySections().empty());
+
+  // local section and a device gaining a link key are persistent
+  test_btif_config_cache.SetString(kBtAdapter, "Address", kBtLocalAddr);
+  test_btif_config_cache.SetString(kBtAddr1, "LinkKey", "1122334455667788");
+  auto dirty = test_btif_config_cache.TakeDirtySections();
+  EXPECT_EQ(dirty.size(), 2u);
+  EXPECT_TRUE(dirty.count(kBtAdapter));
+  EXPECT_TRUE(dirty.count(kBtAddr1));
+
+  // the dirty set was drained
+  EXPECT_TRUE(test_btif_config_cache.TakeDirtySections().empty());
+
+  // updating and removing keys in a persistent section marks it dirty again
+  test_btif_config_cache.SetInt(kBtAddr1, "Property_Int", 1);
+  EXPECT_EQ(test_btif_config_cache.TakeDirtySections().count(kBtAddr1), 1u);
+  EXPECT_TRUE(test_btif_config_cache.RemoveKey(kBtAddr1, "Property_Int"));
+  EXPECT_EQ(test_btif_config_cache.TakeDirtySections().count(kBtAddr1), 1u);
+
+  // unbonding (losing the link key) still marks the section dirty, so a
+  // removal record gets journaled
+  EXPECT_TRUE(test_btif_config_cache.RemoveKey(kBtAddr1, "LinkKey"));
+  EXPECT_EQ(test_btif_config_cache.TakeDirtySections().count(kBtAddr1), 1u);
+  EXPECT_FALSE(test_btif_config_cache.HasPersistentSection(kBtAddr1));
+
+  // wiping the cache needs a full rewrite; TakeDirtySections() resets it
+  test_btif_config_cache.Clear();
+  EXPECT_TRUE(test_btif_config_cache.NeedsFullRewrite());
+  test_btif_config_cache.TakeDirtySections();
+  EXPECT_FALSE(test_btif_config_cache.NeedsFullRewrite());
+}
+
 }  // namespace testing
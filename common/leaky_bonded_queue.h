@@ -21,6 +21,8 @@
 #include <mutex>
 #include <queue>
 
+#include "common/spill_ring_file.h"
+
 namespace bluetooth {
 
 namespace common {
@@ -78,6 +80,25 @@ class LeakyBondedQueue {
    * Pops all items from the queue
    */
   void Clear();
+  /*
+   * Serializer for spilled items: writes a compact representation of ITEM
+   * into BUF (at most BUF_LEN bytes) and returns the number of bytes
+   * written, or 0 to skip the item
+   */
+  using SpillSerializer = size_t (*)(const T& item, uint8_t* buf,
+                                     size_t buf_len);
+  /*
+   * Instead of being lost, items leaked by Enqueue() are serialized with
+   * SERIALIZER and appended to RING, which must outlive the queue. RING
+   * bounds the disk cost and rate limits the writes, so hours of history
+   * survive at no RAM cost. Pass nullptr to detach.
+   */
+  void SetSpill(SpillRingFile* ring, SpillSerializer serializer);
+  /*
+   * Number of items leaked because the queue was at capacity, whether or
+   * not they were spilled
+   */
+  uint64_t DroppedCount();
 
  private:
   // Put item in unique_ptr so that they get freed automatically when poped or
@@ -85,6 +106,9 @@ class LeakyBondedQueue {
   std::queue<std::unique_ptr<T>> queue_;
   std::mutex lock_;
   size_t capacity_;
+  uint64_t dropped_ = 0;
+  SpillRingFile* spill_ring_ = nullptr;
+  SpillSerializer spill_serializer_ = nullptr;
 };
 
 /*
@@ -103,6 +127,13 @@ template <class T>
 void LeakyBondedQueue<T>::Enqueue(T* new_item) {
   std::lock_guard<std::mutex> lock(lock_);
   if ((queue_.size() + 1) > capacity_) {
+    dropped_++;
+    if (spill_ring_ != nullptr && spill_serializer_ != nullptr) {
+      uint8_t buffer[256];
+      size_t length =
+          spill_serializer_(*queue_.front(), buffer, sizeof(buffer));
+      if (length > 0) spill_ring_->Append(buffer, (uint16_t)length);
+    }
     queue_.pop();
   }
   std::unique_ptr<T> item_ptr(new_item);
@@ -114,6 +145,7 @@ T* LeakyBondedQueue<T>::EnqueueWithPop(T* new_item) {
   std::lock_guard<std::mutex> lock(lock_);
   T* old_item = nullptr;
   if ((queue_.size() + 1) > capacity_) {
+    dropped_++;
     std::unique_ptr<T> item = std::move(queue_.front());
     queue_.pop();
     old_item = item.release();
@@ -123,6 +155,20 @@ T* LeakyBondedQueue<T>::EnqueueWithPop(T* new_item) {
   return old_item;
 }
 
+template <class T>
+void LeakyBondedQueue<T>::SetSpill(SpillRingFile* ring,
+                                   SpillSerializer serializer) {
+  std::lock_guard<std::mutex> lock(lock_);
+  spill_ring_ = ring;
+  spill_serializer_ = serializer;
+}
+
+template <class T>
+uint64_t LeakyBondedQueue<T>::DroppedCount() {
+  std::lock_guard<std::mutex> lock(lock_);
+  return dropped_;
+}
+
 template <class T>
 T* LeakyBondedQueue<T>::Dequeue() {
   std::lock_guard<std::mutex> lock(lock_);
@@ -16,8 +16,11 @@
 
 #include "message_loop_thread.h"
 
+#include <stdio.h>
 #include <sys/syscall.h>
+#include <time.h>
 #include <unistd.h>
+#include <algorithm>
 #include <thread>
 
 #include <base/strings/stringprintf.h>
@@ -31,6 +34,10 @@ namespace common {
 
 static constexpr int kRealTimeFifoSchedulingPriority = 1;
 
+// Upper bounds (exclusive, in milliseconds) of the task-latency histogram
+// buckets; the last bucket is unbounded.
+static constexpr int64_t kLatencyBucketBoundsMs[] = {1, 5, 10, 20, 50, 100};
+
 MessageLoopThread::MessageLoopThread(const std::string& thread_name)
     : MessageLoopThread(thread_name, false) {}
 
@@ -103,8 +110,30 @@ bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
                << ", from " << from_here.ToString();
     return false;
   }
-  if (!message_loop_->task_runner()->PostDelayedTask(from_here, std::move(task),
-                                                     delay)) {
+
+  uint64_t sequence =
+      posted_task_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+  size_t queue_depth =
+      sequence - executed_task_count_.load(std::memory_order_relaxed);
+  size_t high_watermark =
+      queue_depth_high_watermark_.load(std::memory_order_relaxed);
+  while (queue_depth > high_watermark &&
+         !queue_depth_high_watermark_.compare_exchange_weak(
+             high_watermark, queue_depth, std::memory_order_relaxed))
+    ;
+
+  // Delayed tasks are not sampled: their post-to-run time is dominated by
+  // the requested delay, not by queue backlog.
+  bool sample_latency =
+      delay.is_zero() && (sequence % kLatencySampleInterval == 0);
+  base::TimeTicks post_time =
+      sample_latency ? base::TimeTicks::Now() : base::TimeTicks();
+
+  if (!message_loop_->task_runner()->PostDelayedTask(
+          from_here,
+          base::BindOnce(&MessageLoopThread::RunTask, base::Unretained(this),
+                         std::move(task), post_time, from_here),
+          delay)) {
     LOG(ERROR) << __func__
                << ": failed to post task to message loop for thread " << *this
                << ", from " << from_here.ToString();
@@ -113,6 +142,131 @@ bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
   return true;
 }
 
+static uint64_t thread_cputime_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+void MessageLoopThread::RunTask(base::OnceClosure task,
+                                base::TimeTicks post_time,
+                                base::Location from_here) {
+  if (!post_time.is_null()) {
+    int64_t latency_ms = (base::TimeTicks::Now() - post_time).InMilliseconds();
+    size_t bucket = 0;
+    while (bucket < kNumLatencyBuckets - 1 &&
+           latency_ms >= kLatencyBucketBoundsMs[bucket])
+      bucket++;
+    latency_buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  uint64_t cpu_start_us = thread_cputime_us();
+  std::move(task).Run();
+  RecordTaskCpu(from_here, thread_cputime_us() - cpu_start_us);
+  executed_task_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MessageLoopThread::RecordTaskCpu(const base::Location& from_here,
+                                      uint64_t cpu_us) {
+  std::lock_guard<std::mutex> lock(cpu_stats_mutex_);
+  cpu_total_us_ += cpu_us;
+  if (++cpu_tasks_since_decay_ >= kCpuDecayIntervalTasks) {
+    cpu_tasks_since_decay_ = 0;
+    for (CpuSite& site : cpu_sites_) {
+      site.cpu_us /= 2;
+      site.runs /= 2;
+      if (site.cpu_us == 0) site.function_name = nullptr;
+    }
+    cpu_total_us_ /= 2;
+    cpu_untracked_us_ /= 2;
+  }
+
+  CpuSite* free_slot = nullptr;
+  for (CpuSite& site : cpu_sites_) {
+    // base::Location strings are literals, so pointer equality is enough.
+    if (site.function_name == from_here.function_name() &&
+        site.line == from_here.line_number()) {
+      site.cpu_us += cpu_us;
+      site.runs++;
+      return;
+    }
+    if (site.function_name == nullptr && free_slot == nullptr)
+      free_slot = &site;
+  }
+  if (free_slot != nullptr) {
+    free_slot->function_name = from_here.function_name();
+    free_slot->file_name = from_here.file_name();
+    free_slot->line = from_here.line_number();
+    free_slot->cpu_us = cpu_us;
+    free_slot->runs = 1;
+    return;
+  }
+  cpu_untracked_us_ += cpu_us;
+}
+
+uint64_t MessageLoopThread::GetPostedTaskCount() const {
+  return posted_task_count_.load(std::memory_order_relaxed);
+}
+
+uint64_t MessageLoopThread::GetExecutedTaskCount() const {
+  return executed_task_count_.load(std::memory_order_relaxed);
+}
+
+size_t MessageLoopThread::GetQueueDepthHighWatermark() const {
+  return queue_depth_high_watermark_.load(std::memory_order_relaxed);
+}
+
+void MessageLoopThread::DumpStatistics(int fd) const {
+  dprintf(fd, "\nThread %s run-queue statistics:\n", thread_name_.c_str());
+  dprintf(fd, "  Tasks posted/executed: %llu / %llu\n",
+          (unsigned long long)GetPostedTaskCount(),
+          (unsigned long long)GetExecutedTaskCount());
+  dprintf(fd, "  Queue depth high watermark: %zu\n",
+          GetQueueDepthHighWatermark());
+  dprintf(fd, "  Sampled task latency (1 in %llu tasks):\n",
+          (unsigned long long)kLatencySampleInterval);
+  for (size_t i = 0; i < kNumLatencyBuckets; ++i) {
+    if (i < kNumLatencyBuckets - 1)
+      dprintf(fd, "    < %3lld ms: %llu\n",
+              (long long)kLatencyBucketBoundsMs[i],
+              (unsigned long long)latency_buckets_[i].load());
+    else
+      dprintf(fd, "    >= %2lld ms: %llu\n",
+              (long long)kLatencyBucketBoundsMs[i - 1],
+              (unsigned long long)latency_buckets_[i].load());
+  }
+
+  std::array<CpuSite, kCpuSiteSlots> sites;
+  uint64_t total_us;
+  uint64_t untracked_us;
+  {
+    std::lock_guard<std::mutex> lock(cpu_stats_mutex_);
+    sites = cpu_sites_;
+    total_us = cpu_total_us_;
+    untracked_us = cpu_untracked_us_;
+  }
+  if (total_us == 0) return;
+
+  std::sort(
+      sites.begin(), sites.end(),
+      [](const CpuSite& a, const CpuSite& b) { return a.cpu_us > b.cpu_us; });
+  dprintf(fd, "  CPU by posting site (decayed, total %llu ms):\n",
+          (unsigned long long)(total_us / 1000));
+  size_t printed = 0;
+  for (const CpuSite& site : sites) {
+    if (site.function_name == nullptr || site.cpu_us == 0) continue;
+    if (++printed > 10) break;
+    dprintf(fd, "    %5.1f%% %9llu us %7llu runs  %s (%s:%d)\n",
+            100.0 * (double)site.cpu_us / (double)total_us,
+            (unsigned long long)site.cpu_us, (unsigned long long)site.runs,
+            site.function_name, site.file_name, site.line);
+  }
+  if (untracked_us != 0)
+    dprintf(fd, "    %5.1f%% %9llu us untracked (site table full)\n",
+            100.0 * (double)untracked_us / (double)total_us,
+            (unsigned long long)untracked_us);
+}
+
 void MessageLoopThread::ShutDown() {
   {
     if (is_main_ && init_flags::gd_rust_is_enabled()) {
@@ -17,8 +17,11 @@
 #pragma once
 
 #include <unistd.h>
+#include <array>
+#include <atomic>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 
@@ -166,6 +169,28 @@ class MessageLoopThread final {
   bool DoInThreadDelayed(const base::Location& from_here,
                          base::OnceClosure task, const base::TimeDelta& delay);
 
+  /**
+   * Get the number of tasks posted to this thread since start-up
+   */
+  uint64_t GetPostedTaskCount() const;
+
+  /**
+   * Get the number of tasks this thread has finished executing since start-up
+   */
+  uint64_t GetExecutedTaskCount() const;
+
+  /**
+   * Get the largest backlog (posted but not yet executed tasks) observed at
+   * post time since start-up
+   */
+  size_t GetQueueDepthHighWatermark() const;
+
+  /**
+   * Dump the task counters and the sampled task-latency histogram in
+   * user-readable text format to the |fd| file descriptor. |fd| must be valid
+   */
+  void DumpStatistics(int fd) const;
+
  private:
   /**
    * Static method to run the thread
@@ -179,6 +204,24 @@ class MessageLoopThread final {
   static void RunThread(MessageLoopThread* context,
                         std::promise<void> start_up_promise);
 
+  /**
+   * Wrapper that runs every posted task so the executed counter, the CPU
+   * attribution table and, for sampled tasks, the post-to-run latency
+   * histogram stay up to date.
+   *
+   * @param task the user task to run
+   * @param post_time time the task was posted for sampled tasks, null
+   * otherwise
+   * @param from_here posting site, used as the CPU attribution key
+   */
+  void RunTask(base::OnceClosure task, base::TimeTicks post_time,
+               base::Location from_here);
+
+  /**
+   * Charge |cpu_us| of thread CPU time to the posting site |from_here|
+   */
+  void RecordTaskCpu(const base::Location& from_here, uint64_t cpu_us);
+
   /**
    * Actual method to run the thread, blocking until ShutDown() is called
    *
@@ -198,6 +241,38 @@ class MessageLoopThread final {
   base::WeakPtrFactory<MessageLoopThread> weak_ptr_factory_;
   bool shutting_down_;
   bool is_main_;
+
+  // Run-queue statistics; updated lock-free on the post and run paths.
+  // Only every |kLatencySampleInterval|-th undelayed task is timed to keep
+  // the hot path cheap.
+  static constexpr uint64_t kLatencySampleInterval = 16;
+  static constexpr size_t kNumLatencyBuckets = 7;
+  std::atomic<uint64_t> posted_task_count_{0};
+  std::atomic<uint64_t> executed_task_count_{0};
+  std::atomic<size_t> queue_depth_high_watermark_{0};
+  std::array<std::atomic<uint64_t>, kNumLatencyBuckets> latency_buckets_{};
+
+  // Per-posting-site CPU attribution. Every task is timed with
+  // CLOCK_THREAD_CPUTIME_ID and charged to its base::Location; counters
+  // are halved every |kCpuDecayIntervalTasks| tasks so recent consumers
+  // dominate the dump, and sites whose time decays to zero free their
+  // slot. Sites that arrive while the table is full land in the
+  // untracked bucket.
+  static constexpr size_t kCpuSiteSlots = 32;
+  static constexpr uint64_t kCpuDecayIntervalTasks = 8192;
+  struct CpuSite {
+    const char* function_name = nullptr;
+    const char* file_name = nullptr;
+    int line = 0;
+    uint64_t cpu_us = 0;
+    uint64_t runs = 0;
+  };
+  mutable std::mutex cpu_stats_mutex_;
+  std::array<CpuSite, kCpuSiteSlots> cpu_sites_{};
+  uint64_t cpu_total_us_ = 0;
+  uint64_t cpu_untracked_us_ = 0;
+  uint64_t cpu_tasks_since_decay_ = 0;
+
   ::rust::Box<shim::rust::MessageLoopThread>* rust_thread_ = nullptr;
 
   DISALLOW_COPY_AND_ASSIGN(MessageLoopThread);
@@ -328,3 +328,26 @@ TEST_F(MessageLoopThreadTest, shut_down_start_up_multi_thread) {
   auto thread = std::thread(&MessageLoopThread::StartUp, &message_loop_thread);
   thread.join();
 }
+
+TEST_F(MessageLoopThreadTest, test_task_counters) {
+  std::string name = "test_thread";
+  MessageLoopThread message_loop_thread(name);
+  message_loop_thread.StartUp();
+
+  constexpr uint64_t kNumTasks = 50;
+  std::promise<void> last_task_promise;
+  std::future<void> last_task_future = last_task_promise.get_future();
+  for (uint64_t i = 0; i < kNumTasks - 1; i++) {
+    message_loop_thread.DoInThread(FROM_HERE, base::BindOnce([]() {}));
+  }
+  message_loop_thread.DoInThread(
+      FROM_HERE, base::BindOnce(
+                     [](std::promise<void> promise) { promise.set_value(); },
+                     std::move(last_task_promise)));
+  last_task_future.wait();
+
+  ASSERT_EQ(message_loop_thread.GetPostedTaskCount(), kNumTasks);
+  ASSERT_EQ(message_loop_thread.GetExecutedTaskCount(), kNumTasks);
+  ASSERT_GE(message_loop_thread.GetQueueDepthHighWatermark(), (size_t)1);
+  message_loop_thread.ShutDown();
+}
@@ -38,6 +38,7 @@
 #include "address_obfuscator.h"
 #include "leaky_bonded_queue.h"
 #include "metric_id_allocator.h"
+#include "sharded_counter.h"
 #include "metrics.h"
 #include "time_util.h"
 
@@ -285,6 +286,10 @@ struct BluetoothMetricsLogger::impl {
   std::unique_ptr<LeakyBondedQueue<PairEvent>> pair_event_queue_;
   std::unique_ptr<LeakyBondedQueue<WakeEvent>> wake_event_queue_;
   std::unique_ptr<LeakyBondedQueue<ScanEvent>> scan_event_queue_;
+  /* Lock-free event tallies, drained into bluetooth_log_ by Build() */
+  ShardedCounter num_pair_event_counter_;
+  ShardedCounter num_wake_event_counter_;
+  ShardedCounter num_scan_event_counter_;
 };
 
 BluetoothMetricsLogger::BluetoothMetricsLogger()
@@ -302,11 +307,7 @@ void BluetoothMetricsLogger::LogPairEvent(uint32_t disconnect_reason,
   event->set_disconnect_reason(disconnect_reason);
   event->set_event_time_millis(timestamp_ms);
   pimpl_->pair_event_queue_->Enqueue(event);
-  {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->bluetooth_log_lock_);
-    pimpl_->bluetooth_log_->set_num_pair_event(
-        pimpl_->bluetooth_log_->num_pair_event() + 1);
-  }
+  pimpl_->num_pair_event_counter_.Add(1);
 }
 
 void BluetoothMetricsLogger::LogWakeEvent(wake_event_type_t type,
@@ -319,11 +320,7 @@ void BluetoothMetricsLogger::LogWakeEvent(wake_event_type_t type,
   event->set_name(name);
   event->set_event_time_millis(timestamp_ms);
   pimpl_->wake_event_queue_->Enqueue(event);
-  {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->bluetooth_log_lock_);
-    pimpl_->bluetooth_log_->set_num_wake_event(
-        pimpl_->bluetooth_log_->num_wake_event() + 1);
-  }
+  pimpl_->num_wake_event_counter_.Add(1);
 }
 
 void BluetoothMetricsLogger::LogScanEvent(bool start,
@@ -341,11 +338,7 @@ void BluetoothMetricsLogger::LogScanEvent(bool start,
   event->set_number_results(results);
   event->set_event_time_millis(timestamp_ms);
   pimpl_->scan_event_queue_->Enqueue(event);
-  {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->bluetooth_log_lock_);
-    pimpl_->bluetooth_log_->set_num_scan_event(
-        pimpl_->bluetooth_log_->num_scan_event() + 1);
-  }
+  pimpl_->num_scan_event_counter_.Add(1);
 }
 
 void BluetoothMetricsLogger::LogBluetoothSessionStart(
@@ -531,6 +524,22 @@ void BluetoothMetricsLogger::Build() {
     bluetooth_log->mutable_wake_event()->AddAllocated(
         pimpl_->wake_event_queue_->Dequeue());
   }
+  /* Fold this epoch's lock-free tallies into the log */
+  int64_t num_pair_event = pimpl_->num_pair_event_counter_.ReadAndReset();
+  if (num_pair_event > 0) {
+    bluetooth_log->set_num_pair_event(bluetooth_log->num_pair_event() +
+                                      num_pair_event);
+  }
+  int64_t num_wake_event = pimpl_->num_wake_event_counter_.ReadAndReset();
+  if (num_wake_event > 0) {
+    bluetooth_log->set_num_wake_event(bluetooth_log->num_wake_event() +
+                                      num_wake_event);
+  }
+  int64_t num_scan_event = pimpl_->num_scan_event_counter_.ReadAndReset();
+  if (num_scan_event > 0) {
+    bluetooth_log->set_num_scan_event(bluetooth_log->num_scan_event() +
+                                      num_scan_event);
+  }
   for (size_t i = 0; i < HeadsetProfileType_ARRAYSIZE; ++i) {
     int num_times_connected = pimpl_->headset_profile_connection_counts_[i];
     if (HeadsetProfileType_IsValid(i) && num_times_connected > 0) {
@@ -558,6 +567,9 @@ void BluetoothMetricsLogger::ResetSession() {
 
 void BluetoothMetricsLogger::ResetLog() {
   std::lock_guard<std::recursive_mutex> lock(pimpl_->bluetooth_log_lock_);
+  pimpl_->num_pair_event_counter_.ReadAndReset();
+  pimpl_->num_wake_event_counter_.ReadAndReset();
+  pimpl_->num_scan_event_counter_.ReadAndReset();
   pimpl_->bluetooth_log_->Clear();
 }
 
@@ -120,6 +120,14 @@ bool RepeatingTimer::IsScheduled() const {
   return message_loop_thread_ != nullptr && message_loop_thread_->IsRunning();
 }
 
+// This runs on message loop thread
+uint64_t RepeatingTimer::GetNominalTickTimeUs() const {
+  std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+  // RunTask advances the expected time before running the task, so the
+  // tick being executed sits exactly one period earlier.
+  return expected_time_next_task_us_ - period_.InMicroseconds();
+}
+
 // This runs on message loop thread
 void RepeatingTimer::RunTask() {
   if (message_loop_thread_ == nullptr || !message_loop_thread_->IsRunning()) {
@@ -72,6 +72,15 @@ class RepeatingTimer final {
    */
   bool IsScheduled() const;
 
+  /**
+   * Get the absolute nominal time of the tick currently being executed, in
+   * microseconds on the clock boot time. Only meaningful when called from
+   * within the scheduled task. The value advances by exactly one period per
+   * tick regardless of dispatch jitter, so periodic work paced off it does
+   * not inherit scheduling noise.
+   */
+  uint64_t GetNominalTickTimeUs() const;
+
  private:
   base::WeakPtr<MessageLoopThread> message_loop_thread_;
   base::CancelableClosure task_wrapper_;
@@ -0,0 +1,91 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace bluetooth {
+
+namespace common {
+
+/*
+ *   ShardedCounter
+ *
+ * - A 64-bit counter split across several cache-line sized shards. Each
+ *   thread increments its own shard, picked once per thread, so bumping the
+ *   counter from a data-path thread never contends a lock or bounces a
+ *   cache line shared with another writer.
+ * - Reads sum all shards with relaxed ordering. The result is an eventually
+ *   consistent snapshot: increments racing with the read may or may not be
+ *   included, which is acceptable for metrics.
+ * - Readers are expected to drain the counter with ReadAndReset() at
+ *   aggregation time (e.g. when a metrics snapshot is built) rather than
+ *   after every increment.
+ */
+class ShardedCounter {
+ public:
+  /* Add DELTA to this thread's shard */
+  void Add(int64_t delta) {
+    shards_[ShardIndex()].value.fetch_add(delta, std::memory_order_relaxed);
+  }
+  /*
+   * Sum all shards without modifying them. Concurrent increments may or may
+   * not be observed.
+   */
+  int64_t Read() const {
+    int64_t sum = 0;
+    for (const Shard& shard : shards_) {
+      sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+  /*
+   * Sum all shards and zero them, returning the accumulated count for this
+   * epoch. Increments racing with the reset are carried into the next epoch.
+   */
+  int64_t ReadAndReset() {
+    int64_t sum = 0;
+    for (Shard& shard : shards_) {
+      sum += shard.value.exchange(0, std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+ private:
+  static constexpr size_t kNumShards = 8;
+
+  struct alignas(64) Shard {
+    std::atomic<int64_t> value{0};
+  };
+
+  /* Threads are spread round-robin across shards on first use */
+  static size_t ShardIndex() {
+    static std::atomic<size_t> next_shard{0};
+    thread_local size_t shard_index =
+        next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+    return shard_index;
+  }
+
+  Shard shards_[kNumShards];
+};
+
+}  // namespace common
+
+}  // namespace bluetooth
@@ -0,0 +1,67 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "common/sharded_counter.h"
+
+namespace testing {
+
+using bluetooth::common::ShardedCounter;
+
+TEST(ShardedCounterTest, add_and_read) {
+  ShardedCounter counter;
+  EXPECT_EQ(0, counter.Read());
+  counter.Add(1);
+  counter.Add(41);
+  EXPECT_EQ(42, counter.Read());
+  counter.Add(-2);
+  EXPECT_EQ(40, counter.Read());
+}
+
+TEST(ShardedCounterTest, read_and_reset_starts_new_epoch) {
+  ShardedCounter counter;
+  counter.Add(5);
+  EXPECT_EQ(5, counter.ReadAndReset());
+  EXPECT_EQ(0, counter.Read());
+  counter.Add(7);
+  EXPECT_EQ(7, counter.ReadAndReset());
+}
+
+TEST(ShardedCounterTest, concurrent_increments_are_not_lost) {
+  static constexpr int kNumThreads = 16;
+  static constexpr int kIncrementsPerThread = 10000;
+  ShardedCounter counter;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([&counter]() {
+      for (int j = 0; j < kIncrementsPerThread; j++) {
+        counter.Add(1);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(kNumThreads * kIncrementsPerThread, counter.Read());
+}
+
+}  // namespace testing
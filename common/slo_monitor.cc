@@ -0,0 +1,216 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "slo_monitor.h"
+
+#include <base/logging.h>
+#include <stdio.h>
+
+#include "time_util.h"
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+constexpr uint64_t kBucketBoundsMs[] = {10,   20,   50,   100,  200,   500,
+                                        1000, 2000, 5000, 10000, 20000, 0};
+
+// Default latency targets. These are deliberately conservative bounds on
+// what a user perceives as "done immediately"; tune per product if needed.
+constexpr uint64_t kDefaultTargetMs[] = {
+    8000,  // kPairing: includes numeric comparison UI round trip
+    1000,  // kA2dpStart: audio must flow before the track audibly starts
+    3000,  // kGattConnect: direct connection to an advertising peer
+};
+
+// Violations are logged at most once per operation per this interval; the
+// histograms keep the full count.
+constexpr uint64_t kViolationLogIntervalMs = 10000;
+
+const char* OperationName(SloOperation operation) {
+  switch (operation) {
+    case SloOperation::kPairing:
+      return "Pairing";
+    case SloOperation::kA2dpStart:
+      return "A2DP start";
+    case SloOperation::kGattConnect:
+      return "GATT connect";
+    default:
+      return "Unknown";
+  }
+}
+
+}  // namespace
+
+static_assert(sizeof(kBucketBoundsMs) / sizeof(kBucketBoundsMs[0]) == 12,
+              "bucket bounds must match SloMonitor::kNumBuckets");
+
+SloMonitor::SloMonitor() {
+  for (size_t i = 0; i < kNumOperations; i++) {
+    target_ms_[i] = kDefaultTargetMs[i];
+  }
+}
+
+void SloMonitor::OperationBegin(SloOperation operation,
+                                const RawAddress& address) {
+  size_t op = static_cast<size_t>(operation);
+  if (op >= kNumOperations) return;
+
+  uint64_t now_ms = time_get_os_boottime_ms();
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_[op][address] = now_ms;
+}
+
+void SloMonitor::OperationEnd(SloOperation operation,
+                              const RawAddress& address) {
+  size_t op = static_cast<size_t>(operation);
+  if (op >= kNumOperations) return;
+
+  uint64_t now_ms = time_get_os_boottime_ms();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = pending_[op].find(address);
+  if (it == pending_[op].end()) return;
+
+  uint64_t latency_ms = now_ms - it->second;
+  pending_[op].erase(it);
+  RecordLatency(operation, latency_ms, address, now_ms);
+}
+
+void SloMonitor::OperationCancel(SloOperation operation,
+                                 const RawAddress& address) {
+  size_t op = static_cast<size_t>(operation);
+  if (op >= kNumOperations) return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_[op].erase(address);
+}
+
+void SloMonitor::RecordLatency(SloOperation operation, uint64_t latency_ms,
+                               const RawAddress& address, uint64_t now_ms) {
+  size_t op = static_cast<size_t>(operation);
+  OperationStats& stats = stats_[op];
+
+  stats.count++;
+  stats.sum_ms += latency_ms;
+  if (latency_ms > stats.max_ms) stats.max_ms = latency_ms;
+
+  size_t bucket = 0;
+  while (bucket < kNumBuckets - 1 && latency_ms > kBucketBoundsMs[bucket]) {
+    bucket++;
+  }
+  stats.buckets[bucket]++;
+
+  if (latency_ms <= target_ms_[op]) return;
+
+  stats.violations++;
+  if (now_ms - stats.last_violation_log_ms < kViolationLogIntervalMs &&
+      stats.last_violation_log_ms != 0) {
+    return;
+  }
+  stats.last_violation_log_ms = now_ms;
+  LOG(WARNING) << __func__ << ": " << OperationName(operation) << " for "
+               << address << " took " << latency_ms << " ms, target "
+               << target_ms_[op] << " ms (" << stats.violations << "/"
+               << stats.count << " over target so far)";
+}
+
+uint64_t SloMonitor::EstimatePercentileMs(const OperationStats& stats,
+                                          double fraction) {
+  if (stats.count == 0) return 0;
+
+  uint64_t threshold = static_cast<uint64_t>(stats.count * fraction);
+  if (threshold == 0) threshold = 1;
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    seen += stats.buckets[i];
+    if (seen >= threshold) {
+      // The last bucket is open-ended; the recorded maximum is the best
+      // bound we have for it.
+      if (i == kNumBuckets - 1) return stats.max_ms;
+      return kBucketBoundsMs[i];
+    }
+  }
+  return stats.max_ms;
+}
+
+void SloMonitor::Dump(int fd) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  dprintf(fd, "\nOperation latency SLOs:\n");
+  for (size_t op = 0; op < kNumOperations; op++) {
+    const OperationStats& stats = stats_[op];
+    dprintf(fd,
+            "  %-12s: target %llu ms, count %llu, violations %llu, "
+            "pending %zu\n",
+            OperationName(static_cast<SloOperation>(op)),
+            (unsigned long long)target_ms_[op], (unsigned long long)stats.count,
+            (unsigned long long)stats.violations, pending_[op].size());
+    if (stats.count == 0) continue;
+    dprintf(fd,
+            "    avg %llu ms, max %llu ms, ~P95 <= %llu ms, "
+            "~P99 <= %llu ms\n",
+            (unsigned long long)(stats.sum_ms / stats.count),
+            (unsigned long long)stats.max_ms,
+            (unsigned long long)EstimatePercentileMs(stats, 0.95),
+            (unsigned long long)EstimatePercentileMs(stats, 0.99));
+    dprintf(fd, "    histogram (ms):");
+    for (size_t i = 0; i < kNumBuckets; i++) {
+      if (stats.buckets[i] == 0) continue;
+      if (i == kNumBuckets - 1) {
+        dprintf(fd, " >%llu:%llu", (unsigned long long)kBucketBoundsMs[i - 1],
+                (unsigned long long)stats.buckets[i]);
+      } else {
+        dprintf(fd, " <=%llu:%llu", (unsigned long long)kBucketBoundsMs[i],
+                (unsigned long long)stats.buckets[i]);
+      }
+    }
+    dprintf(fd, "\n");
+  }
+}
+
+void SloMonitor::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t op = 0; op < kNumOperations; op++) {
+    stats_[op] = OperationStats();
+    target_ms_[op] = kDefaultTargetMs[op];
+    pending_[op].clear();
+  }
+}
+
+SloMonitor::OperationSnapshot SloMonitor::GetSnapshot(SloOperation operation) {
+  OperationSnapshot snapshot;
+  size_t op = static_cast<size_t>(operation);
+  if (op >= kNumOperations) return snapshot;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  snapshot.count = stats_[op].count;
+  snapshot.violations = stats_[op].violations;
+  snapshot.max_ms = stats_[op].max_ms;
+  return snapshot;
+}
+
+void SloMonitor::SetTargetMsForTesting(SloOperation operation,
+                                       uint64_t target_ms) {
+  size_t op = static_cast<size_t>(operation);
+  if (op >= kNumOperations) return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  target_ms_[op] = target_ms;
+}
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include "raw_address.h"
+
+namespace bluetooth {
+namespace common {
+
+// User-facing operations with a latency objective. Each operation is
+// timestamped from existing state transitions in the stack; nothing here
+// drives the operations themselves.
+enum class SloOperation : size_t {
+  kPairing = 0,      // create bond -> bond state BONDED
+  kA2dpStart = 1,    // stream start request -> streaming state entered
+  kGattConnect = 2,  // direct connect request -> connection complete
+  kNumOperations = 3,
+};
+
+// Measures how long user-facing operations take against fixed latency
+// targets. Completed operations are accumulated into per-operation
+// histograms that are printed in the debug dump (so P95/P99 can be read
+// without log scraping), and target violations are reported through a
+// rate-limited warning log.
+//
+// All methods are thread-safe and cheap enough to call from state machine
+// transitions; an unmatched End() or Cancel() is a no-op.
+class SloMonitor {
+ public:
+  // Snapshot of one operation's counters, mainly for tests and dumps.
+  struct OperationSnapshot {
+    uint64_t count = 0;
+    uint64_t violations = 0;
+    uint64_t max_ms = 0;
+  };
+
+  static SloMonitor* GetInstance() {
+    static SloMonitor* instance = new SloMonitor();
+    return instance;
+  }
+
+  // Marks the start of |operation| for |address|. A second Begin() for the
+  // same pair restarts the measurement.
+  void OperationBegin(SloOperation operation, const RawAddress& address);
+
+  // Completes |operation| for |address| and records its latency. No-op if
+  // there is no matching Begin().
+  void OperationEnd(SloOperation operation, const RawAddress& address);
+
+  // Drops a pending |operation| without recording it, e.g. when the
+  // operation failed or was aborted and its latency is meaningless.
+  void OperationCancel(SloOperation operation, const RawAddress& address);
+
+  // Prints the per-operation histograms and derived percentiles to |fd|.
+  void Dump(int fd);
+
+  // Clears all counters and pending operations.
+  void Reset();
+
+  OperationSnapshot GetSnapshot(SloOperation operation);
+
+  // Overrides the latency target of |operation|, so tests can force
+  // violations without sleeping.
+  void SetTargetMsForTesting(SloOperation operation, uint64_t target_ms);
+
+ private:
+  SloMonitor();
+  SloMonitor(const SloMonitor&) = delete;
+  SloMonitor& operator=(const SloMonitor&) = delete;
+
+  static constexpr size_t kNumOperations =
+      static_cast<size_t>(SloOperation::kNumOperations);
+  // Upper bounds of the histogram buckets in milliseconds; the last bucket
+  // is open-ended.
+  static constexpr size_t kNumBuckets = 12;
+
+  struct OperationStats {
+    uint64_t count = 0;
+    uint64_t violations = 0;
+    uint64_t sum_ms = 0;
+    uint64_t max_ms = 0;
+    uint64_t buckets[kNumBuckets] = {};
+    uint64_t last_violation_log_ms = 0;
+  };
+
+  void RecordLatency(SloOperation operation, uint64_t latency_ms,
+                     const RawAddress& address, uint64_t now_ms);
+  // Returns the upper bound of the bucket below which |fraction| of the
+  // recorded samples fall; 0 when nothing was recorded yet.
+  static uint64_t EstimatePercentileMs(const OperationStats& stats,
+                                       double fraction);
+
+  std::mutex mutex_;
+  OperationStats stats_[kNumOperations];
+  uint64_t target_ms_[kNumOperations];
+  std::unordered_map<RawAddress, uint64_t> pending_[kNumOperations];
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/slo_monitor.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "raw_address.h"
+
+using bluetooth::common::SloMonitor;
+using bluetooth::common::SloOperation;
+
+namespace {
+
+const RawAddress kPeer = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x66}};
+const RawAddress kOtherPeer = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x77}};
+
+}  // namespace
+
+class SloMonitorTest : public ::testing::Test {
+ protected:
+  void SetUp() override { SloMonitor::GetInstance()->Reset(); }
+  void TearDown() override { SloMonitor::GetInstance()->Reset(); }
+};
+
+TEST_F(SloMonitorTest, begin_end_records_sample) {
+  SloMonitor* monitor = SloMonitor::GetInstance();
+
+  monitor->OperationBegin(SloOperation::kPairing, kPeer);
+  monitor->OperationEnd(SloOperation::kPairing, kPeer);
+
+  auto snapshot = monitor->GetSnapshot(SloOperation::kPairing);
+  EXPECT_EQ(1u, snapshot.count);
+  EXPECT_EQ(0u, snapshot.violations);
+}
+
+TEST_F(SloMonitorTest, unmatched_end_is_ignored) {
+  SloMonitor* monitor = SloMonitor::GetInstance();
+
+  monitor->OperationEnd(SloOperation::kA2dpStart, kPeer);
+
+  auto snapshot = monitor->GetSnapshot(SloOperation::kA2dpStart);
+  EXPECT_EQ(0u, snapshot.count);
+}
+
+TEST_F(SloMonitorTest, cancel_drops_pending_operation) {
+  SloMonitor* monitor = SloMonitor::GetInstance();
+
+  monitor->OperationBegin(SloOperation::kGattConnect, kPeer);
+  monitor->OperationCancel(SloOperation::kGattConnect, kPeer);
+  monitor->OperationEnd(SloOperation::kGattConnect, kPeer);
+
+  auto snapshot = monitor->GetSnapshot(SloOperation::kGattConnect);
+  EXPECT_EQ(0u, snapshot.count);
+}
+
+TEST_F(SloMonitorTest, operations_tracked_per_peer) {
+  SloMonitor* monitor = SloMonitor::GetInstance();
+
+  monitor->OperationBegin(SloOperation::kPairing, kPeer);
+  monitor->OperationBegin(SloOperation::kPairing, kOtherPeer);
+  monitor->OperationEnd(SloOperation::kPairing, kPeer);
+  monitor->OperationEnd(SloOperation::kPairing, kOtherPeer);
+
+  auto snapshot = monitor->GetSnapshot(SloOperation::kPairing);
+  EXPECT_EQ(2u, snapshot.count);
+}
+
+TEST_F(SloMonitorTest, violation_counted_when_over_target) {
+  SloMonitor* monitor = SloMonitor::GetInstance();
+  monitor->SetTargetMsForTesting(SloOperation::kA2dpStart, 0);
+
+  monitor->OperationBegin(SloOperation::kA2dpStart, kPeer);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  monitor->OperationEnd(SloOperation::kA2dpStart, kPeer);
+
+  auto snapshot = monitor->GetSnapshot(SloOperation::kA2dpStart);
+  EXPECT_EQ(1u, snapshot.count);
+  EXPECT_EQ(1u, snapshot.violations);
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "spill_ring_file.h"
+
+#include <base/logging.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "time_util.h"
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x52505342;  // "BSPR"
+constexpr uint32_t kVersion = 1;
+constexpr uint8_t kRecordMarker = 0xA5;
+constexpr size_t kRecordOverhead = 1 + sizeof(uint16_t);
+
+}  // namespace
+
+SpillRingFile::SpillRingFile(const std::string& path, size_t data_size,
+                             uint32_t max_records_per_sec)
+    : path_(path),
+      data_size_(data_size),
+      max_records_per_sec_(max_records_per_sec) {}
+
+SpillRingFile::~SpillRingFile() {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (header_ != nullptr) {
+    munmap(header_, sizeof(Header) + data_size_);
+    header_ = nullptr;
+    data_ = nullptr;
+  }
+}
+
+bool SpillRingFile::Open() {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (header_ != nullptr) return true;
+
+  int fd = open(path_.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP);
+  if (fd < 0) {
+    LOG(WARNING) << __func__ << ": unable to open " << path_ << ": "
+                 << strerror(errno);
+    return false;
+  }
+
+  const size_t file_size = sizeof(Header) + data_size_;
+  struct stat st;
+  bool fresh = fstat(fd, &st) != 0 || (size_t)st.st_size != file_size;
+  if (ftruncate(fd, file_size) != 0) {
+    LOG(WARNING) << __func__ << ": unable to size " << path_ << ": "
+                 << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  void* map =
+      mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    LOG(WARNING) << __func__ << ": unable to map " << path_ << ": "
+                 << strerror(errno);
+    return false;
+  }
+
+  header_ = static_cast<Header*>(map);
+  data_ = reinterpret_cast<uint8_t*>(header_ + 1);
+
+  if (fresh || header_->magic != kMagic || header_->version != kVersion ||
+      header_->data_size != data_size_ ||
+      header_->write_offset >= data_size_) {
+    /* start over rather than mix framings; history does not survive a
+     * geometry or version change */
+    memset(header_, 0, file_size);
+    header_->magic = kMagic;
+    header_->version = kVersion;
+    header_->data_size = data_size_;
+  }
+  return true;
+}
+
+void SpillRingFile::PutByte(uint8_t byte) {
+  data_[header_->write_offset] = byte;
+  header_->write_offset = (header_->write_offset + 1) % data_size_;
+}
+
+bool SpillRingFile::Append(const uint8_t* data, uint16_t length) {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (header_ == nullptr || length == 0 ||
+      kRecordOverhead + (size_t)length >= data_size_) {
+    return false;
+  }
+
+  uint64_t now_ms = time_get_os_boottime_ms();
+  if (now_ms - rate_window_start_ms_ >= 1000) {
+    rate_window_start_ms_ = now_ms;
+    rate_window_records_ = 0;
+  }
+  if (rate_window_records_ >= max_records_per_sec_) {
+    records_rate_limited_++;
+    return false;
+  }
+  rate_window_records_++;
+
+  PutByte(kRecordMarker);
+  PutByte((uint8_t)(length & 0xff));
+  PutByte((uint8_t)(length >> 8));
+  for (uint16_t i = 0; i < length; i++) PutByte(data[i]);
+  header_->records++;
+  return true;
+}
+
+uint64_t SpillRingFile::RecordsWritten() const {
+  std::lock_guard<std::mutex> lock(lock_);
+  return header_ != nullptr ? header_->records : 0;
+}
+
+uint64_t SpillRingFile::RecordsRateLimited() const {
+  std::lock_guard<std::mutex> lock(lock_);
+  return records_rate_limited_;
+}
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace bluetooth {
+namespace common {
+
+// A fixed-size, memory-mapped ring file for compact binary records.
+//
+// Appends go through the page cache, so steady-state writes cost a memcpy
+// and no syscall; the kernel flushes the pages and the content survives a
+// process crash. The file never grows past header + data size: when the
+// write offset reaches the end of the data area it wraps to the start and
+// the oldest records are overwritten. Appends are rate limited so a
+// misbehaving source cannot wear flash or evict useful history.
+//
+// Record framing in the data area is [0xA5][uint16_t length][payload],
+// little endian, wrapping byte-wise. The header tracks the current write
+// offset so an offline reader can separate the newest records from the
+// oldest.
+class SpillRingFile {
+ public:
+  // |data_size| bytes of ring storage after the header; appends beyond
+  // |max_records_per_sec| within one second are counted and discarded.
+  SpillRingFile(const std::string& path, size_t data_size,
+                uint32_t max_records_per_sec);
+  ~SpillRingFile();
+
+  SpillRingFile(const SpillRingFile&) = delete;
+  SpillRingFile& operator=(const SpillRingFile&) = delete;
+
+  // Creates (or truncates a file whose geometry changed) and maps the ring.
+  // Returns false when the file cannot be created or mapped; Append is a
+  // counted no-op in that case.
+  bool Open();
+
+  // Appends one record. Returns false when the ring is not open, the
+  // record does not fit, or the rate limit is exceeded.
+  bool Append(const uint8_t* data, uint16_t length);
+
+  uint64_t RecordsWritten() const;
+  uint64_t RecordsRateLimited() const;
+
+ private:
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t data_size;
+    uint64_t write_offset; /* next byte to write, relative to data area */
+    uint64_t records;      /* total records appended over the file's life */
+  };
+
+  void PutByte(uint8_t byte);
+
+  const std::string path_;
+  const size_t data_size_;
+  const uint32_t max_records_per_sec_;
+
+  mutable std::mutex lock_;
+  Header* header_ = nullptr; /* start of the mapping; data area follows */
+  uint8_t* data_ = nullptr;
+  uint64_t rate_window_start_ms_ = 0;
+  uint32_t rate_window_records_ = 0;
+  uint64_t records_rate_limited_ = 0;
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <string>
+
+#include "common/leaky_bonded_queue.h"
+#include "common/spill_ring_file.h"
+
+namespace testing {
+
+using bluetooth::common::LeakyBondedQueue;
+using bluetooth::common::SpillRingFile;
+
+class SpillRingFileTest : public Test {
+ protected:
+  void SetUp() override {
+    path_ = "/tmp/spill_ring_file_test_" + std::to_string(getpid()) + ".ring";
+    unlink(path_.c_str());
+  }
+  void TearDown() override { unlink(path_.c_str()); }
+
+  std::string path_;
+};
+
+TEST_F(SpillRingFileTest, AppendAndCount) {
+  SpillRingFile ring(path_, 1024, 1000);
+  ASSERT_TRUE(ring.Open());
+  EXPECT_EQ(ring.RecordsWritten(), static_cast<uint64_t>(0));
+
+  uint8_t record[16] = {1, 2, 3, 4};
+  EXPECT_TRUE(ring.Append(record, sizeof(record)));
+  EXPECT_TRUE(ring.Append(record, sizeof(record)));
+  EXPECT_EQ(ring.RecordsWritten(), static_cast<uint64_t>(2));
+  EXPECT_EQ(ring.RecordsRateLimited(), static_cast<uint64_t>(0));
+}
+
+TEST_F(SpillRingFileTest, WrapsWithoutGrowing) {
+  const size_t data_size = 128;
+  SpillRingFile ring(path_, data_size, 100000);
+  ASSERT_TRUE(ring.Open());
+
+  uint8_t record[32] = {0};
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(ring.Append(record, sizeof(record)));
+  }
+  EXPECT_EQ(ring.RecordsWritten(), static_cast<uint64_t>(100));
+
+  struct stat st;
+  ASSERT_EQ(stat(path_.c_str(), &st), 0);
+  EXPECT_LE(static_cast<size_t>(st.st_size), data_size + 64);
+}
+
+TEST_F(SpillRingFileTest, RejectsOversizedRecord) {
+  SpillRingFile ring(path_, 64, 1000);
+  ASSERT_TRUE(ring.Open());
+
+  uint8_t record[128] = {0};
+  EXPECT_FALSE(ring.Append(record, sizeof(record)));
+  EXPECT_EQ(ring.RecordsWritten(), static_cast<uint64_t>(0));
+}
+
+TEST_F(SpillRingFileTest, RateLimitsAppends) {
+  SpillRingFile ring(path_, 4096, 3);
+  ASSERT_TRUE(ring.Open());
+
+  uint8_t record[8] = {0};
+  int accepted = 0;
+  for (int i = 0; i < 10; i++) {
+    if (ring.Append(record, sizeof(record))) accepted++;
+  }
+  EXPECT_EQ(accepted, 3);
+  EXPECT_EQ(ring.RecordsRateLimited(), static_cast<uint64_t>(7));
+}
+
+TEST_F(SpillRingFileTest, ReopenKeepsHistory) {
+  {
+    SpillRingFile ring(path_, 1024, 1000);
+    ASSERT_TRUE(ring.Open());
+    uint8_t record[8] = {0};
+    EXPECT_TRUE(ring.Append(record, sizeof(record)));
+  }
+  SpillRingFile ring(path_, 1024, 1000);
+  ASSERT_TRUE(ring.Open());
+  EXPECT_EQ(ring.RecordsWritten(), static_cast<uint64_t>(1));
+}
+
+class SpillItem {
+ public:
+  explicit SpillItem(uint8_t i) : index(i) {}
+  uint8_t index;
+};
+
+static size_t SerializeSpillItem(const SpillItem& item, uint8_t* buf,
+                                 size_t buf_len) {
+  if (buf_len < 1) return 0;
+  buf[0] = item.index;
+  return 1;
+}
+
+TEST_F(SpillRingFileTest, LeakyQueueSpillsDroppedItems) {
+  SpillRingFile ring(path_, 1024, 1000);
+  ASSERT_TRUE(ring.Open());
+
+  LeakyBondedQueue<SpillItem> queue(2);
+  queue.SetSpill(&ring, SerializeSpillItem);
+
+  queue.Enqueue(new SpillItem(1));
+  queue.Enqueue(new SpillItem(2));
+  EXPECT_EQ(queue.DroppedCount(), static_cast<uint64_t>(0));
+  EXPECT_EQ(ring.RecordsWritten(), static_cast<uint64_t>(0));
+
+  queue.Enqueue(new SpillItem(3));
+  queue.Enqueue(new SpillItem(4));
+  EXPECT_EQ(queue.DroppedCount(), static_cast<uint64_t>(2));
+  EXPECT_EQ(ring.RecordsWritten(), static_cast<uint64_t>(2));
+  queue.Clear();
+}
+
+}  // namespace testing
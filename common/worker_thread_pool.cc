@@ -0,0 +1,174 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "worker_thread_pool.h"
+
+#include <algorithm>
+
+#include <base/strings/stringprintf.h>
+#include <base/threading/platform_thread.h>
+
+#include "osi/include/log.h"
+
+namespace bluetooth {
+
+namespace common {
+
+static constexpr size_t kMaxDefaultPoolSize = 4;
+
+static size_t default_pool_size() {
+  size_t num_cores = std::thread::hardware_concurrency();
+  if (num_cores == 0) return 1;
+  return std::min(num_cores, kMaxDefaultPoolSize);
+}
+
+WorkerThreadPool::WorkerThreadPool(const std::string& name, size_t num_threads)
+    : name_(name),
+      num_threads_(num_threads != 0 ? num_threads : default_pool_size()) {}
+
+WorkerThreadPool::~WorkerThreadPool() { ShutDown(); }
+
+void WorkerThreadPool::StartUp() {
+  std::lock_guard<std::mutex> api_lock(api_mutex_);
+  if (running_) {
+    LOG(WARNING) << __func__ << ": pool " << name_ << " is already started";
+    return;
+  }
+
+  queues_.clear();
+  for (size_t i = 0; i < num_threads_; ++i)
+    queues_.push_back(std::make_unique<WorkerQueue>());
+
+  running_ = true;
+  for (size_t i = 0; i < num_threads_; ++i)
+    threads_.emplace_back(&WorkerThreadPool::WorkerRun, this, i);
+}
+
+void WorkerThreadPool::ShutDown() {
+  std::lock_guard<std::mutex> api_lock(api_mutex_);
+  if (!running_) return;
+
+  {
+    std::lock_guard<std::mutex> wakeup_lock(wakeup_mutex_);
+    running_ = false;
+  }
+  wakeup_.notify_all();
+
+  for (std::thread& thread : threads_) thread.join();
+  threads_.clear();
+  queues_.clear();
+  pending_jobs_ = 0;
+}
+
+bool WorkerThreadPool::ScheduleJob(base::OnceClosure job) {
+  if (!running_) {
+    LOG(ERROR) << __func__ << ": pool " << name_ << " is not running";
+    return false;
+  }
+
+  // Round-robin placement; idle workers rebalance by stealing.
+  size_t index = next_queue_.fetch_add(1, std::memory_order_relaxed) %
+                 num_threads_;
+  {
+    std::lock_guard<std::mutex> queue_lock(queues_[index]->mutex);
+    queues_[index]->jobs.push_back(std::move(job));
+  }
+  pending_jobs_.fetch_add(1, std::memory_order_release);
+  {
+    // Taken to close the race with a worker that has seen an empty pool but
+    // has not started waiting yet.
+    std::lock_guard<std::mutex> wakeup_lock(wakeup_mutex_);
+  }
+  wakeup_.notify_one();
+  return true;
+}
+
+bool WorkerThreadPool::ScheduleJobWithReply(const base::Location& from_here,
+                                            base::OnceClosure job,
+                                            MessageLoopThread* reply_thread,
+                                            base::OnceClosure reply) {
+  CHECK(reply_thread != nullptr);
+  return ScheduleJob(base::BindOnce(&WorkerThreadPool::RunJobAndReply,
+                                    std::move(job),
+                                    base::Unretained(reply_thread), from_here,
+                                    std::move(reply)));
+}
+
+void WorkerThreadPool::RunJobAndReply(base::OnceClosure job,
+                                      MessageLoopThread* reply_thread,
+                                      const base::Location& from_here,
+                                      base::OnceClosure reply) {
+  std::move(job).Run();
+  if (!reply_thread->DoInThread(from_here, std::move(reply))) {
+    LOG(ERROR) << __func__ << ": failed to post reply to "
+               << reply_thread->GetName() << ", from " << from_here.ToString();
+  }
+}
+
+size_t WorkerThreadPool::GetNumberOfThreads() const { return num_threads_; }
+
+bool WorkerThreadPool::IsRunning() const { return running_; }
+
+bool WorkerThreadPool::PopOrStealJob(size_t worker_index,
+                                     base::OnceClosure* job) {
+  // Own queue first, front end.
+  {
+    WorkerQueue* own_queue = queues_[worker_index].get();
+    std::lock_guard<std::mutex> queue_lock(own_queue->mutex);
+    if (!own_queue->jobs.empty()) {
+      *job = std::move(own_queue->jobs.front());
+      own_queue->jobs.pop_front();
+      return true;
+    }
+  }
+
+  // Steal from siblings, back end, to keep owner and thief on opposite ends.
+  for (size_t offset = 1; offset < num_threads_; ++offset) {
+    WorkerQueue* victim = queues_[(worker_index + offset) % num_threads_].get();
+    std::lock_guard<std::mutex> queue_lock(victim->mutex);
+    if (!victim->jobs.empty()) {
+      *job = std::move(victim->jobs.back());
+      victim->jobs.pop_back();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void WorkerThreadPool::WorkerRun(size_t worker_index) {
+  base::PlatformThread::SetName(
+      base::StringPrintf("%s-%zu", name_.c_str(), worker_index));
+
+  while (true) {
+    base::OnceClosure job;
+    if (PopOrStealJob(worker_index, &job)) {
+      pending_jobs_.fetch_sub(1, std::memory_order_acquire);
+      std::move(job).Run();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> wakeup_lock(wakeup_mutex_);
+    if (!running_ && pending_jobs_.load(std::memory_order_acquire) == 0)
+      return;
+    if (pending_jobs_.load(std::memory_order_acquire) != 0) continue;
+    wakeup_.wait(wakeup_lock);
+  }
+}
+
+}  // namespace common
+
+}  // namespace bluetooth
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <base/bind.h>
+#include <base/location.h>
+
+#include "message_loop_thread.h"
+
+namespace bluetooth {
+
+namespace common {
+
+/**
+ * A small work-stealing thread pool for CPU-bound, order-independent jobs
+ * (media encoding, crypto, parsing) that would otherwise compete with
+ * latency-critical signaling on a single message loop thread.
+ *
+ * Jobs are distributed round-robin across per-worker queues; an idle worker
+ * steals from the back of its siblings' queues before sleeping, so a burst
+ * of jobs spreads over all cores without a single contended queue. No
+ * ordering is guaranteed between jobs, even between two jobs scheduled from
+ * the same thread. Results are handed back by posting a reply closure to a
+ * MessageLoopThread (typically the main thread).
+ */
+class WorkerThreadPool final {
+ public:
+  /**
+   * Create a pool with |num_threads| workers named |name|-0 .. |name|-N.
+   * Workers are not running until StartUp() is called. A |num_threads| of 0
+   * sizes the pool to the number of online cores, capped at 4.
+   */
+  explicit WorkerThreadPool(const std::string& name, size_t num_threads = 0);
+
+  /**
+   * Destroys the pool; equivalent to ShutDown()
+   */
+  ~WorkerThreadPool();
+
+  /**
+   * Start the worker threads. Repeated calls only start the pool once.
+   */
+  void StartUp();
+
+  /**
+   * Stop accepting jobs, run everything already scheduled and join the
+   * workers. Safe to call multiple times. Must not be called from a worker.
+   */
+  void ShutDown();
+
+  /**
+   * Schedule |job| to run on any worker. Returns false if the pool is not
+   * running.
+   */
+  bool ScheduleJob(base::OnceClosure job);
+
+  /**
+   * Schedule |job| to run on any worker and, once it finishes, post |reply|
+   * to |reply_thread|. Returns false if the pool is not running.
+   */
+  bool ScheduleJobWithReply(const base::Location& from_here,
+                            base::OnceClosure job, MessageLoopThread* reply_thread,
+                            base::OnceClosure reply);
+
+  /**
+   * Number of worker threads in this pool.
+   */
+  size_t GetNumberOfThreads() const;
+
+  /**
+   * Check if the pool is accepting jobs.
+   */
+  bool IsRunning() const;
+
+ private:
+  // One worker's run queue. The owner pops from the front; thieves steal
+  // from the back to keep contention on opposite ends.
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<base::OnceClosure> jobs;
+  };
+
+  void WorkerRun(size_t worker_index);
+  static void RunJobAndReply(base::OnceClosure job,
+                             MessageLoopThread* reply_thread,
+                             const base::Location& from_here,
+                             base::OnceClosure reply);
+  bool PopOrStealJob(size_t worker_index, base::OnceClosure* job);
+
+  const std::string name_;
+  const size_t num_threads_;
+
+  mutable std::mutex api_mutex_;
+  std::vector<std::thread> threads_;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::atomic<size_t> next_queue_{0};
+  std::atomic<size_t> pending_jobs_{0};
+  std::atomic<bool> running_{false};
+
+  // Signaled when a job is scheduled or the pool shuts down.
+  std::mutex wakeup_mutex_;
+  std::condition_variable wakeup_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerThreadPool);
+};
+
+}  // namespace common
+
+}  // namespace bluetooth
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "worker_thread_pool.h"
+
+#include <atomic>
+#include <future>
+
+#include <gtest/gtest.h>
+
+#include <base/bind.h>
+
+using bluetooth::common::MessageLoopThread;
+using bluetooth::common::WorkerThreadPool;
+
+TEST(WorkerThreadPoolTest, schedule_before_start_fails) {
+  WorkerThreadPool pool("test_pool", 2);
+  ASSERT_FALSE(pool.IsRunning());
+  ASSERT_FALSE(pool.ScheduleJob(base::BindOnce([]() {})));
+}
+
+TEST(WorkerThreadPoolTest, jobs_all_execute) {
+  WorkerThreadPool pool("test_pool", 3);
+  pool.StartUp();
+  ASSERT_TRUE(pool.IsRunning());
+  ASSERT_EQ(pool.GetNumberOfThreads(), (size_t)3);
+
+  constexpr int kNumJobs = 200;
+  static std::atomic<int> executed{0};
+  executed = 0;
+  for (int i = 0; i < kNumJobs; i++) {
+    ASSERT_TRUE(
+        pool.ScheduleJob(base::BindOnce([]() { executed.fetch_add(1); })));
+  }
+
+  // ShutDown drains everything already scheduled.
+  pool.ShutDown();
+  ASSERT_EQ(executed.load(), kNumJobs);
+  ASSERT_FALSE(pool.IsRunning());
+}
+
+TEST(WorkerThreadPoolTest, repeated_start_up_shut_down) {
+  WorkerThreadPool pool("test_pool", 2);
+  for (int i = 0; i < 3; i++) {
+    pool.StartUp();
+    ASSERT_TRUE(pool.IsRunning());
+    pool.ShutDown();
+    ASSERT_FALSE(pool.IsRunning());
+  }
+  pool.ShutDown();  // Extra shutdown is a no-op.
+}
+
+TEST(WorkerThreadPoolTest, reply_posted_to_message_loop_thread) {
+  MessageLoopThread reply_thread("test_reply_thread");
+  reply_thread.StartUp();
+  WorkerThreadPool pool("test_pool", 2);
+  pool.StartUp();
+
+  static std::atomic<bool> job_ran{false};
+  job_ran = false;
+  std::promise<base::PlatformThreadId> reply_thread_id_promise;
+  std::future<base::PlatformThreadId> reply_thread_id_future =
+      reply_thread_id_promise.get_future();
+
+  ASSERT_TRUE(pool.ScheduleJobWithReply(
+      FROM_HERE, base::BindOnce([]() { job_ran = true; }), &reply_thread,
+      base::BindOnce(
+          [](std::promise<base::PlatformThreadId> promise) {
+            promise.set_value(base::PlatformThread::CurrentId());
+          },
+          std::move(reply_thread_id_promise))));
+
+  // The reply must run on the reply thread, after the job.
+  ASSERT_EQ(reply_thread_id_future.get(), reply_thread.GetThreadId());
+  ASSERT_TRUE(job_ran.load());
+
+  pool.ShutDown();
+  reply_thread.ShutDown();
+}
@@ -21,6 +21,9 @@
 #include <base/logging.h>
 #include <string.h>  // For memcmp
 
+#include <algorithm>
+#include <vector>
+
 #include "btcore/include/module.h"
 #include "device/include/interop.h"
 #include "device/include/interop_database.h"
@@ -34,6 +37,22 @@
 
 static list_t* interop_list = NULL;
 
+// Sorted view over interop_addr_database, built once on first lookup and
+// keyed by (feature, prefix length, address bytes) so a lookup is a handful
+// of binary searches instead of a scan of the whole table.
+static std::vector<const interop_addr_entry_t*> interop_addr_index;
+
+// Direct-mapped cache of recent misses. Almost every address checked on a
+// connection is absent from the database, so the repeated checks made by
+// btm_sec and the profiles resolve here without touching the index. Must
+// be a power of two.
+#define INTEROP_NEGATIVE_CACHE_SIZE 16
+static struct {
+  RawAddress addr;
+  interop_feature_t feature;
+  bool valid;
+} interop_negative_cache[INTEROP_NEGATIVE_CACHE_SIZE];
+
 static const char* interop_feature_string_(const interop_feature_t feature);
 static void interop_free_entry_(void* data);
 static void interop_lazy_init_(void);
@@ -42,12 +61,32 @@ static bool interop_match_fixed_(const interop_feature_t feature,
 static bool interop_match_dynamic_(const interop_feature_t feature,
                                    const RawAddress* addr);
 
+static size_t interop_negative_cache_slot_(const interop_feature_t feature,
+                                           const RawAddress* addr) {
+  size_t hash = (size_t)feature;
+  for (size_t i = 0; i < RawAddress::kLength; ++i)
+    hash = hash * 31 + addr->address[i];
+  return hash & (INTEROP_NEGATIVE_CACHE_SIZE - 1);
+}
+
+static void interop_negative_cache_invalidate_(void) {
+  for (size_t i = 0; i < INTEROP_NEGATIVE_CACHE_SIZE; ++i)
+    interop_negative_cache[i].valid = false;
+}
+
 // Interface functions
 
 bool interop_match_addr(const interop_feature_t feature,
                         const RawAddress* addr) {
   CHECK(addr);
 
+  const size_t slot = interop_negative_cache_slot_(feature, addr);
+  if (interop_negative_cache[slot].valid &&
+      interop_negative_cache[slot].feature == feature &&
+      interop_negative_cache[slot].addr == *addr) {
+    return false;
+  }
+
   if (interop_match_fixed_(feature, addr) ||
       interop_match_dynamic_(feature, addr)) {
     LOG_INFO("%s() Device %s is a match for interop workaround %s.", __func__,
@@ -55,6 +94,9 @@ bool interop_match_addr(const interop_feature_t feature,
     return true;
   }
 
+  interop_negative_cache[slot].addr = *addr;
+  interop_negative_cache[slot].feature = feature;
+  interop_negative_cache[slot].valid = true;
   return false;
 }
 
@@ -91,10 +133,12 @@ void interop_database_add(uint16_t feature, const RawAddress* addr,
 
   interop_lazy_init_();
   list_append(interop_list, entry);
+  interop_negative_cache_invalidate_();
 }
 
 void interop_database_clear() {
   if (interop_list) list_clear(interop_list);
+  interop_negative_cache_invalidate_();
 }
 
 // Module life-cycle functions
@@ -170,16 +214,56 @@ static bool interop_match_dynamic_(const interop_feature_t feature,
   return false;
 }
 
+// Lookup key for the sorted index; ordering must agree with
+// interop_index_entry_before_.
+typedef struct {
+  interop_feature_t feature;
+  size_t length;
+  const RawAddress* addr;
+} interop_index_key_t;
+
+static bool interop_index_entry_before_(const interop_addr_entry_t* a,
+                                        const interop_addr_entry_t* b) {
+  if (a->feature != b->feature) return a->feature < b->feature;
+  if (a->length != b->length) return a->length < b->length;
+  return memcmp(&a->addr, &b->addr, a->length) < 0;
+}
+
+static bool interop_index_entry_before_key_(const interop_addr_entry_t* entry,
+                                            const interop_index_key_t& key) {
+  if (entry->feature != key.feature) return entry->feature < key.feature;
+  if (entry->length != key.length) return entry->length < key.length;
+  return memcmp(&entry->addr, key.addr, entry->length) < 0;
+}
+
+static void interop_index_init_(void) {
+  if (!interop_addr_index.empty()) return;
+
+  const size_t db_size =
+      sizeof(interop_addr_database) / sizeof(interop_addr_entry_t);
+  interop_addr_index.reserve(db_size);
+  for (size_t i = 0; i != db_size; ++i)
+    interop_addr_index.push_back(&interop_addr_database[i]);
+  std::sort(interop_addr_index.begin(), interop_addr_index.end(),
+            interop_index_entry_before_);
+}
+
 static bool interop_match_fixed_(const interop_feature_t feature,
                                  const RawAddress* addr) {
   CHECK(addr);
 
-  const size_t db_size =
-      sizeof(interop_addr_database) / sizeof(interop_addr_entry_t);
-  for (size_t i = 0; i != db_size; ++i) {
-    if (feature == interop_addr_database[i].feature &&
-        memcmp(addr, &interop_addr_database[i].addr,
-               interop_addr_database[i].length) == 0) {
+  interop_index_init_();
+
+  // Entries within a feature mix address prefix lengths, so one binary
+  // search per possible length keeps the comparisons exact; lengths with
+  // no entries fall out of the search immediately.
+  for (size_t length = 1; length <= RawAddress::kLength; ++length) {
+    const interop_index_key_t key = {feature, length, addr};
+    const auto it =
+        std::lower_bound(interop_addr_index.begin(), interop_addr_index.end(),
+                         key, interop_index_entry_before_key_);
+    if (it != interop_addr_index.end() && (*it)->feature == feature &&
+        (*it)->length == length && memcmp(&(*it)->addr, addr, length) == 0) {
       return true;
     }
   }
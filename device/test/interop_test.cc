@@ -43,6 +43,23 @@ TEST(InteropTest, test_lookup_miss) {
   EXPECT_FALSE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
 }
 
+TEST(InteropTest, test_lookup_repeated) {
+  // Repeated queries land in the negative cache; results must not change.
+  RawAddress test_address;
+  RawAddress::FromString("12:34:56:78:9a:bc", test_address);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_FALSE(interop_match_addr(INTEROP_DISABLE_LE_SECURE_CONNECTIONS,
+                                    &test_address));
+    EXPECT_FALSE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+  }
+  RawAddress::FromString("38:2c:4a:e6:67:89", test_address);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(interop_match_addr(INTEROP_DISABLE_LE_SECURE_CONNECTIONS,
+                                   &test_address));
+    EXPECT_FALSE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+  }
+}
+
 TEST(InteropTest, test_dynamic) {
   RawAddress test_address;
 
@@ -113,6 +113,20 @@
 #define SBC_IS_64_MULT_IN_WINDOW_ACCU FALSE
 #endif /*SBC_IS_64_MULT_IN_WINDOW_ACCU */
 
+/* Set SBC_SIMD_OPT to TRUE to use NEON (or SSE2 on x86 hosts) vectorized
+ * windowing. It is bit exact with the 16 bit window accumulator and is
+ * enabled by default whenever the compiler targets a suitable instruction
+ * set. It takes precedence over SBC_ARM_ASM_OPT and SBC_IPAQ_OPT.
+ */
+#ifndef SBC_SIMD_OPT
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__SSE2__)) && \
+    (SBC_IS_64_MULT_IN_WINDOW_ACCU == FALSE)
+#define SBC_SIMD_OPT TRUE
+#else
+#define SBC_SIMD_OPT FALSE
+#endif
+#endif /*SBC_SIMD_OPT */
+
 /* Set SBC_IS_64_MULT_IN_IDCT to TRUE to use 64 bits multiplication in the DCT
  * of Matrixing
  */
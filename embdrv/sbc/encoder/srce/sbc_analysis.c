@@ -27,6 +27,14 @@
 #include "sbc_encoder.h"
 /*#include <math.h>*/
 
+#if (SBC_SIMD_OPT == TRUE)
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#else
+#include <emmintrin.h>
+#endif
+#endif
+
 #if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
 #define WIND_4_SUBBANDS_0_1                                              \
   (int32_t)0x01659F45 /* gas32CoeffFor4SBs[8] = -gas32CoeffFor4SBs[32] = \
@@ -274,6 +282,152 @@ static int16_t* s16X =
     }                                                            \
   }
 
+#if (SBC_SIMD_OPT == TRUE)
+/* The window coefficients above, rearranged as 5 taps by 16 (resp. 8) lanes
+ * so that one contiguous load of s16X covers every subband lane of a tap:
+ * lane k of tap j holds the coefficient applied to s16X[ChOffset + 16*j + k]
+ * (resp. 8*j + k). The folded lanes 0 and 8 (resp. 4) and the mirrored upper
+ * lanes reproduce WINDOW_PARTIAL_8 (resp. _4) term by term, so the vector
+ * path is bit exact with the scalar 16 bit accumulator. */
+static const int16_t gas16WindCoeff8[5][16] = {
+    {0, WIND_8_SUBBANDS_1_0, WIND_8_SUBBANDS_2_0, WIND_8_SUBBANDS_3_0,
+     WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_5_0, WIND_8_SUBBANDS_6_0,
+     WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_8_0, WIND_8_SUBBANDS_7_4,
+     WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_5_4, WIND_8_SUBBANDS_4_4,
+     WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_2_4, WIND_8_SUBBANDS_1_4},
+    {WIND_8_SUBBANDS_0_1, WIND_8_SUBBANDS_1_1, WIND_8_SUBBANDS_2_1,
+     WIND_8_SUBBANDS_3_1, WIND_8_SUBBANDS_4_1, WIND_8_SUBBANDS_5_1,
+     WIND_8_SUBBANDS_6_1, WIND_8_SUBBANDS_7_1, WIND_8_SUBBANDS_8_1,
+     WIND_8_SUBBANDS_7_3, WIND_8_SUBBANDS_6_3, WIND_8_SUBBANDS_5_3,
+     WIND_8_SUBBANDS_4_3, WIND_8_SUBBANDS_3_3, WIND_8_SUBBANDS_2_3,
+     WIND_8_SUBBANDS_1_3},
+    {WIND_8_SUBBANDS_0_2, WIND_8_SUBBANDS_1_2, WIND_8_SUBBANDS_2_2,
+     WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_5_2,
+     WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_8_2,
+     WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_5_2,
+     WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_2_2,
+     WIND_8_SUBBANDS_1_2},
+    {-WIND_8_SUBBANDS_0_2, WIND_8_SUBBANDS_1_3, WIND_8_SUBBANDS_2_3,
+     WIND_8_SUBBANDS_3_3, WIND_8_SUBBANDS_4_3, WIND_8_SUBBANDS_5_3,
+     WIND_8_SUBBANDS_6_3, WIND_8_SUBBANDS_7_3, WIND_8_SUBBANDS_8_1,
+     WIND_8_SUBBANDS_7_1, WIND_8_SUBBANDS_6_1, WIND_8_SUBBANDS_5_1,
+     WIND_8_SUBBANDS_4_1, WIND_8_SUBBANDS_3_1, WIND_8_SUBBANDS_2_1,
+     WIND_8_SUBBANDS_1_1},
+    {-WIND_8_SUBBANDS_0_1, WIND_8_SUBBANDS_1_4, WIND_8_SUBBANDS_2_4,
+     WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_4_4, WIND_8_SUBBANDS_5_4,
+     WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_7_4, WIND_8_SUBBANDS_8_0,
+     WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_6_0, WIND_8_SUBBANDS_5_0,
+     WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_3_0, WIND_8_SUBBANDS_2_0,
+     WIND_8_SUBBANDS_1_0}};
+static const int16_t gas16WindCoeff4[5][8] = {
+    {0, WIND_4_SUBBANDS_1_0, WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_3_0,
+     WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_2_4,
+     WIND_4_SUBBANDS_1_4},
+    {WIND_4_SUBBANDS_0_1, WIND_4_SUBBANDS_1_1, WIND_4_SUBBANDS_2_1,
+     WIND_4_SUBBANDS_3_1, WIND_4_SUBBANDS_4_1, WIND_4_SUBBANDS_3_3,
+     WIND_4_SUBBANDS_2_3, WIND_4_SUBBANDS_1_3},
+    {WIND_4_SUBBANDS_0_2, WIND_4_SUBBANDS_1_2, WIND_4_SUBBANDS_2_2,
+     WIND_4_SUBBANDS_3_2, WIND_4_SUBBANDS_4_2, WIND_4_SUBBANDS_3_2,
+     WIND_4_SUBBANDS_2_2, WIND_4_SUBBANDS_1_2},
+    {-WIND_4_SUBBANDS_0_2, WIND_4_SUBBANDS_1_3, WIND_4_SUBBANDS_2_3,
+     WIND_4_SUBBANDS_3_3, WIND_4_SUBBANDS_4_1, WIND_4_SUBBANDS_3_1,
+     WIND_4_SUBBANDS_2_1, WIND_4_SUBBANDS_1_1},
+    {-WIND_4_SUBBANDS_0_1, WIND_4_SUBBANDS_1_4, WIND_4_SUBBANDS_2_4,
+     WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_3_0,
+     WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_1_0}};
+
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON))
+static void SbcWindowPartial8(int32_t ChOffset) {
+  const int16_t* ps16Smp = s16X + ChOffset;
+  int32x4_t acc0 = vdupq_n_s32(0);
+  int32x4_t acc1 = vdupq_n_s32(0);
+  int32x4_t acc2 = vdupq_n_s32(0);
+  int32x4_t acc3 = vdupq_n_s32(0);
+  int32_t j;
+  for (j = 0; j < 5; j++) {
+    int16x8_t smp_lo = vld1q_s16(ps16Smp + 16 * j);
+    int16x8_t smp_hi = vld1q_s16(ps16Smp + 16 * j + 8);
+    int16x8_t coef_lo = vld1q_s16(gas16WindCoeff8[j]);
+    int16x8_t coef_hi = vld1q_s16(gas16WindCoeff8[j] + 8);
+    acc0 = vmlal_s16(acc0, vget_low_s16(smp_lo), vget_low_s16(coef_lo));
+    acc1 = vmlal_s16(acc1, vget_high_s16(smp_lo), vget_high_s16(coef_lo));
+    acc2 = vmlal_s16(acc2, vget_low_s16(smp_hi), vget_low_s16(coef_hi));
+    acc3 = vmlal_s16(acc3, vget_high_s16(smp_hi), vget_high_s16(coef_hi));
+  }
+  vst1q_s32(s32DCTY, acc0);
+  vst1q_s32(s32DCTY + 4, acc1);
+  vst1q_s32(s32DCTY + 8, acc2);
+  vst1q_s32(s32DCTY + 12, acc3);
+}
+
+static void SbcWindowPartial4(int32_t ChOffset) {
+  const int16_t* ps16Smp = s16X + ChOffset;
+  int32x4_t acc0 = vdupq_n_s32(0);
+  int32x4_t acc1 = vdupq_n_s32(0);
+  int32_t j;
+  for (j = 0; j < 5; j++) {
+    int16x8_t smp = vld1q_s16(ps16Smp + 8 * j);
+    int16x8_t coef = vld1q_s16(gas16WindCoeff4[j]);
+    acc0 = vmlal_s16(acc0, vget_low_s16(smp), vget_low_s16(coef));
+    acc1 = vmlal_s16(acc1, vget_high_s16(smp), vget_high_s16(coef));
+  }
+  vst1q_s32(s32DCTY, acc0);
+  vst1q_s32(s32DCTY + 4, acc1);
+}
+#else /* __SSE2__ */
+static void SbcWindowPartial8(int32_t ChOffset) {
+  const int16_t* ps16Smp = s16X + ChOffset;
+  __m128i acc0 = _mm_setzero_si128();
+  __m128i acc1 = _mm_setzero_si128();
+  __m128i acc2 = _mm_setzero_si128();
+  __m128i acc3 = _mm_setzero_si128();
+  int32_t j;
+  for (j = 0; j < 5; j++) {
+    __m128i smp_lo = _mm_loadu_si128((const __m128i*)(ps16Smp + 16 * j));
+    __m128i smp_hi = _mm_loadu_si128((const __m128i*)(ps16Smp + 16 * j + 8));
+    __m128i coef_lo = _mm_loadu_si128((const __m128i*)gas16WindCoeff8[j]);
+    __m128i coef_hi = _mm_loadu_si128((const __m128i*)(gas16WindCoeff8[j] + 8));
+    /* Lane wise 16x16->32 products from the lo/hi halves */
+    __m128i prod_lo = _mm_mullo_epi16(smp_lo, coef_lo);
+    __m128i prod_hi = _mm_mulhi_epi16(smp_lo, coef_lo);
+    acc0 = _mm_add_epi32(acc0, _mm_unpacklo_epi16(prod_lo, prod_hi));
+    acc1 = _mm_add_epi32(acc1, _mm_unpackhi_epi16(prod_lo, prod_hi));
+    prod_lo = _mm_mullo_epi16(smp_hi, coef_hi);
+    prod_hi = _mm_mulhi_epi16(smp_hi, coef_hi);
+    acc2 = _mm_add_epi32(acc2, _mm_unpacklo_epi16(prod_lo, prod_hi));
+    acc3 = _mm_add_epi32(acc3, _mm_unpackhi_epi16(prod_lo, prod_hi));
+  }
+  _mm_storeu_si128((__m128i*)s32DCTY, acc0);
+  _mm_storeu_si128((__m128i*)(s32DCTY + 4), acc1);
+  _mm_storeu_si128((__m128i*)(s32DCTY + 8), acc2);
+  _mm_storeu_si128((__m128i*)(s32DCTY + 12), acc3);
+}
+
+static void SbcWindowPartial4(int32_t ChOffset) {
+  const int16_t* ps16Smp = s16X + ChOffset;
+  __m128i acc0 = _mm_setzero_si128();
+  __m128i acc1 = _mm_setzero_si128();
+  int32_t j;
+  for (j = 0; j < 5; j++) {
+    __m128i smp = _mm_loadu_si128((const __m128i*)(ps16Smp + 8 * j));
+    __m128i coef = _mm_loadu_si128((const __m128i*)gas16WindCoeff4[j]);
+    __m128i prod_lo = _mm_mullo_epi16(smp, coef);
+    __m128i prod_hi = _mm_mulhi_epi16(smp, coef);
+    acc0 = _mm_add_epi32(acc0, _mm_unpacklo_epi16(prod_lo, prod_hi));
+    acc1 = _mm_add_epi32(acc1, _mm_unpackhi_epi16(prod_lo, prod_hi));
+  }
+  _mm_storeu_si128((__m128i*)s32DCTY, acc0);
+  _mm_storeu_si128((__m128i*)(s32DCTY + 4), acc1);
+}
+#endif
+
+#define WINDOW_PARTIAL_4 \
+  { SbcWindowPartial4(ChOffset); }
+
+#define WINDOW_PARTIAL_8 \
+  { SbcWindowPartial8(ChOffset); }
+
+#else /* SBC_SIMD_OPT == FALSE */
 #if (SBC_ARM_ASM_OPT == TRUE)
 #define WINDOW_ACCU_8_0                                                                                                                                                                                      \
   {                                                                                                                                                                                                          \
@@ -1184,6 +1338,7 @@ static int16_t* s16X =
   }
 #endif
 #endif
+#endif /* SBC_SIMD_OPT */
 
 static int16_t ShiftCounter = 0;
 extern int16_t EncMaxShiftCounter;
@@ -1199,6 +1354,7 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
   int32_t s32NumOfChannels, s32NumOfBlocks;
   int32_t i, *ps32X, *ps32X2;
   int32_t Offset, Offset2, ChOffset;
+#if (SBC_SIMD_OPT == FALSE)
 #if (SBC_ARM_ASM_OPT == TRUE)
   register int32_t s32Hi, s32Hi2;
 #else
@@ -1216,6 +1372,7 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
 
 #endif
 #endif
+#endif /* SBC_SIMD_OPT == FALSE */
 
   s32NumOfChannels = pstrEncParams->s16NumOfChannels;
   s32NumOfBlocks = pstrEncParams->s16NumOfBlocks;
@@ -1290,6 +1447,7 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
   int32_t s32NumOfChannels, s32NumOfBlocks;
   int32_t i, *ps32X, *ps32X2;
   int32_t ChOffset;
+#if (SBC_SIMD_OPT == FALSE)
 #if (SBC_ARM_ASM_OPT == TRUE)
   register int32_t s32Hi, s32Hi2;
 #else
@@ -1305,6 +1463,7 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
 #endif
 #endif
 #endif
+#endif /* SBC_SIMD_OPT == FALSE */
 
   s32NumOfChannels = pstrEncParams->s16NumOfChannels;
   s32NumOfBlocks = pstrEncParams->s16NumOfBlocks;
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <chrono>
+
 #include "common/callback.h"
 #include "os/queue.h"
 
@@ -45,6 +47,12 @@ class BidiQueueEnd : public ::bluetooth::os::IQueueEnqueue<TENQUEUE>, public ::b
     rx_->RegisterDequeue(handler, callback);
   }
 
+  void RegisterDequeueWithWatermark(
+      ::bluetooth::os::Handler* handler, DequeueCallback callback, size_t watermark_items,
+      std::chrono::microseconds watermark_timeout) override {
+    rx_->RegisterDequeueWithWatermark(handler, callback, watermark_items, watermark_timeout);
+  }
+
   void UnregisterDequeue() override {
     rx_->UnregisterDequeue();
   }
@@ -53,6 +61,10 @@ class BidiQueueEnd : public ::bluetooth::os::IQueueEnqueue<TENQUEUE>, public ::b
     return rx_->TryDequeue();
   }
 
+  std::vector<std::unique_ptr<TDEQUEUE>> TryDequeueAll() override {
+    return rx_->TryDequeueAll();
+  }
+
  private:
   ::bluetooth::os::IQueueEnqueue<TENQUEUE>* tx_;
   ::bluetooth::os::IQueueDequeue<TDEQUEUE>* rx_;
@@ -16,6 +16,7 @@
 
 #include "common/bidi_queue.h"
 
+#include <chrono>
 #include <future>
 
 #include "common/bind.h"
@@ -116,6 +117,56 @@ class TestBidiQueueEnd {
   BidiQueueEnd<TA, TB>* end_;
 };
 
+// Accumulates items delivered with a watermark registration and resolves a promise once
+// |expected_count| items have arrived, remembering how many callbacks it took.
+template <typename TA, typename TB>
+class TestWatermarkDequeueEnd {
+ public:
+  TestWatermarkDequeueEnd(BidiQueueEnd<TA, TB>* end, Handler* handler, size_t expected_count)
+      : handler_(handler), end_(end), expected_count_(expected_count) {}
+
+  void RegisterDequeueWithWatermark(size_t watermark_items, std::chrono::microseconds watermark_timeout) {
+    end_->RegisterDequeueWithWatermark(
+        handler_,
+        Bind(&TestWatermarkDequeueEnd<TA, TB>::handle_dequeue, common::Unretained(this)),
+        watermark_items,
+        watermark_timeout);
+  }
+
+  void UnregisterDequeue() {
+    end_->UnregisterDequeue();
+  }
+
+  void handle_dequeue() {
+    callback_count_++;
+    auto packets = end_->TryDequeueAll();
+    for (auto& packet : packets) {
+      received_.push_back(std::move(packet));
+    }
+    if (received_.size() >= expected_count_ && !promise_resolved_) {
+      promise_resolved_ = true;
+      received_promise_.set_value(received_.size());
+    }
+  }
+
+  std::future<size_t> GetReceivedFuture() {
+    return received_promise_.get_future();
+  }
+
+  size_t GetCallbackCount() const {
+    return callback_count_;
+  }
+
+ private:
+  Handler* handler_;
+  BidiQueueEnd<TA, TB>* end_;
+  size_t expected_count_;
+  std::vector<std::unique_ptr<TB>> received_;
+  std::promise<size_t> received_promise_;
+  bool promise_resolved_ = false;
+  size_t callback_count_ = 0;
+};
+
 TEST_F(BidiQueueTest, simple_test) {
   BidiQueue<A, B> queue(100);
   TestBidiQueueEnd<B, A> test_up(queue.GetUpEnd(), up_handler_);
@@ -138,6 +189,51 @@ TEST_F(BidiQueueTest, simple_test) {
   delete promise_sending_a;
 }
 
+TEST_F(BidiQueueTest, watermark_delivers_burst_in_one_callback) {
+  constexpr size_t kWatermark = 10;
+  BidiQueue<A, B> queue(100);
+  TestBidiQueueEnd<B, A> test_up(queue.GetUpEnd(), up_handler_);
+  TestWatermarkDequeueEnd<A, B> test_down(queue.GetDownEnd(), down_handler_, kWatermark);
+  // Timeout far beyond the test duration, so only the watermark can trigger delivery
+  test_down.RegisterDequeueWithWatermark(kWatermark, std::chrono::microseconds(10 * 1000 * 1000));
+  auto received_future = test_down.GetReceivedFuture();
+
+  for (size_t i = 0; i < kWatermark - 1; i++) {
+    auto promise_sending = test_up.Send(new B());
+    promise_sending->get_future().wait();
+    delete promise_sending;
+  }
+  // Below the watermark nothing must be delivered yet
+  EXPECT_EQ(received_future.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+
+  auto promise_sending = test_up.Send(new B());
+  promise_sending->get_future().wait();
+  delete promise_sending;
+
+  EXPECT_EQ(received_future.get(), kWatermark);
+  EXPECT_EQ(test_down.GetCallbackCount(), static_cast<size_t>(1));
+  test_down.UnregisterDequeue();
+}
+
+TEST_F(BidiQueueTest, watermark_timeout_delivers_partial_batch) {
+  constexpr size_t kItemCount = 3;
+  BidiQueue<A, B> queue(100);
+  TestBidiQueueEnd<B, A> test_up(queue.GetUpEnd(), up_handler_);
+  TestWatermarkDequeueEnd<A, B> test_down(queue.GetDownEnd(), down_handler_, kItemCount);
+  // Watermark that is never reached; the timeout has to flush the partial batch
+  test_down.RegisterDequeueWithWatermark(100, std::chrono::microseconds(20 * 1000));
+  auto received_future = test_down.GetReceivedFuture();
+
+  for (size_t i = 0; i < kItemCount; i++) {
+    auto promise_sending = test_up.Send(new B());
+    promise_sending->get_future().wait();
+    delete promise_sending;
+  }
+
+  EXPECT_EQ(received_future.get(), kItemCount);
+  test_down.UnregisterDequeue();
+}
+
 }  // namespace
 }  // namespace common
 }  // namespace bluetooth
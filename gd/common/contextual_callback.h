@@ -26,6 +26,12 @@ class IPostableContext {
  public:
   virtual ~IPostableContext(){};
   virtual void Post(OnceClosure closure) = 0;
+  // Return true if a closure handed to this context right now may be executed from the caller's
+  // frame instead of being posted, i.e. the caller is already running on the context's thread and
+  // inline execution cannot overtake work already posted to the context.
+  virtual bool CanExecuteInline() const {
+    return false;
+  }
 };
 
 template <typename R, typename... Args>
@@ -55,6 +61,17 @@ class ContextualOnceCallback<R(Args...)> {
     }
   }
 
+  // Run the callback from the caller's frame when the execution context allows it, saving the
+  // closure allocation and post for same-thread hops; otherwise post it as usual. Only use this
+  // for callbacks that are safe to run re-entrantly, e.g. on the packet data path.
+  void InvokeInline(Args... args) {
+    if (context_ != nullptr && context_->CanExecuteInline()) {
+      std::move(callback_).Run(std::forward<Args>(args)...);
+      return;
+    }
+    Invoke(std::forward<Args>(args)...);
+  }
+
   bool IsEmpty() {
     return context_ == nullptr;
   }
@@ -91,6 +108,17 @@ class ContextualCallback<R(Args...)> {
     }
   }
 
+  // Run the callback from the caller's frame when the execution context allows it, saving the
+  // closure allocation and post for same-thread hops; otherwise post it as usual. Only use this
+  // for callbacks that are safe to run re-entrantly, e.g. on the packet data path.
+  void InvokeInline(Args... args) {
+    if (context_ != nullptr && context_->CanExecuteInline()) {
+      callback_.Run(std::forward<Args>(args)...);
+      return;
+    }
+    Invoke(std::forward<Args>(args)...);
+  }
+
   bool IsEmpty() {
     return context_ == nullptr;
   }
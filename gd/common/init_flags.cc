@@ -26,8 +26,10 @@
 namespace bluetooth {
 namespace common {
 
-bool InitFlags::logging_debug_enabled_for_all = false;
-std::unordered_map<std::string, bool> InitFlags::logging_debug_explicit_tag_settings = {};
+std::atomic<const InitFlags::Snapshot*> InitFlags::current_snapshot_{nullptr};
+std::vector<const InitFlags::Snapshot*> InitFlags::retired_snapshots_;
+std::vector<InitFlags::ReloadObserver> InitFlags::reload_observers_;
+std::mutex InitFlags::reload_mutex_;
 
 bool ParseBoolFlag(const std::vector<std::string>& flag_pair, const std::string& flag, bool* variable) {
   if (flag != flag_pair[0]) {
@@ -41,9 +43,7 @@ bool ParseBoolFlag(const std::vector<std::string>& flag_pair, const std::string&
   return true;
 }
 
-void InitFlags::Load(const char** flags) {
-  const char** flags_copy = flags;
-  SetAll(false);
+void InitFlags::Parse(const char** flags, Snapshot* snapshot) {
   while (flags != nullptr && *flags != nullptr) {
     std::string flag_element = *flags;
     auto flag_pair = StringSplit(flag_element, "=", 2);
@@ -52,36 +52,42 @@ void InitFlags::Load(const char** flags) {
       continue;
     }
 
-    ParseBoolFlag(flag_pair, "INIT_logging_debug_enabled_for_all", &logging_debug_enabled_for_all);
+    ParseBoolFlag(
+        flag_pair, "INIT_logging_debug_enabled_for_all", &snapshot->logging_debug_enabled_for_all);
     if ("INIT_logging_debug_enabled_for_tags" == flag_pair[0]) {
       auto tags = StringSplit(flag_pair[1], ",");
       for (const auto& tag : tags) {
-        auto setting = logging_debug_explicit_tag_settings.find(tag);
-        if (setting == logging_debug_explicit_tag_settings.end()) {
-          logging_debug_explicit_tag_settings.insert_or_assign(tag, true);
+        auto setting = snapshot->logging_debug_explicit_tag_settings.find(tag);
+        if (setting == snapshot->logging_debug_explicit_tag_settings.end()) {
+          snapshot->logging_debug_explicit_tag_settings.insert_or_assign(tag, true);
         }
       }
     }
     if ("INIT_logging_debug_disabled_for_tags" == flag_pair[0]) {
       auto tags = StringSplit(flag_pair[1], ",");
       for (const auto& tag : tags) {
-        logging_debug_explicit_tag_settings.insert_or_assign(tag, false);
+        snapshot->logging_debug_explicit_tag_settings.insert_or_assign(tag, false);
       }
     }
     flags++;
   }
+}
 
-  std::vector<std::string> logging_debug_enabled_tags;
-  std::vector<std::string> logging_debug_disabled_tags;
-  for (const auto& tag_setting : logging_debug_explicit_tag_settings) {
-    if (tag_setting.second) {
-      logging_debug_enabled_tags.emplace_back(tag_setting.first);
-    } else {
-      logging_debug_disabled_tags.emplace_back(tag_setting.first);
-    }
+void InitFlags::Publish(Snapshot* snapshot) {
+  std::lock_guard<std::mutex> lock(reload_mutex_);
+  const Snapshot* old_snapshot = current_snapshot_.load(std::memory_order_relaxed);
+  snapshot->version = (old_snapshot == nullptr) ? 1 : old_snapshot->version + 1;
+  current_snapshot_.store(snapshot, std::memory_order_release);
+  if (old_snapshot != nullptr) {
+    retired_snapshots_.push_back(old_snapshot);
   }
+}
+
+void InitFlags::Load(const char** flags) {
+  auto* snapshot = new Snapshot();
+  Parse(flags, snapshot);
+  Publish(snapshot);
 
-  flags = flags_copy;
   rust::Vec<rust::String> rusted_flags = rust::Vec<rust::String>();
   while (flags != nullptr && *flags != nullptr) {
     rusted_flags.push_back(rust::String(*flags));
@@ -90,14 +96,35 @@ void InitFlags::Load(const char** flags) {
   init_flags::load(std::move(rusted_flags));
 }
 
-void InitFlags::SetAll(bool value) {
-  logging_debug_enabled_for_all = value;
-  logging_debug_explicit_tag_settings.clear();
+void InitFlags::Reload(const char** flags) {
+  LOG_INFO("reloading init flags");
+  Load(flags);
+
+  std::vector<ReloadObserver> observers;
+  {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+    observers = reload_observers_;
+  }
+  for (auto observer : observers) {
+    observer();
+  }
+}
+
+void InitFlags::RegisterReloadObserver(ReloadObserver observer) {
+  std::lock_guard<std::mutex> lock(reload_mutex_);
+  reload_observers_.push_back(observer);
+}
+
+uint32_t InitFlags::GetVersion() {
+  const Snapshot* snapshot = current_snapshot_.load(std::memory_order_acquire);
+  return (snapshot == nullptr) ? 0 : snapshot->version;
 }
 
 void InitFlags::SetAllForTesting() {
   init_flags::set_all_for_testing();
-  SetAll(true);
+  auto* snapshot = new Snapshot();
+  snapshot->logging_debug_enabled_for_all = true;
+  Publish(snapshot);
 }
 
 }  // namespace common
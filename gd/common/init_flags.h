@@ -16,9 +16,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "src/init_flags.rs.h"
 
@@ -29,25 +33,61 @@ class InitFlags final {
  public:
   static void Load(const char** flags);
 
+  // Re-parses |flags| and atomically publishes them as a new snapshot, then
+  // runs the registered reload observers. Readers are never blocked, so a
+  // running stack can pick up new flag values without a restart.
+  static void Reload(const char** flags);
+
+  // Invoked after every Reload() on the reloading thread, so modules that
+  // cache state derived from flag values can refresh it.
+  using ReloadObserver = void (*)();
+  static void RegisterReloadObserver(ReloadObserver observer);
+
+  // Monotonic snapshot version, bumped on every Load() and Reload(). Hot
+  // paths that cache derived state can compare it to detect staleness.
+  static uint32_t GetVersion();
+
   inline static bool IsDebugLoggingEnabledForTag(const std::string& tag) {
-    auto tag_setting = logging_debug_explicit_tag_settings.find(tag);
-    if (tag_setting != logging_debug_explicit_tag_settings.end()) {
+    const Snapshot* snapshot =
+        current_snapshot_.load(std::memory_order_acquire);
+    if (snapshot == nullptr) {
+      return false;
+    }
+    auto tag_setting = snapshot->logging_debug_explicit_tag_settings.find(tag);
+    if (tag_setting != snapshot->logging_debug_explicit_tag_settings.end()) {
       return tag_setting->second;
     }
-    return logging_debug_enabled_for_all;
+    return snapshot->logging_debug_enabled_for_all;
   }
 
   inline static bool IsDebugLoggingEnabledForAll() {
-    return logging_debug_enabled_for_all;
+    const Snapshot* snapshot =
+        current_snapshot_.load(std::memory_order_acquire);
+    return snapshot != nullptr && snapshot->logging_debug_enabled_for_all;
   }
 
   static void SetAllForTesting();
 
  private:
-  static void SetAll(bool value);
-  static bool logging_debug_enabled_for_all;
-  // save both log allow list and block list in the map to save hashing time
-  static std::unordered_map<std::string, bool> logging_debug_explicit_tag_settings;
+  // Parsed flag values are immutable once published; a (re)load builds a
+  // fresh snapshot and swaps the pointer in, so flag reads are lock-free.
+  struct Snapshot {
+    uint32_t version = 0;
+    bool logging_debug_enabled_for_all = false;
+    // save both log allow list and block list in the map to save hashing time
+    std::unordered_map<std::string, bool> logging_debug_explicit_tag_settings;
+  };
+
+  static void Parse(const char** flags, Snapshot* snapshot);
+  static void Publish(Snapshot* snapshot);
+
+  static std::atomic<const Snapshot*> current_snapshot_;
+  // Replaced snapshots are parked until process exit: a reader may still
+  // hold the old pointer, and reloads are rare enough that the few hundred
+  // bytes each are not worth a reclamation scheme.
+  static std::vector<const Snapshot*> retired_snapshots_;
+  static std::vector<ReloadObserver> reload_observers_;
+  static std::mutex reload_mutex_;
 };
 
 }  // namespace common
@@ -62,3 +62,24 @@ TEST(InitFlagsTest, test_debug_logging_multiple_flags) {
   ASSERT_FALSE(InitFlags::IsDebugLoggingEnabledForTag("Foo"));
   ASSERT_FALSE(InitFlags::IsDebugLoggingEnabledForAll());
 }
+
+static int reload_observer_count = 0;
+static void count_reload() {
+  reload_observer_count++;
+}
+
+TEST(InitFlagsTest, test_reload_publishes_new_snapshot) {
+  const char* off[] = {"INIT_logging_debug_enabled_for_all=false", nullptr};
+  InitFlags::Load(off);
+  uint32_t version = InitFlags::GetVersion();
+  ASSERT_FALSE(InitFlags::IsDebugLoggingEnabledForAll());
+
+  InitFlags::RegisterReloadObserver(count_reload);
+  int observed = reload_observer_count;
+
+  const char* on[] = {"INIT_logging_debug_enabled_for_all=true", nullptr};
+  InitFlags::Reload(on);
+  ASSERT_TRUE(InitFlags::IsDebugLoggingEnabledForAll());
+  ASSERT_GT(InitFlags::GetVersion(), version);
+  ASSERT_EQ(reload_observer_count, observed + 1);
+}
@@ -434,23 +434,27 @@ class HciHalHost : public HciHal {
     }
 
     if (buf[0] == kH4Acl) {
-      RUN_NO_INTR(received_size = recv(sock_fd_, buf + kH4HeaderSize, kHciAclHeaderSize, 0));
+      // Receive the packet directly into the buffer handed to the stack, so the bytes are read
+      // once into their final home and move through the layers without intermediate copies.
+      HciPacket receivedHciPacket(kBufSize - kH4HeaderSize);
+      RUN_NO_INTR(received_size = recv(sock_fd_, receivedHciPacket.data(), kHciAclHeaderSize, 0));
       ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
       ASSERT_LOG(received_size == kHciAclHeaderSize, "malformed ACL header received");
 
-      uint16_t hci_acl_data_total_length = (buf[4] << 8) + buf[3];
+      uint16_t hci_acl_data_total_length = (receivedHciPacket[3] << 8) + receivedHciPacket[2];
+      ASSERT_LOG(hci_acl_data_total_length <= kBufSize - kH4HeaderSize - kHciAclHeaderSize, "packet too long");
       int payload_size;
-      RUN_NO_INTR(payload_size = recv(sock_fd_, buf + kH4HeaderSize + kHciAclHeaderSize, hci_acl_data_total_length, 0));
+      RUN_NO_INTR(
+          payload_size =
+              recv(sock_fd_, receivedHciPacket.data() + kHciAclHeaderSize, hci_acl_data_total_length, 0));
       ASSERT_LOG(payload_size != -1, "Can't receive from socket: %s", strerror(errno));
       ASSERT_LOG(
           payload_size == hci_acl_data_total_length,
           "malformed ACL length received: %d != %d",
           payload_size,
           hci_acl_data_total_length);
-      ASSERT_LOG(hci_acl_data_total_length <= kBufSize - kH4HeaderSize - kHciAclHeaderSize, "packet too long");
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciAclHeaderSize + payload_size);
+      receivedHciPacket.resize(kHciAclHeaderSize + hci_acl_data_total_length);
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -458,7 +462,7 @@ class HciHalHost : public HciHal {
           LOG_INFO("Dropping an ACL packet after processing");
           return;
         }
-        incoming_packet_callback_->aclDataReceived(receivedHciPacket);
+        incoming_packet_callback_->aclDataReceived(std::move(receivedHciPacket));
       }
     }
 
@@ -487,18 +491,22 @@ class HciHalHost : public HciHal {
     }
 
     if (buf[0] == kH4Iso) {
-      RUN_NO_INTR(received_size = recv(sock_fd_, buf + kH4HeaderSize, kHciIsoHeaderSize, 0));
+      // Same single-read flow as ACL data above
+      HciPacket receivedHciPacket(kBufSize - kH4HeaderSize);
+      RUN_NO_INTR(received_size = recv(sock_fd_, receivedHciPacket.data(), kHciIsoHeaderSize, 0));
       ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
       ASSERT_LOG(received_size == kHciIsoHeaderSize, "malformed ISO header received");
 
-      uint16_t hci_iso_data_total_length = ((buf[4] & 0x3f) << 8) + buf[3];
+      uint16_t hci_iso_data_total_length = ((receivedHciPacket[3] & 0x3f) << 8) + receivedHciPacket[2];
+      ASSERT_LOG(hci_iso_data_total_length <= kBufSize - kH4HeaderSize - kHciIsoHeaderSize, "packet too long");
       int payload_size;
-      RUN_NO_INTR(payload_size = recv(sock_fd_, buf + kH4HeaderSize + kHciIsoHeaderSize, hci_iso_data_total_length, 0));
+      RUN_NO_INTR(
+          payload_size =
+              recv(sock_fd_, receivedHciPacket.data() + kHciIsoHeaderSize, hci_iso_data_total_length, 0));
       ASSERT_LOG(payload_size != -1, "Can't receive from socket: %s", strerror(errno));
       ASSERT_LOG(payload_size == hci_iso_data_total_length, "malformed ISO packet received: size mismatch");
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciIsoHeaderSize + payload_size);
+      receivedHciPacket.resize(kHciIsoHeaderSize + hci_iso_data_total_length);
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -506,7 +514,7 @@ class HciHalHost : public HciHal {
           LOG_INFO("Dropping a ISO packet after processing");
           return;
         }
-        incoming_packet_callback_->isoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->isoDataReceived(std::move(receivedHciPacket));
       }
     }
     memset(buf, 0, kBufSize);
@@ -18,12 +18,14 @@
 
 #include <arpa/inet.h>
 #include <sys/stat.h>
+#include <zlib.h>
 
 #include <algorithm>
 #include <bitset>
 #include <chrono>
 #include <sstream>
 
+#include "common/bind.h"
 #include "common/circular_buffer.h"
 #include "common/init_flags.h"
 #include "common/strings.h"
@@ -77,6 +79,15 @@ constexpr size_t kDefaultBtSnoozMaxPayloadBytesPerPacket =
 constexpr size_t kDefaultBtSnoozMaxPacketsPerBuffer =
     kDefaultBtsnoozMaxMemoryUsageBytes / kDefaultBtSnoozMaxBytesPerPacket;
 
+// Size reserved up front for the staging buffer; appends within this capacity do not allocate
+constexpr size_t kStagingBufferCapacityBytes = 64 * 1024;
+// Flush to the log file once this much data has been staged, before an append could reallocate
+constexpr size_t kStagingBufferFlushThresholdBytes = kStagingBufferCapacityBytes - 2 * 1024;
+// How often staged packets are pushed to the kernel when traffic alone does not fill the buffer
+constexpr std::chrono::milliseconds kStagingFlushInterval = std::chrono::milliseconds(100);
+// Scratch space for one round of deflate output; the deflate loop drains it as often as needed
+constexpr size_t kCompressionOutputBufferBytes = 16 * 1024;
+
 std::string get_btsnoop_log_path(std::string log_dir, bool filtered) {
   if (filtered) {
     log_dir.append(".filtered");
@@ -167,16 +178,27 @@ const std::string SnoopLogger::kBtSnoopMaxPacketsPerFileProperty = "persist.blue
 const std::string SnoopLogger::kIsDebuggableProperty = "ro.debuggable";
 const std::string SnoopLogger::kBtSnoopLogModeProperty = "persist.bluetooth.btsnooplogmode";
 const std::string SnoopLogger::kBtSnoopDefaultLogModeProperty = "persist.bluetooth.btsnoopdefaultmode";
+const std::string SnoopLogger::kBtSnoopCompressionProperty = "persist.bluetooth.btsnoopcompress";
+
+struct SnoopLogger::CompressionState {
+  z_stream stream = {};
+  bool active = false;
+  std::vector<uint8_t> out_buffer;
+};
 
 SnoopLogger::SnoopLogger(
     std::string snoop_log_path,
     std::string snooz_log_path,
     size_t max_packets_per_file,
-    const std::string& btsnoop_mode)
+    const std::string& btsnoop_mode,
+    bool btsnoop_compression_enabled)
     : snoop_log_path_(std::move(snoop_log_path)),
       snooz_log_path_(std::move(snooz_log_path)),
+      btsnoop_compression_enabled_(btsnoop_compression_enabled),
       max_packets_per_file_(max_packets_per_file),
-      btsnooz_buffer_(kDefaultBtSnoozMaxPacketsPerBuffer) {
+      btsnooz_buffer_(kDefaultBtSnoozMaxPacketsPerBuffer),
+      compression_state_(std::make_unique<CompressionState>()) {
+  staging_buffer_.reserve(kStagingBufferCapacityBytes);
   if (false && btsnoop_mode == kBtSnoopLogModeFiltered) {
     // TODO(b/163733538): implement filtered snoop log in GD, currently filtered == disabled
     LOG_INFO("Filtered Snoop Logs enabled");
@@ -204,11 +226,27 @@ SnoopLogger::SnoopLogger(
   }
   // Add ".filtered" extension if necessary
   snoop_log_path_ = get_btsnoop_log_path(snoop_log_path_, is_filtered_);
+  // Compressed logs use a gzip container and carry the conventional suffix so host tools
+  // pick the right decoder
+  if (is_enabled_ && btsnoop_compression_enabled_) {
+    snoop_log_path_.append(".gz");
+  }
 }
 
+SnoopLogger::~SnoopLogger() = default;
+
 void SnoopLogger::CloseCurrentSnoopLogFile() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (btsnoop_ostream_.is_open()) {
+    FlushStagingBuffer();
+    if (compression_state_->active) {
+      // Emit the gzip trailer so the closed file decodes on its own
+      compression_state_->stream.next_in = nullptr;
+      compression_state_->stream.avail_in = 0;
+      DeflateToSnoopLogFile(Z_FINISH);
+      deflateEnd(&compression_state_->stream);
+      compression_state_->active = false;
+    }
     btsnoop_ostream_.flush();
     btsnoop_ostream_.close();
   }
@@ -239,12 +277,23 @@ void SnoopLogger::OpenNextSnoopLogFile() {
     LOG_ALWAYS_FATAL("Unable to open snoop log at \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
   }
   umask(prevmask);
-  if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&kBtSnoopFileHeader), sizeof(FileHeaderType))) {
-    LOG_ALWAYS_FATAL("Unable to write file header to \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
-  }
-  if (!btsnoop_ostream_.flush()) {
-    LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+  if (btsnoop_compression_enabled_) {
+    auto& stream = compression_state_->stream;
+    stream = {};
+    // windowBits 15 + 16 selects the gzip container, keeping rotated files gunzip-compatible
+    int err = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+    if (err != Z_OK) {
+      LOG_ERROR(
+          "Unable to initialize compression for \"%s\", writing uncompressed, error: %d", snoop_log_path_.c_str(), err);
+    } else {
+      compression_state_->out_buffer.resize(kCompressionOutputBufferBytes);
+      compression_state_->active = true;
+    }
   }
+  // The file header goes through the staging buffer so that it lands inside the compressed
+  // stream when compression is on; flush right away so a fresh file is never headerless
+  WriteToSnoopLogFile(&kBtSnoopFileHeader, sizeof(FileHeaderType));
+  FlushStagingBuffer();
 }
 
 void SnoopLogger::Capture(const HciPacket& packet, Direction direction, PacketType type) {
@@ -298,20 +347,68 @@ void SnoopLogger::Capture(const HciPacket& packet, Direction direction, PacketTy
     if (packet_counter_ > max_packets_per_file_) {
       OpenNextSnoopLogFile();
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-      LOG_ERROR("Failed to write packet header for btsnoop, error: \"%s\"", strerror(errno));
-    }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(packet.data()), packet.size())) {
-      LOG_ERROR("Failed to write packet payload for btsnoop, error: \"%s\"", strerror(errno));
+    // Packets are staged in memory and reach the kernel on the next periodic flush, or sooner
+    // when the staging buffer fills, instead of costing a write() and flush() per packet
+    WriteToSnoopLogFile(&header, sizeof(PacketHeaderType));
+    WriteToSnoopLogFile(packet.data(), packet.size());
+  }
+}
+
+void SnoopLogger::WriteToSnoopLogFile(const void* data, size_t length) {
+  std::lock_guard<std::recursive_mutex> lock(file_mutex_);
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+  staging_buffer_.insert(staging_buffer_.end(), bytes, bytes + length);
+  if (staging_buffer_.size() >= kStagingBufferFlushThresholdBytes) {
+    FlushStagingBuffer();
+  }
+}
+
+void SnoopLogger::FlushStagingBuffer() {
+  std::lock_guard<std::recursive_mutex> lock(file_mutex_);
+  if (staging_buffer_.empty()) {
+    return;
+  }
+  if (!btsnoop_ostream_.is_open()) {
+    staging_buffer_.clear();
+    return;
+  }
+  if (compression_state_->active) {
+    compression_state_->stream.next_in = staging_buffer_.data();
+    compression_state_->stream.avail_in = staging_buffer_.size();
+    // Z_SYNC_FLUSH so the bytes already on disk stay decodable if we crash before the trailer
+    DeflateToSnoopLogFile(Z_SYNC_FLUSH);
+  } else if (!btsnoop_ostream_.write(
+                 reinterpret_cast<const char*>(staging_buffer_.data()), staging_buffer_.size())) {
+    LOG_ERROR("Failed to write staged packets for btsnoop, error: \"%s\"", strerror(errno));
+  }
+  // std::ofstream::flush() pushes user data into kernel memory. The data will be written even if this process
+  // crashes. However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
+  // NOTE: std::ofstream::write() followed by std::ofstream::flush() has similar effect as UNIX write(fd, data, len)
+  //       as write() syscall dumps data into kernel memory directly
+  if (!btsnoop_ostream_.flush()) {
+    LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+  }
+  staging_buffer_.clear();
+}
+
+void SnoopLogger::DeflateToSnoopLogFile(int flush_mode) {
+  auto& stream = compression_state_->stream;
+  do {
+    stream.next_out = compression_state_->out_buffer.data();
+    stream.avail_out = compression_state_->out_buffer.size();
+    int err = deflate(&stream, flush_mode);
+    if (err == Z_STREAM_ERROR) {
+      LOG_ERROR("Failed to compress staged packets for btsnoop, error: %d", err);
+      return;
     }
-    // std::ofstream::flush() pushes user data into kernel memory. The data will be written even if this process
-    // crashes. However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
-    // NOTE: std::ofstream::write() followed by std::ofstream::flush() has similar effect as UNIX write(fd, data, len)
-    //       as write() syscall dumps data into kernel memory directly
-    if (!btsnoop_ostream_.flush()) {
-      LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+    size_t produced = compression_state_->out_buffer.size() - stream.avail_out;
+    if (produced > 0 &&
+        !btsnoop_ostream_.write(reinterpret_cast<const char*>(compression_state_->out_buffer.data()), produced)) {
+      LOG_ERROR("Failed to write compressed packets for btsnoop, error: \"%s\"", strerror(errno));
+      return;
     }
-  }
+    // A full output buffer means deflate has more to emit for this input
+  } while (stream.avail_out == 0);
 }
 
 void SnoopLogger::DumpSnoozLogToFile(const std::vector<std::string>& data) const {
@@ -362,10 +459,19 @@ void SnoopLogger::Start() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (is_enabled_) {
     OpenNextSnoopLogFile();
+    staging_flush_alarm_ = std::make_unique<os::RepeatingAlarm>(GetHandler());
+    staging_flush_alarm_->Schedule(
+        common::Bind(&SnoopLogger::FlushStagingBuffer, common::Unretained(this)), kStagingFlushInterval);
   }
 }
 
 void SnoopLogger::Stop() {
+  // Tear down the alarm before taking file_mutex_: its destructor waits out an in-flight
+  // flush, which itself needs the mutex
+  if (staging_flush_alarm_ != nullptr) {
+    staging_flush_alarm_->Cancel();
+    staging_flush_alarm_.reset();
+  }
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   LOG_DEBUG("Dumping btsnooz log data to %s", snooz_log_path_.c_str());
   DumpSnoozLogToFile(btsnooz_buffer_.Drain());
@@ -419,12 +525,19 @@ std::string SnoopLogger::GetBtSnoopMode() {
   return btsnoop_mode;
 }
 
+bool SnoopLogger::IsBtSnoopCompressionEnabled() {
+  // Compression is opt-in via system property
+  auto compression_prop = os::GetSystemProperty(kBtSnoopCompressionProperty);
+  return compression_prop.has_value() && common::StringTrim(compression_prop.value()) == "true";
+}
+
 const ModuleFactory SnoopLogger::Factory = ModuleFactory([]() {
   return new SnoopLogger(
       os::ParameterProvider::SnoopLogFilePath(),
       os::ParameterProvider::SnoozLogFilePath(),
       GetMaxPacketsPerFile(),
-      GetBtSnoopMode());
+      GetBtSnoopMode(),
+      IsBtSnoopCompressionEnabled());
 });
 
 }  // namespace hal
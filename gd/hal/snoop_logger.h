@@ -18,12 +18,15 @@
 
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "common/circular_buffer.h"
 #include "hal/hci_hal.h"
 #include "module.h"
+#include "os/repeating_alarm.h"
 
 namespace bluetooth {
 namespace hal {
@@ -40,6 +43,7 @@ class SnoopLogger : public ::bluetooth::Module {
   static const std::string kIsDebuggableProperty;
   static const std::string kBtSnoopLogModeProperty;
   static const std::string kBtSnoopDefaultLogModeProperty;
+  static const std::string kBtSnoopCompressionProperty;
 
   // Put in header for test
   struct PacketHeaderType {
@@ -66,6 +70,10 @@ class SnoopLogger : public ::bluetooth::Module {
   // Changes to this values is only effective after restarting Bluetooth
   static std::string GetBtSnoopMode();
 
+  // Whether the btsnoop stream should be compressed with zlib on its way to disk
+  // Changes to this value is only effective after restarting Bluetooth
+  static bool IsBtSnoopCompressionEnabled();
+
   // Has to be defined from 1 to 4 per btsnoop format
   enum PacketType {
     CMD = 1,
@@ -96,20 +104,32 @@ class SnoopLogger : public ::bluetooth::Module {
       std::string snoop_log_path,
       std::string snooz_log_path,
       size_t max_packets_per_file,
-      const std::string& btsnoop_mode);
+      const std::string& btsnoop_mode,
+      bool btsnoop_compression_enabled = false);
+  ~SnoopLogger() override;
   void CloseCurrentSnoopLogFile();
   void OpenNextSnoopLogFile();
   void DumpSnoozLogToFile(const std::vector<std::string>& data) const;
+  // Push staged packets to the kernel; runs periodically and when the staging buffer fills
+  void FlushStagingBuffer();
 
  private:
+  // Streaming zlib state, kept opaque so that zlib stays out of this header
+  struct CompressionState;
+  void WriteToSnoopLogFile(const void* data, size_t length);
+  void DeflateToSnoopLogFile(int flush_mode);
   std::string snoop_log_path_;
   std::string snooz_log_path_;
   std::ofstream btsnoop_ostream_;
   bool is_enabled_ = false;
   bool is_filtered_ = false;
+  bool btsnoop_compression_enabled_ = false;
   size_t max_packets_per_file_;
   common::CircularBuffer<std::string> btsnooz_buffer_;
   size_t packet_counter_ = 0;
+  std::vector<uint8_t> staging_buffer_;
+  std::unique_ptr<CompressionState> compression_state_;
+  std::unique_ptr<os::RepeatingAlarm> staging_flush_alarm_;
   mutable std::recursive_mutex file_mutex_;
 };
 
@@ -59,8 +59,14 @@ class TestSnoopLoggerModule : public SnoopLogger {
       std::string snoop_log_path,
       std::string snooz_log_path,
       size_t max_packets_per_file,
-      const std::string& btsnoop_mode)
-      : SnoopLogger(std::move(snoop_log_path), std::move(snooz_log_path), max_packets_per_file, btsnoop_mode) {}
+      const std::string& btsnoop_mode,
+      bool btsnoop_compression_enabled = false)
+      : SnoopLogger(
+            std::move(snoop_log_path),
+            std::move(snooz_log_path),
+            max_packets_per_file,
+            btsnoop_mode,
+            btsnoop_compression_enabled) {}
 
   std::string ToString() const override {
     return std::string("TestSnoopLoggerModule");
@@ -155,6 +161,31 @@ TEST_F(SnoopLoggerModuleTest, capture_one_packet_test) {
       sizeof(SnoopLogger::FileHeaderType) + sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size());
 }
 
+TEST_F(SnoopLoggerModuleTest, capture_one_packet_compressed_test) {
+  // Actual test
+  auto* snoop_looger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(), temp_snooz_log_.string(), 10, SnoopLogger::kBtSnoopLogModeFull, true);
+  TestModuleRegistry test_registry;
+  test_registry.InjectTestModule(&SnoopLogger::Factory, snoop_looger);
+
+  snoop_looger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+
+  test_registry.StopAll();
+
+  // Verify states after test: the compressed log carries a ".gz" suffix and a gzip magic number
+  auto compressed_snoop_log = temp_snoop_log_;
+  compressed_snoop_log += ".gz";
+  ASSERT_FALSE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_TRUE(std::filesystem::exists(compressed_snoop_log));
+  std::ifstream compressed_istream(compressed_snoop_log, std::ios::binary | std::ios::in);
+  uint8_t magic[2] = {0, 0};
+  compressed_istream.read(reinterpret_cast<char*>(magic), sizeof(magic));
+  ASSERT_EQ(magic[0], 0x1f);
+  ASSERT_EQ(magic[1], 0x8b);
+  compressed_istream.close();
+  ASSERT_TRUE(std::filesystem::remove(compressed_snoop_log));
+}
+
 TEST_F(SnoopLoggerModuleTest, capture_hci_cmd_btsnooz_test) {
   // Actual test
   auto* snoop_looger = new TestSnoopLoggerModule(
@@ -17,12 +17,14 @@
 #include "hci/acl_manager.h"
 
 #include <atomic>
+#include <chrono>
 #include <future>
 #include <set>
 
 #include "common/bidi_queue.h"
 #include "hci/acl_manager/classic_impl.h"
 #include "hci/acl_manager/connection_management_callbacks.h"
+#include "hci/acl_manager/connection_registry.h"
 #include "hci/acl_manager/le_acl_connection.h"
 #include "hci/acl_manager/le_impl.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
@@ -37,6 +39,11 @@ namespace hci {
 
 constexpr uint16_t kQualcommDebugHandle = 0xedc;
 
+// Inbound ACL wakeup coalescing: deliver once this many packets are queued, or once the oldest
+// queued packet has waited this long, whichever comes first
+constexpr size_t kAclRxWatermarkItems = 4;
+constexpr std::chrono::microseconds kAclRxWatermarkTimeout = std::chrono::microseconds(1000);
+
 using acl_manager::AclConnection;
 using common::Bind;
 using common::BindOnce;
@@ -49,6 +56,7 @@ using acl_manager::le_impl;
 using acl_manager::LeAclConnection;
 using acl_manager::LeConnectionCallbacks;
 
+using acl_manager::ConnectionRegistry;
 using acl_manager::RoundRobinScheduler;
 
 struct AclManager::impl {
@@ -61,12 +69,18 @@ struct AclManager::impl {
     round_robin_scheduler_ = new RoundRobinScheduler(handler_, controller_, hci_layer_->GetAclQueueEnd());
 
     hci_queue_end_ = hci_layer_->GetAclQueueEnd();
-    hci_queue_end_->RegisterDequeue(
-        handler_, common::Bind(&impl::dequeue_and_route_acl_packet_to_connection, common::Unretained(this)));
+    // Batch inbound ACL wakeups: wait for a few packets of a burst to accumulate, but never hold a
+    // lone packet longer than the watermark timeout
+    hci_queue_end_->RegisterDequeueWithWatermark(
+        handler_,
+        common::Bind(&impl::dequeue_and_route_acl_packet_to_connection, common::Unretained(this)),
+        kAclRxWatermarkItems,
+        kAclRxWatermarkTimeout);
     bool crash_on_unknown_handle = false;
-    classic_impl_ =
-        new classic_impl(hci_layer_, controller_, handler_, round_robin_scheduler_, crash_on_unknown_handle);
-    le_impl_ = new le_impl(hci_layer_, controller_, handler_, round_robin_scheduler_, crash_on_unknown_handle);
+    classic_impl_ = new classic_impl(
+        hci_layer_, controller_, handler_, round_robin_scheduler_, &connection_registry_, crash_on_unknown_handle);
+    le_impl_ = new le_impl(
+        hci_layer_, controller_, handler_, round_robin_scheduler_, &connection_registry_, crash_on_unknown_handle);
   }
 
   void Stop() {
@@ -84,8 +98,15 @@ struct AclManager::impl {
 
   // Invoked from some external Queue Reactable context 2
   void dequeue_and_route_acl_packet_to_connection() {
-    auto packet = hci_queue_end_->TryDequeue();
-    ASSERT(packet != nullptr);
+    // Drain the whole RX backlog in one pass, so a burst of packets costs a single reactor wakeup
+    auto packets = hci_queue_end_->TryDequeueAll();
+    ASSERT(!packets.empty());
+    for (auto& packet : packets) {
+      route_acl_packet_to_connection(std::move(packet));
+    }
+  }
+
+  void route_acl_packet_to_connection(std::unique_ptr<AclView> packet) {
     if (!packet->IsValid()) {
       LOG_INFO("Dropping invalid packet of size %zu", packet->size());
       return;
@@ -94,17 +115,13 @@ struct AclManager::impl {
     if (handle == kQualcommDebugHandle) {
       return;
     }
-    auto connection_pair = classic_impl_->acl_connections_.find(handle);
-    if (connection_pair != classic_impl_->acl_connections_.end()) {
-      connection_pair->second.assembler_.on_incoming_packet(*packet);
-    } else {
-      auto le_connection_pair = le_impl_->le_acl_connections_.find(handle);
-      if (le_connection_pair == le_impl_->le_acl_connections_.end()) {
-        LOG_INFO("Dropping packet of size %zu to unknown connection 0x%0hx", packet->size(), handle);
-        return;
-      }
-      le_connection_pair->second.assembler_.on_incoming_packet(*packet);
+    // Classic and LE connections share the handle space, so a single table lookup covers both
+    auto* assembler = connection_registry_.FindAssembler(handle);
+    if (assembler == nullptr) {
+      LOG_INFO("Dropping packet of size %zu to unknown connection 0x%0hx", packet->size(), handle);
+      return;
     }
+    assembler->on_incoming_packet(*packet);
   }
 
   void Dump(
@@ -112,6 +129,8 @@ struct AclManager::impl {
 
   const AclManager& acl_manager_;
 
+  // Shared by classic_impl_ and le_impl_; must outlive both
+  ConnectionRegistry connection_registry_;
   classic_impl* classic_impl_ = nullptr;
   le_impl* le_impl_ = nullptr;
   os::Handler* handler_ = nullptr;
@@ -275,6 +294,10 @@ void AclManager::HACK_SetScoDisconnectCallback(std::function<void(uint16_t, uint
   pimpl_->classic_impl_->HACK_SetScoDisconnectCallback(callback);
 }
 
+void AclManager::SetAclQosClass(uint16_t handle, AclQosClass qos_class) {
+  CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetQosClass, handle, qos_class);
+}
+
 void AclManager::HACK_SetAclTxPriority(uint8_t handle, bool high_priority) {
   CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetLinkPriority, handle, high_priority);
 }
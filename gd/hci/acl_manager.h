@@ -49,6 +49,16 @@ bool L2CA_SetAclPriority(uint16_t, bool);
 
 namespace hci {
 
+// Per-connection transmit QoS class, used by the ACL scheduler to arbitrate controller credits.
+// LATENCY_CRITICAL links preempt the others and have credits reserved for them; INTERACTIVE and
+// BULK share the remainder, with INTERACTIVE getting the larger deficit-round-robin allowance.
+enum class AclQosClass : uint8_t {
+  LATENCY_CRITICAL = 0,
+  INTERACTIVE = 1,
+  BULK = 2,
+};
+static constexpr size_t kNumAclQosClasses = 3;
+
 class AclManager : public Module {
  friend class bluetooth::shim::Btm;
  friend class bluetooth::shim::legacy::Acl;
@@ -81,6 +91,10 @@ public:
  // Ask the controller for specific data parameters
  virtual void SetLeSuggestedDefaultDataParameters(uint16_t octets, uint16_t time);
 
+ // Assign the transmit QoS class used by the ACL scheduler for this connection.
+ // New connections default to AclQosClass::INTERACTIVE.
+ virtual void SetAclQosClass(uint16_t handle, AclQosClass qos_class);
+
  virtual void SetPrivacyPolicyForInitiatorAddress(
      LeAddressManager::AddressPolicy address_policy,
      AddressWithType fixed_address,
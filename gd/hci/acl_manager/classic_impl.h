@@ -18,6 +18,7 @@
 
 #include "common/bind.h"
 #include "hci/acl_manager/assembler.h"
+#include "hci/acl_manager/connection_registry.h"
 #include "hci/acl_manager/event_checkers.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
 #include "hci/controller.h"
@@ -43,10 +44,12 @@ struct classic_impl : public security::ISecurityManagerListener {
       Controller* controller,
       os::Handler* handler,
       RoundRobinScheduler* round_robin_scheduler,
+      ConnectionRegistry* connection_registry,
       bool crash_on_unknown_handle)
       : hci_layer_(hci_layer),
         controller_(controller),
         round_robin_scheduler_(round_robin_scheduler),
+        connection_registry_(connection_registry),
         crash_on_unknown_handle_(crash_on_unknown_handle) {
     hci_layer_ = hci_layer;
     controller_ = controller;
@@ -132,6 +135,7 @@ struct classic_impl : public security::ISecurityManagerListener {
     auto callbacks = get_callbacks(handle);
     if (callbacks != nullptr) {
       round_robin_scheduler_->Unregister(handle);
+      connection_registry_->Unregister(handle);
       callbacks->OnDisconnection(reason);
       acl_connections_.erase(handle);
     } else {
@@ -271,6 +275,7 @@ struct classic_impl : public security::ISecurityManagerListener {
         std::forward_as_tuple(
             AddressWithType{address, AddressType::PUBLIC_DEVICE_ADDRESS}, queue->GetDownEnd(), handler_));
     ASSERT(conn_pair.second);  // Make sure it's not a duplicate
+    connection_registry_->Register(handle, &conn_pair.first->second.assembler_);
     round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, queue);
     std::unique_ptr<ClassicAclConnection> connection(
         new ClassicAclConnection(std::move(queue), acl_connection_interface_, handle, address));
@@ -681,6 +686,7 @@ struct classic_impl : public security::ISecurityManagerListener {
   HciLayer* hci_layer_ = nullptr;
   Controller* controller_ = nullptr;
   RoundRobinScheduler* round_robin_scheduler_ = nullptr;
+  ConnectionRegistry* connection_registry_ = nullptr;
   AclConnectionInterface* acl_connection_interface_ = nullptr;
   os::Handler* handler_ = nullptr;
   ConnectionCallbacks* client_callbacks_ = nullptr;
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+struct assembler;
+
+// Direct-mapped table resolving a connection handle to its packet assembler. Connection handles
+// are at most 0x0eff per the spec, so the table is small enough to index directly, making
+// per-packet connection resolution a bounds check plus an array access instead of a std::map
+// walk. Classic and LE connections share the handle space and therefore share one table.
+//
+// Each slot carries a generation counter that is bumped whenever its handle is registered, so a
+// cached (handle, generation) pair can detect that the handle was recycled for a new connection
+// instead of silently touching the wrong link.
+//
+// All accesses happen on the ACL manager handler thread, so no locking is needed.
+class ConnectionRegistry {
+ public:
+  static constexpr uint16_t kMaxConnectionHandle = 0x0eff;
+
+  void Register(uint16_t handle, struct assembler* assembler) {
+    ASSERT(handle <= kMaxConnectionHandle);
+    auto& slot = slots_[handle];
+    ASSERT_LOG(slot.assembler_ == nullptr, "Handle 0x%04hx is already registered", handle);
+    slot.assembler_ = assembler;
+    slot.generation_++;
+  }
+
+  void Unregister(uint16_t handle) {
+    ASSERT(handle <= kMaxConnectionHandle);
+    slots_[handle].assembler_ = nullptr;
+  }
+
+  // Returns nullptr when no live connection uses the handle
+  struct assembler* FindAssembler(uint16_t handle) const {
+    if (handle > kMaxConnectionHandle) {
+      return nullptr;
+    }
+    return slots_[handle].assembler_;
+  }
+
+  // Generation of the connection currently (or most recently) registered on the handle
+  uint16_t GetGeneration(uint16_t handle) const {
+    ASSERT(handle <= kMaxConnectionHandle);
+    return slots_[handle].generation_;
+  }
+
+ private:
+  struct Slot {
+    struct assembler* assembler_ = nullptr;
+    uint16_t generation_ = 0;
+  };
+  std::array<Slot, kMaxConnectionHandle + 1> slots_ = {};
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/connection_registry.h"
+
+#include <gtest/gtest.h>
+
+#include "hci/acl_manager.h"
+#include "hci/acl_manager/assembler.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+TEST(ConnectionRegistryTest, register_find_unregister) {
+  ConnectionRegistry registry;
+  ASSERT_EQ(registry.FindAssembler(0x0001), nullptr);
+  assembler connection_assembler(AddressWithType{}, nullptr, nullptr);
+  registry.Register(0x0001, &connection_assembler);
+  ASSERT_EQ(registry.FindAssembler(0x0001), &connection_assembler);
+  registry.Unregister(0x0001);
+  ASSERT_EQ(registry.FindAssembler(0x0001), nullptr);
+}
+
+TEST(ConnectionRegistryTest, generation_bumped_on_handle_reuse) {
+  ConnectionRegistry registry;
+  assembler first_assembler(AddressWithType{}, nullptr, nullptr);
+  registry.Register(0x0002, &first_assembler);
+  auto first_generation = registry.GetGeneration(0x0002);
+  registry.Unregister(0x0002);
+  assembler second_assembler(AddressWithType{}, nullptr, nullptr);
+  registry.Register(0x0002, &second_assembler);
+  ASSERT_NE(registry.GetGeneration(0x0002), first_generation);
+  ASSERT_EQ(registry.FindAssembler(0x0002), &second_assembler);
+}
+
+TEST(ConnectionRegistryTest, out_of_range_handle_finds_nothing) {
+  ConnectionRegistry registry;
+  ASSERT_EQ(registry.FindAssembler(ConnectionRegistry::kMaxConnectionHandle + 1), nullptr);
+  ASSERT_EQ(registry.FindAssembler(0xffff), nullptr);
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -19,6 +19,7 @@
 #include "common/bind.h"
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "hci/acl_manager/assembler.h"
+#include "hci/acl_manager/connection_registry.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
 #include "hci/le_address_manager.h"
 #include "os/alarm.h"
@@ -53,10 +54,12 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       Controller* controller,
       os::Handler* handler,
       RoundRobinScheduler* round_robin_scheduler,
+      ConnectionRegistry* connection_registry,
       bool crash_on_unknown_handle)
       : hci_layer_(hci_layer),
         controller_(controller),
         round_robin_scheduler_(round_robin_scheduler),
+        connection_registry_(connection_registry),
         crash_on_unknown_handle_(crash_on_unknown_handle) {
     hci_layer_ = hci_layer;
     controller_ = controller;
@@ -124,11 +127,18 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return;
     }
     round_robin_scheduler_->Unregister(handle);
+    connection_registry_->Unregister(handle);
     callbacks->OnDisconnection(reason);
     le_acl_connections_.erase(handle);
+    if (le_acl_connections_.empty()) {
+      // No anchors left to pack against; let the next link negotiate its interval freely
+      common_connection_interval_ = 0;
+    }
   }
 
   void on_common_le_connection_complete(AddressWithType address_with_type) {
+    // Whatever the outcome, the controller no longer has a create connection in flight
+    create_connection_pending_ = false;
     auto connecting_addr_with_type = connecting_le_.find(address_with_type);
     if (connecting_addr_with_type == connecting_le_.end()) {
       LOG_WARN("No prior connection request for %s", address_with_type.ToString().c_str());
@@ -159,6 +169,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       ready_to_unregister = true;
       remove_device_from_connect_list(remote_address);
     }
+    arm_next_create_connection(remote_address);
 
     if (le_client_handler_ == nullptr) {
       LOG_ERROR("No callbacks to call");
@@ -178,6 +189,9 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       LOG_ERROR("Receive connection complete with invalid connection parameters");
       return;
     }
+    if (common_connection_interval_ == 0) {
+      common_connection_interval_ = conn_interval;
+    }
 
     auto role = connection_complete.GetRole();
     uint16_t handle = connection_complete.GetConnectionHandle();
@@ -187,6 +201,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         std::forward_as_tuple(handle),
         std::forward_as_tuple(remote_address, queue->GetDownEnd(), handler_));
     ASSERT(emplace_pair.second);  // Make sure the connection is unique
+    connection_registry_->Register(handle, &emplace_pair.first->second.assembler_);
     auto& connection_proxy = emplace_pair.first->second;
     round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::LE, handle, queue);
     std::unique_ptr<LeAclConnection> connection(new LeAclConnection(
@@ -217,6 +232,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       ready_to_unregister = true;
       remove_device_from_connect_list(remote_address);
     }
+    arm_next_create_connection(remote_address);
 
     if (le_client_handler_ == nullptr) {
       LOG_ERROR("No callbacks to call");
@@ -246,6 +262,9 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       LOG_ERROR("Receive enhenced connection complete with invalid connection parameters");
       return;
     }
+    if (common_connection_interval_ == 0) {
+      common_connection_interval_ = conn_interval;
+    }
     uint16_t handle = connection_complete.GetConnectionHandle();
     auto queue = std::make_shared<AclConnection::Queue>(10);
     auto emplace_pair = le_acl_connections_.emplace(
@@ -253,6 +272,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         std::forward_as_tuple(handle),
         std::forward_as_tuple(remote_address, queue->GetDownEnd(), handler_));
     ASSERT(emplace_pair.second);  // Make sure it's not a duplicate
+    connection_registry_->Register(handle, &emplace_pair.first->second.assembler_);
     auto& connection_proxy = emplace_pair.first->second;
     round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::LE, handle, queue);
     std::unique_ptr<LeAclConnection> connection(new LeAclConnection(
@@ -445,6 +465,13 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return;
     }
 
+    // The controller can only have one create connection in flight. The peer is already on the
+    // connect list, so park it; the round armed when the current attempt resolves covers it.
+    if (create_connection_pending_) {
+      pending_connections_.insert(address_with_type);
+      return;
+    }
+
     uint16_t le_scan_interval = kScanIntervalSlow;
     uint16_t le_scan_window = kScanWindowSlow;
     // If there is any direct connection in the connection list, use the fast parameter
@@ -459,9 +486,16 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     uint16_t conn_interval_max = 0x0028;
     uint16_t conn_latency = 0x0000;
     uint16_t supervision_timeout = 0x001f4;
+    if (common_connection_interval_ != 0) {
+      // Ask for the interval the existing links already use: links sharing one interval let the
+      // controller pack their anchor points side by side instead of drifting into collisions.
+      conn_interval_min = common_connection_interval_;
+      conn_interval_max = common_connection_interval_;
+    }
     ASSERT(check_connection_parameters(conn_interval_min, conn_interval_max, conn_latency, supervision_timeout));
 
     connecting_le_.insert(address_with_type);
+    create_connection_pending_ = true;
 
     if (initiator_filter_policy == InitiatorFilterPolicy::USE_CONNECT_LIST) {
       address_with_type = AddressWithType();
@@ -499,6 +533,18 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     }
   }
 
+  // Re-arm creation for the next parked peer as soon as the current attempt resolves, so a fleet
+  // of reconnections proceeds back to back instead of waiting on a round trip through the client
+  void arm_next_create_connection(AddressWithType completed_peer) {
+    pending_connections_.erase(completed_peer);
+    if (pending_connections_.empty() || create_connection_pending_) {
+      return;
+    }
+    auto next_peer = *pending_connections_.begin();
+    pending_connections_.erase(pending_connections_.begin());
+    create_le_connection(next_peer, false, false);
+  }
+
   void on_create_connection_timeout(AddressWithType address_with_type) {
     LOG_INFO("on_create_connection_timeout, address: %s", address_with_type.ToString().c_str());
     if (create_connection_timeout_alarms_.find(address_with_type) != create_connection_timeout_alarms_.end()) {
@@ -509,6 +555,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   }
 
   void cancel_connect(AddressWithType address_with_type) {
+    pending_connections_.erase(address_with_type);
     // the connection will be canceled by LeAddressManager.OnPause()
     remove_device_from_connect_list(address_with_type);
   }
@@ -644,7 +691,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
   void check_for_unregister() {
     if (le_acl_connections_.empty() && connecting_le_.empty() && canceled_connections_.empty() &&
-        address_manager_registered && ready_to_unregister) {
+        pending_connections_.empty() && address_manager_registered && ready_to_unregister) {
       le_address_manager_->Unregister(this);
       address_manager_registered = false;
       pause_connection = false;
@@ -687,6 +734,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   Controller* controller_ = nullptr;
   os::Handler* handler_ = nullptr;
   RoundRobinScheduler* round_robin_scheduler_ = nullptr;
+  ConnectionRegistry* connection_registry_ = nullptr;
   LeAddressManager* le_address_manager_ = nullptr;
   LeAclConnectionInterface* le_acl_connection_interface_ = nullptr;
   LeConnectionCallbacks* le_client_callbacks_ = nullptr;
@@ -695,6 +743,11 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   std::set<AddressWithType> connecting_le_;
   std::set<AddressWithType> canceled_connections_;
   std::set<AddressWithType> direct_connections_;
+  // Peers still owed a connection attempt while another create connection is in flight
+  std::set<AddressWithType> pending_connections_;
+  bool create_connection_pending_ = false;
+  // Connection interval shared across live links, so new links anchor beside the existing ones
+  uint16_t common_connection_interval_ = 0;
   bool address_manager_registered = false;
   bool ready_to_unregister = false;
   bool pause_connection = false;
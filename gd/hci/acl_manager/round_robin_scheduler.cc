@@ -68,12 +68,19 @@ void RoundRobinScheduler::Unregister(uint16_t handle) {
 }
 
 void RoundRobinScheduler::SetLinkPriority(uint16_t handle, bool high_priority) {
+  // Legacy entry point (A2dp); map onto the QoS classes
+  SetQosClass(handle, high_priority ? AclQosClass::LATENCY_CRITICAL : AclQosClass::INTERACTIVE);
+}
+
+void RoundRobinScheduler::SetQosClass(uint16_t handle, AclQosClass qos_class) {
   auto acl_queue_handler = acl_queue_handlers_.find(handle);
   if (acl_queue_handler == acl_queue_handlers_.end()) {
     LOG_WARN("handle %d is invalid", handle);
     return;
   }
-  acl_queue_handler->second.high_priority_ = high_priority;
+  acl_queue_handler->second.qos_class_ = qos_class;
+  // Start with a fresh allowance for the new class; the next replenish normalizes it
+  acl_queue_handler->second.drr_deficit_ = qos_weight(qos_class) * kDrrQuantumBytes;
 }
 
 uint16_t RoundRobinScheduler::GetCredits() {
@@ -84,16 +91,84 @@ uint16_t RoundRobinScheduler::GetLeCredits() {
   return le_acl_packet_credits_;
 }
 
+RoundRobinScheduler::SchedulerMetrics RoundRobinScheduler::GetMetrics() {
+  return metrics_;
+}
+
+int RoundRobinScheduler::qos_weight(AclQosClass qos_class) {
+  // Deficit quantum multiplier; LATENCY_CRITICAL is not deficit-scheduled
+  return qos_class == AclQosClass::INTERACTIVE ? 2 : 1;
+}
+
+int RoundRobinScheduler::fragment_priority(const acl_queue_handler& acl_queue_handler) {
+  switch (acl_queue_handler.qos_class_) {
+    case AclQosClass::LATENCY_CRITICAL:
+      return 2;
+    case AclQosClass::INTERACTIVE:
+      // An INTERACTIVE connection that used up its allowance competes at BULK level until the
+      // next replenish
+      return acl_queue_handler.drr_deficit_ > 0 ? 1 : 0;
+    case AclQosClass::BULK:
+    default:
+      return 0;
+  }
+}
+
+bool RoundRobinScheduler::latency_class_registered(ConnectionType connection_type) {
+  for (const auto& acl_queue_handler : acl_queue_handlers_) {
+    if (acl_queue_handler.second.connection_type_ == connection_type &&
+        acl_queue_handler.second.qos_class_ == AclQosClass::LATENCY_CRITICAL) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint16_t RoundRobinScheduler::available_credits(ConnectionType connection_type, AclQosClass qos_class) {
+  uint16_t credits = connection_type == ConnectionType::CLASSIC ? acl_packet_credits_ : le_acl_packet_credits_;
+  if (qos_class == AclQosClass::LATENCY_CRITICAL || !latency_class_registered(connection_type)) {
+    return credits;
+  }
+  // Keep a few credits in reserve so a latency-critical burst never waits for bulk completions
+  return credits > kReservedCreditsForLatencyClass ? credits - kReservedCreditsForLatencyClass : 0;
+}
+
+void RoundRobinScheduler::maybe_replenish_drr_deficits() {
+  bool any_exhausted = false;
+  bool any_served_with_deficit_left = false;
+  for (const auto& acl_queue_handler : acl_queue_handlers_) {
+    if (acl_queue_handler.second.qos_class_ == AclQosClass::LATENCY_CRITICAL) {
+      continue;
+    }
+    if (acl_queue_handler.second.drr_deficit_ <= 0) {
+      any_exhausted = true;
+    } else if (acl_queue_handler.second.served_since_replenish_) {
+      any_served_with_deficit_left = true;
+    }
+  }
+  // The round lasts while some active connection still has allowance left
+  if (!any_exhausted || any_served_with_deficit_left) {
+    return;
+  }
+  for (auto& acl_queue_handler : acl_queue_handlers_) {
+    if (acl_queue_handler.second.qos_class_ == AclQosClass::LATENCY_CRITICAL) {
+      continue;
+    }
+    acl_queue_handler.second.drr_deficit_ = qos_weight(acl_queue_handler.second.qos_class_) * kDrrQuantumBytes;
+    acl_queue_handler.second.served_since_replenish_ = false;
+  }
+  metrics_.drr_rounds_++;
+}
+
 void RoundRobinScheduler::start_round_robin() {
   if (acl_packet_credits_ == 0 && le_acl_packet_credits_ == 0) {
     return;
   }
   if (!fragments_to_send_.empty()) {
-    auto connection_type = fragments_to_send_.front().first;
-    bool classic_buffer_full = acl_packet_credits_ == 0 && connection_type == ConnectionType::CLASSIC;
-    bool le_buffer_full = le_acl_packet_credits_ == 0 && connection_type == ConnectionType::LE;
-    if (classic_buffer_full || le_buffer_full) {
+    auto connection_type = fragments_to_send_.front().connection_type_;
+    if (available_credits(connection_type, fragments_to_send_.front().qos_class_) == 0) {
       LOG_WARN("Buffer of connection_type %d is full", connection_type);
+      metrics_.credit_stalls_++;
       return;
     }
     send_next_fragment();
@@ -104,18 +179,18 @@ void RoundRobinScheduler::start_round_robin() {
     return;
   }
 
+  maybe_replenish_drr_deficits();
+
   if (acl_queue_handlers_.size() == 1 || starting_point_ == acl_queue_handlers_.end()) {
     starting_point_ = acl_queue_handlers_.begin();
   }
   size_t count = acl_queue_handlers_.size();
 
   for (auto acl_queue_handler = starting_point_; count > 0; count--) {
-    // Prevent registration when credits is zero
-    bool classic_buffer_full =
-        acl_packet_credits_ == 0 && acl_queue_handler->second.connection_type_ == ConnectionType::CLASSIC;
-    bool le_buffer_full =
-        le_acl_packet_credits_ == 0 && acl_queue_handler->second.connection_type_ == ConnectionType::LE;
-    if (!acl_queue_handler->second.dequeue_is_registered_ && !classic_buffer_full && !le_buffer_full) {
+    // Prevent registration when the class' share of credits is zero
+    bool buffer_full = available_credits(acl_queue_handler->second.connection_type_,
+                                         acl_queue_handler->second.qos_class_) == 0;
+    if (!acl_queue_handler->second.dequeue_is_registered_ && !buffer_full) {
       acl_queue_handler->second.dequeue_is_registered_ = true;
       acl_queue_handler->second.queue_->GetDownEnd()->RegisterDequeue(
           handler_, common::Bind(&RoundRobinScheduler::buffer_packet, common::Unretained(this), acl_queue_handler));
@@ -142,19 +217,22 @@ void RoundRobinScheduler::buffer_packet(std::map<uint16_t, acl_queue_handler>::i
                                                 ? PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE
                                                 : PacketBoundaryFlag::FIRST_NON_AUTOMATICALLY_FLUSHABLE;
 
-  int acl_priority = acl_queue_handler->second.high_priority_ ? 1 : 0;
-  if (packet->size() <= mtu) {
+  AclQosClass qos_class = acl_queue_handler->second.qos_class_;
+  size_t packet_size = packet->size();
+  int acl_priority = fragment_priority(acl_queue_handler->second);
+  if (packet_size <= mtu) {
     fragments_to_send_.push(
-        std::make_pair(
-            connection_type, AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(packet))),
+        fragment_to_send{
+            connection_type, qos_class,
+            AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(packet))},
         acl_priority);
   } else {
     auto fragments = AclFragmenter(mtu, std::move(packet)).GetFragments();
     for (size_t i = 0; i < fragments.size(); i++) {
       fragments_to_send_.push(
-          std::make_pair(
-              connection_type,
-              AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(fragments[i]))),
+          fragment_to_send{
+              connection_type, qos_class,
+              AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(fragments[i]))},
           acl_priority);
       packet_boundary_flag = PacketBoundaryFlag::CONTINUING_FRAGMENT;
     }
@@ -162,6 +240,13 @@ void RoundRobinScheduler::buffer_packet(std::map<uint16_t, acl_queue_handler>::i
   ASSERT(fragments_to_send_.size() > 0);
   unregister_all_connections();
 
+  if (qos_class != AclQosClass::LATENCY_CRITICAL) {
+    acl_queue_handler->second.drr_deficit_ -= static_cast<int>(packet_size);
+    acl_queue_handler->second.served_since_replenish_ = true;
+  }
+  metrics_.packets_sent_[static_cast<size_t>(qos_class)]++;
+  metrics_.bytes_sent_[static_cast<size_t>(qos_class)] += packet_size;
+
   acl_queue_handler->second.number_of_sent_packets_ += fragments_to_send_.size();
   send_next_fragment();
 }
@@ -185,7 +270,7 @@ void RoundRobinScheduler::send_next_fragment() {
 
 // Invoked from some external Queue Reactable context 1
 std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment() {
-  ConnectionType connection_type = fragments_to_send_.front().first;
+  ConnectionType connection_type = fragments_to_send_.front().connection_type_;
   if (connection_type == ConnectionType::CLASSIC) {
     ASSERT(acl_packet_credits_ > 0);
     acl_packet_credits_ -= 1;
@@ -194,7 +279,7 @@ std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment()
     le_acl_packet_credits_ -= 1;
   }
 
-  auto raw_pointer = fragments_to_send_.front().second.release();
+  auto raw_pointer = fragments_to_send_.front().fragment_.release();
   fragments_to_send_.pop();
   if (fragments_to_send_.empty()) {
     if (enqueue_registered_.exchange(false)) {
@@ -202,11 +287,11 @@ std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment()
     }
     handler_->Post(common::BindOnce(&RoundRobinScheduler::start_round_robin, common::Unretained(this)));
   } else {
-    ConnectionType next_connection_type = fragments_to_send_.front().first;
-    bool classic_buffer_full = next_connection_type == ConnectionType::CLASSIC && acl_packet_credits_ == 0;
-    bool le_buffer_full = next_connection_type == ConnectionType::LE && le_acl_packet_credits_ == 0;
-    if ((classic_buffer_full || le_buffer_full) && enqueue_registered_.exchange(false)) {
+    bool buffer_full = available_credits(fragments_to_send_.front().connection_type_,
+                                         fragments_to_send_.front().qos_class_) == 0;
+    if (buffer_full && enqueue_registered_.exchange(false)) {
       hci_queue_end_->UnregisterEnqueue();
+      metrics_.credit_stalls_++;
     }
   }
   return std::unique_ptr<AclBuilder>(raw_pointer);
@@ -226,10 +311,12 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
     acl_queue_handler->second.number_of_sent_packets_ = 0;
   }
 
-  bool credit_was_zero = false;
+  // Restart whenever credits were scarce, not only at zero: the reserved share may have been
+  // blocking INTERACTIVE/BULK traffic even though a few raw credits remained
+  bool credit_was_scarce = false;
   if (acl_queue_handler->second.connection_type_ == ConnectionType::CLASSIC) {
-    if (acl_packet_credits_ == 0) {
-      credit_was_zero = true;
+    if (acl_packet_credits_ <= kReservedCreditsForLatencyClass) {
+      credit_was_scarce = true;
     }
     acl_packet_credits_ += credits;
     if (acl_packet_credits_ > max_acl_packet_credits_) {
@@ -237,8 +324,8 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
       LOG_WARN("acl packet credits overflow due to receive %hx credits", credits);
     }
   } else {
-    if (le_acl_packet_credits_ == 0) {
-      credit_was_zero = true;
+    if (le_acl_packet_credits_ <= kReservedCreditsForLatencyClass) {
+      credit_was_scarce = true;
     }
     le_acl_packet_credits_ += credits;
     if (le_acl_packet_credits_ > le_max_acl_packet_credits_) {
@@ -246,7 +333,7 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
       LOG_WARN("le acl packet credits overflow due to receive %hx credits", credits);
     }
   }
-  if (credit_was_zero) {
+  if (credit_was_scarce) {
     start_round_robin();
   }
 }
@@ -42,28 +42,58 @@ class RoundRobinScheduler {
     std::shared_ptr<acl_manager::AclConnection::Queue> queue_;
     bool dequeue_is_registered_ = false;
     uint16_t number_of_sent_packets_ = 0;  // Track credits
-    bool high_priority_ = false;           // For A2dp use
+    AclQosClass qos_class_ = AclQosClass::INTERACTIVE;
+    int drr_deficit_ = 0;                  // Bytes left in this connection's deficit-round-robin allowance
+    bool served_since_replenish_ = false;  // Whether the connection sent anything in the current round
+  };
+
+  // Scheduler occupancy counters, tallied per QoS class on the scheduler handler
+  struct SchedulerMetrics {
+    uint64_t packets_sent_[kNumAclQosClasses] = {};
+    uint64_t bytes_sent_[kNumAclQosClasses] = {};
+    uint64_t drr_rounds_ = 0;      // Times the deficit allowances were replenished
+    uint64_t credit_stalls_ = 0;   // Times sending stalled waiting for (unreserved) controller credits
   };
 
   void Register(ConnectionType connection_type, uint16_t handle,
                 std::shared_ptr<acl_manager::AclConnection::Queue> queue);
   void Unregister(uint16_t handle);
   void SetLinkPriority(uint16_t handle, bool high_priority);
+  void SetQosClass(uint16_t handle, AclQosClass qos_class);
   uint16_t GetCredits();
   uint16_t GetLeCredits();
+  SchedulerMetrics GetMetrics();
 
  private:
+  // Controller credits kept back from INTERACTIVE/BULK traffic while a LATENCY_CRITICAL
+  // connection is registered on the same transport
+  static constexpr uint16_t kReservedCreditsForLatencyClass = 2;
+  // Deficit replenished per round for a weight-1 (BULK) connection; INTERACTIVE gets twice this
+  static constexpr int kDrrQuantumBytes = 2048;
+
+  struct fragment_to_send {
+    ConnectionType connection_type_;
+    AclQosClass qos_class_;
+    std::unique_ptr<AclBuilder> fragment_;
+  };
+
   void start_round_robin();
   void buffer_packet(std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler);
   void unregister_all_connections();
   void send_next_fragment();
   std::unique_ptr<AclBuilder> handle_enqueue_next_fragment();
   void incoming_acl_credits(uint16_t handle, uint16_t credits);
+  bool latency_class_registered(ConnectionType connection_type);
+  uint16_t available_credits(ConnectionType connection_type, AclQosClass qos_class);
+  void maybe_replenish_drr_deficits();
+  static int qos_weight(AclQosClass qos_class);
+  static int fragment_priority(const acl_queue_handler& acl_queue_handler);
 
   os::Handler* handler_ = nullptr;
   Controller* controller_ = nullptr;
   std::map<uint16_t, acl_queue_handler> acl_queue_handlers_;
-  common::MultiPriorityQueue<std::pair<ConnectionType, std::unique_ptr<AclBuilder>>, 2> fragments_to_send_;
+  common::MultiPriorityQueue<fragment_to_send, 3> fragments_to_send_;
+  SchedulerMetrics metrics_;
   uint16_t max_acl_packet_credits_ = 0;
   uint16_t acl_packet_credits_ = 0;
   uint16_t le_max_acl_packet_credits_ = 0;
@@ -410,6 +410,41 @@ TEST_F(RoundRobinSchedulerTest, receive_le_credit_when_next_fragment_is_classic)
   round_robin_scheduler_->Unregister(le_handle);
 }
 
+TEST_F(RoundRobinSchedulerTest, qos_class_metrics_per_class) {
+  uint16_t handle = 0x01;
+  uint16_t bulk_handle = 0x02;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(10);
+  auto bulk_connection_queue = std::make_shared<AclConnection::Queue>(10);
+
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, bulk_handle, bulk_connection_queue);
+  round_robin_scheduler_->SetQosClass(handle, AclQosClass::LATENCY_CRITICAL);
+  round_robin_scheduler_->SetQosClass(bulk_handle, AclQosClass::BULK);
+
+  SetPacketFuture(4);
+  AclConnection::QueueUpEnd* queue_up_end = connection_queue->GetUpEnd();
+  AclConnection::QueueUpEnd* bulk_queue_up_end = bulk_connection_queue->GetUpEnd();
+  std::vector<uint8_t> packet = {0x01, 0x02, 0x03};
+  std::vector<uint8_t> bulk_packet = {0x04, 0x05, 0x06};
+  EnqueueAclUpEnd(queue_up_end, packet);
+  EnqueueAclUpEnd(bulk_queue_up_end, bulk_packet);
+  EnqueueAclUpEnd(queue_up_end, packet);
+  EnqueueAclUpEnd(bulk_queue_up_end, bulk_packet);
+
+  packet_future_->wait();
+  sync_handler();
+
+  auto metrics = round_robin_scheduler_->GetMetrics();
+  ASSERT_EQ(metrics.packets_sent_[static_cast<size_t>(AclQosClass::LATENCY_CRITICAL)], 2u);
+  ASSERT_EQ(metrics.packets_sent_[static_cast<size_t>(AclQosClass::BULK)], 2u);
+  ASSERT_EQ(metrics.bytes_sent_[static_cast<size_t>(AclQosClass::LATENCY_CRITICAL)], 2 * packet.size());
+  ASSERT_EQ(metrics.bytes_sent_[static_cast<size_t>(AclQosClass::BULK)], 2 * bulk_packet.size());
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), controller_->max_acl_packet_credits_ - 4);
+
+  round_robin_scheduler_->Unregister(handle);
+  round_robin_scheduler_->Unregister(bulk_handle);
+}
+
 }  // namespace acl_manager
 }  // namespace hci
 }  // namespace bluetooth
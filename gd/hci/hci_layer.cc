@@ -114,18 +114,12 @@ struct HciLayer::impl {
 
   void on_outbound_acl_ready() {
     auto packet = acl_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
-    hal_->sendAclData(bytes);
+    hal_->sendAclData(packet->SerializeToScratchBuffer());
   }
 
   void on_outbound_iso_ready() {
     auto packet = iso_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
-    hal_->sendIsoData(bytes);
+    hal_->sendIsoData(packet->SerializeToScratchBuffer());
   }
 
   template <typename TResponse>
@@ -318,7 +312,7 @@ struct HciLayer::impl {
       LOG_WARN("Unhandled event of type 0x%02hhx (%s)", event_code, EventCodeText(event_code).c_str());
       return;
     }
-    event_handlers_[event_code].Invoke(event);
+    event_handlers_[event_code].InvokeInline(event);
   }
 
   void on_le_meta_event(EventView event) {
@@ -329,7 +323,7 @@ struct HciLayer::impl {
       LOG_WARN("Unhandled le subevent of type 0x%02hhx (%s)", subevent_code, SubeventCodeText(subevent_code).c_str());
       return;
     }
-    subevent_handlers_[subevent_code].Invoke(meta_event_view);
+    subevent_handlers_[subevent_code].InvokeInline(meta_event_view);
   }
 
   hal::HciHal* hal_;
@@ -359,7 +353,7 @@ struct HciLayer::hal_callbacks : public hal::HciHalCallbacks {
   hal_callbacks(HciLayer& module) : module_(module) {}
 
   void hciEventReceived(hal::HciPacket event_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(event_bytes));
+    auto packet = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(move(event_bytes)));
     EventView event = EventView::Create(packet);
     module_.CallOn(module_.impl_, &impl::on_hci_event, move(event));
   }
@@ -207,6 +207,14 @@ void LeAddressManager::push_command(Command command) {
   cached_commands_.push(std::move(command));
 }
 
+void LeAddressManager::push_commands(std::vector<Command> commands) {
+  // Queueing the whole batch in one shot guarantees a single pause/resume cycle around it
+  pause_registered_clients();
+  for (auto& command : commands) {
+    cached_commands_.push(std::move(command));
+  }
+}
+
 void LeAddressManager::ack_pause(LeAddressManagerCallback* callback) {
   ASSERT(registered_clients_.find(callback) != registered_clients_.end());
   registered_clients_.find(callback)->second = ClientState::PAUSED;
@@ -358,12 +366,23 @@ void LeAddressManager::handle_next_command() {
   }
 
   ASSERT(!cached_commands_.empty());
-  auto command = std::move(cached_commands_.front());
-  cached_commands_.pop();
-
-  if (command.command_type == CommandType::ROTATE_RANDOM_ADDRESS) {
-    rotate_random_address();
-  } else {
+  // Stream every queued list-maintenance command in one go; the HCI layer below meters them
+  // against the controller's command credits. Address rotation still goes out on its own, after
+  // everything in flight has completed, because its follow-up depends on the generated address.
+  while (!cached_commands_.empty()) {
+    if (cached_commands_.front().command_type == CommandType::ROTATE_RANDOM_ADDRESS) {
+      if (outstanding_commands_ > 0) {
+        // The last completion of the in-flight batch re-enters here
+        return;
+      }
+      cached_commands_.pop();
+      outstanding_commands_++;
+      rotate_random_address();
+      return;
+    }
+    auto command = std::move(cached_commands_.front());
+    cached_commands_.pop();
+    outstanding_commands_++;
     enqueue_command_.Run(std::move(command.command_packet));
   }
 }
@@ -375,6 +394,28 @@ void LeAddressManager::AddDeviceToConnectList(
   handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command)).Invoke();
 }
 
+void LeAddressManager::AddDevicesToConnectList(
+    std::vector<std::pair<ConnectListAddressType, bluetooth::hci::Address>> devices) {
+  std::vector<Command> commands;
+  commands.reserve(devices.size());
+  for (const auto& device : devices) {
+    auto packet_builder = hci::LeAddDeviceToConnectListBuilder::Create(device.first, device.second);
+    commands.push_back({CommandType::ADD_DEVICE_TO_CONNECT_LIST, std::move(packet_builder)});
+  }
+  handler_->BindOnceOn(this, &LeAddressManager::push_commands, std::move(commands)).Invoke();
+}
+
+void LeAddressManager::RemoveDevicesFromConnectList(
+    std::vector<std::pair<ConnectListAddressType, bluetooth::hci::Address>> devices) {
+  std::vector<Command> commands;
+  commands.reserve(devices.size());
+  for (const auto& device : devices) {
+    auto packet_builder = hci::LeRemoveDeviceFromConnectListBuilder::Create(device.first, device.second);
+    commands.push_back({CommandType::REMOVE_DEVICE_FROM_CONNECT_LIST, std::move(packet_builder)});
+  }
+  handler_->BindOnceOn(this, &LeAddressManager::push_commands, std::move(commands)).Invoke();
+}
+
 void LeAddressManager::AddDeviceToResolvingList(
     PeerAddressType peer_identity_address_type,
     Address peer_identity_address,
@@ -439,6 +480,13 @@ void LeAddressManager::OnCommandComplete(bluetooth::hci::CommandCompleteView vie
     }
   }
 
+  if (outstanding_commands_ > 0) {
+    outstanding_commands_--;
+  }
+  if (outstanding_commands_ > 0) {
+    // More streamed commands are still in flight; resume only after the last completion
+    return;
+  }
   if (cached_commands_.empty()) {
     handler_->BindOnceOn(this, &LeAddressManager::resume_registered_clients).Invoke();
   } else {
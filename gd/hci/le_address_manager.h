@@ -18,6 +18,8 @@
 #include <map>
 #include <mutex>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "common/callback.h"
 #include "hci/address_with_type.h"
@@ -77,6 +79,11 @@ class LeAddressManager {
   uint8_t GetConnectListSize();
   uint8_t GetResolvingListSize();
   void AddDeviceToConnectList(ConnectListAddressType connect_list_address_type, Address address);
+  // Queue connect list changes for a whole group of devices behind a single pause/resume cycle.
+  // The adds are streamed back-to-back, so bulk re-registration stalls the radio once, not once
+  // per device.
+  void AddDevicesToConnectList(std::vector<std::pair<ConnectListAddressType, Address>> devices);
+  void RemoveDevicesFromConnectList(std::vector<std::pair<ConnectListAddressType, Address>> devices);
   void AddDeviceToResolvingList(
       PeerAddressType peer_identity_address_type,
       Address peer_identity_address,
@@ -114,6 +121,7 @@ class LeAddressManager {
 
   void pause_registered_clients();
   void push_command(Command command);
+  void push_commands(std::vector<Command> commands);
   void ack_pause(LeAddressManagerCallback* callback);
   void resume_registered_clients();
   void ack_resume(LeAddressManagerCallback* callback);
@@ -142,6 +150,8 @@ class LeAddressManager {
   uint8_t connect_list_size_;
   uint8_t resolving_list_size_;
   std::queue<Command> cached_commands_;
+  // Streamed commands whose command complete has not arrived yet
+  size_t outstanding_commands_ = 0;
 };
 
 }  // namespace hci
@@ -342,6 +342,39 @@ TEST_F(LeAddressManagerWithSingleClientTest, add_device_to_connect_list) {
   clients[0].get()->WaitForResume();
 }
 
+TEST_F(LeAddressManagerWithSingleClientTest, add_devices_to_connect_list_in_one_batch) {
+  Address address1;
+  Address address2;
+  Address address3;
+  Address::FromString("01:02:03:04:05:06", address1);
+  Address::FromString("02:03:04:05:06:07", address2);
+  Address::FromString("03:04:05:06:07:08", address3);
+  test_hci_layer_->SetCommandFuture();
+  le_address_manager_->AddDevicesToConnectList(
+      {{ConnectListAddressType::RANDOM, address1},
+       {ConnectListAddressType::RANDOM, address2},
+       {ConnectListAddressType::RANDOM, address3}});
+  sync_handler(handler_);
+  sync_handler(handler_);
+
+  // All three adds are streamed before any command complete comes back
+  for (const auto& expected_address : {address1, address2, address3}) {
+    auto packet = test_hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_CONNECT_LIST);
+    auto packet_view =
+        LeAddDeviceToConnectListView::Create(LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(expected_address, packet_view.GetAddress());
+  }
+
+  // The client stays paused until the last completion
+  ASSERT_TRUE(clients[0].get()->paused);
+  test_hci_layer_->IncomingEvent(LeAddDeviceToConnectListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  ASSERT_TRUE(clients[0].get()->paused);
+  test_hci_layer_->IncomingEvent(LeAddDeviceToConnectListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeAddDeviceToConnectListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0].get()->WaitForResume();
+}
+
 TEST_F(LeAddressManagerWithSingleClientTest, remove_device_from_connect_list) {
   Address address;
   Address::FromString("01:02:03:04:05:06", address);
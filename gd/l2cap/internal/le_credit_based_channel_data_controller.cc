@@ -40,28 +40,40 @@ void LeCreditBasedDataController::OnSdu(std::unique_ptr<packet::BasePacketBuilde
   if (sdu_size > mtu_) {
     LOG_WARN("Received sdu_size %d > mtu %d", static_cast<int>(sdu_size), mtu_);
   }
+  // Keep the SDU whole and segment it just-in-time in GetNextPacket(); only the segment count is
+  // needed up front to ask the scheduler for credit-gated PDU slots.
+  size_t num_segments = (sdu_size + mps_ - 3) / (mps_ - 2);
+  sdu_queue_.emplace(std::move(sdu), mps_);
+  if (credits_ >= num_segments) {
+    scheduler_->OnPacketsReady(cid_, num_segments);
+    credits_ -= num_segments;
+  } else if (credits_ > 0) {
+    scheduler_->OnPacketsReady(cid_, credits_);
+    pending_frames_count_ += (num_segments - credits_);
+    credits_ = 0;
+  } else {
+    pending_frames_count_ += num_segments;
+  }
+}
+
+void LeCreditBasedDataController::segment_next_sdu() {
+  ASSERT(!sdu_queue_.empty());
+  auto sdu = std::move(sdu_queue_.front().first);
+  uint16_t mps = sdu_queue_.front().second;
+  sdu_queue_.pop();
+  auto sdu_size = sdu->size();
   std::vector<std::unique_ptr<packet::RawBuilder>> segments;
   // TODO: We don't need to waste 2 bytes for continuation segment.
-  packet::FragmentingInserter fragmenting_inserter(mps_ - 2, std::back_insert_iterator(segments));
+  packet::FragmentingInserter fragmenting_inserter(mps - 2, std::back_insert_iterator(segments));
   sdu->Serialize(fragmenting_inserter);
   fragmenting_inserter.finalize();
   std::unique_ptr<BasicFrameBuilder> builder;
   builder = FirstLeInformationFrameBuilder::Create(remote_cid_, sdu_size, std::move(segments[0]));
   pdu_queue_.emplace(std::move(builder));
-  for (auto i = 1; i < segments.size(); i++) {
+  for (size_t i = 1; i < segments.size(); i++) {
     builder = BasicFrameBuilder::Create(remote_cid_, std::move(segments[i]));
     pdu_queue_.emplace(std::move(builder));
   }
-  if (credits_ >= segments.size()) {
-    scheduler_->OnPacketsReady(cid_, segments.size());
-    credits_ -= segments.size();
-  } else if (credits_ > 0) {
-    scheduler_->OnPacketsReady(cid_, credits_);
-    pending_frames_count_ += (segments.size() - credits_);
-    credits_ = 0;
-  } else {
-    pending_frames_count_ += segments.size();
-  }
 }
 
 void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
@@ -102,6 +114,9 @@ void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
 }
 
 std::unique_ptr<packet::BasePacketBuilder> LeCreditBasedDataController::GetNextPacket() {
+  if (pdu_queue_.empty()) {
+    segment_next_sdu();
+  }
   ASSERT(!pdu_queue_.empty());
   auto next = std::move(pdu_queue_.front());
   pdu_queue_.pop();
@@ -63,6 +63,11 @@ class LeCreditBasedDataController : public DataController {
   Cid remote_cid_;
   os::EnqueueBuffer<UpperEnqueue> enqueue_buffer_;
   os::Handler* handler_;
+  // SDUs waiting for segmentation, with the MPS in effect when they were enqueued so the segment
+  // count announced to the scheduler stays exact. SDUs are kept whole until the scheduler actually
+  // pulls a PDU, so a stalled channel queues builders instead of materialized segment chains.
+  std::queue<std::pair<std::unique_ptr<packet::BasePacketBuilder>, uint16_t>> sdu_queue_;
+  // Segments of the SDU currently being transmitted
   std::queue<std::unique_ptr<packet::BasePacketBuilder>> pdu_queue_;
   Scheduler* scheduler_;
   ILink* link_;
@@ -80,6 +85,9 @@ class LeCreditBasedDataController : public DataController {
   };
   PacketViewForReassembly reassembly_stage_{PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>())};
   uint16_t remaining_sdu_continuation_packet_size_ = 0;
+
+  // Segment the SDU at the front of |sdu_queue_| into |pdu_queue_|
+  void segment_next_sdu();
 };
 
 }  // namespace internal
@@ -16,6 +16,8 @@
 
 #include "l2cap/internal/receiver.h"
 
+#include <chrono>
+
 #include "common/bidi_queue.h"
 #include "l2cap/cid.h"
 #include "l2cap/internal/data_pipeline_manager.h"
@@ -25,12 +27,19 @@
 namespace bluetooth {
 namespace l2cap {
 namespace internal {
+
+// Link RX wakeup coalescing: deliver once this many PDUs are queued, or once the oldest queued PDU
+// has waited this long, whichever comes first
+constexpr size_t kLinkRxWatermarkItems = 4;
+constexpr std::chrono::microseconds kLinkRxWatermarkTimeout = std::chrono::microseconds(1000);
+
 Receiver::Receiver(LowerQueueUpEnd* link_queue_up_end, os::Handler* handler,
                    DataPipelineManager* data_pipeline_manager_)
     : link_queue_up_end_(link_queue_up_end), handler_(handler), data_pipeline_manager_(data_pipeline_manager_) {
   ASSERT(link_queue_up_end_ != nullptr && handler_ != nullptr);
-  link_queue_up_end_->RegisterDequeue(handler_,
-                                      common::Bind(&Receiver::link_queue_dequeue_callback, common::Unretained(this)));
+  link_queue_up_end_->RegisterDequeueWithWatermark(
+      handler_, common::Bind(&Receiver::link_queue_dequeue_callback, common::Unretained(this)), kLinkRxWatermarkItems,
+      kLinkRxWatermarkTimeout);
 }
 
 // Invoked from external handler/thread (ModuleRegistry)
@@ -40,8 +49,15 @@ Receiver::~Receiver() {
 
 // Invoked from external (Queue Reactable)
 void Receiver::link_queue_dequeue_callback() {
-  auto packet = link_queue_up_end_->TryDequeue();
-  auto basic_frame_view = BasicFrameView::Create(*packet);
+  // Drain the whole link RX backlog in one pass, so a burst of PDUs costs a single reactor wakeup
+  auto packets = link_queue_up_end_->TryDequeueAll();
+  for (const auto& packet : packets) {
+    handle_basic_frame(*packet);
+  }
+}
+
+void Receiver::handle_basic_frame(const LowerDequeue& packet) {
+  auto basic_frame_view = BasicFrameView::Create(packet);
   if (!basic_frame_view.IsValid()) {
     LOG_WARN("Received an invalid basic frame");
     return;
@@ -53,7 +69,7 @@ void Receiver::link_queue_dequeue_callback() {
     LOG_WARN("Received a packet with invalid cid: %d", cid);
     return;
   }
-  data_controller->OnPdu(*packet);
+  data_controller->OnPdu(packet);
 }
 
 }  // namespace internal
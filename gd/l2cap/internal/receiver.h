@@ -62,6 +62,7 @@ class Receiver {
   DataPipelineManager* data_pipeline_manager_;
 
   void link_queue_dequeue_callback();
+  void handle_basic_frame(const LowerDequeue& packet);
 };
 
 }  // namespace internal
@@ -16,6 +16,14 @@
 #define LOG_TAG "BtGdModule"
 
 #include "module.h"
+
+#include <chrono>
+#include <future>
+#include <queue>
+#include <sstream>
+#include <utility>
+#include <vector>
+
 #include "common/init_flags.h"
 #include "dumpsys/init_flags.h"
 #include "os/wakelock_manager.h"
@@ -66,8 +74,72 @@ bool ModuleRegistry::IsStarted(const ModuleFactory* module) const {
 }
 
 void ModuleRegistry::Start(ModuleList* modules, Thread* thread) {
+  // Construct every requested module and its transitive dependencies up front so the full
+  // dependency graph is known, then bring independent branches up concurrently, one wave of ready
+  // modules at a time. A module only ever observes fully started dependencies because
+  // started_modules_ is updated between waves, never while a wave is running.
+  std::map<const ModuleFactory*, Module*> pending_modules;
+  std::queue<const ModuleFactory*> to_construct;
   for (auto it = modules->list_.begin(); it != modules->list_.end(); it++) {
-    Start(*it, thread);
+    to_construct.push(*it);
+  }
+  while (!to_construct.empty()) {
+    const ModuleFactory* factory = to_construct.front();
+    to_construct.pop();
+    if (started_modules_.find(factory) != started_modules_.end() ||
+        pending_modules.find(factory) != pending_modules.end()) {
+      continue;
+    }
+    Module* instance = factory->ctor_();
+    last_instance_ = "constructing " + instance->ToString();
+    set_registry_and_handler(instance, thread);
+    instance->ListDependencies(&instance->dependencies_);
+    pending_modules[factory] = instance;
+    for (auto dependency : instance->dependencies_.list_) {
+      to_construct.push(dependency);
+    }
+  }
+
+  while (!pending_modules.empty()) {
+    std::vector<std::pair<const ModuleFactory*, Module*>> wave;
+    for (const auto& pending : pending_modules) {
+      bool dependencies_started = true;
+      for (auto dependency : pending.second->dependencies_.list_) {
+        if (started_modules_.find(dependency) == started_modules_.end()) {
+          dependencies_started = false;
+          break;
+        }
+      }
+      if (dependencies_started) {
+        wave.emplace_back(pending.first, pending.second);
+      }
+    }
+    ASSERT_LOG(!wave.empty(), "Dependency cycle among remaining modules");
+    for (const auto& member : wave) {
+      pending_modules.erase(member.first);
+      last_instance_ = "starting " + member.second->ToString();
+    }
+    std::vector<std::future<std::chrono::milliseconds>> completions;
+    completions.reserve(wave.size());
+    for (const auto& member : wave) {
+      Module* instance = member.second;
+      completions.emplace_back(std::async(std::launch::async, [instance] {
+        auto start_time = std::chrono::steady_clock::now();
+        instance->Start();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_time);
+      }));
+    }
+    for (size_t i = 0; i < wave.size(); i++) {
+      auto start_duration = completions[i].get();
+      start_timings_.emplace_back(wave[i].second->ToString(), start_duration);
+      start_order_.push_back(wave[i].first);
+      started_modules_[wave[i].first] = wave[i].second;
+      LOG_INFO(
+          "Started %s in %lld ms",
+          wave[i].second->ToString().c_str(),
+          static_cast<long long>(start_duration.count()));
+    }
   }
 }
 
@@ -93,10 +165,17 @@ Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
 
   LOG_DEBUG("Finished starting dependencies and calling Start() of %s", instance->ToString().c_str());
 
+  auto start_time = std::chrono::steady_clock::now();
   instance->Start();
+  auto start_duration =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+  start_timings_.emplace_back(instance->ToString(), start_duration);
   start_order_.push_back(module);
   started_modules_[module] = instance;
-  LOG_DEBUG("Started %s", instance->ToString().c_str());
+  LOG_INFO(
+      "Started %s in %lld ms",
+      instance->ToString().c_str(),
+      static_cast<long long>(start_duration.count()));
   return instance;
 }
 
@@ -112,7 +191,14 @@ void ModuleRegistry::StopAll() {
     instance->second->handler_->Clear();
     instance->second->handler_->WaitUntilStopped(kModuleStopTimeout);
     LOG_INFO("Stopping Module %s", instance->second->ToString().c_str());
+    auto stop_time = std::chrono::steady_clock::now();
     instance->second->Stop();
+    auto stop_duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - stop_time);
+    LOG_INFO(
+        "Stopped %s in %lld ms",
+        instance->second->ToString().c_str(),
+        static_cast<long long>(stop_duration.count()));
   }
   for (auto it = start_order_.rbegin(); it != start_order_.rend(); it++) {
     auto instance = started_modules_.find(*it);
@@ -124,6 +210,7 @@ void ModuleRegistry::StopAll() {
 
   ASSERT(started_modules_.empty());
   start_order_.clear();
+  start_timings_.clear();
 }
 
 os::Handler* ModuleRegistry::GetModuleHandler(const ModuleFactory* module) const {
@@ -143,6 +230,12 @@ void ModuleDumper::DumpState(std::string* output) const {
   auto init_flags_offset = dumpsys::InitFlags::Dump(&builder);
   auto wakelock_offset = WakelockManager::Get().GetDumpsysData(&builder);
 
+  std::stringstream start_timings;
+  for (const auto& elem : module_registry_.start_timings_) {
+    start_timings << elem.first << ": " << elem.second.count() << " ms" << std::endl;
+  }
+  auto start_timings_offset = builder.CreateString(start_timings.str());
+
   std::queue<DumpsysDataFinisher> queue;
   for (auto it = module_registry_.start_order_.rbegin(); it != module_registry_.start_order_.rend(); it++) {
     auto instance = module_registry_.started_modules_.find(*it);
@@ -154,6 +247,7 @@ void ModuleDumper::DumpState(std::string* output) const {
   data_builder.add_title(title);
   data_builder.add_init_flags(init_flags_offset);
   data_builder.add_wakelock_manager_data(wakelock_offset);
+  data_builder.add_module_start_timings(start_timings_offset);
 
   while (!queue.empty()) {
     queue.front()(&data_builder);
@@ -17,10 +17,12 @@
 #pragma once
 
 #include <flatbuffers/flatbuffers.h>
+#include <chrono>
 #include <functional>
 #include <future>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/bind.h"
@@ -156,6 +158,8 @@ class ModuleRegistry {
 
   std::map<const ModuleFactory*, Module*> started_modules_;
   std::vector<const ModuleFactory*> start_order_;
+  // How long each module's Start() took, in start order, so slow bring-up can be attributed
+  std::vector<std::pair<std::string, std::chrono::milliseconds>> start_timings_;
   std::string last_instance_;
 };
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "module.h"
+#include "os/thread.h"
+
+using ::benchmark::State;
+using ::bluetooth::Module;
+using ::bluetooth::ModuleFactory;
+using ::bluetooth::ModuleList;
+using ::bluetooth::ModuleRegistry;
+using ::bluetooth::os::Thread;
+
+namespace {
+
+class BenchmarkModule : public Module {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  void ListDependencies(ModuleList* list) override {}
+
+  void Start() override {}
+
+  void Stop() override {}
+
+  std::string ToString() const override {
+    return std::string("BenchmarkModule");
+  }
+};
+
+const ModuleFactory BenchmarkModule::Factory = ModuleFactory([]() { return new BenchmarkModule(); });
+
+}  // namespace
+
+// Measures the fixed cost the module registry adds around each module's Start() and Stop(), so that
+// regressions in stack bring-up latency coming from the registry itself are tracked release over
+// release
+static void BM_ModuleStartStop(State& state) {
+  for (auto _ : state) {
+    Thread thread("module_benchmark", Thread::Priority::NORMAL);
+    ModuleRegistry registry;
+    ModuleList modules;
+    modules.add<BenchmarkModule>();
+    registry.Start(&modules, &thread);
+    registry.StopAll();
+  }
+}
+BENCHMARK(BM_ModuleStartStop);
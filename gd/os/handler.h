@@ -46,6 +46,10 @@ class Handler : public common::IPostableContext {
   // Enqueue a closure to the queue of this handler
   virtual void Post(common::OnceClosure closure) override;
 
+  // Return true if the caller is running on this handler's thread and no tasks are pending on the
+  // queue, so a closure may run inline without overtaking already-posted work
+  bool CanExecuteInline() const override;
+
   // Remove all pending events from the queue of this handler
   void Clear();
 
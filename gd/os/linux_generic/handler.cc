@@ -67,6 +67,14 @@ void Handler::Post(OnceClosure closure) {
   ASSERT(write_result != -1);
 }
 
+bool Handler::CanExecuteInline() const {
+  if (!thread_->IsSameThread()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !was_cleared() && tasks_->empty();
+}
+
 void Handler::Clear() {
   std::queue<OnceClosure>* tmp = nullptr;
   {
@@ -101,6 +101,35 @@ TEST_F(HandlerTest, once_callback) {
   handler_->Clear();
 }
 
+TEST_F(HandlerTest, can_execute_inline_only_on_handler_thread) {
+  ASSERT_FALSE(handler_->CanExecuteInline());
+  std::promise<bool> can_execute;
+  auto future = can_execute.get_future();
+  handler_->Post(common::BindOnce(
+      [](Handler* handler, std::promise<bool> can_execute) { can_execute.set_value(handler->CanExecuteInline()); },
+      common::Unretained(handler_),
+      std::move(can_execute)));
+  ASSERT_TRUE(future.get());
+  handler_->Clear();
+}
+
+TEST_F(HandlerTest, contextual_callback_invoke_inline) {
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  handler_->Post(common::BindOnce(
+      [](Handler* handler, std::promise<void> promise) {
+        int val = 0;
+        handler->BindOnce([](int* val) { *val = *val + 1; }, common::Unretained(&val)).InvokeInline();
+        // The callback must have run from this frame, not via a post
+        ASSERT_EQ(val, 1);
+        promise.set_value();
+      },
+      common::Unretained(handler_),
+      std::move(promise)));
+  future.wait();
+  handler_->Clear();
+}
+
 TEST_F(HandlerTest, callback_with_promise) {
   std::promise<void> promise;
   auto future = promise.get_future();
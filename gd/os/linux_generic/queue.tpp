@@ -65,11 +65,35 @@ void Queue<T>::RegisterDequeue(Handler* handler, DequeueCallback callback) {
       dequeue_.reactive_semaphore_.GetFd(), callback, base::Closure());
 }
 
+template <typename T>
+void Queue<T>::RegisterDequeueWithWatermark(
+    Handler* handler, DequeueCallback callback, size_t watermark_items, std::chrono::microseconds watermark_timeout) {
+  if (watermark_items <= 1 || watermark_timeout.count() <= 0) {
+    RegisterDequeue(handler, std::move(callback));
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  ASSERT(dequeue_.handler_ == nullptr);
+  ASSERT(dequeue_.reactable_ == nullptr);
+  dequeue_watermark_ = watermark_items;
+  dequeue_watermark_timeout_ = watermark_timeout;
+  dequeue_watermark_alarm_ = std::make_unique<Alarm>(handler);
+  dequeue_watermark_masked_ = false;
+  dequeue_watermark_alarm_armed_ = false;
+  dequeue_watermark_expired_ = false;
+  dequeue_watermark_on_read_ =
+      base::Bind(&Queue<T>::DequeueWatermarkCallbackInternal, base::Unretained(this), std::move(callback));
+  dequeue_.handler_ = handler;
+  dequeue_.reactable_ = dequeue_.handler_->thread_->GetReactor()->Register(
+      dequeue_.reactive_semaphore_.GetFd(), dequeue_watermark_on_read_, base::Closure());
+}
+
 template <typename T>
 void Queue<T>::UnregisterDequeue() {
   Reactor* reactor = nullptr;
   Reactor::Reactable* to_unregister = nullptr;
   bool wait_for_unregister = false;
+  std::unique_ptr<Alarm> alarm_to_destroy;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     ASSERT(dequeue_.reactable_ != nullptr);
@@ -78,11 +102,18 @@ void Queue<T>::UnregisterDequeue() {
     to_unregister = dequeue_.reactable_;
     dequeue_.reactable_ = nullptr;
     dequeue_.handler_ = nullptr;
+    dequeue_watermark_ = 1;
+    dequeue_watermark_masked_ = false;
+    dequeue_watermark_alarm_armed_ = false;
+    dequeue_watermark_expired_ = false;
+    dequeue_watermark_on_read_.Reset();
+    alarm_to_destroy = std::move(dequeue_watermark_alarm_);
   }
   reactor->Unregister(to_unregister);
   if (wait_for_unregister) {
     reactor->WaitForUnregisteredReactable(std::chrono::milliseconds(1000));
   }
+  alarm_to_destroy.reset();
 }
 
 template <typename T>
@@ -103,6 +134,24 @@ std::unique_ptr<T> Queue<T>::TryDequeue() {
   return data;
 }
 
+template <typename T>
+std::vector<std::unique_ptr<T>> Queue<T>::TryDequeueAll() {
+  std::vector<std::unique_ptr<T>> items;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  items.reserve(queue_.size());
+  while (!queue_.empty()) {
+    dequeue_.reactive_semaphore_.Decrease();
+
+    items.push_back(std::move(queue_.front()));
+    queue_.pop();
+
+    enqueue_.reactive_semaphore_.Increase();
+  }
+
+  return items;
+}
+
 template <typename T>
 void Queue<T>::EnqueueCallbackInternal(EnqueueCallback callback) {
   std::unique_ptr<T> data = callback.Run();
@@ -111,4 +160,59 @@ void Queue<T>::EnqueueCallbackInternal(EnqueueCallback callback) {
   enqueue_.reactive_semaphore_.Decrease();
   queue_.push(std::move(data));
   dequeue_.reactive_semaphore_.Increase();
+  if (dequeue_watermark_masked_ && queue_.size() >= dequeue_watermark_) {
+    // The burst reached the watermark before the timer did; wake the consumer now
+    dequeue_watermark_masked_ = false;
+    if (dequeue_watermark_alarm_armed_) {
+      dequeue_watermark_alarm_armed_ = false;
+      dequeue_watermark_alarm_->Cancel();
+    }
+    dequeue_.handler_->thread_->GetReactor()->ModifyRegistration(
+        dequeue_.reactable_, dequeue_watermark_on_read_, base::Closure());
+  }
+}
+
+// Invoked by the reactor when the dequeue fd is readable. Delivers the notification when the watermark (or the
+// timeout) is met; otherwise masks the read interest so the reactor sleeps while the burst keeps building.
+template <typename T>
+void Queue<T>::DequeueWatermarkCallbackInternal(DequeueCallback callback) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (dequeue_.reactable_ == nullptr) {
+      return;
+    }
+    if (queue_.size() < dequeue_watermark_ && !dequeue_watermark_expired_) {
+      dequeue_watermark_masked_ = true;
+      dequeue_.handler_->thread_->GetReactor()->ModifyRegistration(dequeue_.reactable_, base::Closure(),
+                                                                   base::Closure());
+      if (!dequeue_watermark_alarm_armed_) {
+        dequeue_watermark_alarm_armed_ = true;
+        dequeue_watermark_alarm_->Schedule(
+            base::BindOnce(&Queue<T>::OnDequeueWatermarkTimeout, base::Unretained(this)),
+            std::chrono::ceil<std::chrono::milliseconds>(dequeue_watermark_timeout_));
+      }
+      return;
+    }
+    dequeue_watermark_expired_ = false;
+    if (dequeue_watermark_alarm_armed_) {
+      dequeue_watermark_alarm_armed_ = false;
+      dequeue_watermark_alarm_->Cancel();
+    }
+  }
+  callback.Run();
+}
+
+// Runs on the dequeue handler when a partial batch has waited long enough; unmasks the read interest and lets the
+// next reactor iteration deliver whatever is queued.
+template <typename T>
+void Queue<T>::OnDequeueWatermarkTimeout() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  dequeue_watermark_alarm_armed_ = false;
+  if (!dequeue_watermark_masked_) {
+    return;
+  }
+  dequeue_watermark_masked_ = false;
+  dequeue_watermark_expired_ = true;
+  dequeue_.handler_->thread_->GetReactor()->ModifyRegistration(
+      dequeue_.reactable_, dequeue_watermark_on_read_, base::Closure());
 }
@@ -18,12 +18,16 @@
 
 #include <unistd.h>
 
+#include <chrono>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
+#include "os/alarm.h"
 #include "os/handler.h"
 #ifdef OS_LINUX_GENERIC
 #include "os/linux_generic/reactive_semaphore.h"
@@ -52,6 +56,25 @@ class IQueueDequeue {
   virtual void RegisterDequeue(Handler* handler, DequeueCallback callback) = 0;
   virtual void UnregisterDequeue() = 0;
   virtual std::unique_ptr<T> TryDequeue() = 0;
+
+  // Same as RegisterDequeue, but coalesce wakeups: |callback| is invoked once |watermark_items| pieces of data are
+  // queued, or once |watermark_timeout| has passed since the first undelivered piece, whichever comes first. The
+  // default implementation ignores the watermark and notifies per item; implementations may override it.
+  virtual void RegisterDequeueWithWatermark(
+      Handler* handler, DequeueCallback callback, size_t /* watermark_items */,
+      std::chrono::microseconds /* watermark_timeout */) {
+    RegisterDequeue(handler, std::move(callback));
+  }
+
+  // Drain every item currently in the queue. The default implementation dequeues one item at a
+  // time; implementations may override it to drain under a single lock.
+  virtual std::vector<std::unique_ptr<T>> TryDequeueAll() {
+    std::vector<std::unique_ptr<T>> items;
+    for (std::unique_ptr<T> item = TryDequeue(); item != nullptr; item = TryDequeue()) {
+      items.push_back(std::move(item));
+    }
+    return items;
+  }
 };
 
 template <typename T>
@@ -74,19 +97,42 @@ class Queue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
   // Register |callback| that will be called on |handler| when the queue has at least one piece of data ready
   // for dequeue. This will cause a crash if handler or callback has already been registered before.
   void RegisterDequeue(Handler* handler, DequeueCallback callback) override;
+  // Like RegisterDequeue, but |callback| fires on |handler| once |watermark_items| pieces of data are queued, or
+  // once |watermark_timeout| has passed since data became ready, whichever comes first. A burst of enqueues then
+  // costs one reactor wakeup instead of one per item. The callback should drain with TryDequeueAll().
+  void RegisterDequeueWithWatermark(
+      Handler* handler, DequeueCallback callback, size_t watermark_items,
+      std::chrono::microseconds watermark_timeout) override;
   // Unregister current DequeueCallback from this queue, this will cause a crash if not registered yet.
   void UnregisterDequeue() override;
 
   // Try to dequeue an item from this queue. Return nullptr when there is nothing in the queue.
   std::unique_ptr<T> TryDequeue() override;
 
+  // Drain every item currently in the queue under a single lock. This also consumes the pending
+  // dequeue wakeups, so the DequeueCallback fires once per burst instead of once per item.
+  std::vector<std::unique_ptr<T>> TryDequeueAll() override;
+
  private:
   void EnqueueCallbackInternal(EnqueueCallback callback);
+  void DequeueWatermarkCallbackInternal(DequeueCallback callback);
+  void OnDequeueWatermarkTimeout();
   // An internal queue that holds at most |capacity| pieces of data
   std::queue<std::unique_ptr<T>> queue_;
   // A mutex that guards data in this queue
   std::mutex mutex_;
 
+  // Watermark state for RegisterDequeueWithWatermark. While below the watermark, the dequeue fd's read interest is
+  // masked and a single-shot alarm bounds the delivery delay; the enqueue side unmasks it as soon as the watermark
+  // is crossed. All fields are guarded by |mutex_|, except the alarm which has its own internal lock.
+  size_t dequeue_watermark_ = 1;
+  std::chrono::microseconds dequeue_watermark_timeout_{0};
+  std::unique_ptr<Alarm> dequeue_watermark_alarm_;
+  common::Closure dequeue_watermark_on_read_;
+  bool dequeue_watermark_masked_ = false;
+  bool dequeue_watermark_alarm_armed_ = false;
+  bool dequeue_watermark_expired_ = false;
+
   class QueueEndpoint {
    public:
 #ifdef OS_LINUX_GENERIC
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <chrono>
 #include <future>
 
 #include "benchmark/benchmark.h"
@@ -137,6 +138,42 @@ class TestDequeueEnd {
   }
 };
 
+class TestBatchDequeueEnd {
+ public:
+  explicit TestBatchDequeueEnd(int64_t count, Queue<std::string>* queue, Handler* handler, std::promise<void>* promise)
+      : count_(count), handler_(handler), queue_(queue), promise_(promise) {}
+
+  void RegisterDequeue() {
+    handler_->Post(common::BindOnce(&TestBatchDequeueEnd::handle_register_dequeue, common::Unretained(this)));
+  }
+
+  void BatchDequeueCallbackForTest() {
+    auto packets = queue_->TryDequeueAll();
+    for (auto& packet : packets) {
+      buffer_.push(std::move(*packet));
+      count_--;
+    }
+
+    if (count_ <= 0) {
+      queue_->UnregisterDequeue();
+      promise_->set_value();
+    }
+  }
+
+  std::queue<std::string> buffer_;
+  int64_t count_;
+
+ private:
+  Handler* handler_;
+  Queue<std::string>* queue_;
+  std::promise<void>* promise_;
+
+  void handle_register_dequeue() {
+    queue_->RegisterDequeue(
+        handler_, common::Bind(&TestBatchDequeueEnd::BatchDequeueCallbackForTest, common::Unretained(this)));
+  }
+};
+
 BENCHMARK_DEFINE_F(BM_QueuePerformance, send_packet_vary_by_packet_num)(State& state) {
   for (auto _ : state) {
     int64_t num_data_to_send_ = state.range(0);
@@ -170,6 +207,108 @@ BENCHMARK_REGISTER_F(BM_QueuePerformance, send_packet_vary_by_packet_num)
     ->Iterations(100)
     ->UseRealTime();
 
+BENCHMARK_DEFINE_F(BM_QueuePerformance, send_burst_batch_dequeue_vary_by_burst_size)(State& state) {
+  for (auto _ : state) {
+    int64_t num_data_to_send_ = state.range(0);
+    Queue<std::string> queue(num_data_to_send_);
+
+    // register batched dequeue, draining the whole backlog per reactor wakeup
+    std::promise<void> dequeue_promise;
+    auto dequeue_future = dequeue_promise.get_future();
+    TestBatchDequeueEnd test_dequeue_end(num_data_to_send_, &queue, enqueue_handler_, &dequeue_promise);
+    test_dequeue_end.RegisterDequeue();
+
+    // Push data to enqueue end buffer and register enqueue
+    std::promise<void> enqueue_promise;
+    TestEnqueueEnd test_enqueue_end(num_data_to_send_, &queue, enqueue_handler_, &enqueue_promise);
+    for (int i = 0; i < num_data_to_send_; i++) {
+      std::string data = std::to_string(1);
+      test_enqueue_end.push(std::move(data));
+    }
+    dequeue_future.wait();
+  }
+
+  state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
+};
+
+BENCHMARK_REGISTER_F(BM_QueuePerformance, send_burst_batch_dequeue_vary_by_burst_size)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Iterations(100)
+    ->UseRealTime();
+
+class TestWatermarkDequeueEnd {
+ public:
+  explicit TestWatermarkDequeueEnd(int64_t count, Queue<std::string>* queue, Handler* handler,
+                                   std::promise<void>* promise)
+      : count_(count), handler_(handler), queue_(queue), promise_(promise) {}
+
+  void RegisterDequeueWithWatermark(size_t watermark_items, std::chrono::microseconds watermark_timeout) {
+    handler_->Post(common::BindOnce(&TestWatermarkDequeueEnd::handle_register_dequeue, common::Unretained(this),
+                                    watermark_items, watermark_timeout));
+  }
+
+  void WatermarkDequeueCallbackForTest() {
+    auto packets = queue_->TryDequeueAll();
+    for (auto& packet : packets) {
+      buffer_.push(std::move(*packet));
+      count_--;
+    }
+
+    if (count_ <= 0) {
+      queue_->UnregisterDequeue();
+      promise_->set_value();
+    }
+  }
+
+  std::queue<std::string> buffer_;
+  int64_t count_;
+
+ private:
+  Handler* handler_;
+  Queue<std::string>* queue_;
+  std::promise<void>* promise_;
+
+  void handle_register_dequeue(size_t watermark_items, std::chrono::microseconds watermark_timeout) {
+    queue_->RegisterDequeueWithWatermark(
+        handler_,
+        common::Bind(&TestWatermarkDequeueEnd::WatermarkDequeueCallbackForTest, common::Unretained(this)),
+        watermark_items, watermark_timeout);
+  }
+};
+
+BENCHMARK_DEFINE_F(BM_QueuePerformance, send_burst_watermark_dequeue_vary_by_burst_size)(State& state) {
+  for (auto _ : state) {
+    int64_t num_data_to_send_ = state.range(0);
+    Queue<std::string> queue(num_data_to_send_);
+
+    // register watermark dequeue, waking the reactor once per batch instead of once per packet
+    std::promise<void> dequeue_promise;
+    auto dequeue_future = dequeue_promise.get_future();
+    TestWatermarkDequeueEnd test_dequeue_end(num_data_to_send_, &queue, enqueue_handler_, &dequeue_promise);
+    test_dequeue_end.RegisterDequeueWithWatermark(16, std::chrono::microseconds(1000));
+
+    // Push data to enqueue end buffer and register enqueue
+    std::promise<void> enqueue_promise;
+    TestEnqueueEnd test_enqueue_end(num_data_to_send_, &queue, enqueue_handler_, &enqueue_promise);
+    for (int i = 0; i < num_data_to_send_; i++) {
+      std::string data = std::to_string(1);
+      test_enqueue_end.push(std::move(data));
+    }
+    dequeue_future.wait();
+  }
+
+  state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
+};
+
+BENCHMARK_REGISTER_F(BM_QueuePerformance, send_burst_watermark_dequeue_vary_by_burst_size)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Iterations(100)
+    ->UseRealTime();
+
 BENCHMARK_DEFINE_F(BM_QueuePerformance, send_10000_packet_vary_by_packet_size)(State& state) {
   for (auto _ : state) {
     int64_t num_data_to_send_ = 10000;
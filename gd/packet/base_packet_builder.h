@@ -38,6 +38,19 @@ class BasePacketBuilder {
   // Write to the vector with the given iterator.
   virtual void Serialize(BitInserter& it) const = 0;
 
+  // Serialize into a scratch buffer that is reused across calls on the same thread. The buffer
+  // keeps its capacity between packets, so steady-state serialization performs no allocation.
+  // The returned reference is only valid until the next call on the same thread: consume or copy
+  // the bytes before serializing another packet.
+  const std::vector<uint8_t>& SerializeToScratchBuffer() const {
+    thread_local std::vector<uint8_t> scratch_buffer;
+    scratch_buffer.clear();
+    scratch_buffer.reserve(size());
+    BitInserter inserter(scratch_buffer);
+    Serialize(inserter);
+    return scratch_buffer;
+  }
+
   void SetFlushable(bool is_flushable) {
     is_flushable_ = is_flushable;
   }
@@ -122,7 +122,7 @@ uint8_t Iterator<little_endian>::operator*() const {
   ASSERT_LOG(index_ < end_ && !(begin_ > index_), "Index %zu out of bounds: [%zu,%zu)", index_, begin_, end_);
   size_t index = index_;
 
-  for (auto view : data_) {
+  for (const auto& view : data_) {
     if (index < view.size()) {
       return view[index];
     }
@@ -132,6 +132,28 @@ uint8_t Iterator<little_endian>::operator*() const {
   return 0;
 }
 
+template <bool little_endian>
+void Iterator<little_endian>::ExtractBytes(uint8_t* dest, size_t length) {
+  ASSERT_LOG(
+      NumBytesRemaining() >= length, "Extracting %zu bytes with %zu remaining", length, NumBytesRemaining());
+  size_t index = index_;
+  size_t copied = 0;
+  for (const auto& view : data_) {
+    if (index >= view.size()) {
+      index -= view.size();
+      continue;
+    }
+    while (index < view.size() && copied < length) {
+      dest[copied++] = view[index++];
+    }
+    if (copied == length) {
+      break;
+    }
+    index = 0;
+  }
+  index_ += length;
+}
+
 template <bool little_endian>
 size_t Iterator<little_endian>::NumBytesRemaining() const {
   if (end_ > index_ && !(begin_ > index_)) {
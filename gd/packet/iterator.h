@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <forward_list>
 #include <memory>
@@ -62,17 +63,17 @@ class Iterator : public std::iterator<std::random_access_iterator_tag, uint8_t>
 
   Iterator Subrange(size_t index, size_t length) const;
 
-  // Get the next sizeof(FixedWidthPODType) bytes and return the filled type
+  // Get the next sizeof(FixedWidthPODType) bytes and return the filled type.
+  // The whole field is validated once and copied with ExtractBytes(), instead
+  // of bounds-checking and walking the fragment list for every byte.
   template <typename FixedWidthPODType, typename std::enable_if<std::is_pod<FixedWidthPODType>::value, int>::type = 0>
   FixedWidthPODType extract() {
     static_assert(std::is_pod<FixedWidthPODType>::value, "Iterator::extract requires a fixed-width type.");
     FixedWidthPODType extracted_value{};
     uint8_t* value_ptr = (uint8_t*)&extracted_value;
-
-    for (size_t i = 0; i < sizeof(FixedWidthPODType); i++) {
-      size_t index = (little_endian ? i : sizeof(FixedWidthPODType) - i - 1);
-      value_ptr[index] = this->operator*();
-      this->operator++();
+    ExtractBytes(value_ptr, sizeof(FixedWidthPODType));
+    if (!little_endian) {
+      std::reverse(value_ptr, value_ptr + sizeof(FixedWidthPODType));
     }
     return extracted_value;
   }
@@ -80,15 +81,19 @@ class Iterator : public std::iterator<std::random_access_iterator_tag, uint8_t>
   template <typename T, typename std::enable_if<std::is_base_of_v<CustomFieldFixedSizeInterface<T>, T>, int>::type = 0>
   T extract() {
     T extracted_value{};
-    for (size_t i = 0; i < CustomFieldFixedSizeInterface<T>::length(); i++) {
-      size_t index = (little_endian ? i : CustomFieldFixedSizeInterface<T>::length() - i - 1);
-      extracted_value.data()[index] = this->operator*();
-      this->operator++();
+    uint8_t* value_ptr = extracted_value.data();
+    ExtractBytes(value_ptr, CustomFieldFixedSizeInterface<T>::length());
+    if (!little_endian) {
+      std::reverse(value_ptr, value_ptr + CustomFieldFixedSizeInterface<T>::length());
     }
     return extracted_value;
   }
 
  private:
+  // Copies the next |length| bytes into |dest| and advances the iterator,
+  // with a single bounds check for the whole run.
+  void ExtractBytes(uint8_t* dest, size_t length);
+
   std::forward_list<View> data_;
   size_t index_;
   size_t begin_;
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace packet {
+
+namespace {
+
+std::unique_ptr<RawBuilder> build_payload(size_t payload_size) {
+  auto builder = std::make_unique<RawBuilder>();
+  builder->AddOctets(std::vector<uint8_t>(payload_size, 0x42));
+  return builder;
+}
+
+}  // namespace
+
+static void BM_SerializeToFreshVector(State& state) {
+  auto builder = build_payload(state.range(0));
+  for (auto _ : state) {
+    std::vector<uint8_t> bytes;
+    BitInserter inserter(bytes);
+    builder->Serialize(inserter);
+    ::benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_SerializeToFreshVector)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_SerializeToScratchBuffer(State& state) {
+  auto builder = build_payload(state.range(0));
+  for (auto _ : state) {
+    const std::vector<uint8_t>& bytes = builder->SerializeToScratchBuffer();
+    ::benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_SerializeToScratchBuffer)->Arg(10)->Arg(100)->Arg(1000);
+
+}  // namespace packet
+}  // namespace bluetooth
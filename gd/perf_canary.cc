@@ -0,0 +1,700 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone performance canary for the GD stack.
+ *
+ * Unlike the cert suite this needs no gRPC facade or Python runner: the
+ * binary links the stack over hal/hci_hal_host.cc against a running
+ * rootcanal instance, attaches one extra raw H4 socket per simulated peer
+ * (each TCP connection is its own rootcanal device), and replays a
+ * parameterized traffic mix:
+ *
+ *   - N LE connections brought up in parallel,
+ *   - M ATT notification-sized packets per second from every peer,
+ *   - an A2DP-like periodic outbound ACL stream on every connection.
+ *
+ * At the end it reports connection setup latency, receive inter-arrival
+ * and transmit pacing percentiles, plus heap allocation counts, so a run
+ * before and after a change gives a quick regression signal without any
+ * test infrastructure.
+ *
+ * Usage:
+ *   bluetooth_perf_canary --rootcanal-port=6402 --connections=4 \
+ *       --notifications-per-second=100 --duration-seconds=30
+ */
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdio>
+#include <future>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/bind.h"
+#include "common/init_flags.h"
+#include "hal/hci_hal_host.h"
+#include "hci/acl_manager.h"
+#include "hci/acl_manager/le_acl_connection.h"
+#include "hci/acl_manager/le_connection_callbacks.h"
+#include "hci/address_with_type.h"
+#include "os/handler.h"
+#include "os/log.h"
+#include "os/repeating_alarm.h"
+#include "os/thread.h"
+#include "packet/raw_builder.h"
+#include "stack_manager.h"
+
+using ::bluetooth::ModuleList;
+using ::bluetooth::StackManager;
+using ::bluetooth::hal::HciHalHostRootcanalConfig;
+using ::bluetooth::hci::Address;
+using ::bluetooth::hci::AddressType;
+using ::bluetooth::hci::AddressWithType;
+using ::bluetooth::os::Handler;
+using ::bluetooth::os::Thread;
+
+namespace {
+
+// Process-wide allocation counters; reported per scenario so a change in
+// per-packet allocation behavior shows up directly in the canary output.
+std::atomic<uint64_t> g_alloc_count{0};
+std::atomic<uint64_t> g_alloc_bytes{0};
+
+struct AllocSnapshot {
+  uint64_t count;
+  uint64_t bytes;
+};
+
+AllocSnapshot TakeAllocSnapshot() {
+  return {g_alloc_count.load(), g_alloc_bytes.load()};
+}
+
+// Timestamped samples with percentile reporting
+class LatencyStats {
+ public:
+  void Record(uint64_t value_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    samples_.push_back(value_us);
+  }
+
+  size_t Count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return samples_.size();
+  }
+
+  uint64_t Percentile(double percentile) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.empty()) {
+      return 0;
+    }
+    std::vector<uint64_t> sorted = samples_;
+    std::sort(sorted.begin(), sorted.end());
+    size_t index = static_cast<size_t>(percentile * (sorted.size() - 1));
+    return sorted[index];
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<uint64_t> samples_;
+};
+
+uint64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// A raw H4-over-TCP rootcanal device acting as an advertising LE
+// peripheral. Once the stack under test connects to it, it floods ATT
+// notification-sized ACL packets upstream at the configured rate.
+class RootcanalPeer {
+ public:
+  ~RootcanalPeer() {
+    Shutdown();
+  }
+
+  bool Connect(uint16_t port) {
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+      return false;
+    }
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+      close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    return true;
+  }
+
+  // Reset the controller, learn our address and start connectable
+  // advertising. Synchronous; every command waits for its completion.
+  bool Bringup() {
+    if (!SendCommandAndWait(0x0c03 /* Reset */, {})) {
+      return false;
+    }
+    std::vector<uint8_t> bd_addr_params;
+    if (!SendCommandAndWait(0x1009 /* Read BD_ADDR */, {}, &bd_addr_params) ||
+        bd_addr_params.size() < 7) {
+      return false;
+    }
+    std::memcpy(address_.address.data(), bd_addr_params.data() + 1, 6);
+
+    // ADV_IND, 20ms interval, public own address, all channels
+    std::vector<uint8_t> adv_params = {0x20, 0x00, 0x20, 0x00, 0x00, 0x00,
+                                       0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                       0x00, 0x07, 0x00};
+    if (!SendCommandAndWait(0x2006 /* LE Set Advertising Parameters */,
+                            adv_params)) {
+      return false;
+    }
+    std::vector<uint8_t> adv_data(32, 0x00);
+    adv_data[0] = 3;     // significant octets
+    adv_data[1] = 0x02;  // AD length
+    adv_data[2] = 0x01;  // AD type: flags
+    adv_data[3] = 0x06;  // LE general discoverable, no BR/EDR
+    if (!SendCommandAndWait(0x2008 /* LE Set Advertising Data */, adv_data)) {
+      return false;
+    }
+    if (!SendCommandAndWait(0x200a /* LE Set Advertise Enable */, {0x01})) {
+      return false;
+    }
+
+    reader_ = std::thread(&RootcanalPeer::ReaderLoop, this);
+    return true;
+  }
+
+  Address address() const {
+    return address_;
+  }
+
+  bool WaitForConnection(std::chrono::seconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return connected_cv_.wait_for(lock, timeout,
+                                  [this] { return handle_valid_; });
+  }
+
+  // Send ATT notification-shaped packets upstream until |running| clears
+  void NotificationLoop(double per_second, std::atomic<bool>* running) {
+    if (per_second <= 0) {
+      return;
+    }
+    auto interval =
+        std::chrono::microseconds(static_cast<uint64_t>(1000000.0 / per_second));
+    while (running->load()) {
+      std::this_thread::sleep_for(interval);
+      uint16_t handle;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!handle_valid_) {
+          continue;
+        }
+        handle = handle_;
+      }
+      SendNotification(handle);
+    }
+  }
+
+  void Shutdown() {
+    if (fd_ >= 0) {
+      shutdown(fd_, SHUT_RDWR);
+    }
+    if (reader_.joinable()) {
+      reader_.join();
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+
+ private:
+  bool SendCommandAndWait(uint16_t opcode,
+                          const std::vector<uint8_t>& params,
+                          std::vector<uint8_t>* return_params = nullptr) {
+    std::vector<uint8_t> packet;
+    packet.push_back(0x01);  // H4 command
+    packet.push_back(opcode & 0xff);
+    packet.push_back(opcode >> 8);
+    packet.push_back(params.size());
+    packet.insert(packet.end(), params.begin(), params.end());
+    if (!WriteAll(packet.data(), packet.size())) {
+      return false;
+    }
+
+    // Consume packets until the matching Command Complete shows up
+    for (;;) {
+      uint8_t type;
+      std::vector<uint8_t> payload;
+      if (!ReadPacket(&type, &payload)) {
+        return false;
+      }
+      if (type != 0x04 || payload.size() < 2) {
+        continue;
+      }
+      uint8_t event_code = payload[0];
+      if (event_code != 0x0e /* Command Complete */ || payload.size() < 6) {
+        continue;
+      }
+      uint16_t complete_opcode = payload[3] | (payload[4] << 8);
+      if (complete_opcode != opcode) {
+        continue;
+      }
+      if (return_params != nullptr) {
+        return_params->assign(payload.begin() + 5, payload.end());
+      }
+      return payload[5] == 0x00;  // status
+    }
+  }
+
+  void ReaderLoop() {
+    for (;;) {
+      uint8_t type;
+      std::vector<uint8_t> payload;
+      if (!ReadPacket(&type, &payload)) {
+        return;
+      }
+      if (type != 0x04 || payload.size() < 5) {
+        continue;
+      }
+      // LE meta / connection complete carries our connection handle
+      if (payload[0] == 0x3e && (payload[2] == 0x01 || payload[2] == 0x0a) &&
+          payload[3] == 0x00) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handle_ = payload[4] | (payload[5] << 8);
+        handle_valid_ = true;
+        connected_cv_.notify_all();
+      }
+    }
+  }
+
+  void SendNotification(uint16_t handle) {
+    const uint16_t value_len = 20;  // typical characteristic payload
+    const uint16_t att_len = 3 + value_len;
+    std::vector<uint8_t> packet;
+    packet.push_back(0x02);  // H4 ACL
+    packet.push_back(handle & 0xff);
+    packet.push_back((handle >> 8) & 0x0f);  // PB/BC: start, point-to-point
+    packet.push_back((att_len + 4) & 0xff);
+    packet.push_back((att_len + 4) >> 8);
+    packet.push_back(att_len & 0xff);  // L2CAP length
+    packet.push_back(att_len >> 8);
+    packet.push_back(0x04);  // ATT fixed channel
+    packet.push_back(0x00);
+    packet.push_back(0x1b);  // Handle Value Notification
+    packet.push_back(0x2a);  // attribute handle
+    packet.push_back(0x00);
+    for (uint16_t i = 0; i < value_len; i++) {
+      packet.push_back(i);
+    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    WriteAll(packet.data(), packet.size());
+  }
+
+  bool WriteAll(const uint8_t* data, size_t length) {
+    size_t written = 0;
+    while (written < length) {
+      ssize_t ret = write(fd_, data + written, length - written);
+      if (ret <= 0) {
+        return false;
+      }
+      written += ret;
+    }
+    return true;
+  }
+
+  bool ReadAll(uint8_t* data, size_t length) {
+    size_t received = 0;
+    while (received < length) {
+      ssize_t ret = read(fd_, data + received, length - received);
+      if (ret <= 0) {
+        return false;
+      }
+      received += ret;
+    }
+    return true;
+  }
+
+  bool ReadPacket(uint8_t* type, std::vector<uint8_t>* payload) {
+    if (!ReadAll(type, 1)) {
+      return false;
+    }
+    if (*type == 0x04) {  // event
+      uint8_t header[2];
+      if (!ReadAll(header, 2)) {
+        return false;
+      }
+      payload->resize(2 + header[1]);
+      (*payload)[0] = header[0];
+      (*payload)[1] = header[1];
+      return ReadAll(payload->data() + 2, header[1]);
+    }
+    if (*type == 0x02) {  // ACL
+      uint8_t header[4];
+      if (!ReadAll(header, 4)) {
+        return false;
+      }
+      uint16_t length = header[2] | (header[3] << 8);
+      payload->resize(4 + length);
+      std::memcpy(payload->data(), header, 4);
+      return ReadAll(payload->data() + 4, length);
+    }
+    LOG_WARN("Unexpected H4 packet type 0x%02x", *type);
+    return false;
+  }
+
+  int fd_ = -1;
+  Address address_;
+  std::thread reader_;
+  std::mutex mutex_;
+  std::mutex write_mutex_;
+  std::condition_variable connected_cv_;
+  uint16_t handle_ = 0;
+  bool handle_valid_ = false;
+};
+
+// Collects connections as they come up and drives per-connection traffic:
+// counts/timestamps inbound packets and paces an A2DP-like outbound stream.
+class CanaryConnectionCallbacks
+    : public bluetooth::hci::acl_manager::LeConnectionCallbacks {
+ public:
+  CanaryConnectionCallbacks(Handler* handler, uint64_t a2dp_packet_bytes,
+                            std::chrono::milliseconds a2dp_interval)
+      : handler_(handler),
+        a2dp_packet_bytes_(a2dp_packet_bytes),
+        a2dp_interval_(a2dp_interval) {}
+
+  void OnLeConnectSuccess(
+      AddressWithType address_with_type,
+      std::unique_ptr<bluetooth::hci::acl_manager::LeAclConnection> connection)
+      override {
+    LOG_INFO("Connected to %s", address_with_type.ToString().c_str());
+    auto stream = std::make_unique<ConnectionStream>(this, std::move(connection));
+    stream->Start();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      streams_.push_back(std::move(stream));
+    }
+    connected_cv_.notify_all();
+  }
+
+  void OnLeConnectFail(AddressWithType address_with_type,
+                       bluetooth::hci::ErrorCode reason) override {
+    LOG_ERROR("Connection to %s failed: 0x%02hhx",
+              address_with_type.ToString().c_str(),
+              static_cast<uint8_t>(reason));
+    failed_connections_++;
+    connected_cv_.notify_all();
+  }
+
+  bool WaitForConnections(size_t expected, std::chrono::seconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return connected_cv_.wait_for(lock, timeout, [this, expected] {
+      return streams_.size() + failed_connections_ >= expected;
+    });
+  }
+
+  void StopAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& stream : streams_) {
+      stream->Stop();
+    }
+    streams_.clear();
+  }
+
+  size_t connected_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_.size();
+  }
+
+  LatencyStats rx_interarrival_us_;
+  LatencyStats tx_jitter_us_;
+  std::atomic<uint64_t> rx_packets_{0};
+  std::atomic<uint64_t> tx_packets_{0};
+
+ private:
+  // Per-connection RX accounting and TX pacing state
+  class ConnectionStream {
+   public:
+    ConnectionStream(
+        CanaryConnectionCallbacks* owner,
+        std::unique_ptr<bluetooth::hci::acl_manager::LeAclConnection> connection)
+        : owner_(owner),
+          connection_(std::move(connection)),
+          tx_alarm_(owner->handler_) {}
+
+    void Start() {
+      connection_->GetAclQueueEnd()->RegisterDequeue(
+          owner_->handler_,
+          bluetooth::common::Bind(&ConnectionStream::OnPacketReceived,
+                                  bluetooth::common::Unretained(this)));
+      if (owner_->a2dp_packet_bytes_ > 0) {
+        tx_alarm_.Schedule(
+            bluetooth::common::Bind(&ConnectionStream::OnTxTick,
+                                    bluetooth::common::Unretained(this)),
+            owner_->a2dp_interval_);
+      }
+    }
+
+    void Stop() {
+      tx_alarm_.Cancel();
+      connection_->GetAclQueueEnd()->UnregisterDequeue();
+      if (tx_registered_) {
+        connection_->GetAclQueueEnd()->UnregisterEnqueue();
+        tx_registered_ = false;
+      }
+    }
+
+   private:
+    void OnPacketReceived() {
+      auto packet = connection_->GetAclQueueEnd()->TryDequeue();
+      if (packet == nullptr) {
+        return;
+      }
+      uint64_t now_us = NowUs();
+      if (last_rx_us_ != 0) {
+        owner_->rx_interarrival_us_.Record(now_us - last_rx_us_);
+      }
+      last_rx_us_ = now_us;
+      owner_->rx_packets_++;
+    }
+
+    void OnTxTick() {
+      uint64_t now_us = NowUs();
+      if (last_tick_us_ != 0) {
+        uint64_t expected_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                owner_->a2dp_interval_)
+                .count();
+        uint64_t delta_us = now_us - last_tick_us_;
+        owner_->tx_jitter_us_.Record(delta_us > expected_us
+                                         ? delta_us - expected_us
+                                         : expected_us - delta_us);
+      }
+      last_tick_us_ = now_us;
+      pending_tx_packets_++;
+      if (!tx_registered_) {
+        tx_registered_ = true;
+        connection_->GetAclQueueEnd()->RegisterEnqueue(
+            owner_->handler_,
+            bluetooth::common::Bind(&ConnectionStream::OnTxReady,
+                                    bluetooth::common::Unretained(this)));
+      }
+    }
+
+    std::unique_ptr<bluetooth::packet::BasePacketBuilder> OnTxReady() {
+      // Raw L2CAP frame shaped like one A2DP media packet
+      std::vector<uint8_t> payload(owner_->a2dp_packet_bytes_, 0x5a);
+      payload[0] = (owner_->a2dp_packet_bytes_ - 4) & 0xff;
+      payload[1] = (owner_->a2dp_packet_bytes_ - 4) >> 8;
+      payload[2] = 0x04;
+      payload[3] = 0x00;
+      owner_->tx_packets_++;
+      if (--pending_tx_packets_ == 0) {
+        connection_->GetAclQueueEnd()->UnregisterEnqueue();
+        tx_registered_ = false;
+      }
+      return std::make_unique<bluetooth::packet::RawBuilder>(payload);
+    }
+
+    CanaryConnectionCallbacks* owner_;
+    std::unique_ptr<bluetooth::hci::acl_manager::LeAclConnection> connection_;
+    bluetooth::os::RepeatingAlarm tx_alarm_;
+    uint64_t last_rx_us_ = 0;
+    uint64_t last_tick_us_ = 0;
+    uint64_t pending_tx_packets_ = 0;
+    bool tx_registered_ = false;
+  };
+
+  Handler* handler_;
+  uint64_t a2dp_packet_bytes_;
+  std::chrono::milliseconds a2dp_interval_;
+  std::mutex mutex_;
+  std::condition_variable connected_cv_;
+  std::vector<std::unique_ptr<ConnectionStream>> streams_;
+  size_t failed_connections_ = 0;
+};
+
+void PrintReport(const char* name, const LatencyStats& stats) {
+  printf("  %-24s samples=%zu p50=%" PRIu64 "us p95=%" PRIu64 "us p99=%" PRIu64
+         "us\n",
+         name, stats.Count(), stats.Percentile(0.50), stats.Percentile(0.95),
+         stats.Percentile(0.99));
+}
+
+}  // namespace
+
+// Count every heap allocation made by the process while scenarios run
+void* operator new(std::size_t size) {
+  g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+  g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  void* ptr = malloc(size);
+  if (ptr == nullptr) {
+    abort();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  free(ptr);
+}
+
+int main(int argc, const char** argv) {
+  uint16_t rootcanal_port = 6402;
+  size_t num_connections = 2;
+  double notifications_per_second = 50;
+  uint64_t a2dp_packet_bytes = 668;  // SBC media packet on a 672 octet MTU
+  std::chrono::milliseconds a2dp_interval(14);
+  int duration_seconds = 30;
+
+  const std::string arg_rootcanal_port = "--rootcanal-port=";
+  const std::string arg_connections = "--connections=";
+  const std::string arg_notifications = "--notifications-per-second=";
+  const std::string arg_a2dp_bytes = "--a2dp-packet-bytes=";
+  const std::string arg_duration = "--duration-seconds=";
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.find(arg_rootcanal_port) == 0) {
+      rootcanal_port = std::stoi(arg.substr(arg_rootcanal_port.size()));
+    }
+    if (arg.find(arg_connections) == 0) {
+      num_connections = std::stoul(arg.substr(arg_connections.size()));
+    }
+    if (arg.find(arg_notifications) == 0) {
+      notifications_per_second = std::stod(arg.substr(arg_notifications.size()));
+    }
+    if (arg.find(arg_a2dp_bytes) == 0) {
+      a2dp_packet_bytes = std::stoul(arg.substr(arg_a2dp_bytes.size()));
+    }
+    if (arg.find(arg_duration) == 0) {
+      duration_seconds = std::stoi(arg.substr(arg_duration.size()));
+    }
+  }
+
+  bluetooth::common::InitFlags::SetAllForTesting();
+  HciHalHostRootcanalConfig::Get()->SetPort(rootcanal_port);
+
+  // Attach the simulated peers first so they are advertising before the
+  // stack under test starts initiating
+  std::vector<std::unique_ptr<RootcanalPeer>> peers;
+  for (size_t i = 0; i < num_connections; i++) {
+    auto peer = std::make_unique<RootcanalPeer>();
+    if (!peer->Connect(rootcanal_port) || !peer->Bringup()) {
+      LOG_ERROR("Unable to attach peer %zu to rootcanal on port %u", i,
+                rootcanal_port);
+      return 1;
+    }
+    peers.push_back(std::move(peer));
+  }
+
+  Thread stack_thread("canary_stack_thread", Thread::Priority::REAL_TIME);
+  StackManager stack_manager;
+  ModuleList modules;
+  modules.add<bluetooth::hci::AclManager>();
+  stack_manager.StartUp(&modules, &stack_thread);
+
+  Thread user_thread("canary_user_thread", Thread::Priority::NORMAL);
+  Handler user_handler(&user_thread);
+  CanaryConnectionCallbacks callbacks(&user_handler, a2dp_packet_bytes,
+                                      a2dp_interval);
+
+  auto* acl_manager =
+      stack_manager.GetInstance<bluetooth::hci::AclManager>();
+  acl_manager->RegisterLeCallbacks(&callbacks, &user_handler);
+  acl_manager->SetPrivacyPolicyForInitiatorAddress(
+      bluetooth::hci::LeAddressManager::AddressPolicy::USE_PUBLIC_ADDRESS,
+      AddressWithType{}, std::chrono::minutes(7), std::chrono::minutes(15));
+
+  AllocSnapshot setup_allocs = TakeAllocSnapshot();
+  uint64_t connect_start_us = NowUs();
+  for (auto& peer : peers) {
+    acl_manager->CreateLeConnection(
+        AddressWithType(peer->address(), AddressType::PUBLIC_DEVICE_ADDRESS),
+        /* is_direct */ true);
+  }
+  if (!callbacks.WaitForConnections(num_connections,
+                                    std::chrono::seconds(10))) {
+    LOG_ERROR("Timed out waiting for %zu connections", num_connections);
+  }
+  uint64_t connect_done_us = NowUs();
+
+  // Run the traffic mix for the requested duration
+  std::atomic<bool> running{true};
+  std::vector<std::thread> notification_threads;
+  for (auto& peer : peers) {
+    notification_threads.emplace_back([&peer, notifications_per_second,
+                                       &running] {
+      peer->NotificationLoop(notifications_per_second, &running);
+    });
+  }
+  AllocSnapshot traffic_allocs = TakeAllocSnapshot();
+  std::this_thread::sleep_for(std::chrono::seconds(duration_seconds));
+  running = false;
+  for (auto& thread : notification_threads) {
+    thread.join();
+  }
+  AllocSnapshot end_allocs = TakeAllocSnapshot();
+
+  printf("bluetooth_perf_canary report\n");
+  printf("  connections=%zu/%zu setup=%" PRIu64 "ms\n",
+         callbacks.connected_count(), num_connections,
+         (connect_done_us - connect_start_us) / 1000);
+  printf("  rx_packets=%" PRIu64 " tx_packets=%" PRIu64 " duration=%ds\n",
+         callbacks.rx_packets_.load(), callbacks.tx_packets_.load(),
+         duration_seconds);
+  PrintReport("rx_interarrival", callbacks.rx_interarrival_us_);
+  PrintReport("tx_pacing_jitter", callbacks.tx_jitter_us_);
+  printf("  allocs: setup=%" PRIu64 " traffic=%" PRIu64 " (%" PRIu64
+         " KiB), %.1f allocs/packet\n",
+         traffic_allocs.count - setup_allocs.count,
+         end_allocs.count - traffic_allocs.count,
+         (end_allocs.bytes - traffic_allocs.bytes) / 1024,
+         static_cast<double>(end_allocs.count - traffic_allocs.count) /
+             std::max<uint64_t>(
+                 1, callbacks.rx_packets_.load() + callbacks.tx_packets_.load()));
+
+  callbacks.StopAll();
+  std::promise<void> unregister_promise;
+  auto unregister_done = unregister_promise.get_future();
+  acl_manager->UnregisterLeCallbacks(&callbacks, std::move(unregister_promise));
+  unregister_done.wait();
+  user_handler.Clear();
+
+  for (auto& peer : peers) {
+    peer->Shutdown();
+  }
+  stack_manager.ShutDown();
+  return 0;
+}
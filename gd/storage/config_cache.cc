@@ -20,6 +20,7 @@
 #include <sstream>
 #include <utility>
 
+#include "common/strings.h"
 #include "hci/enum_helper.h"
 #include "storage/mutation.h"
 
@@ -48,6 +49,44 @@ const std::unordered_set<std::string_view> kClassicPropertyNames = {
 
 const std::string ConfigCache::kDefaultSectionName = "Global";
 
+namespace {
+
+// Parse the "key = value" lines of a still-unparsed device section, mirroring the tokenization done
+// by the legacy config parser. Lines without a separator were rejected when the file was read.
+common::ListMap<std::string, std::string> ParseRawEntries(const std::string& raw_entries) {
+  common::ListMap<std::string, std::string> properties;
+  std::stringstream stream(raw_entries);
+  std::string line;
+  while (std::getline(stream, line)) {
+    auto tokens = common::StringSplit(line, "=", 2);
+    if (tokens.size() != 2) {
+      continue;
+    }
+    properties.insert_or_assign(common::StringTrim(std::move(tokens[0])), common::StringTrim(std::move(tokens[1])));
+  }
+  return properties;
+}
+
+// Look up a single property in a still-unparsed device section without materializing it. When a key
+// is repeated the later value wins, matching ParseRawEntries()
+std::optional<std::string> FindValueInRawEntries(const std::string& raw_entries, const std::string& property) {
+  std::optional<std::string> result;
+  std::stringstream stream(raw_entries);
+  std::string line;
+  while (std::getline(stream, line)) {
+    auto tokens = common::StringSplit(line, "=", 2);
+    if (tokens.size() != 2) {
+      continue;
+    }
+    if (common::StringTrim(std::move(tokens[0])) == property) {
+      result = common::StringTrim(std::move(tokens[1]));
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
 ConfigCache::ConfigCache(size_t temp_device_capacity, std::unordered_set<std::string_view> persistent_property_names)
     : persistent_property_names_(std::move(persistent_property_names)),
       information_sections_(),
@@ -64,7 +103,9 @@ ConfigCache::ConfigCache(ConfigCache&& other) noexcept
       persistent_property_names_(std::move(other.persistent_property_names_)),
       information_sections_(std::move(other.information_sections_)),
       persistent_devices_(std::move(other.persistent_devices_)),
-      temporary_devices_(std::move(other.temporary_devices_)) {
+      temporary_devices_(std::move(other.temporary_devices_)),
+      deferred_device_sections_(std::move(other.deferred_device_sections_)),
+      fix_device_type_on_materialize_(other.fix_device_type_on_materialize_) {
   // std::function will be in a valid but unspecified state after std::move(), hence resetting it
   other.persistent_config_changed_callback_ = {};
 }
@@ -81,12 +122,18 @@ ConfigCache& ConfigCache::operator=(ConfigCache&& other) noexcept {
   information_sections_ = std::move(other.information_sections_);
   persistent_devices_ = std::move(other.persistent_devices_);
   temporary_devices_ = std::move(other.temporary_devices_);
+  deferred_device_sections_ = std::move(other.deferred_device_sections_);
+  fix_device_type_on_materialize_ = other.fix_device_type_on_materialize_;
   return *this;
 }
 
 bool ConfigCache::operator==(const ConfigCache& rhs) const {
   std::lock_guard<std::recursive_mutex> my_lock(mutex_);
   std::lock_guard<std::recursive_mutex> others_lock(rhs.mutex_);
+  // Deferred sections parse on access; compare the materialized form so that equality does not
+  // depend on how each cache was loaded
+  MaterializeAllDeferredSections();
+  rhs.MaterializeAllDeferredSections();
   return persistent_property_names_ == rhs.persistent_property_names_ &&
          information_sections_ == rhs.information_sections_ && persistent_devices_ == rhs.persistent_devices_ &&
          temporary_devices_ == rhs.temporary_devices_;
@@ -109,16 +156,30 @@ void ConfigCache::Clear() {
   if (temporary_devices_.size() > 0) {
     temporary_devices_.clear();
   }
+  if (deferred_device_sections_.size() > 0) {
+    bool has_persistent_deferred_section = false;
+    for (const auto& elem : deferred_device_sections_) {
+      if (elem.second.is_persistent) {
+        has_persistent_deferred_section = true;
+        break;
+      }
+    }
+    deferred_device_sections_.clear();
+    if (has_persistent_deferred_section) {
+      PersistentConfigChangedCallback();
+    }
+  }
 }
 
 bool ConfigCache::HasSection(const std::string& section) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   return information_sections_.contains(section) || persistent_devices_.contains(section) ||
-         temporary_devices_.contains(section);
+         temporary_devices_.contains(section) || deferred_device_sections_.contains(section);
 }
 
 bool ConfigCache::HasProperty(const std::string& section, const std::string& property) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  MaterializeDeferredSection(section);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
     return section_iter->second.find(property) != section_iter->second.end();
@@ -136,6 +197,7 @@ bool ConfigCache::HasProperty(const std::string& section, const std::string& pro
 
 std::optional<std::string> ConfigCache::GetProperty(const std::string& section, const std::string& property) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  MaterializeDeferredSection(section);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
     auto property_iter = section_iter->second.find(property);
@@ -167,6 +229,7 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
   }
   ASSERT_LOG(!section.empty(), "Empty section name not allowed");
   ASSERT_LOG(!property.empty(), "Empty property name not allowed");
+  MaterializeDeferredSection(section);
   if (!IsDeviceSection(section)) {
     auto section_iter = information_sections_.find(section);
     if (section_iter == information_sections_.end()) {
@@ -201,6 +264,14 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
 
 bool ConfigCache::RemoveSection(const std::string& section) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  // a deferred section can be dropped without ever parsing it
+  auto deferred_section = deferred_device_sections_.extract(section);
+  if (deferred_section) {
+    if (deferred_section->second.is_persistent) {
+      PersistentConfigChangedCallback();
+    }
+    return true;
+  }
   // sections are unique among all three maps, hence removing from one of them is enough
   if (information_sections_.extract(section) || persistent_devices_.extract(section)) {
     PersistentConfigChangedCallback();
@@ -212,6 +283,7 @@ bool ConfigCache::RemoveSection(const std::string& section) {
 
 bool ConfigCache::RemoveProperty(const std::string& section, const std::string& property) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  MaterializeDeferredSection(section);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
     auto value = section_iter->second.extract(property);
@@ -285,6 +357,17 @@ void ConfigCache::RemoveSectionWithProperty(const std::string& property) {
     }
     it++;
   }
+  for (auto it = deferred_device_sections_.begin(); it != deferred_device_sections_.end();) {
+    if (FindValueInRawEntries(it->second.raw_entries, property).has_value()) {
+      LOG_INFO("Removing deferred section %s with property %s", it->first.c_str(), property.c_str());
+      if (it->second.is_persistent) {
+        num_persistent_removed++;
+      }
+      it = deferred_device_sections_.erase(it);
+      continue;
+    }
+    it++;
+  }
   if (num_persistent_removed > 0) {
     PersistentConfigChangedCallback();
   }
@@ -297,6 +380,11 @@ std::vector<std::string> ConfigCache::GetPersistentSections() const {
   for (const auto& elem : persistent_devices_) {
     paired_devices.emplace_back(elem.first);
   }
+  for (const auto& elem : deferred_device_sections_) {
+    if (elem.second.is_persistent) {
+      paired_devices.emplace_back(elem.first);
+    }
+  }
   return paired_devices;
 }
 
@@ -332,6 +420,14 @@ std::string ConfigCache::SerializeToLegacyFormat() const {
       serialized << std::endl;
     }
   }
+  // deferred sections are still in legacy format, emit their entries verbatim without parsing
+  for (const auto& elem : deferred_device_sections_) {
+    if (!elem.second.is_persistent) {
+      continue;
+    }
+    serialized << "[" << elem.first << "]" << std::endl;
+    serialized << elem.second.raw_entries << std::endl;
+  }
   return serialized.str();
 }
 
@@ -355,6 +451,12 @@ std::vector<ConfigCache::SectionAndPropertyValue> ConfigCache::GetSectionNamesWi
       continue;
     }
   }
+  for (const auto& elem : deferred_device_sections_) {
+    auto value = FindValueInRawEntries(elem.second.raw_entries, property);
+    if (value) {
+      result.emplace_back(SectionAndPropertyValue{.section = elem.first, .property = std::move(*value)});
+    }
+  }
   return result;
 }
 
@@ -402,6 +504,9 @@ bool FixDeviceTypeInconsistencyInSection(
 
 bool ConfigCache::FixDeviceTypeInconsistencies() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  // Deferred sections are not parsed here so that this startup pass stays cheap; each one applies
+  // the repair when it materializes instead
+  fix_device_type_on_materialize_ = true;
   bool persistent_device_changed = false;
   for (auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (auto& elem : *config_section) {
@@ -422,9 +527,81 @@ bool ConfigCache::FixDeviceTypeInconsistencies() {
   return persistent_device_changed || temp_device_changed;
 }
 
+void ConfigCache::DeferDeviceSection(std::string section, std::string raw_entries) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  ASSERT_LOG(IsDeviceSection(section), "Only device sections can be deferred, got '%s'", section.c_str());
+  if (information_sections_.contains(section) || persistent_devices_.contains(section) ||
+      temporary_devices_.contains(section)) {
+    // the section was already materialized, parse eagerly so the entries merge into it
+    for (auto& property : ParseRawEntries(raw_entries)) {
+      SetProperty(section, property.first, std::move(property.second));
+    }
+    return;
+  }
+  // a single persistent property makes the whole section persistent, only the keys need checking
+  bool is_persistent = false;
+  std::stringstream stream(raw_entries);
+  std::string line;
+  while (std::getline(stream, line)) {
+    auto separator = line.find('=');
+    if (separator == std::string::npos) {
+      continue;
+    }
+    if (persistent_property_names_.count(common::StringTrim(line.substr(0, separator))) > 0) {
+      is_persistent = true;
+      break;
+    }
+  }
+  auto deferred_iter = deferred_device_sections_.find(section);
+  if (deferred_iter != deferred_device_sections_.end()) {
+    // the same section appears twice in the file, append so that later keys still win when parsed
+    deferred_iter->second.raw_entries += raw_entries;
+    deferred_iter->second.is_persistent = deferred_iter->second.is_persistent || is_persistent;
+    return;
+  }
+  deferred_device_sections_.try_emplace_back(section, DeferredSection{std::move(raw_entries), is_persistent});
+}
+
+void ConfigCache::MaterializeDeferredSection(const std::string& section) const {
+  // Moving a section between internal containers does not change observable content, hence safe to
+  // trigger from const observers
+  auto* self = const_cast<ConfigCache*>(this);
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  auto deferred_section = self->deferred_device_sections_.extract(section);
+  if (!deferred_section) {
+    return;
+  }
+  auto properties = ParseRawEntries(deferred_section->second.raw_entries);
+  if (properties.size() == 0) {
+    return;
+  }
+  bool device_type_fixed = false;
+  if (fix_device_type_on_materialize_) {
+    device_type_fixed = FixDeviceTypeInconsistencyInSection(deferred_section->first, properties);
+  }
+  if (deferred_section->second.is_persistent) {
+    self->persistent_devices_.try_emplace_back(deferred_section->first, std::move(properties));
+    if (device_type_fixed) {
+      PersistentConfigChangedCallback();
+    }
+  } else {
+    self->temporary_devices_.insert_or_assign(deferred_section->first, std::move(properties));
+  }
+}
+
+void ConfigCache::MaterializeAllDeferredSections() const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  while (deferred_device_sections_.size() > 0) {
+    // copy the name as materializing removes the deferred entry it points into
+    std::string section = deferred_device_sections_.begin()->first;
+    MaterializeDeferredSection(section);
+  }
+}
+
 bool ConfigCache::HasAtLeastOneMatchingPropertiesInSection(
     const std::string& section, const std::unordered_set<std::string_view>& property_names) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  MaterializeDeferredSection(section);
   const common::ListMap<std::string, std::string>* section_ptr;
   if (!IsDeviceSection(section)) {
     auto section_iter = information_sections_.find(section);
@@ -452,7 +629,11 @@ bool ConfigCache::HasAtLeastOneMatchingPropertiesInSection(
 
 bool ConfigCache::IsPersistentSection(const std::string& section) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  return persistent_devices_.contains(section);
+  if (persistent_devices_.contains(section)) {
+    return true;
+  }
+  auto deferred_iter = deferred_device_sections_.find(section);
+  return deferred_iter != deferred_device_sections_.end() && deferred_iter->second.is_persistent;
 }
 
 }  // namespace storage
@@ -98,6 +98,11 @@ class ConfigCache {
   // Commit all mutation entries in sequence while holding the config mutex
   virtual void Commit(std::queue<MutationEntry>& mutation);
   virtual void SetProperty(std::string section, std::string property, std::string value);
+  // Hand over a still-unparsed device section read from the legacy config file. |raw_entries| holds
+  // the section's "key = value" lines verbatim, one per line, each terminated by '\n'. The section
+  // is only parsed into individual properties when it is first read or written, so loading a large
+  // bond database does not materialize every device section up front.
+  virtual void DeferDeviceSection(std::string section, std::string raw_entries);
   virtual bool RemoveSection(const std::string& section);
   virtual bool RemoveProperty(const std::string& section, const std::string& property);
   // TODO: have a systematic way of doing this instead of specialized methods
@@ -121,6 +126,20 @@ class ConfigCache {
   static const std::string kDefaultSectionName;
 
  private:
+  // A device section handed over by the config parser whose properties have not been parsed yet
+  struct DeferredSection {
+    // The section's "key = value" lines verbatim, one per line, each terminated by '\n'
+    std::string raw_entries;
+    // Pre-computed from the keys in |raw_entries| so that persistence queries do not need to parse
+    bool is_persistent;
+  };
+
+  // Parse a deferred device section into persistent_devices_ or temporary_devices_, no-op when
+  // |section| is not deferred. Logically const: observable content does not change, except for the
+  // device type repair when FixDeviceTypeInconsistencies() ran before the section materialized.
+  void MaterializeDeferredSection(const std::string& section) const;
+  void MaterializeAllDeferredSections() const;
+
   mutable std::recursive_mutex mutex_;
   // A callback to notify interested party that a persistent config change has just happened, empty by default
   std::function<void()> persistent_config_changed_callback_;
@@ -134,6 +153,12 @@ class ConfigCache {
   // Information about temporary devices, normally unpaired, will not be written to disk, will be evicted automatically
   // if capacity exceeds given value during initialization
   common::LruCache<std::string, common::ListMap<std::string, std::string>> temporary_devices_;
+  // Device sections handed over by the config parser that have not been parsed yet, materialized
+  // into persistent_devices_ or temporary_devices_ on first access
+  common::ListMap<std::string, DeferredSection> deferred_device_sections_;
+  // Set once FixDeviceTypeInconsistencies() has run; deferred sections skipped by that pass apply
+  // the repair when they materialize
+  bool fix_device_type_on_materialize_ = false;
 
   // Convenience method to check if the callback is valid before calling it
   inline void PersistentConfigChangedCallback() const {
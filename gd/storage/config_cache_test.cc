@@ -337,4 +337,40 @@ TEST(ConfigCacheTest, test_empty_persistent_properties) {
   ASSERT_THAT(config.GetPersistentSections(), ElementsAre());
 }
 
+TEST(ConfigCacheTest, defer_device_section_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.DeferDeviceSection("CC:DD:EE:FF:00:11", "name = hello\nLinkKey = AABBAABBCCDDEE\n");
+  config.DeferDeviceSection("CC:DD:EE:FF:00:12", "name = unpaired\n");
+  // persistence and section queries work without parsing the deferred entries
+  ASSERT_TRUE(config.HasSection("CC:DD:EE:FF:00:11"));
+  ASSERT_TRUE(config.IsPersistentSection("CC:DD:EE:FF:00:11"));
+  ASSERT_FALSE(config.IsPersistentSection("CC:DD:EE:FF:00:12"));
+  ASSERT_THAT(config.GetPersistentSections(), ElementsAre("CC:DD:EE:FF:00:11"));
+  // first property access parses the section
+  ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:11", "name"), Optional(StrEq("hello")));
+  ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:12", "name"), Optional(StrEq("unpaired")));
+  config.SetProperty("CC:DD:EE:FF:00:11", "name", "world");
+  ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:11", "name"), Optional(StrEq("world")));
+  ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:11", "LinkKey"), Optional(StrEq("AABBAABBCCDDEE")));
+}
+
+TEST(ConfigCacheTest, defer_device_section_serialization_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.DeferDeviceSection("CC:DD:EE:FF:00:11", "LinkKey = AABBAABBCCDDEE\n");
+  config.DeferDeviceSection("CC:DD:EE:FF:00:12", "name = unpaired\n");
+  // still-deferred sections serialize verbatim, temporary ones are not written at all
+  ASSERT_EQ(config.SerializeToLegacyFormat(), "[A]\nB = C\n\n[CC:DD:EE:FF:00:11]\nLinkKey = AABBAABBCCDDEE\n\n");
+}
+
+TEST(ConfigCacheTest, defer_device_section_removal_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.DeferDeviceSection("CC:DD:EE:FF:00:11", "LinkKey = AABBAABBCCDDEE\n");
+  ASSERT_TRUE(config.RemoveSection("CC:DD:EE:FF:00:11"));
+  ASSERT_FALSE(config.HasSection("CC:DD:EE:FF:00:11"));
+  config.DeferDeviceSection("CC:DD:EE:FF:00:12", "LinkKey = AABBAABBCCDDEE\nRestricted = 1\n");
+  config.RemoveSectionWithProperty("Restricted");
+  ASSERT_FALSE(config.HasSection("CC:DD:EE:FF:00:12"));
+}
+
 }  // namespace testing
\ No newline at end of file
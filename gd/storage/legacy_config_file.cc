@@ -43,6 +43,10 @@ std::optional<ConfigCache> LegacyConfigFile::Read(size_t temp_devices_capacity)
   ConfigCache cache(temp_devices_capacity, Device::kLinkKeyProperties);
   std::string line;
   std::string section(ConfigCache::kDefaultSectionName);
+  bool section_is_device = false;
+  // Raw entries of the device section currently being read, handed over unparsed so that a large
+  // bond database is not materialized into per-property maps at startup
+  std::string deferred_entries;
   while (std::getline(config_file, line)) {
     ++line_num;
     line = common::StringTrim(std::move(line));
@@ -54,19 +58,31 @@ std::optional<ConfigCache> LegacyConfigFile::Read(size_t temp_devices_capacity)
         LOG_WARN("unterminated section name on line %d", line_num);
         return std::nullopt;
       }
+      if (!deferred_entries.empty()) {
+        cache.DeferDeviceSection(section, std::move(deferred_entries));
+        deferred_entries.clear();
+      }
       // Read 'test' from '[text]', hence -2
       section = line.substr(1, line.size() - 2);
+      section_is_device = ConfigCache::IsDeviceSection(section);
     } else {
       auto tokens = common::StringSplit(line, "=", 2);
       if (tokens.size() != 2) {
         LOG_WARN("no key/value separator found on line %d", line_num);
         return std::nullopt;
       }
+      if (section_is_device) {
+        deferred_entries.append(line).append("\n");
+        continue;
+      }
       tokens[0] = common::StringTrim(std::move(tokens[0]));
       tokens[1] = common::StringTrim(std::move(tokens[1]));
       cache.SetProperty(section, tokens[0], std::move(tokens[1]));
     }
   }
+  if (!deferred_entries.empty()) {
+    cache.DeferDeviceSection(section, std::move(deferred_entries));
+  }
   return cache;
 }
 
@@ -93,5 +93,20 @@ const hci_t* hci_layer_get_test_interface(
 
 void post_to_main_message_loop(const base::Location& from_here, BT_HDR* p_msg);
 
+// Number of Completed Packets fast lane: during a burst the HCI thread
+// folds NOCP credits into per-handle counters instead of dispatching every
+// event to the main thread. One slot per distinct connection handle.
+#define HCI_NOCP_COALESCE_SLOTS 16
+
+// Big enough for every coalescing slot to emit one handle/count pair plus
+// the leading Num_Handles byte.
+#define HCI_NOCP_DRAIN_BUF_SIZE (1 + HCI_NOCP_COALESCE_SLOTS * 4)
+
+// Drains the coalesced Number of Completed Packets credits into |buffer|
+// as a synthesized event parameter block (Num_Handles byte followed by
+// handle/count pairs). Called on the main thread when a NOCP event
+// arrives. Returns the block length, or 0 when nothing was coalesced.
+uint8_t hci_nocp_drain_coalesced(uint8_t* buffer, uint8_t max_len);
+
 void hci_layer_cleanup_interface();
 bool hci_is_root_inflammation_event_received();
@@ -35,6 +35,7 @@
 #include <sys/time.h>
 #include <sys/uio.h>
 #include <unistd.h>
+#include <atomic>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -45,8 +46,13 @@
 #include "hci/include/btsnoop_mem.h"
 #include "hci_layer.h"
 #include "internal_include/bt_trace.h"
+#include "osi/include/allocator.h"
 #include "osi/include/log.h"
+#include "osi/include/osi.h"
 #include "osi/include/properties.h"
+#include "osi/include/ringbuffer.h"
+#include "osi/include/semaphore.h"
+#include "osi/include/thread.h"
 #include "stack/include/hcimsgs.h"
 #include "stack/include/rfcdefs.h"
 #include "stack/l2cap/l2c_int.h"
@@ -98,6 +104,22 @@ static std::mutex btsnoop_mutex;
 static int32_t packets_per_file;
 static int32_t packet_counter;
 
+// Async writer state. The capture path copies each record into |snoop_ring|
+// and never touches the log file; |snoop_writer_thread| drains the ring and
+// performs the blocking file I/O (including rotation) at low priority, so
+// enabling snoop logging no longer adds write(2) latency to the HCI path.
+static const size_t BTSNOOP_RING_SIZE = 256 * 1024;
+static const size_t BTSNOOP_FLUSH_CHUNK_SIZE = 16 * 1024;
+static const int BTSNOOP_WRITER_NICENESS = 10;
+
+static ringbuffer_t* snoop_ring;
+static std::mutex snoop_ring_mutex;
+static semaphore_t* snoop_data_available;
+static thread_t* snoop_writer_thread;
+static std::atomic<bool> snoop_writer_active{false};
+// Packets dropped because the ring was full, since the last accepted packet.
+static std::atomic<uint32_t> snoop_dropped_since_last{0};
+
 // Channel tracking variables for filtering.
 
 // Keeps track of L2CAP channels that need to be filtered out of the snoop
@@ -157,6 +179,71 @@ std::mutex filter_list_mutex;
 std::unordered_map<uint16_t, FilterTracker> filter_list;
 std::unordered_map<uint16_t, uint16_t> local_cid_to_acl;
 
+// Compiled filter match table.
+//
+// The allowlist above only changes on (rare) channel events, but the capture
+// path used to take filter_list_mutex and probe the maps for every ACL
+// packet. The mutators instead compile the allowlist into this flat table,
+// which should_filter_log reads guarded by a sequence counter and no lock: a
+// reader racing a rebuild simply retries. Connections or channels that do
+// not fit the table fall back to the locked maps.
+static const size_t MAX_COMPILED_FILTERS = 16;
+static const size_t MAX_COMPILED_CIDS = 16;
+
+typedef struct {
+  bool in_use;
+  // Too many channels to compile; the reader uses the locked path instead.
+  bool overflow;
+  uint16_t acl_handle;
+  uint16_t local_cids[MAX_COMPILED_CIDS];  // packed; 0 terminates the list
+  uint16_t remote_cids[MAX_COMPILED_CIDS];
+  uint16_t rfc_local_cid;
+  uint16_t rfc_remote_cid;
+  uint64_t rfc_dlci_bitmap;  // DLCIs are 6 bits wide
+} compiled_filter_entry_t;
+
+static compiled_filter_entry_t compiled_filters[MAX_COMPILED_FILTERS];
+static bool compiled_filter_table_overflow;
+// Odd while a rebuild is in progress; bumped to the next even value after.
+static std::atomic<uint32_t> compiled_filter_seq{0};
+
+// Rebuilds the compiled match table from |filter_list|. filter_list_mutex
+// must be held.
+static void compile_filter_table(void) {
+  compiled_filter_seq.fetch_add(1, std::memory_order_acq_rel);
+
+  memset(compiled_filters, 0, sizeof(compiled_filters));
+  compiled_filter_table_overflow = false;
+
+  size_t slot = 0;
+  for (auto& it : filter_list) {
+    if (slot >= MAX_COMPILED_FILTERS) {
+      compiled_filter_table_overflow = true;
+      break;
+    }
+    compiled_filter_entry_t* entry = &compiled_filters[slot++];
+    FilterTracker& tracker = it.second;
+    entry->in_use = true;
+    entry->acl_handle = it.first;
+    entry->rfc_local_cid = tracker.rfc_local_cid;
+    entry->rfc_remote_cid = tracker.rfc_remote_cid;
+    if (tracker.l2c_local_cid.size() > MAX_COMPILED_CIDS ||
+        tracker.l2c_remote_cid.size() > MAX_COMPILED_CIDS) {
+      entry->overflow = true;
+      continue;
+    }
+    size_t i = 0;
+    for (uint16_t cid : tracker.l2c_local_cid) entry->local_cids[i++] = cid;
+    i = 0;
+    for (uint16_t cid : tracker.l2c_remote_cid) entry->remote_cids[i++] = cid;
+    for (uint16_t dlci : tracker.rfc_channels) {
+      if (dlci < 64) entry->rfc_dlci_bitmap |= (UINT64_C(1) << dlci);
+    }
+  }
+
+  compiled_filter_seq.fetch_add(1, std::memory_order_release);
+}
+
 // Cached value for whether full snoop logs are enabled. So the property isn't
 // checked for every packet.
 static bool is_btsnoop_enabled;
@@ -173,6 +260,7 @@ static std::string get_btsnoop_last_log_path(std::string log_path);
 static void open_next_snoop_file();
 static void btsnoop_write_packet(packet_type_t type, uint8_t* packet,
                                  bool is_received, uint64_t timestamp_us);
+static void snoop_writer_work(void* context);
 
 // Module lifecycle functions
 
@@ -218,12 +306,43 @@ static future_t* start_up() {
     packets_per_file = osi_property_get_int32(BTSNOOP_MAX_PACKETS_PROPERTY,
                                               DEFAULT_BTSNOOP_SIZE);
     btsnoop_net_open();
+
+    snoop_ring = ringbuffer_init(BTSNOOP_RING_SIZE);
+    snoop_data_available = semaphore_new(0);
+    snoop_writer_thread = thread_new("btsnoop_writer");
+    if (!snoop_ring || !snoop_data_available || !snoop_writer_thread) {
+      LOG(ERROR) << __func__ << ": unable to start async snoop writer";
+      thread_free(snoop_writer_thread);
+      snoop_writer_thread = NULL;
+      semaphore_free(snoop_data_available);
+      snoop_data_available = NULL;
+      ringbuffer_free(snoop_ring);
+      snoop_ring = NULL;
+      is_btsnoop_enabled = false;
+      return NULL;
+    }
+    thread_set_priority(snoop_writer_thread, BTSNOOP_WRITER_NICENESS);
+    snoop_writer_active = true;
+    thread_post(snoop_writer_thread, snoop_writer_work, NULL);
   }
 
   return NULL;
 }
 
 static future_t* shut_down(void) {
+  // Stop the writer before taking the module lock so the final drain below
+  // sees every record the capture path managed to enqueue.
+  if (snoop_writer_active) {
+    snoop_writer_active = false;
+    semaphore_post(snoop_data_available);
+    thread_free(snoop_writer_thread);
+    snoop_writer_thread = NULL;
+    semaphore_free(snoop_data_available);
+    snoop_data_available = NULL;
+    ringbuffer_free(snoop_ring);
+    snoop_ring = NULL;
+  }
+
   std::lock_guard<std::mutex> lock(btsnoop_mutex);
 
   if (is_btsnoop_enabled) {
@@ -266,7 +385,7 @@ static void capture(const BT_HDR* buffer, bool is_received) {
 
   btsnoop_mem_capture(buffer, timestamp_us);
 
-  if (logfile_fd == INVALID_FD) return;
+  if (!snoop_writer_active) return;
 
   switch (buffer->event & MSG_EVT_MASK) {
     case MSG_HC_TO_STACK_HCI_EVT:
@@ -303,6 +422,7 @@ static void allowlist_l2c_channel(uint16_t conn_handle, uint16_t local_cid,
   // This will create the entry if there is no associated filter with the
   // connection.
   filter_list[conn_handle].addL2cCid(local_cid, remote_cid);
+  compile_filter_table();
 }
 
 static void allowlist_rfc_dlci(uint16_t local_cid, uint8_t dlci) {
@@ -316,6 +436,7 @@ static void allowlist_rfc_dlci(uint16_t local_cid, uint8_t dlci) {
 
   tL2C_CCB* p_ccb = l2cu_find_ccb_by_cid(nullptr, local_cid);
   filter_list[p_ccb->p_lcb->Handle()].addRfcDlci(dlci);
+  compile_filter_table();
 }
 
 static void add_rfc_l2c_channel(uint16_t conn_handle, uint16_t local_cid,
@@ -331,6 +452,7 @@ static void add_rfc_l2c_channel(uint16_t conn_handle, uint16_t local_cid,
 
   filter_list[conn_handle].setRfcCid(local_cid, remote_cid);
   local_cid_to_acl.insert({local_cid, conn_handle});
+  compile_filter_table();
 }
 
 static void clear_l2cap_allowlist(uint16_t conn_handle, uint16_t local_cid,
@@ -344,6 +466,7 @@ static void clear_l2cap_allowlist(uint16_t conn_handle, uint16_t local_cid,
   }
   std::lock_guard lock(filter_list_mutex);
   filter_list[conn_handle].removeL2cCid(local_cid, remote_cid);
+  compile_filter_table();
 }
 
 static const btsnoop_t interface = {capture, allowlist_l2c_channel,
@@ -419,15 +542,82 @@ static uint64_t htonll(uint64_t ll) {
   return ll;
 }
 
+// Matches a packet against the compiled filter table. Sets |*p_fallback|
+// when the table cannot answer (rebuild overflowed) and the caller has to
+// use the locked maps instead.
+static bool compiled_filter_match(bool is_received, uint16_t acl_handle,
+                                  uint16_t l2c_channel, uint8_t* packet,
+                                  bool* p_fallback) {
+  *p_fallback = false;
+
+  const compiled_filter_entry_t* entry = NULL;
+  for (size_t i = 0; i < MAX_COMPILED_FILTERS; i++) {
+    if (compiled_filters[i].in_use &&
+        compiled_filters[i].acl_handle == acl_handle) {
+      entry = &compiled_filters[i];
+      break;
+    }
+  }
+  if (entry == NULL) {
+    if (compiled_filter_table_overflow) {
+      *p_fallback = true;
+      return false;
+    }
+    // Unknown connection: only the L2CAP signaling channel is logged.
+    return l2c_channel != 1;
+  }
+  if (entry->overflow) {
+    *p_fallback = true;
+    return false;
+  }
+
+  uint16_t rfc_cid = is_received ? entry->rfc_local_cid : entry->rfc_remote_cid;
+  if (l2c_channel == rfc_cid) {
+    uint8_t rfc_event = packet[RFC_EVENT_OFFSET] & 0b11101111;
+    if (rfc_event == RFCOMM_SABME || rfc_event == RFCOMM_UA) {
+      return false;
+    }
+
+    uint8_t rfc_dlci = packet[RFC_CHANNEL_OFFSET] >> 2;
+    return !((entry->rfc_dlci_bitmap >> rfc_dlci) & 1);
+  }
+
+  const uint16_t* cids = is_received ? entry->local_cids : entry->remote_cids;
+  for (size_t i = 0; i < MAX_COMPILED_CIDS && cids[i] != 0; i++) {
+    if (cids[i] == l2c_channel) return false;
+  }
+  return true;
+}
+
 static bool should_filter_log(bool is_received, uint8_t* packet) {
   uint16_t acl_handle =
       HCID_GET_HANDLE((((uint16_t)packet[ACL_CHANNEL_OFFSET + 1]) << 8) +
                       packet[ACL_CHANNEL_OFFSET]);
+  uint16_t l2c_channel =
+      (packet[L2C_CHANNEL_OFFSET + 1] << 8) + packet[L2C_CHANNEL_OFFSET];
+
+  // Fast path: read the compiled match table under the sequence counter.
+  // A rebuild in progress, or one racing the read, just means retrying;
+  // rebuilds are rare and bounded, so the loop terminates quickly.
+  while (true) {
+    uint32_t seq_start = compiled_filter_seq.load(std::memory_order_acquire);
+    if (seq_start & 1) continue;
+
+    bool fallback;
+    bool filtered = compiled_filter_match(is_received, acl_handle, l2c_channel,
+                                          packet, &fallback);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (compiled_filter_seq.load(std::memory_order_relaxed) != seq_start) {
+      continue;
+    }
+    if (!fallback) return filtered;
+    break;
+  }
 
+  // Slow path: the connection had more channels than the compiled table
+  // holds, so answer from the full maps.
   std::lock_guard lock(filter_list_mutex);
   auto& filters = filter_list[acl_handle];
-  uint16_t l2c_channel =
-      (packet[L2C_CHANNEL_OFFSET + 1] << 8) + packet[L2C_CHANNEL_OFFSET];
   if (filters.isRfcChannel(is_received, l2c_channel)) {
     uint8_t rfc_event = packet[RFC_EVENT_OFFSET] & 0b11101111;
     if (rfc_event == RFCOMM_SABME || rfc_event == RFCOMM_UA) {
@@ -492,14 +682,68 @@ static void btsnoop_write_packet(packet_type_t type, uint8_t* packet,
   btsnoop_net_write(&header, sizeof(btsnoop_header_t));
   btsnoop_net_write(packet, length_he - 1);
 
-  if (logfile_fd != INVALID_FD) {
-    packet_counter++;
-    if (packet_counter > packets_per_file) {
-      open_next_snoop_file();
+  // Hand the record to the async writer. Each ring record is a 16-bit
+  // length followed by the snoop header and payload bytes.
+  uint16_t payload_length = length_he - 1;
+  uint16_t record_length = sizeof(btsnoop_header_t) + payload_length;
+  {
+    std::lock_guard<std::mutex> ring_lock(snoop_ring_mutex);
+    if (ringbuffer_available(snoop_ring) <
+            sizeof(record_length) + record_length ||
+        record_length > BTSNOOP_FLUSH_CHUNK_SIZE) {
+      snoop_dropped_since_last++;
+      return;
+    }
+
+    // Surface ring overruns through the snoop format's own drop counter.
+    header.dropped_packets = htonl(snoop_dropped_since_last.exchange(0));
+
+    ringbuffer_insert(snoop_ring,
+                      reinterpret_cast<const uint8_t*>(&record_length),
+                      sizeof(record_length));
+    ringbuffer_insert(snoop_ring, reinterpret_cast<const uint8_t*>(&header),
+                      sizeof(btsnoop_header_t));
+    ringbuffer_insert(snoop_ring, packet, payload_length);
+  }
+  semaphore_post(snoop_data_available);
+}
+
+// Runs on |snoop_writer_thread|: drains the ring in batches and performs the
+// blocking file writes and rotation the capture path used to do inline.
+static void snoop_writer_work(UNUSED_ATTR void* context) {
+  uint8_t* flush_buffer =
+      static_cast<uint8_t*>(osi_malloc(BTSNOOP_FLUSH_CHUNK_SIZE));
+
+  while (true) {
+    semaphore_wait(snoop_data_available);
+
+    size_t flush_length = 0;
+    int32_t flushed_records = 0;
+    {
+      std::lock_guard<std::mutex> ring_lock(snoop_ring_mutex);
+      for (;;) {
+        uint16_t record_length;
+        if (ringbuffer_peek(snoop_ring, 0,
+                            reinterpret_cast<uint8_t*>(&record_length),
+                            sizeof(record_length)) != sizeof(record_length))
+          break;
+        if (flush_length + record_length > BTSNOOP_FLUSH_CHUNK_SIZE) break;
+
+        ringbuffer_delete(snoop_ring, sizeof(record_length));
+        ringbuffer_pop(snoop_ring, flush_buffer + flush_length, record_length);
+        flush_length += record_length;
+        flushed_records++;
+      }
     }
 
-    iovec iov[] = {{&header, sizeof(btsnoop_header_t)},
-                   {reinterpret_cast<void*>(packet), length_he - 1}};
-    TEMP_FAILURE_RETRY(writev(logfile_fd, iov, 2));
+    if (flush_length > 0 && logfile_fd != INVALID_FD) {
+      packet_counter += flushed_records;
+      if (packet_counter > packets_per_file) open_next_snoop_file();
+      TEMP_FAILURE_RETRY(write(logfile_fd, flush_buffer, flush_length));
+    }
+
+    if (!snoop_writer_active && flush_length == 0) break;
   }
+
+  osi_free(flush_buffer);
 }
@@ -27,13 +27,20 @@
 #include <base/threading/thread.h>
 #include <frameworks/proto_logging/stats/enums/bluetooth/hci/enums.pb.h>
 
+#include <errno.h>
+#include <sched.h>
 #include <signal.h>
 #include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <list>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "btcore/include/module.h"
 #include "btif/include/btif_bqr.h"
@@ -49,10 +56,10 @@
 #include "hcimsgs.h"
 #include "main/shim/shim.h"
 #include "osi/include/alarm.h"
-#include "osi/include/list.h"
 #include "osi/include/log.h"
 #include "osi/include/properties.h"
 #include "osi/include/reactor.h"
+#include "osi/include/tracepoint.h"
 #include "packet_fragmenter.h"
 
 #define BT_HCI_TIMEOUT_TAG_NUM 1010000
@@ -63,6 +70,7 @@ using bluetooth::common::StopWatchLegacy;
 
 extern void hci_initialize();
 extern void hci_transmit(BT_HDR* packet);
+extern void hci_transmit_flush(void);
 extern void hci_close();
 extern int hci_open_firmware_log_file();
 extern void hci_close_firmware_log_file(int fd);
@@ -113,16 +121,51 @@ static int command_credits = 1;
 static std::mutex command_credits_mutex;
 static std::queue<base::Closure> command_queue;
 
+// Upper bound on commands we keep in flight regardless of what the
+// controller advertises, to bound timeout debugging and wait-list size.
+static const int MAX_COMMANDS_IN_FLIGHT = 8;
+
+// Command pipelining statistics, protected by |command_credits_mutex|.
+static int max_commands_in_flight_seen = 0;
+static size_t command_queue_high_watermark = 0;
+
 // Inbound-related
 static alarm_t* command_response_timer;
-static list_t* commands_pending_response;
+static std::list<waiting_command_t*> commands_pending_response;
+// Opcode-keyed index into |commands_pending_response| so event matching is
+// a lookup instead of a list walk. Multimap because pipelining can put the
+// same opcode in flight more than once.
+static std::unordered_multimap<command_opcode_t,
+                               std::list<waiting_command_t*>::iterator>
+    commands_pending_response_index;
 static std::recursive_timed_mutex commands_pending_response_mutex;
+
+// Slowest command response seen since startup, protected by
+// |commands_pending_response_mutex|.
+static int command_response_max_latency_ms = 0;
+static command_opcode_t command_response_max_latency_opcode = HCI_COMMAND_NONE;
+// Responses slower than this are worth a log line on their own.
+static const int COMMAND_RESPONSE_SLOW_THRESHOLD_MS = 500;
 static OnceTimer abort_timer;
 
 // Root inflammation error codes
 static uint8_t root_inflamed_error_code = 0;
 static uint8_t root_inflamed_vendor_error_code = 0;
 
+// Number of Completed Packets fast lane. While one NOCP event is riding to
+// the main thread as a drain doorbell, the credits of further NOCP events
+// are folded into these per-handle counters right here on the HCI thread
+// and the events freed, collapsing a burst into a single main-thread
+// dispatch. Slots are claimed by the HCI thread only and are never
+// reclaimed: once every slot is taken by a distinct handle, later handles
+// simply lose the fast lane and ride up unmodified, which is always
+// correct. All accesses are seq_cst so a drain that saw the doorbell flag
+// set cannot miss counts recorded before it was raised.
+static std::atomic<uint16_t> nocp_slot_handle_p1[HCI_NOCP_COALESCE_SLOTS];
+static std::atomic<uint32_t> nocp_slot_credits[HCI_NOCP_COALESCE_SLOTS];
+static std::atomic<bool> nocp_doorbell_pending{false};
+static std::atomic<uint32_t> nocp_events_coalesced{0};
+
 // The hand-off point for data going to a higher layer, set by the higher layer
 static base::Callback<void(const base::Location&, BT_HDR*)> send_data_upwards;
 
@@ -157,7 +200,54 @@ void initialization_complete() {
   hci_thread.DoInThread(FROM_HERE, base::Bind(&event_finish_startup, nullptr));
 }
 
+// Real-time priority for threads delivering inbound HCI packets, same value
+// the alarm and message loop threads use. Set the property to 0 to leave the
+// thread at its default priority.
+static const char* const RX_RT_PRIORITY_PROPERTY =
+    "bluetooth.hci.rx_rt_priority";
+static const int RX_RT_PRIORITY_DEFAULT = 1;
+// Bitmask of CPUs the RX threads may run on, 0 (default) leaves the affinity
+// alone.
+static const char* const RX_CPU_AFFINITY_MASK_PROPERTY =
+    "bluetooth.hci.rx_cpu_affinity_mask";
+
+// Applies the configured scheduling policy to the calling thread. The
+// transport calls this from whichever thread delivers inbound packets - the
+// socket reader thread on Linux, HIDL binder threads on Android - so that
+// reads from the controller are not starved when the rest of the process is
+// busy. Configures each calling thread only once, cheap to call per packet.
+void hci_configure_rx_thread() {
+  static thread_local bool configured = false;
+  if (configured) return;
+  configured = true;
+
+  int priority =
+      osi_property_get_int32(RX_RT_PRIORITY_PROPERTY, RX_RT_PRIORITY_DEFAULT);
+  if (priority > 0) {
+    struct sched_param rt_params = {.sched_priority = priority};
+    if (sched_setscheduler(0, SCHED_FIFO, &rt_params) != 0) {
+      LOG_WARN("%s unable to set SCHED_FIFO priority %d: %s", __func__,
+               priority, strerror(errno));
+    }
+  }
+
+  int affinity_mask =
+      osi_property_get_int32(RX_CPU_AFFINITY_MASK_PROPERTY, 0);
+  if (affinity_mask != 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu = 0; cpu < 32; cpu++) {
+      if (affinity_mask & (1 << cpu)) CPU_SET(cpu, &cpus);
+    }
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+      LOG_WARN("%s unable to set cpu affinity mask 0x%x: %s", __func__,
+               affinity_mask, strerror(errno));
+    }
+  }
+}
+
 void hci_event_received(const base::Location& from_here, BT_HDR* packet) {
+  TRACEPOINT(TRACE_HCI_EVT_RX, packet->data[packet->offset], packet->len);
   btsnoop->capture(packet, true);
 
   if (!filter_incoming_event(packet)) {
@@ -166,13 +256,23 @@ void hci_event_received(const base::Location& from_here, BT_HDR* packet) {
 }
 
 void acl_event_received(BT_HDR* packet) {
+  TRACEPOINT(TRACE_HCI_ACL_RX, packet->event, packet->len);
   btsnoop->capture(packet, true);
   packet_fragmenter->reassemble_and_dispatch(packet);
 }
 
 void sco_data_received(BT_HDR* packet) {
   btsnoop->capture(packet, true);
-  packet_fragmenter->reassemble_and_dispatch(packet);
+  /* Voice data is routed in hardware (PCM/I2S) on this stack generation;
+   * btm_route_sco_data only frees whatever still arrives over HCI. Free it
+   * here on the RX thread instead of bouncing it through the fragmenter and
+   * the btu thread first. */
+  static size_t dropped_sco_packets = 0;
+  if ((dropped_sco_packets++ % 1000) == 0) {
+    LOG_WARN("%s dropped %zu SCO packets - audio is routed in hardware",
+             __func__, dropped_sco_packets);
+  }
+  buffer_allocator->free(packet);
 }
 
 void iso_data_received(BT_HDR* packet) {
@@ -237,11 +337,13 @@ static future_t* hci_module_start_up(void) {
     goto error;
   }
 
-  commands_pending_response = list_new(NULL);
-  if (!commands_pending_response) {
-    LOG_ERROR("%s unable to create list for commands pending response.",
-              __func__);
-    goto error;
+  {
+    std::lock_guard<std::recursive_timed_mutex> lock(
+        commands_pending_response_mutex);
+    commands_pending_response.clear();
+    commands_pending_response_index.clear();
+    command_response_max_latency_ms = 0;
+    command_response_max_latency_opcode = HCI_COMMAND_NONE;
   }
 
   // Make sure we run in a bounded amount of time
@@ -283,8 +385,8 @@ static future_t* hci_module_shut_down() {
   {
     std::lock_guard<std::recursive_timed_mutex> lock(
         commands_pending_response_mutex);
-    list_free(commands_pending_response);
-    commands_pending_response = NULL;
+    commands_pending_response.clear();
+    commands_pending_response_index.clear();
   }
 
   packet_fragmenter->cleanup();
@@ -415,7 +517,9 @@ static void event_command_ready(waiting_command_t* wait_entry) {
     std::lock_guard<std::recursive_timed_mutex> lock(
         commands_pending_response_mutex);
     wait_entry->timestamp = std::chrono::steady_clock::now();
-    list_append(commands_pending_response, wait_entry);
+    commands_pending_response.push_back(wait_entry);
+    commands_pending_response_index.emplace(
+        wait_entry->opcode, std::prev(commands_pending_response.end()));
   }
   // Send it off
   packet_fragmenter->fragment_and_dispatch(wait_entry->command);
@@ -440,6 +544,7 @@ static void event_packet_ready(void* pkt) {
 
 // Callback for the fragmenter to send a fragment
 static void transmit_fragment(BT_HDR* packet, bool send_transmit_finished) {
+  TRACEPOINT(TRACE_HCI_TX, packet->event & MSG_EVT_MASK, packet->len);
   btsnoop->capture(packet, false);
 
   // HCI command packets are freed on a different thread when the matching
@@ -450,6 +555,10 @@ static void transmit_fragment(BT_HDR* packet, bool send_transmit_finished) {
 
   hci_transmit(packet);
 
+  // Last fragment of this packet; push anything the transport staged in its
+  // TX ring out to the controller.
+  if (send_transmit_finished) hci_transmit_flush();
+
   if (free_after_transmit) {
     buffer_allocator->free(packet);
   }
@@ -493,12 +602,13 @@ static void hci_root_inflamed_abort() {
 static void command_timed_out_log_info(void* original_wait_entry) {
   LOG_ERROR("%s: %d commands pending response", __func__,
             get_num_waiting_commands());
+  LOG_ERROR("%s: max in flight %d, queue high watermark %zu", __func__,
+            max_commands_in_flight_seen, command_queue_high_watermark);
+  LOG_ERROR("%s: slowest response so far %d ms (opcode 0x%04x)", __func__,
+            command_response_max_latency_ms,
+            command_response_max_latency_opcode);
 
-  for (const list_node_t* node = list_begin(commands_pending_response);
-       node != list_end(commands_pending_response); node = list_next(node)) {
-    waiting_command_t* wait_entry =
-        reinterpret_cast<waiting_command_t*>(list_node(node));
-
+  for (waiting_command_t* wait_entry : commands_pending_response) {
     int wait_time_ms =
         std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - wait_entry->timestamp)
@@ -576,6 +686,11 @@ static void command_timed_out(void* original_wait_entry) {
 }
 
 // Event/packet receiving functions
+// Runs a batch of ready commands on the HCI thread with a single hop.
+static void event_command_batch_ready(std::vector<base::Closure>* batch) {
+  for (base::Closure& command_ready : *batch) command_ready.Run();
+}
+
 void process_command_credits(int credits) {
   std::lock_guard<std::mutex> command_credits_lock(command_credits_mutex);
 
@@ -584,16 +699,34 @@ void process_command_credits(int credits) {
     return;
   }
 
-  // Subtract commands in flight.
-  command_credits = credits - get_num_waiting_commands();
+  // Num_HCI_Command_Packets already excludes commands the controller has not
+  // responded to, so trust it as-is and only clamp against our own in-flight
+  // bound. Subtracting in-flight commands again would serialize command
+  // trains to one outstanding command even on controllers advertising more.
+  int num_waiting = get_num_waiting_commands();
+  command_credits = std::min(credits, MAX_COMMANDS_IN_FLIGHT - num_waiting);
+
+  if (num_waiting > max_commands_in_flight_seen)
+    max_commands_in_flight_seen = num_waiting;
+  if (command_queue.size() > command_queue_high_watermark)
+    command_queue_high_watermark = command_queue.size();
+
+  if (command_credits <= 0 || command_queue.empty()) return;
 
+  // Drain every command the credits allow in one thread hop so long command
+  // trains (e.g. accept list population) pipeline instead of paying a
+  // message-loop round trip per command.
+  auto* batch = new std::vector<base::Closure>;
   while (command_credits > 0 && !command_queue.empty()) {
-    if (!hci_thread.DoInThread(FROM_HERE, std::move(command_queue.front()))) {
-      LOG(ERROR) << __func__ << ": failed to enqueue command";
-    }
+    batch->push_back(std::move(command_queue.front()));
     command_queue.pop();
     command_credits--;
   }
+
+  if (!hci_thread.DoInThread(FROM_HERE, base::BindOnce(&event_command_batch_ready,
+                                                       base::Owned(batch)))) {
+    LOG(ERROR) << __func__ << ": failed to enqueue command batch";
+  }
 }
 
 bool hci_is_root_inflammation_event_received() {
@@ -644,6 +777,81 @@ void handle_root_inflammation_event() {
   }
 }
 
+// Finds the coalescing slot for |handle|, claiming a free one if needed.
+// Only the HCI thread writes slot handles, so claiming is a plain store.
+// Returns -1 when the table is full.
+static int nocp_find_or_claim_slot(uint16_t handle) {
+  int free_slot = -1;
+  for (int i = 0; i < HCI_NOCP_COALESCE_SLOTS; i++) {
+    uint16_t h_p1 = nocp_slot_handle_p1[i].load();
+    if (h_p1 == (uint16_t)(handle + 1)) return i;
+    if (h_p1 == 0 && free_slot < 0) free_slot = i;
+  }
+  if (free_slot >= 0) nocp_slot_handle_p1[free_slot].store(handle + 1);
+  return free_slot;
+}
+
+// Folds every handle/count pair of a Number of Completed Packets event
+// into the coalescing counters. Returns false without recording any credit
+// when a handle cannot get a slot; the caller then forwards the event
+// unmodified.
+static bool nocp_coalesce_event(uint8_t* payload, uint8_t length) {
+  uint8_t* p = payload;
+  uint8_t num_handles;
+  uint16_t handle;
+  uint16_t num_sent;
+
+  if (length < 1 + 2 * sizeof(uint16_t)) return false;
+  STREAM_TO_UINT8(num_handles, p);
+  if (num_handles == 0 || num_handles > (length - 1) / (2 * sizeof(uint16_t)))
+    return false;
+
+  // Claim slots for every handle first so a full table backs out cleanly
+  // before any credit is recorded.
+  for (uint8_t i = 0; i < num_handles; i++) {
+    STREAM_TO_UINT16(handle, p);
+    STREAM_TO_UINT16(num_sent, p);
+    if (nocp_find_or_claim_slot(handle) < 0) return false;
+  }
+
+  p = payload + 1;
+  for (uint8_t i = 0; i < num_handles; i++) {
+    STREAM_TO_UINT16(handle, p);
+    STREAM_TO_UINT16(num_sent, p);
+    nocp_slot_credits[nocp_find_or_claim_slot(handle)].fetch_add(num_sent);
+  }
+  return true;
+}
+
+uint8_t hci_nocp_drain_coalesced(uint8_t* buffer, uint8_t max_len) {
+  nocp_doorbell_pending.store(false);
+
+  uint8_t num_handles = 0;
+  uint8_t* p = buffer + 1;
+  for (int i = 0; i < HCI_NOCP_COALESCE_SLOTS; i++) {
+    uint16_t h_p1 = nocp_slot_handle_p1[i].load();
+    if (h_p1 == 0) continue;
+    uint32_t credits = nocp_slot_credits[i].exchange(0);
+    while (credits > 0 &&
+           (uint8_t)(1 + (num_handles + 1) * 2 * sizeof(uint16_t)) <=
+               max_len) {
+      uint16_t chunk = (credits > 0xFFFF) ? 0xFFFF : (uint16_t)credits;
+      UINT16_TO_STREAM(p, (uint16_t)(h_p1 - 1));
+      UINT16_TO_STREAM(p, chunk);
+      credits -= chunk;
+      num_handles++;
+    }
+    // A full buffer can only happen when a slot accumulated more than
+    // 0xffff credits between drains; put the excess back for the next
+    // doorbell rather than dropping it.
+    if (credits > 0) nocp_slot_credits[i].fetch_add(credits);
+  }
+
+  if (num_handles == 0) return 0;
+  buffer[0] = num_handles;
+  return (uint8_t)(1 + num_handles * 2 * sizeof(uint16_t));
+}
+
 // Returns true if the event was intercepted and should not proceed to
 // higher layers. Also inspects an incoming event for interesting
 // information, like how many commands are now able to be sent.
@@ -711,6 +919,26 @@ static bool filter_incoming_event(BT_HDR* packet) {
                                     wait_entry->context);
     }
 
+    goto intercepted;
+  } else if (event_code == HCI_NUM_COMPL_DATA_PKTS_EVT) {
+    // Credits are recorded before the doorbell flag is checked, so a main
+    // thread drain that observed the flag set is guaranteed to see them.
+    if (!nocp_coalesce_event(stream, length)) return false;
+    if (!nocp_doorbell_pending.exchange(true)) {
+      // First event of a burst rides up as the drain doorbell. Its credits
+      // already live in the counters, so neuter the payload down to one
+      // zero-credit entry (an empty one would fail the btu minimum-length
+      // check).
+      stream[0] = 1; /* Num_Handles */
+      stream[3] = 0; /* first Num_Completed_Packets, little endian */
+      stream[4] = 0;
+      return false;
+    }
+    uint32_t coalesced = nocp_events_coalesced.fetch_add(1) + 1;
+    if ((coalesced % 1000) == 0) {
+      LOG_INFO("%s coalesced %u NOCP events on the HCI thread", __func__,
+               coalesced);
+    }
     goto intercepted;
   } else if (event_code == HCI_VENDOR_SPECIFIC_EVT) {
     uint8_t sub_event_code;
@@ -772,25 +1000,39 @@ static waiting_command_t* get_waiting_command(command_opcode_t opcode) {
   std::lock_guard<std::recursive_timed_mutex> lock(
       commands_pending_response_mutex);
 
-  for (const list_node_t* node = list_begin(commands_pending_response);
-       node != list_end(commands_pending_response); node = list_next(node)) {
-    waiting_command_t* wait_entry =
-        reinterpret_cast<waiting_command_t*>(list_node(node));
+  auto range = commands_pending_response_index.equal_range(opcode);
+  if (range.first == range.second) return NULL;
 
-    if (!wait_entry || wait_entry->opcode != opcode) continue;
+  // If the same opcode is in flight more than once, the controller answers
+  // the oldest instance first.
+  auto oldest = range.first;
+  for (auto it = std::next(range.first); it != range.second; ++it) {
+    if ((*it->second)->timestamp < (*oldest->second)->timestamp) oldest = it;
+  }
 
-    list_remove(commands_pending_response, wait_entry);
+  waiting_command_t* wait_entry = *oldest->second;
+  commands_pending_response.erase(oldest->second);
+  commands_pending_response_index.erase(oldest);
 
-    return wait_entry;
+  int latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - wait_entry->timestamp)
+                       .count();
+  if (latency_ms > command_response_max_latency_ms) {
+    command_response_max_latency_ms = latency_ms;
+    command_response_max_latency_opcode = opcode;
+  }
+  if (latency_ms >= COMMAND_RESPONSE_SLOW_THRESHOLD_MS) {
+    LOG_WARN("%s opcode 0x%04x waited %d ms for a response", __func__, opcode,
+             latency_ms);
   }
 
-  return NULL;
+  return wait_entry;
 }
 
 static int get_num_waiting_commands() {
   std::lock_guard<std::recursive_timed_mutex> lock(
       commands_pending_response_mutex);
-  return list_length(commands_pending_response);
+  return commands_pending_response.size();
 }
 
 static void update_command_response_timer(void) {
@@ -798,11 +1040,11 @@ static void update_command_response_timer(void) {
       commands_pending_response_mutex);
 
   if (command_response_timer == NULL) return;
-  if (list_is_empty(commands_pending_response)) {
+  if (commands_pending_response.empty()) {
     alarm_cancel(command_response_timer);
   } else {
     alarm_set(command_response_timer, COMMAND_PENDING_TIMEOUT_MS,
-              command_timed_out, list_front(commands_pending_response));
+              command_timed_out, commands_pending_response.front());
   }
 }
 
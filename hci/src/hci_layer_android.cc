@@ -53,6 +53,7 @@ using ::bluetooth::common::StopWatchLegacy;
 using namespace ::android::hardware::bluetooth;
 
 extern void initialization_complete();
+extern void hci_configure_rx_thread();
 extern void hci_event_received(const base::Location& from_here, BT_HDR* packet);
 extern void acl_event_received(BT_HDR* packet);
 extern void sco_data_received(BT_HDR* packet);
@@ -96,6 +97,11 @@ class BluetoothHciCallbacks : public V1_1::IBluetoothHciCallbacks {
   }
 
   BT_HDR* WrapPacketAndCopy(uint16_t event, const hidl_vec<uint8_t>& data) {
+    // inbound packets arrive on binder threads the HAL picks for us; make
+    // sure each of them runs with the configured RX scheduling (no-op after
+    // the first packet on a given thread)
+    hci_configure_rx_thread();
+
     size_t packet_size = data.size() + BT_HDR_SIZE;
     BT_HDR* packet =
         reinterpret_cast<BT_HDR*>(buffer_allocator->alloc(packet_size));
@@ -232,6 +238,11 @@ void hci_transmit(BT_HDR* packet) {
   }
 }
 
+void hci_transmit_flush(void) {
+  // Packets go to the HAL one at a time; nothing is staged on this
+  // transport.
+}
+
 int hci_open_firmware_log_file() {
   if (rename(LOG_PATH, LAST_LOG_PATH) == -1 && errno != ENOENT) {
     LOG_ERROR("%s unable to rename '%s' to '%s': %s", __func__, LOG_PATH,
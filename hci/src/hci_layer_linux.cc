@@ -30,12 +30,16 @@
 #include <string.h>
 #include <algorithm>
 
+#include <mutex>
+
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "buffer_allocator.h"
 #include "hci_internals.h"
 #include "hci_layer.h"
+#include "osi/include/alarm.h"
 #include "osi/include/compat.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
@@ -93,6 +97,7 @@ enum HciPacketType {
 };
 
 extern void initialization_complete();
+extern void hci_configure_rx_thread();
 extern void hci_event_received(const base::Location& from_here, BT_HDR* packet);
 extern void acl_event_received(BT_HDR* packet);
 extern void sco_data_received(BT_HDR* packet);
@@ -103,10 +108,16 @@ static int rfkill_en;
 static int wait_hcidev(void);
 static int rfkill(int block);
 
+void hci_transmit_flush(void);
+static alarm_t* tx_ring_flush_alarm;
+
 int reader_thread_ctrl_fd = -1;
 Thread* reader_thread = NULL;
 
 void monitor_socket(int ctrl_fd, int fd) {
+  /* this thread does nothing but read the transport, keep it scheduled */
+  hci_configure_rx_thread();
+
   const allocator_t* buffer_allocator = buffer_allocator_get_interface();
   const size_t buf_size = 2000;
   uint8_t buf[buf_size];
@@ -224,6 +235,12 @@ void hci_initialize() {
 void hci_close() {
   LOG(INFO) << __func__;
 
+  hci_transmit_flush();
+  if (tx_ring_flush_alarm != NULL) {
+    alarm_free(tx_ring_flush_alarm);
+    tx_ring_flush_alarm = NULL;
+  }
+
   if (bt_vendor_fd != -1) {
     close(bt_vendor_fd);
     bt_vendor_fd = -1;
@@ -244,6 +261,58 @@ void hci_close() {
   rfkill(1);
 }
 
+// TX descriptor ring between the fragmenter output and the transport. The
+// fragmenter reuses one buffer for all fragments of a packet and overwrites
+// each fragment's tail with the next ACL header, so fragments are staged by
+// copy and handed to the driver with a single writev() when the packet's
+// last fragment arrives (hci_transmit_flush) or the flush alarm expires,
+// whichever comes first.
+#define HCI_TX_RING_SLOTS 8
+// Biggest fragment: ACL preamble plus the classic ACL MTU plus the H4
+// packet type byte.
+#define HCI_TX_RING_SLOT_SIZE 1030
+#define HCI_TX_RING_FLUSH_TIMEOUT_MS 1
+
+typedef struct {
+  uint8_t data[HCI_TX_RING_SLOT_SIZE];
+  size_t len;
+} tx_ring_slot_t;
+
+static std::mutex tx_ring_mutex;
+static tx_ring_slot_t tx_ring[HCI_TX_RING_SLOTS];
+static size_t tx_ring_count = 0;
+
+// Must be called with tx_ring_mutex held.
+static void tx_ring_flush_locked(void) {
+  if (tx_ring_count == 0) return;
+
+  struct iovec iov[HCI_TX_RING_SLOTS];
+  size_t total = 0;
+  for (size_t i = 0; i < tx_ring_count; i++) {
+    iov[i].iov_base = tx_ring[i].data;
+    iov[i].iov_len = tx_ring[i].len;
+    total += tx_ring[i].len;
+  }
+
+  ssize_t ret;
+  OSI_NO_INTR(ret = writev(bt_vendor_fd, iov, tx_ring_count));
+  tx_ring_count = 0;
+
+  if (ret == -1) PLOG(FATAL) << "writev failed";
+
+  if ((size_t)ret != total) LOG(ERROR) << "Should have send whole TX ring";
+}
+
+static void tx_ring_flush_alarm_cb(UNUSED_ATTR void* context) {
+  std::lock_guard<std::mutex> lock(tx_ring_mutex);
+  tx_ring_flush_locked();
+}
+
+void hci_transmit_flush(void) {
+  std::lock_guard<std::mutex> lock(tx_ring_mutex);
+  tx_ring_flush_locked();
+}
+
 void hci_transmit(BT_HDR* packet) {
   uint8_t type = 0;
 
@@ -268,11 +337,37 @@ void hci_transmit(BT_HDR* packet) {
   uint8_t* addr = packet->data + packet->offset - 1;
   uint8_t store = *addr;
   *addr = type;
-  size_t ret = write(bt_vendor_fd, addr, packet->len + 1);
+  size_t length = packet->len + 1;
+
+  {
+    std::lock_guard<std::mutex> lock(tx_ring_mutex);
+    if (length <= HCI_TX_RING_SLOT_SIZE) {
+      if (tx_ring_count == HCI_TX_RING_SLOTS) tx_ring_flush_locked();
+
+      memcpy(tx_ring[tx_ring_count].data, addr, length);
+      tx_ring[tx_ring_count].len = length;
+      tx_ring_count++;
+      *(addr) = store;
+
+      if (tx_ring_count == 1) {
+        if (tx_ring_flush_alarm == NULL)
+          tx_ring_flush_alarm = alarm_new("hci.tx_ring_flush");
+        alarm_set(tx_ring_flush_alarm, HCI_TX_RING_FLUSH_TIMEOUT_MS,
+                  tx_ring_flush_alarm_cb, NULL);
+      }
+      return;
+    }
+
+    // Oversized packet: drain the ring first to keep ordering, then write
+    // it through directly.
+    tx_ring_flush_locked();
+  }
+
+  size_t ret = write(bt_vendor_fd, addr, length);
 
   *(addr) = store;
 
-  if (ret != packet->len + 1) LOG(ERROR) << "Should have send whole packet";
+  if (ret != length) LOG(ERROR) << "Should have send whole packet";
 
   if (ret == -1) PLOG(FATAL) << "write failed";
 }
@@ -28,6 +28,7 @@
 #include "buffer_allocator.h"
 #include "device/include/controller.h"
 #include "hci_internals.h"
+#include "osi/include/buffer.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
 
@@ -50,14 +51,32 @@ static const allocator_t* buffer_allocator;
 static const controller_t* controller;
 static const packet_fragmenter_callbacks_t* callbacks;
 
-static std::unordered_map<uint16_t /* handle */, BT_HDR*> partial_packets;
+// In-flight L2CAP SDU being reassembled for one ACL handle. Incoming
+// fragments are chained in place instead of being copied into a
+// preallocated jumbo buffer; a single gather pass runs when the SDU
+// completes and the contiguous packet is needed by the stack.
+typedef struct {
+  uint16_t event;
+  uint16_t full_length;      // Expected SDU length, including ACL preamble
+  uint16_t received_length;  // Bytes chained so far
+  buffer_chain_t* chain;
+} partial_sdu_t;
+
+static std::unordered_map<uint16_t /* handle */, partial_sdu_t> partial_packets;
 static std::unordered_map<uint16_t /* handle */, BT_HDR*> partial_iso_packets;
 
+// Chain free callback: each fragment is owned by the HAL packet it arrived in.
+static void free_fragment_packet(void* owner) {
+  buffer_allocator->free(owner);
+}
+
 static void init(const packet_fragmenter_callbacks_t* result_callbacks) {
   callbacks = result_callbacks;
 }
 
 static void cleanup() {
+  for (auto& map_entry : partial_packets)
+    buffer_chain_free(map_entry.second.chain);
   partial_packets.clear();
   partial_iso_packets.clear();
 }
@@ -395,9 +414,8 @@ static void reassemble_and_dispatch(BT_HDR* packet) {
             "Dropping old.",
             __func__);
 
-        BT_HDR* hdl = map_iter->second;
+        buffer_chain_free(map_iter->second.chain);
         partial_packets.erase(map_iter);
-        buffer_allocator->free(hdl);
       }
 
       if (acl_length < L2CAP_HEADER_PDU_LEN_SIZE) {
@@ -430,23 +448,22 @@ static void reassemble_and_dispatch(BT_HDR* packet) {
         return;
       }
 
-      BT_HDR* partial_packet =
-          (BT_HDR*)buffer_allocator->alloc(full_length + sizeof(BT_HDR));
-      partial_packet->event = packet->event;
-      partial_packet->len = full_length;
-      partial_packet->offset = packet->len;
-
-      memcpy(partial_packet->data, packet->data, packet->len);
-
-      // Update the ACL data size to indicate the full expected length
-      stream = partial_packet->data;
+      // Patch the ACL data size in place so the first fragment already
+      // carries the full expected length when the chain is flattened.
+      stream = packet->data;
       STREAM_SKIP_UINT16(stream);  // skip the handle
       UINT16_TO_STREAM(stream, full_length - HCI_ACL_PREAMBLE_SIZE);
 
-      partial_packets[handle] = partial_packet;
+      partial_sdu_t partial_sdu;
+      partial_sdu.event = packet->event;
+      partial_sdu.full_length = full_length;
+      partial_sdu.received_length = packet->len;
+      partial_sdu.chain = buffer_chain_new(free_fragment_packet);
+      buffer_chain_append(partial_sdu.chain, packet, packet->data, packet->len);
 
-      // Free the old packet buffer, since we don't need it anymore
-      buffer_allocator->free(packet);
+      // The fragment bytes stay in the HAL packet until the SDU completes;
+      // no copy happens here.
+      partial_packets[handle] = partial_sdu;
     } else {
       auto map_iter = partial_packets.find(handle);
       if (map_iter == partial_packets.end()) {
@@ -455,32 +472,43 @@ static void reassemble_and_dispatch(BT_HDR* packet) {
         buffer_allocator->free(packet);
         return;
       }
-      BT_HDR* partial_packet = map_iter->second;
+      partial_sdu_t* partial_sdu = &map_iter->second;
 
-      packet->offset = HCI_ACL_PREAMBLE_SIZE;
-      uint16_t projected_offset =
-          partial_packet->offset + (packet->len - HCI_ACL_PREAMBLE_SIZE);
-      if ((packet->len - packet->offset) >
-          (partial_packet->len - partial_packet->offset)) {
+      uint16_t fragment_length = packet->len - HCI_ACL_PREAMBLE_SIZE;
+      uint16_t remaining_length =
+          partial_sdu->full_length - partial_sdu->received_length;
+      if (fragment_length > remaining_length) {
         LOG_WARN(
             "%s got packet which would exceed expected length of %d. "
             "Truncating.",
-            __func__, partial_packet->len);
-        packet->len = (partial_packet->len - partial_packet->offset) + packet->offset;
-        projected_offset = partial_packet->len;
+            __func__, partial_sdu->full_length);
+        fragment_length = remaining_length;
       }
 
-      memcpy(partial_packet->data + partial_packet->offset,
-             packet->data + packet->offset, packet->len - packet->offset);
-
-      // Free the old packet buffer, since we don't need it anymore
-      buffer_allocator->free(packet);
-      partial_packet->offset = projected_offset;
+      if (fragment_length > 0) {
+        buffer_chain_append(partial_sdu->chain, packet,
+                            packet->data + HCI_ACL_PREAMBLE_SIZE,
+                            fragment_length);
+        partial_sdu->received_length += fragment_length;
+      } else {
+        buffer_allocator->free(packet);
+      }
 
-      if (partial_packet->offset == partial_packet->len) {
-        partial_packets.erase(handle);
-        partial_packet->offset = 0;
-        callbacks->reassembled(partial_packet);
+      if (partial_sdu->received_length == partial_sdu->full_length) {
+        // The stack consumes SDUs contiguously, so flatten the chain with
+        // one gather pass now that the total size is known exactly.
+        BT_HDR* full_packet = (BT_HDR*)buffer_allocator->alloc(
+            partial_sdu->full_length + sizeof(BT_HDR));
+        full_packet->event = partial_sdu->event;
+        full_packet->len = partial_sdu->full_length;
+        full_packet->offset = 0;
+        full_packet->layer_specific = 0;
+        buffer_chain_flatten(partial_sdu->chain, full_packet->data,
+                             partial_sdu->full_length);
+
+        buffer_chain_free(partial_sdu->chain);
+        partial_packets.erase(map_iter);
+        callbacks->reassembled(full_packet);
       }
     }
   } else if ((packet->event & MSG_EVT_MASK) == MSG_HC_TO_STACK_HCI_ISO) {
@@ -41,6 +41,7 @@ void monitor_socket(int ctrl_fd, int fd) {
 void hci_initialize() { LOG(INFO) << __func__ << " UNIMPLEMENTED"; }
 void hci_close() { LOG(INFO) << __func__ << " UNIMPLEMENTED"; }
 void hci_transmit(BT_HDR* packet) { LOG(INFO) << __func__ << " UNIMPLEMENTED"; }
+void hci_transmit_flush(void) {}
 int hci_open_firmware_log_file() { return INVALID_FD; }
 void hci_close_firmware_log_file(int fd) {}
 void hci_log_firmware_debug_packet(int fd, BT_HDR* packet) {}
@@ -359,6 +359,12 @@ typedef struct {
   /** Closes the interface. */
   void (*cleanup)(void);
 
+  /** Toggle the low-latency (game) audio mode for the given device.
+   *  While enabled the stack shrinks its transmit buffering and lets the
+   *  controller flush stale audio, trading robustness to link hiccups
+   *  for end-to-end latency. */
+  bt_status_t (*set_low_latency_mode)(const RawAddress& bd_addr,
+                                      bool enabled);
 } btav_source_interface_t;
 
 /** Represents the standard BT-AV A2DP Sink interface.
@@ -184,6 +184,14 @@ typedef void (*conn_updated_callback)(int conn_id, uint16_t interval,
 /** Callback when services are changed */
 typedef void (*service_changed_callback)(int conn_id);
 
+/**
+ * Batched GATT notifications, delivered in arrival order. Only invoked for
+ * connections that opted in through set_notification_batching.
+ */
+typedef void (*notify_batch_callback)(int conn_id,
+                                      const btgatt_notify_params_t* p_data,
+                                      int count);
+
 typedef struct {
   register_client_callback register_client_cb;
   connect_callback open_cb;
@@ -205,6 +213,7 @@ typedef struct {
   phy_updated_callback phy_updated_cb;
   conn_updated_callback conn_updated_cb;
   service_changed_callback service_changed_cb;
+  notify_batch_callback notify_batch_cb;
 } btgatt_client_callbacks_t;
 
 /** Represents the standard BT-GATT client interface. */
@@ -310,6 +319,14 @@ typedef struct {
   /** Get gatt db content */
   bt_status_t (*get_gatt_db)(int conn_id);
 
+  /**
+   * Coalesce notifications received on this connection within a window of
+   * 1-5 ms into a single notify_batch_cb upcall. A window of 0 disables
+   * batching. Indications always flush pending notifications and are
+   * delivered immediately.
+   */
+  bt_status_t (*set_notification_batching)(int conn_id, int window_ms);
+
 } btgatt_client_interface_t;
 
 __END_DECLS
@@ -30,6 +30,9 @@ __BEGIN_DECLS
 #define BTSOCK_FLAG_AUTH_MITM (1 << 3)
 #define BTSOCK_FLAG_AUTH_16_DIGIT (1 << 4)
 #define BTSOCK_FLAG_LE_COC (1 << 5)
+/* Opt this socket out of TX coalescing; every app write is pushed to the
+ * peer immediately (the TCP_NODELAY equivalent). */
+#define BTSOCK_FLAG_NO_COALESCE (1 << 6)
 
 typedef enum {
   BTSOCK_RFCOMM = 1,
@@ -421,6 +421,13 @@
 #define BTM_BLE_CONFORMANCE_TESTING FALSE
 #endif
 
+/* Window (in ms) within which repeated LE advertising reports carrying
+ * identical data from the same device are suppressed. 0 disables suppression.
+ */
+#ifndef BTM_BLE_ADV_DEDUP_WINDOW_MS
+#define BTM_BLE_ADV_DEDUP_WINDOW_MS 100
+#endif
+
 /******************************************************************************
  *
  * L2CAP
@@ -29,6 +29,8 @@
 #include <base/logging.h>
 #include <hardware/bluetooth.h>
 
+#include <atomic>
+
 #include "bt_common.h"
 #include "btcore/include/module.h"
 #include "bte.h"
@@ -37,17 +39,28 @@
 #include "btu.h"
 #include "device/include/interop.h"
 #include "hci_layer.h"
+#include "osi/include/allocator.h"
+#include "osi/include/fixed_queue_mpsc.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
 #include "shim/hci_layer.h"
 #include "shim/shim.h"
 #include "stack_config.h"
 
+/* HCI packets run per drain pass before yielding the main thread */
+#define BTE_HCI_DRAIN_BUDGET 64
+
 /*******************************************************************************
  *  Static variables
  ******************************************************************************/
 static const hci_t* hci;
 
+/* Inbound HCI traffic arrives on whichever threads the HAL picks (plus the
+ * hci thread for events), so the staging queue is multi-producer; the btu
+ * main thread is the only consumer. */
+static fixed_queue_mpsc_t* hci_msg_queue;
+static std::atomic_bool hci_drain_scheduled;
+
 /*******************************************************************************
  *  Externs
  ******************************************************************************/
@@ -57,24 +70,73 @@ extern void btu_hci_msg_process(BT_HDR* p_msg);
  *  Static functions
  ******************************************************************************/
 
+/******************************************************************************
+ *
+ * Function         btu_hci_msg_drain
+ *
+ * Description      Runs staged HCI packets on the main thread, up to the
+ *                  drain budget per pass. Reposts itself while a backlog
+ *                  remains so a burst cannot monopolize the thread.
+ *
+ * Returns          None
+ *
+ *****************************************************************************/
+static void btu_hci_msg_drain(void) {
+  for (uint32_t processed = 0; processed < BTE_HCI_DRAIN_BUDGET; processed++) {
+    BT_HDR* p_msg =
+        static_cast<BT_HDR*>(fixed_queue_mpsc_try_dequeue(hci_msg_queue));
+    if (p_msg == NULL) break;
+    btu_hci_msg_process(p_msg);
+  }
+
+  hci_drain_scheduled.store(false, std::memory_order_release);
+  if (fixed_queue_mpsc_length(hci_msg_queue) == 0) return;
+
+  /* Budget exhausted, or a producer enqueued while the flag was being
+   * cleared; either way another pass is needed. */
+  if (!hci_drain_scheduled.exchange(true, std::memory_order_acq_rel) &&
+      do_in_main_thread(FROM_HERE, base::Bind(&btu_hci_msg_drain)) !=
+          BT_STATUS_SUCCESS) {
+    LOG(ERROR) << __func__ << ": do_in_main_thread failed";
+    hci_drain_scheduled.store(false, std::memory_order_release);
+  }
+}
+
 /******************************************************************************
  *
  * Function         post_to_hci_message_loop
  *
- * Description      Post an HCI event to the main thread
+ * Description      Stage an inbound HCI packet for the main thread. The
+ *                  enqueue is a single atomic exchange, so RX threads never
+ *                  contend on the message loop lock or with each other; only
+ *                  the first packet of a burst posts a drain task.
  *
  * Returns          None
  *
  *****************************************************************************/
 void post_to_main_message_loop(const base::Location& from_here, BT_HDR* p_msg) {
-  if (do_in_main_thread(from_here, base::Bind(&btu_hci_msg_process, p_msg)) !=
+  fixed_queue_mpsc_enqueue(hci_msg_queue, p_msg);
+
+  if (hci_drain_scheduled.exchange(true, std::memory_order_acq_rel)) return;
+  if (do_in_main_thread(from_here, base::Bind(&btu_hci_msg_drain)) !=
       BT_STATUS_SUCCESS) {
     LOG(ERROR) << __func__ << ": do_in_main_thread failed from "
                << from_here.ToString();
+    hci_drain_scheduled.store(false, std::memory_order_release);
   }
 }
 
 void bte_main_init(void) {
+  if (hci_msg_queue == NULL) hci_msg_queue = fixed_queue_mpsc_new(SIZE_MAX);
+
+  /* Drop packets stranded by a shutdown that raced a pending drain. */
+  BT_HDR* p_msg;
+  while ((p_msg = static_cast<BT_HDR*>(
+              fixed_queue_mpsc_try_dequeue(hci_msg_queue))) != NULL) {
+    osi_free(p_msg);
+  }
+  hci_drain_scheduled.store(false, std::memory_order_relaxed);
+
   hci = hci_layer_get_interface();
   if (!hci) {
     LOG_ERROR("%s could not get hci layer interface.", __func__);
@@ -64,7 +64,6 @@ extern tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda);
 extern void btm_acl_update_inquiry_status(uint8_t status);
 extern void btm_clear_all_pending_le_entry(void);
 extern void btm_clr_inq_result_flt(void);
-extern void btm_set_eir_uuid(uint8_t* p_eir, tBTM_INQ_RESULTS* p_results);
 extern void btm_sort_inq_result(void);
 extern void btm_process_inq_complete(uint8_t status, uint8_t result_type);
 
@@ -228,9 +227,18 @@ void btm_api_process_extended_inquiry_result(RawAddress raw_address,
   }
 
   if (is_new || update) {
-    memset(p_i->inq_info.results.eir_uuid, 0,
-           BTM_EIR_SERVICE_ARRAY_SIZE * (BTM_EIR_ARRAY_BITS / 8));
-    btm_set_eir_uuid(const_cast<uint8_t*>(eir_data), &p_i->inq_info.results);
+    /* Keep the raw EIR; the UUID bit map is parsed out lazily on the first
+     * BTM_HasInquiryEirService() lookup */
+    uint16_t copy_len = (eir_len < BTM_INQ_RESULT_EIR_SIZE)
+                            ? static_cast<uint16_t>(eir_len)
+                            : BTM_INQ_RESULT_EIR_SIZE;
+    memcpy(p_i->inq_info.results.eir_data, eir_data, copy_len);
+    /* The parser stops at a zero-length AD structure, so terminate short
+     * payloads instead of leaving stale bytes behind them */
+    memset(p_i->inq_info.results.eir_data + copy_len, 0,
+           BTM_INQ_RESULT_EIR_SIZE - copy_len);
+    p_i->inq_info.results.eir_data_len = copy_len;
+    p_i->inq_info.results.eir_parsed = false;
     uint8_t* p_eir_data = const_cast<uint8_t*>(eir_data);
     (btm_cb.btm_inq_vars.p_inq_results_cb)(&p_i->inq_info.results, p_eir_data,
                                            eir_len);
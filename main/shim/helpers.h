@@ -117,13 +117,12 @@ inline BT_HDR* MakeLegacyBtHdrPacket(
     std::unique_ptr<bluetooth::hci::PacketView<bluetooth::hci::kLittleEndian>>
         packet,
     const std::vector<uint8_t>& preamble) {
-  std::vector<uint8_t> packet_vector(packet->begin(), packet->end());
+  size_t packet_size = packet->size();
   BT_HDR* buffer = static_cast<BT_HDR*>(
-      osi_calloc(packet_vector.size() + preamble.size() + sizeof(BT_HDR)));
+      osi_calloc(packet_size + preamble.size() + sizeof(BT_HDR)));
   std::copy(preamble.begin(), preamble.end(), buffer->data);
-  std::copy(packet_vector.begin(), packet_vector.end(),
-            buffer->data + preamble.size());
-  buffer->len = preamble.size() + packet_vector.size();
+  std::copy(packet->begin(), packet->end(), buffer->data + preamble.size());
+  buffer->len = preamble.size() + packet_size;
   return buffer;
 }
 
@@ -249,6 +248,35 @@ inline bool IsPacketFlushable(const BT_HDR* p_buf) {
   return ToPacketData<const HciDataPreamble>(p_buf)->IsFlushable();
 }
 
+// Builder that serializes an outgoing payload straight out of the legacy
+// BT_HDR it arrived in, rather than copying it into a RawBuilder vector
+// first. Takes ownership of |p_buf| and frees it once GD destroys the
+// builder after serialization, so shim-mode TX performs the same single
+// copy as the single-stack path.
+class BtHdrBuilder : public packet::RawBuilder {
+ public:
+  // The first |trim_front| bytes of the payload are skipped, for callers
+  // that strip an already-consumed preamble.
+  explicit BtHdrBuilder(BT_HDR* p_buf, uint16_t trim_front = 0)
+      : p_buf_(p_buf), trim_front_(trim_front) {
+    ASSERT(p_buf != nullptr);
+    SetFlushable(IsPacketFlushable(p_buf));
+  }
+  ~BtHdrBuilder() override { osi_free(p_buf_); }
+
+  size_t size() const override { return p_buf_->len - trim_front_; }
+
+  void Serialize(packet::BitInserter& it) const override {
+    const uint8_t* data = p_buf_->data + p_buf_->offset + trim_front_;
+    const uint8_t* end = data + size();
+    for (const uint8_t* p = data; p != end; p++) insert(*p, it);
+  }
+
+ private:
+  BT_HDR* p_buf_;
+  uint16_t trim_front_;
+};
+
 namespace debug {
 
 inline void DumpBtHdr(const BT_HDR* p_buf, const char* token) {
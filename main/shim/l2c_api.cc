@@ -787,12 +787,9 @@ uint8_t L2CA_DataWrite(uint16_t cid, BT_HDR* p_data) {
     return 0;
   }
   auto len = p_data->len;
-  auto* data = p_data->data + p_data->offset;
-  uint8_t sent_length =
-      classic_dynamic_channel_helper_map_[psm]->send(
-          cid, MakeUniquePacket(data, len, IsPacketFlushable(p_data))) *
-      len;
-  osi_free(p_data);
+  uint8_t sent_length = classic_dynamic_channel_helper_map_[psm]->send(
+                            cid, std::make_unique<BtHdrBuilder>(p_data)) *
+                        len;
   return sent_length;
 }
 
@@ -1024,12 +1021,8 @@ uint16_t L2CA_SendFixedChnlData(uint16_t cid, const RawAddress& rem_bda,
     return L2CAP_DW_FAILED;
   }
   auto* helper = &le_fixed_channel_helper_.find(cid)->second;
-  auto len = p_buf->len;
-  auto* data = p_buf->data + p_buf->offset;
-  bool sent =
-      helper->send(ToGdAddress(rem_bda),
-                   MakeUniquePacket(data, len, IsPacketFlushable(p_buf)));
-  osi_free(p_buf);
+  bool sent = helper->send(ToGdAddress(rem_bda),
+                           std::make_unique<BtHdrBuilder>(p_buf));
   return sent ? L2CAP_DW_SUCCESS : L2CAP_DW_FAILED;
 }
 
@@ -1577,12 +1570,9 @@ uint8_t L2CA_LECocDataWrite(uint16_t cid, BT_HDR* p_data) {
     return 0;
   }
   auto len = p_data->len;
-  auto* data = p_data->data + p_data->offset;
-  uint8_t sent_length =
-      le_dynamic_channel_helper_map_[psm]->send(
-          cid, MakeUniquePacket(data, len, IsPacketFlushable(p_data))) *
-      len;
-  osi_free(p_data);
+  uint8_t sent_length = le_dynamic_channel_helper_map_[psm]->send(
+                            cid, std::make_unique<BtHdrBuilder>(p_data)) *
+                        len;
   return sent_length;
 }
 
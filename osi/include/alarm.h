@@ -79,6 +79,19 @@ void alarm_set(alarm_t* alarm, uint64_t interval_ms, alarm_callback_t cb,
 void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
                         alarm_callback_t cb, void* data);
 
+// Sets an |alarm| to execute a callback on the named callback
+// queue |queue_name|. This function is same as |alarm_set| except
+// that the |cb| callback is called on a thread dedicated to
+// |queue_name| instead of the shared default callback thread, so
+// a slow callback on one queue cannot delay alarms on another.
+// The queue and its thread are created on first use and live
+// until |alarm_cleanup|. |queue_name| may not be NULL. If the
+// queue cannot be created, the alarm falls back to the default
+// callback thread.
+void alarm_set_on_queue(alarm_t* alarm, uint64_t interval_ms,
+                        alarm_callback_t cb, void* data,
+                        const char* queue_name);
+
 // This function cancels the |alarm| if it was previously set.
 // When this call returns, the caller has a guarantee that the
 // callback is not in progress and will not be called if it
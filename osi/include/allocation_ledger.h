@@ -0,0 +1,56 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+
+// Always-on per-subsystem accounting of live osi allocations. Unlike the
+// canary-based allocation_tracker, which only runs in debug builds, the
+// ledger costs two relaxed atomic updates per allocation and is meant to
+// stay enabled in the field so out-of-memory reports can be attributed to
+// a subsystem without a rebuild. The tag and requested size travel in a
+// small header in front of each allocation; osi_free reads them back.
+
+typedef enum {
+  ALLOC_TAG_OTHER = 0,  // Anything not routed to a specific subsystem
+  ALLOC_TAG_L2CAP,
+  ALLOC_TAG_GATT,
+  ALLOC_TAG_A2DP,
+  ALLOC_TAG_BTIF,
+  ALLOC_TAG_MAX,
+} alloc_tag_t;
+
+// Number of bytes the ledger prepends to every allocation. Callers of
+// malloc must over-allocate by this much before calling
+// |allocation_ledger_notify_alloc|.
+size_t allocation_ledger_header_size(void);
+
+// Record an allocation of |size| user bytes for |tag| and stamp the header
+// at |ptr|. Returns the adjusted pointer to hand to the caller. |ptr| must
+// point at |size| + allocation_ledger_header_size() usable bytes.
+void* allocation_ledger_notify_alloc(void* ptr, size_t size, alloc_tag_t tag);
+
+// Record the free of an allocation returned by
+// |allocation_ledger_notify_alloc| and return the original base pointer to
+// pass to free. Asserts if |ptr| does not carry a ledger header.
+void* allocation_ledger_notify_free(void* ptr);
+
+// Dump per-tag live byte/block counts and peaks to the |fd| file
+// descriptor in user-readable text format. The |fd| must be valid.
+void allocation_ledger_debug_dump(int fd);
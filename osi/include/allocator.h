@@ -22,6 +22,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "osi/include/allocation_ledger.h"
+
 typedef void* (*alloc_fn)(size_t size);
 typedef void (*free_fn)(void* ptr);
 
@@ -41,6 +43,19 @@ void* osi_malloc(size_t size);
 void* osi_calloc(size_t size);
 void osi_free(void* ptr);
 
+// Tagged variants of |osi_malloc|/|osi_calloc| that attribute the
+// allocation to a subsystem in the allocation ledger. The plain functions
+// above are equivalent to passing ALLOC_TAG_OTHER; either way the buffer
+// is released with |osi_free|. A module-internal header may redirect its
+// translation units wholesale:
+//
+//   #ifndef osi_malloc
+//   #define osi_malloc(size) osi_malloc_tagged((size), ALLOC_TAG_L2CAP)
+//   #define osi_calloc(size) osi_calloc_tagged((size), ALLOC_TAG_L2CAP)
+//   #endif
+void* osi_malloc_tagged(size_t size, alloc_tag_t tag);
+void* osi_calloc_tagged(size_t size, alloc_tag_t tag);
+
 // Free a buffer that was previously allocated with function |osi_malloc|
 // or |osi_calloc| and reset the pointer to that buffer to NULL.
 // |p_ptr| is a pointer to the buffer pointer to be reset.
@@ -54,3 +54,49 @@ void* buffer_ptr(const buffer_t* buf);
 // Returns the length of the writeable memory region referred to by |buf|.
 // |buf| must not be NULL.
 size_t buffer_length(const buffer_t* buf);
+
+typedef struct buffer_chain_t buffer_chain_t;
+
+// Called for the |owner| of each fragment when a chain is freed, so the
+// chain can hold fragment bytes in place without copying or owning them.
+typedef void (*buffer_chain_free_cb)(void* owner);
+
+// Visits one fragment during |buffer_chain_for_each|. Returning false stops
+// the iteration early.
+typedef bool (*buffer_chain_visit_cb)(const void* data, size_t length,
+                                      void* context);
+
+// Returns a new, empty fragment chain. |free_cb| is invoked on each
+// fragment's owner when the chain is freed and may be NULL if fragments
+// outlive the chain. The caller must release the chain with
+// |buffer_chain_free|.
+buffer_chain_t* buffer_chain_new(buffer_chain_free_cb free_cb);
+
+// Frees a fragment chain, invoking the chain's free callback on every
+// appended fragment owner. |chain| may be NULL.
+void buffer_chain_free(buffer_chain_t* chain);
+
+// Appends |length| bytes starting at |data| to the end of |chain|. The bytes
+// are not copied; they must remain valid until the chain is freed. |owner| is
+// an opaque handle (e.g. the containing packet) passed to the free callback.
+// |chain| and |data| must not be NULL; |length| must be greater than 0.
+void buffer_chain_append(buffer_chain_t* chain, void* owner, const void* data,
+                         size_t length);
+
+// Returns the total number of bytes across all fragments in |chain|.
+// |chain| must not be NULL.
+size_t buffer_chain_length(const buffer_chain_t* chain);
+
+// Invokes |visit_cb| on each fragment of |chain| in append order, passing
+// |context| through untouched, until the callback returns false or the chain
+// is exhausted. Neither |chain| nor |visit_cb| may be NULL.
+void buffer_chain_for_each(const buffer_chain_t* chain,
+                           buffer_chain_visit_cb visit_cb, void* context);
+
+// Gathers the chain's fragments into the contiguous region at |dest|,
+// copying at most |max_length| bytes, and returns the number of bytes
+// written. This is the only copying operation on a chain; callers that can
+// consume fragments in place should prefer |buffer_chain_for_each|.
+// |chain| and |dest| must not be NULL.
+size_t buffer_chain_flatten(const buffer_chain_t* chain, void* dest,
+                            size_t max_length);
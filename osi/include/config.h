@@ -146,3 +146,19 @@ bool config_save(const config_t& config, const std::string& filename);
 // that this could be a destructive operation: if |filename| already exists,
 // it will be overwritten.
 bool checksum_save(const std::string& checksum, const std::string& filename);
+
+// Saves |config| to |filename| as a binary snapshot. A snapshot is a cache
+// of an already-saved text config file: it loads much faster than the text
+// parser but carries no comments or formatting. |tag| identifies the
+// generation of the text file the snapshot was built from; the same value
+// must be passed to |config_load_snapshot| for the snapshot to be accepted.
+bool config_save_snapshot(const config_t& config, const std::string& filename,
+                          uint64_t tag);
+
+// Loads a config from the binary snapshot at |filename|. Returns NULL if the
+// file is missing, was written by a different format version, fails its
+// checksum, or was built from a different text file generation than
+// |expected_tag| - in all of those cases the caller should parse the text
+// file instead. |filename| must not be NULL.
+std::unique_ptr<config_t> config_load_snapshot(const char* filename,
+                                               uint64_t expected_tag);
@@ -0,0 +1,91 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+struct fixed_queue_mpsc_t;
+typedef struct fixed_queue_mpsc_t fixed_queue_mpsc_t;
+typedef struct reactor_t reactor_t;
+
+typedef void (*fixed_queue_mpsc_free_cb)(void* data);
+typedef void (*fixed_queue_mpsc_cb)(fixed_queue_mpsc_t* queue, void* context);
+
+// Multi-producer/single-consumer variant of fixed_queue for hot paths where
+// many threads enqueue toward one draining thread (e.g. HCI RX toward the
+// btu task). Producers never take a mutex: enqueue is a lock-free exchange
+// on the queue tail. Exactly one thread may dequeue at a time; concurrent
+// consumers are undefined behaviour.
+
+// Creates a new MPSC queue with the given soft |capacity|. Unlike
+// |fixed_queue_new|, producers are never blocked: |capacity| only bounds
+// |fixed_queue_mpsc_try_enqueue|. Returns NULL on failure. The caller must
+// free the returned queue with |fixed_queue_mpsc_free|.
+fixed_queue_mpsc_t* fixed_queue_mpsc_new(size_t capacity);
+
+// Frees a queue and (optionally) the enqueued elements.
+// |queue| is the queue to free. If the |free_cb| callback is not null,
+// it is called on each queue element to free it. Freeing a queue that is
+// currently in use results in undefined behaviour.
+void fixed_queue_mpsc_free(fixed_queue_mpsc_t* queue,
+                           fixed_queue_mpsc_free_cb free_cb);
+
+// Returns the number of elements currently in the |queue|. The value is a
+// snapshot and may be stale by the time it is observed. If |queue| is NULL,
+// the return value is 0.
+size_t fixed_queue_mpsc_length(fixed_queue_mpsc_t* queue);
+
+// Enqueues the given |data| into the |queue|. This function never blocks
+// and is safe to call from any number of producer threads concurrently.
+// Neither |queue| nor |data| may be NULL.
+void fixed_queue_mpsc_enqueue(fixed_queue_mpsc_t* queue, void* data);
+
+// Tries to enqueue |data| into the |queue|. Returns false immediately if the
+// queue already holds |capacity| elements, true otherwise. Neither |queue|
+// nor |data| may be NULL.
+bool fixed_queue_mpsc_try_enqueue(fixed_queue_mpsc_t* queue, void* data);
+
+// Dequeues the next element from |queue|, blocking the (single) consumer
+// until an item is enqueued. This function will never return NULL. |queue|
+// may not be NULL.
+void* fixed_queue_mpsc_dequeue(fixed_queue_mpsc_t* queue);
+
+// Tries to dequeue an element from |queue| without blocking. Returns NULL
+// immediately if the queue is empty or NULL.
+void* fixed_queue_mpsc_try_dequeue(fixed_queue_mpsc_t* queue);
+
+// This function returns a valid file descriptor. Callers may perform one
+// operation on the fd: select(2). If |select| indicates that the file
+// descriptor is readable, the caller may call |fixed_queue_mpsc_dequeue|
+// without blocking. The caller must not close the returned file descriptor.
+// |queue| may not be NULL.
+int fixed_queue_mpsc_get_dequeue_fd(const fixed_queue_mpsc_t* queue);
+
+// Registers |queue| with |reactor| for dequeue operations, mirroring
+// |fixed_queue_register_dequeue|. Neither |queue|, nor |reactor|, nor
+// |ready_cb| may be NULL. |context| may be NULL.
+void fixed_queue_mpsc_register_dequeue(fixed_queue_mpsc_t* queue,
+                                       reactor_t* reactor,
+                                       fixed_queue_mpsc_cb ready_cb,
+                                       void* context);
+
+// Unregisters the dequeue ready callback for |queue| from whichever reactor
+// it is registered with, if any. This function is idempotent.
+void fixed_queue_mpsc_unregister_dequeue(fixed_queue_mpsc_t* queue);
@@ -0,0 +1,49 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "osi/include/allocator.h"
+
+// Size-class pool allocator for the packet hot path.
+//
+// Buffers up to the largest size class are served from per-class freelists
+// instead of the libc heap, so steady-state packet allocation and free are
+// O(1) pointer pops/pushes. Requests larger than every size class are not
+// handled here and fall through to the regular heap allocator.
+
+// Attempt to allocate |size| bytes from the pools. Returns NULL if |size|
+// does not fit any size class; the caller must then fall back to the heap.
+void* pool_allocator_alloc(size_t size);
+
+// Return |ptr| to its pool if it was allocated by |pool_allocator_alloc|.
+// Returns false if |ptr| is not pool-owned, in which case the caller must
+// free it through the allocator that produced it; the ownership check never
+// reads memory that is not pool-owned. |ptr| may be NULL.
+bool pool_allocator_free(void* ptr);
+
+// Dump per-size-class allocation statistics in user-readable text format to
+// the |fd| file descriptor. The |fd| must be valid.
+void pool_allocator_debug_dump(int fd);
+
+// allocator_t abstraction that serves from the pools and transparently falls
+// back to |osi_malloc|/|osi_free| for oversized requests.
+extern const allocator_t allocator_pool;
@@ -71,6 +71,17 @@ reactor_object_t* reactor_register(reactor_t* reactor, int fd, void* context,
                                    void (*read_ready)(void* context),
                                    void (*write_ready)(void* context));
 
+// Same as |reactor_register|, but subscribes the file descriptor in
+// edge-triggered mode. The reactor then receives one wakeup per readiness
+// transition instead of one per loop iteration while data is pending, which
+// cuts epoll traffic for busy sockets. In exchange, the |read_ready| and
+// |write_ready| callbacks MUST consume the file descriptor until it returns
+// EAGAIN/EWOULDBLOCK, otherwise remaining data will not produce another
+// wakeup. The |fd| must be non-blocking.
+reactor_object_t* reactor_register_edge_triggered(
+    reactor_t* reactor, int fd, void* context,
+    void (*read_ready)(void* context), void (*write_ready)(void* context));
+
 // Changes the subscription mode for the file descriptor represented by
 // |object|. If the caller has already registered a file descriptor with a
 // reactor, has a valid |object|, and decides to change the |read_ready| and/or
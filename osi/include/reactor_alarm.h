@@ -0,0 +1,72 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct reactor_alarm_t reactor_alarm_t;
+typedef struct thread_t thread_t;
+
+typedef void (*reactor_alarm_callback_t)(void* data);
+
+// Reactor-native timer for latency-critical callbacks. A regular |alarm_t|
+// expiry travels kernel timer -> dispatcher thread -> semaphore -> callback
+// queue -> callback thread before the callback runs, costing two to three
+// thread hops. A reactor alarm is a timerfd registered directly on the
+// target thread's reactor, so an expiry is a single wakeup of the thread
+// that will run the callback.
+//
+// Unlike |alarm_t|, a reactor alarm does not hold a wake lock across expiry
+// and will not wake the system from suspend, so it is only suitable for
+// timers that tick while the stack is actively working (e.g. a media or
+// flush timer), not for timeouts that must fire from idle.
+
+// Creates a new reactor alarm that will fire its callback on |thread|'s
+// reactor. |name| is used for logging and is copied. Neither |name| nor
+// |thread| may be NULL. The thread must outlive the alarm. Returns NULL on
+// failure; the returned alarm must be freed with |reactor_alarm_free|.
+reactor_alarm_t* reactor_alarm_new(const char* name, thread_t* thread);
+
+// Frees a reactor alarm created with |reactor_alarm_new|, cancelling it
+// first if it is scheduled. Must not be called from the alarm's own
+// callback. |alarm| may be NULL.
+void reactor_alarm_free(reactor_alarm_t* alarm);
+
+// Schedules |alarm| to run |cb| with |data| on the alarm's thread once,
+// |interval_ms| milliseconds from now. Re-setting an already scheduled
+// alarm replaces the previous deadline and callback. |alarm| and |cb| may
+// not be NULL.
+void reactor_alarm_set(reactor_alarm_t* alarm, uint64_t interval_ms,
+                       reactor_alarm_callback_t cb, void* data);
+
+// Like |reactor_alarm_set|, but the alarm fires every |period_ms|
+// milliseconds until cancelled. Expirations missed while the thread was
+// busy are coalesced into a single callback.
+void reactor_alarm_set_periodic(reactor_alarm_t* alarm, uint64_t period_ms,
+                                reactor_alarm_callback_t cb, void* data);
+
+// Cancels |alarm| if it is scheduled; a no-op otherwise. If the callback is
+// running on another thread, this function blocks until it has returned.
+// |alarm| may not be NULL.
+void reactor_alarm_cancel(reactor_alarm_t* alarm);
+
+// Returns true if |alarm| is scheduled and has not yet fired (one-shot) or
+// has not been cancelled (periodic). |alarm| may be NULL.
+bool reactor_alarm_is_scheduled(const reactor_alarm_t* alarm);
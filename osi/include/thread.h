@@ -82,3 +82,7 @@ reactor_t* thread_get_reactor(const thread_t* thread);
 
 // Returns the name of the given |thread|. |thread| may not be NULL.
 const char* thread_name(const thread_t* thread);
+
+// Dumps per-work-function CPU attribution for every live osi thread to
+// |fd|. Counters decay over time, so the output reflects recent load.
+void thread_dump_all_cpu_stats(int fd);
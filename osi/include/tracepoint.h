@@ -0,0 +1,63 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+// Lightweight tracepoint facility for the stack's hot paths.
+//
+// Each tracepoint records a nanosecond CLOCK_MONOTONIC timestamp, an event
+// identifier and two caller-defined arguments into a fixed-size lock-free
+// ring buffer, so markers are cheap enough to leave enabled in production.
+// The ring is dumped through dumpsys in a stable one-line-per-event format
+// that host tooling can convert into Perfetto track events for per-packet
+// latency breakdowns.
+//
+// Compiling with -DOSI_DISABLE_TRACEPOINTS turns the TRACEPOINT() macro
+// into a no-op and removes all overhead at the call sites.
+
+// Identifiers for the fixed tracepoint sites across the stack.
+typedef enum {
+  TRACE_HCI_TX = 0,          // hci_layer transmit_fragment
+  TRACE_HCI_EVT_RX,          // hci_layer hci_event_received
+  TRACE_HCI_ACL_RX,          // hci_layer acl_event_received
+  TRACE_L2C_RX,              // l2c_rcv_acl_data
+  TRACE_BTU_HCIF_EVT,        // btu_hcif_process_event
+  TRACE_A2DP_ENCODE_TICK,    // btif_a2dp_source encode timer
+  TRACE_GATT_OP_ENQUEUE,     // BtaGattQueue operation enqueued
+  TRACE_GATT_OP_COMPLETE,    // BtaGattQueue operation completed
+  TRACE_ID_MAX,
+} tracepoint_id_t;
+
+// Record one tracepoint event. Lock-free and safe to call from any thread;
+// the oldest entries are overwritten once the ring is full.
+void tracepoint_record(tracepoint_id_t id, uint32_t arg1, uint32_t arg2);
+
+// Discard all recorded events.
+void tracepoint_reset(void);
+
+// Dump the recorded events, oldest first, to the |fd| file descriptor.
+// The caller is responsible for closing the |fd|.
+void tracepoint_debug_dump(int fd);
+
+#if defined(OSI_DISABLE_TRACEPOINTS)
+#define TRACEPOINT(id, arg1, arg2)
+#else
+#define TRACEPOINT(id, arg1, arg2) tracepoint_record((id), (arg1), (arg2))
+#endif
@@ -20,6 +20,7 @@
 
 #include <hardware/bluetooth.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // Set the Bluetooth OS callouts to |callouts|.
 // This function should be called when native kernel wakelocks are not used
@@ -42,6 +43,14 @@ bool wakelock_release(void);
 // graceful shutdown.
 void wakelock_cleanup(void);
 
+// Set how long the underlying wakelock is kept after the last
+// wakelock_release() before it is actually dropped. Re-acquires inside the
+// window are absorbed without touching the kernel, so bursty timer traffic
+// pays for one acquire/release pair per burst. Setting |hysteresis_ms| to 0
+// makes releases synchronous again and flushes any pending deferred release.
+// The function is thread safe.
+void wakelock_set_release_hysteresis_ms(uint64_t hysteresis_ms);
+
 // This function should not need to be called normally.
 // /sys/power/wake_{|un}lock are used by default.
 // This is not guaranteed to have any effect after an alarm has been
@@ -36,10 +36,12 @@
 #include <hardware/bluetooth.h>
 
 #include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
 
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
-#include "osi/include/list.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
 #include "osi/include/semaphore.h"
@@ -54,12 +56,29 @@ using base::CancelableClosure;
 // meet audio deadlines.  Use this priority for all audio/timer related thread.
 static const int THREAD_RT_PRIORITY = 1;
 
+// Callbacks on a given queue share that queue's thread, so one slow callback
+// delays every alarm behind it. Callbacks that run longer than this budget
+// are logged and counted against their queue.
+static const uint64_t ALARM_CALLBACK_BUDGET_MS = 25;
+
 typedef struct {
   size_t count;
   uint64_t total_ms;
   uint64_t max_ms;
 } stat_t;
 
+// A callback queue and the dedicated thread that drains it. Alarms set with
+// |alarm_set| all share the default queue; |alarm_set_on_queue| lets latency
+// sensitive callers (e.g. audio timers) get a queue of their own so they are
+// not stuck behind slow housekeeping callbacks.
+typedef struct {
+  char* name;
+  thread_t* thread;
+  fixed_queue_t* queue;
+  stat_t callback_execution;
+  size_t overrun_count;  // callbacks that blew ALARM_CALLBACK_BUDGET_MS
+} dispatch_queue_t;
+
 // Alarm-related information and statistics
 typedef struct {
   const char* name;
@@ -96,6 +115,7 @@ struct alarm_t {
   uint64_t prev_deadline_ms;  // Previous deadline - used for accounting of
                               // periodic timers
   bool is_periodic;
+  uint64_t pending_sequence;  // Insertion order among equal deadlines
   fixed_queue_t* queue;  // The processing queue to add this alarm to
   alarm_callback_t callback;
   void* data;
@@ -112,11 +132,24 @@ struct alarm_t {
 int64_t TIMER_INTERVAL_FOR_WAKELOCK_IN_MS = 3000;
 static const clockid_t CLOCK_ID = CLOCK_BOOTTIME;
 
+// Orders pending alarms by earliest deadline first; ties are broken by
+// insertion order so equal deadlines dispatch FIFO. Because the tie-breaker
+// is unique per pending alarm, insert and erase are both O(log n).
+struct alarm_deadline_cmp {
+  bool operator()(const alarm_t* a, const alarm_t* b) const {
+    if (a->deadline_ms != b->deadline_ms)
+      return a->deadline_ms < b->deadline_ms;
+    return a->pending_sequence < b->pending_sequence;
+  }
+};
+typedef std::set<alarm_t*, alarm_deadline_cmp> alarm_set_t;
+
 // This mutex ensures that the |alarm_set|, |alarm_cancel|, and alarm callback
 // functions execute serially and not concurrently. As a result, this mutex
-// also protects the |alarms| list.
+// also protects the |alarms| set.
 static std::mutex alarms_mutex;
-static list_t* alarms;
+static alarm_set_t* alarms;
+static uint64_t alarm_next_sequence;
 static timer_t timer;
 static timer_t wakeup_timer;
 static bool timer_set;
@@ -126,9 +159,12 @@ static thread_t* dispatcher_thread;
 static bool dispatcher_thread_active;
 static semaphore_t* alarm_expired;
 
-// Default alarm callback thread and queue
-static thread_t* default_callback_thread;
-static fixed_queue_t* default_callback_queue;
+// Callback queues indexed by name. Guards the map and the per-queue
+// statistics; deliberately separate from |alarms_mutex| because the
+// statistics are updated while an alarm's callback mutex is held.
+static std::mutex dispatch_queues_mutex;
+static std::unordered_map<std::string, dispatch_queue_t*>* dispatch_queues;
+static dispatch_queue_t* default_dispatch_queue;
 
 static alarm_t* alarm_new_internal(const char* name, bool is_periodic);
 static bool lazy_initialize(void);
@@ -146,10 +182,16 @@ static void callback_dispatch(void* context);
 static bool timer_create_internal(const clockid_t clock_id, timer_t* timer);
 static void update_scheduling_stats(alarm_stats_t* stats, uint64_t now_ms,
                                     uint64_t deadline_ms);
-// Registers |queue| for processing alarm callbacks on |thread|.
-// |queue| may not be NULL. |thread| may not be NULL.
-static void alarm_register_processing_queue(fixed_queue_t* queue,
-                                            thread_t* thread);
+// Creates a callback queue named |name| along with its dedicated dispatch
+// thread. Returns NULL on failure. |name| may not be NULL.
+static dispatch_queue_t* dispatch_queue_new(const char* name);
+static void dispatch_queue_free(dispatch_queue_t* dispatch_queue);
+// Returns the callback queue registered under |name|, creating it (and its
+// thread) on first use. Returns NULL if the queue could not be created.
+static dispatch_queue_t* get_dispatch_queue(const char* name);
+// Registers |dispatch_queue|'s fixed queue for processing alarm callbacks on
+// its thread. |dispatch_queue| may not be NULL.
+static void alarm_register_processing_queue(dispatch_queue_t* dispatch_queue);
 
 static void update_stat(stat_t* stat, uint64_t delta_ms) {
   if (stat->max_ms < delta_ms) stat->max_ms = delta_ms;
@@ -164,7 +206,7 @@ alarm_t* alarm_new_periodic(const char* name) {
 }
 
 static alarm_t* alarm_new_internal(const char* name, bool is_periodic) {
-  // Make sure we have a list we can insert alarms into.
+  // Make sure we have a set we can insert alarms into.
   if (!alarms && !lazy_initialize()) {
     CHECK(false);  // if initialization failed, we should not continue
     return NULL;
@@ -211,7 +253,25 @@ uint64_t alarm_get_remaining_ms(const alarm_t* alarm) {
 
 void alarm_set(alarm_t* alarm, uint64_t interval_ms, alarm_callback_t cb,
                void* data) {
-  alarm_set_internal(alarm, interval_ms, cb, data, default_callback_queue,
+  alarm_set_internal(alarm, interval_ms, cb, data,
+                     default_dispatch_queue->queue, false);
+}
+
+void alarm_set_on_queue(alarm_t* alarm, uint64_t interval_ms,
+                        alarm_callback_t cb, void* data,
+                        const char* queue_name) {
+  CHECK(queue_name != NULL);
+
+  dispatch_queue_t* dispatch_queue = get_dispatch_queue(queue_name);
+  if (dispatch_queue == NULL) {
+    // A late callback on the shared thread beats no callback at all.
+    LOG_ERROR("%s unable to create callback queue '%s', using default queue",
+              __func__, queue_name);
+    alarm_set(alarm, interval_ms, cb, data);
+    return;
+  }
+
+  alarm_set_internal(alarm, interval_ms, cb, data, dispatch_queue->queue,
                      false);
 }
 
@@ -259,8 +319,7 @@ void alarm_cancel(alarm_t* alarm) {
 // Internal implementation of canceling an alarm.
 // The caller must hold the |alarms_mutex|
 static void alarm_cancel_internal(alarm_t* alarm) {
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
+  bool needs_reschedule = (!alarms->empty() && *alarms->begin() == alarm);
 
   remove_pending_alarm(alarm);
 
@@ -290,17 +349,20 @@ void alarm_cleanup(void) {
 
   std::lock_guard<std::mutex> lock(alarms_mutex);
 
-  fixed_queue_free(default_callback_queue, NULL);
-  default_callback_queue = NULL;
-  thread_free(default_callback_thread);
-  default_callback_thread = NULL;
+  {
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_queues_mutex);
+    for (auto& entry : *dispatch_queues) dispatch_queue_free(entry.second);
+    delete dispatch_queues;
+    dispatch_queues = NULL;
+    default_dispatch_queue = NULL;
+  }
 
   timer_delete(wakeup_timer);
   timer_delete(timer);
   semaphore_free(alarm_expired);
   alarm_expired = NULL;
 
-  list_free(alarms);
+  delete alarms;
   alarms = NULL;
 }
 
@@ -314,11 +376,7 @@ static bool lazy_initialize(void) {
 
   std::lock_guard<std::mutex> lock(alarms_mutex);
 
-  alarms = list_new(NULL);
-  if (!alarms) {
-    LOG_ERROR("%s unable to allocate alarm list.", __func__);
-    goto error;
-  }
+  alarms = new alarm_set_t;
 
   if (!timer_create_internal(CLOCK_ID, &timer)) goto error;
   timer_initialized = true;
@@ -336,20 +394,11 @@ static bool lazy_initialize(void) {
     goto error;
   }
 
-  default_callback_thread =
-      thread_new_sized("alarm_default_callbacks", SIZE_MAX);
-  if (default_callback_thread == NULL) {
-    LOG_ERROR("%s unable to create default alarm callbacks thread.", __func__);
-    goto error;
-  }
-  thread_set_rt_priority(default_callback_thread, THREAD_RT_PRIORITY);
-  default_callback_queue = fixed_queue_new(SIZE_MAX);
-  if (default_callback_queue == NULL) {
-    LOG_ERROR("%s unable to create default alarm callbacks queue.", __func__);
-    goto error;
-  }
-  alarm_register_processing_queue(default_callback_queue,
-                                  default_callback_thread);
+  dispatch_queues = new std::unordered_map<std::string, dispatch_queue_t*>;
+  default_dispatch_queue = dispatch_queue_new("alarm_default_callbacks");
+  if (default_dispatch_queue == NULL) goto error;
+  dispatch_queues->emplace(default_dispatch_queue->name,
+                           default_dispatch_queue);
 
   dispatcher_thread_active = true;
   dispatcher_thread = thread_new("alarm_dispatcher");
@@ -362,10 +411,10 @@ static bool lazy_initialize(void) {
   return true;
 
 error:
-  fixed_queue_free(default_callback_queue, NULL);
-  default_callback_queue = NULL;
-  thread_free(default_callback_thread);
-  default_callback_thread = NULL;
+  dispatch_queue_free(default_dispatch_queue);
+  default_dispatch_queue = NULL;
+  delete dispatch_queues;
+  dispatch_queues = NULL;
 
   thread_free(dispatcher_thread);
   dispatcher_thread = NULL;
@@ -379,7 +428,7 @@ error:
 
   if (timer_initialized) timer_delete(timer);
 
-  list_free(alarms);
+  delete alarms;
   alarms = NULL;
 
   return false;
@@ -397,10 +446,10 @@ static uint64_t now_ms(void) {
   return (ts.tv_sec * 1000LL) + (ts.tv_nsec / 1000000LL);
 }
 
-// Remove alarm from internal alarm list and the processing queue
+// Remove alarm from the internal pending set and the processing queue
 // The caller must hold the |alarms_mutex|
 static void remove_pending_alarm(alarm_t* alarm) {
-  list_remove(alarms, alarm);
+  alarms->erase(alarm);
 
   if (alarm->for_msg_loop) {
     alarm->closure.i.Cancel();
@@ -415,10 +464,9 @@ static void remove_pending_alarm(alarm_t* alarm) {
 
 // Must be called with |alarms_mutex| held
 static void schedule_next_instance(alarm_t* alarm) {
-  // If the alarm is currently set and it's at the start of the list,
+  // If the alarm is currently set and it's at the start of the set,
   // we'll need to re-schedule since we've adjusted the earliest deadline.
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
+  bool needs_reschedule = (!alarms->empty() && *alarms->begin() == alarm);
   if (alarm->callback) remove_pending_alarm(alarm);
 
   // Calculate the next deadline for this alarm
@@ -429,26 +477,15 @@ static void schedule_next_instance(alarm_t* alarm) {
         ((just_now_ms - alarm->creation_time_ms) % alarm->period_ms);
   alarm->deadline_ms = just_now_ms + (alarm->period_ms - ms_into_period);
 
-  // Add it into the timer list sorted by deadline (earliest deadline first).
-  if (list_is_empty(alarms) ||
-      ((alarm_t*)list_front(alarms))->deadline_ms > alarm->deadline_ms) {
-    list_prepend(alarms, alarm);
-  } else {
-    for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-         node = list_next(node)) {
-      list_node_t* next = list_next(node);
-      if (next == list_end(alarms) ||
-          ((alarm_t*)list_node(next))->deadline_ms > alarm->deadline_ms) {
-        list_insert_after(alarms, node, alarm);
-        break;
-      }
-    }
-  }
+  // Add it into the pending set ordered by deadline (earliest first).
+  // The sequence number keeps dispatch FIFO among equal deadlines and makes
+  // the ordering key unique, so insertion is a single O(log n) operation.
+  alarm->pending_sequence = ++alarm_next_sequence;
+  alarms->insert(alarm);
 
   // If the new alarm has the earliest deadline, we need to re-evaluate our
   // schedule.
-  if (needs_reschedule ||
-      (!list_is_empty(alarms) && list_front(alarms) == alarm)) {
+  if (needs_reschedule || (!alarms->empty() && *alarms->begin() == alarm)) {
     reschedule_root_alarm();
   }
 }
@@ -465,9 +502,9 @@ static void reschedule_root_alarm(void) {
   struct itimerspec timer_time;
   memset(&timer_time, 0, sizeof(timer_time));
 
-  if (list_is_empty(alarms)) goto done;
+  if (alarms->empty()) goto done;
 
-  next = static_cast<alarm_t*>(list_front(alarms));
+  next = *alarms->begin();
   next_expiration = next->deadline_ms - now_ms();
   if (next_expiration < TIMER_INTERVAL_FOR_WAKELOCK_IN_MS) {
     if (!timer_set) {
@@ -543,17 +580,66 @@ done:
   }
 }
 
-static void alarm_register_processing_queue(fixed_queue_t* queue,
-                                            thread_t* thread) {
-  CHECK(queue != NULL);
-  CHECK(thread != NULL);
+static dispatch_queue_t* dispatch_queue_new(const char* name) {
+  dispatch_queue_t* ret =
+      static_cast<dispatch_queue_t*>(osi_calloc(sizeof(dispatch_queue_t)));
+
+  ret->name = osi_strdup(name);
+  ret->thread = thread_new_sized(name, SIZE_MAX);
+  if (ret->thread == NULL) {
+    LOG_ERROR("%s unable to create alarm callbacks thread '%s'.", __func__,
+              name);
+    goto error;
+  }
+  thread_set_rt_priority(ret->thread, THREAD_RT_PRIORITY);
 
-  fixed_queue_register_dequeue(queue, thread_get_reactor(thread),
-                               alarm_queue_ready, NULL);
+  ret->queue = fixed_queue_new(SIZE_MAX);
+  if (ret->queue == NULL) {
+    LOG_ERROR("%s unable to create alarm callbacks queue '%s'.", __func__,
+              name);
+    goto error;
+  }
+  alarm_register_processing_queue(ret);
+  return ret;
+
+error:
+  dispatch_queue_free(ret);
+  return NULL;
+}
+
+static void dispatch_queue_free(dispatch_queue_t* dispatch_queue) {
+  if (!dispatch_queue) return;
+
+  fixed_queue_free(dispatch_queue->queue, NULL);
+  thread_free(dispatch_queue->thread);
+  osi_free(dispatch_queue->name);
+  osi_free(dispatch_queue);
+}
+
+static dispatch_queue_t* get_dispatch_queue(const char* name) {
+  std::lock_guard<std::mutex> lock(dispatch_queues_mutex);
+  if (dispatch_queues == NULL) return NULL;
+
+  auto it = dispatch_queues->find(name);
+  if (it != dispatch_queues->end()) return it->second;
+
+  dispatch_queue_t* dispatch_queue = dispatch_queue_new(name);
+  if (dispatch_queue != NULL)
+    dispatch_queues->emplace(dispatch_queue->name, dispatch_queue);
+  return dispatch_queue;
+}
+
+static void alarm_register_processing_queue(dispatch_queue_t* dispatch_queue) {
+  CHECK(dispatch_queue != NULL);
+
+  fixed_queue_register_dequeue(dispatch_queue->queue,
+                               thread_get_reactor(dispatch_queue->thread),
+                               alarm_queue_ready, dispatch_queue);
 }
 
 static void alarm_ready_generic(alarm_t* alarm,
-                                std::unique_lock<std::mutex>& lock) {
+                                std::unique_lock<std::mutex>& lock,
+                                dispatch_queue_t* dispatch_queue) {
   if (alarm == NULL) {
     return;  // The alarm was probably canceled
   }
@@ -587,25 +673,47 @@ static void alarm_ready_generic(alarm_t* alarm,
   std::lock_guard<std::recursive_mutex> cb_lock(*local_mutex_ref);
   lock.unlock();
 
+  // Keep a copy of the name for the overrun log below; the callback may
+  // free the alarm.
+  char name[64];
+  strncpy(name, alarm->stats.name, sizeof(name) - 1);
+  name[sizeof(name) - 1] = '\0';
+
   // Update the statistics
   update_scheduling_stats(&alarm->stats, now_ms(), deadline_ms);
 
   // NOTE: Do NOT access "alarm" after the callback, as a safety precaution
   // in case the callback itself deleted the alarm.
+  uint64_t start_ms = now_ms();
   callback(data);
+
+  uint64_t duration_ms = now_ms() - start_ms;
+  if (duration_ms > ALARM_CALLBACK_BUDGET_MS) {
+    LOG_WARN("%s alarm '%s' callback ran for %llu ms on '%s' (budget %llu ms)",
+             __func__, name, (unsigned long long)duration_ms,
+             (dispatch_queue != NULL) ? dispatch_queue->name
+                                      : "main message loop",
+             (unsigned long long)ALARM_CALLBACK_BUDGET_MS);
+  }
+  if (dispatch_queue != NULL) {
+    std::lock_guard<std::mutex> stats_lock(dispatch_queues_mutex);
+    update_stat(&dispatch_queue->callback_execution, duration_ms);
+    if (duration_ms > ALARM_CALLBACK_BUDGET_MS) dispatch_queue->overrun_count++;
+  }
 }
 
 static void alarm_ready_mloop(alarm_t* alarm) {
   std::unique_lock<std::mutex> lock(alarms_mutex);
-  alarm_ready_generic(alarm, lock);
+  alarm_ready_generic(alarm, lock, NULL);
 }
 
-static void alarm_queue_ready(fixed_queue_t* queue, UNUSED_ATTR void* context) {
+static void alarm_queue_ready(fixed_queue_t* queue, void* context) {
   CHECK(queue != NULL);
 
   std::unique_lock<std::mutex> lock(alarms_mutex);
   alarm_t* alarm = (alarm_t*)fixed_queue_try_dequeue(queue);
-  alarm_ready_generic(alarm, lock);
+  alarm_ready_generic(alarm, lock,
+                      static_cast<dispatch_queue_t*>(context));
 }
 
 // Callback function for wake alarms and our posix timer
@@ -628,14 +736,13 @@ static void callback_dispatch(UNUSED_ATTR void* context) {
     // Take into account that the alarm may get cancelled before we get to it.
     // We're done here if there are no alarms or the alarm at the front is in
     // the future. Exit right away since there's nothing left to do.
-    if (list_is_empty(alarms) ||
-        (alarm = static_cast<alarm_t*>(list_front(alarms)))->deadline_ms >
-            now_ms()) {
+    if (alarms->empty() ||
+        (alarm = *alarms->begin())->deadline_ms > now_ms()) {
       reschedule_root_alarm();
       continue;
     }
 
-    list_remove(alarms, alarm);
+    alarms->erase(alarms->begin());
 
     if (alarm->is_periodic) {
       alarm->prev_deadline_ms = alarm->deadline_ms;
@@ -734,12 +841,30 @@ void alarm_debug_dump(int fd) {
 
   uint64_t just_now_ms = now_ms();
 
-  dprintf(fd, "  Total Alarms: %zu\n\n", list_length(alarms));
+  dprintf(fd, "  Total Alarms: %zu\n\n", alarms->size());
+
+  // Dump info for each callback queue
+  {
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_queues_mutex);
+    for (auto& entry : *dispatch_queues) {
+      dispatch_queue_t* dispatch_queue = entry.second;
+
+      dprintf(fd, "  Queue : %s\n", dispatch_queue->name);
+
+      dprintf(fd, "%-51s: %zu / %zu\n",
+              "    Callback counts (executed/overrun)",
+              dispatch_queue->callback_execution.count,
+              dispatch_queue->overrun_count);
+
+      dump_stat(fd, &dispatch_queue->callback_execution,
+                "    Callback execution time in ms (total/max/avg)");
+
+      dprintf(fd, "\n");
+    }
+  }
 
   // Dump info for each alarm
-  for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-       node = list_next(node)) {
-    alarm_t* alarm = (alarm_t*)list_node(node);
+  for (alarm_t* alarm : *alarms) {
     alarm_stats_t* stats = &alarm->stats;
 
     dprintf(fd, "  Alarm : %s (%s)\n", stats->name,
@@ -0,0 +1,107 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_osi_allocation_ledger"
+
+#include "osi/include/allocation_ledger.h"
+
+#include <base/logging.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+
+// Prepended to every osi allocation. Eight bytes keeps BT_HDR and other
+// eight-byte-aligned payloads aligned; the debug canary already shifts
+// allocations by the same amount, so nothing in the stack assumes more.
+typedef struct {
+  uint32_t size;  // Requested (user) size in bytes
+  uint16_t tag;   // alloc_tag_t of the allocating subsystem
+  uint16_t magic; // Guards against freeing foreign or corrupted pointers
+} ledger_header_t;
+
+static const uint16_t LEDGER_MAGIC = 0x4c67;
+
+static std::atomic<size_t> live_bytes[ALLOC_TAG_MAX];
+static std::atomic<size_t> live_blocks[ALLOC_TAG_MAX];
+static std::atomic<size_t> peak_bytes[ALLOC_TAG_MAX];
+
+static const char* tag_name(size_t tag) {
+  switch (tag) {
+    case ALLOC_TAG_OTHER:
+      return "other";
+    case ALLOC_TAG_L2CAP:
+      return "l2cap";
+    case ALLOC_TAG_GATT:
+      return "gatt";
+    case ALLOC_TAG_A2DP:
+      return "a2dp";
+    case ALLOC_TAG_BTIF:
+      return "btif";
+    default:
+      return "unknown";
+  }
+}
+
+size_t allocation_ledger_header_size(void) { return sizeof(ledger_header_t); }
+
+void* allocation_ledger_notify_alloc(void* ptr, size_t size, alloc_tag_t tag) {
+  if (!ptr) return ptr;
+  CHECK(size <= UINT32_MAX);
+  CHECK(tag < ALLOC_TAG_MAX);
+
+  ledger_header_t* header = (ledger_header_t*)ptr;
+  header->size = (uint32_t)size;
+  header->tag = (uint16_t)tag;
+  header->magic = LEDGER_MAGIC;
+
+  size_t bytes =
+      live_bytes[tag].fetch_add(size, std::memory_order_relaxed) + size;
+  live_blocks[tag].fetch_add(1, std::memory_order_relaxed);
+  // Racy read-modify-write, but the peak is diagnostic only and a lost
+  // update under contention is preferable to a compare-exchange loop on
+  // every allocation.
+  if (bytes > peak_bytes[tag].load(std::memory_order_relaxed))
+    peak_bytes[tag].store(bytes, std::memory_order_relaxed);
+
+  return header + 1;
+}
+
+void* allocation_ledger_notify_free(void* ptr) {
+  if (!ptr) return ptr;
+
+  ledger_header_t* header = ((ledger_header_t*)ptr) - 1;
+  CHECK(header->magic == LEDGER_MAGIC);
+  CHECK(header->tag < ALLOC_TAG_MAX);
+
+  live_bytes[header->tag].fetch_sub(header->size, std::memory_order_relaxed);
+  live_blocks[header->tag].fetch_sub(1, std::memory_order_relaxed);
+  header->magic = 0;  // Poison against double free
+
+  return header;
+}
+
+void allocation_ledger_debug_dump(int fd) {
+  dprintf(fd, "\nBluetooth Memory Ledger (live osi allocations by tag):\n");
+  for (size_t tag = 0; tag < ALLOC_TAG_MAX; tag++) {
+    dprintf(fd, "  %-6s live: %zu bytes in %zu blocks, peak: %zu bytes\n",
+            tag_name(tag), live_bytes[tag].load(std::memory_order_relaxed),
+            live_blocks[tag].load(std::memory_order_relaxed),
+            peak_bytes[tag].load(std::memory_order_relaxed));
+  }
+}
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "osi/include/allocation_ledger.h"
 #include "osi/include/allocation_tracker.h"
 #include "osi/include/allocator.h"
 
@@ -26,13 +27,7 @@ static const allocator_id_t alloc_allocator_id = 42;
 
 char* osi_strdup(const char* str) {
   size_t size = strlen(str) + 1;  // + 1 for the null terminator
-  size_t real_size = allocation_tracker_resize_for_canary(size);
-  void* ptr = malloc(real_size);
-  CHECK(ptr);
-
-  char* new_string = static_cast<char*>(
-      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size));
-  if (!new_string) return NULL;
+  char* new_string = static_cast<char*>(osi_malloc(size));
 
   memcpy(new_string, str, size);
   return new_string;
@@ -42,37 +37,46 @@ char* osi_strndup(const char* str, size_t len) {
   size_t size = strlen(str);
   if (len < size) size = len;
 
-  size_t real_size = allocation_tracker_resize_for_canary(size + 1);
-  void* ptr = malloc(real_size);
-  CHECK(ptr);
-
-  char* new_string = static_cast<char*>(
-      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size + 1));
-  if (!new_string) return NULL;
+  char* new_string = static_cast<char*>(osi_malloc(size + 1));
 
   memcpy(new_string, str, size);
   new_string[size] = '\0';
   return new_string;
 }
 
-void* osi_malloc(size_t size) {
+void* osi_malloc_tagged(size_t size, alloc_tag_t tag) {
   CHECK(static_cast<ssize_t>(size) >= 0);
-  size_t real_size = allocation_tracker_resize_for_canary(size);
+  size_t ledger_size = size + allocation_ledger_header_size();
+  size_t real_size = allocation_tracker_resize_for_canary(ledger_size);
   void* ptr = malloc(real_size);
   CHECK(ptr);
-  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  void* tracked =
+      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, ledger_size);
+  return allocation_ledger_notify_alloc(tracked, size, tag);
 }
 
-void* osi_calloc(size_t size) {
+void* osi_calloc_tagged(size_t size, alloc_tag_t tag) {
   CHECK(static_cast<ssize_t>(size) >= 0);
-  size_t real_size = allocation_tracker_resize_for_canary(size);
+  size_t ledger_size = size + allocation_ledger_header_size();
+  size_t real_size = allocation_tracker_resize_for_canary(ledger_size);
   void* ptr = calloc(1, real_size);
   CHECK(ptr);
-  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  void* tracked =
+      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, ledger_size);
+  return allocation_ledger_notify_alloc(tracked, size, tag);
+}
+
+void* osi_malloc(size_t size) {
+  return osi_malloc_tagged(size, ALLOC_TAG_OTHER);
+}
+
+void* osi_calloc(size_t size) {
+  return osi_calloc_tagged(size, ALLOC_TAG_OTHER);
 }
 
 void osi_free(void* ptr) {
-  free(allocation_tracker_notify_free(alloc_allocator_id, ptr));
+  free(allocation_tracker_notify_free(alloc_allocator_id,
+                                      allocation_ledger_notify_free(ptr)));
 }
 
 void osi_free_and_reset(void** p_ptr) {
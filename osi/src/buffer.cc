@@ -22,6 +22,7 @@
 
 #include <base/logging.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
@@ -89,3 +90,89 @@ size_t buffer_length(const buffer_t* buf) {
   CHECK(buf != NULL);
   return buf->length;
 }
+
+typedef struct buffer_fragment_t {
+  struct buffer_fragment_t* next;
+  void* owner;
+  const uint8_t* data;
+  size_t length;
+} buffer_fragment_t;
+
+struct buffer_chain_t {
+  buffer_fragment_t* head;
+  buffer_fragment_t* tail;
+  size_t total_length;
+  buffer_chain_free_cb free_cb;
+};
+
+buffer_chain_t* buffer_chain_new(buffer_chain_free_cb free_cb) {
+  buffer_chain_t* chain =
+      static_cast<buffer_chain_t*>(osi_calloc(sizeof(buffer_chain_t)));
+  chain->free_cb = free_cb;
+  return chain;
+}
+
+void buffer_chain_free(buffer_chain_t* chain) {
+  if (!chain) return;
+
+  for (buffer_fragment_t* fragment = chain->head; fragment;) {
+    buffer_fragment_t* next = fragment->next;
+    if (chain->free_cb) chain->free_cb(fragment->owner);
+    osi_free(fragment);
+    fragment = next;
+  }
+  osi_free(chain);
+}
+
+void buffer_chain_append(buffer_chain_t* chain, void* owner, const void* data,
+                         size_t length) {
+  CHECK(chain != NULL);
+  CHECK(data != NULL);
+  CHECK(length > 0);
+
+  buffer_fragment_t* fragment =
+      static_cast<buffer_fragment_t*>(osi_calloc(sizeof(buffer_fragment_t)));
+  fragment->owner = owner;
+  fragment->data = static_cast<const uint8_t*>(data);
+  fragment->length = length;
+
+  if (chain->tail)
+    chain->tail->next = fragment;
+  else
+    chain->head = fragment;
+  chain->tail = fragment;
+  chain->total_length += length;
+}
+
+size_t buffer_chain_length(const buffer_chain_t* chain) {
+  CHECK(chain != NULL);
+  return chain->total_length;
+}
+
+void buffer_chain_for_each(const buffer_chain_t* chain,
+                           buffer_chain_visit_cb visit_cb, void* context) {
+  CHECK(chain != NULL);
+  CHECK(visit_cb != NULL);
+
+  for (const buffer_fragment_t* fragment = chain->head; fragment;
+       fragment = fragment->next) {
+    if (!visit_cb(fragment->data, fragment->length, context)) return;
+  }
+}
+
+size_t buffer_chain_flatten(const buffer_chain_t* chain, void* dest,
+                            size_t max_length) {
+  CHECK(chain != NULL);
+  CHECK(dest != NULL);
+
+  uint8_t* out = static_cast<uint8_t*>(dest);
+  size_t copied = 0;
+  for (const buffer_fragment_t* fragment = chain->head;
+       fragment && copied < max_length; fragment = fragment->next) {
+    size_t to_copy = fragment->length;
+    if (to_copy > max_length - copied) to_copy = max_length - copied;
+    memcpy(out + copied, fragment->data, to_copy);
+    copied += to_copy;
+  }
+  return copied;
+}
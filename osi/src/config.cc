@@ -476,6 +476,196 @@ error2:
   return false;
 }
 
+// Binary snapshot format: |snapshot_header_t| followed by length-prefixed
+// section/key/value strings. The layout is private to this module; bump
+// |CONFIG_SNAPSHOT_VERSION| whenever it changes so older files fall back to
+// the text parser instead of being misread.
+static const uint32_t CONFIG_SNAPSHOT_MAGIC = 0x42544346;  // 'BTCF'
+static const uint32_t CONFIG_SNAPSHOT_VERSION = 1;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t tag;
+  uint32_t checksum;
+  uint32_t payload_size;
+} snapshot_header_t;
+
+// FNV-1a, cheap and dependency-free. This only needs to catch torn or
+// damaged snapshot files; the text config file remains the source of truth.
+static uint32_t snapshot_checksum(const uint8_t* data, size_t size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static void snapshot_append_u32(std::string* payload, uint32_t value) {
+  payload->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void snapshot_append_string(std::string* payload,
+                                   const std::string& str) {
+  snapshot_append_u32(payload, str.size());
+  payload->append(str);
+}
+
+static bool snapshot_read_u32(const std::string& payload, size_t* offset,
+                              uint32_t* out) {
+  if (payload.size() - *offset < sizeof(*out)) return false;
+  memcpy(out, payload.data() + *offset, sizeof(*out));
+  *offset += sizeof(*out);
+  return true;
+}
+
+static bool snapshot_read_string(const std::string& payload, size_t* offset,
+                                 std::string* out) {
+  uint32_t len;
+  if (!snapshot_read_u32(payload, offset, &len)) return false;
+  if (payload.size() - *offset < len) return false;
+  out->assign(payload, *offset, len);
+  *offset += len;
+  return true;
+}
+
+bool config_save_snapshot(const config_t& config, const std::string& filename,
+                          uint64_t tag) {
+  CHECK(!filename.empty());
+
+  std::string payload;
+  snapshot_append_u32(&payload, config.sections.size());
+  for (const section_t& section : config.sections) {
+    snapshot_append_string(&payload, section.name);
+    snapshot_append_u32(&payload, section.entries.size());
+    for (const entry_t& entry : section.entries) {
+      snapshot_append_string(&payload, entry.key);
+      snapshot_append_string(&payload, entry.value);
+    }
+  }
+
+  snapshot_header_t header = {
+      .magic = CONFIG_SNAPSHOT_MAGIC,
+      .version = CONFIG_SNAPSHOT_VERSION,
+      .tag = tag,
+      .checksum = snapshot_checksum(
+          reinterpret_cast<const uint8_t*>(payload.data()), payload.size()),
+      .payload_size = static_cast<uint32_t>(payload.size()),
+  };
+
+  std::string serialized(reinterpret_cast<const char*>(&header),
+                         sizeof(header));
+  serialized += payload;
+
+  // Write-then-rename keeps readers from seeing a half-written file. A torn
+  // write after a crash just fails the checksum on the next load, so the
+  // fsync dance |config_save| does for the text file is not needed here.
+  const std::string temp_filename = filename + ".new";
+  if (base::WriteFile(base::FilePath(temp_filename), serialized.data(),
+                      serialized.size()) != (int)serialized.size()) {
+    LOG(ERROR) << __func__ << ": unable to write file '" << temp_filename
+               << "': " << strerror(errno);
+    unlink(temp_filename.c_str());
+    return false;
+  }
+
+  if (chmod(temp_filename.c_str(), S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP) ==
+      -1) {
+    LOG(ERROR) << __func__ << ": unable to change file permissions '"
+               << temp_filename << "': " << strerror(errno);
+    unlink(temp_filename.c_str());
+    return false;
+  }
+
+  if (rename(temp_filename.c_str(), filename.c_str()) == -1) {
+    LOG(ERROR) << __func__ << ": unable to commit file '" << filename
+               << "': " << strerror(errno);
+    unlink(temp_filename.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+std::unique_ptr<config_t> config_load_snapshot(const char* filename,
+                                               uint64_t expected_tag) {
+  CHECK(filename != nullptr);
+
+  base::FilePath path(filename);
+  // Missing snapshot is the normal case on first boot; not worth a log line.
+  if (!base::PathExists(path)) return nullptr;
+
+  std::string serialized;
+  if (!base::ReadFileToString(path, &serialized)) {
+    LOG(ERROR) << __func__ << ": unable to read file '" << filename << "'";
+    return nullptr;
+  }
+
+  snapshot_header_t header;
+  if (serialized.size() < sizeof(header)) {
+    LOG(WARNING) << __func__ << ": snapshot too short, ignoring";
+    return nullptr;
+  }
+  memcpy(&header, serialized.data(), sizeof(header));
+
+  if (header.magic != CONFIG_SNAPSHOT_MAGIC ||
+      header.version != CONFIG_SNAPSHOT_VERSION) {
+    LOG(WARNING) << __func__ << ": unknown snapshot format, ignoring";
+    return nullptr;
+  }
+
+  if (header.tag != expected_tag) {
+    LOG(WARNING) << __func__
+                 << ": snapshot is stale, falling back to text parse";
+    return nullptr;
+  }
+
+  std::string payload = serialized.substr(sizeof(header));
+  if (payload.size() != header.payload_size ||
+      snapshot_checksum(reinterpret_cast<const uint8_t*>(payload.data()),
+                        payload.size()) != header.checksum) {
+    LOG(WARNING) << __func__ << ": snapshot failed checksum, ignoring";
+    return nullptr;
+  }
+
+  std::unique_ptr<config_t> config = config_new_empty();
+
+  // The snapshot was serialized from a well-formed config, so sections and
+  // keys are unique and in order; append directly instead of going through
+  // |config_set_string| and its linear lookups.
+  size_t offset = 0;
+  uint32_t section_count;
+  if (!snapshot_read_u32(payload, &offset, &section_count)) return nullptr;
+
+  for (uint32_t i = 0; i < section_count; ++i) {
+    std::string name;
+    uint32_t entry_count;
+    if (!snapshot_read_string(payload, &offset, &name) ||
+        !snapshot_read_u32(payload, &offset, &entry_count)) {
+      LOG(WARNING) << __func__ << ": truncated snapshot payload, ignoring";
+      return nullptr;
+    }
+
+    config->sections.emplace_back(section_t{.name = std::move(name)});
+    section_t& section = config->sections.back();
+
+    for (uint32_t j = 0; j < entry_count; ++j) {
+      std::string key;
+      std::string value;
+      if (!snapshot_read_string(payload, &offset, &key) ||
+          !snapshot_read_string(payload, &offset, &value)) {
+        LOG(WARNING) << __func__ << ": truncated snapshot payload, ignoring";
+        return nullptr;
+      }
+      section.entries.emplace_back(
+          entry_t{.key = std::move(key), .value = std::move(value)});
+    }
+  }
+
+  return config;
+}
+
 static char* trim(char* str) {
   while (isspace(*str)) ++str;
 
@@ -0,0 +1,221 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "osi/include/fixed_queue_mpsc.h"
+
+#include <base/logging.h>
+
+#include <atomic>
+
+#include "osi/include/allocator.h"
+#include "osi/include/pool_allocator.h"
+#include "osi/include/reactor.h"
+#include "osi/include/semaphore.h"
+
+// Intrusive node for the Vyukov-style MPSC list. Nodes come from the pool
+// allocator so steady-state enqueue/dequeue do not touch the heap.
+typedef struct mpsc_node_t {
+  std::atomic<struct mpsc_node_t*> next;
+  void* data;
+} mpsc_node_t;
+
+typedef struct fixed_queue_mpsc_t {
+  // Producers swing |tail| with an atomic exchange; only the consumer
+  // follows |head|. |head| always points at a consumed stub node.
+  std::atomic<mpsc_node_t*> tail;
+  mpsc_node_t* head;
+  std::atomic<size_t> length;
+  size_t capacity;
+
+  // The semaphore provides the blocking dequeue and the reactor fd; it is
+  // only touched after the lock-free list operation completes.
+  semaphore_t* dequeue_sem;
+
+  reactor_object_t* dequeue_object;
+  fixed_queue_mpsc_cb dequeue_ready;
+  void* dequeue_context;
+} fixed_queue_mpsc_t;
+
+static void internal_dequeue_ready(void* context);
+
+static mpsc_node_t* node_new(void* data) {
+  mpsc_node_t* node =
+      static_cast<mpsc_node_t*>(allocator_pool.alloc(sizeof(mpsc_node_t)));
+  CHECK(node);
+  node->next.store(NULL, std::memory_order_relaxed);
+  node->data = data;
+  return node;
+}
+
+static void node_free(mpsc_node_t* node) { allocator_pool.free(node); }
+
+// Links |node| at the tail. This is the only operation producers perform
+// and it is wait-free apart from the single atomic exchange.
+static void push_node(fixed_queue_mpsc_t* queue, mpsc_node_t* node) {
+  mpsc_node_t* prev =
+      queue->tail.exchange(node, std::memory_order_acq_rel);
+  prev->next.store(node, std::memory_order_release);
+}
+
+// Unlinks the node after |head|, if visible. Consumer-only.
+static mpsc_node_t* pop_node(fixed_queue_mpsc_t* queue) {
+  mpsc_node_t* stub = queue->head;
+  mpsc_node_t* next = stub->next.load(std::memory_order_acquire);
+  if (!next) return NULL;
+
+  queue->head = next;
+  // |next| becomes the new stub; its payload moves out with the old stub.
+  stub->data = next->data;
+  return stub;
+}
+
+fixed_queue_mpsc_t* fixed_queue_mpsc_new(size_t capacity) {
+  fixed_queue_mpsc_t* ret = static_cast<fixed_queue_mpsc_t*>(
+      osi_calloc(sizeof(fixed_queue_mpsc_t)));
+
+  mpsc_node_t* stub = node_new(NULL);
+  ret->tail.store(stub, std::memory_order_relaxed);
+  ret->head = stub;
+  ret->length.store(0, std::memory_order_relaxed);
+  ret->capacity = capacity;
+
+  ret->dequeue_sem = semaphore_new(0);
+  if (!ret->dequeue_sem) {
+    node_free(stub);
+    osi_free(ret);
+    return NULL;
+  }
+
+  return ret;
+}
+
+void fixed_queue_mpsc_free(fixed_queue_mpsc_t* queue,
+                           fixed_queue_mpsc_free_cb free_cb) {
+  if (!queue) return;
+
+  fixed_queue_mpsc_unregister_dequeue(queue);
+
+  for (;;) {
+    void* data = fixed_queue_mpsc_try_dequeue(queue);
+    if (!data) break;
+    if (free_cb) free_cb(data);
+  }
+
+  node_free(queue->head);
+  semaphore_free(queue->dequeue_sem);
+  osi_free(queue);
+}
+
+size_t fixed_queue_mpsc_length(fixed_queue_mpsc_t* queue) {
+  if (queue == NULL) return 0;
+  return queue->length.load(std::memory_order_relaxed);
+}
+
+void fixed_queue_mpsc_enqueue(fixed_queue_mpsc_t* queue, void* data) {
+  CHECK(queue != NULL);
+  CHECK(data != NULL);
+
+  push_node(queue, node_new(data));
+  queue->length.fetch_add(1, std::memory_order_relaxed);
+  semaphore_post(queue->dequeue_sem);
+}
+
+bool fixed_queue_mpsc_try_enqueue(fixed_queue_mpsc_t* queue, void* data) {
+  CHECK(queue != NULL);
+  CHECK(data != NULL);
+
+  // The capacity check is advisory: concurrent producers may briefly
+  // overshoot by the number of racing threads, which is acceptable for a
+  // drop-on-overload policy.
+  if (queue->length.load(std::memory_order_relaxed) >= queue->capacity)
+    return false;
+
+  fixed_queue_mpsc_enqueue(queue, data);
+  return true;
+}
+
+void* fixed_queue_mpsc_dequeue(fixed_queue_mpsc_t* queue) {
+  CHECK(queue != NULL);
+
+  semaphore_wait(queue->dequeue_sem);
+
+  mpsc_node_t* node;
+  // A producer has posted the semaphore but may not have published the
+  // node's |next| link yet; spin on the sub-microsecond window.
+  while ((node = pop_node(queue)) == NULL)
+    ;
+
+  void* ret = node->data;
+  node_free(node);
+  queue->length.fetch_sub(1, std::memory_order_relaxed);
+  return ret;
+}
+
+void* fixed_queue_mpsc_try_dequeue(fixed_queue_mpsc_t* queue) {
+  if (queue == NULL) return NULL;
+
+  if (!semaphore_try_wait(queue->dequeue_sem)) return NULL;
+
+  mpsc_node_t* node;
+  while ((node = pop_node(queue)) == NULL)
+    ;
+
+  void* ret = node->data;
+  node_free(node);
+  queue->length.fetch_sub(1, std::memory_order_relaxed);
+  return ret;
+}
+
+int fixed_queue_mpsc_get_dequeue_fd(const fixed_queue_mpsc_t* queue) {
+  CHECK(queue != NULL);
+  return semaphore_get_fd(queue->dequeue_sem);
+}
+
+void fixed_queue_mpsc_register_dequeue(fixed_queue_mpsc_t* queue,
+                                       reactor_t* reactor,
+                                       fixed_queue_mpsc_cb ready_cb,
+                                       void* context) {
+  CHECK(queue != NULL);
+  CHECK(reactor != NULL);
+  CHECK(ready_cb != NULL);
+
+  // Make sure we're not already registered
+  fixed_queue_mpsc_unregister_dequeue(queue);
+
+  queue->dequeue_ready = ready_cb;
+  queue->dequeue_context = context;
+  queue->dequeue_object =
+      reactor_register(reactor, fixed_queue_mpsc_get_dequeue_fd(queue), queue,
+                       internal_dequeue_ready, NULL);
+}
+
+void fixed_queue_mpsc_unregister_dequeue(fixed_queue_mpsc_t* queue) {
+  CHECK(queue != NULL);
+
+  if (queue->dequeue_object) {
+    reactor_unregister(queue->dequeue_object);
+    queue->dequeue_object = NULL;
+  }
+}
+
+static void internal_dequeue_ready(void* context) {
+  CHECK(context != NULL);
+
+  fixed_queue_mpsc_t* queue = static_cast<fixed_queue_mpsc_t*>(context);
+  queue->dequeue_ready(queue, queue->dequeue_context);
+}
@@ -0,0 +1,165 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "osi/include/pool_allocator.h"
+
+#include <base/logging.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <unordered_set>
+
+#include "osi/include/allocator.h"
+
+// Size classes cover a BT_HDR plus the common ACL/L2CAP payload sizes seen
+// on the data path (BR/EDR 3-DH5, default LE data length, typical A2DP MTU).
+// Each class keeps a bounded freelist so a burst does not pin memory forever.
+static const size_t kClassSizes[] = {64, 384, 1120, 1824};
+static const size_t kNumClasses = sizeof(kClassSizes) / sizeof(kClassSizes[0]);
+static const size_t kMaxFreeBlocksPerClass = 64;
+
+static const uint32_t kPoolBlockMagic = 0x6f736950;  // "osiP"
+
+typedef struct pool_block_t {
+  union {
+    struct {
+      uint32_t magic;  // Corruption/double-free canary on pool-owned blocks.
+      uint32_t class_index;
+    };
+    struct pool_block_t* next;  // Valid only while on a freelist.
+    // Padding keeps user payloads at max_align even on 32-bit targets.
+    max_align_t align;
+  };
+} pool_block_t;
+
+typedef struct {
+  pool_block_t* free_list;
+  size_t free_count;
+  size_t allocated;      // Blocks currently handed out.
+  size_t peak;           // High water mark of |allocated|.
+  size_t total_allocs;   // Lifetime allocation count.
+  size_t freelist_hits;  // Allocations served without touching the heap.
+} pool_class_t;
+
+static std::mutex pool_mutex;
+static pool_class_t pools[kNumClasses];
+static size_t oversize_misses;  // Requests too large for every class.
+// Payload pointers currently handed out. Free routing checks this table
+// instead of reading a header in front of the pointer, which would be an
+// out-of-bounds read when handed a buffer some other allocator produced.
+static std::unordered_set<void*> live_blocks;
+
+static size_t class_for_size(size_t size) {
+  for (size_t i = 0; i < kNumClasses; ++i) {
+    if (size <= kClassSizes[i]) return i;
+  }
+  return kNumClasses;
+}
+
+void* pool_allocator_alloc(size_t size) {
+  size_t index = class_for_size(size);
+  if (index == kNumClasses) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    ++oversize_misses;
+    return NULL;
+  }
+
+  pool_block_t* block = NULL;
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    pool_class_t* pool = &pools[index];
+    block = pool->free_list;
+    if (block) {
+      pool->free_list = block->next;
+      --pool->free_count;
+      ++pool->freelist_hits;
+      live_blocks.insert(block + 1);
+    }
+    ++pool->total_allocs;
+    ++pool->allocated;
+    if (pool->allocated > pool->peak) pool->peak = pool->allocated;
+  }
+
+  if (!block) {
+    block = static_cast<pool_block_t*>(
+        malloc(sizeof(pool_block_t) + kClassSizes[index]));
+    CHECK(block);
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    live_blocks.insert(block + 1);
+  }
+
+  block->magic = kPoolBlockMagic;
+  block->class_index = index;
+  return block + 1;
+}
+
+bool pool_allocator_free(void* ptr) {
+  if (!ptr) return false;
+
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  if (live_blocks.erase(ptr) == 0) return false;
+
+  // The pointer is pool-owned, so the header in front of it is ours to read.
+  pool_block_t* block = static_cast<pool_block_t*>(ptr) - 1;
+  CHECK(block->magic == kPoolBlockMagic);
+  CHECK(block->class_index < kNumClasses);
+
+  size_t index = block->class_index;
+  block->magic = 0;
+
+  pool_class_t* pool = &pools[index];
+  CHECK(pool->allocated > 0);
+  --pool->allocated;
+  if (pool->free_count >= kMaxFreeBlocksPerClass) {
+    free(block);
+    return true;
+  }
+  block->next = pool->free_list;
+  pool->free_list = block;
+  ++pool->free_count;
+  return true;
+}
+
+static void* pool_or_heap_alloc(size_t size) {
+  void* ptr = pool_allocator_alloc(size);
+  return ptr ? ptr : osi_malloc(size);
+}
+
+static void pool_or_heap_free(void* ptr) {
+  if (!pool_allocator_free(ptr)) osi_free(ptr);
+}
+
+const allocator_t allocator_pool = {pool_or_heap_alloc, pool_or_heap_free};
+
+void pool_allocator_debug_dump(int fd) {
+  dprintf(fd, "\nBluetooth pool allocator state:\n");
+
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  for (size_t i = 0; i < kNumClasses; ++i) {
+    const pool_class_t* pool = &pools[i];
+    dprintf(fd,
+            "  Class %zu bytes: in use %zu (peak %zu), cached %zu, "
+            "allocations %zu (freelist hits %zu)\n",
+            kClassSizes[i], pool->allocated, pool->peak, pool->free_count,
+            pool->total_allocs, pool->freelist_hits);
+  }
+  dprintf(fd, "  Oversize requests passed to heap: %zu\n", oversize_misses);
+}
@@ -0,0 +1,182 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_osi_reactor_alarm"
+
+#include "osi/include/reactor_alarm.h"
+
+#include <base/logging.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <memory>
+#include <mutex>
+
+#include "osi/include/allocator.h"
+#include "osi/include/log.h"
+#include "osi/include/reactor.h"
+#include "osi/include/thread.h"
+
+struct reactor_alarm_t {
+  int fd;
+  reactor_object_t* reactor_object;
+  const char* name;
+
+  // Serializes set/cancel against the callback and is held while the
+  // callback runs, so |reactor_alarm_cancel| blocks until an in-flight
+  // callback has returned. Recursive so the callback may re-arm or cancel
+  // its own alarm. A shared reference is taken before the callback runs,
+  // mirroring |alarm_t|, so a concurrent free cannot pull the mutex out
+  // from under it.
+  std::shared_ptr<std::recursive_mutex> callback_mutex;
+  reactor_alarm_callback_t callback;
+  void* data;
+  bool is_periodic;
+  bool is_scheduled;
+};
+
+// Runs on the alarm's reactor thread when the timerfd expires.
+static void timerfd_ready(void* context) {
+  reactor_alarm_t* alarm = static_cast<reactor_alarm_t*>(context);
+
+  // Drain the expiration count; missed periodic expirations coalesce here.
+  uint64_t expirations;
+  if (read(alarm->fd, &expirations, sizeof(expirations)) == -1) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK)
+      LOG_ERROR(LOG_TAG, "%s unable to read timerfd for alarm \"%s\": %s",
+                __func__, alarm->name, strerror(errno));
+    return;
+  }
+
+  std::shared_ptr<std::recursive_mutex> local_mutex_ref =
+      alarm->callback_mutex;
+  std::lock_guard<std::recursive_mutex> lock(*local_mutex_ref);
+
+  // A cancel may have raced the wakeup; the callback must not run then.
+  if (!alarm->is_scheduled || !alarm->callback) return;
+
+  if (!alarm->is_periodic) alarm->is_scheduled = false;
+
+  alarm->callback(alarm->data);
+}
+
+static void reactor_alarm_schedule(reactor_alarm_t* alarm,
+                                   uint64_t interval_ms, uint64_t period_ms,
+                                   reactor_alarm_callback_t cb, void* data) {
+  CHECK(alarm != NULL);
+  CHECK(cb != NULL);
+
+  std::lock_guard<std::recursive_mutex> lock(*alarm->callback_mutex);
+
+  struct itimerspec spec;
+  memset(&spec, 0, sizeof(spec));
+  spec.it_value.tv_sec = interval_ms / 1000;
+  spec.it_value.tv_nsec = (interval_ms % 1000) * 1000000ULL;
+  spec.it_interval.tv_sec = period_ms / 1000;
+  spec.it_interval.tv_nsec = (period_ms % 1000) * 1000000ULL;
+
+  if (timerfd_settime(alarm->fd, 0, &spec, NULL) == -1) {
+    LOG_ERROR(LOG_TAG, "%s unable to arm alarm \"%s\": %s", __func__,
+              alarm->name, strerror(errno));
+    return;
+  }
+
+  alarm->callback = cb;
+  alarm->data = data;
+  alarm->is_periodic = (period_ms != 0);
+  alarm->is_scheduled = true;
+}
+
+reactor_alarm_t* reactor_alarm_new(const char* name, thread_t* thread) {
+  CHECK(name != NULL);
+  CHECK(thread != NULL);
+
+  reactor_alarm_t* alarm =
+      static_cast<reactor_alarm_t*>(osi_calloc(sizeof(reactor_alarm_t)));
+
+  alarm->fd = timerfd_create(CLOCK_BOOTTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (alarm->fd == -1) {
+    LOG_ERROR(LOG_TAG, "%s unable to create timerfd for alarm \"%s\": %s",
+              __func__, name, strerror(errno));
+    osi_free(alarm);
+    return NULL;
+  }
+
+  alarm->reactor_object = reactor_register(thread_get_reactor(thread),
+                                           alarm->fd, alarm, timerfd_ready,
+                                           NULL);
+  if (!alarm->reactor_object) {
+    LOG_ERROR(LOG_TAG, "%s unable to register timerfd for alarm \"%s\"",
+              __func__, name);
+    close(alarm->fd);
+    osi_free(alarm);
+    return NULL;
+  }
+
+  alarm->name = osi_strdup(name);
+  alarm->callback_mutex = std::make_shared<std::recursive_mutex>();
+  return alarm;
+}
+
+void reactor_alarm_free(reactor_alarm_t* alarm) {
+  if (!alarm) return;
+
+  reactor_alarm_cancel(alarm);
+  reactor_unregister(alarm->reactor_object);
+  close(alarm->fd);
+  alarm->callback_mutex.reset();
+  osi_free((void*)alarm->name);
+  osi_free(alarm);
+}
+
+void reactor_alarm_set(reactor_alarm_t* alarm, uint64_t interval_ms,
+                       reactor_alarm_callback_t cb, void* data) {
+  reactor_alarm_schedule(alarm, interval_ms, 0, cb, data);
+}
+
+void reactor_alarm_set_periodic(reactor_alarm_t* alarm, uint64_t period_ms,
+                                reactor_alarm_callback_t cb, void* data) {
+  reactor_alarm_schedule(alarm, period_ms, period_ms, cb, data);
+}
+
+void reactor_alarm_cancel(reactor_alarm_t* alarm) {
+  CHECK(alarm != NULL);
+
+  std::shared_ptr<std::recursive_mutex> local_mutex_ref =
+      alarm->callback_mutex;
+  std::lock_guard<std::recursive_mutex> lock(*local_mutex_ref);
+
+  struct itimerspec spec;
+  memset(&spec, 0, sizeof(spec));
+  if (timerfd_settime(alarm->fd, 0, &spec, NULL) == -1)
+    LOG_ERROR(LOG_TAG, "%s unable to disarm alarm \"%s\": %s", __func__,
+              alarm->name, strerror(errno));
+
+  alarm->is_scheduled = false;
+  alarm->callback = NULL;
+  alarm->data = NULL;
+}
+
+bool reactor_alarm_is_scheduled(const reactor_alarm_t* alarm) {
+  if (!alarm) return false;
+
+  std::lock_guard<std::recursive_mutex> lock(*alarm->callback_mutex);
+  return alarm->is_scheduled;
+}
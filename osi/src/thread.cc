@@ -23,13 +23,16 @@
 #include <atomic>
 
 #include <base/logging.h>
+#include <dlfcn.h>
 #include <errno.h>
 #include <malloc.h>
 #include <pthread.h>
+#include <stdio.h>
 #include <string.h>
 #include <sys/prctl.h>
 #include <sys/resource.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "osi/include/allocator.h"
@@ -39,6 +42,19 @@
 #include "osi/include/reactor.h"
 #include "osi/include/semaphore.h"
 
+// CPU attribution table entry, keyed by the posted work function. Updated
+// only by the owning thread while it dispatches; counters are halved every
+// THREAD_CPU_DECAY_RUNS dispatches so recent consumers dominate the dump
+// and cold sites decay back to free slots.
+#define THREAD_CPU_SITE_SLOTS 16
+#define THREAD_CPU_DECAY_RUNS 8192
+
+typedef struct {
+  thread_fn func;
+  uint64_t cpu_us;
+  uint64_t runs;
+} thread_cpu_site_t;
+
 struct thread_t {
   std::atomic_bool is_joined{false};
   pthread_t pthread;
@@ -46,8 +62,20 @@ struct thread_t {
   char name[THREAD_NAME_MAX + 1];
   reactor_t* reactor;
   fixed_queue_t* work_queue;
+
+  thread_cpu_site_t cpu_sites[THREAD_CPU_SITE_SLOTS];
+  uint64_t cpu_total_us;
+  uint64_t cpu_untracked_us;
+  uint64_t cpu_runs_since_decay;
 };
 
+// Live threads, so thread_dump_all_cpu_stats can walk them. The lock only
+// guards membership: a thread is registered after creation succeeds and
+// removed at the top of thread_free, before its memory goes away.
+#define THREAD_REGISTRY_MAX 32
+static pthread_mutex_t thread_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static thread_t* thread_registry[THREAD_REGISTRY_MAX];
+
 struct start_arg {
   thread_t* thread;
   semaphore_t* start_sem;
@@ -90,6 +118,15 @@ thread_t* thread_new_sized(const char* name, size_t work_queue_capacity) {
 
   if (start.error) goto error;
 
+  pthread_mutex_lock(&thread_registry_lock);
+  for (size_t i = 0; i < THREAD_REGISTRY_MAX; i++) {
+    if (thread_registry[i] == NULL) {
+      thread_registry[i] = ret;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&thread_registry_lock);
+
   return ret;
 
 error:;
@@ -108,6 +145,15 @@ thread_t* thread_new(const char* name) {
 void thread_free(thread_t* thread) {
   if (!thread) return;
 
+  pthread_mutex_lock(&thread_registry_lock);
+  for (size_t i = 0; i < THREAD_REGISTRY_MAX; i++) {
+    if (thread_registry[i] == thread) {
+      thread_registry[i] = NULL;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&thread_registry_lock);
+
   thread_stop(thread);
   thread_join(thread);
 
@@ -211,7 +257,7 @@ static void* run_thread(void* start_arg) {
   semaphore_post(start->start_sem);
 
   int fd = fixed_queue_get_dequeue_fd(thread->work_queue);
-  void* context = thread->work_queue;
+  void* context = thread;
 
   reactor_object_t* work_queue_object =
       reactor_register(thread->reactor, fd, context, work_queue_read_cb, NULL);
@@ -240,11 +286,93 @@ static void* run_thread(void* start_arg) {
   return NULL;
 }
 
+static uint64_t thread_cputime_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+// Charges |cpu_us| to |func| in |thread|'s attribution table. Runs on the
+// owning thread only; sites that arrive while the table is full land in
+// the untracked bucket until decay frees a slot.
+static void thread_record_cpu(thread_t* thread, thread_fn func,
+                              uint64_t cpu_us) {
+  thread->cpu_total_us += cpu_us;
+  if (++thread->cpu_runs_since_decay >= THREAD_CPU_DECAY_RUNS) {
+    thread->cpu_runs_since_decay = 0;
+    for (size_t i = 0; i < THREAD_CPU_SITE_SLOTS; i++) {
+      thread->cpu_sites[i].cpu_us /= 2;
+      thread->cpu_sites[i].runs /= 2;
+      if (thread->cpu_sites[i].cpu_us == 0) thread->cpu_sites[i].func = NULL;
+    }
+    thread->cpu_total_us /= 2;
+    thread->cpu_untracked_us /= 2;
+  }
+
+  thread_cpu_site_t* free_slot = NULL;
+  for (size_t i = 0; i < THREAD_CPU_SITE_SLOTS; i++) {
+    thread_cpu_site_t* site = &thread->cpu_sites[i];
+    if (site->func == func) {
+      site->cpu_us += cpu_us;
+      site->runs++;
+      return;
+    }
+    if (site->func == NULL && !free_slot) free_slot = site;
+  }
+  if (free_slot) {
+    free_slot->func = func;
+    free_slot->cpu_us = cpu_us;
+    free_slot->runs = 1;
+    return;
+  }
+  thread->cpu_untracked_us += cpu_us;
+}
+
+void thread_dump_all_cpu_stats(int fd) {
+  dprintf(fd, "\nosi thread CPU attribution (decayed, by work function):\n");
+  pthread_mutex_lock(&thread_registry_lock);
+  for (size_t i = 0; i < THREAD_REGISTRY_MAX; i++) {
+    thread_t* thread = thread_registry[i];
+    if (!thread || thread->cpu_total_us == 0) continue;
+
+    dprintf(fd, "  %s: total %llu ms\n", thread->name,
+            (unsigned long long)(thread->cpu_total_us / 1000));
+    for (size_t j = 0; j < THREAD_CPU_SITE_SLOTS; j++) {
+      const thread_cpu_site_t* site = &thread->cpu_sites[j];
+      if (site->func == NULL || site->cpu_us == 0) continue;
+
+      Dl_info info;
+      const char* sym = NULL;
+      if (dladdr((void*)site->func, &info) && info.dli_sname)
+        sym = info.dli_sname;
+      if (sym)
+        dprintf(fd, "    %5.1f%% %9llu us %7llu runs  %s\n",
+                100.0 * (double)site->cpu_us / (double)thread->cpu_total_us,
+                (unsigned long long)site->cpu_us,
+                (unsigned long long)site->runs, sym);
+      else
+        dprintf(fd, "    %5.1f%% %9llu us %7llu runs  %p\n",
+                100.0 * (double)site->cpu_us / (double)thread->cpu_total_us,
+                (unsigned long long)site->cpu_us,
+                (unsigned long long)site->runs, (void*)site->func);
+    }
+    if (thread->cpu_untracked_us != 0)
+      dprintf(fd, "    %5.1f%% %9llu us untracked (site table full)\n",
+              100.0 * (double)thread->cpu_untracked_us /
+                  (double)thread->cpu_total_us,
+              (unsigned long long)thread->cpu_untracked_us);
+  }
+  pthread_mutex_unlock(&thread_registry_lock);
+}
+
 static void work_queue_read_cb(void* context) {
   CHECK(context != NULL);
 
-  fixed_queue_t* queue = (fixed_queue_t*)context;
-  work_item_t* item = static_cast<work_item_t*>(fixed_queue_dequeue(queue));
+  thread_t* thread = (thread_t*)context;
+  work_item_t* item =
+      static_cast<work_item_t*>(fixed_queue_dequeue(thread->work_queue));
+  uint64_t cpu_start_us = thread_cputime_us();
   item->func(item->context);
+  thread_record_cpu(thread, item->func, thread_cputime_us() - cpu_start_us);
   osi_free(item);
 }
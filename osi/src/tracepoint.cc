@@ -0,0 +1,96 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "osi/include/tracepoint.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <atomic>
+
+typedef struct {
+  uint64_t timestamp_ns;
+  uint32_t id;
+  uint32_t arg1;
+  uint32_t arg2;
+} tracepoint_entry_t;
+
+// Must be a power of two so the write index can wrap with a mask.
+static const size_t TRACEPOINT_RING_SIZE = 4096;
+
+static tracepoint_entry_t tracepoint_ring[TRACEPOINT_RING_SIZE];
+static std::atomic<uint64_t> tracepoint_write_count{0};
+
+static const char* tracepoint_id_name(uint32_t id) {
+  switch (id) {
+    case TRACE_HCI_TX:
+      return "HCI_TX";
+    case TRACE_HCI_EVT_RX:
+      return "HCI_EVT_RX";
+    case TRACE_HCI_ACL_RX:
+      return "HCI_ACL_RX";
+    case TRACE_L2C_RX:
+      return "L2C_RX";
+    case TRACE_BTU_HCIF_EVT:
+      return "BTU_HCIF_EVT";
+    case TRACE_A2DP_ENCODE_TICK:
+      return "A2DP_ENCODE_TICK";
+    case TRACE_GATT_OP_ENQUEUE:
+      return "GATT_OP_ENQUEUE";
+    case TRACE_GATT_OP_COMPLETE:
+      return "GATT_OP_COMPLETE";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+void tracepoint_record(tracepoint_id_t id, uint32_t arg1, uint32_t arg2) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  const uint64_t index =
+      tracepoint_write_count.fetch_add(1, std::memory_order_relaxed);
+  tracepoint_entry_t* entry =
+      &tracepoint_ring[index & (TRACEPOINT_RING_SIZE - 1)];
+  entry->timestamp_ns = (ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+  entry->id = id;
+  entry->arg1 = arg1;
+  entry->arg2 = arg2;
+}
+
+void tracepoint_reset(void) {
+  tracepoint_write_count.store(0, std::memory_order_relaxed);
+}
+
+void tracepoint_debug_dump(int fd) {
+  // Snapshot the write count; entries written while we dump may tear, which
+  // is acceptable for a best-effort debug ring.
+  const uint64_t total = tracepoint_write_count.load(std::memory_order_relaxed);
+  const uint64_t start =
+      (total > TRACEPOINT_RING_SIZE) ? total - TRACEPOINT_RING_SIZE : 0;
+
+  dprintf(fd, "\nBluetooth Tracepoints (%" PRIu64 " of %" PRIu64 " events):\n",
+          total - start, total);
+  for (uint64_t i = start; i < total; i++) {
+    const tracepoint_entry_t* entry =
+        &tracepoint_ring[i & (TRACEPOINT_RING_SIZE - 1)];
+    dprintf(fd, "  %" PRIu64 " %-16s 0x%08x 0x%08x\n", entry->timestamp_ns,
+            tracepoint_id_name(entry->id), entry->arg1, entry->arg2);
+  }
+}
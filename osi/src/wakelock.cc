@@ -58,6 +58,27 @@ static pthread_once_t initialized = PTHREAD_ONCE_INIT;
 static int wake_lock_fd = INVALID_FD;
 static int wake_unlock_fd = INVALID_FD;
 
+// How long the underlying lock is kept after the last wakelock_release().
+// Steady-state timer traffic re-acquires well inside this window, so the
+// sysfs write (or OS callout) pair is paid only once per burst. Zero makes
+// releases synchronous again.
+static const uint64_t DEFAULT_RELEASE_HYSTERESIS_MS = 50;
+static uint64_t release_hysteresis_ms = DEFAULT_RELEASE_HYSTERESIS_MS;
+
+// Debounced wakelock manager state, all guarded by |monitor_mutex|. The
+// logical lock is refcounted; the physical lock is written only on the
+// rising edge and - after the hysteresis delay elapsed on the debounce
+// thread - on the falling edge.
+static pthread_mutex_t monitor_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t monitor_cond;
+static size_t wakelock_ref_count = 0;
+static bool wakelock_physically_held = false;
+static bool release_pending = false;
+static struct timespec release_deadline_ts;
+static pthread_t debounce_thread;
+static bool debounce_thread_created = false;
+static bool debounce_thread_running = false;
+
 // Wakelock statistics for the "bluetooth_timer"
 typedef struct {
   bool is_acquired;
@@ -65,6 +86,9 @@ typedef struct {
   size_t released_count;
   size_t acquired_errors;
   size_t released_errors;
+  size_t debounced_acquires;
+  size_t deferred_releases;
+  size_t deferred_release_cancels;
   uint64_t min_acquired_interval_ms;
   uint64_t max_acquired_interval_ms;
   uint64_t last_acquired_interval_ms;
@@ -86,6 +110,9 @@ static bt_status_t wakelock_acquire_callout(void);
 static bt_status_t wakelock_acquire_native(void);
 static bt_status_t wakelock_release_callout(void);
 static bt_status_t wakelock_release_native(void);
+static bt_status_t wakelock_acquire_physical(void);
+static bt_status_t wakelock_release_physical(void);
+static void* debounce_thread_fn(void* context);
 static void wakelock_initialize(void);
 static void wakelock_initialize_native(void);
 static void reset_wakelock_stats(void);
@@ -101,21 +128,47 @@ void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
 bool wakelock_acquire(void) {
   pthread_once(&initialized, wakelock_initialize);
 
-  bt_status_t status = BT_STATUS_FAIL;
+  pthread_mutex_lock(&monitor_mutex);
+
+  wakelock_ref_count++;
 
-  if (is_native)
-    status = wakelock_acquire_native();
-  else
-    status = wakelock_acquire_callout();
+  // A pending deferred release is cancelled by any new acquire: the burst
+  // is still going, so keep holding the physical lock.
+  if (release_pending) {
+    release_pending = false;
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    wakelock_stats.deferred_release_cancels++;
+  }
 
+  if (wakelock_physically_held) {
+    // Steady state: the lock is already held, no syscall needed.
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      wakelock_stats.debounced_acquires++;
+    }
+    pthread_mutex_unlock(&monitor_mutex);
+    return true;
+  }
+
+  // Rising edge: the physical acquire must happen before we return, or the
+  // device could suspend underneath the caller.
+  const bt_status_t status = wakelock_acquire_physical();
+  if (status == BT_STATUS_SUCCESS) wakelock_physically_held = true;
   update_wakelock_acquired_stats(status);
 
+  pthread_mutex_unlock(&monitor_mutex);
+
   if (status != BT_STATUS_SUCCESS)
     LOG_ERROR("%s unable to acquire wake lock: %d", __func__, status);
 
   return (status == BT_STATUS_SUCCESS);
 }
 
+static bt_status_t wakelock_acquire_physical(void) {
+  if (is_native) return wakelock_acquire_native();
+  return wakelock_acquire_callout();
+}
+
 static bt_status_t wakelock_acquire_callout(void) {
   return static_cast<bt_status_t>(
       wakelock_os_callouts->acquire_wake_lock(WAKE_LOCK_ID));
@@ -147,18 +200,83 @@ static bt_status_t wakelock_acquire_native(void) {
 bool wakelock_release(void) {
   pthread_once(&initialized, wakelock_initialize);
 
-  bt_status_t status = BT_STATUS_FAIL;
+  pthread_mutex_lock(&monitor_mutex);
+
+  if (wakelock_ref_count == 0) {
+    LOG_WARN("%s release without matching acquire", __func__);
+    pthread_mutex_unlock(&monitor_mutex);
+    return false;
+  }
+
+  wakelock_ref_count--;
 
-  if (is_native)
-    status = wakelock_release_native();
-  else
-    status = wakelock_release_callout();
+  if (wakelock_ref_count > 0 || !wakelock_physically_held) {
+    pthread_mutex_unlock(&monitor_mutex);
+    return true;
+  }
+
+  // Last reference gone. With a hysteresis window configured, hand the
+  // physical release to the debounce thread so a re-acquire inside the
+  // window costs nothing.
+  if (release_hysteresis_ms > 0 && debounce_thread_running) {
+    clock_gettime(CLOCK_MONOTONIC, &release_deadline_ts);
+    release_deadline_ts.tv_sec += release_hysteresis_ms / 1000;
+    release_deadline_ts.tv_nsec += (release_hysteresis_ms % 1000) * 1000000LL;
+    if (release_deadline_ts.tv_nsec >= 1000000000LL) {
+      release_deadline_ts.tv_sec++;
+      release_deadline_ts.tv_nsec -= 1000000000LL;
+    }
+    release_pending = true;
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      wakelock_stats.deferred_releases++;
+    }
+    pthread_cond_signal(&monitor_cond);
+    pthread_mutex_unlock(&monitor_mutex);
+    return true;
+  }
 
+  const bt_status_t status = wakelock_release_physical();
+  wakelock_physically_held = false;
   update_wakelock_released_stats(status);
 
+  pthread_mutex_unlock(&monitor_mutex);
+
   return (status == BT_STATUS_SUCCESS);
 }
 
+static bt_status_t wakelock_release_physical(void) {
+  if (is_native) return wakelock_release_native();
+  return wakelock_release_callout();
+}
+
+// Waits out the hysteresis window on a dedicated thread and performs the
+// deferred physical release, unless a new acquire cancelled it first.
+static void* debounce_thread_fn(UNUSED_ATTR void* context) {
+  pthread_mutex_lock(&monitor_mutex);
+  while (debounce_thread_running) {
+    if (!release_pending) {
+      pthread_cond_wait(&monitor_cond, &monitor_mutex);
+      continue;
+    }
+
+    const int ret =
+        pthread_cond_timedwait(&monitor_cond, &monitor_mutex,
+                               &release_deadline_ts);
+    if (!debounce_thread_running) break;
+    if (!release_pending || ret != ETIMEDOUT) continue;
+
+    release_pending = false;
+    if (wakelock_ref_count == 0 && wakelock_physically_held) {
+      const bt_status_t status = wakelock_release_physical();
+      wakelock_physically_held = false;
+      update_wakelock_released_stats(status);
+    }
+  }
+  pthread_mutex_unlock(&monitor_mutex);
+  return NULL;
+}
+
 static bt_status_t wakelock_release_callout(void) {
   return static_cast<bt_status_t>(
       wakelock_os_callouts->release_wake_lock(WAKE_LOCK_ID));
@@ -184,6 +302,23 @@ static void wakelock_initialize(void) {
   reset_wakelock_stats();
 
   if (is_native) wakelock_initialize_native();
+
+  pthread_condattr_t condattr;
+  pthread_condattr_init(&condattr);
+  pthread_condattr_setclock(&condattr, CLOCK_MONOTONIC);
+  pthread_cond_init(&monitor_cond, &condattr);
+  pthread_condattr_destroy(&condattr);
+
+  debounce_thread_running = true;
+  if (pthread_create(&debounce_thread, NULL, debounce_thread_fn, NULL) == 0) {
+    debounce_thread_created = true;
+  } else {
+    // Without the thread all releases fall back to the synchronous path.
+    LOG_ERROR("%s unable to create debounce thread: %s", __func__,
+              strerror(errno));
+    debounce_thread_running = false;
+    pthread_cond_destroy(&monitor_cond);
+  }
 }
 
 static void wakelock_initialize_native(void) {
@@ -209,10 +344,24 @@ static void wakelock_initialize_native(void) {
 }
 
 void wakelock_cleanup(void) {
-  if (wakelock_stats.is_acquired) {
+  if (debounce_thread_created) {
+    pthread_mutex_lock(&monitor_mutex);
+    debounce_thread_running = false;
+    release_pending = false;
+    pthread_cond_signal(&monitor_cond);
+    pthread_mutex_unlock(&monitor_mutex);
+    pthread_join(debounce_thread, NULL);
+    pthread_cond_destroy(&monitor_cond);
+    debounce_thread_created = false;
+  }
+  if (wakelock_physically_held) {
     LOG_ERROR("%s releasing wake lock as part of cleanup", __func__);
-    wakelock_release();
+    const bt_status_t status = wakelock_release_physical();
+    wakelock_physically_held = false;
+    update_wakelock_released_stats(status);
   }
+  wakelock_ref_count = 0;
+  release_pending = false;
   wake_lock_path.clear();
   wake_unlock_path.clear();
   initialized = PTHREAD_ONCE_INIT;
@@ -224,6 +373,21 @@ void wakelock_set_paths(const char* lock_path, const char* unlock_path) {
   if (unlock_path) wake_unlock_path = unlock_path;
 }
 
+void wakelock_set_release_hysteresis_ms(uint64_t hysteresis_ms) {
+  pthread_mutex_lock(&monitor_mutex);
+  release_hysteresis_ms = hysteresis_ms;
+  // Turning the hysteresis off flushes any release that is still pending.
+  if (hysteresis_ms == 0 && release_pending) {
+    release_pending = false;
+    if (wakelock_ref_count == 0 && wakelock_physically_held) {
+      const bt_status_t status = wakelock_release_physical();
+      wakelock_physically_held = false;
+      update_wakelock_released_stats(status);
+    }
+  }
+  pthread_mutex_unlock(&monitor_mutex);
+}
+
 static uint64_t now_ms(void) {
   struct timespec ts;
   if (clock_gettime(CLOCK_ID, &ts) == -1) {
@@ -244,6 +408,9 @@ static void reset_wakelock_stats(void) {
   wakelock_stats.released_count = 0;
   wakelock_stats.acquired_errors = 0;
   wakelock_stats.released_errors = 0;
+  wakelock_stats.debounced_acquires = 0;
+  wakelock_stats.deferred_releases = 0;
+  wakelock_stats.deferred_release_cancels = 0;
   wakelock_stats.min_acquired_interval_ms = 0;
   wakelock_stats.max_acquired_interval_ms = 0;
   wakelock_stats.last_acquired_interval_ms = 0;
@@ -356,6 +523,11 @@ void wakelock_debug_dump(int fd) {
           wakelock_stats.acquired_count, wakelock_stats.released_count);
   dprintf(fd, "  Acquired/released error count  : %zu / %zu\n",
           wakelock_stats.acquired_errors, wakelock_stats.released_errors);
+  dprintf(fd, "  Debounced acquire count        : %zu\n",
+          wakelock_stats.debounced_acquires);
+  dprintf(fd, "  Deferred release sched/cancel  : %zu / %zu\n",
+          wakelock_stats.deferred_releases,
+          wakelock_stats.deferred_release_cancels);
   dprintf(fd, "  Last acquire/release error code: %d / %d\n",
           wakelock_stats.last_acquired_error,
           wakelock_stats.last_released_error);
@@ -44,6 +44,10 @@ void AlarmTestHarness::SetUp() {
   TIMER_INTERVAL_FOR_WAKELOCK_IN_MS = 500;
 
   wakelock_set_os_callouts(&bt_wakelock_callouts);
+
+  // The alarm tests assert on wakelock transitions right after alarm
+  // callbacks run, so releases must be synchronous.
+  wakelock_set_release_hysteresis_ms(0);
 }
 
 void AlarmTestHarness::TearDown() {
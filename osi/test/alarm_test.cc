@@ -122,6 +122,22 @@ TEST_F(AlarmTest, test_set_short) {
   alarm_free(alarm);
 }
 
+TEST_F(AlarmTest, test_set_short_on_queue) {
+  alarm_t* alarm = alarm_new("alarm_test.test_set_short_on_queue");
+
+  alarm_set_on_queue(alarm, 10, cb, NULL, "alarm_test.queue");
+
+  EXPECT_EQ(cb_counter, 0);
+  EXPECT_TRUE(WakeLockHeld());
+
+  semaphore_wait(semaphore);
+
+  EXPECT_EQ(cb_counter, 1);
+  EXPECT_FALSE(WakeLockHeld());
+
+  alarm_free(alarm);
+}
+
 TEST_F(AlarmTest, test_set_short_periodic) {
   alarm_t* alarm = alarm_new_periodic("alarm_test.test_set_short_periodic");
 
@@ -332,6 +348,35 @@ TEST_F(AlarmTest, test_callback_ordering_on_mloop) {
   EXPECT_FALSE(WakeLockHeld());
 }
 
+// Test whether the callbacks are invoked in the expected order on a
+// named callback queue.
+TEST_F(AlarmTest, test_callback_ordering_on_queue) {
+  alarm_t* alarms[100];
+
+  for (int i = 0; i < 100; i++) {
+    const std::string alarm_name =
+        "alarm_test.test_callback_ordering_on_queue[" + std::to_string(i) +
+        "]";
+    alarms[i] = alarm_new(alarm_name.c_str());
+  }
+
+  for (int i = 0; i < 100; i++) {
+    alarm_set_on_queue(alarms[i], 100, ordered_cb, INT_TO_PTR(i),
+                       "alarm_test.queue");
+  }
+
+  for (int i = 1; i <= 100; i++) {
+    semaphore_wait(semaphore);
+    EXPECT_GE(cb_counter, i);
+  }
+  EXPECT_EQ(cb_counter, 100);
+  EXPECT_EQ(cb_misordered_counter, 0);
+
+  for (int i = 0; i < 100; i++) alarm_free(alarms[i]);
+
+  EXPECT_FALSE(WakeLockHeld());
+}
+
 // Try to catch any race conditions between the timer callback and |alarm_free|.
 TEST_F(AlarmTest, test_callback_free_race) {
   for (int i = 0; i < 1000; ++i) {
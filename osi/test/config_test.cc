@@ -263,6 +263,65 @@ TEST_F(ConfigTest, checksum_read) {
   EXPECT_TRUE(std::filesystem::remove(filename));
 }
 
+TEST_F(ConfigTest, config_snapshot_round_trip) {
+  auto filename = std::filesystem::temp_directory_path() / "test.snapshot";
+  std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
+  ASSERT_NE(config, nullptr);
+
+  EXPECT_TRUE(config_save_snapshot(*config, filename, 0x1234));
+
+  std::unique_ptr<config_t> loaded =
+      config_load_snapshot(filename.c_str(), 0x1234);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(config_get_int(*loaded, "DID", "version", 0), 0x1436);
+  EXPECT_EQ(config_get_uint64(*loaded, "DID", "HiSyncId", 0),
+            0xFFFFFFFFFFFFFFFF);
+  EXPECT_STREQ(
+      config_get_string(*loaded, CONFIG_DEFAULT_SECTION, "first_key", nullptr)
+          ->c_str(),
+      "value");
+  EXPECT_EQ(loaded->sections.size(), config->sections.size());
+
+  EXPECT_TRUE(std::filesystem::remove(filename));
+}
+
+TEST_F(ConfigTest, config_snapshot_missing_file) {
+  EXPECT_EQ(config_load_snapshot("/meow.snapshot", 0x1234), nullptr);
+}
+
+TEST_F(ConfigTest, config_snapshot_stale_tag) {
+  auto filename = std::filesystem::temp_directory_path() / "test.snapshot";
+  std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
+  ASSERT_NE(config, nullptr);
+
+  EXPECT_TRUE(config_save_snapshot(*config, filename, 0x1234));
+  EXPECT_EQ(config_load_snapshot(filename.c_str(), 0x5678), nullptr);
+
+  EXPECT_TRUE(std::filesystem::remove(filename));
+}
+
+TEST_F(ConfigTest, config_snapshot_corrupted) {
+  auto filename = std::filesystem::temp_directory_path() / "test.snapshot";
+  std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
+  ASSERT_NE(config, nullptr);
+
+  EXPECT_TRUE(config_save_snapshot(*config, filename, 0x1234));
+
+  // Flip one payload byte; the checksum must reject the file.
+  FILE* fp = fopen(filename.c_str(), "r+b");
+  ASSERT_NE(fp, nullptr);
+  ASSERT_EQ(fseek(fp, -1, SEEK_END), 0);
+  int last = fgetc(fp);
+  ASSERT_NE(last, EOF);
+  ASSERT_EQ(fseek(fp, -1, SEEK_END), 0);
+  ASSERT_NE(fputc(last ^ 0xff, fp), EOF);
+  ASSERT_EQ(fclose(fp), 0);
+
+  EXPECT_EQ(config_load_snapshot(filename.c_str(), 0x1234), nullptr);
+
+  EXPECT_TRUE(std::filesystem::remove(filename));
+}
+
 TEST_F(ConfigTest, checksum_save) {
   auto tmp_dir = std::filesystem::temp_directory_path();
   auto filename = tmp_dir / "test.checksum";
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "osi/include/fixed_queue_mpsc.h"
+#include "osi/include/osi.h"
+
+static const size_t TEST_QUEUE_SIZE = 10;
+
+TEST(FixedQueueMpscTest, test_new_free) {
+  fixed_queue_mpsc_t* queue = fixed_queue_mpsc_new(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+  fixed_queue_mpsc_free(queue, NULL);
+
+  // Test a corner case: free a NULL queue
+  fixed_queue_mpsc_free(NULL, NULL);
+}
+
+TEST(FixedQueueMpscTest, test_enqueue_dequeue_order) {
+  fixed_queue_mpsc_t* queue = fixed_queue_mpsc_new(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+
+  int values[3] = {1, 2, 3};
+  for (int& value : values) fixed_queue_mpsc_enqueue(queue, &value);
+  EXPECT_EQ((size_t)3, fixed_queue_mpsc_length(queue));
+
+  // FIFO order must be preserved across dequeues.
+  for (int& value : values)
+    EXPECT_EQ(&value, fixed_queue_mpsc_dequeue(queue));
+  EXPECT_EQ((size_t)0, fixed_queue_mpsc_length(queue));
+  EXPECT_TRUE(fixed_queue_mpsc_try_dequeue(queue) == NULL);
+
+  fixed_queue_mpsc_free(queue, NULL);
+}
+
+TEST(FixedQueueMpscTest, test_try_enqueue_respects_capacity) {
+  fixed_queue_mpsc_t* queue = fixed_queue_mpsc_new(2);
+  ASSERT_TRUE(queue != NULL);
+
+  int value = 0;
+  EXPECT_TRUE(fixed_queue_mpsc_try_enqueue(queue, &value));
+  EXPECT_TRUE(fixed_queue_mpsc_try_enqueue(queue, &value));
+  EXPECT_FALSE(fixed_queue_mpsc_try_enqueue(queue, &value));
+
+  fixed_queue_mpsc_free(queue, NULL);
+}
+
+static void free_counter_cb(UNUSED_ATTR void* data) {
+  // Counted by the caller through the enqueued sentinel values.
+}
+
+TEST(FixedQueueMpscTest, test_free_with_pending_entries) {
+  fixed_queue_mpsc_t* queue = fixed_queue_mpsc_new(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+
+  int values[4] = {0, 1, 2, 3};
+  for (int& value : values) fixed_queue_mpsc_enqueue(queue, &value);
+  fixed_queue_mpsc_free(queue, free_counter_cb);
+}
+
+TEST(FixedQueueMpscTest, test_multiple_producers_single_consumer) {
+  static const size_t kProducers = 4;
+  static const size_t kItemsPerProducer = 1000;
+
+  fixed_queue_mpsc_t* queue =
+      fixed_queue_mpsc_new(kProducers * kItemsPerProducer);
+  ASSERT_TRUE(queue != NULL);
+
+  static int token;
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < kProducers; ++i) {
+    producers.push_back(std::thread([queue] {
+      for (size_t j = 0; j < kItemsPerProducer; ++j)
+        fixed_queue_mpsc_enqueue(queue, &token);
+    }));
+  }
+
+  // The consumer must see every item exactly once, regardless of producer
+  // interleaving.
+  for (size_t i = 0; i < kProducers * kItemsPerProducer; ++i)
+    EXPECT_EQ(&token, fixed_queue_mpsc_dequeue(queue));
+
+  for (auto& producer : producers) producer.join();
+  EXPECT_EQ((size_t)0, fixed_queue_mpsc_length(queue));
+  EXPECT_TRUE(fixed_queue_mpsc_try_dequeue(queue) == NULL);
+
+  fixed_queue_mpsc_free(queue, NULL);
+}
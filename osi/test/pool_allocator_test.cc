@@ -0,0 +1,63 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ *
+ ******************************************************************************/
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "osi/include/pool_allocator.h"
+
+TEST(PoolAllocatorTest, test_alloc_and_free_round_trip) {
+  void* ptr = pool_allocator_alloc(48);
+  ASSERT_TRUE(ptr != NULL);
+  memset(ptr, 0xa5, 48);
+  EXPECT_TRUE(pool_allocator_free(ptr));
+}
+
+TEST(PoolAllocatorTest, test_freelist_reuse) {
+  void* first = pool_allocator_alloc(339);
+  ASSERT_TRUE(first != NULL);
+  EXPECT_TRUE(pool_allocator_free(first));
+
+  // The freed block should be served back for the same size class.
+  void* second = pool_allocator_alloc(339);
+  EXPECT_EQ(first, second);
+  EXPECT_TRUE(pool_allocator_free(second));
+}
+
+TEST(PoolAllocatorTest, test_oversize_returns_null) {
+  EXPECT_TRUE(pool_allocator_alloc(64 * 1024) == NULL);
+}
+
+TEST(PoolAllocatorTest, test_free_rejects_foreign_pointer) {
+  void* heap_ptr = osi_malloc(128);
+  EXPECT_FALSE(pool_allocator_free(heap_ptr));
+  osi_free(heap_ptr);
+
+  EXPECT_FALSE(pool_allocator_free(NULL));
+}
+
+TEST(PoolAllocatorTest, test_allocator_pool_falls_back_to_heap) {
+  // Oversized requests must still succeed through the allocator_t wrapper.
+  void* big = allocator_pool.alloc(64 * 1024);
+  ASSERT_TRUE(big != NULL);
+  allocator_pool.free(big);
+
+  void* small = allocator_pool.alloc(100);
+  ASSERT_TRUE(small != NULL);
+  allocator_pool.free(small);
+}
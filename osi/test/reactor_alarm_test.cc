@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "AllocationTestHarness.h"
+
+#include "osi/include/reactor_alarm.h"
+#include "osi/include/semaphore.h"
+#include "osi/include/thread.h"
+
+class ReactorAlarmTest : public AllocationTestHarness {
+ protected:
+  void SetUp() override {
+    AllocationTestHarness::SetUp();
+    thread_ = thread_new("reactor_alarm_test_thread");
+    ASSERT_TRUE(thread_ != NULL);
+    semaphore_ = semaphore_new(0);
+    ASSERT_TRUE(semaphore_ != NULL);
+  }
+
+  void TearDown() override {
+    semaphore_free(semaphore_);
+    thread_free(thread_);
+    AllocationTestHarness::TearDown();
+  }
+
+  thread_t* thread_;
+  semaphore_t* semaphore_;
+};
+
+static void post_semaphore_cb(void* data) {
+  semaphore_post((semaphore_t*)data);
+}
+
+TEST_F(ReactorAlarmTest, test_new_free_simple) {
+  reactor_alarm_t* alarm = reactor_alarm_new("alarm_test", thread_);
+  ASSERT_TRUE(alarm != NULL);
+  EXPECT_FALSE(reactor_alarm_is_scheduled(alarm));
+  reactor_alarm_free(alarm);
+}
+
+TEST_F(ReactorAlarmTest, test_free_null) { reactor_alarm_free(NULL); }
+
+TEST_F(ReactorAlarmTest, test_one_shot_fires_on_thread) {
+  reactor_alarm_t* alarm = reactor_alarm_new("alarm_test", thread_);
+
+  reactor_alarm_set(alarm, 5, post_semaphore_cb, semaphore_);
+  EXPECT_TRUE(reactor_alarm_is_scheduled(alarm));
+
+  semaphore_wait(semaphore_);
+  EXPECT_FALSE(reactor_alarm_is_scheduled(alarm));
+
+  reactor_alarm_free(alarm);
+}
+
+TEST_F(ReactorAlarmTest, test_periodic_fires_repeatedly) {
+  reactor_alarm_t* alarm = reactor_alarm_new("alarm_test", thread_);
+
+  reactor_alarm_set_periodic(alarm, 5, post_semaphore_cb, semaphore_);
+  for (int i = 0; i < 3; i++) semaphore_wait(semaphore_);
+  EXPECT_TRUE(reactor_alarm_is_scheduled(alarm));
+
+  reactor_alarm_cancel(alarm);
+  EXPECT_FALSE(reactor_alarm_is_scheduled(alarm));
+
+  reactor_alarm_free(alarm);
+}
+
+TEST_F(ReactorAlarmTest, test_cancel_before_expiry) {
+  reactor_alarm_t* alarm = reactor_alarm_new("alarm_test", thread_);
+
+  reactor_alarm_set(alarm, 10000, post_semaphore_cb, semaphore_);
+  EXPECT_TRUE(reactor_alarm_is_scheduled(alarm));
+  reactor_alarm_cancel(alarm);
+  EXPECT_FALSE(reactor_alarm_is_scheduled(alarm));
+
+  reactor_alarm_free(alarm);
+}
+
+TEST_F(ReactorAlarmTest, test_reset_replaces_deadline) {
+  reactor_alarm_t* alarm = reactor_alarm_new("alarm_test", thread_);
+
+  reactor_alarm_set(alarm, 10000, post_semaphore_cb, semaphore_);
+  reactor_alarm_set(alarm, 5, post_semaphore_cb, semaphore_);
+  semaphore_wait(semaphore_);
+  EXPECT_FALSE(reactor_alarm_is_scheduled(alarm));
+
+  reactor_alarm_free(alarm);
+}
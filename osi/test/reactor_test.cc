@@ -111,3 +111,37 @@ TEST_F(ReactorTest, reactor_unregister_from_separate_thread) {
   close(fd);
   reactor_free(reactor);
 }
+
+static int edge_triggered_callback_count;
+
+static void edge_triggered_read_cb(void* context) {
+  int* fd = (int*)context;
+  // Edge-triggered objects must drain the descriptor completely.
+  eventfd_t value;
+  while (eventfd_read(*fd, &value) == 0)
+    ;
+  edge_triggered_callback_count++;
+}
+
+TEST_F(ReactorTest, reactor_register_edge_triggered_rearms) {
+  reactor_t* reactor = reactor_new();
+
+  int fd = eventfd(0, EFD_NONBLOCK);
+  edge_triggered_callback_count = 0;
+  reactor_object_t* object = reactor_register_edge_triggered(
+      reactor, fd, &fd, edge_triggered_read_cb, NULL);
+  ASSERT_TRUE(object != NULL);
+
+  eventfd_write(fd, 1);
+  reactor_run_once(reactor);
+  EXPECT_EQ(1, edge_triggered_callback_count);
+
+  // A new readiness transition must produce another wakeup.
+  eventfd_write(fd, 1);
+  reactor_run_once(reactor);
+  EXPECT_EQ(2, edge_triggered_callback_count);
+
+  reactor_unregister(object);
+  close(fd);
+  reactor_free(reactor);
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "osi/include/tracepoint.h"
+
+// Dumps the tracepoint ring into a string for inspection.
+static std::string dump_to_string(void) {
+  char path[] = "/tmp/bttraceXXXXXX";
+  int fd = mkstemp(path);
+  EXPECT_GE(fd, 0);
+
+  tracepoint_debug_dump(fd);
+
+  std::string content;
+  char buffer[4096];
+  lseek(fd, 0, SEEK_SET);
+  ssize_t bytes_read;
+  while ((bytes_read = read(fd, buffer, sizeof(buffer))) > 0)
+    content.append(buffer, bytes_read);
+
+  close(fd);
+  unlink(path);
+  return content;
+}
+
+TEST(TracepointTest, test_record_and_dump) {
+  tracepoint_reset();
+
+  tracepoint_record(TRACE_HCI_TX, 0x1234, 0x42);
+  tracepoint_record(TRACE_L2C_RX, 0x0040, 27);
+
+  std::string dump = dump_to_string();
+  EXPECT_NE(dump.find("2 of 2 events"), std::string::npos);
+  EXPECT_NE(dump.find("HCI_TX"), std::string::npos);
+  EXPECT_NE(dump.find("L2C_RX"), std::string::npos);
+  EXPECT_NE(dump.find("0x00001234"), std::string::npos);
+}
+
+TEST(TracepointTest, test_reset) {
+  tracepoint_record(TRACE_HCI_EVT_RX, 0, 0);
+  tracepoint_reset();
+
+  std::string dump = dump_to_string();
+  EXPECT_NE(dump.find("0 of 0 events"), std::string::npos);
+  EXPECT_EQ(dump.find("HCI_EVT_RX"), std::string::npos);
+}
+
+TEST(TracepointTest, test_ring_wraps) {
+  tracepoint_reset();
+
+  // Overfill the ring; only the most recent window should be dumped and
+  // nothing should go out of bounds.
+  const size_t num_events = 10000;
+  for (size_t i = 0; i < num_events; i++)
+    tracepoint_record(TRACE_BTU_HCIF_EVT, i, 0);
+
+  std::string dump = dump_to_string();
+  EXPECT_NE(dump.find("of 10000 events"), std::string::npos);
+  EXPECT_NE(dump.find("BTU_HCIF_EVT"), std::string::npos);
+}
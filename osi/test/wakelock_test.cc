@@ -67,6 +67,10 @@ class WakelockTest : public AllocationTestHarness {
 
     creat(lock_path_.c_str(), S_IRWXU);
     creat(unlock_path_.c_str(), S_IRWXU);
+
+    // Make releases synchronous so the acquire/release assertions below can
+    // observe the wakelock state immediately.
+    wakelock_set_release_hysteresis_ms(0);
   }
 
   void TearDown() override {
@@ -141,6 +145,39 @@ TEST_F(WakelockTest, test_set_os_callouts) {
   }
 }
 
+TEST_F(WakelockTest, test_release_hysteresis) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+
+  // Use a window large enough that it cannot elapse during the test, so the
+  // deferred release is observable and its cancellation is deterministic.
+  wakelock_set_release_hysteresis_ms(10 * 60 * 1000);
+
+  wakelock_acquire();
+  ASSERT_TRUE(is_wake_lock_acquired);
+
+  // The release is deferred: the lock stays physically held.
+  wakelock_release();
+  ASSERT_TRUE(is_wake_lock_acquired);
+
+  // A re-acquire inside the window cancels the deferred release.
+  wakelock_acquire();
+  ASSERT_TRUE(is_wake_lock_acquired);
+  wakelock_release();
+  ASSERT_TRUE(is_wake_lock_acquired);
+
+  // Nested acquires are refcounted: only the last release schedules the drop.
+  wakelock_acquire();
+  wakelock_acquire();
+  wakelock_release();
+  ASSERT_TRUE(is_wake_lock_acquired);
+  wakelock_release();
+  ASSERT_TRUE(is_wake_lock_acquired);
+
+  // Turning the hysteresis off flushes the pending release.
+  wakelock_set_release_hysteresis_ms(0);
+  ASSERT_FALSE(is_wake_lock_acquired);
+}
+
 TEST_F(WakelockTest, test_set_paths) {
   wakelock_set_os_callouts(NULL);  // Make sure we use native wakelocks
   wakelock_set_paths(lock_path_.c_str(), unlock_path_.c_str());
@@ -175,9 +175,7 @@ void GetFolderItemsResponseBuilder::PushMediaPlayerItem(
   uint16_t name_len = item.name_.size();
   AddPayloadOctets2(pkt, base::ByteSwap(name_len));
 
-  for (const uint8_t& byte : item.name_) {
-    AddPayloadOctets1(pkt, byte);
-  }
+  AddPayloadBytes(pkt, item.name_);
 }
 
 void GetFolderItemsResponseBuilder::PushFolderItem(
@@ -192,9 +190,7 @@ void GetFolderItemsResponseBuilder::PushFolderItem(
                     base::ByteSwap((uint16_t)0x006a));  // UTF-8 Character Set
   uint16_t name_len = item.name_.size();
   AddPayloadOctets2(pkt, base::ByteSwap(name_len));
-  for (const uint8_t& byte : item.name_) {
-    AddPayloadOctets1(pkt, byte);
-  }
+  AddPayloadBytes(pkt, item.name_);
 }
 
 void GetFolderItemsResponseBuilder::PushMediaElementItem(
@@ -209,9 +205,7 @@ void GetFolderItemsResponseBuilder::PushMediaElementItem(
                     base::ByteSwap((uint16_t)0x006a));  // UTF-8 Character Set
   uint16_t name_len = item.name_.size();
   AddPayloadOctets2(pkt, base::ByteSwap(name_len));
-  for (const uint8_t& byte : item.name_) {
-    AddPayloadOctets1(pkt, byte);
-  }
+  AddPayloadBytes(pkt, item.name_);
 
   AddPayloadOctets1(pkt, (uint8_t)item.attributes_.size());
   for (const auto& entry : item.attributes_) {
@@ -223,9 +217,7 @@ void GetFolderItemsResponseBuilder::PushMediaElementItem(
     uint16_t attr_len = attr_val.size();
 
     AddPayloadOctets2(pkt, base::ByteSwap(attr_len));
-    for (const uint8_t& byte : attr_val) {
-      AddPayloadOctets1(pkt, byte);
-    }
+    AddPayloadBytes(pkt, attr_val);
   }
 }
 
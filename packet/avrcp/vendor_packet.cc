@@ -72,9 +72,7 @@ bool VendorPacketBuilder::PushAttributeValue(
   AddPayloadOctets2(pkt, base::ByteSwap(character_set));
   uint16_t value_length = entry.value().length();
   AddPayloadOctets2(pkt, base::ByteSwap(value_length));
-  for (int i = 0; i < value_length; i++) {
-    AddPayloadOctets1(pkt, entry.value()[i]);
-  }
+  AddPayloadBytes(pkt, entry.value());
 
   return true;
 }
@@ -40,4 +40,12 @@ bool PacketBuilder::AddPayloadOctets(const std::shared_ptr<Packet>& pkt,
   return true;
 }
 
+bool PacketBuilder::AddPayloadBytes(const std::shared_ptr<Packet>& pkt,
+                                    const uint8_t* data, size_t length) {
+  pkt->data_->insert(pkt->data_->end(), data, data + length);
+  pkt->packet_end_index_ += length;
+
+  return true;
+}
+
 }  // namespace bluetooth
\ No newline at end of file
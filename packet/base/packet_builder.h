@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 namespace bluetooth {
 
@@ -50,6 +51,15 @@ class PacketBuilder {
   bool AddPayloadOctets8(const std::shared_ptr<Packet>& pkt, uint64_t value) {
     return AddPayloadOctets(pkt, 8, value);
   }
+  // Append |length| bytes starting at |data| to the payload as a single
+  // insert rather than one octet at a time.
+  bool AddPayloadBytes(const std::shared_ptr<Packet>& pkt, const uint8_t* data,
+                       size_t length);
+  bool AddPayloadBytes(const std::shared_ptr<Packet>& pkt,
+                       const std::string& value) {
+    return AddPayloadBytes(
+        pkt, reinterpret_cast<const uint8_t*>(value.data()), value.size());
+  }
 
  private:
   // Add |octets| bytes to the payload.  Return true if:
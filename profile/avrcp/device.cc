@@ -70,6 +70,9 @@ void Device::SetBrowseMtu(uint16_t browse_mtu) {
 void Device::SetBipClientStatus(bool connected) {
   DEVICE_LOG(INFO) << __PRETTY_FUNCTION__ << ": connected = " << connected;
   has_bip_client_ = connected;
+  // Cover art filtering depends on the BIP client, so the cached element
+  // attributes no longer match what we should hand out.
+  last_song_info_valid_ = false;
 }
 
 bool Device::HasBipClient() const {
@@ -171,6 +174,14 @@ void Device::VendorPacketHandler(uint8_t label,
         send_message(label, false, std::move(response));
         return;
       }
+      // Car kits poll this PDU every second; while the track is unchanged,
+      // answer from the cached song info instead of waking the media layer.
+      if (last_song_info_valid_) {
+        GetElementAttributesResponse(label, get_element_attributes_request_pkt,
+                                     last_song_info_);
+        return;
+      }
+
       media_interface_->GetSongInfo(base::Bind(&Device::GetElementAttributesResponse, weak_ptr_factory_.GetWeakPtr(),
                                                label, get_element_attributes_request_pkt));
     } break;
@@ -623,6 +634,7 @@ void Device::GetElementAttributesResponse(
   }
 
   last_song_info_ = info;
+  last_song_info_valid_ = true;
 
   if (attributes_requested.size() != 0) {
     for (const auto& attribute : attributes_requested) {
@@ -1344,7 +1356,12 @@ void Device::SendMediaUpdate(bool metadata, bool play_status, bool queue) {
     }
   }
 
-  if (metadata) HandleTrackUpdate();
+  if (metadata) {
+    // The current track (or its metadata) changed, stop serving
+    // GetElementAttributes polls from the cached song info.
+    last_song_info_valid_ = false;
+    HandleTrackUpdate();
+  }
 }
 
 void Device::SendFolderUpdate(bool available_players, bool addressed_player,
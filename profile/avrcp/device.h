@@ -327,6 +327,11 @@ class Device {
   uint32_t play_pos_interval_ = 0;
 
   SongInfo last_song_info_;
+  // Whether last_song_info_ still describes the current track. While set,
+  // GetElementAttributes polls are answered from the cached info without a
+  // round trip to the media layer; cleared on track changes and on BIP
+  // client changes since those alter the attributes we hand out.
+  bool last_song_info_valid_ = false;
   PlayStatus last_play_status_;
 
   base::CancelableClosure play_pos_update_cb_;
@@ -646,6 +646,56 @@ TEST_F(AvrcpDeviceTest, getElementAttributesTest) {
   SendMessage(3, TestAvrcpPacket::Make(get_element_attributes_request_full));
 }
 
+TEST_F(AvrcpDeviceTest, getElementAttributesCachedTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr);
+
+  SongInfo info = {"test_id",
+                   {// The attribute map
+                    AttributeEntry(Attribute::TITLE, "Test Song"),
+                    AttributeEntry(Attribute::ARTIST_NAME, "Test Artist")}};
+
+  // Only the first poll and the poll after the track change should reach
+  // the media layer; the poll in between is served from the cache.
+  EXPECT_CALL(interface, GetSongInfo(_))
+      .Times(2)
+      .WillRepeatedly(InvokeCb<0>(info));
+
+  auto compare_to_first =
+      GetElementAttributesResponseBuilder::MakeBuilder(0xFFFF);
+  compare_to_first->AddAttributeEntry(Attribute::TITLE, "Test Song");
+  compare_to_first->AddAttributeEntry(Attribute::ARTIST_NAME, "Test Artist");
+  EXPECT_CALL(response_cb,
+              Call(1, false, matchPacket(std::move(compare_to_first))))
+      .Times(1);
+  SendMessage(1, TestAvrcpPacket::Make(get_element_attributes_request_full));
+
+  auto compare_to_cached =
+      GetElementAttributesResponseBuilder::MakeBuilder(0xFFFF);
+  compare_to_cached->AddAttributeEntry(Attribute::TITLE, "Test Song");
+  compare_to_cached->AddAttributeEntry(Attribute::ARTIST_NAME, "Test Artist");
+  EXPECT_CALL(response_cb,
+              Call(2, false, matchPacket(std::move(compare_to_cached))))
+      .Times(1);
+  SendMessage(2, TestAvrcpPacket::Make(get_element_attributes_request_full));
+
+  // A metadata update invalidates the cache even when the remote isn't
+  // registered for track change notifications.
+  test_device->SendMediaUpdate(true, false, false);
+
+  auto compare_to_refetched =
+      GetElementAttributesResponseBuilder::MakeBuilder(0xFFFF);
+  compare_to_refetched->AddAttributeEntry(Attribute::TITLE, "Test Song");
+  compare_to_refetched->AddAttributeEntry(Attribute::ARTIST_NAME,
+                                          "Test Artist");
+  EXPECT_CALL(response_cb,
+              Call(3, false, matchPacket(std::move(compare_to_refetched))))
+      .Times(1);
+  SendMessage(3, TestAvrcpPacket::Make(get_element_attributes_request_full));
+}
+
 TEST_F(AvrcpDeviceTest, getElementAttributesWithCoverArtTest) {
   MockMediaInterface interface;
   NiceMock<MockA2dpInterface> a2dp_interface;
@@ -405,6 +405,7 @@ const btgatt_client_callbacks_t gatt_client_callbacks = {
     nullptr,
     nullptr,
     nullptr,  // service_changed_cb
+    nullptr,  // notify_batch_cb
 };
 
 const btgatt_server_callbacks_t gatt_server_callbacks = {
@@ -70,6 +70,12 @@ typedef struct {
   size_t media_read_total_dropped_packets;
   size_t media_read_total_actual_reads_count;
   size_t media_read_total_actual_read_bytes;
+
+  // Cost of the libFDK encode itself, one sample per produced AU, so the
+  // encoder share of the media task interval can be monitored per bitrate.
+  uint64_t encode_total_us;
+  uint64_t encode_max_us;
+  size_t encode_frames;
 } a2dp_aac_encoder_stats_t;
 
 typedef struct {
@@ -649,9 +655,15 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame) {
         }
         in_buf_vector[0] = read_buffer;
         out_buf_vector[0] = packet + count;
+        uint64_t encode_start_us = bluetooth::common::time_get_os_boottime_us();
         AACENC_ERROR aac_error =
             aacEncEncode(a2dp_aac_encoder_cb.aac_handle, &in_buf_desc,
                          &out_buf_desc, &aac_in_args, &aac_out_args);
+        uint64_t encode_us =
+            bluetooth::common::time_get_os_boottime_us() - encode_start_us;
+        a2dp_aac_encoder_cb.stats.encode_total_us += encode_us;
+        if (encode_us > a2dp_aac_encoder_cb.stats.encode_max_us)
+          a2dp_aac_encoder_cb.stats.encode_max_us = encode_us;
         if (aac_error != AACENC_OK) {
           LOG_ERROR("%s: AAC encoding error: 0x%x", __func__, aac_error);
           a2dp_aac_encoder_cb.stats.media_read_total_dropped_packets++;
@@ -659,6 +671,7 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame) {
           return;
         }
         written = aac_out_args.numOutBytes;
+        if (written > 0) a2dp_aac_encoder_cb.stats.encode_frames++;
         count += written;
         p_buf->len += written;
         nb_frame--;
@@ -766,4 +779,12 @@ void A2dpCodecConfigAacSource::debug_codec_dump(int fd) {
           "%zu\n",
           stats->media_read_total_expected_read_bytes,
           stats->media_read_total_actual_read_bytes);
+
+  dprintf(fd,
+          "  Frame encode time in us (average/max)                   : "
+          "%" PRIu64 " / %" PRIu64 " (%zu frames)\n",
+          stats->encode_frames != 0
+              ? stats->encode_total_us / stats->encode_frames
+              : 0,
+          stats->encode_max_us, stats->encode_frames);
 }
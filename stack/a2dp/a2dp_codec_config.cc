@@ -1335,45 +1335,53 @@ int A2DP_GetSinkTrackChannelType(const uint8_t* p_codec_info) {
 
 bool A2DP_GetPacketTimestamp(const uint8_t* p_codec_info, const uint8_t* p_data,
                              uint32_t* p_timestamp) {
-  tA2DP_CODEC_TYPE codec_type = A2DP_GetCodecType(p_codec_info);
-
-  switch (codec_type) {
-    case A2DP_MEDIA_CT_SBC:
-      return A2DP_GetPacketTimestampSbc(p_codec_info, p_data, p_timestamp);
-#if !defined(EXCLUDE_NONSTANDARD_CODECS)
-    case A2DP_MEDIA_CT_AAC:
-      return A2DP_GetPacketTimestampAac(p_codec_info, p_data, p_timestamp);
-    case A2DP_MEDIA_CT_NON_A2DP:
-      return A2DP_VendorGetPacketTimestamp(p_codec_info, p_data, p_timestamp);
-#endif
-    default:
-      break;
-  }
-
-  LOG_ERROR("%s: unsupported codec type 0x%x", __func__, codec_type);
-  return false;
+  const tA2DP_PACKET_INTERFACE* packet_interface =
+      A2DP_GetPacketInterface(p_codec_info);
+  if (packet_interface == NULL) return false;
+  return packet_interface->get_packet_timestamp(p_codec_info, p_data,
+                                                p_timestamp);
 }
 
 bool A2DP_BuildCodecHeader(const uint8_t* p_codec_info, BT_HDR* p_buf,
                            uint16_t frames_per_packet) {
+  const tA2DP_PACKET_INTERFACE* packet_interface =
+      A2DP_GetPacketInterface(p_codec_info);
+  if (packet_interface == NULL) return false;
+  return packet_interface->build_codec_header(p_codec_info, p_buf,
+                                              frames_per_packet);
+}
+
+static const tA2DP_PACKET_INTERFACE a2dp_packet_interface_sbc = {
+    A2DP_GetPacketTimestampSbc,
+    A2DP_BuildCodecHeaderSbc,
+};
+
+#if !defined(EXCLUDE_NONSTANDARD_CODECS)
+static const tA2DP_PACKET_INTERFACE a2dp_packet_interface_aac = {
+    A2DP_GetPacketTimestampAac,
+    A2DP_BuildCodecHeaderAac,
+};
+#endif
+
+const tA2DP_PACKET_INTERFACE* A2DP_GetPacketInterface(
+    const uint8_t* p_codec_info) {
   tA2DP_CODEC_TYPE codec_type = A2DP_GetCodecType(p_codec_info);
 
   switch (codec_type) {
     case A2DP_MEDIA_CT_SBC:
-      return A2DP_BuildCodecHeaderSbc(p_codec_info, p_buf, frames_per_packet);
+      return &a2dp_packet_interface_sbc;
 #if !defined(EXCLUDE_NONSTANDARD_CODECS)
     case A2DP_MEDIA_CT_AAC:
-      return A2DP_BuildCodecHeaderAac(p_codec_info, p_buf, frames_per_packet);
+      return &a2dp_packet_interface_aac;
     case A2DP_MEDIA_CT_NON_A2DP:
-      return A2DP_VendorBuildCodecHeader(p_codec_info, p_buf,
-                                         frames_per_packet);
+      return A2DP_VendorGetPacketInterface(p_codec_info);
 #endif
     default:
       break;
   }
 
   LOG_ERROR("%s: unsupported codec type 0x%x", __func__, codec_type);
-  return false;
+  return NULL;
 }
 
 const tA2DP_ENCODER_INTERFACE* A2DP_GetEncoderInterface(
@@ -97,6 +97,7 @@ typedef struct {
   uint8_t tx_sbc_frames;
   bool is_peer_edr;         /* True if the peer device supports EDR */
   bool peer_supports_3mbps; /* True if the peer device supports 3Mbps EDR */
+  bool low_latency_mode;    /* True to send single-frame packets */
   uint16_t peer_mtu;        /* MTU of the A2DP peer */
   uint32_t timestamp;       /* Timestamp for the A2DP frames */
   SBC_ENC_PARAMS sbc_encoder_params;
@@ -812,9 +813,20 @@ static uint8_t calculate_max_frames_per_packet(void) {
       LOG_ERROR("%s: Max number of SBC frames: %d", __func__, result);
       break;
   }
+  if (a2dp_sbc_encoder_cb.low_latency_mode && result > 1) {
+    // In low-latency mode no frame waits for a larger packet to fill up.
+    result = 1;
+  }
   return result;
 }
 
+void a2dp_sbc_set_low_latency_mode(bool enabled) {
+  if (a2dp_sbc_encoder_cb.low_latency_mode == enabled) return;
+  LOG_INFO("%s: enabled=%d", __func__, enabled);
+  a2dp_sbc_encoder_cb.low_latency_mode = enabled;
+  a2dp_sbc_encoder_cb.tx_sbc_frames = calculate_max_frames_per_packet();
+}
+
 static uint16_t a2dp_sbc_source_rate() {
   uint16_t rate = A2DP_SBC_DEFAULT_BITRATE;
 
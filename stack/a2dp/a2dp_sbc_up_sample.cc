@@ -25,6 +25,12 @@
 
 #include "a2dp_sbc_up_sample.h"
 
+#include <string.h>
+
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#endif
+
 typedef int(tA2DP_SBC_ACT)(void* p_src, void* p_dst, uint32_t src_samples,
                            uint32_t dst_samples, uint32_t* p_ret);
 
@@ -164,7 +170,35 @@ int a2dp_sbc_up_sample_16s(void* p_src, void* p_dst, uint32_t src_samples,
 
   a2dp_sbc_ups_cb.cur_pos = dst_sps;
 
-  while (src_samples-- && dst_samples) {
+  while (src_samples && dst_samples) {
+    if (a2dp_sbc_ups_cb.cur_pos <= (int32_t)src_sps) {
+      /* Every frame in this stretch is emitted exactly once, and for the
+       * common rate pairs (equal rates, or 44.1kHz -> 48kHz) that covers
+       * nearly all frames, so copy the whole run as one block instead of
+       * sample by sample. */
+      uint32_t run;
+      if (dst_sps > src_sps) {
+        run = 1 + (uint32_t)((int32_t)src_sps - a2dp_sbc_ups_cb.cur_pos) /
+                      (dst_sps - src_sps);
+      } else {
+        run = src_samples;
+      }
+      if (run > src_samples) run = src_samples;
+      if (run > dst_samples) run = dst_samples;
+
+      memcpy(p_dst_tmp, p_src_tmp, run * 2 * sizeof(int16_t));
+      p_src_tmp += run * 2;
+      p_dst_tmp += run * 2;
+      src_samples -= run;
+      dst_samples -= run;
+      a2dp_sbc_ups_cb.cur_pos +=
+          (int32_t)run * ((int32_t)dst_sps - (int32_t)src_sps);
+      *p_worker1 = *(p_src_tmp - 2);
+      *p_worker2 = *(p_src_tmp - 1);
+      continue;
+    }
+
+    src_samples--;
     *p_worker1 = *p_src_tmp++;
     *p_worker2 = *p_src_tmp++;
 
@@ -223,7 +257,47 @@ int a2dp_sbc_up_sample_16m(void* p_src, void* p_dst, uint32_t src_samples,
 
   a2dp_sbc_ups_cb.cur_pos = dst_sps;
 
-  while (src_samples-- && dst_samples) {
+  while (src_samples && dst_samples) {
+    if (a2dp_sbc_ups_cb.cur_pos <= (int32_t)src_sps) {
+      /* Same run detection as the stereo case; each mono sample in the
+       * run expands to exactly one left/right pair, which vectorizes as
+       * a duplicate-and-interleave store. */
+      uint32_t run;
+      if (dst_sps > src_sps) {
+        run = 1 + (uint32_t)((int32_t)src_sps - a2dp_sbc_ups_cb.cur_pos) /
+                      (dst_sps - src_sps);
+      } else {
+        run = src_samples;
+      }
+      if (run > src_samples) run = src_samples;
+      if (run > dst_samples / 2) run = dst_samples / 2;
+      if (run == 0) break;
+
+      uint32_t n = run;
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      while (n >= 8) {
+        int16x8_t samples = vld1q_s16(p_src_tmp);
+        int16x8x2_t frames = {{samples, samples}};
+        vst2q_s16(p_dst_tmp, frames);
+        p_src_tmp += 8;
+        p_dst_tmp += 16;
+        n -= 8;
+      }
+#endif
+      while (n--) {
+        *p_dst_tmp++ = *p_src_tmp;
+        *p_dst_tmp++ = *p_src_tmp++;
+      }
+
+      src_samples -= run;
+      dst_samples -= run * 2;
+      a2dp_sbc_ups_cb.cur_pos +=
+          (int32_t)run * ((int32_t)dst_sps - (int32_t)src_sps);
+      *p_worker = *(p_src_tmp - 1);
+      continue;
+    }
+
+    src_samples--;
     *p_worker = *p_src_tmp++;
 
     do {
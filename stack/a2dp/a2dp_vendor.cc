@@ -472,6 +472,48 @@ bool A2DP_VendorBuildCodecHeader(const uint8_t* p_codec_info, BT_HDR* p_buf,
   return false;
 }
 
+static const tA2DP_PACKET_INTERFACE a2dp_packet_interface_aptx = {
+    A2DP_VendorGetPacketTimestampAptx,
+    A2DP_VendorBuildCodecHeaderAptx,
+};
+
+static const tA2DP_PACKET_INTERFACE a2dp_packet_interface_aptx_hd = {
+    A2DP_VendorGetPacketTimestampAptxHd,
+    A2DP_VendorBuildCodecHeaderAptxHd,
+};
+
+static const tA2DP_PACKET_INTERFACE a2dp_packet_interface_ldac = {
+    A2DP_VendorGetPacketTimestampLdac,
+    A2DP_VendorBuildCodecHeaderLdac,
+};
+
+const tA2DP_PACKET_INTERFACE* A2DP_VendorGetPacketInterface(
+    const uint8_t* p_codec_info) {
+  uint32_t vendor_id = A2DP_VendorCodecGetVendorId(p_codec_info);
+  uint16_t codec_id = A2DP_VendorCodecGetCodecId(p_codec_info);
+
+  // Check for aptX
+  if (vendor_id == A2DP_APTX_VENDOR_ID &&
+      codec_id == A2DP_APTX_CODEC_ID_BLUETOOTH) {
+    return &a2dp_packet_interface_aptx;
+  }
+
+  // Check for aptX-HD
+  if (vendor_id == A2DP_APTX_HD_VENDOR_ID &&
+      codec_id == A2DP_APTX_HD_CODEC_ID_BLUETOOTH) {
+    return &a2dp_packet_interface_aptx_hd;
+  }
+
+  // Check for LDAC
+  if (vendor_id == A2DP_LDAC_VENDOR_ID && codec_id == A2DP_LDAC_CODEC_ID) {
+    return &a2dp_packet_interface_ldac;
+  }
+
+  // Add checks based on <vendor_id, codec_id>
+
+  return NULL;
+}
+
 const tA2DP_ENCODER_INTERFACE* A2DP_VendorGetEncoderInterface(
     const uint8_t* p_codec_info) {
   uint32_t vendor_id = A2DP_VendorCodecGetVendorId(p_codec_info);
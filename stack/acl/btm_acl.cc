@@ -38,7 +38,9 @@
 #include "bta/include/bta_dm_acl.h"
 #include "bta/sys/bta_sys.h"
 #include "btif/include/btif_acl.h"
+#include "btif/include/btif_config.h"
 #include "common/metrics.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "device/include/interop.h"
 #include "include/l2cap_hci_link_interface.h"
@@ -62,6 +64,7 @@
 #include "stack/include/btu.h"
 #include "stack/include/hci_error_code.h"
 #include "stack/include/hcimsgs.h"
+#include "stack/include/l2c_api.h"
 #include "stack/include/l2cap_acl_interface.h"
 #include "stack/include/sco_hci_link_interface.h"
 #include "types/hci_role.h"
@@ -136,12 +139,15 @@ inline bool IsEprAvailable(const tACL_CONN& p_acl) {
          controller_get_interface()->supports_encryption_pause();
 }
 
+static void btm_cache_remote_features(const tACL_CONN& p_acl,
+                                      uint8_t max_page_number);
 static void btm_process_remote_ext_features(tACL_CONN* p_acl_cb,
                                             uint8_t max_page_number);
 static void btm_read_failed_contact_counter_timeout(void* data);
 static void btm_read_remote_ext_features(uint16_t handle, uint8_t page_number);
 static void btm_read_rssi_timeout(void* data);
 static void btm_read_tx_power_timeout(void* data);
+static bool btm_restore_remote_features(tACL_CONN* p_acl_cb);
 static void check_link_policy(tLINK_POLICY* settings);
 void btm_set_link_policy(tACL_CONN* conn, tLINK_POLICY policy);
 
@@ -412,6 +418,19 @@ void btm_acl_created(const RawAddress& bda, uint16_t hci_handle,
         !bluetooth::shim::is_gd_acl_enabled()) {
       // GD L2cap and GD Acl read this automatically
       btsnd_hcic_rmt_ver_req(hci_handle);
+      if (btm_restore_remote_features(p_acl)) {
+        /* A bonded reconnect rides the feature pages cached from the
+         * last read, so the remote feature reads are skipped entirely
+         * and the link is usable by profiles right away; the version
+         * read above still refreshes the version info but no longer
+         * gates establishment */
+        internal_.btm_establish_continue(p_acl);
+      } else {
+        /* Queue the feature read right behind the version read instead
+         * of chaining it off the version completion; the HCI layer
+         * issues them back to back as command credits allow */
+        internal_.btm_read_remote_features(hci_handle);
+      }
     }
   }
 
@@ -482,7 +501,16 @@ void btm_acl_device_down(void) {
   BTM_db_reset();
 }
 
-void btm_acl_set_paging(bool value) { btm_cb.is_paging = value; }
+void btm_acl_set_paging(bool value) {
+  if (value != btm_cb.is_paging) {
+    /* let an active inquiry yield the radio for the page duration */
+    if (value)
+      btm_inq_page_started();
+    else
+      btm_inq_page_completed();
+  }
+  btm_cb.is_paging = value;
+}
 
 void btm_acl_update_inquiry_status(uint8_t status) {
   btm_cb.is_inquiry = status == BTM_INQUIRY_STARTED;
@@ -758,7 +786,7 @@ void BTM_default_block_role_switch() {
  *
  ******************************************************************************/
 static void maybe_chain_more_commands_after_read_remote_version_complete(
-    uint8_t status, uint16_t handle) {
+    UNUSED_ATTR uint8_t status, uint16_t handle) {
   tACL_CONN* p_acl_cb = internal_.acl_get_connection_from_handle(handle);
   if (p_acl_cb == nullptr) {
     LOG_WARN("Received remote version complete for unknown device");
@@ -772,15 +800,13 @@ static void maybe_chain_more_commands_after_read_remote_version_complete(
       break;
     case BT_TRANSPORT_BR_EDR:
       /**
-       * When running legacy stack continue chain of executing various
-       * read commands.  Skip when gd_acl is enabled because that
-       * module handles all remote read functionality.
+       * When running legacy stack the remote feature read is pipelined
+       * right behind the version read at ACL creation, or satisfied
+       * from the bonded-device cache, so nothing more is chained here.
+       * When gd_acl is enabled that module handles all remote read
+       * functionality.
        */
-      if (!bluetooth::shim::is_gd_acl_enabled()) {
-        if (status == HCI_SUCCESS) {
-          internal_.btm_read_remote_features(p_acl_cb->hci_handle);
-        }
-      }
+      break;
   }
 }
 
@@ -872,6 +898,73 @@ void btm_process_remote_ext_features(tACL_CONN* p_acl_cb,
                             br_edr_supported, le_supported);
 }
 
+/*******************************************************************************
+ *
+ * Function         btm_cache_remote_features
+ *
+ * Description      Persist the remote feature pages just read so the next
+ *                  connection to this peer can skip the remote reads. The
+ *                  entry lives in the device's config section and follows
+ *                  its lifetime; unpaired devices are pruned with the rest
+ *                  of their section.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void btm_cache_remote_features(const tACL_CONN& p_acl,
+                                      uint8_t max_page_number) {
+  uint8_t blob[1 + sizeof(p_acl.peer_lmp_feature_pages)];
+
+  blob[0] = max_page_number;
+  memcpy(&blob[1], p_acl.peer_lmp_feature_pages,
+         sizeof(p_acl.peer_lmp_feature_pages));
+  btif_config_set_bin(p_acl.remote_addr.ToString(),
+                      BT_CONFIG_KEY_REMOTE_FEATURE_PAGES, blob, sizeof(blob));
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_restore_remote_features
+ *
+ * Description      Apply the feature pages cached for a bonded peer and
+ *                  process them as if the remote reads just completed, so
+ *                  profiles learn their prerequisite bits without waiting
+ *                  on the air. Only bonded peers are trusted; anyone else
+ *                  gets the full read sequence.
+ *
+ * Returns          true if cached pages were applied
+ *
+ ******************************************************************************/
+static bool btm_restore_remote_features(tACL_CONN* p_acl_cb) {
+  CHECK(p_acl_cb != nullptr);
+
+  if (!btm_sec_is_a_bonded_dev(p_acl_cb->remote_addr)) return false;
+
+  uint8_t blob[1 + sizeof(p_acl_cb->peer_lmp_feature_pages)];
+  size_t length = sizeof(blob);
+  if (!btif_config_get_bin(p_acl_cb->remote_addr.ToString(),
+                           BT_CONFIG_KEY_REMOTE_FEATURE_PAGES, blob,
+                           &length) ||
+      length != sizeof(blob)) {
+    return false;
+  }
+
+  const uint8_t max_page_number = blob[0];
+  if (max_page_number > HCI_EXT_FEATURES_PAGE_MAX) return false;
+
+  memcpy(p_acl_cb->peer_lmp_feature_pages, &blob[1],
+         sizeof(p_acl_cb->peer_lmp_feature_pages));
+  for (uint8_t page = 0; page <= max_page_number; page++) {
+    p_acl_cb->peer_lmp_feature_valid[page] = true;
+  }
+
+  LOG_DEBUG("Restored %d cached remote feature pages for %s",
+            max_page_number + 1, PRIVATE_ADDRESS(p_acl_cb->remote_addr));
+
+  btm_process_remote_ext_features(p_acl_cb, max_page_number);
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         btm_read_remote_features
@@ -977,6 +1070,7 @@ void btm_read_remote_features_complete(uint16_t handle, uint8_t* features) {
   /* Remote controller has no extended features. Process remote controller
      supported features (features page 0). */
   btm_process_remote_ext_features(p_acl_cb, 0);
+  btm_cache_remote_features(*p_acl_cb, 0);
 
   /* Continue with HCI connection establishment */
   internal_.btm_establish_continue(p_acl_cb);
@@ -1054,6 +1148,7 @@ void btm_read_remote_ext_features_complete(uint16_t handle, uint8_t page_num,
 
   /* Process the pages */
   btm_process_remote_ext_features(p_acl_cb, max_page);
+  btm_cache_remote_features(*p_acl_cb, max_page);
 
   /* Continue with HCI connection establishment */
   internal_.btm_establish_continue(p_acl_cb);
@@ -1690,6 +1785,159 @@ tBTM_STATUS BTM_ReadRSSI(const RawAddress& remote_bda, tBTM_CMPL_CB* p_cb) {
   return (BTM_UNKNOWN_ADDR);
 }
 
+/*******************************************************************************
+ *
+ * Shared link metrics poller. btif_dm, the A2DP source debug path and the
+ * hearing aid profile all poll RSSI on the same links independently, and
+ * the single completion slot in devcb turns those overlaps into BTM_BUSY
+ * failures. The poller issues one Read RSSI per link and fans the result
+ * out to every subscriber, with a floor on the polling rate.
+ *
+ ******************************************************************************/
+constexpr uint8_t BTM_METRICS_MAX_SUBS = 8;
+constexpr uint16_t BTM_METRICS_MIN_PERIOD_MS = 250;
+
+typedef struct {
+  bool in_use;
+  RawAddress bd_addr;
+  uint16_t period_ms; /* 0: one reading, then the slot frees itself */
+  uint64_t next_due_ms;
+  tBTM_CMPL_CB* p_cb;
+} tBTM_METRICS_SUB;
+
+static struct {
+  tBTM_METRICS_SUB subs[BTM_METRICS_MAX_SUBS];
+  alarm_t* timer;
+  RawAddress in_flight_bda;
+  bool in_flight;
+  uint32_t polls_issued;
+  uint32_t results_fanned_out;
+} btm_metrics;
+
+static void btm_link_metrics_poll_due(void);
+
+static void btm_link_metrics_timer_timeout(UNUSED_ATTR void* data) {
+  btm_link_metrics_poll_due();
+}
+
+/* Arm the timer for the earliest pending subscription */
+static void btm_link_metrics_schedule(void) {
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  uint64_t earliest_ms = UINT64_MAX;
+
+  for (const tBTM_METRICS_SUB& sub : btm_metrics.subs) {
+    if (sub.in_use && sub.next_due_ms < earliest_ms)
+      earliest_ms = sub.next_due_ms;
+  }
+  if (earliest_ms == UINT64_MAX) {
+    if (btm_metrics.timer != nullptr) alarm_cancel(btm_metrics.timer);
+    return;
+  }
+
+  uint64_t delay_ms = (earliest_ms > now_ms) ? earliest_ms - now_ms : 1;
+  alarm_set_on_mloop(btm_metrics.timer, delay_ms,
+                     btm_link_metrics_timer_timeout, NULL);
+}
+
+static void btm_link_metrics_rssi_cb(void* p_data) {
+  tBTM_RSSI_RESULT* p_result = (tBTM_RSSI_RESULT*)p_data;
+  btm_metrics.in_flight = false;
+
+  if (p_result != nullptr) {
+    for (tBTM_METRICS_SUB& sub : btm_metrics.subs) {
+      if (!sub.in_use || sub.bd_addr != btm_metrics.in_flight_bda) continue;
+      btm_metrics.results_fanned_out++;
+      (*sub.p_cb)(p_data);
+      if (sub.period_ms == 0) sub.in_use = false;
+    }
+  }
+
+  /* Other links may have come due while this read was outstanding */
+  btm_link_metrics_poll_due();
+}
+
+/* Issue one read for the most overdue link; the completion callback polls
+ * again, so due links are served back to back through the single devcb
+ * completion slot. */
+static void btm_link_metrics_poll_due(void) {
+  if (btm_metrics.in_flight) return;
+
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  tBTM_METRICS_SUB* p_due = nullptr;
+
+  for (tBTM_METRICS_SUB& sub : btm_metrics.subs) {
+    if (!sub.in_use || sub.next_due_ms > now_ms) continue;
+    if (p_due == nullptr || sub.next_due_ms < p_due->next_due_ms) p_due = &sub;
+  }
+  if (p_due == nullptr) {
+    btm_link_metrics_schedule();
+    return;
+  }
+
+  /* Advance every subscription of this link so one read serves them all */
+  for (tBTM_METRICS_SUB& sub : btm_metrics.subs) {
+    if (sub.in_use && sub.bd_addr == p_due->bd_addr) {
+      sub.next_due_ms = now_ms + ((sub.period_ms > BTM_METRICS_MIN_PERIOD_MS)
+                                      ? sub.period_ms
+                                      : BTM_METRICS_MIN_PERIOD_MS);
+    }
+  }
+
+  tBTM_STATUS status = BTM_ReadRSSI(p_due->bd_addr, btm_link_metrics_rssi_cb);
+  if (status == BTM_CMD_STARTED) {
+    btm_metrics.in_flight = true;
+    btm_metrics.in_flight_bda = p_due->bd_addr;
+    btm_metrics.polls_issued++;
+  } else if (status == BTM_UNKNOWN_ADDR) {
+    /* The link is gone; drop its subscriptions */
+    for (tBTM_METRICS_SUB& sub : btm_metrics.subs) {
+      if (sub.in_use && sub.bd_addr == p_due->bd_addr) sub.in_use = false;
+    }
+  }
+  /* On BTM_BUSY a direct BTM_ReadRSSI user owns the slot; the re-armed
+   * timer retries after the advanced due time */
+  btm_link_metrics_schedule();
+}
+
+tBTM_STATUS BTM_LinkMetricsSubscribe(const RawAddress& remote_bda,
+                                     uint16_t period_ms, tBTM_CMPL_CB* p_cb) {
+  if (btm_metrics.timer == nullptr)
+    btm_metrics.timer = alarm_new("btm.link_metrics_timer");
+
+  tBTM_METRICS_SUB* p_free = nullptr;
+  for (tBTM_METRICS_SUB& sub : btm_metrics.subs) {
+    if (sub.in_use && sub.bd_addr == remote_bda && sub.p_cb == p_cb) {
+      /* Existing subscription: just adopt the new period */
+      sub.period_ms = period_ms;
+      return BTM_CMD_STARTED;
+    }
+    if (!sub.in_use && p_free == nullptr) p_free = &sub;
+  }
+  if (p_free == nullptr) {
+    LOG_WARN("%s no free subscription slot for %s", __func__,
+             remote_bda.ToString().c_str());
+    return BTM_NO_RESOURCES;
+  }
+
+  p_free->bd_addr = remote_bda;
+  p_free->period_ms = period_ms;
+  p_free->next_due_ms = bluetooth::common::time_get_os_boottime_ms();
+  p_free->p_cb = p_cb;
+  p_free->in_use = true;
+
+  btm_link_metrics_poll_due();
+  return BTM_CMD_STARTED;
+}
+
+void BTM_LinkMetricsUnsubscribe(const RawAddress& remote_bda,
+                                tBTM_CMPL_CB* p_cb) {
+  for (tBTM_METRICS_SUB& sub : btm_metrics.subs) {
+    if (sub.in_use && sub.bd_addr == remote_bda && sub.p_cb == p_cb)
+      sub.in_use = false;
+  }
+  btm_link_metrics_schedule();
+}
+
 /*******************************************************************************
  *
  * Function         BTM_ReadFailedContactCounter
@@ -2766,6 +3014,20 @@ void acl_write_automatic_flush_timeout(const RawAddress& bd_addr,
   btsnd_hcic_write_auto_flush_tout(p_acl->hci_handle, flush_timeout_in_ticks);
 }
 
+void BTM_SetAdaptiveFlushTimeout(const RawAddress& bd_addr,
+                                 uint16_t max_latency_ms) {
+  /* While packets age in the controller past what the caller can still use,
+   * bound their lifetime so stale data is flushed instead of delaying live
+   * traffic; restore the infinite timeout once the link recovers. The write
+   * below is cached, so repeated calls with an unchanged verdict are free. */
+  uint16_t flush_timeout_in_ticks = 0; /* no automatic flush */
+  if (L2CA_GetTxLatencyMs(bd_addr, 95) > max_latency_ms) {
+    /* ticks are 0.625 ms */
+    flush_timeout_in_ticks = (uint16_t)(((uint32_t)max_latency_ms * 8) / 5);
+  }
+  acl_write_automatic_flush_timeout(bd_addr, flush_timeout_in_ticks);
+}
+
 bool acl_create_le_connection_with_id(uint8_t id, const RawAddress& bd_addr) {
   if (bluetooth::shim::is_gd_acl_enabled()) {
     tBLE_BD_ADDR address_with_type{
@@ -311,6 +311,15 @@ bool BTM_ReadPowerMode(const RawAddress& remote_bda, tBTM_PM_MODE* p_mode) {
   return true;
 }
 
+uint16_t BTM_GetSniffInterval(const RawAddress& remote_bda) {
+  tBTM_PM_MCB* p_mcb = btm_pm_get_power_manager_from_address(remote_bda);
+  if (p_mcb == nullptr || p_mcb->state != BTM_PM_ST_SNIFF) {
+    return 0;
+  }
+  /* kept current by btm_pm_proc_mode_change */
+  return p_mcb->interval;
+}
+
 /*******************************************************************************
  *
  * Function         BTM_SetSsrParams
@@ -77,6 +77,7 @@ typedef struct {
   uint8_t state;          /* The state machine state */
   uint8_t ch_state;       /* L2CAP channel state */
   BT_HDR* p_rx_msg;       /* Message being reassembled */
+  uint16_t rx_buf_size;   /* Data size of the buffer at p_rx_msg */
   uint16_t conflict_lcid; /* L2CAP channel LCID */
   RawAddress peer_addr;   /* BD address of peer */
   fixed_queue_t* tx_q;    /* Transmit data buffer queue       */
@@ -94,8 +94,20 @@ static BT_HDR* avct_lcb_msg_asmbl(tAVCT_LCB* p_lcb, BT_HDR* p_buf) {
      * Allocate bigger buffer for reassembly. As lower layers are
      * not aware of possible packet size after reassembly, they
      * would have allocated smaller buffer.
+     *
+     * Pre-size it from the number-of-packets field in the start
+     * header: every subsequent fragment carries at most
+     * (kAvrcMtu - AVCT_HDR_LEN_CONT) payload bytes, so one
+     * allocation up front fits the whole message and fragments are
+     * appended in place.
      */
-    p_lcb->p_rx_msg = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+    uint32_t rx_buf_size =
+        sizeof(BT_HDR) + p_buf->offset + p_buf->len +
+        (uint32_t)(*(p + 1)) * (kAvrcMtu - AVCT_HDR_LEN_CONT);
+    if (rx_buf_size > UINT16_MAX) rx_buf_size = UINT16_MAX;
+
+    p_lcb->p_rx_msg = (BT_HDR*)osi_malloc(rx_buf_size);
+    p_lcb->rx_buf_size = (uint16_t)(rx_buf_size - sizeof(BT_HDR));
     memcpy(p_lcb->p_rx_msg, p_buf, sizeof(BT_HDR) + p_buf->offset + p_buf->len);
 
     /* Free original buffer */
@@ -126,9 +138,9 @@ static BT_HDR* avct_lcb_msg_asmbl(tAVCT_LCB* p_lcb, BT_HDR* p_buf) {
       /* get size of buffer holding assembled message */
       /*
        * NOTE: The buffer is allocated above at the beginning of the
-       * reassembly, and is always of size BT_DEFAULT_BUFFER_SIZE.
+       * reassembly, sized from the start header's packet count.
        */
-      uint16_t buf_len = BT_DEFAULT_BUFFER_SIZE - sizeof(BT_HDR);
+      uint16_t buf_len = p_lcb->rx_buf_size;
 
       /* adjust offset and len of fragment for header byte */
       p_buf->offset += AVCT_HDR_LEN_CONT;
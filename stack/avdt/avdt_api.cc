@@ -877,7 +877,22 @@ uint16_t AVDT_WriteReqOpt(uint8_t handle, BT_HDR* p_pkt, uint32_t time_stamp,
     evt.apiwrite.time_stamp = time_stamp;
     evt.apiwrite.m_pt = m_pt;
     evt.apiwrite.opt = opt;
-    avdt_scb_event(p_scb, AVDT_SCB_API_WRITE_REQ_EVT, &evt);
+
+    /* Media packet fast path: in the steady streaming state the state
+     * machine dispatch of AVDT_SCB_API_WRITE_REQ_EVT reduces to
+     * avdt_scb_hdl_write_req() followed by avdt_scb_chk_snd_pkt(), so call
+     * them directly and skip the per-packet table dispatch and the
+     * active-stream scan. Any state transition, congestion or held packet
+     * still goes through avdt_scb_event() and is re-validated there;
+     * curr_stream is only maintained by the state machine, so the first
+     * packet after a stream rearrangement always takes the full path. */
+    if (p_scb->state == AVDT_SCB_STREAM_ST && p_scb->curr_stream &&
+        !p_scb->cong && p_scb->p_pkt == NULL && p_scb->p_ccb != NULL) {
+      avdt_scb_hdl_write_req(p_scb, &evt);
+      avdt_scb_chk_snd_pkt(p_scb, &evt);
+    } else {
+      avdt_scb_event(p_scb, AVDT_SCB_API_WRITE_REQ_EVT, &evt);
+    }
   }
 
   AVDT_TRACE_DEBUG("%s: result=%d avdt_handle=%d", __func__, result, handle);
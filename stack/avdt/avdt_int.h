@@ -415,6 +415,8 @@ class AvdtpScb {
         p_pkt(nullptr),
         p_ccb(nullptr),
         media_seq(0),
+        media_hdr_octet1(0),
+        media_hdr_len(0),
         allocated(false),
         in_use(false),
         role(0),
@@ -464,6 +466,8 @@ class AvdtpScb {
     p_pkt = nullptr;
     p_ccb = nullptr;
     media_seq = 0;
+    media_hdr_octet1 = 0;
+    media_hdr_len = 0;
     allocated = false;
     in_use = false;
     role = 0;
@@ -488,6 +492,8 @@ class AvdtpScb {
   BT_HDR* p_pkt;                     // Packet waiting to be sent
   AvdtpCcb* p_ccb;                   // CCB associated with this SCB
   uint16_t media_seq;                // Media packet sequence number
+  uint8_t media_hdr_octet1;  // First octet of last received media header
+  uint8_t media_hdr_len;     // Cached media header length; 0 when invalid
   bool allocated;                    // True if the SCB is allocated
   bool in_use;                       // True if used by peer
   uint8_t role;        // Initiator/acceptor role in current procedure
@@ -214,6 +214,38 @@ void avdt_scb_hdl_open_rsp(AvdtpScb* p_scb, UNUSED_ATTR tAVDT_SCB_EVT* p_data) {
                      avdt_scb_transport_channel_timer_timeout, p_scb);
 }
 
+/* Fixed 12-octet prefix of the media packet header, overlaid on the
+ * received buffer so the steady-state path can read the per-packet fields
+ * in place instead of re-walking the header byte by byte.  Multi-octet
+ * fields are big-endian on the wire; the accessors below convert.
+ */
+typedef struct {
+  uint8_t octet1; /* V(2) P(1) X(1) CC(4) */
+  uint8_t m_pt;   /* M(1) PT(7) */
+  uint8_t seq[2];
+  uint8_t time_stamp[4];
+  uint8_t ssrc[4];
+} __attribute__((packed)) tAVDT_MEDIA_HDR;
+
+static inline uint16_t avdt_media_hdr_seq(const tAVDT_MEDIA_HDR* p_hdr) {
+  uint16_t v;
+  memcpy(&v, p_hdr->seq, sizeof(v));
+#if !defined(__BYTE_ORDER__) || (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  v = __builtin_bswap16(v);
+#endif
+  return v;
+}
+
+static inline uint32_t avdt_media_hdr_time_stamp(
+    const tAVDT_MEDIA_HDR* p_hdr) {
+  uint32_t v;
+  memcpy(&v, p_hdr->time_stamp, sizeof(v));
+#if !defined(__BYTE_ORDER__) || (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  v = __builtin_bswap32(v);
+#endif
+  return v;
+}
+
 /*******************************************************************************
  *
  * Function         avdt_scb_hdl_pkt_no_frag
@@ -234,13 +266,30 @@ void avdt_scb_hdl_pkt_no_frag(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data) {
   uint16_t ex_len;
   uint8_t pad_len = 0;
   uint16_t len = p_data->p_pkt->len;
+  const tAVDT_MEDIA_HDR* p_hdr;
 
   p = p_start = (uint8_t*)(p_data->p_pkt + 1) + p_data->p_pkt->offset;
 
   /* parse media packet header */
-  offset = 12;
+  offset = AVDT_MEDIA_HDR_SIZE;
   // AVDT_MSG_PRS_OCTET1(1) + AVDT_MSG_PRS_M_PT(1) + UINT16(2) + UINT32(4) + 4
   if (offset > len) goto length_error;
+
+  /* Fast path: back-to-back packets on a stream carry an identical first
+   * octet, and with the padding and extension bits clear the header length
+   * is a constant the slow path already computed and cached on the SCB.
+   * Read the per-packet fields through the overlay and skip the re-parse.
+   */
+  if (p_scb->media_hdr_len != 0 && *p == p_scb->media_hdr_octet1) {
+    p_hdr = (const tAVDT_MEDIA_HDR*)p;
+    marker = (p_hdr->m_pt >> 7) & 0x01;
+    m_pt = p_hdr->m_pt & 0x7F;
+    seq = avdt_media_hdr_seq(p_hdr);
+    time_stamp = avdt_media_hdr_time_stamp(p_hdr);
+    offset = p_scb->media_hdr_len;
+    goto deliver;
+  }
+
   AVDT_MSG_PRS_OCTET1(p, o_v, o_p, o_x, o_cc);
   AVDT_MSG_PRS_M_PT(p, m_pt, marker);
   BE_STREAM_TO_UINT16(seq, p);
@@ -267,6 +316,19 @@ void avdt_scb_hdl_pkt_no_frag(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data) {
     pad_len = *(p_start + p_data->p_pkt->len);
   }
 
+  /* The header length is invariant for the stream only when the padding
+   * and extension bits are clear; the pad length lives at the end of each
+   * packet and the extension length is per-packet too.
+   */
+  if (!o_p && !o_x && offset <= 0xFF) {
+    p_scb->media_hdr_octet1 = *p_start;
+    p_scb->media_hdr_len = (uint8_t)offset;
+  } else {
+    p_scb->media_hdr_len = 0;
+  }
+
+deliver:
+
   /* do sanity check */
   if ((offset > p_data->p_pkt->len) ||
       ((pad_len + offset) > p_data->p_pkt->len)) {
@@ -98,6 +98,7 @@ static void avrc_ctrl_cback(uint8_t handle, uint8_t event, uint16_t result,
   if ((event == AVCT_DISCONNECT_CFM_EVT) ||
       (event == AVCT_DISCONNECT_IND_EVT)) {
     avrc_flush_cmd_q(handle);
+    avrc_flush_frag_q(handle);
     alarm_free(avrc_cb.ccb_int[handle].tle);
     avrc_cb.ccb_int[handle].tle = NULL;
   }
@@ -121,6 +122,24 @@ void avrc_flush_cmd_q(uint8_t handle) {
   avrc_cb.ccb_int[handle].cmd_q = NULL;
 }
 
+/******************************************************************************
+ *
+ * Function         avrc_flush_frag_q
+ *
+ * Description      Flush the pending response fragments for the specified
+ *                  avrc handle
+ *
+ * Returns          Nothing.
+ *
+ *****************************************************************************/
+void avrc_flush_frag_q(uint8_t handle) {
+  AVRC_TRACE_DEBUG("AVRC: Flushing response fragments for handle=0x%02x",
+                   handle);
+  avrc_cb.fcb[handle].frag_enabled = false;
+  fixed_queue_free(avrc_cb.fcb[handle].frag_q, osi_free);
+  avrc_cb.fcb[handle].frag_q = NULL;
+}
+
 /******************************************************************************
  *
  * Function         avrc_process_timeout
@@ -250,95 +269,95 @@ static BT_HDR* avrc_copy_packet(BT_HDR* p_pkt, int rsp_pkt_len) {
 
 /******************************************************************************
  *
- * Function         avrc_prep_end_frag
+ * Function         avrc_prep_frags
  *
- * Description      This function prepares an end response fragment
+ * Description      This function slices an oversized response into right-sized
+ *                  fragment packets, queued to be sent one by one as the peer
+ *                  requests continuations. Each fragment carries a copy of the
+ *                  original AV/C vendor header, so the response type of every
+ *                  fragment matches the original response. Errata:
+ *                  https://www.bluetooth.org/errata/errata_view.cfm?errata_id=4383
+ *                  The original message buffer is freed once the fragments are
+ *                  prepared, so the (typically much larger) builder buffer is
+ *                  not retained for the whole continuation exchange.
  *
- * Returns          Nothing.
+ * Returns          The start fragment, ready to be sent.
  *
  *****************************************************************************/
-static void avrc_prep_end_frag(uint8_t handle) {
-  tAVRC_FRAG_CB* p_fcb;
-  BT_HDR* p_pkt_new;
-  uint8_t *p_data, *p_orig_data;
-  uint8_t rsp_type;
-
-  AVRC_TRACE_DEBUG("%s", __func__);
-  p_fcb = &avrc_cb.fcb[handle];
+static BT_HDR* avrc_prep_frags(uint8_t handle, BT_HDR* p_pkt,
+                               uint8_t* p_start) {
+  tAVRC_FRAG_CB* p_fcb = &avrc_cb.fcb[handle];
+  /* max parameter bytes carried by one fragment */
+  const uint16_t frag_data_len =
+      AVRC_MAX_CTRL_DATA_LEN - AVRC_VENDOR_HDR_SIZE - AVRC_MIN_META_HDR_SIZE;
+  uint8_t* p_orig_hdr = p_start - AVRC_VENDOR_HDR_SIZE;
+  uint8_t* p_param = p_start + AVRC_MIN_META_HDR_SIZE;
+  uint16_t param_len =
+      p_pkt->len - AVRC_VENDOR_HDR_SIZE - AVRC_MIN_META_HDR_SIZE;
+  BT_HDR* p_frag_first = NULL;
+
+  while (param_len > 0) {
+    uint16_t chunk_len =
+        (param_len > frag_data_len) ? frag_data_len : param_len;
+    uint8_t pkt_type = (p_frag_first == NULL)
+                           ? AVRC_PKT_START
+                           : ((chunk_len == param_len) ? AVRC_PKT_END
+                                                       : AVRC_PKT_CONTINUE);
+    BT_HDR* p_frag = (BT_HDR*)osi_calloc(BT_HDR_SIZE + AVCT_MSG_OFFSET +
+                                         AVRC_VENDOR_HDR_SIZE +
+                                         AVRC_MIN_META_HDR_SIZE + chunk_len);
+    p_frag->len = AVRC_VENDOR_HDR_SIZE + AVRC_MIN_META_HDR_SIZE + chunk_len;
+    p_frag->offset = AVCT_MSG_OFFSET;
+    p_frag->layer_specific = p_pkt->layer_specific;
+    p_frag->event = p_pkt->event;
+    uint8_t* p_data = (uint8_t*)(p_frag + 1) + p_frag->offset;
+    memcpy(p_data, p_orig_hdr, AVRC_VENDOR_HDR_SIZE);
+    p_data += AVRC_VENDOR_HDR_SIZE;
+    *p_data++ = p_fcb->frag_pdu;
+    *p_data++ = pkt_type;
+    UINT16_TO_BE_STREAM(p_data, chunk_len);
+    memcpy(p_data, p_param, chunk_len);
+
+    if (p_frag_first == NULL)
+      p_frag_first = p_frag;
+    else
+      fixed_queue_enqueue(p_fcb->frag_q, p_frag);
+
+    p_param += chunk_len;
+    param_len -= chunk_len;
+  }
 
-  /* The response type of the end fragment should be the same as the the PDU of
-   * "End Fragment Response" Errata:
-   * https://www.bluetooth.org/errata/errata_view.cfm?errata_id=4383
-   */
-  p_orig_data = ((uint8_t*)(p_fcb->p_fmsg + 1) + p_fcb->p_fmsg->offset);
-  rsp_type = ((*p_orig_data) & AVRC_CTYPE_MASK);
-
-  p_pkt_new = p_fcb->p_fmsg;
-  p_pkt_new->len -=
-      (AVRC_MAX_CTRL_DATA_LEN - AVRC_VENDOR_HDR_SIZE - AVRC_MIN_META_HDR_SIZE);
-  p_pkt_new->offset +=
-      (AVRC_MAX_CTRL_DATA_LEN - AVRC_VENDOR_HDR_SIZE - AVRC_MIN_META_HDR_SIZE);
-  p_data = (uint8_t*)(p_pkt_new + 1) + p_pkt_new->offset;
-  *p_data++ = rsp_type;
-  *p_data++ = (AVRC_SUB_PANEL << AVRC_SUBTYPE_SHIFT);
-  *p_data++ = AVRC_OP_VENDOR;
-  AVRC_CO_ID_TO_BE_STREAM(p_data, AVRC_CO_METADATA);
-  *p_data++ = p_fcb->frag_pdu;
-  *p_data++ = AVRC_PKT_END;
-
-  /* 4=pdu, pkt_type & len */
-  UINT16_TO_BE_STREAM(
-      p_data, (p_pkt_new->len - AVRC_VENDOR_HDR_SIZE - AVRC_MIN_META_HDR_SIZE));
+  osi_free(p_pkt);
+  return p_frag_first;
 }
 
 /******************************************************************************
  *
  * Function         avrc_send_continue_frag
  *
- * Description      This function sends a continue response fragment
+ * Description      This function sends the next prepared response fragment
  *
  * Returns          AVRC_SUCCESS if successful.
  *                  AVRC_BAD_HANDLE if handle is invalid.
  *
  *****************************************************************************/
 static uint16_t avrc_send_continue_frag(uint8_t handle, uint8_t label) {
-  tAVRC_FRAG_CB* p_fcb;
-  BT_HDR *p_pkt_old, *p_pkt;
-  uint8_t *p_old, *p_data;
-  uint8_t cr = AVCT_RSP;
+  tAVRC_FRAG_CB* p_fcb = &avrc_cb.fcb[handle];
+  BT_HDR* p_pkt = (BT_HDR*)fixed_queue_try_dequeue(p_fcb->frag_q);
 
-  p_fcb = &avrc_cb.fcb[handle];
-  p_pkt = p_fcb->p_fmsg;
+  if (p_pkt == NULL) {
+    AVRC_TRACE_ERROR("%s handle = %u no fragment pending", __func__, handle);
+    p_fcb->frag_enabled = false;
+    return AVRC_NO_RESOURCES;
+  }
 
   AVRC_TRACE_DEBUG("%s handle = %u label = %u len = %d", __func__, handle,
                    label, p_pkt->len);
-  if (p_pkt->len > AVRC_MAX_CTRL_DATA_LEN) {
-    int offset_len = MAX(AVCT_MSG_OFFSET, p_pkt->offset);
-    p_pkt_old = p_fcb->p_fmsg;
-    p_pkt = (BT_HDR*)osi_calloc(AVRC_PACKET_LEN + offset_len + BT_HDR_SIZE);
-    p_pkt->len = AVRC_MAX_CTRL_DATA_LEN;
-    p_pkt->offset = AVCT_MSG_OFFSET;
-    p_pkt->layer_specific = p_pkt_old->layer_specific;
-    p_pkt->event = p_pkt_old->event;
-    p_old = (uint8_t*)(p_pkt_old + 1) + p_pkt_old->offset;
-    p_data = (uint8_t*)(p_pkt + 1) + p_pkt->offset;
-    memcpy(p_data, p_old, AVRC_MAX_CTRL_DATA_LEN);
-    /* use AVRC continue packet type */
-    p_data += AVRC_VENDOR_HDR_SIZE;
-    p_data++; /* pdu */
-    *p_data++ = AVRC_PKT_CONTINUE;
-    /* 4=pdu, pkt_type & len */
-    UINT16_TO_BE_STREAM(p_data,
-                        (AVRC_MAX_CTRL_DATA_LEN - AVRC_VENDOR_HDR_SIZE - 4));
-
-    /* prepare the left over for as an end fragment */
-    avrc_prep_end_frag(handle);
-  } else {
-    /* end fragment. clean the control block */
+  if (fixed_queue_is_empty(p_fcb->frag_q)) {
+    /* sending the end fragment. clean the control block */
     p_fcb->frag_enabled = false;
-    p_fcb->p_fmsg = NULL;
   }
-  return AVCT_MsgReq(handle, label, cr, p_pkt);
+  return AVCT_MsgReq(handle, label, AVCT_RSP, p_pkt);
 }
 
 /******************************************************************************
@@ -419,7 +438,7 @@ static BT_HDR* avrc_proc_vendor_command(uint8_t handle, uint8_t label,
     }
 
     if (abort_frag) {
-      osi_free_and_reset((void**)&p_fcb->p_fmsg);
+      fixed_queue_flush(p_fcb->frag_q, osi_free);
       p_fcb->frag_enabled = false;
     }
   }
@@ -1043,6 +1062,7 @@ uint16_t AVRC_Open(uint8_t* p_handle, tAVRC_CONN_CB* p_ccb,
     memset(&avrc_cb.rcb[*p_handle], 0, sizeof(tAVRC_RASM_CB));
     avrc_cb.ccb_int[*p_handle].tle = alarm_new("avrcp.commandTimer");
     avrc_cb.ccb_int[*p_handle].cmd_q = fixed_queue_new(SIZE_MAX);
+    avrc_cb.fcb[*p_handle].frag_q = fixed_queue_new(SIZE_MAX);
   }
   AVRC_TRACE_DEBUG("%s role: %d, control:%d status:%d, handle:%d", __func__,
                    cc.role, cc.control, status, *p_handle);
@@ -1071,6 +1091,7 @@ uint16_t AVRC_Open(uint8_t* p_handle, tAVRC_CONN_CB* p_ccb,
 uint16_t AVRC_Close(uint8_t handle) {
   AVRC_TRACE_DEBUG("%s handle:%d", __func__, handle);
   avrc_flush_cmd_q(handle);
+  avrc_flush_frag_q(handle);
   return AVCT_RemoveConn(handle);
 }
 
@@ -1132,7 +1153,6 @@ uint16_t AVRC_MsgReq(uint8_t handle, uint8_t label, uint8_t ctype,
   bool chk_frag = true;
   uint8_t* p_start = NULL;
   tAVRC_FRAG_CB* p_fcb;
-  uint16_t len;
   uint16_t status;
   uint8_t msg_mask = 0;
   uint16_t peer_mtu;
@@ -1208,43 +1228,21 @@ uint16_t AVRC_MsgReq(uint8_t handle, uint8_t label, uint8_t ctype,
 
   if (p_fcb->frag_enabled) p_fcb->frag_enabled = false;
 
-  osi_free_and_reset((void**)&p_fcb->p_fmsg);
+  fixed_queue_flush(p_fcb->frag_q, osi_free);
 
   /* AVRCP spec has not defined any control channel commands that needs
    * fragmentation at this level
    * check for fragmentation only on the response */
   if ((cr == AVCT_RSP) && (chk_frag)) {
     if (p_pkt->len > AVRC_MAX_CTRL_DATA_LEN) {
-      int offset_len = MAX(AVCT_MSG_OFFSET, p_pkt->offset);
-      BT_HDR* p_pkt_new =
-          (BT_HDR*)osi_calloc(AVRC_PACKET_LEN + offset_len + BT_HDR_SIZE);
       if (p_start != NULL) {
         p_fcb->frag_enabled = true;
-        p_fcb->p_fmsg = p_pkt;
         p_fcb->frag_pdu = *p_start;
-        p_pkt = p_pkt_new;
-        p_pkt_new = p_fcb->p_fmsg;
-        p_pkt->len = AVRC_MAX_CTRL_DATA_LEN;
-        p_pkt->offset = p_pkt_new->offset;
-        p_pkt->layer_specific = p_pkt_new->layer_specific;
-        p_pkt->event = p_pkt_new->event;
-        p_data = (uint8_t*)(p_pkt + 1) + p_pkt->offset;
-        p_start -= AVRC_VENDOR_HDR_SIZE;
-        memcpy(p_data, p_start, AVRC_MAX_CTRL_DATA_LEN);
-        /* use AVRC start packet type */
-        p_data += AVRC_VENDOR_HDR_SIZE;
-        p_data++; /* pdu */
-        *p_data++ = AVRC_PKT_START;
-
-        /* 4 pdu, pkt_type & len */
-        len = (AVRC_MAX_CTRL_DATA_LEN - AVRC_VENDOR_HDR_SIZE -
-               AVRC_MIN_META_HDR_SIZE);
-        UINT16_TO_BE_STREAM(p_data, len);
-
-        /* prepare the left over for as an end fragment */
-        avrc_prep_end_frag(handle);
-        AVRC_TRACE_DEBUG("%s p_pkt len:%d/%d, next len:%d", __func__,
-                         p_pkt->len, len, p_fcb->p_fmsg->len);
+        /* slice the message into right-sized fragments up front; the
+         * continuation requests are then served straight from the queue */
+        p_pkt = avrc_prep_frags(handle, p_pkt, p_start);
+        AVRC_TRACE_DEBUG("%s p_pkt len:%d, %zu fragments pending", __func__,
+                         p_pkt->len, fixed_queue_length(p_fcb->frag_q));
       } else {
         /* TODO: Is this "else" block valid? Remove it? */
         AVRC_TRACE_ERROR("%s no buffers for fragmentation", __func__);
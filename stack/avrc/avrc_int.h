@@ -120,9 +120,9 @@
 
 /* type for Metadata fragmentation control block */
 typedef struct {
-  BT_HDR* p_fmsg;    /* the fragmented message */
-  uint8_t frag_pdu;  /* the PDU ID for fragmentation */
-  bool frag_enabled; /* fragmentation flag */
+  fixed_queue_t* frag_q; /* fragments awaiting continuation requests */
+  uint8_t frag_pdu;      /* the PDU ID for fragmentation */
+  bool frag_enabled;     /* fragmentation flag */
 } tAVRC_FRAG_CB;
 
 /* type for Metadata re-assembly control block */
@@ -166,6 +166,7 @@ extern tAVRC_STS avrc_pars_pass_thru(tAVRC_MSG_PASS* p_msg,
 extern uint8_t avrc_opcode_from_pdu(uint8_t pdu);
 extern bool avrc_is_valid_opcode(uint8_t opcode);
 extern void avrc_flush_cmd_q(uint8_t handle);
+extern void avrc_flush_frag_q(uint8_t handle);
 void avrc_start_cmd_timer(uint8_t handle, uint8_t label, uint8_t msg_mask);
 void avrc_send_next_vendor_cmd(uint8_t handle);
 
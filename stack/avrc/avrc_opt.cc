@@ -51,7 +51,10 @@ static BT_HDR* avrc_vendor_msg(tAVRC_MSG_VENDOR* p_msg) {
   CHECK(p_msg != NULL);
 
   CHECK(AVRC_META_CMD_BUF_SIZE > (AVRC_MIN_CMD_LEN + p_msg->vendor_len));
-  p_cmd = (BT_HDR*)osi_calloc(AVRC_META_CMD_BUF_SIZE);
+  /* the command length is known up front, so right-size the buffer instead
+   * of allocating the maximum metadata command size */
+  p_cmd = (BT_HDR*)osi_calloc(BT_HDR_SIZE + AVCT_MSG_OFFSET +
+                              AVRC_VENDOR_HDR_SIZE + p_msg->vendor_len);
 
   p_cmd->offset = AVCT_MSG_OFFSET;
   p_data = (uint8_t*)(p_cmd + 1) + p_cmd->offset;
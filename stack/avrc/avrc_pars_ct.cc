@@ -278,6 +278,11 @@ static tAVRC_STS avrc_pars_browse_rsp(tAVRC_MSG_BROWSE* p_msg,
           __func__, get_item_rsp->pdu, get_item_rsp->status, pkt_len,
           get_item_rsp->uid_counter, get_item_rsp->item_count);
 
+      /* bound the allocation by what the payload can actually hold;
+       * each item takes at least 3 octets (type + length) */
+      if (get_item_rsp->item_count > (pkt_len - min_len) / 3)
+        goto browse_length_error;
+
       /* get each of the items */
       get_item_rsp->p_item_list = (tAVRC_ITEM*)osi_malloc(
           get_item_rsp->item_count * (sizeof(tAVRC_ITEM)));
@@ -369,6 +374,10 @@ static tAVRC_STS avrc_pars_browse_rsp(tAVRC_MSG_BROWSE* p_msg,
                              __func__, media->type, media->name.charset_id,
                              media->name.str_len, media->attr_count);
 
+            /* each attribute entry takes at least 8 octets */
+            if (media->attr_count > (pkt_len - min_len) / 8)
+              goto browse_length_error;
+
             media->p_attr_list = (tAVRC_ATTR_ENTRY*)osi_malloc(
                 media->attr_count * sizeof(tAVRC_ATTR_ENTRY));
             for (int jk = 0; jk < media->attr_count; jk++) {
@@ -435,6 +444,9 @@ static tAVRC_STS avrc_pars_browse_rsp(tAVRC_MSG_BROWSE* p_msg,
       }
       BE_STREAM_TO_UINT8(get_attr_rsp->status, p)
       BE_STREAM_TO_UINT8(get_attr_rsp->num_attrs, p);
+      /* each attribute entry takes at least 8 octets */
+      if (get_attr_rsp->num_attrs > (pkt_len - min_len) / 8)
+        goto browse_length_error;
       get_attr_rsp->p_attrs = (tAVRC_ATTR_ENTRY*)osi_malloc(
           get_attr_rsp->num_attrs * sizeof(tAVRC_ATTR_ENTRY));
       for (int i = 0; i < get_attr_rsp->num_attrs; i++) {
@@ -481,6 +493,10 @@ static tAVRC_STS avrc_pars_browse_rsp(tAVRC_MSG_BROWSE* p_msg,
           __func__, set_br_pl_rsp->status, set_br_pl_rsp->num_items,
           set_br_pl_rsp->charset_id, set_br_pl_rsp->folder_depth);
 
+      /* each folder name takes at least a 2 octet length */
+      if (set_br_pl_rsp->folder_depth > (pkt_len - min_len) / 2)
+        goto browse_length_error;
+
       set_br_pl_rsp->p_folders = (tAVRC_NAME*)osi_malloc(
           set_br_pl_rsp->folder_depth * sizeof(tAVRC_NAME));
 
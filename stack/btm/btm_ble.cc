@@ -40,6 +40,7 @@
 #include "stack/include/btm_api.h"
 #include "stack/include/btu.h"
 #include "stack/include/gatt_api.h"
+#include "stack/include/l2cap_hci_link_interface.h"
 #include "stack/include/l2cap_security_interface.h"
 #include "stack/include/l2cdefs.h"
 #include "stack/include/smp_api.h"
@@ -1155,6 +1156,8 @@ void btm_sec_save_le_key(const RawAddress& bd_addr, tBTM_LE_KEY_TYPE key_type,
             p_keys->pid_key.identity_addr_type);
         /* update device record address as identity address */
         p_rec->bd_addr = p_keys->pid_key.identity_addr;
+        /* a new IRK can resolve RPAs cached as unresolvable */
+        btm_ble_resolve_cache_invalidate();
         /* combine DUMO device security record if needed */
         btm_consolidate_dev(p_rec);
         break;
@@ -1217,6 +1220,9 @@ void btm_sec_save_le_key(const RawAddress& bd_addr, tBTM_LE_KEY_TYPE key_type,
     VLOG(1) << "BLE key type 0x" << loghex(key_type)
             << " updated for BDA: " << bd_addr << " (btm_sec_save_le_key)";
 
+    /* the LE bond state may just have changed */
+    btm_sec_bond_snapshot_publish();
+
     /* Notify the application that one of the BLE keys has been updated
        If link key is in progress, it will get sent later.*/
     if (pass_to_application && btm_cb.api.p_le_callback) {
@@ -1528,6 +1534,10 @@ void btm_ble_link_encrypted(const RawAddress& bd_addr, uint8_t encr_enable) {
   }
   /* to notify GATT to send data if any request is pending */
   gatt_notify_enc_cmpl(p_dev_rec->ble.pseudo_addr);
+
+  /* encryption was the last bring-up gate; let L2CAP pipeline the link
+   * level negotiations so first data rides a fully negotiated link */
+  if (encr_enable) l2cble_post_encryption_bringup(p_dev_rec->ble.pseudo_addr);
 }
 
 /*******************************************************************************
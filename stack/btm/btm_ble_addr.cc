@@ -32,6 +32,8 @@
 #include "hcimsgs.h"
 
 #include "btm_ble_int.h"
+#include "common/lru.h"
+#include "common/time_util.h"
 #include "main/shim/shim.h"
 #include "stack/btm/btm_dev.h"
 #include "stack/crypto_toolbox/crypto_toolbox.h"
@@ -206,15 +208,61 @@ static bool btm_ble_match_random_bda(void* data, void* context) {
   return true;
 }
 
+/* Cache of host-side RPA resolutions. When the controller resolving list is
+ * full, every ADV report carrying an unknown RPA costs one AES run per bonded
+ * device with an IRK; a peer keeps the same RPA for a full rotation period, so
+ * repeated reports resolve to the same answer. Unresolvable addresses are
+ * cached as well (with an empty identity address), which is where most of the
+ * crypto is burned in dense environments. Entries expire after the minimum
+ * RPA rotation interval and the whole cache is dropped whenever an IRK is
+ * added or a bond is removed (btm_ble_resolve_cache_invalidate). */
+constexpr size_t kRpaResolveCacheCapacity = 128;
+/* matches interval_min_ms in btm_get_next_private_addrress_interval_ms() */
+constexpr uint64_t kRpaResolveCacheValidityMs = (7 * 60 * 1000);
+
+struct tBTM_BLE_RPA_RESOLVE_ENTRY {
+  RawAddress identity_addr; /* RawAddress::kEmpty when not resolvable */
+  uint64_t resolved_at_ms;
+};
+
+static bluetooth::common::LegacyLruCache<RawAddress,
+                                         tBTM_BLE_RPA_RESOLVE_ENTRY>
+    rpa_resolve_cache(kRpaResolveCacheCapacity, "btm_rpa_resolve_cache");
+
+/** Drop all cached RPA resolutions; called whenever the IRK set changes */
+void btm_ble_resolve_cache_invalidate(void) { rpa_resolve_cache.Clear(); }
+
 /** This function is called to resolve a random address.
  * Returns pointer to the security record of the device whom a random address is
  * matched to.
  */
 tBTM_SEC_DEV_REC* btm_ble_resolve_random_addr(const RawAddress& random_bda) {
+  tBTM_BLE_RPA_RESOLVE_ENTRY* entry = rpa_resolve_cache.Find(random_bda);
+  if (entry != nullptr) {
+    if (bluetooth::common::time_get_os_boottime_ms() - entry->resolved_at_ms <
+        kRpaResolveCacheValidityMs) {
+      if (entry->identity_addr.IsEmpty()) return nullptr;
+      tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(entry->identity_addr);
+      if (p_dev_rec != nullptr &&
+          (p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) &&
+          (p_dev_rec->ble.key_type & BTM_LE_KEY_PID)) {
+        return p_dev_rec;
+      }
+    }
+    rpa_resolve_cache.Remove(random_bda);
+  }
+
   list_node_t* n = list_foreach(btm_cb.sec_dev_rec, btm_ble_match_random_bda,
                                 (void*)&random_bda);
-  return (n == nullptr) ? (nullptr)
-                        : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+  tBTM_SEC_DEV_REC* p_dev_rec =
+      (n == nullptr) ? (nullptr)
+                     : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+
+  rpa_resolve_cache.Put(
+      random_bda,
+      {(p_dev_rec == nullptr) ? RawAddress::kEmpty : p_dev_rec->bd_addr,
+       bluetooth::common::time_get_os_boottime_ms()});
+  return p_dev_rec;
 }
 
 /*******************************************************************************
@@ -160,6 +160,41 @@ class AdvertisingCache {
  * on secondary channel */
 AdvertisingCache cache;
 
+/* Open-addressing filter that suppresses repeated advertising reports carrying
+ * unchanged data. Beacons repeat the same frame many times per second; each
+ * repetition would otherwise be fully parsed and delivered through the result
+ * callbacks. An entry records the last time a (address, event type, data)
+ * combination was seen; a report matching an entry younger than
+ * BTM_BLE_ADV_DEDUP_WINDOW_MS is dropped. The filter is best-effort - probing
+ * is bounded and collisions merely let a duplicate through. */
+constexpr size_t kAdvDedupTableSize = 64; /* power of 2 */
+constexpr size_t kAdvDedupMaxProbes = 4;
+
+struct tBTM_BLE_ADV_DEDUP_ENT {
+  RawAddress bda;
+  uint32_t data_hash;
+  uint64_t last_seen_ms;
+  uint16_t evt_type;
+  uint8_t addr_type;
+  bool in_use;
+};
+
+tBTM_BLE_ADV_DEDUP_ENT adv_dedup_table[kAdvDedupTableSize];
+
+/* 32 bit FNV-1a over address type, address and advertising data */
+uint32_t adv_dedup_hash(uint8_t addr_type, const RawAddress& bda,
+                        uint8_t data_len, const uint8_t* data) {
+  uint32_t hash = 0x811c9dc5;
+  auto mix = [&hash](uint8_t octet) {
+    hash ^= octet;
+    hash *= 0x01000193;
+  };
+  mix(addr_type);
+  for (uint8_t octet : bda.address) mix(octet);
+  for (uint8_t i = 0; i < data_len; i++) mix(data[i]);
+  return hash;
+}
+
 }  // namespace
 
 #if (BLE_VND_INCLUDED == TRUE)
@@ -217,6 +252,51 @@ static uint8_t ble_evt_type_data_status(uint16_t evt_type) {
   return (evt_type >> 5) & 3;
 }
 
+/* Forget all suppressed advertisers, e.g. when a new scan starts */
+static void btm_ble_adv_dedup_reset(void) {
+  for (size_t i = 0; i < kAdvDedupTableSize; i++)
+    adv_dedup_table[i].in_use = false;
+}
+
+/* Returns true if an identical report from |bda| was already processed within
+ * the dedup window. Fragments and scan responses are never suppressed; they
+ * feed the reassembly state in |cache| and must all be observed. */
+static bool btm_ble_adv_report_is_dup(uint16_t evt_type, uint8_t addr_type,
+                                      const RawAddress& bda, uint8_t data_len,
+                                      const uint8_t* data) {
+  if (BTM_BLE_ADV_DEDUP_WINDOW_MS == 0) return false;
+  if (ble_evt_type_data_status(evt_type) == 0x01) return false;
+  if (ble_evt_type_is_scan_resp(evt_type)) return false;
+
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  uint32_t hash = adv_dedup_hash(addr_type, bda, data_len, data);
+
+  tBTM_BLE_ADV_DEDUP_ENT* victim = nullptr;
+  for (size_t probe = 0; probe < kAdvDedupMaxProbes; probe++) {
+    tBTM_BLE_ADV_DEDUP_ENT& ent =
+        adv_dedup_table[(hash + probe) & (kAdvDedupTableSize - 1)];
+    if (ent.in_use && ent.bda == bda && ent.addr_type == addr_type &&
+        ent.evt_type == evt_type && ent.data_hash == hash) {
+      if (now_ms - ent.last_seen_ms < BTM_BLE_ADV_DEDUP_WINDOW_MS) return true;
+      /* window elapsed, let this report through and restart the window */
+      ent.last_seen_ms = now_ms;
+      return false;
+    }
+    if (victim == nullptr || !ent.in_use ||
+        (victim->in_use && ent.last_seen_ms < victim->last_seen_ms)) {
+      victim = &ent;
+    }
+  }
+
+  victim->bda = bda;
+  victim->data_hash = hash;
+  victim->last_seen_ms = now_ms;
+  victim->evt_type = evt_type;
+  victim->addr_type = addr_type;
+  victim->in_use = true;
+  return false;
+}
+
 constexpr uint8_t UNSUPPORTED = 255;
 
 /* LE states combo bit to check */
@@ -1622,9 +1702,12 @@ void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
 
   p_i->inq_count = p_inq->inq_counter; /* Mark entry for current inquiry */
 
+  /* index the AD structures once instead of rescanning |data| per field */
+  AdvertiseDataIndex data_index(data);
+
   if (!data.empty()) {
     const uint8_t* p_flag =
-        AdvertiseDataParser::GetFieldByType(data, BTM_BLE_AD_TYPE_FLAG, &len);
+        data_index.GetFieldByType(BTM_BLE_AD_TYPE_FLAG, &len);
     if (p_flag != NULL && len != 0) p_cur->flag = *p_flag;
   }
 
@@ -1636,14 +1719,13 @@ void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
      * Otherwise fall back to trying to infer if it is a HID device based on the
      * service class.
      */
-    const uint8_t* p_uuid16 = AdvertiseDataParser::GetFieldByType(
-        data, BTM_BLE_AD_TYPE_APPEARANCE, &len);
+    const uint8_t* p_uuid16 =
+        data_index.GetFieldByType(BTM_BLE_AD_TYPE_APPEARANCE, &len);
     if (p_uuid16 && len == 2) {
       btm_ble_appearance_to_cod((uint16_t)p_uuid16[0] | (p_uuid16[1] << 8),
                                 p_cur->dev_class);
     } else {
-      p_uuid16 = AdvertiseDataParser::GetFieldByType(
-          data, BTM_BLE_AD_TYPE_16SRV_CMPL, &len);
+      p_uuid16 = data_index.GetFieldByType(BTM_BLE_AD_TYPE_16SRV_CMPL, &len);
       if (p_uuid16 != NULL) {
         uint8_t i;
         for (i = 0; i + 2 <= len; i = i + 2) {
@@ -1886,6 +1968,9 @@ void btm_ble_process_adv_pkt_cont(uint16_t evt_type, uint8_t addr_type,
   tBTM_INQUIRY_VAR_ST* p_inq = &btm_cb.btm_inq_vars;
   bool update = true;
 
+  if (btm_ble_adv_report_is_dup(evt_type, addr_type, bda, data_len, data))
+    return;
+
   std::vector<uint8_t> tmp;
   if (data_len != 0) tmp.insert(tmp.begin(), data, data + data_len);
 
@@ -2093,6 +2178,8 @@ void btm_ble_process_phy_update_pkt(uint8_t len, uint8_t* data) {
  ******************************************************************************/
 void btm_ble_start_scan() {
   tBTM_BLE_INQ_CB* p_inq = &btm_cb.ble_ctr_cb.inq_var;
+  /* a fresh scan must report every advertiser at least once */
+  btm_ble_adv_dedup_reset();
   /* start scan, disable duplicate filtering */
   btm_send_hci_scan_enable(BTM_BLE_SCAN_ENABLE, BTM_BLE_DUPLICATE_DISABLE);
 
@@ -26,6 +26,7 @@
 #include "btm_int_types.h"
 #include "stack/btm/btm_ble_int.h"
 
+#include <stdio.h>
 #include <string.h>
 #include <queue>
 #include <vector>
@@ -57,6 +58,27 @@ bool is_connectable(uint16_t advertising_event_properties) {
   return advertising_event_properties & 0x01;
 }
 
+bool is_scannable(uint16_t advertising_event_properties) {
+  return advertising_event_properties & 0x02;
+}
+
+/* The controller schedules each advertising set on its own; the only
+ * scheduling lever the host has is the interval range it programs. Sets
+ * programmed with identical intervals stay phase-locked, so their events
+ * collide on every cycle. Spread concurrent sets across distinct interval
+ * "lanes" inside the caller's [min, max] range - the relative phase of any
+ * two sets then drifts and a collision shears apart within a few cycles.
+ * One lane step is 1.25 ms. */
+constexpr uint32_t ADV_INTERVAL_LANE_STEP = 2; /* 2 * 0.625 ms */
+
+uint32_t select_advertising_lane(uint8_t inst_id, uint32_t adv_int_min,
+                                 uint32_t adv_int_max) {
+  if (adv_int_max <= adv_int_min) return adv_int_min;
+
+  uint32_t span = adv_int_max - adv_int_min;
+  return adv_int_min + (inst_id * ADV_INTERVAL_LANE_STEP) % (span + 1);
+}
+
 struct AdvertisingInstance {
   uint8_t inst_id;
   bool in_use;
@@ -72,6 +94,21 @@ struct AdvertisingInstance {
   bool address_update_required;
   bool periodic_enabled;
   uint32_t advertising_interval;  // 1 unit is 0.625 ms
+  uint16_t adv_data_len;
+  uint16_t scan_rsp_len;
+
+  /* Last data programmed into the controller for this set, kept so a
+   * SetData whose final payload is identical can skip the HCI write (and
+   * the advertising pause it causes on some controllers) entirely. The
+   * valid flags are cleared whenever a write fails or the set is released,
+   * so a stale image can never suppress a needed write. */
+  std::vector<uint8_t> last_adv_data;
+  std::vector<uint8_t> last_scan_rsp_data;
+  bool last_adv_data_valid;
+  bool last_scan_rsp_data_valid;
+  /* Bumped every time this slot is handed to a new advertiser, so a write
+   * completion from a previous owner can be recognized and ignored. */
+  uint32_t registration_generation;
 
   /* When true, advertising set is enabled, or last scheduled call to "LE Set
    * Extended Advertising Set Enable" is to enable this advertising set. Any
@@ -100,6 +137,12 @@ struct AdvertisingInstance {
         own_address(RawAddress::kEmpty),
         address_update_required(false),
         periodic_enabled(false),
+        advertising_interval(0),
+        adv_data_len(0),
+        scan_rsp_len(0),
+        last_adv_data_valid(false),
+        last_scan_rsp_data_valid(false),
+        registration_generation(0),
         enable_status(false) {
     adv_raddr_timer = alarm_new_periodic("btm_ble.adv_raddr_timer");
   }
@@ -246,6 +289,11 @@ class BleAdvertisingManagerImpl
       if (p_inst->in_use) continue;
 
       p_inst->in_use = true;
+      p_inst->registration_generation++;
+      /* A reused slot must not inherit the previous owner's data image, or
+       * a new advertiser with byte-identical data would skip the write. */
+      p_inst->last_adv_data_valid = false;
+      p_inst->last_scan_rsp_data_valid = false;
 
       // set up periodic timer to update address.
       if (BTM_BleLocalPrivacyEnabled()) {
@@ -352,6 +400,16 @@ class BleAdvertisingManagerImpl
                   return;
                 }
 
+                if (c->scan_response_data.empty() &&
+                    !is_scannable(c->params.advertising_event_properties)) {
+                  /* a non-scannable set has nothing to answer scans with -
+                   * skip the scan response command to trim per-set bring-up
+                   * command load */
+                  c->self->adv_inst[c->inst_id].scan_rsp_len = 0;
+                  c->self->Enable(c->inst_id, true, c->cb, c->duration, 0, std::move(c->timeout_cb));
+                  return;
+                }
+
                 c->self->SetData(c->inst_id, true, std::move(c->scan_response_data), Bind(
                   [](c_type c, uint8_t status) {
                     if (!c->self) {
@@ -477,6 +535,20 @@ class BleAdvertisingManagerImpl
                 return;
               }
 
+              if (c->scan_response_data.empty() &&
+                  !is_scannable(c->params.advertising_event_properties)) {
+                /* non-scannable set with no scan response payload; skip the
+                 * scan response command */
+                c->self->adv_inst[c->inst_id].scan_rsp_len = 0;
+                auto self = c->self;
+                if (c->periodic_params.enable) {
+                  self->StartAdvertisingSetPeriodicPart(std::move(c));
+                } else {
+                  self->StartAdvertisingSetFinish(std::move(c));
+                }
+                return;
+              }
+
               c->self->SetData(
                   c->inst_id, true, std::move(c->scan_response_data),
                   Bind(
@@ -690,7 +762,13 @@ class BleAdvertisingManagerImpl
     p_inst->advertising_event_properties =
         p_params->advertising_event_properties;
     p_inst->tx_power = p_params->tx_power;
-    p_inst->advertising_interval = p_params->adv_int_min;
+
+    /* Place this set on its own interval lane. Programming the lane value
+     * as both minimum and maximum keeps the controller from collapsing
+     * concurrent sets back onto the same schedule. */
+    uint32_t adv_interval = select_advertising_lane(
+        p_inst->inst_id, p_params->adv_int_min, p_params->adv_int_max);
+    p_inst->advertising_interval = adv_interval;
     const RawAddress& peer_address = RawAddress::kEmpty;
 
     // sid must be in range 0x00 to 0x0F. Since no controller supports more than
@@ -698,8 +776,8 @@ class BleAdvertisingManagerImpl
     uint8_t sid = p_inst->inst_id % 0x0F;
 
     GetHciInterface()->SetParameters(
-        p_inst->inst_id, p_params->advertising_event_properties,
-        p_params->adv_int_min, p_params->adv_int_max, p_params->channel_map,
+        p_inst->inst_id, p_params->advertising_event_properties, adv_interval,
+        adv_interval, p_params->channel_map,
         p_inst->own_address_type, p_inst->own_address, 0x00, peer_address,
         p_params->adv_filter_policy, p_inst->tx_power,
         p_params->primary_advertising_phy, 0x00,
@@ -745,13 +823,60 @@ class BleAdvertisingManagerImpl
       i += data[i] + 1;
     }
 
+    if (is_scan_rsp)
+      p_inst->scan_rsp_len = data.size();
+    else
+      p_inst->adv_data_len = data.size();
+
     VLOG(1) << "data is: " << base::HexEncode(data.data(), data.size());
+
+    /* Skip the write when the controller already has this exact payload;
+     * frequent re-setters (flags or tx power rewrites, beacon refreshes
+     * that resolve to the same bytes) otherwise retransmit the whole data
+     * and needlessly pause the set on some controllers. */
+    const std::vector<uint8_t>& last =
+        is_scan_rsp ? p_inst->last_scan_rsp_data : p_inst->last_adv_data;
+    bool last_valid = is_scan_rsp ? p_inst->last_scan_rsp_data_valid
+                                  : p_inst->last_adv_data_valid;
+    if (last_valid && data == last) {
+      VLOG(1) << __func__ << " data unchanged, skipping write";
+      cb.Run(0);
+      return;
+    }
+
+    MultiAdvCb record_cb =
+        Bind(&BleAdvertisingManagerImpl::OnDataProgrammed,
+             weak_factory_.GetWeakPtr(), is_scan_rsp, inst_id,
+             p_inst->registration_generation, data, cb);
     DivideAndSendData(
-        inst_id, data, cb,
+        inst_id, std::move(data), std::move(record_cb),
         base::Bind(&BleAdvertisingManagerImpl::SetDataAdvDataSender,
                    weak_factory_.GetWeakPtr(), is_scan_rsp));
   }
 
+  /* Remembers the data image the controller holds once a SetData write
+   * chain finished, so identical follow-up writes can be elided. */
+  void OnDataProgrammed(uint8_t is_scan_rsp, uint8_t inst_id,
+                        uint32_t generation, std::vector<uint8_t> data,
+                        MultiAdvCb cb, uint8_t status) {
+    AdvertisingInstance* p_inst = &adv_inst[inst_id];
+    /* The set may have been unregistered (and even re-registered) while the
+     * write chain was in flight; recording against the new owner would
+     * validate an image it never programmed. */
+    if (!p_inst->in_use || p_inst->registration_generation != generation) {
+      cb.Run(status);
+      return;
+    }
+    if (is_scan_rsp) {
+      p_inst->last_scan_rsp_data_valid = (status == 0);
+      p_inst->last_scan_rsp_data = std::move(data);
+    } else {
+      p_inst->last_adv_data_valid = (status == 0);
+      p_inst->last_adv_data = std::move(data);
+    }
+    cb.Run(status);
+  }
+
   void SetDataAdvDataSender(uint8_t is_scan_rsp, uint8_t inst_id,
                             uint8_t operation, uint8_t length, uint8_t* data,
                             MultiAdvCb cb) {
@@ -874,6 +999,8 @@ class BleAdvertisingManagerImpl
 
     alarm_cancel(p_inst->adv_raddr_timer);
     p_inst->in_use = false;
+    p_inst->last_adv_data_valid = false;
+    p_inst->last_scan_rsp_data_valid = false;
     GetHciInterface()->RemoveAdvertisingSet(inst_id, base::DoNothing());
     p_inst->address_update_required = false;
   }
@@ -988,6 +1115,33 @@ class BleAdvertisingManagerImpl
     return weak_factory_.GetWeakPtr();
   }
 
+  /* Report per-set state and a rough airtime estimate to dumpsys. */
+  void Dump(int fd) {
+    dprintf(fd, "\nBLE advertising sets:\n");
+    AdvertisingInstance* p_inst = &adv_inst[0];
+    for (uint8_t i = 0; i < inst_count; i++, p_inst++) {
+      if (!p_inst->in_use) continue;
+
+      /* An advertising event touches three primary channels; per channel
+       * count roughly 10 bytes of access address, header and CRC overhead
+       * plus the payload, at 8 us per byte on the 1M PHY. */
+      uint32_t event_us = 3 * 8 * (10 + p_inst->adv_data_len);
+      uint32_t interval_us = p_inst->advertising_interval * 625;
+      uint32_t airtime_permille =
+          interval_us ? (event_us * 1000) / interval_us : 0;
+
+      dprintf(fd,
+              "  set %d: %s, props=0x%02x, interval=%u slots, "
+              "adv_data=%u bytes, scan_rsp=%u bytes, est airtime=%u.%u%%\n",
+              p_inst->inst_id,
+              p_inst->enable_status ? "enabled" : "disabled",
+              p_inst->advertising_event_properties,
+              p_inst->advertising_interval, p_inst->adv_data_len,
+              p_inst->scan_rsp_len, airtime_permille / 10,
+              airtime_permille % 10);
+    }
+  }
+
   void CancelAdvAlarms() {
     AdvertisingInstance* p_inst = &adv_inst[0];
     for (uint8_t i = 0; i < inst_count; i++, p_inst++) {
@@ -1067,6 +1221,22 @@ void btm_ble_multi_adv_cleanup(void) {
   BleAdvertiserHciInterface::CleanUp();
 }
 
+/*******************************************************************************
+ *
+ * Function         btm_ble_multi_adv_dump
+ *
+ * Description      This function dumps per-set advertising state and the
+ *                  estimated airtime of each set for debugging.
+ *
+ * Parameters       fd: file descriptor receiving the dump
+ * Returns          void
+ *
+ ******************************************************************************/
+void btm_ble_multi_adv_dump(int fd) {
+  BleAdvertisingManagerImpl* ptr = instance_weakptr.get();
+  if (ptr) ptr->Dump(fd);
+}
+
 // TODO(jpawlowski): Find a nicer way to test RecomputeTimeout without exposing
 // AdvertisingInstance
 bool timeout_triggered = false;
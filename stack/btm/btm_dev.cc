@@ -27,6 +27,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include "bt_common.h"
 #include "bt_types.h"
 #include "btm_api.h"
@@ -42,6 +46,104 @@
 
 extern tBTM_CB btm_cb;
 
+/* Address-keyed index over btm_cb.sec_dev_rec. Records are reachable through
+ * several addresses (BR/EDR address, LE pseudo address, resolved RPAs), so the
+ * index is filled lazily: btm_find_dev() memoizes every address it resolved
+ * with the full list walk. Entries are verified against the record on every
+ * hit and dropped when a record was re-addressed (e.g. by
+ * btm_consolidate_dev()); wipe_secrets_and_remove() purges entries before a
+ * record is freed, so the index never holds a dangling pointer. */
+static std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> sec_dev_rec_index;
+
+/* Drop all index entries resolving to |p_dev_rec| */
+static void btm_sec_dev_rec_index_remove(tBTM_SEC_DEV_REC* p_dev_rec) {
+  for (auto it = sec_dev_rec_index.begin(); it != sec_dev_rec_index.end();) {
+    if (it->second == p_dev_rec) {
+      it = sec_dev_rec_index.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
+/* Called when the device record list itself is created or freed */
+void btm_sec_dev_rec_index_clear(void) {
+  sec_dev_rec_index.clear();
+  btm_sec_bond_snapshot_publish();
+}
+
+/* RCU-style snapshot of the bonded device set. The security records are only
+ * ever touched on the stack thread, but a few btif callers query bond state
+ * directly from their own context. Rather than routing those reads through
+ * the global stack mutex, every bond/unbond republishes an immutable copy of
+ * the bonded addresses and readers pick it up with an atomic shared_ptr load:
+ * lock-free and never dangling, at the cost of a view that can be one
+ * publication behind the live records. */
+struct tBTM_SEC_BOND_SNAPSHOT_REC {
+  RawAddress bd_addr;     /* identity address of the bonded peer */
+  RawAddress pseudo_addr; /* LE pseudo address; may equal bd_addr */
+};
+static std::shared_ptr<const std::vector<tBTM_SEC_BOND_SNAPSHOT_REC>>
+    btm_sec_bond_snapshot;
+
+static bool btm_sec_bond_snapshot_collect(void* data, void* context) {
+  tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(data);
+  auto* records =
+      static_cast<std::vector<tBTM_SEC_BOND_SNAPSHOT_REC>*>(context);
+
+  /* same bonded predicate as btm_sec_is_a_bonded_dev() */
+  if ((p_dev_rec->ble.key_type &&
+       (p_dev_rec->sec_flags & BTM_SEC_LE_LINK_KEY_KNOWN)) ||
+      (p_dev_rec->sec_flags & BTM_SEC_LINK_KEY_KNOWN)) {
+    records->push_back({p_dev_rec->bd_addr, p_dev_rec->ble.pseudo_addr});
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_sec_bond_snapshot_publish
+ *
+ * Description      Rebuild the bonded device snapshot from the live security
+ *                  records and publish it for lock-free readers. Must run on
+ *                  the stack thread; call after any bond/unbond transition.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void btm_sec_bond_snapshot_publish(void) {
+  auto records = std::make_shared<std::vector<tBTM_SEC_BOND_SNAPSHOT_REC>>();
+  if (btm_cb.sec_dev_rec != nullptr) {
+    list_foreach(btm_cb.sec_dev_rec, btm_sec_bond_snapshot_collect,
+                 records.get());
+  }
+  std::atomic_store(
+      &btm_sec_bond_snapshot,
+      std::shared_ptr<const std::vector<tBTM_SEC_BOND_SNAPSHOT_REC>>(
+          std::move(records)));
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_sec_is_a_bonded_dev_snapshot
+ *
+ * Description      Bond state check against the last published snapshot.
+ *                  Unlike btm_sec_is_a_bonded_dev() this is safe to call
+ *                  from any thread without holding the stack mutex.
+ *
+ * Returns          true - dev was bonded in the last published snapshot
+ *
+ ******************************************************************************/
+bool btm_sec_is_a_bonded_dev_snapshot(const RawAddress& bd_addr) {
+  auto records = std::atomic_load(&btm_sec_bond_snapshot);
+  if (records == nullptr) return false;
+
+  for (const auto& rec : *records) {
+    if (rec.bd_addr == bd_addr || rec.pseudo_addr == bd_addr) return true;
+  }
+  return false;
+}
+
 /*******************************************************************************
  *
  * Function         BTM_SecAddDevice
@@ -72,6 +174,7 @@ bool BTM_SecAddDevice(const RawAddress& bd_addr, DEV_CLASS dev_class,
                   bd_addr.ToString().c_str());
 
     p_dev_rec->bd_addr = bd_addr;
+    sec_dev_rec_index[bd_addr] = p_dev_rec;
     p_dev_rec->hci_handle = BTM_GetHCIConnHandle(bd_addr, BT_TRANSPORT_BR_EDR);
 
     /* use default value for background connection params */
@@ -119,13 +222,19 @@ bool BTM_SecAddDevice(const RawAddress& bd_addr, DEV_CLASS dev_class,
   p_dev_rec->rmt_io_caps = BTM_IO_CAP_OUT;
   p_dev_rec->device_type |= BT_DEVICE_TYPE_BREDR;
 
+  btm_sec_bond_snapshot_publish();
+
   return true;
 }
 
 void wipe_secrets_and_remove(tBTM_SEC_DEV_REC* p_dev_rec) {
   p_dev_rec->link_key.fill(0);
   memset(&p_dev_rec->ble.keys, 0, sizeof(tBTM_SEC_BLE_KEYS));
+  btm_sec_dev_rec_index_remove(p_dev_rec);
+  if (p_dev_rec->ble.key_type & BTM_LE_KEY_PID)
+    btm_ble_resolve_cache_invalidate();
   list_remove(btm_cb.sec_dev_rec, p_dev_rec);
+  btm_sec_bond_snapshot_publish();
 }
 
 /** Free resources associated with the device associated with |bd_addr| address.
@@ -179,6 +288,8 @@ void BTM_SecClearSecurityFlags(const RawAddress& bd_addr) {
   p_dev_rec->sec_flags = 0;
   p_dev_rec->sec_state = BTM_SEC_STATE_IDLE;
   p_dev_rec->sm4 = BTM_SM4_UNKNOWN;
+
+  btm_sec_bond_snapshot_publish();
 }
 
 /*******************************************************************************
@@ -233,6 +344,7 @@ tBTM_SEC_DEV_REC* btm_sec_alloc_dev(const RawAddress& bd_addr) {
   memset(&p_dev_rec->conn_params, 0xff, sizeof(tBTM_LE_CONN_PRAMS));
 
   p_dev_rec->bd_addr = bd_addr;
+  sec_dev_rec_index[bd_addr] = p_dev_rec;
 
   p_dev_rec->ble_hci_handle = BTM_GetHCIConnHandle(bd_addr, BT_TRANSPORT_LE);
   p_dev_rec->hci_handle = BTM_GetHCIConnHandle(bd_addr, BT_TRANSPORT_BR_EDR);
@@ -337,9 +449,26 @@ bool is_address_equal(void* data, void* context) {
  *
  ******************************************************************************/
 tBTM_SEC_DEV_REC* btm_find_dev(const RawAddress& bd_addr) {
+  auto it = sec_dev_rec_index.find(bd_addr);
+  if (it != sec_dev_rec_index.end()) {
+    tBTM_SEC_DEV_REC* p_dev_rec = it->second;
+    if (p_dev_rec->bd_addr == bd_addr ||
+        p_dev_rec->ble.pseudo_addr == bd_addr) {
+      return p_dev_rec;
+    }
+    /* the record no longer answers to this address, re-resolve below */
+    sec_dev_rec_index.erase(it);
+  }
+
   list_node_t* n =
       list_foreach(btm_cb.sec_dev_rec, is_address_equal, (void*)&bd_addr);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    /* memoize; a resolved RPA became the pseudo address in
+     * btm_ble_addr_resolvable(), so the verification above keeps working */
+    sec_dev_rec_index[bd_addr] = p_dev_rec;
+    return p_dev_rec;
+  }
 
   return NULL;
 }
@@ -44,6 +44,37 @@ bool BTM_SecAddDevice(const RawAddress& bd_addr, DEV_CLASS dev_class,
                       uint8_t key_type, uint8_t pin_length);
 void wipe_secrets_and_remove(tBTM_SEC_DEV_REC* p_dev_rec);
 
+/* Reset the address index over the security device records. Must be called
+ * whenever btm_cb.sec_dev_rec is created or freed wholesale, i.e. from the
+ * BTM init/free path. */
+void btm_sec_dev_rec_index_clear(void);
+
+/*******************************************************************************
+ *
+ * Function         btm_sec_bond_snapshot_publish
+ *
+ * Description      Rebuild the bonded device snapshot from the live security
+ *                  records and publish it for lock-free readers. Must run on
+ *                  the stack thread; call after any bond/unbond transition.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void btm_sec_bond_snapshot_publish(void);
+
+/*******************************************************************************
+ *
+ * Function         btm_sec_is_a_bonded_dev_snapshot
+ *
+ * Description      Bond state check against the last published snapshot.
+ *                  Unlike btm_sec_is_a_bonded_dev() this is safe to call
+ *                  from any thread without holding the stack mutex.
+ *
+ * Returns          true - dev was bonded in the last published snapshot
+ *
+ ******************************************************************************/
+bool btm_sec_is_a_bonded_dev_snapshot(const RawAddress& bd_addr);
+
 /** Free resources associated with the device associated with |bd_addr| address.
  *
  * *** WARNING ***
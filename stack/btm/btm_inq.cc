@@ -32,6 +32,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <unordered_map>
+
 #include "common/time_util.h"
 #include "device/include/controller.h"
 #include "osi/include/log.h"
@@ -83,6 +85,21 @@ using bluetooth::Uuid;
 static const LAP general_inq_lap = {0x9e, 0x8b, 0x33};
 static const LAP limited_inq_lap = {0x9e, 0x8b, 0x00};
 
+/* Hash index over inq_db, so per-result lookups don't scan the whole array.
+ * Code outside this file may mark entries unused without telling us (e.g.
+ * btm_clear_all_pending_le_entry), so lookups verify the entry and drop stale
+ * mappings lazily. */
+static std::unordered_map<RawAddress, uint16_t> inq_db_index;
+
+/* Drop the index mapping of |p_ent|, if it still points at that entry */
+static void btm_inq_db_index_remove(tINQ_DB_ENT* p_ent) {
+  auto it = inq_db_index.find(p_ent->inq_info.results.remote_bd_addr);
+  if (it != inq_db_index.end() &&
+      &btm_cb.btm_inq_vars.inq_db[it->second] == p_ent) {
+    inq_db_index.erase(it);
+  }
+}
+
 const uint16_t BTM_EIR_UUID_LKUP_TBL[BTM_EIR_MAX_SERVICES] = {
     UUID_SERVCLASS_SERVICE_DISCOVERY_SERVER,
     /*    UUID_SERVCLASS_BROWSE_GROUP_DESCRIPTOR,   */
@@ -448,7 +465,10 @@ void BTM_CancelInquiry(void) {
     p_inq->p_inq_cmpl_cb = NULL;    /* Do not notify caller anymore */
 
     if ((p_inq->inqparms.mode & BTM_BR_INQUIRY_MASK) != 0) {
-      bluetooth::legacy::hci::GetInterface().InquiryCancel();
+      /* no controller inquiry to cancel while yielded to a page */
+      if (!p_inq->br_inq_yielded)
+        bluetooth::legacy::hci::GetInterface().InquiryCancel();
+      p_inq->br_inq_yielded = false;
     }
     if ((p_inq->inqparms.mode & BTM_BLE_INQUIRY_MASK) != 0)
       btm_ble_stop_inquiry();
@@ -458,6 +478,86 @@ void BTM_CancelInquiry(void) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         BTM_SetInquiryPageYield
+ *
+ * Description      Enable or disable yielding the classic inquiry to
+ *                  outgoing connection attempts (enabled by default). While
+ *                  enabled, an active inquiry is paused in the controller
+ *                  for the duration of a BR/EDR page and resumes with its
+ *                  remaining duration afterwards, so connect latency during
+ *                  discovery approaches that of an idle radio.
+ *
+ ******************************************************************************/
+void BTM_SetInquiryPageYield(bool enable) {
+  tBTM_INQUIRY_VAR_ST* p_inq = &btm_cb.btm_inq_vars;
+
+  BTM_TRACE_API("BTM_SetInquiryPageYield %d", enable);
+  p_inq->page_yield_enabled = enable;
+  /* disabling mid-yield puts the inquiry back on the air right away */
+  if (!enable && p_inq->br_inq_yielded) btm_inq_page_completed();
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_inq_page_started
+ *
+ * Description      Called when an outgoing BR/EDR page starts. An active
+ *                  classic inquiry is cancelled in the controller only; the
+ *                  BTM inquiry state stays active so upper layers still see
+ *                  the inquiry in progress while it waits for the radio.
+ *
+ ******************************************************************************/
+void btm_inq_page_started(void) {
+  tBTM_INQUIRY_VAR_ST* p_inq = &btm_cb.btm_inq_vars;
+
+  if (!p_inq->page_yield_enabled || p_inq->br_inq_yielded) return;
+  if ((p_inq->inqparms.mode & BTM_BR_INQUIRY_MASK) == 0 ||
+      p_inq->state != BTM_INQ_ACTIVE_STATE)
+    return;
+
+  BTM_TRACE_DEBUG("%s: inquiry yields to outgoing page", __func__);
+  p_inq->br_inq_yielded = true;
+  bluetooth::legacy::hci::GetInterface().InquiryCancel();
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_inq_page_completed
+ *
+ * Description      Called when an outgoing BR/EDR page finishes, whether
+ *                  the connection came up or failed. Resumes a yielded
+ *                  classic inquiry with whatever duration its budget has
+ *                  left, or completes it if the budget ran out while
+ *                  yielded.
+ *
+ ******************************************************************************/
+void btm_inq_page_completed(void) {
+  tBTM_INQUIRY_VAR_ST* p_inq = &btm_cb.btm_inq_vars;
+
+  if (!p_inq->br_inq_yielded) return;
+  p_inq->br_inq_yielded = false;
+
+  if ((p_inq->inqparms.mode & BTM_BR_INQUIRY_MASK) == 0 ||
+      p_inq->state != BTM_INQ_ACTIVE_STATE)
+    return;
+
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  if (now_ms + 1280 >= p_inq->br_inq_deadline_ms) {
+    /* the controller inquiry is already cancelled; finish the classic
+     * half of the inquiry as if its duration had elapsed */
+    btm_process_inq_complete(HCI_SUCCESS, BTM_BR_INQUIRY_MASK);
+    return;
+  }
+
+  uint8_t duration =
+      (uint8_t)((p_inq->br_inq_deadline_ms - now_ms + 1279) / 1280);
+  BTM_TRACE_DEBUG("%s: resuming inquiry for %d intervals", __func__, duration);
+  bluetooth::legacy::hci::GetInterface().StartInquiry(general_inq_lap,
+                                                      duration, 0);
+}
+
 /*******************************************************************************
  *
  * Function         BTM_StartInquiry
@@ -553,6 +653,17 @@ tBTM_STATUS BTM_StartInquiry(tBTM_INQ_RESULTS_CB* p_results_cb,
   p_inq->max_bd_entries =
       (uint16_t)(BT_DEFAULT_BUFFER_SIZE / sizeof(tINQ_BDADDR));
 
+  p_inq->br_inq_deadline_ms =
+      bluetooth::common::time_get_os_boottime_ms() +
+      (uint64_t)p_inq->inqparms.duration * 1280;
+  if (p_inq->page_yield_enabled && btm_cb.is_paging) {
+    /* a page is already on the air; the classic half starts from
+     * btm_inq_page_completed once the page finishes */
+    p_inq->br_inq_yielded = true;
+    return BTM_CMD_STARTED;
+  }
+
+  p_inq->br_inq_yielded = false;
   bluetooth::legacy::hci::GetInterface().StartInquiry(
       general_inq_lap, p_inq->inqparms.duration, 0);
   return BTM_CMD_STARTED;
@@ -897,6 +1008,7 @@ void btm_clr_inq_db(const RawAddress* p_bda) {
     if (p_ent->in_use) {
       /* If this is the specified BD_ADDR or clearing all devices */
       if (p_bda == NULL || (p_ent->inq_info.results.remote_bd_addr == *p_bda)) {
+        btm_inq_db_index_remove(p_ent);
         p_ent->in_use = false;
       }
     }
@@ -969,15 +1081,15 @@ bool btm_inq_find_bdaddr(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_find(const RawAddress& p_bda) {
-  uint16_t xx;
-  tINQ_DB_ENT* p_ent = btm_cb.btm_inq_vars.inq_db;
+  auto it = inq_db_index.find(p_bda);
+  if (it == inq_db_index.end()) return (NULL);
 
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use && p_ent->inq_info.results.remote_bd_addr == p_bda)
-      return (p_ent);
-  }
+  tINQ_DB_ENT* p_ent = &btm_cb.btm_inq_vars.inq_db[it->second];
+  if (p_ent->in_use && p_ent->inq_info.results.remote_bd_addr == p_bda)
+    return (p_ent);
 
-  /* If here, not found */
+  /* The entry was released or recycled behind our back */
+  inq_db_index.erase(it);
   return (NULL);
 }
 
@@ -1000,10 +1112,12 @@ tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda) {
 
   for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
     if (!p_ent->in_use) {
+      btm_inq_db_index_remove(p_ent);
       memset(p_ent, 0, sizeof(tINQ_DB_ENT));
       p_ent->inq_info.results.remote_bd_addr = p_bda;
       p_ent->in_use = true;
 
+      inq_db_index[p_bda] = xx;
       return (p_ent);
     }
 
@@ -1015,10 +1129,12 @@ tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda) {
 
   /* If here, no free entry found. Return the oldest. */
 
+  btm_inq_db_index_remove(p_old);
   memset(p_old, 0, sizeof(tINQ_DB_ENT));
   p_old->inq_info.results.remote_bd_addr = p_bda;
   p_old->in_use = true;
 
+  inq_db_index[p_bda] = (uint16_t)(p_old - btm_cb.btm_inq_vars.inq_db);
   return (p_old);
 }
 
@@ -1193,10 +1309,11 @@ void btm_process_inq_results(uint8_t* p, uint8_t hci_evt_len,
 
     if (is_new || update) {
       if (inq_res_mode == BTM_INQ_RESULT_EXTENDED) {
-        memset(p_cur->eir_uuid, 0,
-               BTM_EIR_SERVICE_ARRAY_SIZE * (BTM_EIR_ARRAY_BITS / 8));
-        /* set bit map of UUID list from received EIR */
-        btm_set_eir_uuid(p, p_cur);
+        /* Keep the raw EIR; the UUID bit map is only built from it on the
+         * first BTM_HasInquiryEirService() lookup */
+        memcpy(p_cur->eir_data, p, HCI_EXT_INQ_RESPONSE_LEN);
+        p_cur->eir_data_len = HCI_EXT_INQ_RESPONSE_LEN;
+        p_cur->eir_parsed = false;
         p_eir_data = p;
       } else
         p_eir_data = NULL;
@@ -1558,6 +1675,30 @@ bool BTM_HasEirService(const uint32_t* p_eir_uuid, uint16_t uuid16) {
     return (false);
 }
 
+/*******************************************************************************
+ *
+ * Function         btm_inq_parse_eir
+ *
+ * Description      This function builds the UUID bit map of an inquiry result
+ *                  from its stored raw EIR on first use. Results that are
+ *                  never inspected never pay the parse cost.
+ *
+ * Parameters       p_results - inquiry results
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void btm_inq_parse_eir(tBTM_INQ_RESULTS* p_results) {
+  if (p_results->eir_parsed) return;
+
+  memset(p_results->eir_uuid, 0,
+         BTM_EIR_SERVICE_ARRAY_SIZE * (BTM_EIR_ARRAY_BITS / 8));
+  if (p_results->eir_data_len != 0) {
+    btm_set_eir_uuid(p_results->eir_data, p_results);
+  }
+  p_results->eir_parsed = true;
+}
+
 /*******************************************************************************
  *
  * Function         BTM_HasInquiryEirService
@@ -1575,6 +1716,7 @@ bool BTM_HasEirService(const uint32_t* p_eir_uuid, uint16_t uuid16) {
  ******************************************************************************/
 tBTM_EIR_SEARCH_RESULT BTM_HasInquiryEirService(tBTM_INQ_RESULTS* p_results,
                                                 uint16_t uuid16) {
+  btm_inq_parse_eir(p_results);
   if (BTM_HasEirService(p_results->eir_uuid, uuid16)) {
     return BTM_EIR_FOUND;
   } else if (p_results->eir_complete_list) {
@@ -1778,11 +1920,10 @@ static const uint8_t* btm_eir_get_uuid_list(uint8_t* p_eir, size_t eir_len,
       break;
   }
 
-  p_uuid_data = AdvertiseDataParser::GetFieldByType(p_eir, eir_len,
-                                                    complete_type, &uuid_len);
+  AdvertiseDataIndex eir_index(p_eir, eir_len);
+  p_uuid_data = eir_index.GetFieldByType(complete_type, &uuid_len);
   if (p_uuid_data == NULL) {
-    p_uuid_data = AdvertiseDataParser::GetFieldByType(p_eir, eir_len, more_type,
-                                                      &uuid_len);
+    p_uuid_data = eir_index.GetFieldByType(more_type, &uuid_len);
     *p_uuid_list_type = more_type;
   } else {
     *p_uuid_list_type = complete_type;
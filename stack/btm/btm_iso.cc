@@ -128,6 +128,10 @@ void IsoManager::HandleHciEvent(uint8_t sub_code, uint8_t* params,
     pimpl_->iso_impl_->on_iso_event(sub_code, params, length);
 }
 
+void IsoManager::Dump(int fd) {
+  if (pimpl_->IsRunning()) pimpl_->iso_impl_->dump(fd);
+}
+
 void IsoManager::Start() {
   if (!pimpl_->IsRunning())
     pimpl_->Start();
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <queue>
 #include <set>
 
 #include "base/bind.h"
@@ -57,6 +58,14 @@ struct iso_base {
   struct iso_sync_info sync_info;
   uint8_t state_flags;
   uint32_t sdu_itv;
+
+  /* TX scheduler state: SDUs parked while the controller is out of ISO
+   * buffers, flushed oldest first as credits return. last_tx_seq_nb tracks
+   * the SDU interval cadence so missed intervals show up as underruns. */
+  std::queue<BT_HDR*> tx_pending_queue;
+  uint16_t last_tx_seq_nb;
+  uint32_t tx_underrun_count;
+  uint32_t tx_overrun_count;
 };
 
 typedef iso_base iso_cis;
@@ -68,7 +77,12 @@ struct iso_impl {
     iso_buffer_size_ = controller_get_interface()->get_iso_data_size();
   }
 
-  ~iso_impl() {}
+  ~iso_impl() {
+    for (auto& kv_pair : conn_hdl_to_cis_map_)
+      flush_tx_pending_queue(kv_pair.second.get());
+    for (auto& kv_pair : conn_hdl_to_bis_map_)
+      flush_tx_pending_queue(kv_pair.second.get());
+  }
 
   void handle_register_cis_callbacks(CigCallbacks* callbacks) {
     LOG_ASSERT(callbacks != nullptr) << "Invalid CIG callbacks";
@@ -104,10 +118,12 @@ struct iso_impl {
       if (evt_code == kIsoEventCigOnReconfigureCmpl) {
         auto cis_it = conn_hdl_to_cis_map_.cbegin();
         while (cis_it != conn_hdl_to_cis_map_.cend()) {
-          if (cis_it->second->cig_id == evt.cig_id)
+          if (cis_it->second->cig_id == evt.cig_id) {
+            flush_tx_pending_queue(cis_it->second.get());
             cis_it = conn_hdl_to_cis_map_.erase(cis_it);
-          else
+          } else {
             ++cis_it;
+          }
         }
       }
 
@@ -165,10 +181,12 @@ struct iso_impl {
     if (evt.status == HCI_SUCCESS) {
       auto cis_it = conn_hdl_to_cis_map_.cbegin();
       while (cis_it != conn_hdl_to_cis_map_.cend()) {
-        if (cis_it->second->cig_id == evt.cig_id)
+        if (cis_it->second->cig_id == evt.cig_id) {
+          flush_tx_pending_queue(cis_it->second.get());
           cis_it = conn_hdl_to_cis_map_.erase(cis_it);
-        else
+        } else {
           ++cis_it;
+        }
       }
     }
 
@@ -396,19 +414,67 @@ struct iso_impl {
     uint32_t ts = bluetooth::common::time_get_os_boottime_us();
     iso->sync_info.seq_nb = (ts - iso->sync_info.first_sync_ts) / iso->sdu_itv;
 
-    if (iso_credits_ == 0 || data_len > iso_buffer_size_) {
+    if (data_len > iso_buffer_size_) {
       LOG(WARNING) << __func__ << ", dropping ISO packet, len: "
-                   << static_cast<int>(data_len)
-                   << ", iso credits: " << static_cast<int>(iso_credits_);
+                   << static_cast<int>(data_len) << ", iso buffer size: "
+                   << static_cast<int>(iso_buffer_size_);
       return;
     }
 
-    iso_credits_--;
+    /* SDU intervals that elapsed without a ready SDU are underruns */
+    if ((iso->last_tx_seq_nb != 0) &&
+        (iso->sync_info.seq_nb > iso->last_tx_seq_nb + 1)) {
+      iso->tx_underrun_count += iso->sync_info.seq_nb - iso->last_tx_seq_nb - 1;
+    }
+    iso->last_tx_seq_nb = iso->sync_info.seq_nb;
 
     BT_HDR* packet =
         prepare_ts_hci_packet(iso_handle, ts, iso->sync_info.seq_nb, data_len);
     memcpy(packet->data + kIsoDataInTsBtHdrOffset, data, data_len);
-    send_iso_data_hci_packet(packet);
+
+    if ((iso_credits_ > 0) && iso->tx_pending_queue.empty()) {
+      iso_credits_--;
+      send_iso_data_hci_packet(packet);
+      return;
+    }
+
+    /* Controller buffers are full - park the SDU until credits return, so
+     * a scheduling hiccup does not turn into a dropped frame. A parked SDU
+     * keeps its original timestamp and sequence number. Bound the backlog
+     * to one controller buffer depth and prefer the freshest audio when it
+     * overflows. */
+    if (iso->tx_pending_queue.size() >=
+        controller_get_interface()->get_iso_buffer_count()) {
+      iso->tx_overrun_count++;
+      osi_free(iso->tx_pending_queue.front());
+      iso->tx_pending_queue.pop();
+    }
+    iso->tx_pending_queue.push(packet);
+  }
+
+  /* Flush parked SDUs to the controller as credits return, oldest first so
+   * the SDU interval cadence is preserved. */
+  void send_pending_iso_data() {
+    for (auto* iso_map : {&conn_hdl_to_cis_map_, &conn_hdl_to_bis_map_}) {
+      for (auto& kv_pair : *iso_map) {
+        iso_base* iso = kv_pair.second.get();
+
+        while ((iso_credits_ > 0) && !iso->tx_pending_queue.empty()) {
+          iso_credits_--;
+          send_iso_data_hci_packet(iso->tx_pending_queue.front());
+          iso->tx_pending_queue.pop();
+        }
+
+        if (iso_credits_ == 0) return;
+      }
+    }
+  }
+
+  void flush_tx_pending_queue(iso_base* iso) {
+    while (!iso->tx_pending_queue.empty()) {
+      osi_free(iso->tx_pending_queue.front());
+      iso->tx_pending_queue.pop();
+    }
   }
 
   void process_cis_est_pkt(uint8_t len, uint8_t* data) {
@@ -463,6 +529,7 @@ struct iso_impl {
 
       cig_callbacks_->OnCisEvent(kIsoEventCisDisconnected, &evt);
       cis->state_flags &= ~kStateFlagIsConnected;
+      flush_tx_pending_queue(cis);
       /* Data path is considered still valid, but can be reconfigured only once
        * CIS is reestablished.
        */
@@ -488,6 +555,8 @@ struct iso_impl {
 
       iso_credits_ += num_sent;
     }
+
+    if (iso_credits_ > 0) send_pending_iso_data();
   }
 
   void process_create_big_cmpl_pkt(uint8_t len, uint8_t* data) {
@@ -547,6 +616,7 @@ struct iso_impl {
     auto bis_it = conn_hdl_to_bis_map_.cbegin();
     while (bis_it != conn_hdl_to_bis_map_.cend()) {
       if (bis_it->second->big_handle == evt.big_id) {
+        flush_tx_pending_queue(bis_it->second.get());
         bis_it = conn_hdl_to_bis_map_.erase(bis_it);
         is_known_handle = true;
       } else {
@@ -655,6 +725,32 @@ struct iso_impl {
     cig_callbacks_->OnCisEvent(kIsoEventCisDataAvailable, &evt);
   }
 
+  void dump(int fd) {
+    dprintf(fd, "  ----------------\n");
+    dprintf(fd, "  ISO Manager:\n");
+    dprintf(fd, "    Available credits: %d\n", iso_credits_);
+    dprintf(fd, "    Controller buffer size: %d\n", iso_buffer_size_);
+    dprintf(fd, "    CIS list:\n");
+    for (auto const& cis_pair : conn_hdl_to_cis_map_) {
+      dprintf(fd, "      CIS Connection handle: %d\n", cis_pair.first);
+      dprintf(fd, "        CIG ID: %d\n", cis_pair.second->cig_id);
+      dprintf(fd, "        TX queued: %zu, underruns: %u, overruns: %u\n",
+              cis_pair.second->tx_pending_queue.size(),
+              cis_pair.second->tx_underrun_count,
+              cis_pair.second->tx_overrun_count);
+    }
+    dprintf(fd, "    BIS list:\n");
+    for (auto const& bis_pair : conn_hdl_to_bis_map_) {
+      dprintf(fd, "      BIS Connection handle: %d\n", bis_pair.first);
+      dprintf(fd, "        BIG Handle: %d\n", bis_pair.second->big_handle);
+      dprintf(fd, "        TX queued: %zu, underruns: %u, overruns: %u\n",
+              bis_pair.second->tx_pending_queue.size(),
+              bis_pair.second->tx_underrun_count,
+              bis_pair.second->tx_overrun_count);
+    }
+    dprintf(fd, "  ----------------\n");
+  }
+
   iso_cis* GetCisIfKnown(uint16_t cis_conn_handle) {
     auto cis_it = conn_hdl_to_cis_map_.find(cis_conn_handle);
     return (cis_it != conn_hdl_to_cis_map_.end()) ? cis_it->second.get()
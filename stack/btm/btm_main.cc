@@ -27,6 +27,7 @@
 #include "bt_target.h"
 #include "bt_types.h"
 #include "main/shim/dumpsys.h"
+#include "stack/btm/btm_dev.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/include/btm_client_interface.h"
 #include "stack_config.h"
@@ -48,6 +49,7 @@ tBTM_CB btm_cb;
  *
  ******************************************************************************/
 void btm_init(void) {
+  btm_sec_dev_rec_index_clear();
   btm_cb.Init(stack_config_get_interface()->get_pts_secure_only_mode()
                   ? BTM_SEC_MODE_SC
                   : BTM_SEC_MODE_SP);
@@ -56,6 +58,7 @@ void btm_init(void) {
 /** This function is called to free dynamic memory and system resource allocated by btm_init */
 void btm_free(void) {
   btm_cb.Free();
+  btm_sec_dev_rec_index_clear();
 }
 
 constexpr size_t kMaxLogHistoryTagLength = 6;
@@ -3843,6 +3843,9 @@ void btm_sec_link_key_notification(const RawAddress& p_bda,
   p_dev_rec->enc_key_size = 16;
   p_dev_rec->link_key = link_key;
 
+  /* a new link key means the BR/EDR bond state changed */
+  btm_sec_bond_snapshot_publish();
+
   if ((btm_cb.pairing_state != BTM_PAIR_STATE_IDLE) &&
       (btm_cb.pairing_bda == p_bda)) {
     if (btm_cb.pairing_flags & BTM_PAIR_FLAGS_WE_STARTED_DD)
@@ -93,6 +93,10 @@ enum : uint8_t {
   BTM_INQ_RES_IGNORE_RSSI = 0x7f,
 };
 
+/* Size of the raw EIR payload kept with each inquiry result; matches
+ * HCI_EXT_INQ_RESPONSE_LEN in hcidefs.h */
+constexpr uint16_t BTM_INQ_RESULT_EIR_SIZE = 240;
+
 /* These are the fields returned in each device's response to the inquiry.  It
  * is returned in the results callback if registered.
  */
@@ -106,6 +110,13 @@ typedef struct {
   int8_t rssi; /* Set to BTM_INQ_RES_IGNORE_RSSI if  not valid */
   uint32_t eir_uuid[BTM_EIR_SERVICE_ARRAY_SIZE];
   bool eir_complete_list;
+  /* Raw EIR of the last extended inquiry response. The eir_uuid bit map
+   * above is only rebuilt from it on the first service lookup
+   * (btm_inq_parse_eir), so results nobody inspects never pay the parse
+   * cost. */
+  uint8_t eir_data[BTM_INQ_RESULT_EIR_SIZE];
+  uint16_t eir_data_len;
+  bool eir_parsed;
   tBT_DEVICE_TYPE device_type;
   uint8_t inq_result_type;
   tBLE_ADDR_TYPE ble_addr_type;
@@ -229,10 +240,18 @@ typedef struct {
   uint8_t inq_active; /* Bit Mask indicating type of inquiry is active */
   bool no_inc_ssp;    /* true, to stop inquiry on incoming SSP */
 
+  /* Adaptive inquiry/page interleave. While an outgoing BR/EDR page is on
+   * the air, the classic inquiry yields the radio to the page and resumes
+   * with whatever duration its budget has left once the page completes */
+  bool page_yield_enabled; /* policy; see BTM_SetInquiryPageYield */
+  bool br_inq_yielded;     /* BR inquiry cancelled in controller only */
+  uint64_t br_inq_deadline_ms; /* boottime when the BR inquiry budget ends */
+
   void Init() {
     alarm_free(remote_name_timer);
     remote_name_timer = alarm_new("btm_inq.remote_name_timer");
     no_inc_ssp = BTM_NO_SSP_ON_INQUIRY;
+    page_yield_enabled = true;
   }
   void Free() { alarm_free(remote_name_timer); }
 
@@ -257,3 +276,5 @@ typedef union /* contains the inquiry filter condition */
 
 extern bool btm_inq_find_bdaddr(const RawAddress& p_bda);
 extern tINQ_DB_ENT* btm_inq_db_find(const RawAddress& p_bda);
+extern void btm_inq_page_started(void);
+extern void btm_inq_page_completed(void);
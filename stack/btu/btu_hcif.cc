@@ -29,12 +29,15 @@
 
 #include <base/bind.h>
 #include <base/location.h>
+#include <array>
 #include <cstdint>
 
 #include "btif/include/btif_config.h"
 #include "common/metrics.h"
 #include "device/include/controller.h"
+#include "hci_layer.h"
 #include "osi/include/log.h"
+#include "osi/include/tracepoint.h"
 #include "stack/include/acl_hci_link_interface.h"
 #include "stack/include/ble_acl_interface.h"
 #include "stack/include/ble_hci_link_interface.h"
@@ -244,6 +247,266 @@ void btu_hcif_log_event_metrics(uint8_t evt_code, uint8_t* p_event) {
   }
 }
 
+/* Same-thread handler for a received HCI event. |p| points past the event
+ * header, |evt_len| is the parameter total length. */
+typedef void (*tBTU_HCIF_EVT_HANDLER)(uint8_t* p, uint8_t evt_len);
+
+/* Handler for an LE meta event. |p| points past the subevent code, |evt_len|
+ * is the parameter total length including the subevent code octet. */
+typedef void (*tBTU_HCIF_BLE_EVT_HANDLER)(uint8_t ble_sub_code, uint8_t* p,
+                                          uint8_t evt_len);
+
+static void btu_hcif_ble_event(uint8_t* p, uint8_t evt_len);
+
+/* Event and subevent codes are single octets, so both dispatch tables cover
+ * the full code space and unknown codes simply hit an empty slot. The tables
+ * are built at compile time and dispatch runs inline on the calling (main)
+ * thread with no per-event allocation, which matters for the interrupt-driven
+ * high-frequency events (Number Of Completed Packets, advertising reports).
+ */
+static constexpr std::array<tBTU_HCIF_EVT_HANDLER, 0x100>
+btu_hcif_build_event_table() {
+  std::array<tBTU_HCIF_EVT_HANDLER, 0x100> table{};
+
+  table[HCI_INQUIRY_COMP_EVT] = [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+    btu_hcif_inquiry_comp_evt(p);
+  };
+  table[HCI_INQUIRY_RESULT_EVT] = [](uint8_t* p, uint8_t evt_len) {
+    btm_process_inq_results(p, evt_len, BTM_INQ_RESULT_STANDARD);
+  };
+  table[HCI_INQUIRY_RSSI_RESULT_EVT] = [](uint8_t* p, uint8_t evt_len) {
+    btm_process_inq_results(p, evt_len, BTM_INQ_RESULT_WITH_RSSI);
+  };
+  table[HCI_EXTENDED_INQUIRY_RESULT_EVT] = [](uint8_t* p, uint8_t evt_len) {
+    btm_process_inq_results(p, evt_len, BTM_INQ_RESULT_EXTENDED);
+  };
+  table[HCI_CONNECTION_COMP_EVT] = btu_hcif_connection_comp_evt;
+  table[HCI_CONNECTION_REQUEST_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_connection_request_evt(p);
+      };
+  table[HCI_DISCONNECTION_COMP_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_disconnection_comp_evt(p);
+      };
+  table[HCI_AUTHENTICATION_COMP_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_authentication_comp_evt(p);
+      };
+  table[HCI_RMT_NAME_REQUEST_COMP_EVT] = [](uint8_t* p, uint8_t evt_len) {
+    btu_hcif_rmt_name_request_comp_evt(p, evt_len);
+  };
+  table[HCI_ENCRYPTION_CHANGE_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_encryption_change_evt(p);
+      };
+  table[HCI_ENCRYPTION_KEY_REFRESH_COMP_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_encryption_key_refresh_cmpl_evt(p);
+      };
+  table[HCI_READ_RMT_FEATURES_COMP_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btm_read_remote_features_complete_raw(p);
+      };
+  table[HCI_READ_RMT_EXT_FEATURES_COMP_EVT] = [](uint8_t* p, uint8_t evt_len) {
+    btu_hcif_read_rmt_ext_features_comp_evt(p, evt_len);
+  };
+  table[HCI_READ_RMT_VERSION_COMP_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btm_read_remote_version_complete_raw(p);
+      };
+  table[HCI_COMMAND_COMPLETE_EVT] =
+      [](UNUSED_ATTR uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        LOG_ERROR(
+            "should not have received a command complete event. "
+            "Someone didn't go through the hci transmit_command function.");
+      };
+  table[HCI_COMMAND_STATUS_EVT] =
+      [](UNUSED_ATTR uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        LOG_ERROR(
+            "should not have received a command status event. "
+            "Someone didn't go through the hci transmit_command function.");
+      };
+  table[HCI_HARDWARE_ERROR_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_hardware_error_evt(p);
+      };
+  table[HCI_ROLE_CHANGE_EVT] = [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+    btu_hcif_role_change_evt(p);
+  };
+  table[HCI_NUM_COMPL_DATA_PKTS_EVT] = [](uint8_t* p, uint8_t evt_len) {
+    acl_process_num_completed_pkts(p, evt_len);
+
+    // Credits of further NOCP events may have been coalesced on the HCI
+    // thread while this event waited for the main thread; apply them as
+    // one synthesized parameter block.
+    uint8_t coalesced[HCI_NOCP_DRAIN_BUF_SIZE];
+    uint8_t coalesced_len =
+        hci_nocp_drain_coalesced(coalesced, sizeof(coalesced));
+    if (coalesced_len > 0)
+      acl_process_num_completed_pkts(coalesced, coalesced_len);
+  };
+  table[HCI_MODE_CHANGE_EVT] = [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+    btu_hcif_mode_change_evt(p);
+  };
+  table[HCI_PIN_CODE_REQUEST_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btm_sec_pin_code_request(p);
+      };
+  table[HCI_LINK_KEY_REQUEST_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btm_sec_link_key_request(p);
+      };
+  table[HCI_LINK_KEY_NOTIFICATION_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_link_key_notification_evt(p);
+      };
+  table[HCI_READ_CLOCK_OFF_COMP_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_read_clock_off_comp_evt(p);
+      };
+  table[HCI_ESCO_CONNECTION_COMP_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_esco_connection_comp_evt(p);
+      };
+  table[HCI_ESCO_CONNECTION_CHANGED_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_esco_connection_chg_evt(p);
+      };
+  table[HCI_SNIFF_SUB_RATE_EVT] = [](uint8_t* p, uint8_t evt_len) {
+    btm_pm_proc_ssr_evt(p, evt_len);
+  };
+  table[HCI_RMT_HOST_SUP_FEAT_NOTIFY_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btm_sec_rmt_host_support_feat_evt(p);
+      };
+  table[HCI_IO_CAPABILITY_REQUEST_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btu_hcif_io_cap_request_evt(p);
+      };
+  table[HCI_IO_CAPABILITY_RESPONSE_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btm_io_capabilities_rsp(p);
+      };
+  table[HCI_USER_CONFIRMATION_REQUEST_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btm_proc_sp_req_evt(BTM_SP_CFM_REQ_EVT, p);
+      };
+  table[HCI_USER_PASSKEY_REQUEST_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btm_proc_sp_req_evt(BTM_SP_KEY_REQ_EVT, p);
+      };
+  table[HCI_REMOTE_OOB_DATA_REQUEST_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) { btm_rem_oob_req(p); };
+  table[HCI_SIMPLE_PAIRING_COMPLETE_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btm_simple_pair_complete(p);
+      };
+  table[HCI_USER_PASSKEY_NOTIFY_EVT] =
+      [](uint8_t* p, UNUSED_ATTR uint8_t evt_len) {
+        btm_proc_sp_req_evt(BTM_SP_KEY_NOTIF_EVT, p);
+      };
+  table[HCI_BLE_EVENT] = btu_hcif_ble_event;
+  table[HCI_VENDOR_SPECIFIC_EVT] = [](uint8_t* p, uint8_t evt_len) {
+    btm_vendor_specific_evt(p, evt_len);
+  };
+
+  return table;
+}
+
+static constexpr std::array<tBTU_HCIF_BLE_EVT_HANDLER, 0x100>
+btu_hcif_build_ble_event_table() {
+  std::array<tBTU_HCIF_BLE_EVT_HANDLER, 0x100> table{};
+
+  /* result of inquiry */
+  table[HCI_BLE_ADV_PKT_RPT_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btm_ble_process_adv_pkt(evt_len - 1, p);
+      };
+  table[HCI_BLE_CONN_COMPLETE_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btm_ble_conn_complete(p, evt_len, false);
+      };
+  table[HCI_BLE_LL_CONN_PARAM_UPD_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btu_ble_ll_conn_param_upd_evt(p, evt_len);
+      };
+  table[HCI_BLE_READ_REMOTE_FEAT_CMPL_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p,
+         UNUSED_ATTR uint8_t evt_len) {
+        btm_ble_read_remote_features_complete(p);
+      };
+  /* received only at peripheral device */
+  table[HCI_BLE_LTK_REQ_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p,
+         UNUSED_ATTR uint8_t evt_len) { btu_ble_proc_ltk_req(p); };
+  table[HCI_BLE_ENHANCED_CONN_COMPLETE_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btm_ble_conn_complete(p, evt_len, true);
+      };
+  table[HCI_BLE_RC_PARAM_REQ_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p,
+         UNUSED_ATTR uint8_t evt_len) { btu_ble_rc_param_req_evt(p); };
+  table[HCI_BLE_DATA_LENGTH_CHANGE_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btu_ble_data_length_change_evt(p, evt_len);
+      };
+  table[HCI_BLE_PHY_UPDATE_COMPLETE_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btm_ble_process_phy_update_pkt(evt_len - 1, p);
+      };
+  table[HCI_LE_EXTENDED_ADVERTISING_REPORT_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btm_ble_process_ext_adv_pkt(evt_len, p);
+      };
+  table[HCI_LE_ADVERTISING_SET_TERMINATED_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btm_le_on_advertising_set_terminated(p, evt_len);
+      };
+  table[HCI_BLE_REQ_PEER_SCA_CPL_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btm_acl_process_sca_cmpl_pkt(evt_len - 1, p);
+      };
+  table[HCI_BLE_PERIODIC_ADV_SYNC_EST_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btm_ble_process_periodic_adv_sync_est_evt(evt_len - 1, p);
+      };
+  table[HCI_BLE_PERIODIC_ADV_REPORT_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btm_ble_process_periodic_adv_pkt(evt_len - 1, p);
+      };
+  table[HCI_BLE_PERIODIC_ADV_SYNC_LOST_EVT] =
+      [](UNUSED_ATTR uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        btm_ble_process_periodic_adv_sync_lost_evt(evt_len - 1, p);
+      };
+
+  constexpr tBTU_HCIF_BLE_EVT_HANDLER iso_handler =
+      [](uint8_t ble_sub_code, uint8_t* p, uint8_t evt_len) {
+        IsoManager::GetInstance()->HandleHciEvent(ble_sub_code, p, evt_len - 1);
+      };
+  table[HCI_BLE_CIS_EST_EVT] = iso_handler;
+  table[HCI_BLE_CREATE_BIG_CPL_EVT] = iso_handler;
+  table[HCI_BLE_TERM_BIG_CPL_EVT] = iso_handler;
+  table[HCI_BLE_CIS_REQ_EVT] = iso_handler;
+  table[HCI_BLE_BIG_SYNC_EST_EVT] = iso_handler;
+  table[HCI_BLE_BIG_SYNC_LOST_EVT] = iso_handler;
+
+  return table;
+}
+
+static constexpr auto btu_hcif_event_table = btu_hcif_build_event_table();
+static constexpr auto btu_hcif_ble_event_table =
+    btu_hcif_build_ble_event_table();
+
+static void btu_hcif_ble_event(uint8_t* p, uint8_t evt_len) {
+  uint8_t ble_sub_code;
+  STREAM_TO_UINT8(ble_sub_code, p);
+
+  const tBTU_HCIF_BLE_EVT_HANDLER handler =
+      btu_hcif_ble_event_table[ble_sub_code];
+  if (handler != nullptr) handler(ble_sub_code, p, evt_len);
+}
+
 /*******************************************************************************
  *
  * Function         btu_hcif_process_event
@@ -257,10 +520,11 @@ void btu_hcif_log_event_metrics(uint8_t evt_code, uint8_t* p_event) {
 void btu_hcif_process_event(UNUSED_ATTR uint8_t controller_id, BT_HDR* p_msg) {
   uint8_t* p = (uint8_t*)(p_msg + 1) + p_msg->offset;
   uint8_t hci_evt_code, hci_evt_len;
-  uint8_t ble_sub_code;
   STREAM_TO_UINT8(hci_evt_code, p);
   STREAM_TO_UINT8(hci_evt_len, p);
 
+  TRACEPOINT(TRACE_BTU_HCIF_EVT, hci_evt_code, hci_evt_len);
+
   // validate event size
   if (hci_evt_len < hci_event_parameters_minimum_length[hci_evt_code]) {
     HCI_TRACE_WARNING("%s: evt:0x%2X, malformed event of size %hhd", __func__,
@@ -270,194 +534,8 @@ void btu_hcif_process_event(UNUSED_ATTR uint8_t controller_id, BT_HDR* p_msg) {
 
   btu_hcif_log_event_metrics(hci_evt_code, p);
 
-  switch (hci_evt_code) {
-    case HCI_INQUIRY_COMP_EVT:
-      btu_hcif_inquiry_comp_evt(p);
-      break;
-    case HCI_INQUIRY_RESULT_EVT:
-      btm_process_inq_results(p, hci_evt_len, BTM_INQ_RESULT_STANDARD);
-      break;
-    case HCI_INQUIRY_RSSI_RESULT_EVT:
-      btm_process_inq_results(p, hci_evt_len, BTM_INQ_RESULT_WITH_RSSI);
-      break;
-    case HCI_EXTENDED_INQUIRY_RESULT_EVT:
-      btm_process_inq_results(p, hci_evt_len, BTM_INQ_RESULT_EXTENDED);
-      break;
-    case HCI_CONNECTION_COMP_EVT:
-      btu_hcif_connection_comp_evt(p, hci_evt_len);
-      break;
-    case HCI_CONNECTION_REQUEST_EVT:
-      btu_hcif_connection_request_evt(p);
-      break;
-    case HCI_DISCONNECTION_COMP_EVT:
-      btu_hcif_disconnection_comp_evt(p);
-      break;
-    case HCI_AUTHENTICATION_COMP_EVT:
-      btu_hcif_authentication_comp_evt(p);
-      break;
-    case HCI_RMT_NAME_REQUEST_COMP_EVT:
-      btu_hcif_rmt_name_request_comp_evt(p, hci_evt_len);
-      break;
-    case HCI_ENCRYPTION_CHANGE_EVT:
-      btu_hcif_encryption_change_evt(p);
-      break;
-    case HCI_ENCRYPTION_KEY_REFRESH_COMP_EVT:
-      btu_hcif_encryption_key_refresh_cmpl_evt(p);
-      break;
-    case HCI_READ_RMT_FEATURES_COMP_EVT:
-      btm_read_remote_features_complete_raw(p);
-      break;
-    case HCI_READ_RMT_EXT_FEATURES_COMP_EVT:
-      btu_hcif_read_rmt_ext_features_comp_evt(p, hci_evt_len);
-      break;
-    case HCI_READ_RMT_VERSION_COMP_EVT:
-      btm_read_remote_version_complete_raw(p);
-      break;
-    case HCI_COMMAND_COMPLETE_EVT:
-      LOG_ERROR(
-          "%s should not have received a command complete event. "
-          "Someone didn't go through the hci transmit_command function.",
-          __func__);
-      break;
-    case HCI_COMMAND_STATUS_EVT:
-      LOG_ERROR(
-          "%s should not have received a command status event. "
-          "Someone didn't go through the hci transmit_command function.",
-          __func__);
-      break;
-    case HCI_HARDWARE_ERROR_EVT:
-      btu_hcif_hardware_error_evt(p);
-      break;
-    case HCI_ROLE_CHANGE_EVT:
-      btu_hcif_role_change_evt(p);
-      break;
-    case HCI_NUM_COMPL_DATA_PKTS_EVT:
-      acl_process_num_completed_pkts(p, hci_evt_len);
-      break;
-    case HCI_MODE_CHANGE_EVT:
-      btu_hcif_mode_change_evt(p);
-      break;
-    case HCI_PIN_CODE_REQUEST_EVT:
-      btm_sec_pin_code_request(p);
-      break;
-    case HCI_LINK_KEY_REQUEST_EVT:
-      btm_sec_link_key_request(p);
-      break;
-    case HCI_LINK_KEY_NOTIFICATION_EVT:
-      btu_hcif_link_key_notification_evt(p);
-      break;
-    case HCI_READ_CLOCK_OFF_COMP_EVT:
-      btu_hcif_read_clock_off_comp_evt(p);
-      break;
-    case HCI_ESCO_CONNECTION_COMP_EVT:
-      btu_hcif_esco_connection_comp_evt(p);
-      break;
-    case HCI_ESCO_CONNECTION_CHANGED_EVT:
-      btu_hcif_esco_connection_chg_evt(p);
-      break;
-    case HCI_SNIFF_SUB_RATE_EVT:
-      btm_pm_proc_ssr_evt(p, hci_evt_len);
-      break;
-    case HCI_RMT_HOST_SUP_FEAT_NOTIFY_EVT:
-      btm_sec_rmt_host_support_feat_evt(p);
-      break;
-    case HCI_IO_CAPABILITY_REQUEST_EVT:
-      btu_hcif_io_cap_request_evt(p);
-      break;
-    case HCI_IO_CAPABILITY_RESPONSE_EVT:
-      btm_io_capabilities_rsp(p);
-      break;
-    case HCI_USER_CONFIRMATION_REQUEST_EVT:
-      btm_proc_sp_req_evt(BTM_SP_CFM_REQ_EVT, p);
-      break;
-    case HCI_USER_PASSKEY_REQUEST_EVT:
-      btm_proc_sp_req_evt(BTM_SP_KEY_REQ_EVT, p);
-      break;
-    case HCI_REMOTE_OOB_DATA_REQUEST_EVT:
-      btm_rem_oob_req(p);
-      break;
-    case HCI_SIMPLE_PAIRING_COMPLETE_EVT:
-      btm_simple_pair_complete(p);
-      break;
-    case HCI_USER_PASSKEY_NOTIFY_EVT:
-      btm_proc_sp_req_evt(BTM_SP_KEY_NOTIF_EVT, p);
-      break;
-
-    case HCI_BLE_EVENT: {
-      STREAM_TO_UINT8(ble_sub_code, p);
-
-      uint8_t ble_evt_len = hci_evt_len - 1;
-      switch (ble_sub_code) {
-        case HCI_BLE_ADV_PKT_RPT_EVT: /* result of inquiry */
-          btm_ble_process_adv_pkt(ble_evt_len, p);
-          break;
-        case HCI_BLE_CONN_COMPLETE_EVT:
-          btm_ble_conn_complete(p, hci_evt_len, false);
-          break;
-        case HCI_BLE_LL_CONN_PARAM_UPD_EVT:
-          btu_ble_ll_conn_param_upd_evt(p, hci_evt_len);
-          break;
-        case HCI_BLE_READ_REMOTE_FEAT_CMPL_EVT:
-          btm_ble_read_remote_features_complete(p);
-          break;
-        case HCI_BLE_LTK_REQ_EVT: /* received only at peripheral device */
-          btu_ble_proc_ltk_req(p);
-          break;
-        case HCI_BLE_ENHANCED_CONN_COMPLETE_EVT:
-          btm_ble_conn_complete(p, hci_evt_len, true);
-          break;
-        case HCI_BLE_RC_PARAM_REQ_EVT:
-          btu_ble_rc_param_req_evt(p);
-          break;
-        case HCI_BLE_DATA_LENGTH_CHANGE_EVT:
-          btu_ble_data_length_change_evt(p, hci_evt_len);
-          break;
-
-        case HCI_BLE_PHY_UPDATE_COMPLETE_EVT:
-          btm_ble_process_phy_update_pkt(ble_evt_len, p);
-          break;
-
-        case HCI_LE_EXTENDED_ADVERTISING_REPORT_EVT:
-          btm_ble_process_ext_adv_pkt(hci_evt_len, p);
-          break;
-
-        case HCI_LE_ADVERTISING_SET_TERMINATED_EVT:
-          btm_le_on_advertising_set_terminated(p, hci_evt_len);
-          break;
-
-        case HCI_BLE_REQ_PEER_SCA_CPL_EVT:
-          btm_acl_process_sca_cmpl_pkt(ble_evt_len, p);
-          break;
-
-        case HCI_BLE_PERIODIC_ADV_SYNC_EST_EVT:
-          btm_ble_process_periodic_adv_sync_est_evt(ble_evt_len, p);
-          break;
-
-        case HCI_BLE_PERIODIC_ADV_REPORT_EVT:
-          btm_ble_process_periodic_adv_pkt(ble_evt_len, p);
-          break;
-
-        case HCI_BLE_PERIODIC_ADV_SYNC_LOST_EVT:
-          btm_ble_process_periodic_adv_sync_lost_evt(ble_evt_len, p);
-          break;
-
-        case HCI_BLE_CIS_EST_EVT:
-        case HCI_BLE_CREATE_BIG_CPL_EVT:
-        case HCI_BLE_TERM_BIG_CPL_EVT:
-        case HCI_BLE_CIS_REQ_EVT:
-        case HCI_BLE_BIG_SYNC_EST_EVT:
-        case HCI_BLE_BIG_SYNC_LOST_EVT:
-          IsoManager::GetInstance()->HandleHciEvent(ble_sub_code, p,
-                                                    ble_evt_len);
-          break;
-      }
-      break;
-    }
-
-    case HCI_VENDOR_SPECIFIC_EVT:
-      btm_vendor_specific_evt(p, hci_evt_len);
-      break;
-  }
+  const tBTU_HCIF_EVT_HANDLER handler = btu_hcif_event_table[hci_evt_code];
+  if (handler != nullptr) handler(p, hci_evt_len);
 }
 
 static void btu_hcif_log_command_metrics(uint16_t opcode, uint8_t* p_cmd,
@@ -845,9 +923,9 @@ static void btu_hcif_command_complete_evt_with_cb_on_task(BT_HDR* event,
 
 static void btu_hcif_command_complete_evt_with_cb(BT_HDR* response,
                                                   void* context) {
-  do_in_main_thread(FROM_HERE,
-                    base::Bind(btu_hcif_command_complete_evt_with_cb_on_task,
-                               response, context));
+  do_in_main_thread(
+      FROM_HERE, base::BindOnce(btu_hcif_command_complete_evt_with_cb_on_task,
+                                response, context));
 }
 
 static void btu_hcif_command_status_evt_with_cb_on_task(uint8_t status,
@@ -883,8 +961,8 @@ static void btu_hcif_command_status_evt_with_cb(uint8_t status, BT_HDR* command,
   }
 
   do_in_main_thread(
-      FROM_HERE, base::Bind(btu_hcif_command_status_evt_with_cb_on_task, status,
-                            command, context));
+      FROM_HERE, base::BindOnce(btu_hcif_command_status_evt_with_cb_on_task,
+                                status, command, context));
 }
 
 /* This function is called to send commands to the Host Controller. |cb| is
@@ -1376,8 +1454,9 @@ static void btu_hcif_command_complete_evt_on_task(BT_HDR* event,
 }
 
 static void btu_hcif_command_complete_evt(BT_HDR* response, void* context) {
-  do_in_main_thread(FROM_HERE, base::Bind(btu_hcif_command_complete_evt_on_task,
-                                          response, context));
+  do_in_main_thread(
+      FROM_HERE, base::BindOnce(btu_hcif_command_complete_evt_on_task, response,
+                                context));
 }
 
 /*******************************************************************************
@@ -1526,8 +1605,9 @@ static void btu_hcif_command_status_evt_on_task(uint8_t status, BT_HDR* event,
 
 static void btu_hcif_command_status_evt(uint8_t status, BT_HDR* command,
                                         void* context) {
-  do_in_main_thread(FROM_HERE, base::Bind(btu_hcif_command_status_evt_on_task,
-                                          status, command, context));
+  do_in_main_thread(
+      FROM_HERE, base::BindOnce(btu_hcif_command_status_evt_on_task, status,
+                                command, context));
 }
 
 /*******************************************************************************
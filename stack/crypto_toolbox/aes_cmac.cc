@@ -58,23 +58,77 @@ static void xor_128(Octet16* a, const Octet16& b) {
 }
 }  // namespace
 
-/* This function computes AES_128(key, message) */
-Octet16 aes_128(const Octet16& key, const Octet16& message) {
-  Octet16 key_reversed;
+/* Registered hardware backend, NULL when the software cipher is in use */
+static const tAES_128_BACKEND* aes_128_backend = nullptr;
+
+void aes_128_set_backend(const tAES_128_BACKEND* backend) {
+  aes_128_backend = backend;
+  LOG(INFO) << __func__ << ": AES-128 backend is "
+            << (backend ? backend->name : "software");
+}
+
+Aes128Context::Aes128Context(const Octet16& key) {
+  std::reverse_copy(key.begin(), key.end(), key_reversed_.begin());
+  aes_set_key(key_reversed_.data(), key_reversed_.size(), &ctx_);
+}
+
+Octet16 Aes128Context::encrypt(const Octet16& message) const {
   Octet16 message_reversed;
   Octet16 output;
 
-  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
   std::reverse_copy(message.begin(), message.end(), message_reversed.begin());
 
-  aes_context ctx;
-  aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
-  aes_encrypt(message_reversed.data(), output.data(), &ctx);
+  if (aes_128_backend == nullptr ||
+      !aes_128_backend->encrypt_blocks(key_reversed_.data(),
+                                       message_reversed.data(), output.data(),
+                                       1)) {
+    aes_encrypt(message_reversed.data(), output.data(), &ctx_);
+  }
 
   std::reverse(output.begin(), output.end());
   return output;
 }
 
+/* This function computes AES_128(key, message) */
+Octet16 aes_128(const Octet16& key, const Octet16& message) {
+  return Aes128Context(key).encrypt(message);
+}
+
+std::vector<Octet16> aes_128_batch(const Octet16& key,
+                                   const std::vector<Octet16>& messages) {
+  std::vector<Octet16> output;
+  output.reserve(messages.size());
+
+  if (aes_128_backend != nullptr && !messages.empty()) {
+    Octet16 key_reversed;
+    std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
+
+    std::vector<uint8_t> in(messages.size() * OCTET16_LEN);
+    std::vector<uint8_t> out(messages.size() * OCTET16_LEN);
+    for (size_t i = 0; i < messages.size(); i++) {
+      std::reverse_copy(messages[i].begin(), messages[i].end(),
+                        in.begin() + i * OCTET16_LEN);
+    }
+
+    if (aes_128_backend->encrypt_blocks(key_reversed.data(), in.data(),
+                                        out.data(), messages.size())) {
+      for (size_t i = 0; i < messages.size(); i++) {
+        Octet16 block;
+        std::reverse_copy(out.begin() + i * OCTET16_LEN,
+                          out.begin() + (i + 1) * OCTET16_LEN, block.begin());
+        output.push_back(block);
+      }
+      return output;
+    }
+  }
+
+  Aes128Context ctx(key);
+  for (const Octet16& message : messages) {
+    output.push_back(ctx.encrypt(message));
+  }
+  return output;
+}
+
 /** utility function to padding the given text to be a 128 bits data. The
  * parameter dest is input and output parameter, it must point to a
  * OCTET16_LEN memory space; where include length bytes valid data. */
@@ -98,8 +152,9 @@ static void leftshift_onebit(uint8_t* input, uint8_t* output) {
   return;
 }
 
-/** This function is the calculation of block cipher using AES-128. */
-static Octet16 cmac_aes_k_calculate(const Octet16& key) {
+/** This function is the calculation of block cipher using AES-128. The
+ * expanded |key| schedule is shared across all rounds. */
+static Octet16 cmac_aes_k_calculate(const Aes128Context& key_ctx) {
   Octet16 output;
   Octet16 x{0};  // zero initialized
 
@@ -110,8 +165,10 @@ static Octet16 cmac_aes_k_calculate(const Octet16& key) {
     /* Mi' := Mi (+) X  */
     xor_128((Octet16*)&cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN], x);
 
-    output = aes_128(key, &cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN],
-                     OCTET16_LEN);
+    Octet16 block;
+    memcpy(block.data(), &cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN],
+           OCTET16_LEN);
+    output = key_ctx.encrypt(block);
     x = output;
     i++;
   }
@@ -145,11 +202,11 @@ static void cmac_prepare_last_block(const Octet16& k1, const Octet16& k2) {
 /** This is the function to generate the two subkeys.
  * |key| is CMAC key, expect SRK when used by SMP.
  */
-static void cmac_generate_subkey(const Octet16& key) {
+static void cmac_generate_subkey(const Aes128Context& key_ctx) {
   DVLOG(2) << __func__;
 
   Octet16 zero{};
-  Octet16 p = aes_128(key, zero.data(), OCTET16_LEN);
+  Octet16 p = key_ctx.encrypt(zero);
 
   Octet16 k1, k2;
   uint8_t* pp = p.data();
@@ -203,10 +260,13 @@ Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
     cmac_cb.len = 0;
   }
 
+  /* expand the key schedule once for the subkeys and every round */
+  Aes128Context key_ctx(key);
+
   /* prepare calculation for subkey s and last block of data */
-  cmac_generate_subkey(key);
+  cmac_generate_subkey(key_ctx);
   /* start calculation */
-  Octet16 signature = cmac_aes_k_calculate(key);
+  Octet16 signature = cmac_aes_k_calculate(key_ctx);
 
   /* clean up */
   memset(&cmac_cb, 0, sizeof(tCMAC_CB));
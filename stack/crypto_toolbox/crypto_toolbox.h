@@ -17,11 +17,47 @@
 #pragma once
 #include <base/logging.h>
 
+#include <vector>
+
+#include "stack/crypto_toolbox/aes.h"
 #include "stack/include/bt_types.h"
 
 namespace crypto_toolbox {
 
+/* Optional hardware AES backend. |encrypt_blocks| encrypts |num_blocks|
+ * consecutive 16-byte blocks of |in| into |out| under |key|, all in standard
+ * (big-endian) AES byte order, and returns false to fall back to the
+ * software implementation. Platforms with AES-NI or ARMv8-CE register one
+ * at startup; passing NULL restores the software path. */
+typedef struct {
+  const char* name;
+  bool (*encrypt_blocks)(const uint8_t* key, const uint8_t* in, uint8_t* out,
+                         size_t num_blocks);
+} tAES_128_BACKEND;
+
+extern void aes_128_set_backend(const tAES_128_BACKEND* backend);
+
+/* Caches the AES-128 key schedule for one key, so repeated encryptions
+ * under that key (CMAC rounds, RPA candidate checks against one IRK) skip
+ * the per-call key expansion that aes_128() performs. */
+class Aes128Context {
+ public:
+  explicit Aes128Context(const Octet16& key);
+
+  Octet16 encrypt(const Octet16& message) const;
+
+ private:
+  Octet16 key_reversed_;
+  aes_context ctx_;
+};
+
 extern Octet16 aes_128(const Octet16& key, const Octet16& message);
+
+/* Encrypts each element of |messages| under |key| with a single key
+ * expansion, handing the whole run to the hardware backend in one call when
+ * one is registered. Intended for resolving a batch of RPA candidates. */
+extern std::vector<Octet16> aes_128_batch(const Octet16& key,
+                                          const std::vector<Octet16>& messages);
 extern Octet16 aes_cmac(const Octet16& key, const uint8_t* message,
                         uint16_t length);
 extern Octet16 f4(const uint8_t* u, const uint8_t* v, const Octet16& x,
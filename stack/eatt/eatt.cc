@@ -125,6 +125,10 @@ void EattExtension::Connect(const RawAddress& bd_addr) {
   pimpl_->eatt_impl_->connect(bd_addr);
 }
 
+void EattExtension::EncryptionComplete(const RawAddress& bd_addr) {
+  pimpl_->eatt_impl_->encryption_complete(bd_addr);
+}
+
 void EattExtension::Disconnect(const RawAddress& bd_addr) {
   pimpl_->eatt_impl_->disconnect(bd_addr);
 }
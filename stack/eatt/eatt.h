@@ -121,6 +121,14 @@ class EattExtension {
    */
   virtual void Connect(const RawAddress& bd_addr);
 
+  /**
+   * Notify EATT that link encryption completed. Brings up any EATT channels
+   * whose establishment was deferred until the link got encrypted.
+   *
+   * @param bd_addr peer device address
+   */
+  virtual void EncryptionComplete(const RawAddress& bd_addr);
+
   /**
    * Disconnect all EATT channels to peer device.
    *
@@ -44,8 +44,13 @@ class eatt_device {
 
   std::map<uint16_t, std::shared_ptr<EattChannel>> eatt_channels;
 
+  /* True when the eCoC connect request is held back until the link gets
+   * encrypted; see eatt_impl::encryption_complete */
+  bool connect_deferred_;
+
   eatt_device(const RawAddress& bd_addr, uint16_t mtu, uint16_t mps)
-      : rx_mtu_(mtu), rx_mps_(mps), eatt_tcb_(nullptr) {
+      : rx_mtu_(mtu), rx_mps_(mps), eatt_tcb_(nullptr),
+        connect_deferred_(false) {
     bda_ = bd_addr;
   }
 };
@@ -393,19 +398,24 @@ struct eatt_impl {
                                                    : iter->second.get();
   };
 
+  /* Returns the opened channel with the fewest queued client commands, so
+   * that independent requests fan out over every channel instead of
+   * serializing behind the first one. Can return a busy channel; the caller
+   * decides whether queueing there beats the unenhanced ATT channel. */
   EattChannel* get_channel_available_for_client_request(
       const RawAddress& bd_addr) {
     eatt_device* eatt_dev = find_device_by_address(bd_addr);
     if (!eatt_dev) return nullptr;
 
-    auto iter = find_if(
-        eatt_dev->eatt_channels.begin(), eatt_dev->eatt_channels.end(),
-        [](const std::pair<uint16_t, std::shared_ptr<EattChannel>>& el) {
-          return el.second->cl_cmd_q_.empty();
-        });
+    EattChannel* best = nullptr;
+    for (const auto& el : eatt_dev->eatt_channels) {
+      EattChannel* channel = el.second.get();
+      if (channel->state_ != EattChannelState::EATT_CHANNEL_OPENED) continue;
+      if (!best || channel->cl_cmd_q_.size() < best->cl_cmd_q_.size())
+        best = channel;
+    }
 
-    return (iter == eatt_dev->eatt_channels.end()) ? nullptr
-                                                   : iter->second.get();
+    return best;
   }
 
   void free_gatt_resources(const RawAddress& bd_addr) {
@@ -646,6 +656,16 @@ struct eatt_impl {
         return;
       }
 
+      if (btm_sec_is_a_bonded_dev(bd_addr) &&
+          !BTM_IsEncrypted(bd_addr, BT_TRANSPORT_LE)) {
+        /* A bonded peer will typically reject eCoC before encryption. Hold
+         * the request and pre-warm the channels the moment encryption
+         * completes, so the first GATT burst finds them open. */
+        LOG(INFO) << __func__ << " Bonded device, wait for encryption";
+        eatt_dev->connect_deferred_ = true;
+        return;
+      }
+
       connect_eatt(eatt_dev);
       return;
     }
@@ -659,6 +679,18 @@ struct eatt_impl {
     }
   }
 
+  void encryption_complete(const RawAddress& bd_addr) {
+    eatt_device* eatt_dev = find_device_by_address(bd_addr);
+    if (!eatt_dev || !eatt_dev->connect_deferred_) return;
+
+    eatt_dev->connect_deferred_ = false;
+
+    if (L2CA_GetBleConnRole(bd_addr) != HCI_ROLE_CENTRAL) return;
+
+    LOG(INFO) << __func__ << " " << bd_addr << ", pre-warming EATT channels";
+    connect_eatt(eatt_dev);
+  }
+
   void add_from_storage(const RawAddress& bd_addr) {
     eatt_device* eatt_dev = find_device_by_address(bd_addr);
 
@@ -37,6 +37,29 @@ using bluetooth::Uuid;
 /**********************************************************************
  *   ATT protocl message building utility                              *
  **********************************************************************/
+/*******************************************************************************
+ *
+ * Function         attp_get_pdu_buf
+ *
+ * Description      Allocate a transmit buffer sized exactly for |pdu_len|
+ *                  PDU bytes, with the L2CAP + HCI header offset reserved
+ *                  up front so the lower layers prepend their headers in
+ *                  place instead of copying.
+ *
+ * Returns          pointer to the buffer; the PDU starts at
+ *                  (p_buf + 1) + p_buf->offset.
+ *
+ ******************************************************************************/
+static BT_HDR* attp_get_pdu_buf(uint16_t pdu_len) {
+  BT_HDR* p_buf =
+      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + L2CAP_MIN_OFFSET + pdu_len);
+
+  p_buf->offset = L2CAP_MIN_OFFSET;
+  p_buf->len = 0;
+
+  return p_buf;
+}
+
 /*******************************************************************************
  *
  * Function         attp_build_mtu_exec_cmd
@@ -48,14 +71,12 @@ using bluetooth::Uuid;
  ******************************************************************************/
 static BT_HDR* attp_build_mtu_cmd(uint8_t op_code, uint16_t rx_mtu) {
   uint8_t* p;
-  BT_HDR* p_buf =
-      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + GATT_HDR_SIZE + L2CAP_MIN_OFFSET);
+  BT_HDR* p_buf = attp_get_pdu_buf(GATT_HDR_SIZE);
 
-  p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  p = (uint8_t*)(p_buf + 1) + p_buf->offset;
   UINT8_TO_STREAM(p, op_code);
   UINT16_TO_STREAM(p, rx_mtu);
 
-  p_buf->offset = L2CAP_MIN_OFFSET;
   p_buf->len = GATT_HDR_SIZE; /* opcode + 2 bytes mtu */
 
   return p_buf;
@@ -70,12 +91,11 @@ static BT_HDR* attp_build_mtu_cmd(uint8_t op_code, uint16_t rx_mtu) {
  *
  ******************************************************************************/
 static BT_HDR* attp_build_exec_write_cmd(uint8_t op_code, uint8_t flag) {
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(GATT_DATA_BUF_SIZE);
+  BT_HDR* p_buf = attp_get_pdu_buf(GATT_OP_CODE_SIZE + 1);
   uint8_t* p;
 
-  p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  p = (uint8_t*)(p_buf + 1) + p_buf->offset;
 
-  p_buf->offset = L2CAP_MIN_OFFSET;
   p_buf->len = GATT_OP_CODE_SIZE;
 
   UINT8_TO_STREAM(p, op_code);
@@ -101,15 +121,14 @@ static BT_HDR* attp_build_exec_write_cmd(uint8_t op_code, uint8_t flag) {
 static BT_HDR* attp_build_err_cmd(uint8_t cmd_code, uint16_t err_handle,
                                   uint8_t reason) {
   uint8_t* p;
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + L2CAP_MIN_OFFSET + 5);
+  BT_HDR* p_buf = attp_get_pdu_buf(GATT_HDR_SIZE + 1 + 1);
 
-  p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  p = (uint8_t*)(p_buf + 1) + p_buf->offset;
   UINT8_TO_STREAM(p, GATT_RSP_ERROR);
   UINT8_TO_STREAM(p, cmd_code);
   UINT16_TO_STREAM(p, err_handle);
   UINT8_TO_STREAM(p, reason);
 
-  p_buf->offset = L2CAP_MIN_OFFSET;
   /* GATT_HDR_SIZE (1B ERR_RSP op code+ 2B handle) + 1B cmd_op_code  + 1B status
    */
   p_buf->len = GATT_HDR_SIZE + 1 + 1;
@@ -130,12 +149,10 @@ static BT_HDR* attp_build_browse_cmd(uint8_t op_code, uint16_t s_hdl,
                                      const bluetooth::Uuid& uuid) {
   const size_t payload_size =
       (GATT_OP_CODE_SIZE) + (GATT_START_END_HANDLE_SIZE) + (Uuid::kNumBytes128);
-  BT_HDR* p_buf =
-      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+  BT_HDR* p_buf = attp_get_pdu_buf(payload_size);
 
-  uint8_t* p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  uint8_t* p = (uint8_t*)(p_buf + 1) + p_buf->offset;
   /* Describe the built message location and size */
-  p_buf->offset = L2CAP_MIN_OFFSET;
   p_buf->len = GATT_OP_CODE_SIZE + 4;
 
   UINT8_TO_STREAM(p, op_code);
@@ -159,11 +176,9 @@ static BT_HDR* attp_build_read_by_type_value_cmd(
     uint16_t payload_size, tGATT_FIND_TYPE_VALUE* p_value_type) {
   uint8_t* p;
   uint16_t len = p_value_type->value_len;
-  BT_HDR* p_buf =
-      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+  BT_HDR* p_buf = attp_get_pdu_buf(payload_size);
 
-  p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
-  p_buf->offset = L2CAP_MIN_OFFSET;
+  p = (uint8_t*)(p_buf + 1) + p_buf->offset;
   p_buf->len = 5; /* opcode + s_handle + e_handle */
 
   UINT8_TO_STREAM(p, GATT_REQ_FIND_TYPE_VALUE);
@@ -194,11 +209,9 @@ static BT_HDR* attp_build_read_multi_cmd(uint8_t op_code, uint16_t payload_size,
                                          uint16_t num_handle,
                                          uint16_t* p_handle) {
   uint8_t *p, i = 0;
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + num_handle * 2 + 1 +
-                                      L2CAP_MIN_OFFSET);
+  BT_HDR* p_buf = attp_get_pdu_buf(num_handle * 2 + 1);
 
-  p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
-  p_buf->offset = L2CAP_MIN_OFFSET;
+  p = (uint8_t*)(p_buf + 1) + p_buf->offset;
   p_buf->len = 1;
 
   UINT8_TO_STREAM(p, op_code);
@@ -222,10 +235,9 @@ static BT_HDR* attp_build_read_multi_cmd(uint8_t op_code, uint16_t payload_size,
 static BT_HDR* attp_build_handle_cmd(uint8_t op_code, uint16_t handle,
                                      uint16_t offset) {
   uint8_t* p;
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + 5 + L2CAP_MIN_OFFSET);
+  BT_HDR* p_buf = attp_get_pdu_buf(5);
 
-  p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
-  p_buf->offset = L2CAP_MIN_OFFSET;
+  p = (uint8_t*)(p_buf + 1) + p_buf->offset;
 
   UINT8_TO_STREAM(p, op_code);
   p_buf->len = 1;
@@ -252,10 +264,9 @@ static BT_HDR* attp_build_handle_cmd(uint8_t op_code, uint16_t handle,
  ******************************************************************************/
 static BT_HDR* attp_build_opcode_cmd(uint8_t op_code) {
   uint8_t* p;
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + 1 + L2CAP_MIN_OFFSET);
+  BT_HDR* p_buf = attp_get_pdu_buf(1);
 
-  p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
-  p_buf->offset = L2CAP_MIN_OFFSET;
+  p = (uint8_t*)(p_buf + 1) + p_buf->offset;
 
   UINT8_TO_STREAM(p, op_code);
   p_buf->len = 1;
@@ -275,46 +286,80 @@ static BT_HDR* attp_build_opcode_cmd(uint8_t op_code) {
 static BT_HDR* attp_build_value_cmd(uint16_t payload_size, uint8_t op_code,
                                     uint16_t handle, uint16_t offset,
                                     uint16_t len, uint8_t* p_data) {
-  uint8_t *p, *pp, pair_len, *p_pair_len;
-  BT_HDR* p_buf =
-      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+  uint8_t* p;
+  uint16_t hdr_len = 1; /* op code */
 
-  p = pp = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  if (op_code == GATT_RSP_READ_BY_TYPE) hdr_len += 1; /* pair length */
+  if (op_code != GATT_RSP_READ_BLOB && op_code != GATT_RSP_READ)
+    hdr_len += 2; /* handle */
+  if (op_code == GATT_REQ_PREPARE_WRITE || op_code == GATT_RSP_PREPARE_WRITE)
+    hdr_len += 2; /* value offset */
+
+  if (p_data == NULL) len = 0;
+
+  /* ensure data not exceed MTU size */
+  if (len > payload_size - hdr_len) {
+    len = payload_size - hdr_len;
+    LOG(WARNING) << StringPrintf(
+        "attribute value too long, to be truncated to %d", len);
+  }
+
+  /* with the PDU length known up front the buffer is sized exactly and
+   * the value is written into the transmit buffer in a single pass */
+  BT_HDR* p_buf = attp_get_pdu_buf(hdr_len + len);
+
+  p = (uint8_t*)(p_buf + 1) + p_buf->offset;
   UINT8_TO_STREAM(p, op_code);
-  p_buf->offset = L2CAP_MIN_OFFSET;
-  p_buf->len = 1;
 
   if (op_code == GATT_RSP_READ_BY_TYPE) {
-    p_pair_len = p;
-    pair_len = len + 2;
-    UINT8_TO_STREAM(p, pair_len);
-    p_buf->len += 1;
+    /* handle value pair length */
+    UINT8_TO_STREAM(p, (uint8_t)(len + 2));
   }
   if (op_code != GATT_RSP_READ_BLOB && op_code != GATT_RSP_READ) {
     UINT16_TO_STREAM(p, handle);
-    p_buf->len += 2;
   }
 
   if (op_code == GATT_REQ_PREPARE_WRITE || op_code == GATT_RSP_PREPARE_WRITE) {
     UINT16_TO_STREAM(p, offset);
-    p_buf->len += 2;
   }
 
-  if (len > 0 && p_data != NULL) {
-    /* ensure data not exceed MTU size */
-    if (payload_size - p_buf->len < len) {
-      len = payload_size - p_buf->len;
-      /* update handle value pair length */
-      if (op_code == GATT_RSP_READ_BY_TYPE) *p_pair_len = (len + 2);
+  if (len > 0) {
+    ARRAY_TO_STREAM(p, p_data, len);
+  }
 
-      LOG(WARNING) << StringPrintf(
-          "attribute value too long, to be truncated to %d", len);
-    }
+  p_buf->len = hdr_len + len;
 
-    ARRAY_TO_STREAM(p, p_data, len);
-    p_buf->len += len;
+  return p_buf;
+}
+
+/*******************************************************************************
+ *
+ * Function         attp_build_multi_ntf_cmd
+ *
+ * Description      Build a multiple handle value notification command from
+ *                  pre-serialized handle/length/value tuples.
+ *
+ * Returns          None.
+ *
+ ******************************************************************************/
+static BT_HDR* attp_build_multi_ntf_cmd(uint16_t payload_size, uint16_t len,
+                                        uint8_t* p_data) {
+  uint8_t* p;
+
+  /* the caller packs tuples against the MTU, never split one here */
+  if (len > payload_size - 1) {
+    LOG(ERROR) << StringPrintf("notification train too long: %d", len);
+    return NULL;
   }
 
+  BT_HDR* p_buf = attp_get_pdu_buf(len + 1);
+
+  p = (uint8_t*)(p_buf + 1) + p_buf->offset;
+
+  UINT8_TO_STREAM(p, GATT_HANDLE_MULTI_VALUE_NOTIF);
+  ARRAY_TO_STREAM(p, p_data, len);
+  p_buf->len = len + 1;
+
   return p_buf;
 }
 
@@ -368,6 +413,10 @@ BT_HDR* attp_build_sr_msg(tGATT_TCB& tcb, uint8_t op_code,
           tcb.payload_size, op_code, p_msg->attr_value.handle, offset,
           p_msg->attr_value.len, p_msg->attr_value.value);
 
+    case GATT_HANDLE_MULTI_VALUE_NOTIF:
+      return attp_build_multi_ntf_cmd(tcb.payload_size, p_msg->multi_ntf.len,
+                                      p_msg->multi_ntf.p_value);
+
     case GATT_RSP_WRITE:
       return attp_build_opcode_cmd(op_code);
 
@@ -421,6 +470,7 @@ tGATT_STATUS attp_send_sr_msg(tGATT_TCB& tcb, uint16_t cid, BT_HDR* p_msg) {
  * Returns          GATT_SUCCESS if command sent
  *                  GATT_CONGESTED if command sent but channel congested
  *                  GATT_CMD_STARTED if command queue up in GATT
+ *                  GATT_BUSY if the command queue is at its hard limit
  *                  GATT_ERROR if command sending failure
  *
  ******************************************************************************/
@@ -430,7 +480,12 @@ static tGATT_STATUS attp_cl_send_cmd(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
 
   if (gatt_tcb_is_cid_busy(tcb, p_clcb->cid) &&
       cmd_code != GATT_HANDLE_VALUE_CONF) {
-    gatt_cmd_enq(tcb, p_clcb, true, cmd_code, p_cmd);
+    if (!gatt_cmd_enq(tcb, p_clcb, true, cmd_code, p_cmd)) {
+      /* queue is at the hard limit; refuse rather than grow unbounded,
+       * the congestion callback told the app to pace some time ago */
+      osi_free(p_cmd);
+      return GATT_BUSY;
+    }
     LOG_DEBUG("Enqueued ATT command");
     return GATT_CMD_STARTED;
   }
@@ -26,6 +26,7 @@
 #include <memory>
 #include <set>
 
+#include "common/slo_monitor.h"
 #include "internal_include/bt_trace.h"
 #include "main/shim/shim.h"
 #include "osi/include/alarm.h"
@@ -184,6 +185,8 @@ static void remove_all_clients_with_pending_connections(
 void on_connection_complete(const RawAddress& address) {
   LOG_INFO("Le connection completed to device:%s", address.ToString().c_str());
 
+  bluetooth::common::SloMonitor::GetInstance()->OperationEnd(
+      bluetooth::common::SloOperation::kGattConnect, address);
   remove_all_clients_with_pending_connections(address);
 }
 
@@ -246,6 +249,9 @@ bool direct_connect_add(uint8_t app_id, const RawAddress& address) {
 
   bgconn_dev[address].doing_direct_conn.emplace(
       app_id, unique_alarm_ptr(timeout, &alarm_free));
+
+  bluetooth::common::SloMonitor::GetInstance()->OperationBegin(
+      bluetooth::common::SloOperation::kGattConnect, address);
   return true;
 }
 
@@ -257,6 +263,8 @@ static bool any_direct_connect_left() {
 }
 
 bool direct_connect_remove(uint8_t app_id, const RawAddress& address) {
+  bluetooth::common::SloMonitor::GetInstance()->OperationCancel(
+      bluetooth::common::SloOperation::kGattConnect, address);
   auto it = bgconn_dev.find(address);
   if (it == bgconn_dev.end()) {
     LOG_WARN("Unable to find background connection to remove");
@@ -308,6 +308,8 @@ tGATT_STATUS GATTS_AddService(tGATT_IF gatt_if, btgatt_db_element_t* service,
   elem.type = list.asgn_range.is_primary ? GATT_UUID_PRI_SERVICE
                                          : GATT_UUID_SEC_SERVICE;
 
+  gatt_cb.srv_handle_index.emplace(elem.s_hdl, rit);
+
   if (elem.type == GATT_UUID_PRI_SERVICE) {
     Uuid* p_uuid = gatts_get_service_uuid(elem.p_db);
     elem.sdp_handle = gatt_add_sdp_record(*p_uuid, elem.s_hdl, elem.e_hdl);
@@ -415,6 +417,7 @@ void GATTS_StopService(uint16_t service_handle) {
     SDP_DeleteRecord(it->sdp_handle);
   }
 
+  gatt_cb.srv_handle_index.erase(it->s_hdl);
   gatt_cb.srv_list_info->erase(it);
   gatt_update_last_srv_info();
 }
@@ -536,6 +539,83 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   return cmd_sent;
 }
 
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleValueNotificationCoalesced
+ *
+ * Description      This function queues a handle value notification for
+ *                  transmission in a multiple handle value notification PDU
+ *                  shared with other pending notifications on the link. The
+ *                  train is flushed when it fills the MTU or after a short
+ *                  coalescing window. Falls back to an immediate single
+ *                  notification when the client does not accept multiple
+ *                  handle value notifications.
+ *
+ * Parameter        conn_id: connection identifier.
+ *                  attr_handle: Attribute handle of this handle value
+ *                               indication.
+ *                  val_len: Length of the indicated attribute value.
+ *                  p_val: Pointer to the indicated attribute value data.
+ *
+ * Returns          GATT_SUCCESS if sucessfully sent or queued; otherwise
+ *                  error code.
+ *
+ ******************************************************************************/
+tGATT_STATUS GATTS_HandleValueNotificationCoalesced(uint16_t conn_id,
+                                                    uint16_t attr_handle,
+                                                    uint16_t val_len,
+                                                    uint8_t* p_val) {
+  tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
+  uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
+  tGATT_REG* p_reg = gatt_get_regcb(gatt_if);
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
+
+  VLOG(1) << __func__;
+
+  if ((p_reg == NULL) || (p_tcb == NULL)) {
+    LOG(ERROR) << __func__ << "Unknown  conn_id: " << conn_id;
+    return (tGATT_STATUS)GATT_INVALID_CONN_ID;
+  }
+
+  if (!GATT_HANDLE_IS_VALID(attr_handle)) {
+    return GATT_ILLEGAL_PARAMETER;
+  }
+
+  /* each tuple carries a 2 octet handle and a 2 octet value length; the
+   * opcode takes one octet of the payload */
+  uint16_t tuple_len = 4 + val_len;
+  if (!gatt_sr_is_cl_multi_notif_supported(*p_tcb) ||
+      tuple_len > p_tcb->payload_size - 1) {
+    return GATTS_HandleValueNotification(conn_id, attr_handle, val_len, p_val);
+  }
+
+  /* no room left in the pending train - push it out first */
+  if (p_tcb->ntf_train.len + tuple_len > p_tcb->payload_size - 1) {
+    tGATT_STATUS status = gatt_ntf_train_flush(*p_tcb);
+    if (status != GATT_SUCCESS && status != GATT_CONGESTED) return status;
+  }
+
+  if (p_tcb->ntf_train.len == 0) {
+    p_tcb->ntf_train.use_eatt = p_reg->eatt_support;
+  }
+
+  uint8_t* p = p_tcb->ntf_train.buf + p_tcb->ntf_train.len;
+  UINT16_TO_STREAM(p, attr_handle);
+  UINT16_TO_STREAM(p, val_len);
+  ARRAY_TO_STREAM(p, p_val, val_len);
+  p_tcb->ntf_train.len += tuple_len;
+  p_tcb->ntf_train.count++;
+
+  /* a train that cannot take even an empty tuple goes out right away;
+   * otherwise leave a short window for more notifications to join it */
+  if (p_tcb->ntf_train.len + 4 > p_tcb->payload_size - 1) {
+    return gatt_ntf_train_flush(*p_tcb);
+  }
+
+  gatt_start_ntf_flush_timer(*p_tcb);
+  return GATT_SUCCESS;
+}
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -34,6 +34,9 @@
 #include "stack/btm/btm_ble_int_types.h"
 #include "stack/btm/btm_int.h"
 #include "stack/btm/btm_sec.h"
+#include "stack/eatt/eatt.h"
+
+using bluetooth::eatt::EattExtension;
 
 using base::StringPrintf;
 
@@ -231,6 +234,9 @@ void gatt_notify_enc_cmpl(const RawAddress& bd_addr) {
     }
     p_tcb->pending_enc_clcb = new_pending_clcbs;
   }
+
+  /* bring up any EATT channels deferred until encryption */
+  EattExtension::GetInstance()->EncryptionComplete(bd_addr);
 }
 /*******************************************************************************
  *
@@ -29,6 +29,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
 #include "gatt_int.h"
 #include "l2c_api.h"
 #include "osi/include/osi.h"
@@ -274,8 +275,11 @@ tGATT_STATUS gatts_db_read_attr_value_by_type(
   uint8_t* p = (uint8_t*)(p_rsp + 1) + p_rsp->len + L2CAP_MIN_OFFSET;
 
   if (p_db) {
-    for (tGATT_ATTR& attr : p_db->attr_list) {
-      if (attr.handle >= s_handle && type == attr.uuid) {
+    /* skip straight to the start of the requested range */
+    for (auto it = find_attr_lower_bound(*p_db, s_handle);
+         it != p_db->attr_list.end(); it++) {
+      tGATT_ATTR& attr = *it;
+      if (type == attr.uuid) {
         if (*p_len <= 2) {
           status = GATT_NO_RESOURCES;
           break;
@@ -436,15 +440,22 @@ uint16_t gatts_add_char_descr(tGATT_SVC_DB& db, tGATT_PERM perm,
 /******************************************************************************/
 /* Service Attribute Database Query Utility Functions */
 /******************************************************************************/
+
+/* attr_list handles are assigned monotonically in allocate_attr_in_db, so the
+ * vector is always sorted by handle and can be binary searched directly. */
+std::vector<tGATT_ATTR>::iterator find_attr_lower_bound(tGATT_SVC_DB& db,
+                                                        uint16_t handle) {
+  return std::lower_bound(
+      db.attr_list.begin(), db.attr_list.end(), handle,
+      [](const tGATT_ATTR& attr, uint16_t h) { return attr.handle < h; });
+}
+
 tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle) {
   if (!p_db) return nullptr;
 
-  for (auto& attr : p_db->attr_list) {
-    if (attr.handle == handle) return &attr;
-    if (attr.handle > handle) return nullptr;
-  }
-
-  return nullptr;
+  auto it = find_attr_lower_bound(*p_db, handle);
+  if (it == p_db->attr_list.end() || it->handle != handle) return nullptr;
+  return &(*it);
 }
 
 /*******************************************************************************
@@ -24,12 +24,21 @@
 #include "btm_ble_api.h"
 #include "btu.h"
 #include "gatt_api.h"
+#include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 
+/* Attribute this module's allocations to GATT in the memory ledger */
+#ifndef osi_malloc
+#define osi_malloc(size) osi_malloc_tagged((size), ALLOC_TAG_GATT)
+#define osi_calloc(size) osi_calloc_tagged((size), ALLOC_TAG_GATT)
+#endif
+
 #include <base/bind.h>
 #include <base/strings/stringprintf.h>
 #include <string.h>
 #include <list>
+#include <map>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -84,6 +93,23 @@ inline std::string gatt_security_action_text(const tGATT_SEC_ACTION& action) {
 #define GATT_WAIT_FOR_DISC_RSP_TIMEOUT_MS (5 * 1000)
 #define GATT_REQ_RETRY_LIMIT 2
 
+/* window for further notifications to join a pending coalesced train
+ * before it is flushed; the osi alarm granularity is 1 ms */
+#define GATT_NTF_FLUSH_TIMEOUT_MS 1
+
+/* initial capacity of the per-TCB pending indication ring; the ring is
+ * doubled when full so the queue stays unbounded */
+#define GATT_PENDING_IND_RING_INIT_CAP 8
+
+/* admission control for the client command queues; depth counts the
+ * unenhanced bearer and all EATT channels of a connection together.
+ * Crossing the high watermark raises the application congestion
+ * callback, dropping to the low watermark clears it, and commands
+ * beyond the hard limit are refused with GATT_CONGESTED */
+#define GATT_CL_CMD_Q_HIGH_WATERMARK 30
+#define GATT_CL_CMD_Q_LOW_WATERMARK 10
+#define GATT_CL_CMD_Q_HARD_LIMIT 60
+
 #define GATT_SEC_FLAG_LKEY_UNAUTHED BTM_SEC_FLAG_LKEY_KNOWN
 #define GATT_SEC_FLAG_LKEY_AUTHED BTM_SEC_FLAG_LKEY_AUTHED
 #define GATT_SEC_FLAG_ENCRYPTED BTM_SEC_FLAG_ENCRYPTED
@@ -131,10 +157,17 @@ typedef struct {
 
 /* server response message to ATT protocol
 */
+/* serialized handle/length/value tuples of a coalesced notification train */
+typedef struct {
+  uint16_t len;
+  uint8_t* p_value;
+} tGATT_MULTI_NTF;
+
 typedef union {
   /* data type            member          event   */
   tGATT_VALUE attr_value; /* READ, HANDLE_VALUE_IND, PREPARE_WRITE */
                           /* READ_BLOB, READ_BY_TYPE */
+  tGATT_MULTI_NTF multi_ntf; /* HANDLE_MULTI_VALUE_NOTIF */
   tGATT_ERROR error;      /* ERROR_RSP */
   uint16_t handle;        /* WRITE, WRITE_BLOB */
   uint16_t mtu;           /* exchange MTU request */
@@ -304,7 +337,16 @@ typedef struct {
   /* server response data */
   tGATT_SR_CMD sr_cmd;
   uint16_t indicate_handle;
-  fixed_queue_t* pending_ind_q;
+
+  /* server indications queued while one is outstanding; the ring storage
+   * is allocated on the first queued indication and doubled when full, so
+   * steady-state enqueue/dequeue does not allocate */
+  struct {
+    tGATT_VALUE* buf; /* ring storage, |cap| entries */
+    uint16_t cap;
+    uint16_t head; /* index of the oldest queued indication */
+    uint16_t count;
+  } pending_ind_ring;
 
   alarm_t* conf_timer; /* peer confirm to indication timer */
 
@@ -312,8 +354,25 @@ typedef struct {
   uint8_t ind_count;
 
   std::queue<tGATT_CMD_Q> cl_cmd_q;
+
+  /* client command queue admission control, across all bearers */
+  uint16_t cl_cmd_q_depth = 0;     /* commands queued right now */
+  uint16_t cl_cmd_q_max_depth = 0; /* watermark since connection setup */
+  uint32_t cl_cmd_q_rejected = 0;  /* commands refused at the hard limit */
+  bool cl_cmd_q_app_congested = false; /* apps told to pace */
+
   alarm_t* ind_ack_timer; /* local app confirm to indication timer */
 
+  /* pending notifications coalescing into one ATT Multiple Handle Value
+   * Notifications PDU; buf holds serialized handle/length/value tuples */
+  struct {
+    uint8_t buf[GATT_MAX_MTU_SIZE];
+    uint16_t len;
+    uint8_t count;
+    bool use_eatt; /* eatt_support of the app that started the train */
+  } ntf_train;
+  alarm_t* ntf_flush_timer; /* pending notification train flush timer */
+
   // TODO(hylo): support byte array data
   /* Client supported feature*/
   uint8_t cl_supp_feat;
@@ -386,6 +445,10 @@ typedef struct {
 
 typedef struct {
   tGATT_TCB tcb[GATT_MAX_PHY_CHANNEL];
+  /* index over tcb[] keyed by peer address, one table per transport,
+   * maintained by gatt_allocate_tcb_by_bdaddr/gatt_tcb_index_remove so the
+   * ATT RX path resolves a TCB without scanning the array */
+  std::unordered_map<RawAddress, uint8_t> tcb_addr_index[2];
   fixed_queue_t* sign_op_queue;
 
   uint16_t next_handle;     /* next available handle */
@@ -394,6 +457,11 @@ typedef struct {
   tGATT_IF gatt_if;
   std::list<tGATT_HDL_LIST_ELEM>* hdl_list_info;
   std::list<tGATT_SRV_LIST_ELEM>* srv_list_info;
+  /* index over *srv_list_info keyed by service start handle, kept in sync by
+   * GATTS_AddService/GATTS_StopService so the owner of an attribute handle
+   * can be resolved in O(log n) */
+  std::map<uint16_t, std::list<tGATT_SRV_LIST_ELEM>::iterator>
+      srv_handle_index;
 
   fixed_queue_t* srv_chg_clt_q; /* service change clients queue */
   tGATT_REG cl_rcb[GATT_MAX_APPS];
@@ -446,6 +514,7 @@ extern bool gatt_connect(const RawAddress& rem_bda, tGATT_TCB* p_tcb,
                          tBT_TRANSPORT transport, uint8_t initiating_phys,
                          tGATT_IF gatt_if);
 extern void gatt_data_process(tGATT_TCB& p_tcb, uint16_t cid, BT_HDR* p_buf);
+extern void gatt_notify_apps_congestion(tGATT_TCB& tcb, bool congested);
 extern void gatt_update_app_use_link_flag(tGATT_IF gatt_if, tGATT_TCB* p_tcb,
                                           bool is_add, bool check_acl_link);
 
@@ -468,6 +537,7 @@ extern bool gatt_cl_read_sr_supp_feat_req(
     base::OnceCallback<void(const RawAddress&, uint8_t)> cb);
 
 extern bool gatt_sr_is_cl_change_aware(tGATT_TCB& tcb);
+extern bool gatt_sr_is_cl_multi_notif_supported(tGATT_TCB& tcb);
 extern void gatt_sr_init_cl_status(tGATT_TCB& tcb);
 extern void gatt_sr_update_cl_status(tGATT_TCB& tcb, bool chg_unaware);
 
@@ -503,6 +573,9 @@ extern void gatt_indication_confirmation_timeout(void* data);
 extern void gatt_ind_ack_timeout(void* data);
 extern void gatt_start_ind_ack_timer(tGATT_TCB& tcb, uint16_t cid);
 extern void gatt_stop_ind_ack_timer(tGATT_TCB* p_tcb, uint16_t cid);
+extern void gatt_start_ntf_flush_timer(tGATT_TCB& tcb);
+extern void gatt_ntf_flush_timeout(void* data);
+extern tGATT_STATUS gatt_ntf_train_flush(tGATT_TCB& tcb);
 extern tGATT_STATUS gatt_send_error_rsp(tGATT_TCB& tcb, uint16_t cid,
                                         uint8_t err_code, uint8_t op_code,
                                         uint16_t handle, bool deq);
@@ -517,6 +590,8 @@ extern bool gatt_find_the_connected_bda(uint8_t start_idx, RawAddress& bda,
 extern void gatt_set_srv_chg(void);
 extern void gatt_delete_dev_from_srv_chg_clt_list(const RawAddress& bd_addr);
 extern void gatt_add_pending_ind(tGATT_TCB* p_tcb, tGATT_VALUE* p_ind);
+extern bool gatt_pending_ind_pop_first(tGATT_TCB& tcb, tGATT_VALUE* p_out);
+extern void gatt_free_pending_ind(tGATT_TCB* p_tcb);
 extern void gatt_free_srvc_db_buffer_app_id(const bluetooth::Uuid& app_id);
 extern bool gatt_cl_send_next_cmd_inq(tGATT_TCB& tcb);
 
@@ -586,6 +661,7 @@ extern uint8_t gatt_num_clcb_by_bd_addr(const RawAddress& bda);
 extern tGATT_TCB* gatt_find_tcb_by_cid(uint16_t lcid);
 extern tGATT_TCB* gatt_allocate_tcb_by_bdaddr(const RawAddress& bda,
                                               tBT_TRANSPORT transport);
+extern void gatt_tcb_index_remove(const tGATT_TCB& tcb);
 extern tGATT_TCB* gatt_get_tcb_by_idx(uint8_t tcb_idx);
 extern tGATT_TCB* gatt_find_tcb_by_addr(const RawAddress& bda,
                                         tBT_TRANSPORT transport);
@@ -609,7 +685,7 @@ extern void gatt_act_read(tGATT_CLCB* p_clcb, uint16_t offset);
 extern void gatt_act_write(tGATT_CLCB* p_clcb, uint8_t sec_act);
 extern tGATT_CLCB* gatt_cmd_dequeue(tGATT_TCB& tcb, uint16_t cid,
                                     uint8_t* p_opcode);
-extern void gatt_cmd_enq(tGATT_TCB& tcb, tGATT_CLCB* p_clcb, bool to_send,
+extern bool gatt_cmd_enq(tGATT_TCB& tcb, tGATT_CLCB* p_clcb, bool to_send,
                          uint8_t op_code, BT_HDR* p_buf);
 extern void gatt_client_handle_server_rsp(tGATT_TCB& tcb, uint16_t cid,
                                           uint8_t op_code, uint16_t len,
@@ -655,6 +731,10 @@ extern tGATT_STATUS gatts_read_attr_perm_check(tGATT_SVC_DB* p_db, bool is_long,
                                                tGATT_SEC_FLAG sec_flag,
                                                uint8_t key_size);
 extern bluetooth::Uuid* gatts_get_service_uuid(tGATT_SVC_DB* p_db);
+/* binary search over the handle-sorted attribute list */
+extern std::vector<tGATT_ATTR>::iterator find_attr_lower_bound(
+    tGATT_SVC_DB& db, uint16_t handle);
+extern tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle);
 
 /* gatt_sr_hash.cc */
 extern Octet16 gatts_calculate_database_hash(
@@ -150,8 +150,7 @@ void gatt_free(void) {
   for (i = 0; i < GATT_MAX_PHY_CHANNEL; i++) {
     gatt_cb.tcb[i].pending_enc_clcb = std::queue<tGATT_CLCB*>();
 
-    fixed_queue_free(gatt_cb.tcb[i].pending_ind_q, NULL);
-    gatt_cb.tcb[i].pending_ind_q = NULL;
+    gatt_free_pending_ind(&gatt_cb.tcb[i]);
 
     alarm_free(gatt_cb.tcb[i].conf_timer);
     gatt_cb.tcb[i].conf_timer = NULL;
@@ -165,10 +164,13 @@ void gatt_free(void) {
     if (gatt_cb.tcb[i].eatt)
       EattExtension::GetInstance()->FreeGattResources(gatt_cb.tcb[i].peer_bda);
   }
+  gatt_cb.tcb_addr_index[0].clear();
+  gatt_cb.tcb_addr_index[1].clear();
 
   gatt_cb.hdl_list_info->clear();
   delete gatt_cb.hdl_list_info;
   gatt_cb.hdl_list_info = nullptr;
+  gatt_cb.srv_handle_index.clear();
   gatt_cb.srv_list_info->clear();
   delete gatt_cb.srv_list_info;
   gatt_cb.srv_list_info = nullptr;
@@ -396,7 +398,8 @@ bool gatt_act_connect(tGATT_REG* p_reg, const RawAddress& bd_addr,
   if (!gatt_connect(bd_addr, p_tcb, transport, initiating_phys,
                     p_reg->gatt_if)) {
     LOG(ERROR) << "gatt_connect failed";
-    fixed_queue_free(p_tcb->pending_ind_q, NULL);
+    gatt_free_pending_ind(p_tcb);
+    gatt_tcb_index_remove(*p_tcb);
     *p_tcb = tGATT_TCB();
     return false;
   }
@@ -478,27 +481,33 @@ static void gatt_le_connect_cback(uint16_t chan, const RawAddress& bd_addr,
   EattExtension::GetInstance()->Connect(bd_addr);
 }
 
-/** This function is called to process the congestion callback from lcb */
-static void gatt_channel_congestion(tGATT_TCB* p_tcb, bool congested) {
+/** Raise or clear the congestion callback of every registered application
+ * for the connection; used for L2CAP channel congestion and for command
+ * queue backpressure alike */
+void gatt_notify_apps_congestion(tGATT_TCB& tcb, bool congested) {
   uint8_t i = 0;
   tGATT_REG* p_reg = NULL;
   uint16_t conn_id;
 
-  /* if uncongested, check to see if there is any more pending data */
-  if (p_tcb != NULL && !congested) {
-    gatt_cl_send_next_cmd_inq(*p_tcb);
-  }
-  /* notifying all applications for the connection up event */
   for (i = 0, p_reg = gatt_cb.cl_rcb; i < GATT_MAX_APPS; i++, p_reg++) {
     if (p_reg->in_use) {
       if (p_reg->app_cb.p_congestion_cb) {
-        conn_id = GATT_CREATE_CONN_ID(p_tcb->tcb_idx, p_reg->gatt_if);
+        conn_id = GATT_CREATE_CONN_ID(tcb.tcb_idx, p_reg->gatt_if);
         (*p_reg->app_cb.p_congestion_cb)(conn_id, congested);
       }
     }
   }
 }
 
+/** This function is called to process the congestion callback from lcb */
+static void gatt_channel_congestion(tGATT_TCB* p_tcb, bool congested) {
+  /* if uncongested, check to see if there is any more pending data */
+  if (p_tcb != NULL && !congested) {
+    gatt_cl_send_next_cmd_inq(*p_tcb);
+  }
+  gatt_notify_apps_congestion(*p_tcb, congested);
+}
+
 void gatt_notify_phy_updated(tGATT_STATUS status, uint16_t handle,
                              uint8_t tx_phy, uint8_t rx_phy) {
   tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev_by_handle(handle);
@@ -584,11 +584,11 @@ static tGATT_STATUS gatt_build_find_info_rsp(tGATT_SRV_LIST_ELEM& el,
 
   uint8_t* p = (uint8_t*)(p_msg + 1) + L2CAP_MIN_OFFSET + p_msg->len;
 
-  for (auto& attr : el.p_db->attr_list) {
+  for (auto it = find_attr_lower_bound(*el.p_db, s_hdl);
+       it != el.p_db->attr_list.end(); it++) {
+    tGATT_ATTR& attr = *it;
     if (attr.handle > e_hdl) break;
 
-    if (attr.handle < s_hdl) continue;
-
     uint8_t uuid_len = attr.uuid.GetShortestRepresentationSize();
     if (p_msg->offset == 0)
       p_msg->offset = (uuid_len == Uuid::kNumBytes16) ? GATT_INFO_TYPE_PAIR_16
@@ -1106,27 +1106,25 @@ void gatts_process_attribute_req(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
   if (GATT_HANDLE_IS_VALID(handle)) {
     for (auto& el : *gatt_cb.srv_list_info) {
       if (el.s_hdl <= handle && el.e_hdl >= handle) {
-        for (const auto& attr : el.p_db->attr_list) {
-          if (attr.handle == handle) {
-            switch (op_code) {
-              case GATT_REQ_READ: /* read char/char descriptor value */
-              case GATT_REQ_READ_BLOB:
-                gatts_process_read_req(tcb, cid, el, op_code, handle, len, p);
-                break;
-
-              case GATT_REQ_WRITE: /* write char/char descriptor value */
-              case GATT_CMD_WRITE:
-              case GATT_SIGN_CMD_WRITE:
-              case GATT_REQ_PREPARE_WRITE:
-                gatts_process_write_req(tcb, cid, el, handle, op_code, len, p,
-                                        attr.gatt_type);
-                break;
-              default:
-                break;
-            }
-            status = GATT_SUCCESS;
-            break;
+        const tGATT_ATTR* p_attr = find_attr_by_handle(el.p_db, handle);
+        if (p_attr != nullptr) {
+          switch (op_code) {
+            case GATT_REQ_READ: /* read char/char descriptor value */
+            case GATT_REQ_READ_BLOB:
+              gatts_process_read_req(tcb, cid, el, op_code, handle, len, p);
+              break;
+
+            case GATT_REQ_WRITE: /* write char/char descriptor value */
+            case GATT_CMD_WRITE:
+            case GATT_SIGN_CMD_WRITE:
+            case GATT_REQ_PREPARE_WRITE:
+              gatts_process_write_req(tcb, cid, el, handle, op_code, len, p,
+                                      p_attr->gatt_type);
+              break;
+            default:
+              break;
           }
+          status = GATT_SUCCESS;
         }
         break;
       }
@@ -1177,12 +1175,9 @@ void gatts_proc_srv_chg_ind_ack(tGATT_TCB tcb) {
 static void gatts_chk_pending_ind(tGATT_TCB& tcb) {
   VLOG(1) << __func__;
 
-  tGATT_VALUE* p_buf =
-      (tGATT_VALUE*)fixed_queue_try_peek_first(tcb.pending_ind_q);
-  if (p_buf != NULL) {
-    GATTS_HandleValueIndication(p_buf->conn_id, p_buf->handle, p_buf->len,
-                                p_buf->value);
-    osi_free(fixed_queue_try_remove_from_queue(tcb.pending_ind_q, p_buf));
+  tGATT_VALUE ind;
+  if (gatt_pending_ind_pop_first(tcb, &ind)) {
+    GATTS_HandleValueIndication(ind.conn_id, ind.handle, ind.len, ind.value);
   }
 }
 
@@ -94,13 +94,12 @@ const char* const op_code_name[] = {"UNKNOWN",
 void gatt_free_pending_ind(tGATT_TCB* p_tcb) {
   VLOG(1) << __func__;
 
-  if (p_tcb->pending_ind_q == NULL) return;
-
-  /* release all queued indications */
-  while (!fixed_queue_is_empty(p_tcb->pending_ind_q))
-    osi_free(fixed_queue_try_dequeue(p_tcb->pending_ind_q));
-  fixed_queue_free(p_tcb->pending_ind_q, NULL);
-  p_tcb->pending_ind_q = NULL;
+  /* release the ring storage along with anything still queued */
+  osi_free(p_tcb->pending_ind_ring.buf);
+  p_tcb->pending_ind_ring.buf = NULL;
+  p_tcb->pending_ind_ring.cap = 0;
+  p_tcb->pending_ind_ring.head = 0;
+  p_tcb->pending_ind_ring.count = 0;
 }
 
 /*******************************************************************************
@@ -164,9 +163,46 @@ void gatt_set_srv_chg(void) {
 void gatt_add_pending_ind(tGATT_TCB* p_tcb, tGATT_VALUE* p_ind) {
   VLOG(1) << __func__ << "enqueue a pending indication";
 
-  tGATT_VALUE* p_buf = (tGATT_VALUE*)osi_malloc(sizeof(tGATT_VALUE));
-  memcpy(p_buf, p_ind, sizeof(tGATT_VALUE));
-  fixed_queue_enqueue(p_tcb->pending_ind_q, p_buf);
+  auto& ring = p_tcb->pending_ind_ring;
+  if (ring.count == ring.cap) {
+    /* first use, or the ring is full: (re)allocate at double the capacity
+     * and unwrap the queued entries so they start at index 0 */
+    uint16_t new_cap = (ring.cap == 0) ? GATT_PENDING_IND_RING_INIT_CAP
+                                       : (uint16_t)(ring.cap << 1);
+    tGATT_VALUE* new_buf =
+        (tGATT_VALUE*)osi_malloc(new_cap * sizeof(tGATT_VALUE));
+    for (uint16_t i = 0; i < ring.count; i++)
+      memcpy(&new_buf[i], &ring.buf[(ring.head + i) % ring.cap],
+             sizeof(tGATT_VALUE));
+    osi_free(ring.buf);
+    ring.buf = new_buf;
+    ring.cap = new_cap;
+    ring.head = 0;
+  }
+  memcpy(&ring.buf[(ring.head + ring.count) % ring.cap], p_ind,
+         sizeof(tGATT_VALUE));
+  ring.count++;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_pending_ind_pop_first
+ *
+ * Description      Copy out and remove the oldest queued indication. The
+ *                  entry is copied so the caller may re-queue indications
+ *                  while holding it without referencing ring storage.
+ *
+ * Returns          true if an indication was dequeued
+ *
+ ******************************************************************************/
+bool gatt_pending_ind_pop_first(tGATT_TCB& tcb, tGATT_VALUE* p_out) {
+  auto& ring = tcb.pending_ind_ring;
+  if (ring.count == 0) return false;
+
+  memcpy(p_out, &ring.buf[ring.head], sizeof(tGATT_VALUE));
+  ring.head = (uint16_t)((ring.head + 1) % ring.cap);
+  ring.count--;
+  return true;
 }
 
 /*******************************************************************************
@@ -282,7 +318,7 @@ bool gatt_find_the_connected_bda(uint8_t start_idx, RawAddress& bda,
  ******************************************************************************/
 bool gatt_is_srv_chg_ind_pending(tGATT_TCB* p_tcb) {
   VLOG(1) << __func__
-          << " is_queue_empty=" << fixed_queue_is_empty(p_tcb->pending_ind_q);
+          << " pending_count=" << +p_tcb->pending_ind_ring.count;
 
   if (p_tcb->indicate_handle == gatt_cb.handle_of_h_r) return true;
 
@@ -290,13 +326,9 @@ bool gatt_is_srv_chg_ind_pending(tGATT_TCB* p_tcb) {
                          p_tcb->peer_bda, gatt_cb.handle_of_h_r))
     return true;
 
-  if (fixed_queue_is_empty(p_tcb->pending_ind_q)) return false;
-
-  list_t* list = fixed_queue_get_list(p_tcb->pending_ind_q);
-  for (const list_node_t* node = list_begin(list); node != list_end(list);
-       node = list_next(node)) {
-    tGATT_VALUE* p_buf = (tGATT_VALUE*)list_node(node);
-    if (p_buf->handle == gatt_cb.handle_of_h_r) {
+  const auto& ring = p_tcb->pending_ind_ring;
+  for (uint16_t i = 0; i < ring.count; i++) {
+    if (ring.buf[(ring.head + i) % ring.cap].handle == gatt_cb.handle_of_h_r) {
       return true;
     }
   }
@@ -355,25 +387,42 @@ bool gatt_is_bda_connected(const RawAddress& bda) {
   return connected;
 }
 
+/* One index table per transport; LE and BR/EDR links to the same peer own
+ * separate TCBs */
+static size_t gatt_tcb_index_slot(tBT_TRANSPORT transport) {
+  return (transport == BT_TRANSPORT_LE) ? 0 : 1;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_tcb_index_remove
+ *
+ * Description      Drop the tcb from the address index. Must be called before
+ *                  the entry is reset for reuse.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_tcb_index_remove(const tGATT_TCB& tcb) {
+  gatt_cb.tcb_addr_index[gatt_tcb_index_slot(tcb.transport)].erase(
+      tcb.peer_bda);
+}
+
 /*******************************************************************************
  *
  * Function         gatt_find_i_tcb_by_addr
  *
- * Description      Search for an empty tcb entry, and return the index.
+ * Description      Look up the tcb index for a peer address on a transport.
  *
  * Returns          GATT_INDEX_INVALID if not found. Otherwise index to the tcb.
  *
  ******************************************************************************/
 uint8_t gatt_find_i_tcb_by_addr(const RawAddress& bda,
                                 tBT_TRANSPORT transport) {
-  uint8_t i = 0;
+  const auto& index = gatt_cb.tcb_addr_index[gatt_tcb_index_slot(transport)];
+  auto it = index.find(bda);
+  if (it != index.end()) return it->second;
 
-  for (; i < GATT_MAX_PHY_CHANNEL; i++) {
-    if (gatt_cb.tcb[i].peer_bda == bda &&
-        gatt_cb.tcb[i].transport == transport) {
-      return i;
-    }
-  }
   return GATT_INDEX_INVALID;
 }
 
@@ -437,13 +486,16 @@ tGATT_TCB* gatt_allocate_tcb_by_bdaddr(const RawAddress& bda,
 
     *p_tcb = tGATT_TCB();
 
-    p_tcb->pending_ind_q = fixed_queue_new(SIZE_MAX);
+    /* pending indication ring storage is created on the first queued
+     * indication, so an idle connection carries no queue */
     p_tcb->conf_timer = alarm_new("gatt.conf_timer");
     p_tcb->ind_ack_timer = alarm_new("gatt.ind_ack_timer");
+    p_tcb->ntf_flush_timer = alarm_new("gatt.ntf_flush_timer");
     p_tcb->in_use = true;
     p_tcb->tcb_idx = i;
     p_tcb->transport = transport;
     p_tcb->peer_bda = bda;
+    gatt_cb.tcb_addr_index[gatt_tcb_index_slot(transport)][bda] = i;
     p_tcb->eatt = 0;
     gatt_sr_init_cl_status(*p_tcb);
     gatt_cl_init_sr_status(*p_tcb);
@@ -629,6 +681,70 @@ void gatt_stop_ind_ack_timer(tGATT_TCB* p_tcb, uint16_t cid) {
     p_tcb->ind_count = 0;
   }
 }
+
+/*******************************************************************************
+ *
+ * Function         gatt_start_ntf_flush_timer
+ *
+ * Description      Start the pending notification train flush timer.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_start_ntf_flush_timer(tGATT_TCB& tcb) {
+  if (alarm_is_scheduled(tcb.ntf_flush_timer)) return;
+
+  alarm_set_on_mloop(tcb.ntf_flush_timer, GATT_NTF_FLUSH_TIMEOUT_MS,
+                     gatt_ntf_flush_timeout, &tcb);
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_ntf_flush_timeout
+ *
+ * Description      Called when the notification coalescing window closes
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_ntf_flush_timeout(void* data) {
+  tGATT_TCB* p_tcb = (tGATT_TCB*)data;
+
+  if (!p_tcb->in_use) return;
+  gatt_ntf_train_flush(*p_tcb);
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_ntf_train_flush
+ *
+ * Description      Send the pending coalesced notifications as a single
+ *                  multiple handle value notification PDU.
+ *
+ * Returns          GATT_SUCCESS if sent or nothing pending; otherwise error
+ *                  code.
+ *
+ ******************************************************************************/
+tGATT_STATUS gatt_ntf_train_flush(tGATT_TCB& tcb) {
+  alarm_cancel(tcb.ntf_flush_timer);
+
+  if (tcb.ntf_train.len == 0) return GATT_SUCCESS;
+
+  tGATT_SR_MSG gatt_sr_msg;
+  gatt_sr_msg.multi_ntf.len = tcb.ntf_train.len;
+  gatt_sr_msg.multi_ntf.p_value = tcb.ntf_train.buf;
+
+  BT_HDR* p_buf =
+      attp_build_sr_msg(tcb, GATT_HANDLE_MULTI_VALUE_NOTIF, &gatt_sr_msg);
+
+  uint16_t cid = gatt_tcb_get_att_cid(tcb, tcb.ntf_train.use_eatt);
+  tcb.ntf_train.len = 0;
+  tcb.ntf_train.count = 0;
+
+  if (p_buf == NULL) return GATT_NO_RESOURCES;
+
+  return attp_send_sr_msg(tcb, cid, p_buf);
+}
 /*******************************************************************************
  *
  * Function         gatt_rsp_timeout
@@ -731,15 +847,18 @@ void  gatt_ind_ack_timeout(void* data) {
  ******************************************************************************/
 std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_i_rcb_by_handle(
     uint16_t handle) {
-  auto it = gatt_cb.srv_list_info->begin();
-
-  for (; it != gatt_cb.srv_list_info->end(); it++) {
-    if (it->s_hdl <= handle && it->e_hdl >= handle) {
-      return it;
-    }
+  /* Service ranges do not overlap, so the owner is the service with the
+   * largest start handle that does not exceed |handle|. */
+  auto idx = gatt_cb.srv_handle_index.upper_bound(handle);
+  if (idx == gatt_cb.srv_handle_index.begin()) {
+    return gatt_cb.srv_list_info->end();
+  }
+  --idx;
+  if (idx->second->e_hdl >= handle) {
+    return idx->second;
   }
 
-  return it;
+  return gatt_cb.srv_list_info->end();
 }
 
 /*******************************************************************************
@@ -1100,7 +1219,13 @@ uint16_t gatt_tcb_get_att_cid(tGATT_TCB& tcb, bool eatt_support) {
     EattChannel* channel =
         EattExtension::GetInstance()->GetChannelAvailableForClientRequest(tcb.peer_bda);
     if (channel) {
-      return channel->cid_;
+      /* Take an idle enhanced channel right away. When all of them are
+       * busy, spill over to the unenhanced channel if that one is idle,
+       * and otherwise queue on whichever channel has the shortest backlog
+       * so pending requests keep draining over all channels in parallel. */
+      if (channel->cl_cmd_q_.empty()) return channel->cid_;
+      if (channel->cl_cmd_q_.size() < tcb.cl_cmd_q.size())
+        return channel->cid_;
     }
   }
   return tcb.att_lcid;
@@ -1409,9 +1534,19 @@ bool gatt_cancel_open(tGATT_IF gatt_if, const RawAddress& bda) {
   return true;
 }
 
-/** Enqueue this command */
-void gatt_cmd_enq(tGATT_TCB& tcb, tGATT_CLCB* p_clcb, bool to_send,
+/** Enqueue this command. Returns false and leaves the command untouched
+ * when the connection already holds GATT_CL_CMD_Q_HARD_LIMIT queued
+ * commands; only commands still waiting to be sent count against the
+ * limit, response bookkeeping entries are always accepted. */
+bool gatt_cmd_enq(tGATT_TCB& tcb, tGATT_CLCB* p_clcb, bool to_send,
                   uint8_t op_code, BT_HDR* p_buf) {
+  if (to_send && tcb.cl_cmd_q_depth >= GATT_CL_CMD_Q_HARD_LIMIT) {
+    tcb.cl_cmd_q_rejected++;
+    LOG(WARNING) << __func__ << ": command queue full, "
+                 << tcb.cl_cmd_q_rejected << " commands refused so far";
+    return false;
+  }
+
   tGATT_CMD_Q cmd;
   cmd.to_send = to_send; /* waiting to be sent */
   cmd.op_code = op_code;
@@ -1427,6 +1562,16 @@ void gatt_cmd_enq(tGATT_TCB& tcb, tGATT_CLCB* p_clcb, bool to_send,
     CHECK(channel);
     channel->cl_cmd_q_.push(cmd);
   }
+
+  tcb.cl_cmd_q_depth++;
+  if (tcb.cl_cmd_q_depth > tcb.cl_cmd_q_max_depth)
+    tcb.cl_cmd_q_max_depth = tcb.cl_cmd_q_depth;
+  if (!tcb.cl_cmd_q_app_congested &&
+      tcb.cl_cmd_q_depth >= GATT_CL_CMD_Q_HIGH_WATERMARK) {
+    tcb.cl_cmd_q_app_congested = true;
+    gatt_notify_apps_congestion(tcb, true);
+  }
+  return true;
 }
 
 /** dequeue the command in the client CCB command queue */
@@ -1450,6 +1595,13 @@ tGATT_CLCB* gatt_cmd_dequeue(tGATT_TCB& tcb, uint16_t cid, uint8_t* p_op_code) {
   p_clcb->cid = cid;
   cl_cmd_q_p->pop();
 
+  if (tcb.cl_cmd_q_depth > 0) tcb.cl_cmd_q_depth--;
+  if (tcb.cl_cmd_q_app_congested &&
+      tcb.cl_cmd_q_depth <= GATT_CL_CMD_Q_LOW_WATERMARK) {
+    tcb.cl_cmd_q_app_congested = false;
+    gatt_notify_apps_congestion(tcb, false);
+  }
+
   return p_clcb;
 }
 
@@ -1549,6 +1701,12 @@ void gatt_cleanup_upon_disc(const RawAddress& bda, tGATT_DISCONN_REASON reason,
   tGATT_TCB* p_tcb = gatt_find_tcb_by_addr(bda, transport);
   if (!p_tcb) return;
 
+  if (p_tcb->cl_cmd_q_max_depth >= GATT_CL_CMD_Q_HIGH_WATERMARK) {
+    LOG(INFO) << __func__ << ": command queue watermark "
+              << p_tcb->cl_cmd_q_max_depth << ", "
+              << p_tcb->cl_cmd_q_rejected << " commands refused";
+  }
+
   gatt_set_ch_state(p_tcb, GATT_CH_CLOSE);
   for (uint8_t i = 0; i < GATT_CL_MAX_LCB; i++) {
     tGATT_CLCB* p_clcb = &gatt_cb.clcb[i];
@@ -1568,6 +1726,8 @@ void gatt_cleanup_upon_disc(const RawAddress& bda, tGATT_DISCONN_REASON reason,
   p_tcb->ind_ack_timer = NULL;
   alarm_free(p_tcb->conf_timer);
   p_tcb->conf_timer = NULL;
+  alarm_free(p_tcb->ntf_flush_timer);
+  p_tcb->ntf_flush_timer = NULL;
   gatt_free_pending_ind(p_tcb);
   fixed_queue_free(p_tcb->sr_cmd.multi_rsp_q, NULL);
   p_tcb->sr_cmd.multi_rsp_q = NULL;
@@ -1581,6 +1741,7 @@ void gatt_cleanup_upon_disc(const RawAddress& bda, tGATT_DISCONN_REASON reason,
     }
   }
 
+  gatt_tcb_index_remove(*p_tcb);
   *p_tcb = tGATT_TCB();
   VLOG(1) << __func__ << ": exit";
 }
@@ -34,6 +34,14 @@
 #include "a2dp_api.h"
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
 #include "avdt_api.h"
+#include "osi/include/allocator.h"
+
+// Attribute the A2DP data path's allocations (codec configs, encoder
+// buffers) to A2DP in the memory ledger.
+#ifndef osi_malloc
+#define osi_malloc(size) osi_malloc_tagged((size), ALLOC_TAG_A2DP)
+#define osi_calloc(size) osi_calloc_tagged((size), ALLOC_TAG_A2DP)
+#endif
 
 class tBT_A2DP_OFFLOAD;
 
@@ -538,6 +546,12 @@ typedef struct {
 
   // Set transmit queue length for the A2DP encoder.
   void (*set_transmit_queue_length)(size_t transmit_queue_length);
+
+  // Set the low-latency (game) mode for the A2DP encoder. While enabled,
+  // the encoder emits single-frame packets so no frame waits for a larger
+  // packet to fill up. May be NULL if the codec has no latency-specific
+  // tuning.
+  void (*set_low_latency_mode)(bool enabled);
 } tA2DP_ENCODER_INTERFACE;
 
 // Prototype for a callback to receive decoded audio data from a
@@ -570,6 +584,32 @@ typedef struct {
   void (*decoder_configure)(const uint8_t* p_codec_info);
 } tA2DP_DECODER_INTERFACE;
 
+//
+// A2DP codec packet-path operations.
+//
+// Per-codec function set for the operations performed on every outgoing
+// media packet. Resolved once via |A2DP_GetPacketInterface| when the codec
+// configuration is selected, so the data path does not re-examine the codec
+// information on each packet.
+//
+typedef struct {
+  // Gets the A2DP audio data timestamp from an audio packet.
+  // |p_codec_info| contains the codec information.
+  // |p_data| contains the audio data.
+  // The timestamp is stored in |p_timestamp|.
+  // Returns true on success, otherwise false.
+  bool (*get_packet_timestamp)(const uint8_t* p_codec_info,
+                               const uint8_t* p_data, uint32_t* p_timestamp);
+
+  // Builds A2DP codec header for audio data.
+  // |p_codec_info| contains the codec information.
+  // |p_buf| contains the audio data.
+  // |frames_per_packet| is the number of frames in this packet.
+  // Returns true on success, otherwise false.
+  bool (*build_codec_header)(const uint8_t* p_codec_info, BT_HDR* p_buf,
+                             uint16_t frames_per_packet);
+} tA2DP_PACKET_INTERFACE;
+
 // Gets the A2DP codec type.
 // |p_codec_info| contains information about the codec capabilities.
 tA2DP_CODEC_TYPE A2DP_GetCodecType(const uint8_t* p_codec_info);
@@ -686,6 +726,13 @@ bool A2DP_GetPacketTimestamp(const uint8_t* p_codec_info, const uint8_t* p_data,
 bool A2DP_BuildCodecHeader(const uint8_t* p_codec_info, BT_HDR* p_buf,
                            uint16_t frames_per_packet);
 
+// Gets the per-codec packet-path operations - see |tA2DP_PACKET_INTERFACE|.
+// |p_codec_info| contains the codec information.
+// Returns the A2DP packet interface if the |p_codec_info| is valid and
+// supported, otherwise NULL.
+const tA2DP_PACKET_INTERFACE* A2DP_GetPacketInterface(
+    const uint8_t* p_codec_info);
+
 // Gets the A2DP encoder interface that can be used to encode and prepare
 // A2DP packets for transmission - see |tA2DP_ENCODER_INTERFACE|.
 // |p_codec_info| contains the codec information.
@@ -62,4 +62,8 @@ void a2dp_sbc_send_frames(uint64_t timestamp_us);
 // Get SBC bitrate
 // Returns |uint32_t| bitrate in bits per second
 uint32_t a2dp_sbc_get_bitrate();
+
+// Set the low-latency (game) mode for the A2DP SBC encoder.
+// While enabled, each outgoing packet carries a single SBC frame.
+void a2dp_sbc_set_low_latency_mode(bool enabled);
 #endif  // A2DP_SBC_ENCODER_H
@@ -159,6 +159,14 @@ bool A2DP_VendorGetPacketTimestamp(const uint8_t* p_codec_info,
 bool A2DP_VendorBuildCodecHeader(const uint8_t* p_codec_info, BT_HDR* p_buf,
                                  uint16_t frames_per_packet);
 
+// Gets the vendor-specific per-codec packet-path operations - see
+// |tA2DP_PACKET_INTERFACE|.
+// |p_codec_info| contains the codec information.
+// Returns the A2DP packet interface if the |p_codec_info| is valid and
+// supported, otherwise NULL.
+const tA2DP_PACKET_INTERFACE* A2DP_VendorGetPacketInterface(
+    const uint8_t* p_codec_info);
+
 // Gets the A2DP vendor encoder interface that can be used to encode and
 // prepare A2DP packets for transmission - see |tA2DP_ENCODER_INTERFACE|.
 // |p_codec_info| contains the codec information.
@@ -66,6 +66,20 @@ tBTM_STATUS BTM_SetLinkSuperTout(const RawAddress& remote_bda,
 tBTM_STATUS BTM_GetLinkSuperTout(const RawAddress& remote_bda,
                                  uint16_t* p_timeout);
 
+/*******************************************************************************
+ *
+ * Function         BTM_SetAdaptiveFlushTimeout
+ *
+ * Description      Enable the automatic flush timeout on the link when the
+ *                  measured transmit latency exceeds what the caller can
+ *                  tolerate, and disable it again once the link recovers.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void BTM_SetAdaptiveFlushTimeout(const RawAddress& bd_addr,
+                                 uint16_t max_latency_ms);
+
 /*******************************************************************************
  *
  * Function         BTM_IsAclConnectionUp
@@ -133,6 +147,36 @@ tBTM_STATUS BTM_SwitchRoleToCentral(const RawAddress& remote_bd_addr);
  ******************************************************************************/
 tBTM_STATUS BTM_ReadRSSI(const RawAddress& remote_bda, tBTM_CMPL_CB* p_cb);
 
+/*******************************************************************************
+ *
+ * Function         BTM_LinkMetricsSubscribe
+ *
+ * Description      Register for RSSI readings of the given link through the
+ *                  shared metrics poller. One HCI read per link serves all
+ *                  subscribers; each gets the result as a tBTM_RSSI_RESULT,
+ *                  the same shape BTM_ReadRSSI delivers. A |period_ms| of 0
+ *                  requests a single reading, after which the subscription
+ *                  removes itself. Periods are capped below at the poller's
+ *                  minimum rate.
+ *
+ * Returns          BTM_CMD_STARTED if the subscription is active
+ *                  BTM_NO_RESOURCES if the subscriber table is full
+ *
+ ******************************************************************************/
+tBTM_STATUS BTM_LinkMetricsSubscribe(const RawAddress& remote_bda,
+                                     uint16_t period_ms, tBTM_CMPL_CB* p_cb);
+
+/*******************************************************************************
+ *
+ * Function         BTM_LinkMetricsUnsubscribe
+ *
+ * Description      Drop the subscription matching the given link and
+ *                  callback. The poller stops once no subscriptions remain.
+ *
+ ******************************************************************************/
+void BTM_LinkMetricsUnsubscribe(const RawAddress& remote_bda,
+                                tBTM_CMPL_CB* p_cb);
+
 /*******************************************************************************
  *
  * Function         BTM_ReadFailedContactCounter
@@ -284,6 +328,22 @@ void btm_acl_update_conn_addr(uint16_t conn_handle, const RawAddress& address);
  ******************************************************************************/
 bool BTM_ReadPowerMode(const RawAddress& remote_bda, tBTM_PM_MODE* p_mode);
 
+/*******************************************************************************
+ *
+ * Function         BTM_GetSniffInterval
+ *
+ * Description      This returns the sniff interval of an ACL connection, so
+ *                  background traffic can be batched against it instead of
+ *                  waking the link per packet.
+ *
+ * Input Param      remote_bda - device address of desired ACL connection
+ *
+ * Returns          Sniff interval in baseband slots, or 0 if the link is
+ *                  not in sniff mode.
+ *
+ ******************************************************************************/
+uint16_t BTM_GetSniffInterval(const RawAddress& remote_bda);
+
 void btm_acl_created(const RawAddress& bda, uint16_t hci_handle,
                      tHCI_ROLE link_role, tBT_TRANSPORT transport);
 
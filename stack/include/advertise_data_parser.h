@@ -142,3 +142,64 @@ class AdvertiseDataParser {
     return GetFieldByType(ad.data(), ad.size(), type, p_length);
   }
 };
+
+/**
+ * Index over the AD structures of an advertising data or EIR payload, built
+ * with a single walk of the structure list. Consumers that query several field
+ * types from the same payload should build one index and use its
+ * GetFieldByType() instead of rescanning the payload per type.
+ *
+ * The index stores offsets into the payload; it must not outlive the buffer
+ * it was built from. Like AdvertiseDataParser::GetFieldByType(), only the
+ * first occurrence of a type is returned.
+ */
+class AdvertiseDataIndex {
+ public:
+  AdvertiseDataIndex(const uint8_t* ad, size_t ad_len) : ad_(ad), entries_{} {
+    size_t position = 0;
+
+    while (position != ad_len) {
+      uint8_t len = ad[position];
+
+      if (len == 0) break;
+      if (position + len >= ad_len) break;
+
+      uint8_t adv_type = ad[position + 1];
+
+      /* data offsets start past the length and type octets, so 0 means the
+       * type has not been seen yet */
+      if (entries_[adv_type].offset == 0) {
+        entries_[adv_type].offset = static_cast<uint16_t>(position + 2);
+        entries_[adv_type].length = len - 1; /* minus the length of type */
+      }
+
+      position += len + 1; /* skip the length of data */
+    }
+  }
+
+  explicit AdvertiseDataIndex(std::vector<uint8_t> const& ad)
+      : AdvertiseDataIndex(ad.data(), ad.size()) {}
+
+  /**
+   * Same contract as AdvertiseDataParser::GetFieldByType(), resolved from the
+   * prebuilt index in constant time.
+   */
+  const uint8_t* GetFieldByType(uint8_t type, uint8_t* p_length) const {
+    const Entry& entry = entries_[type];
+    if (entry.offset == 0) {
+      *p_length = 0;
+      return NULL;
+    }
+    *p_length = entry.length;
+    return ad_ + entry.offset;
+  }
+
+ private:
+  struct Entry {
+    uint16_t offset;
+    uint8_t length;
+  };
+
+  const uint8_t* ad_;
+  std::array<Entry, 256> entries_;
+};
@@ -140,7 +140,104 @@ enum {
 
 /*******************************************************************************
  * Macros to get and put bytes to and from a stream (Little Endian format).
+ *
+ * The multi-byte accessors delegate to the typed inline helpers below: a
+ * memcpy of the whole value compiles to one unaligned load or store on
+ * every supported target, where the historical byte-at-a-time shifts kept
+ * the parse and serialize paths scalar. Building with
+ * -DBT_STREAM_DEBUG_BOUNDS arms a per-thread watch window for diagnosing
+ * stream overruns; it is compiled out otherwise.
  */
+#include <string.h>
+
+#if defined(BT_STREAM_DEBUG_BOUNDS)
+inline thread_local const uint8_t* bt_stream_window_begin = NULL;
+inline thread_local const uint8_t* bt_stream_window_end = NULL;
+
+/* Arms the watch window: until re-armed, any stream macro access on this
+ * thread outside [begin, begin + len) traps. A len of 0 disarms it. */
+static inline void bt_stream_set_window(const void* begin, size_t len) {
+  bt_stream_window_begin = (len != 0) ? (const uint8_t*)begin : NULL;
+  bt_stream_window_end = (const uint8_t*)begin + len;
+}
+
+static inline void bt_stream_check(const void* p, size_t len) {
+  const uint8_t* q = (const uint8_t*)p;
+  if (bt_stream_window_begin != NULL &&
+      (q < bt_stream_window_begin || q + len > bt_stream_window_end))
+    __builtin_trap();
+}
+#else
+static inline void bt_stream_check(const void* /* p */, size_t /* len */) {}
+#endif
+
+static inline uint16_t bt_stream_get_le16(const void* p) {
+  uint16_t v;
+  bt_stream_check(p, sizeof(v));
+  memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  v = __builtin_bswap16(v);
+#endif
+  return v;
+}
+
+static inline uint32_t bt_stream_get_le32(const void* p) {
+  uint32_t v;
+  bt_stream_check(p, sizeof(v));
+  memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  v = __builtin_bswap32(v);
+#endif
+  return v;
+}
+
+static inline uint64_t bt_stream_get_le64(const void* p) {
+  uint64_t v;
+  bt_stream_check(p, sizeof(v));
+  memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
+
+static inline void bt_stream_put_le16(void* p, uint16_t v) {
+  bt_stream_check(p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  v = __builtin_bswap16(v);
+#endif
+  memcpy(p, &v, sizeof(v));
+}
+
+static inline void bt_stream_put_le32(void* p, uint32_t v) {
+  bt_stream_check(p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  v = __builtin_bswap32(v);
+#endif
+  memcpy(p, &v, sizeof(v));
+}
+
+/* Bulk copy out of a stream; always byte-exact, so a straight memcpy. */
+static inline void bt_stream_get_array(void* a, const void* p, int len) {
+  if (len <= 0) return;
+  bt_stream_check(p, (size_t)len);
+  memcpy(a, p, (size_t)len);
+}
+
+/* Bulk copy into a stream; |a| may be anything indexable (raw pointer,
+ * C array, std::array). The legacy macro truncated each source element to
+ * a byte, so only byte-sized elements may take the memcpy fast path. */
+template <typename T>
+static inline void bt_stream_put_array(void* p, const T& a, int len) {
+  if (len <= 0) return;
+  bt_stream_check(p, (size_t)len);
+  if (sizeof(a[0]) == 1) {
+    memcpy(p, &a[0], (size_t)len);
+  } else {
+    for (int i = 0; i < len; i++) ((uint8_t*)p)[i] = (uint8_t)a[i];
+  }
+}
+
 #define UINT64_TO_BE_STREAM(p, u64)  \
   {                                  \
     *(p)++ = (uint8_t)((u64) >> 56); \
@@ -152,12 +249,10 @@ enum {
     *(p)++ = (uint8_t)((u64) >> 8);  \
     *(p)++ = (uint8_t)(u64);         \
   }
-#define UINT32_TO_STREAM(p, u32)     \
-  {                                  \
-    *(p)++ = (uint8_t)(u32);         \
-    *(p)++ = (uint8_t)((u32) >> 8);  \
-    *(p)++ = (uint8_t)((u32) >> 16); \
-    *(p)++ = (uint8_t)((u32) >> 24); \
+#define UINT32_TO_STREAM(p, u32)              \
+  {                                           \
+    bt_stream_put_le32((p), (uint32_t)(u32)); \
+    (p) += 4;                                 \
   }
 #define UINT24_TO_STREAM(p, u24)     \
   {                                  \
@@ -165,10 +260,10 @@ enum {
     *(p)++ = (uint8_t)((u24) >> 8);  \
     *(p)++ = (uint8_t)((u24) >> 16); \
   }
-#define UINT16_TO_STREAM(p, u16)    \
-  {                                 \
-    *(p)++ = (uint8_t)(u16);        \
-    *(p)++ = (uint8_t)((u16) >> 8); \
+#define UINT16_TO_STREAM(p, u16)              \
+  {                                           \
+    bt_stream_put_le16((p), (uint16_t)(u16)); \
+    (p) += 2;                                 \
   }
 #define UINT8_TO_STREAM(p, u8) \
   { *(p)++ = (uint8_t)(u8); }
@@ -201,10 +296,12 @@ enum {
     for (ijk = 0; ijk < DEV_CLASS_LEN; ijk++)         \
       *(p)++ = (uint8_t)(a)[DEV_CLASS_LEN - 1 - ijk]; \
   }
-#define ARRAY_TO_STREAM(p, a, len)                                \
-  {                                                               \
-    int ijk;                                                      \
-    for (ijk = 0; ijk < (len); ijk++) *(p)++ = (uint8_t)(a)[ijk]; \
+#define ARRAY_TO_STREAM(p, a, len)           \
+  {                                          \
+    if ((len) > 0) {                         \
+      bt_stream_put_array((p), (a), (len));  \
+      (p) += (len);                          \
+    }                                        \
   }
 #define REVERSE_ARRAY_TO_STREAM(p, a, len)                                  \
   {                                                                         \
@@ -222,10 +319,10 @@ enum {
     (u8) = (uint8_t)(*(p));    \
     (p) += 1;                  \
   }
-#define STREAM_TO_UINT16(u16, p)                                  \
-  {                                                               \
-    (u16) = ((uint16_t)(*(p)) + (((uint16_t)(*((p) + 1))) << 8)); \
-    (p) += 2;                                                     \
+#define STREAM_TO_UINT16(u16, p)   \
+  {                                \
+    (u16) = bt_stream_get_le16(p); \
+    (p) += 2;                      \
   }
 #define STREAM_TO_UINT24(u32, p)                                      \
   {                                                                   \
@@ -233,23 +330,15 @@ enum {
              ((((uint32_t)(*((p) + 2)))) << 16));                     \
     (p) += 3;                                                         \
   }
-#define STREAM_TO_UINT32(u32, p)                                      \
-  {                                                                   \
-    (u32) = (((uint32_t)(*(p))) + ((((uint32_t)(*((p) + 1)))) << 8) + \
-             ((((uint32_t)(*((p) + 2)))) << 16) +                     \
-             ((((uint32_t)(*((p) + 3)))) << 24));                     \
-    (p) += 4;                                                         \
+#define STREAM_TO_UINT32(u32, p)   \
+  {                                \
+    (u32) = bt_stream_get_le32(p); \
+    (p) += 4;                      \
   }
-#define STREAM_TO_UINT64(u64, p)                                      \
-  {                                                                   \
-    (u64) = (((uint64_t)(*(p))) + ((((uint64_t)(*((p) + 1)))) << 8) + \
-             ((((uint64_t)(*((p) + 2)))) << 16) +                     \
-             ((((uint64_t)(*((p) + 3)))) << 24) +                     \
-             ((((uint64_t)(*((p) + 4)))) << 32) +                     \
-             ((((uint64_t)(*((p) + 5)))) << 40) +                     \
-             ((((uint64_t)(*((p) + 6)))) << 48) +                     \
-             ((((uint64_t)(*((p) + 7)))) << 56));                     \
-    (p) += 8;                                                         \
+#define STREAM_TO_UINT64(u64, p)   \
+  {                                \
+    (u64) = bt_stream_get_le64(p); \
+    (p) += 8;                      \
   }
 #define STREAM_TO_ARRAY32(a, p)                     \
   {                                                 \
@@ -281,10 +370,12 @@ enum {
     uint8_t* plap = (uint8_t*)(a) + LAP_LEN - 1;          \
     for (ijk = 0; ijk < LAP_LEN; ijk++) *plap-- = *(p)++; \
   }
-#define STREAM_TO_ARRAY(a, p, len)                                   \
-  {                                                                  \
-    int ijk;                                                         \
-    for (ijk = 0; ijk < (len); ijk++) ((uint8_t*)(a))[ijk] = *(p)++; \
+#define STREAM_TO_ARRAY(a, p, len)           \
+  {                                          \
+    if ((len) > 0) {                         \
+      bt_stream_get_array((a), (p), (len));  \
+      (p) += (len);                          \
+    }                                        \
   }
 #define REVERSE_STREAM_TO_ARRAY(a, p, len)             \
   {                                                    \
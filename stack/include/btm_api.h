@@ -312,6 +312,16 @@ uint16_t BTM_IsInquiryActive(void);
  ******************************************************************************/
 void BTM_CancelInquiry(void);
 
+/*******************************************************************************
+ *
+ * Function         BTM_SetInquiryPageYield
+ *
+ * Description      Enable or disable yielding the classic inquiry to
+ *                  outgoing connection attempts (enabled by default)
+ *
+ ******************************************************************************/
+void BTM_SetInquiryPageYield(bool enable);
+
 /*******************************************************************************
  *
  * Function         BTM_SetConnectability
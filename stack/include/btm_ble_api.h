@@ -610,6 +610,7 @@ extern void BTM_BleSetPhy(const RawAddress& bd_addr, uint8_t tx_phys,
                           uint8_t rx_phys, uint16_t phy_options);
 
 extern void btm_ble_multi_adv_cleanup(void);
+extern void btm_ble_multi_adv_dump(int fd);
 
 /*******************************************************************************
  *
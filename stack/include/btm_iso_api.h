@@ -218,6 +218,13 @@ class IsoManager {
   virtual void HandleHciEvent(uint8_t sub_code, uint8_t* params,
                               uint16_t length);
 
+  /**
+   * Dumps ISO credit and per-stream TX scheduler state
+   *
+   * @param fd file descriptor the state is dumped to
+   */
+  virtual void Dump(int fd);
+
   /**
    * Starts the IsoManager module
    */
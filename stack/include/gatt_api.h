@@ -871,6 +871,31 @@ extern tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
                                                   uint16_t val_len,
                                                   uint8_t* p_val);
 
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleValueNotificationCoalesced
+ *
+ * Description      This function queues a handle value notification so that
+ *                  it can share a multiple handle value notification PDU
+ *                  with other notifications pending on the same link. Sends
+ *                  a plain notification when the client does not accept
+ *                  multiple handle value notifications.
+ *
+ * Parameter        conn_id: connection identifier.
+ *                  attr_handle: Attribute handle of this handle value
+ *                               indication.
+ *                  val_len: Length of the indicated attribute value.
+ *                  p_val: Pointer to the indicated attribute value data.
+ *
+ * Returns          GATT_SUCCESS if sucessfully sent or queued; otherwise
+ *                  error code.
+ *
+ ******************************************************************************/
+extern tGATT_STATUS GATTS_HandleValueNotificationCoalesced(uint16_t conn_id,
+                                                           uint16_t attr_handle,
+                                                           uint16_t val_len,
+                                                           uint8_t* p_val);
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -170,12 +170,14 @@ constexpr uint16_t L2CAP_LE_CREDIT_MAX = 65535;
 // credits once they fall below threshold
 constexpr uint16_t L2CAP_LE_CREDIT_DEFAULT = 0xffff;
 
-// If credit count on remote fall below this value, we send back credits to
-// reach default value.
-constexpr uint16_t L2CAP_LE_CREDIT_THRESHOLD = 0x0040;
+// Once the remote has consumed 1/N of its initial credit grant, we send
+// back credits to reach the grant again. Batching the returns this way keeps
+// the signaling traffic at one credit packet per batch of SDUs even for
+// channels configured with small grants.
+constexpr uint16_t L2CAP_LE_CREDIT_REPLENISH_FRACTION = 2;
 
-static_assert(L2CAP_LE_CREDIT_THRESHOLD < L2CAP_LE_CREDIT_DEFAULT,
-              "Threshold must be smaller than default credits");
+static_assert(L2CAP_LE_CREDIT_REPLENISH_FRACTION > 1,
+              "Replenish fraction of 1 would return credits on every SDU");
 
 /* Define a structure to hold the configuration parameter for LE L2CAP
  * connection oriented channels.
@@ -539,6 +541,20 @@ extern bool L2CA_DisconnectLECocReq(uint16_t cid);
  ******************************************************************************/
 extern uint8_t L2CA_DataWrite(uint16_t cid, BT_HDR* p_data);
 
+/*******************************************************************************
+ *
+ * Function         L2CA_AllocTxBuffer
+ *
+ * Description      Allocate a transmit buffer with |data_len| bytes of
+ *                  payload space and the headroom the channel needs for
+ *                  in-place header prepending. offset is set to the
+ *                  reserved headroom and len to 0.
+ *
+ * Returns          the allocated buffer
+ *
+ ******************************************************************************/
+extern BT_HDR* L2CA_AllocTxBuffer(uint16_t cid, uint16_t data_len);
+
 extern uint8_t L2CA_LECocDataWrite(uint16_t cid, BT_HDR* p_data);
 
 // Given a local channel identifier, |lcid|, this function returns the bound
@@ -623,6 +639,20 @@ extern bool L2CA_SetAclPriority(const RawAddress& bd_addr,
  ******************************************************************************/
 extern bool L2CA_SetTxPriority(uint16_t cid, tL2CAP_CHNL_PRIORITY priority);
 
+/*******************************************************************************
+ *
+ * Function         L2CA_SetChnlTxQuota
+ *
+ * Description      Sets the per-round transmit token quota for a channel.
+ *                  A non-zero quota caps the number of PDUs the channel may
+ *                  send per scheduling round of its priority group; 0 removes
+ *                  the cap.
+ *
+ * Returns          true if a valid channel, else false
+ *
+ ******************************************************************************/
+extern bool L2CA_SetChnlTxQuota(uint16_t cid, uint8_t quota);
+
 /*******************************************************************************
  *
  * Function         L2CA_SetChnlFlushability
@@ -794,6 +824,22 @@ extern bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda,
 extern bool L2CA_EnableUpdateBleConnParams(const RawAddress& rem_bda,
                                            bool enable);
 
+/*******************************************************************************
+ *
+ *  Function        L2CA_SetBleConnParamsAutoTune
+ *
+ *  Description     Opt a LE link in or out of automatic connection parameter
+ *                  tuning driven by the traffic observed on the link.
+ *
+ *  Parameters:     BD Address of remote
+ *                  enable flag
+ *
+ *  Return value:   true if the policy was changed
+ *
+ ******************************************************************************/
+extern bool L2CA_SetBleConnParamsAutoTune(const RawAddress& rem_bda,
+                                          bool enable);
+
 /*******************************************************************************
  *
  * Function         L2CA_GetBleConnRole
@@ -815,4 +861,31 @@ extern void L2CA_AdjustConnectionIntervals(uint16_t* min_interval,
 extern bool L2CA_IsLinkEstablished(const RawAddress& bd_addr,
                                    tBT_TRANSPORT transport);
 
+/**
+ * Number of ACL packets sent to the controller but not yet reported
+ * complete by a Number of Completed Packets event. Returns 0 when the GD
+ * L2CAP shim owns the data path.
+ */
+extern uint16_t L2CA_GetControllerAclBuffersUsed(void);
+
+/**
+ * Percentile of the queueing latency of recent ACL packets on the BR/EDR link
+ * to the given peer, measured from handoff to the controller until the
+ * matching Number of Completed Packets event. Returns 0 when nothing was
+ * measured or the GD L2CAP shim owns the data path.
+ */
+extern uint16_t L2CA_GetTxLatencyMs(const RawAddress& bd_addr,
+                                    uint8_t percentile);
+
+/**
+ * Dump the per-link TX latency histograms to the given file descriptor.
+ */
+extern void L2CA_LinkTxLatencyDump(int fd);
+
+/**
+ * Dump CCB/LCB pool occupancy (current, allocated and high water mark) to
+ * the given file descriptor.
+ */
+extern void L2CA_PoolUsageDump(int fd);
+
 #endif /* L2C_API_H */
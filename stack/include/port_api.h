@@ -84,6 +84,14 @@ typedef int(tPORT_DATA_CO_CALLBACK)(uint16_t port_handle, uint8_t* p_buf,
 
 typedef void(tPORT_CALLBACK)(uint32_t code, uint16_t port_handle);
 
+/*
+ * Define a scatter/gather element for PORT_WriteDatav
+*/
+typedef struct {
+  const char* p_data; /* data to send */
+  uint16_t len;       /* number of bytes at p_data */
+} tPORT_DATA_VEC;
+
 /*
  * Define events that registered application can receive in the callback
 */
@@ -385,6 +393,22 @@ extern int PORT_ReadData(uint16_t handle, char* p_data, uint16_t max_len,
 extern int PORT_WriteData(uint16_t handle, const char* p_data, uint16_t max_len,
                           uint16_t* p_len);
 
+/*******************************************************************************
+ *
+ * Function         PORT_WriteDatav
+ *
+ * Description      This function is called to send a list of data fragments,
+ *                  gathered into maximum size RFCOMM frames.
+ *
+ * Parameters:      handle     - Handle returned in the RFCOMM_CreateConnection
+ *                  p_vec       - Array of data fragments
+ *                  num_vec     - Number of fragments at p_vec
+ *                  p_len       - Bytes written
+ *
+ ******************************************************************************/
+extern int PORT_WriteDatav(uint16_t handle, const tPORT_DATA_VEC* p_vec,
+                           uint16_t num_vec, uint16_t* p_len);
+
 /*******************************************************************************
  *
  * Function         PORT_WriteDataCO
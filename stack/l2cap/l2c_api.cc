@@ -1042,6 +1042,43 @@ bool L2CA_SetTxPriority(uint16_t cid, tL2CAP_CHNL_PRIORITY priority) {
   return (true);
 }
 
+/*******************************************************************************
+ *
+ * Function         L2CA_SetChnlTxQuota
+ *
+ * Description      Sets the per-round transmit token quota for a channel.
+ *                  A non-zero quota caps the number of PDUs the channel may
+ *                  send per scheduling round of its priority group, reserving
+ *                  the remaining controller buffer share for other channels
+ *                  (e.g. capping bulk OPP/RFCOMM traffic so A2DP and HID are
+ *                  not starved). A quota of 0 removes the cap.
+ *
+ * Returns          true if a valid channel, else false
+ *
+ ******************************************************************************/
+bool L2CA_SetChnlTxQuota(uint16_t cid, uint8_t quota) {
+  if (bluetooth::shim::is_gd_l2cap_enabled()) {
+    /* The GD L2CAP module runs its own scheduler */
+    return false;
+  }
+
+  tL2C_CCB* p_ccb;
+
+  L2CAP_TRACE_API("L2CA_SetChnlTxQuota()  CID: 0x%04x, quota:%d", cid, quota);
+
+  /* Find the channel control block. We don't know the link it is on. */
+  p_ccb = l2cu_find_ccb_by_cid(NULL, cid);
+  if (p_ccb == NULL) {
+    L2CAP_TRACE_WARNING("L2CAP - no CCB for L2CA_SetChnlTxQuota, CID: %d", cid);
+    return (false);
+  }
+
+  p_ccb->tx_token_quota = quota;
+  p_ccb->tx_tokens = quota;
+
+  return (true);
+}
+
 /*******************************************************************************
  *
  *  Function         L2CA_GetPeerFeatures
@@ -1476,6 +1513,36 @@ bool L2CA_SetLeGattTimeout(const RawAddress& rem_bda, uint16_t idle_tout) {
  *                  L2CAP_DW_FAILED, if error
  *
  ******************************************************************************/
+/*******************************************************************************
+ *
+ * Function         L2CA_AllocTxBuffer
+ *
+ * Description      Allocate a transmit buffer with enough headroom for the
+ *                  channel's L2CAP and HCI headers (including the SDU
+ *                  length field on LE credit based channels) so the lower
+ *                  layers prepend in place instead of re-copying. offset
+ *                  is set to the reserved headroom and len to 0; the
+ *                  caller writes |data_len| payload bytes starting at
+ *                  (p_buf + 1) + p_buf->offset. When |cid| is not (yet) a
+ *                  known channel the worst case headroom is reserved.
+ *
+ * Returns          the allocated buffer
+ *
+ ******************************************************************************/
+BT_HDR* L2CA_AllocTxBuffer(uint16_t cid, uint16_t data_len) {
+  uint16_t headroom = L2CAP_LCC_OFFSET; /* worst case */
+
+  tL2C_CCB* p_ccb = l2cu_find_ccb_by_cid(NULL, cid);
+  if (p_ccb != NULL && p_ccb->p_lcb != NULL &&
+      p_ccb->p_lcb->transport == BT_TRANSPORT_BR_EDR)
+    headroom = L2CAP_MIN_OFFSET;
+
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + headroom + data_len);
+  p_buf->offset = headroom;
+  p_buf->len = 0;
+  return p_buf;
+}
+
 uint8_t L2CA_DataWrite(uint16_t cid, BT_HDR* p_data) {
   if (bluetooth::shim::is_gd_l2cap_enabled()) {
     return bluetooth::shim::L2CA_DataWrite(cid, p_data);
@@ -1638,3 +1705,86 @@ bool L2CA_IsLinkEstablished(const RawAddress& bd_addr,
 
   return l2cu_find_lcb_by_bd_addr(bd_addr, transport) != nullptr;
 }
+
+uint16_t L2CA_GetControllerAclBuffersUsed(void) {
+  if (bluetooth::shim::is_gd_l2cap_enabled()) {
+    return 0;
+  }
+
+  if (l2cb.controller_xmit_window >= l2cb.num_lm_acl_bufs) return 0;
+  return l2cb.num_lm_acl_bufs - l2cb.controller_xmit_window;
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_tx_lat_percentile
+ *
+ * Description      Read the given percentile out of a link's TX latency
+ *                  histogram. The value returned is the upper bound in
+ *                  milliseconds of the bucket the percentile falls in.
+ *
+ * Returns          Latency in milliseconds; 0 when nothing was measured.
+ *
+ ******************************************************************************/
+static uint16_t l2c_tx_lat_percentile(const tL2C_LCB* p_lcb,
+                                      uint8_t percentile) {
+  uint32_t total = p_lcb->tx_lat.completed;
+  if (total == 0) return 0;
+
+  uint64_t needed = ((uint64_t)total * percentile + 99) / 100;
+  uint64_t cumulative = 0;
+  for (uint8_t i = 0; i < L2CAP_TX_LATENCY_BUCKETS; i++) {
+    cumulative += p_lcb->tx_lat.bucket[i];
+    if (cumulative >= needed) {
+      if (i < L2CAP_TX_LATENCY_BUCKETS - 1)
+        return L2CAP_TX_LATENCY_BOUNDS_MS[i];
+      /* Catch-all bucket has no upper edge; report past the last bound */
+      return L2CAP_TX_LATENCY_BOUNDS_MS[L2CAP_TX_LATENCY_BUCKETS - 2] * 2;
+    }
+  }
+  return 0;
+}
+
+uint16_t L2CA_GetTxLatencyMs(const RawAddress& bd_addr, uint8_t percentile) {
+  if (bluetooth::shim::is_gd_l2cap_enabled()) {
+    return 0;
+  }
+
+  tL2C_LCB* p_lcb = l2cu_find_lcb_by_bd_addr(bd_addr, BT_TRANSPORT_BR_EDR);
+  if (p_lcb == nullptr) return 0;
+  return l2c_tx_lat_percentile(p_lcb, percentile);
+}
+
+void L2CA_LinkTxLatencyDump(int fd) {
+  if (bluetooth::shim::is_gd_l2cap_enabled()) {
+    return;
+  }
+
+  dprintf(fd, "\nL2CAP ACL TX latency:\n");
+  for (int i = 0; i < MAX_L2CAP_LINKS; i++) {
+    const tL2C_LCB* p_lcb = &l2cb.lcb_pool[i];
+    if (!p_lcb->in_use) continue;
+    dprintf(fd, "  %s completed:%u in_flight:%d p50:%dms p95:%dms p99:%dms\n",
+            p_lcb->remote_bd_addr.ToString().c_str(), p_lcb->tx_lat.completed,
+            p_lcb->tx_lat.count + p_lcb->tx_lat.skipped,
+            l2c_tx_lat_percentile(p_lcb, 50), l2c_tx_lat_percentile(p_lcb, 95),
+            l2c_tx_lat_percentile(p_lcb, 99));
+    dprintf(fd, "    quota:%u loan:%u credit_waits:%u wait_total:%ums\n",
+            p_lcb->link_xmit_quota, p_lcb->credit_loan,
+            p_lcb->credit_wait.episodes,
+            (unsigned int)p_lcb->credit_wait.total_ms);
+  }
+}
+
+void L2CA_PoolUsageDump(int fd) {
+  if (bluetooth::shim::is_gd_l2cap_enabled()) {
+    return;
+  }
+
+  dprintf(fd, "\nL2CAP pool occupancy:\n");
+  dprintf(fd, "  CCBs in_use:%u allocated:%u high_water:%u slabs:%u\n",
+          l2cb.num_used_ccbs, l2cb.num_ccbs, l2cb.max_used_ccbs,
+          l2cb.num_ccb_slabs);
+  dprintf(fd, "  LCBs in_use:%u allocated:%u\n", l2cb.num_used_lcbs,
+          MAX_L2CAP_LINKS);
+}
@@ -36,6 +36,7 @@
 #include "l2cdefs.h"
 #include "main/shim/l2c_api.h"
 #include "main/shim/shim.h"
+#include "osi/include/alarm.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
 #include "stack/btm/btm_dev.h"
@@ -160,6 +161,252 @@ bool L2CA_EnableUpdateBleConnParams(const RawAddress& rem_bda, bool enable) {
   return (true);
 }
 
+/* LE connection parameter auto-tuner (see tL2C_LCB.conn_tune) */
+constexpr uint64_t L2C_BLE_TUNE_PERIOD_MS = 1000;
+/* at least this many bytes per period counts as a bulk transfer */
+constexpr uint32_t L2C_BLE_TUNE_BULK_BYTES = 4096;
+/* periods a quieter class must hold before parameters step down */
+constexpr uint8_t L2C_BLE_TUNE_STEP_DOWN_PERIODS = 3;
+
+/* Parameter sets per traffic class, indexed by L2C_BLE_TUNE_* */
+static const struct {
+  uint16_t min_int; /* 1.25 ms units */
+  uint16_t max_int;
+  uint16_t latency;
+  uint16_t timeout; /* 10 ms units */
+} l2c_ble_tune_params[] = {
+    /* IDLE: long interval, peripheral may skip a couple of events */
+    {0x00A0, 0x00C0, 2, 600},
+    /* INTERACTIVE: the stock 30 - 50 ms */
+    {0x0018, 0x0028, 0, 500},
+    /* BULK: shortest practical interval for throughput */
+    {0x0006, 0x000C, 0, 500},
+};
+
+static void l2cble_conn_tune_timeout(void* data);
+
+/* below this RSSI a marginal bulk link prefers coded PHY over 2M */
+constexpr int8_t L2C_BLE_TUNE_CODED_PHY_RSSI_FLOOR = -80; /* dBm */
+
+/*******************************************************************************
+ *
+ *  Function        l2cble_conn_tune_phy_rssi_cb
+ *
+ *  Description     RSSI read kicked off by a bulk upgrade completed; pick
+ *                  the PHY the link is best served by. A healthy link gets
+ *                  2M for symbol rate, a marginal one gets coded PHY for
+ *                  range. Capability gating relies on the peer feature page
+ *                  cached with the ACL, so no extra air traffic is spent.
+ *
+ *  Return value:   void
+ *
+ ******************************************************************************/
+static void l2cble_conn_tune_phy_rssi_cb(void* p_data) {
+  tBTM_RSSI_RESULT* p_result = (tBTM_RSSI_RESULT*)p_data;
+
+  if (!p_result || p_result->status != BTM_SUCCESS) return;
+
+  tL2C_LCB* p_lcb =
+      l2cu_find_lcb_by_bd_addr(p_result->rem_bda, BT_TRANSPORT_LE);
+  if (!p_lcb || !p_lcb->conn_tune.enabled) return;
+
+  /* LE Set PHY preference bits: 0x01 1M, 0x02 2M, 0x04 coded */
+  uint8_t phys = 0x02;
+  if (p_result->rssi < L2C_BLE_TUNE_CODED_PHY_RSSI_FLOOR &&
+      controller_get_interface()->supports_ble_coded_phy() &&
+      acl_peer_supports_ble_coded_phy(p_lcb->Handle())) {
+    phys = 0x04;
+  } else if (!controller_get_interface()->supports_ble_2m_phy() ||
+             !acl_peer_supports_ble_2m_phy(p_lcb->Handle())) {
+    /* nothing better than 1M available on this pairing */
+    return;
+  }
+
+  L2CAP_TRACE_API("%s: BD_ADDR %s phys 0x%02x rssi %d", __func__,
+                  p_lcb->remote_bd_addr.ToString().c_str(), phys,
+                  p_result->rssi);
+  BTM_BleSetPhy(p_lcb->remote_bd_addr, phys, phys, 0);
+}
+
+/*******************************************************************************
+ *
+ *  Function        l2cble_conn_tune_apply
+ *
+ *  Description     Negotiate the parameter set for TRAFFIC_CLASS on the link.
+ *
+ *  Return value:   void
+ *
+ ******************************************************************************/
+static void l2cble_conn_tune_apply(tL2C_LCB* p_lcb, uint8_t traffic_class) {
+  p_lcb->conn_tune.traffic_class = traffic_class;
+  p_lcb->conn_tune.pending_periods = 0;
+
+  L2CAP_TRACE_API("%s: BD_ADDR %s class %d", __func__,
+                  p_lcb->remote_bd_addr.ToString().c_str(), traffic_class);
+
+  if (traffic_class == L2C_BLE_TUNE_BULK && !p_lcb->conn_tune.phy_upgraded) {
+    /* One PHY preference request per bulk episode; the RSSI read decides
+     * between 2M and coded and drops the request if neither side can do
+     * better than 1M */
+    p_lcb->conn_tune.phy_upgraded = true;
+    if (BTM_ReadRSSI(p_lcb->remote_bd_addr, l2cble_conn_tune_phy_rssi_cb) !=
+        BTM_CMD_STARTED) {
+      BTM_BleSetPhy(p_lcb->remote_bd_addr, 0x02 /* 2M */, 0x02 /* 2M */, 0);
+    }
+  } else if (traffic_class == L2C_BLE_TUNE_IDLE) {
+    /* Let the next bulk episode re-evaluate the PHY */
+    p_lcb->conn_tune.phy_upgraded = false;
+  }
+
+  L2CA_UpdateBleConnParams(p_lcb->remote_bd_addr,
+                           l2c_ble_tune_params[traffic_class].min_int,
+                           l2c_ble_tune_params[traffic_class].max_int,
+                           l2c_ble_tune_params[traffic_class].latency,
+                           l2c_ble_tune_params[traffic_class].timeout, 0, 0);
+}
+
+/*******************************************************************************
+ *
+ *  Function        l2cble_conn_tune_timeout
+ *
+ *  Description     Evaluation period expired; classify the traffic moved
+ *                  since the last period and follow it with the connection
+ *                  parameters. Busier classes are applied immediately so a
+ *                  starting transfer ramps without delay; quieter classes
+ *                  must hold for a few periods first.
+ *
+ *  Return value:   void
+ *
+ ******************************************************************************/
+static void l2cble_conn_tune_timeout(void* data) {
+  tL2C_LCB* p_lcb = (tL2C_LCB*)data;
+
+  if (!p_lcb->in_use || !p_lcb->conn_tune.enabled) return;
+
+  uint32_t bytes = p_lcb->conn_tune.bytes;
+  p_lcb->conn_tune.bytes = 0;
+
+  uint8_t traffic_class = L2C_BLE_TUNE_IDLE;
+  if (bytes >= L2C_BLE_TUNE_BULK_BYTES)
+    traffic_class = L2C_BLE_TUNE_BULK;
+  else if (bytes > 0)
+    traffic_class = L2C_BLE_TUNE_INTERACTIVE;
+
+  if (traffic_class > p_lcb->conn_tune.traffic_class) {
+    l2cble_conn_tune_apply(p_lcb, traffic_class);
+  } else if (traffic_class < p_lcb->conn_tune.traffic_class) {
+    if (traffic_class != p_lcb->conn_tune.pending_class)
+      p_lcb->conn_tune.pending_periods = 0;
+    p_lcb->conn_tune.pending_class = traffic_class;
+    if (++p_lcb->conn_tune.pending_periods >= L2C_BLE_TUNE_STEP_DOWN_PERIODS)
+      l2cble_conn_tune_apply(p_lcb, traffic_class);
+  } else {
+    p_lcb->conn_tune.pending_periods = 0;
+  }
+
+  alarm_set_on_mloop(p_lcb->conn_tune.timer, L2C_BLE_TUNE_PERIOD_MS,
+                     l2cble_conn_tune_timeout, p_lcb);
+}
+
+/*******************************************************************************
+ *
+ *  Function        L2CA_SetBleConnParamsAutoTune
+ *
+ *  Description     Opt a LE link in or out of automatic connection parameter
+ *                  tuning. While opted in, the link's traffic is sampled
+ *                  periodically and the connection interval and latency
+ *                  follow the observed class (idle/interactive/bulk), so
+ *                  idle links stop burning airtime and bulk transfers get
+ *                  the shortest practical interval without the app asking.
+ *
+ *  Parameters:     BD Address of remote
+ *                  enable flag
+ *
+ *  Return value:   true if the policy was changed
+ *
+ ******************************************************************************/
+bool L2CA_SetBleConnParamsAutoTune(const RawAddress& rem_bda, bool enable) {
+  if (bluetooth::shim::is_gd_l2cap_enabled()) return false;
+
+  tL2C_LCB* p_lcb = l2cu_find_lcb_by_bd_addr(rem_bda, BT_TRANSPORT_LE);
+  if (!p_lcb) {
+    LOG(WARNING) << __func__ << " - unknown BD_ADDR " << rem_bda;
+    return false;
+  }
+
+  if (p_lcb->transport != BT_TRANSPORT_LE) {
+    LOG(WARNING) << __func__ << " - BD_ADDR " << rem_bda << " not LE";
+    return false;
+  }
+
+  p_lcb->conn_tune.enabled = enable;
+  p_lcb->conn_tune.bytes = 0;
+  p_lcb->conn_tune.pending_periods = 0;
+
+  if (enable) {
+    /* Until traffic says otherwise, assume an interactive link */
+    p_lcb->conn_tune.traffic_class = L2C_BLE_TUNE_INTERACTIVE;
+    alarm_set_on_mloop(p_lcb->conn_tune.timer, L2C_BLE_TUNE_PERIOD_MS,
+                       l2cble_conn_tune_timeout, p_lcb);
+  } else {
+    alarm_cancel(p_lcb->conn_tune.timer);
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+ *
+ *  Function        l2cble_post_encryption_bringup
+ *
+ *  Description     Encryption just completed on the LE link; pipeline the
+ *                  remaining link-level negotiations in one go instead of
+ *                  leaving each profile to trigger them at its own pace.
+ *                  The data length update, the PHY preference and the
+ *                  interactive connection parameters are all issued
+ *                  back-to-back, gated on the controller features and the
+ *                  peer feature page cached with the ACL, so first data
+ *                  rides an already-negotiated link. Runs once per
+ *                  connection.
+ *
+ *  Return value:   void
+ *
+ ******************************************************************************/
+void l2cble_post_encryption_bringup(const RawAddress& bda) {
+  if (bluetooth::shim::is_gd_l2cap_enabled()) return;
+
+  tL2C_LCB* p_lcb = l2cu_find_lcb_by_bd_addr(bda, BT_TRANSPORT_LE);
+  if (!p_lcb || p_lcb->transport != BT_TRANSPORT_LE) return;
+
+  if (p_lcb->le_bringup_done) return;
+  p_lcb->le_bringup_done = true;
+
+  L2CAP_TRACE_API("%s: BD_ADDR %s", __func__,
+                  p_lcb->remote_bd_addr.ToString().c_str());
+
+  /* Stretch the LLCP payload to the maximum right away; a later ATT MTU
+   * exchange then costs no extra data length round trip because BTM caps
+   * requests at the controller maximum already issued here */
+  if (controller_get_interface()->supports_ble_packet_extension() &&
+      acl_peer_supports_ble_packet_extension(p_lcb->Handle())) {
+    BTM_SetBleDataLength(p_lcb->remote_bd_addr, BTM_BLE_DATA_SIZE_MAX);
+  }
+
+  /* Prefer 2M symbol rate when both sides can do it; the auto-tuner may
+   * still steer a marginal bulk link to coded PHY later */
+  if (controller_get_interface()->supports_ble_2m_phy() &&
+      acl_peer_supports_ble_2m_phy(p_lcb->Handle())) {
+    BTM_BleSetPhy(p_lcb->remote_bd_addr, 0x02 /* 2M */, 0x02 /* 2M */, 0);
+  }
+
+  /* Service discovery and the first requests are interactive traffic;
+   * negotiate that parameter set now rather than after the first stall */
+  const auto& params = l2c_ble_tune_params[L2C_BLE_TUNE_INTERACTIVE];
+  L2CA_UpdateBleConnParams(p_lcb->remote_bd_addr, params.min_int,
+                           params.max_int, params.latency, params.timeout, 0,
+                           0);
+}
+
 hci_role_t L2CA_GetBleConnRole(const RawAddress& bd_addr) {
   if (bluetooth::shim::is_gd_l2cap_enabled()) {
     return bluetooth::shim::L2CA_GetBleConnRole(bd_addr);
@@ -582,7 +829,7 @@ void l2cble_process_sig_cmd(tL2C_LCB* p_lcb, uint8_t* p, uint16_t pkt_len) {
           temp_p_ccb->ecoc = true;
           temp_p_ccb->remote_id = id;
           temp_p_ccb->p_rcb = p_rcb;
-          temp_p_ccb->remote_cid = rcid;
+          l2cu_set_remote_cid(temp_p_ccb, rcid);
 
           temp_p_ccb->peer_conn_cfg.mtu = mtu;
           temp_p_ccb->peer_conn_cfg.mps = mps;
@@ -902,7 +1149,7 @@ void l2cble_process_sig_cmd(tL2C_LCB* p_lcb, uint8_t* p, uint16_t pkt_len) {
 
       p_ccb->remote_id = id;
       p_ccb->p_rcb = p_rcb;
-      p_ccb->remote_cid = rcid;
+      l2cu_set_remote_cid(p_ccb, rcid);
 
       p_ccb->local_conn_cfg.mtu = L2CAP_SDU_LENGTH_LE_MAX;
       p_ccb->local_conn_cfg.mps =
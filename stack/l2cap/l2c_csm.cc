@@ -605,7 +605,7 @@ static void l2c_csm_w4_l2cap_connect_rsp(tL2C_CCB* p_ccb, tL2CEVT event,
       break;
 
     case L2CEVT_L2CAP_CONNECT_RSP: /* Got peer connect confirm */
-      p_ccb->remote_cid = p_ci->remote_cid;
+      l2cu_set_remote_cid(p_ccb, p_ci->remote_cid);
       if (p_ccb->p_lcb->transport == BT_TRANSPORT_LE) {
         /* Connection is completed */
         alarm_cancel(p_ccb->l2c_ccb_timer);
@@ -626,7 +626,7 @@ static void l2c_csm_w4_l2cap_connect_rsp(tL2C_CCB* p_ccb, tL2CEVT event,
       break;
 
     case L2CEVT_L2CAP_CONNECT_RSP_PND: /* Got peer connect pending */
-      p_ccb->remote_cid = p_ci->remote_cid;
+      l2cu_set_remote_cid(p_ccb, p_ci->remote_cid);
       alarm_set_on_mloop(p_ccb->l2c_ccb_timer,
                          L2CAP_CHNL_CONNECT_EXT_TIMEOUT_MS,
                          l2c_ccb_timer_timeout, p_ccb);
@@ -0,0 +1,38 @@
+/******************************************************************************
+ *
+ *  Copyright 2021 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef L2C_FCS_H
+#define L2C_FCS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ *
+ * Function         l2c_fcs_crc16
+ *
+ * Description      Compute the L2CAP ERTM FCS (CRC-16, polynomial
+ *                  x**16 + x**15 + x**2 + 1, reflected) of |length| bytes at
+ *                  |p|, continuing from |initial|.
+ *
+ * Returns          CRC
+ *
+ ******************************************************************************/
+uint16_t l2c_fcs_crc16(uint16_t initial, const uint8_t* p, size_t length);
+
+#endif /* L2C_FCS_H */
@@ -37,11 +37,18 @@
 #include "l2cap_security_interface.h"
 #include "l2cdefs.h"
 #include "osi/include/alarm.h"
+#include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/list.h"
 #include "stack/include/hci_error_code.h"
 #include "types/hci_role.h"
 
+/* Attribute this module's allocations to L2CAP in the memory ledger */
+#ifndef osi_malloc
+#define osi_malloc(size) osi_malloc_tagged((size), ALLOC_TAG_L2CAP)
+#define osi_calloc(size) osi_calloc_tagged((size), ALLOC_TAG_L2CAP)
+#endif
+
 #define L2CAP_MIN_MTU 48 /* Minimum acceptable MTU is 48 bytes */
 
 constexpr uint16_t L2CAP_CREDIT_BASED_MIN_MTU = 64;
@@ -55,6 +62,8 @@ constexpr uint16_t L2CAP_CREDIT_BASED_MIN_MPS = 64;
 #define L2CAP_LINK_CONNECT_TIMEOUT_MS (60 * 1000)      /* 30 seconds */
 #define L2CAP_LINK_CONNECT_EXT_TIMEOUT_MS (120 * 1000) /* 120 seconds */
 #define L2CAP_LINK_FLOW_CONTROL_TIMEOUT_MS (2 * 1000)  /* 2 seconds */
+#define L2CAP_SNIFF_BATCH_MIN_MS 10  /* Min hold for sniff batching */
+#define L2CAP_SNIFF_BATCH_MAX_MS 60  /* Cap hold under deep subrating */
 #define L2CAP_LINK_DISCONNECT_TIMEOUT_MS (30 * 1000)   /* 30 seconds */
 #define L2CAP_CHNL_CONNECT_TIMEOUT_MS (60 * 1000)      /* 60 seconds */
 #define L2CAP_CHNL_CONNECT_EXT_TIMEOUT_MS (120 * 1000) /* 120 seconds */
@@ -228,6 +237,10 @@ typedef struct {
   uint8_t last_ack_sent;     /* Last peer sequence number ack'ed */
   uint8_t num_tries;         /* Number of retries to send a packet */
   uint8_t max_held_acks;     /* Max acks we can hold before sending */
+  uint8_t adaptive_tx_win;   /* Dynamic cap on unacked I-frames; halved on a
+                                whole-window retransmission, regrown by clean
+                                acks. 0 until the first loss event */
+  uint8_t win_growth_acks;   /* Clean acks counted towards window regrowth */
 
   bool remote_busy; /* true if peer has flowed us off */
 
@@ -286,6 +299,8 @@ typedef struct {
 */
 typedef struct t_l2c_ccb {
   bool in_use;                /* true when in use, false when not */
+  uint16_t ccb_index; /* Fixed index of this CCB in the channel pool;
+                         assigned when its slab is created */
   tL2C_CHNL_STATE chnl_state; /* Channel state */
   tL2CAP_LE_CFG_INFO
       local_conn_cfg; /* Our config for ble conn oriented channel */
@@ -299,8 +314,12 @@ typedef struct t_l2c_ccb {
   struct t_l2c_ccb* p_prev_ccb; /* Previous CCB in the chain */
   struct t_l2c_linkcb* p_lcb;   /* Link this CCB is assigned to */
 
+  struct t_l2c_ccb* p_rcid_hash_next; /* Next CCB in the same remote CID
+                                         hash bucket on the link */
+
   uint16_t local_cid;  /* Local CID */
-  uint16_t remote_cid; /* Remote CID */
+  uint16_t remote_cid; /* Remote CID; update via l2cu_set_remote_cid() so
+                          the per-link remote CID hash stays in sync */
 
   alarm_t* l2c_ccb_timer; /* CCB Timer Entry */
 
@@ -329,6 +348,15 @@ typedef struct t_l2c_ccb {
   uint16_t buff_quota;        /* Buffer quota before sending congestion */
 
   tL2CAP_CHNL_PRIORITY ccb_priority;  /* Channel priority */
+
+  /* Per-channel token bucket within the priority group round-robin. A
+   * non-zero quota caps how many PDUs the channel may send per scheduling
+   * round, leaving the rest of the group quota (and controller buffers) to
+   * its siblings; 0 leaves the channel unlimited. Set via
+   * L2CA_SetChnlTxQuota(). */
+  uint8_t tx_token_quota; /* Max PDUs per scheduling round; 0 = no limit */
+  uint8_t tx_tokens;      /* Tokens left in the current round */
+
   tL2CAP_CHNL_DATA_RATE tx_data_rate; /* Channel Tx data rate */
   tL2CAP_CHNL_DATA_RATE rx_data_rate; /* Channel Rx data rate */
 
@@ -423,11 +451,24 @@ typedef enum : uint8_t {
 /* Define a link control block. There is one link control block between
  * this device and any other device (i.e. BD ADDR).
 */
+/* TX latency histogram geometry. The bounds are the inclusive upper edge in
+ * milliseconds of each bucket; the final bucket catches everything above. */
+#define L2CAP_TX_LATENCY_RING_SIZE 32
+#define L2CAP_TX_LATENCY_BUCKETS 8
+constexpr uint16_t L2CAP_TX_LATENCY_BOUNDS_MS[L2CAP_TX_LATENCY_BUCKETS - 1] = {
+    5, 10, 20, 50, 100, 200, 500};
+
 typedef struct t_l2c_linkcb {
   bool in_use; /* true when in use, false when not */
   tL2C_LINK_STATE link_state;
 
   alarm_t* l2c_lcb_timer; /* Timer entry for timeout evt */
+
+  /* Background channel data is held while the link sleeps in sniff mode so
+   * it goes out in one batch per sniff interval instead of per packet */
+  alarm_t* sniff_batch_timer;
+  bool sniff_batch_draining; /* Timer fired; held data must go out now */
+
  private:
   uint16_t handle_; /* The handle used with LM */
   friend void l2cu_set_lcb_handle(struct t_l2c_linkcb& p_lcb, uint16_t handle);
@@ -439,6 +480,13 @@ typedef struct t_l2c_linkcb {
 
   tL2C_CCB_Q ccb_queue; /* Queue of CCBs on this LCB */
 
+/* Number of buckets in the per-link remote CID hash; must be a power of 2 */
+#define L2CAP_RCID_HASH_SIZE 32
+  /* Remote CID -> CCB hash buckets, chained through p_rcid_hash_next.
+   * Maintained by l2cu_set_remote_cid()/l2cu_release_ccb() so that
+   * l2cu_find_ccb_by_remote_cid() does not scan the whole CCB queue. */
+  tL2C_CCB* rcid_hash[L2CAP_RCID_HASH_SIZE];
+
   tL2C_CCB* p_pending_ccb;  /* ccb of waiting channel during link disconnect */
   alarm_t* info_resp_timer; /* Timer entry for info resp timeout evt */
   RawAddress remote_bd_addr; /* The BD address of the remote */
@@ -468,6 +516,21 @@ typedef struct t_l2c_linkcb {
   bool is_round_robin_scheduling() const { return link_xmit_quota == 0; }
 
   uint16_t sent_not_acked;  /* Num packets sent but not acked */
+
+  uint16_t credit_loan; /* Credits borrowed from the shared pool on top of
+                           link_xmit_quota; repaid as completions arrive */
+  uint16_t effective_xmit_quota() const {
+    return link_xmit_quota + credit_loan;
+  }
+
+  /* Credit-wait instrumentation: time this link spent with data queued
+   * while every credit it may use was in flight. */
+  struct {
+    uint64_t start_ms; /* boottime ms the current wait began; 0 when idle */
+    uint64_t total_ms;
+    uint32_t episodes;
+  } credit_wait;
+
   void update_outstanding_packets(uint16_t packets_acked) {
     if (sent_not_acked > packets_acked)
       sent_not_acked -= packets_acked;
@@ -475,6 +538,18 @@ typedef struct t_l2c_linkcb {
       sent_not_acked = 0;
   }
 
+  /* TX latency instrumentation: one send timestamp per controller buffer
+   * consumed, matched in FIFO order against Number of Completed Packets.
+   * Completion deltas land in a histogram surfaced through dumpsys. */
+  struct {
+    uint64_t sent_ms[L2CAP_TX_LATENCY_RING_SIZE];
+    uint8_t head;     /* oldest recorded entry */
+    uint8_t count;    /* recorded entries awaiting completion */
+    uint16_t skipped; /* in-flight credits the full ring could not record */
+    uint32_t bucket[L2CAP_TX_LATENCY_BUCKETS];
+    uint32_t completed; /* completions with a recorded timestamp */
+  } tx_lat;
+
   bool partial_segment_being_sent; /* Set true when a partial segment */
                                    /* is being sent. */
   bool w4_info_rsp;                /* true when info request is active */
@@ -525,6 +600,29 @@ typedef struct t_l2c_linkcb {
   uint16_t min_ce_len;
   uint16_t max_ce_len;
 
+/* Traffic classes assigned by the LE connection parameter auto-tuner */
+#define L2C_BLE_TUNE_IDLE 0
+#define L2C_BLE_TUNE_INTERACTIVE 1
+#define L2C_BLE_TUNE_BULK 2
+
+  /* Opt-in LE connection parameter auto-tuner. Link traffic is classified
+   * from a byte counter sampled once per evaluation period and the
+   * negotiated interval/latency follow the class; quieter classes only
+   * take effect after holding for several consecutive periods. */
+  struct {
+    bool enabled;
+    uint8_t traffic_class;   /* class the current parameters serve */
+    uint8_t pending_class;   /* quieter class waiting out the hysteresis */
+    uint8_t pending_periods; /* consecutive periods pending_class held */
+    uint32_t bytes;          /* bytes moved since the last evaluation */
+    bool phy_upgraded;       /* PHY preference requested this bulk episode */
+    alarm_t* timer;          /* evaluation period timer */
+  } conn_tune;
+
+  /* post-encryption bring-up (DLE, PHY and connection interval) already
+   * pipelined for this connection; see l2cble_post_encryption_bringup */
+  bool le_bringup_done;
+
   /* each priority group is limited burst transmission */
   /* round robin service for the same priority channels */
   tL2C_RR_SERV rr_serv[L2CAP_NUM_CHNL_PRIORITY];
@@ -576,9 +674,21 @@ typedef struct {
 
   bool is_cong_cback_context;
 
-  tL2C_LCB lcb_pool[MAX_L2CAP_LINKS];    /* Link Control Block pool */
-  tL2C_CCB ccb_pool[MAX_L2CAP_CHANNELS]; /* Channel Control Block pool */
-  tL2C_RCB rcb_pool[MAX_L2CAP_CLIENTS];  /* Registration info pool */
+  tL2C_LCB lcb_pool[MAX_L2CAP_LINKS];   /* Link Control Block pool */
+  tL2C_RCB rcb_pool[MAX_L2CAP_CLIENTS]; /* Registration info pool */
+
+/* Maximum number of slabs the CCB pool may grow to */
+#define L2CAP_MAX_CCB_SLABS 8
+
+  /* Channel Control Blocks live in heap slabs so the pool size can be set
+   * at init time and grown under EATT/CoC load. Slabs are never freed or
+   * moved while the stack is up, so CCB pointers stay stable. */
+  tL2C_CCB* ccb_slabs[L2CAP_MAX_CCB_SLABS];
+  uint16_t ccb_slab_size;  /* CCBs per slab (the initial pool size) */
+  uint16_t num_ccb_slabs;  /* Slabs currently allocated */
+  uint16_t num_ccbs;       /* Total CCBs across all slabs */
+  uint16_t num_used_ccbs;  /* CCBs currently in use */
+  uint16_t max_used_ccbs;  /* CCB occupancy high water mark */
 
   tL2C_CCB* p_free_ccb_first; /* Pointer to first free CCB */
   tL2C_CCB* p_free_ccb_last;  /* Pointer to last  free CCB */
@@ -686,9 +796,12 @@ extern void l2cu_change_pri_ccb(tL2C_CCB* p_ccb, tL2CAP_CHNL_PRIORITY priority);
 
 extern tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid);
 extern void l2cu_release_ccb(tL2C_CCB* p_ccb);
+extern tL2C_CCB* l2cu_get_ccb_by_index(uint16_t ccb_index);
+extern bool l2cu_grow_ccb_pool(void);
 extern tL2C_CCB* l2cu_find_ccb_by_cid(tL2C_LCB* p_lcb, uint16_t local_cid);
 extern tL2C_CCB* l2cu_find_ccb_by_remote_cid(tL2C_LCB* p_lcb,
                                              uint16_t remote_cid);
+extern void l2cu_set_remote_cid(tL2C_CCB* p_ccb, uint16_t remote_cid);
 extern bool l2c_is_cmd_rejected(uint8_t cmd_code, uint8_t id, tL2C_LCB* p_lcb);
 
 extern void l2cu_send_peer_cmd_reject(tL2C_LCB* p_lcb, uint16_t reason,
@@ -27,6 +27,7 @@
 
 #include <cstdint>
 
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "main/shim/l2c_api.h"
 #include "main/shim/shim.h"
@@ -56,6 +57,141 @@ void btm_sco_acl_removed(const RawAddress* bda);
 static void l2c_link_send_to_lower(tL2C_LCB* p_lcb, BT_HDR* p_buf);
 static BT_HDR* l2cu_get_next_buffer_to_send(tL2C_LCB* p_lcb);
 
+/*******************************************************************************
+ *
+ * Function         l2c_link_tx_lat_record
+ *
+ * Description      Record the send time of |num_credits| controller buffers
+ *                  so completion events can be turned into latencies.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void l2c_link_tx_lat_record(tL2C_LCB* p_lcb, uint16_t num_credits) {
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+
+  while (num_credits-- > 0) {
+    /* Once a credit goes unrecorded, later ones must too or the FIFO match
+     * against Number of Completed Packets would pair wrong timestamps */
+    if (p_lcb->tx_lat.skipped == 0 &&
+        p_lcb->tx_lat.count < L2CAP_TX_LATENCY_RING_SIZE) {
+      uint8_t idx = (p_lcb->tx_lat.head + p_lcb->tx_lat.count) %
+                    L2CAP_TX_LATENCY_RING_SIZE;
+      p_lcb->tx_lat.sent_ms[idx] = now_ms;
+      p_lcb->tx_lat.count++;
+    } else {
+      p_lcb->tx_lat.skipped++;
+    }
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_link_tx_lat_complete
+ *
+ * Description      Consume |num_sent| completed packets, oldest first, and
+ *                  add their queueing delays to the link's histogram.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void l2c_link_tx_lat_complete(tL2C_LCB* p_lcb, uint16_t num_sent) {
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+
+  while (num_sent-- > 0) {
+    if (p_lcb->tx_lat.count > 0) {
+      uint64_t delta_ms = now_ms - p_lcb->tx_lat.sent_ms[p_lcb->tx_lat.head];
+      p_lcb->tx_lat.head =
+          (p_lcb->tx_lat.head + 1) % L2CAP_TX_LATENCY_RING_SIZE;
+      p_lcb->tx_lat.count--;
+
+      uint8_t bucket = 0;
+      while (bucket < L2CAP_TX_LATENCY_BUCKETS - 1 &&
+             delta_ms > L2CAP_TX_LATENCY_BOUNDS_MS[bucket])
+        bucket++;
+      p_lcb->tx_lat.bucket[bucket]++;
+      p_lcb->tx_lat.completed++;
+    } else if (p_lcb->tx_lat.skipped > 0) {
+      p_lcb->tx_lat.skipped--;
+    } else {
+      break;
+    }
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_link_credit_wait_start
+ *
+ * Description      Mark the start of a stall where the link has data queued
+ *                  but every credit it may use is in flight. No-op when a
+ *                  wait is already being measured.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void l2c_link_credit_wait_start(tL2C_LCB* p_lcb) {
+  if (p_lcb->credit_wait.start_ms == 0)
+    p_lcb->credit_wait.start_ms = bluetooth::common::time_get_os_boottime_ms();
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_link_credit_wait_end
+ *
+ * Description      Close the current credit-wait episode, if any, and fold
+ *                  its duration into the link's totals.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void l2c_link_credit_wait_end(tL2C_LCB* p_lcb) {
+  if (p_lcb->credit_wait.start_ms == 0) return;
+
+  p_lcb->credit_wait.total_ms +=
+      bluetooth::common::time_get_os_boottime_ms() -
+      p_lcb->credit_wait.start_ms;
+  p_lcb->credit_wait.episodes++;
+  p_lcb->credit_wait.start_ms = 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_link_try_borrow_credit
+ *
+ * Description      Grant the link one credit on loan from the shared
+ *                  controller window when it has exhausted its static quota.
+ *                  Every other dedicated-quota link with quota headroom
+ *                  keeps one credit reserved, so a borrower can never starve
+ *                  a peer below its guaranteed minimum. Loans are repaid by
+ *                  completion events.
+ *
+ * Returns          true if a credit was loaned out
+ *
+ ******************************************************************************/
+static bool l2c_link_try_borrow_credit(tL2C_LCB* p_requester) {
+  bool is_le = (p_requester->transport == BT_TRANSPORT_LE);
+  uint16_t window =
+      is_le ? l2cb.controller_le_xmit_window : l2cb.controller_xmit_window;
+  if (window == 0) return false;
+
+  uint16_t reserved = 0;
+  tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
+  for (uint16_t yy = 0; yy < MAX_L2CAP_LINKS; yy++, p_lcb++) {
+    if (!p_lcb->in_use || p_lcb == p_requester) continue;
+    if ((p_lcb->transport == BT_TRANSPORT_LE) != is_le) continue;
+    if (p_lcb->link_xmit_quota != 0 &&
+        p_lcb->sent_not_acked < p_lcb->link_xmit_quota)
+      reserved++;
+  }
+  if (window <= reserved) return false;
+
+  p_requester->credit_loan++;
+  LOG_DEBUG("Loaned 1 credit to 0x%04x, loan=%d window=%d reserved=%d",
+            p_requester->Handle(), p_requester->credit_loan, window, reserved);
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         l2c_link_hci_conn_req
@@ -686,6 +822,9 @@ void l2c_link_adjust_allocation(void) {
         }
       }
 
+      /* A re-division invalidates any outstanding shared-pool loans */
+      p_lcb->credit_loan = 0;
+
       LOG_DEBUG(
           "l2c_link_adjust_allocation LCB %d   Priority: %d  XmitQuota: %d", yy,
           p_lcb->acl_priority, p_lcb->link_xmit_quota);
@@ -723,8 +862,8 @@ void l2c_link_adjust_allocation(void) {
  ******************************************************************************/
 void l2c_link_adjust_chnl_allocation(void) {
   /* assign buffer quota to each channel based on its data rate requirement */
-  for (uint8_t xx = 0; xx < MAX_L2CAP_CHANNELS; xx++) {
-    tL2C_CCB* p_ccb = l2cb.ccb_pool + xx;
+  for (uint16_t xx = 0; xx < l2cb.num_ccbs; xx++) {
+    tL2C_CCB* p_ccb = l2cu_get_ccb_by_index(xx);
 
     if (!p_ccb->in_use) continue;
 
@@ -856,6 +995,68 @@ static bool l2c_link_check_power_mode(tL2C_LCB* p_lcb) {
   return false;
 }
 
+/*******************************************************************************
+ *
+ * Function         l2c_link_sniff_batch_timeout
+ *
+ * Description      Release channel data that was held while the link slept
+ *                  in sniff mode.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void l2c_link_sniff_batch_timeout(void* data) {
+  tL2C_LCB* p_lcb = (tL2C_LCB*)data;
+
+  p_lcb->sniff_batch_draining = true;
+  l2c_link_check_send_pkts(p_lcb, 0, NULL);
+  p_lcb->sniff_batch_draining = false;
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_link_defer_for_sniff
+ *
+ * Description      Check if pending channel data should be held so that it
+ *                  goes out in one batch per sniff interval instead of one
+ *                  wakeup per packet. Only background (low priority) channel
+ *                  traffic is ever held, and only while the link is actually
+ *                  in sniff mode; anything urgent flushes immediately.
+ *
+ * Returns          true if transmission was deferred to the batch timer.
+ *
+ ******************************************************************************/
+static bool l2c_link_defer_for_sniff(tL2C_LCB* p_lcb) {
+  if (p_lcb->is_transport_ble() || p_lcb->sniff_batch_draining) return false;
+
+  /* anything on the link queue (signaling, segments) is urgent */
+  if (!list_is_empty(p_lcb->link_xmit_data_q)) return false;
+
+  bool have_data = false;
+  for (tL2C_CCB* p_ccb = p_lcb->ccb_queue.p_first_ccb; p_ccb;
+       p_ccb = p_ccb->p_next_ccb) {
+    if (!fixed_queue_is_empty(p_ccb->xmit_hold_q)) {
+      if (p_ccb->ccb_priority != L2CAP_CHNL_PRIORITY_LOW) return false;
+      have_data = true;
+    }
+  }
+  if (!have_data) return false;
+
+  uint16_t sniff_interval = BTM_GetSniffInterval(p_lcb->remote_bd_addr);
+  if (sniff_interval == 0) return false;
+
+  if (!alarm_is_scheduled(p_lcb->sniff_batch_timer)) {
+    /* one sniff interval in milliseconds (0.625 ms per slot), bounded so
+     * deep subrating cannot stall background traffic noticeably */
+    uint64_t hold_ms = ((uint64_t)sniff_interval * 5) / 8;
+    if (hold_ms < L2CAP_SNIFF_BATCH_MIN_MS) hold_ms = L2CAP_SNIFF_BATCH_MIN_MS;
+    if (hold_ms > L2CAP_SNIFF_BATCH_MAX_MS) hold_ms = L2CAP_SNIFF_BATCH_MAX_MS;
+    alarm_set_on_mloop(p_lcb->sniff_batch_timer, hold_ms,
+                       l2c_link_sniff_batch_timeout, p_lcb);
+  }
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         l2c_link_check_send_pkts
@@ -980,12 +1181,20 @@ void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
         l2cb.controller_le_xmit_window, p_lcb->sent_not_acked,
         p_lcb->link_xmit_quota);
 
+    /* If the static quota is used up but data is still queued, try a
+     * demand-driven loan of idle credits from the shared pool */
+    if ((p_lcb->link_xmit_quota != 0) &&
+        (p_lcb->sent_not_acked >= p_lcb->effective_xmit_quota()) &&
+        (!list_is_empty(p_lcb->link_xmit_data_q))) {
+      l2c_link_try_borrow_credit(p_lcb);
+    }
+
     /* See if we can send anything from the link queue */
     while (((l2cb.controller_xmit_window != 0 &&
              (p_lcb->transport == BT_TRANSPORT_BR_EDR)) ||
             (l2cb.controller_le_xmit_window != 0 &&
              (p_lcb->transport == BT_TRANSPORT_LE))) &&
-           (p_lcb->sent_not_acked < p_lcb->link_xmit_quota)) {
+           (p_lcb->sent_not_acked < p_lcb->effective_xmit_quota())) {
       if (list_is_empty(p_lcb->link_xmit_data_q)) {
         LOG_DEBUG("No transmit data, skipping");
         break;
@@ -999,11 +1208,15 @@ void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
     if (!single_write) {
       /* See if we can send anything for any channel */
       LOG_DEBUG("Trying to send other data when single_write is false");
+      if (l2c_link_defer_for_sniff(p_lcb)) {
+        LOG_DEBUG("Holding background data for sniff batch");
+        return;
+      }
       while (((l2cb.controller_xmit_window != 0 &&
                (p_lcb->transport == BT_TRANSPORT_BR_EDR)) ||
               (l2cb.controller_le_xmit_window != 0 &&
                (p_lcb->transport == BT_TRANSPORT_LE))) &&
-             (p_lcb->sent_not_acked < p_lcb->link_xmit_quota)) {
+             (p_lcb->sent_not_acked < p_lcb->effective_xmit_quota())) {
         p_buf = l2cu_get_next_buffer_to_send(p_lcb);
         if (p_buf == NULL) {
           LOG_DEBUG("No next buffer, skipping");
@@ -1018,10 +1231,13 @@ void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
     /* this link may have sent anything but some other link sent packets so  */
     /* so we may need a timer to kick off this link's transmissions.         */
     if ((!list_is_empty(p_lcb->link_xmit_data_q)) &&
-        (p_lcb->sent_not_acked < p_lcb->link_xmit_quota)) {
+        (p_lcb->sent_not_acked < p_lcb->effective_xmit_quota())) {
       alarm_set_on_mloop(p_lcb->l2c_lcb_timer,
                          L2CAP_LINK_FLOW_CONTROL_TIMEOUT_MS,
                          l2c_lcb_timer_timeout, p_lcb);
+    } else if (!list_is_empty(p_lcb->link_xmit_data_q)) {
+      /* Data is queued but every credit is in flight; measure the stall */
+      l2c_link_credit_wait_start(p_lcb);
     }
   }
 }
@@ -1062,6 +1278,7 @@ static void l2c_link_send_to_lower_br_edr(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
     p_lcb->sent_not_acked++;
     p_buf->layer_specific = 0;
     l2cb.controller_xmit_window--;
+    l2c_link_tx_lat_record(p_lcb, 1);
   } else {
     uint16_t num_segs =
         (p_buf->len - HCI_DATA_PREAMBLE_SIZE + acl_data_size_classic - 1) /
@@ -1078,8 +1295,8 @@ static void l2c_link_send_to_lower_br_edr(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
         p_lcb->partial_segment_being_sent = true;
       }
 
-      if (num_segs > (p_lcb->link_xmit_quota - p_lcb->sent_not_acked)) {
-        num_segs = (p_lcb->link_xmit_quota - p_lcb->sent_not_acked);
+      if (num_segs > (p_lcb->effective_xmit_quota() - p_lcb->sent_not_acked)) {
+        num_segs = (p_lcb->effective_xmit_quota() - p_lcb->sent_not_acked);
         p_lcb->partial_segment_being_sent = true;
       }
     }
@@ -1087,6 +1304,7 @@ static void l2c_link_send_to_lower_br_edr(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
     p_lcb->sent_not_acked += num_segs;
     p_buf->layer_specific = num_segs;
     l2cb.controller_xmit_window -= num_segs;
+    l2c_link_tx_lat_record(p_lcb, num_segs);
     if (p_lcb->link_xmit_quota == 0) l2cb.round_robin_unacked += num_segs;
   }
   acl_send_data_packet_br_edr(p_lcb->remote_bd_addr, p_buf);
@@ -1097,6 +1315,9 @@ static void l2c_link_send_to_lower_br_edr(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
 }
 
 static void l2c_link_send_to_lower_ble(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
+  /* Feed the LE connection parameter auto-tuner, when opted in */
+  if (p_lcb->conn_tune.enabled) p_lcb->conn_tune.bytes += p_buf->len;
+
   const uint16_t acl_packet_size_ble =
       controller_get_interface()->get_acl_packet_size_ble();
   const uint16_t acl_data_size_ble =
@@ -1111,6 +1332,7 @@ static void l2c_link_send_to_lower_ble(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
     p_lcb->sent_not_acked++;
     p_buf->layer_specific = 0;
     l2cb.controller_le_xmit_window--;
+    l2c_link_tx_lat_record(p_lcb, 1);
   } else {
     uint16_t num_segs =
         (p_buf->len - HCI_DATA_PREAMBLE_SIZE + acl_data_size_ble - 1) /
@@ -1127,8 +1349,8 @@ static void l2c_link_send_to_lower_ble(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
         p_lcb->partial_segment_being_sent = true;
       }
 
-      if (num_segs > (p_lcb->link_xmit_quota - p_lcb->sent_not_acked)) {
-        num_segs = (p_lcb->link_xmit_quota - p_lcb->sent_not_acked);
+      if (num_segs > (p_lcb->effective_xmit_quota() - p_lcb->sent_not_acked)) {
+        num_segs = (p_lcb->effective_xmit_quota() - p_lcb->sent_not_acked);
         p_lcb->partial_segment_being_sent = true;
       }
     }
@@ -1136,6 +1358,7 @@ static void l2c_link_send_to_lower_ble(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
     p_lcb->sent_not_acked += num_segs;
     p_buf->layer_specific = num_segs;
     l2cb.controller_le_xmit_window -= num_segs;
+    l2c_link_tx_lat_record(p_lcb, num_segs);
     if (p_lcb->link_xmit_quota == 0) l2cb.ble_round_robin_unacked += num_segs;
   }
   acl_send_data_packet_ble(p_lcb->remote_bd_addr, p_buf);
@@ -1146,6 +1369,7 @@ static void l2c_link_send_to_lower_ble(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
 }
 
 static void l2c_link_send_to_lower(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
+  l2c_link_credit_wait_end(p_lcb);
   if (p_lcb->transport == BT_TRANSPORT_BR_EDR) {
     l2c_link_send_to_lower_br_edr(p_lcb, p_buf);
   } else {
@@ -1193,6 +1417,7 @@ void l2c_link_process_num_completed_pkts(uint8_t* p, uint8_t evt_len) {
     p_lcb = l2cu_find_lcb_by_handle(handle);
 
     if (p_lcb) {
+      l2c_link_tx_lat_complete(p_lcb, num_sent);
       if (p_lcb && (p_lcb->transport == BT_TRANSPORT_LE))
         l2cb.controller_le_xmit_window += num_sent;
       else {
@@ -1222,6 +1447,13 @@ void l2c_link_process_num_completed_pkts(uint8_t* p, uint8_t evt_len) {
       else
         p_lcb->sent_not_acked = 0;
 
+      /* Loans are repaid ahead of the guaranteed share so the link falls
+       * back to its static allocation once the burst drains */
+      if (p_lcb->credit_loan > num_sent)
+        p_lcb->credit_loan -= num_sent;
+      else
+        p_lcb->credit_loan = 0;
+
       l2c_link_check_send_pkts(p_lcb, 0, NULL);
 
       /* If we were doing round-robin for low priority links, check 'em */
@@ -1424,6 +1656,9 @@ tL2C_CCB* l2cu_get_next_channel_in_rr(tL2C_LCB* p_lcb) {
 
       if (p_ccb->chnl_state != CST_OPEN) continue;
 
+      /* honor the channel's token bucket if one is configured */
+      if ((p_ccb->tx_token_quota != 0) && (p_ccb->tx_tokens == 0)) continue;
+
       if (p_ccb->p_lcb->transport == BT_TRANSPORT_LE) {
         LOG_DEBUG("Connection oriented channel");
         if (fixed_queue_is_empty(p_ccb->xmit_hold_q)) continue;
@@ -1448,8 +1683,9 @@ tL2C_CCB* l2cu_get_next_channel_in_rr(tL2C_LCB* p_lcb) {
 
       /* found a channel to serve */
       p_serve_ccb = p_ccb;
-      /* decrease quota of its priority group */
+      /* decrease quota of its priority group and the channel's tokens */
       p_lcb->rr_serv[p_lcb->rr_pri].quota--;
+      if (p_serve_ccb->tx_token_quota != 0) p_serve_ccb->tx_tokens--;
     }
 
     /* if there is no more quota of the priority group or no channel to have
@@ -1460,6 +1696,12 @@ tL2C_CCB* l2cu_get_next_channel_in_rr(tL2C_LCB* p_lcb) {
       /* initialize its quota */
       p_lcb->rr_serv[p_lcb->rr_pri].quota =
           L2CAP_GET_PRIORITY_QUOTA(p_lcb->rr_pri);
+      /* refill the token buckets of the channels in the group */
+      for (p_ccb = p_lcb->rr_serv[p_lcb->rr_pri].p_first_ccb;
+           (p_ccb != NULL) &&
+           (p_ccb->ccb_priority == (tL2CAP_CHNL_PRIORITY)p_lcb->rr_pri);
+           p_ccb = p_ccb->p_next_ccb)
+        p_ccb->tx_tokens = p_ccb->tx_token_quota;
     }
   }
 
@@ -34,8 +34,11 @@
 #include "l2c_int.h"
 #include "l2cdefs.h"
 #include "main/shim/shim.h"
+#include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
+#include "osi/include/tracepoint.h"
 
 /******************************************************************************/
 /*            L O C A L    F U N C T I O N     P R O T O T Y P E S            */
@@ -66,6 +69,8 @@ void l2c_rcv_acl_data(BT_HDR* p_msg) {
   uint8_t pkt_type = HCID_GET_EVENT(handle);
   handle = HCID_GET_HANDLE(handle);
 
+  TRACEPOINT(TRACE_L2C_RX, handle, p_msg->len);
+
   /* Since the HCI Transport is putting segmented packets back together, we */
   /* should never get a valid packet with the type set to "continuation"    */
   if (pkt_type == L2CAP_PKT_CONTINUE) {
@@ -145,6 +150,9 @@ void l2c_rcv_acl_data(BT_HDR* p_msg) {
     l2cble_notify_le_connection(p_lcb->remote_bd_addr);
   }
 
+  /* Feed the LE connection parameter auto-tuner, when opted in */
+  if (p_lcb && p_lcb->conn_tune.enabled) p_lcb->conn_tune.bytes += p_msg->len;
+
   /* Find the CCB for this CID */
   tL2C_CCB* p_ccb = NULL;
   if (rcv_cid >= L2CAP_BASE_APPL_CID) {
@@ -220,10 +228,19 @@ void l2c_rcv_acl_data(BT_HDR* p_msg) {
     /* The remote device has one less credit left */
     --p_ccb->remote_credit_count;
 
-    /* If the credits left on the remote device are getting low, send some */
-    if (p_ccb->remote_credit_count <= L2CAP_LE_CREDIT_THRESHOLD) {
-      uint16_t credits = L2CAP_LE_CREDIT_DEFAULT - p_ccb->remote_credit_count;
-      p_ccb->remote_credit_count = L2CAP_LE_CREDIT_DEFAULT;
+    uint16_t init_credit = p_ccb->local_conn_cfg.credits
+                               ? p_ccb->local_conn_cfg.credits
+                               : L2CAP_LE_CREDIT_DEFAULT;
+
+    /* Once the remote has consumed a set fraction of its initial grant, top
+     * it back up to the grant with a single signaling PDU. The old absolute
+     * threshold fired on nearly every SDU when the grant was small, and the
+     * old refill target silently widened app-configured receive windows to
+     * the default grant. */
+    if (p_ccb->remote_credit_count <=
+        init_credit - init_credit / L2CAP_LE_CREDIT_REPLENISH_FRACTION) {
+      uint16_t credits = init_credit - p_ccb->remote_credit_count;
+      p_ccb->remote_credit_count = init_credit;
 
       /* Return back credits */
       l2c_csm_execute(p_ccb, L2CEVT_L2CA_SEND_FLOW_CONTROL_CREDIT, &credits);
@@ -409,7 +426,7 @@ static void process_l2cap_cmd(tL2C_LCB* p_lcb, uint8_t* p, uint16_t pkt_len) {
         }
         p_ccb->remote_id = id;
         p_ccb->p_rcb = p_rcb;
-        p_ccb->remote_cid = rcid;
+        l2cu_set_remote_cid(p_ccb, rcid);
         p_ccb->connection_initiator = L2CAP_INITIATOR_REMOTE;
 
         if (p_rcb->psm == BT_PSM_RFCOMM) {
@@ -910,24 +927,24 @@ void l2c_init(void) {
     return;
   }
 
-  int16_t xx;
-
   memset(&l2cb, 0, sizeof(tL2C_CB));
 
   /* the LE PSM is increased by 1 before being used */
   l2cb.le_dyn_psm = LE_DYNAMIC_PSM_START - 1;
 
-  /* Put all the channel control blocks on the free queue */
-  for (xx = 0; xx < MAX_L2CAP_CHANNELS - 1; xx++) {
-    l2cb.ccb_pool[xx].p_next_ccb = &l2cb.ccb_pool[xx + 1];
-  }
+  /* Size the CCB pool from config so one binary covers both small-RAM and
+   * many-channel profiles; the pool grows a slab at a time if the initial
+   * size is exhausted (see l2cu_grow_ccb_pool) */
+  int32_t num_channels = osi_property_get_int32(
+      "bluetooth.l2cap.num_channels", MAX_L2CAP_CHANNELS);
+  if (num_channels < 4) num_channels = 4;
+  if (num_channels > 512) num_channels = 512;
+  l2cb.ccb_slab_size = (uint16_t)num_channels;
+  l2cu_grow_ccb_pool();
 
   /* it will be set to L2CAP_PKT_START_NON_FLUSHABLE if controller supports */
   l2cb.non_flushable_pbf = L2CAP_PKT_START << L2CAP_PKT_TYPE_SHIFT;
 
-  l2cb.p_free_ccb_first = &l2cb.ccb_pool[0];
-  l2cb.p_free_ccb_last = &l2cb.ccb_pool[MAX_L2CAP_CHANNELS - 1];
-
   /* Set the default idle timeout */
   l2cb.idle_timeout = L2CAP_LINK_INACTIVITY_TOUT;
 
@@ -962,6 +979,16 @@ void l2c_free(void) {
 
   list_free(l2cb.rcv_pending_q);
   l2cb.rcv_pending_q = NULL;
+
+  for (uint16_t xx = 0; xx < l2cb.num_ccb_slabs; xx++) {
+    osi_free(l2cb.ccb_slabs[xx]);
+    l2cb.ccb_slabs[xx] = NULL;
+  }
+  l2cb.num_ccb_slabs = 0;
+  l2cb.num_ccbs = 0;
+  l2cb.num_used_ccbs = 0;
+  l2cb.p_free_ccb_first = NULL;
+  l2cb.p_free_ccb_last = NULL;
 }
 
 void l2c_receive_hold_timer_timeout(UNUSED_ATTR void* data) {
@@ -62,6 +62,8 @@ tL2C_LCB* l2cu_allocate_lcb(const RawAddress& p_bd_addr, bool is_bonding,
     if (!p_lcb->in_use) {
       alarm_free(p_lcb->l2c_lcb_timer);
       alarm_free(p_lcb->info_resp_timer);
+      alarm_free(p_lcb->sniff_batch_timer);
+      alarm_free(p_lcb->conn_tune.timer);
       memset(p_lcb, 0, sizeof(tL2C_LCB));
 
       p_lcb->remote_bd_addr = p_bd_addr;
@@ -71,6 +73,8 @@ tL2C_LCB* l2cu_allocate_lcb(const RawAddress& p_bd_addr, bool is_bonding,
       p_lcb->InvalidateHandle();
       p_lcb->l2c_lcb_timer = alarm_new("l2c_lcb.l2c_lcb_timer");
       p_lcb->info_resp_timer = alarm_new("l2c_lcb.info_resp_timer");
+      p_lcb->sniff_batch_timer = alarm_new("l2c_lcb.sniff_batch_timer");
+      p_lcb->conn_tune.timer = alarm_new("l2c_lcb.conn_tune_timer");
       p_lcb->idle_timeout = l2cb.idle_timeout;
       p_lcb->signal_id = 1; /* spec does not allow '0' */
       if (is_bonding) {
@@ -157,6 +161,10 @@ void l2cu_release_lcb(tL2C_LCB* p_lcb) {
   p_lcb->l2c_lcb_timer = NULL;
   alarm_free(p_lcb->info_resp_timer);
   p_lcb->info_resp_timer = NULL;
+  alarm_free(p_lcb->sniff_batch_timer);
+  p_lcb->sniff_batch_timer = NULL;
+  alarm_free(p_lcb->conn_tune.timer);
+  p_lcb->conn_tune.timer = NULL;
 
   if (p_lcb->transport == BT_TRANSPORT_BR_EDR) /* Release all SCO links */
     BTM_RemoveSco(p_lcb->remote_bd_addr);
@@ -1337,6 +1345,85 @@ void l2cu_change_pri_ccb(tL2C_CCB* p_ccb, tL2CAP_CHNL_PRIORITY priority) {
   }
 }
 
+/* Insert |p_ccb| into the remote CID hash of its link. The CCB must be
+ * attached to a link and have a non-zero remote CID. */
+static void l2cu_rcid_hash_insert(tL2C_CCB* p_ccb) {
+  tL2C_CCB** p_bucket =
+      &p_ccb->p_lcb->rcid_hash[p_ccb->remote_cid & (L2CAP_RCID_HASH_SIZE - 1)];
+  p_ccb->p_rcid_hash_next = *p_bucket;
+  *p_bucket = p_ccb;
+}
+
+/* Remove |p_ccb| from the remote CID hash of its link, if present. */
+static void l2cu_rcid_hash_remove(tL2C_CCB* p_ccb) {
+  tL2C_CCB** p_link =
+      &p_ccb->p_lcb->rcid_hash[p_ccb->remote_cid & (L2CAP_RCID_HASH_SIZE - 1)];
+  for (; *p_link != nullptr; p_link = &(*p_link)->p_rcid_hash_next) {
+    if (*p_link == p_ccb) {
+      *p_link = p_ccb->p_rcid_hash_next;
+      break;
+    }
+  }
+  p_ccb->p_rcid_hash_next = nullptr;
+}
+
+/*******************************************************************************
+ *
+ * Function         l2cu_get_ccb_by_index
+ *
+ * Description      Map a pool index (local CID minus L2CAP_BASE_APPL_CID)
+ *                  to the CCB backing it.
+ *
+ * Returns          pointer to CCB, or NULL if the index is out of range
+ *
+ ******************************************************************************/
+tL2C_CCB* l2cu_get_ccb_by_index(uint16_t ccb_index) {
+  if (ccb_index >= l2cb.num_ccbs) return NULL;
+  return &l2cb.ccb_slabs[ccb_index / l2cb.ccb_slab_size]
+                        [ccb_index % l2cb.ccb_slab_size];
+}
+
+/*******************************************************************************
+ *
+ * Function         l2cu_grow_ccb_pool
+ *
+ * Description      Add a slab of CCBs to the pool and chain them onto the
+ *                  free list. Called at init for the first slab and again
+ *                  when an allocation finds the free list empty. Existing
+ *                  CCBs never move, so live channel pointers stay valid.
+ *
+ * Returns          true if the pool grew, false if it is at its cap
+ *
+ ******************************************************************************/
+bool l2cu_grow_ccb_pool(void) {
+  if (l2cb.num_ccb_slabs >= L2CAP_MAX_CCB_SLABS) {
+    L2CAP_TRACE_WARNING("%s: CCB pool is at its cap of %u channels", __func__,
+                        l2cb.num_ccbs);
+    return false;
+  }
+
+  tL2C_CCB* p_slab =
+      (tL2C_CCB*)osi_calloc(sizeof(tL2C_CCB) * l2cb.ccb_slab_size);
+  l2cb.ccb_slabs[l2cb.num_ccb_slabs++] = p_slab;
+
+  for (uint16_t xx = 0; xx < l2cb.ccb_slab_size; xx++) {
+    p_slab[xx].ccb_index = l2cb.num_ccbs + xx;
+    p_slab[xx].p_next_ccb = NULL;
+    if (!l2cb.p_free_ccb_first) {
+      l2cb.p_free_ccb_first = &p_slab[xx];
+    } else {
+      l2cb.p_free_ccb_last->p_next_ccb = &p_slab[xx];
+    }
+    l2cb.p_free_ccb_last = &p_slab[xx];
+  }
+  l2cb.num_ccbs += l2cb.ccb_slab_size;
+
+  if (l2cb.num_ccb_slabs > 1)
+    L2CAP_TRACE_WARNING("%s: CCB pool grown to %u channels", __func__,
+                        l2cb.num_ccbs);
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         l2cu_allocate_ccb
@@ -1350,7 +1437,7 @@ void l2cu_change_pri_ccb(tL2C_CCB* p_ccb, tL2CAP_CHNL_PRIORITY priority) {
  ******************************************************************************/
 tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid) {
   LOG_DEBUG("cid 0x%04x", cid);
-  if (!l2cb.p_free_ccb_first) {
+  if (!l2cb.p_free_ccb_first && !l2cu_grow_ccb_pool()) {
     LOG_ERROR("First free ccb is null for cid 0x%04x", cid);
     return nullptr;
   }
@@ -1362,7 +1449,11 @@ tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid) {
   } else {
     tL2C_CCB* p_prev = nullptr;
 
-    p_ccb = &l2cb.ccb_pool[cid - L2CAP_BASE_APPL_CID];
+    p_ccb = l2cu_get_ccb_by_index(cid - L2CAP_BASE_APPL_CID);
+    if (p_ccb == nullptr) {
+      LOG_ERROR("No CCB backs CID 0x%04x", cid);
+      return nullptr;
+    }
 
     if (p_ccb == l2cb.p_free_ccb_first) {
       l2cb.p_free_ccb_first = p_ccb->p_next_ccb;
@@ -1387,17 +1478,24 @@ tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid) {
   }
 
   p_ccb->p_next_ccb = p_ccb->p_prev_ccb = nullptr;
+  p_ccb->p_rcid_hash_next = nullptr;
 
   p_ccb->in_use = true;
 
+  l2cb.num_used_ccbs++;
+  if (l2cb.num_used_ccbs > l2cb.max_used_ccbs)
+    l2cb.max_used_ccbs = l2cb.num_used_ccbs;
+
   /* Get a CID for the connection */
-  p_ccb->local_cid = L2CAP_BASE_APPL_CID + (uint16_t)(p_ccb - l2cb.ccb_pool);
+  p_ccb->local_cid = L2CAP_BASE_APPL_CID + p_ccb->ccb_index;
 
   p_ccb->p_lcb = p_lcb;
   p_ccb->p_rcb = nullptr;
 
   /* Set priority then insert ccb into LCB queue (if we have an LCB) */
   p_ccb->ccb_priority = L2CAP_CHNL_PRIORITY_LOW;
+  p_ccb->tx_token_quota = 0; /* No per-channel cap until configured */
+  p_ccb->tx_tokens = 0;
 
   if (p_lcb) l2cu_enqueue_ccb(p_ccb);
 
@@ -1449,6 +1547,7 @@ tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid) {
   /* If CCB was reserved Config_Done can already have some value */
   if (cid == 0) {
     p_ccb->config_done = 0;
+    p_ccb->remote_cid = 0; /* Not assigned yet; not in the remote CID hash */
   } else {
     LOG_DEBUG("cid 0x%04x config_done:0x%x", cid, p_ccb->config_done);
   }
@@ -1552,6 +1651,9 @@ void l2cu_release_ccb(tL2C_CCB* p_ccb) {
 
   l2c_fcr_cleanup(p_ccb);
 
+  /* Unhook from the remote CID hash before the CCB leaves the link */
+  if ((p_lcb) && (p_ccb->remote_cid != 0)) l2cu_rcid_hash_remove(p_ccb);
+
   /* Channel may not be assigned to any LCB if it was just pre-reserved */
   if ((p_lcb) && ((p_ccb->local_cid >= L2CAP_BASE_APPL_CID))) {
     l2cu_dequeue_ccb(p_ccb);
@@ -1575,6 +1677,7 @@ void l2cu_release_ccb(tL2C_CCB* p_ccb) {
 
   /* Flag as not in use */
   p_ccb->in_use = false;
+  if (l2cb.num_used_ccbs > 0) l2cb.num_used_ccbs--;
 
   /* If no channels on the connection, start idle timeout */
   if ((p_lcb) && p_lcb->in_use) {
@@ -1620,7 +1723,8 @@ tL2C_CCB* l2cu_find_ccb_by_remote_cid(tL2C_LCB* p_lcb, uint16_t remote_cid) {
   if (!p_lcb) {
     return NULL;
   } else {
-    for (p_ccb = p_lcb->ccb_queue.p_first_ccb; p_ccb; p_ccb = p_ccb->p_next_ccb)
+    for (p_ccb = p_lcb->rcid_hash[remote_cid & (L2CAP_RCID_HASH_SIZE - 1)];
+         p_ccb; p_ccb = p_ccb->p_rcid_hash_next)
       if ((p_ccb->in_use) && (p_ccb->remote_cid == remote_cid)) return (p_ccb);
   }
 
@@ -1628,6 +1732,29 @@ tL2C_CCB* l2cu_find_ccb_by_remote_cid(tL2C_LCB* p_lcb, uint16_t remote_cid) {
   return (NULL);
 }
 
+/*******************************************************************************
+ *
+ * Function         l2cu_set_remote_cid
+ *
+ * Description      Assign the remote CID of a CCB and keep the per-link
+ *                  remote CID hash in sync. Must be used for all remote CID
+ *                  updates of a CCB that is (or may get) attached to a link.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void l2cu_set_remote_cid(tL2C_CCB* p_ccb, uint16_t remote_cid) {
+  if (p_ccb->remote_cid == remote_cid) return;
+
+  if (p_ccb->p_lcb != nullptr) {
+    if (p_ccb->remote_cid != 0) l2cu_rcid_hash_remove(p_ccb);
+    p_ccb->remote_cid = remote_cid;
+    if (remote_cid != 0) l2cu_rcid_hash_insert(p_ccb);
+  } else {
+    p_ccb->remote_cid = remote_cid;
+  }
+}
+
 /*******************************************************************************
  *
  * Function         l2cu_allocate_rcb
@@ -2422,7 +2549,7 @@ bool l2cu_initialize_fixed_ccb(tL2C_LCB* p_lcb, uint16_t fixed_cid) {
 
   /* Set CID for the connection */
   p_ccb->local_cid = fixed_cid;
-  p_ccb->remote_cid = fixed_cid;
+  l2cu_set_remote_cid(p_ccb, fixed_cid);
 
   p_ccb->is_flushable = false;
 
@@ -3146,9 +3273,8 @@ tL2C_CCB* l2cu_find_ccb_by_cid(tL2C_LCB* p_lcb, uint16_t local_cid) {
     /* find the associated CCB by "index" */
     local_cid -= L2CAP_BASE_APPL_CID;
 
-    if (local_cid >= MAX_L2CAP_CHANNELS) return NULL;
-
-    p_ccb = l2cb.ccb_pool + local_cid;
+    p_ccb = l2cu_get_ccb_by_index(local_cid);
+    if (p_ccb == NULL) return NULL;
 
     /* make sure the CCB is in use */
     if (!p_ccb->in_use) {
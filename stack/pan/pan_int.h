@@ -116,6 +116,7 @@ extern tPAN_CONN* pan_get_pcb_by_handle(uint16_t handle);
 extern tPAN_CONN* pan_get_pcb_by_addr(const RawAddress& p_bda);
 extern void pan_close_all_connections(void);
 extern void pan_release_pcb(tPAN_CONN* p_pcb);
+extern void pan_flow_cache_flush(void);
 extern void pan_dump_status(void);
 
 /******************************************************************************/
@@ -40,6 +40,74 @@ using bluetooth::Uuid;
 
 tPAN_CB pan_cb;
 
+/* Forwarding decisions learned from the first packet of each
+ * (src, dst, protocol) flow, so repeat frames skip the broadcast and
+ * bridge classification and go straight to the right sink. The cache is
+ * direct mapped and flushed whenever any PAN connection changes state. */
+#define PAN_FLOW_CACHE_SIZE 16
+
+#define PAN_FLOW_ACTION_NONE 0   /* empty entry */
+#define PAN_FLOW_ACTION_HOST 1   /* deliver to the local host stack */
+#define PAN_FLOW_ACTION_BRIDGE 2 /* relay to another PAN connection */
+
+typedef struct {
+  uint8_t action;
+  uint16_t handle;     /* connection the flow arrives on */
+  uint16_t dst_handle; /* relay destination for PAN_FLOW_ACTION_BRIDGE */
+  uint16_t protocol;
+  RawAddress src;
+  RawAddress dst;
+} tPAN_FLOW;
+
+static tPAN_FLOW pan_flow_cache[PAN_FLOW_CACHE_SIZE];
+
+static uint8_t pan_flow_hash(const RawAddress& src, const RawAddress& dst,
+                             uint16_t protocol) {
+  return (src.address[5] ^ dst.address[5] ^ (uint8_t)protocol) &
+         (PAN_FLOW_CACHE_SIZE - 1);
+}
+
+static tPAN_FLOW* pan_flow_cache_find(uint16_t handle, const RawAddress& src,
+                                      const RawAddress& dst,
+                                      uint16_t protocol) {
+  tPAN_FLOW* p_flow = &pan_flow_cache[pan_flow_hash(src, dst, protocol)];
+  if (p_flow->action == PAN_FLOW_ACTION_NONE || p_flow->handle != handle ||
+      p_flow->protocol != protocol || p_flow->src != src ||
+      p_flow->dst != dst) {
+    return NULL;
+  }
+  return p_flow;
+}
+
+static void pan_flow_cache_learn(uint16_t handle, const RawAddress& src,
+                                 const RawAddress& dst, uint16_t protocol,
+                                 uint8_t action, uint16_t dst_handle) {
+  tPAN_FLOW* p_flow = &pan_flow_cache[pan_flow_hash(src, dst, protocol)];
+  p_flow->action = action;
+  p_flow->handle = handle;
+  p_flow->dst_handle = dst_handle;
+  p_flow->protocol = protocol;
+  p_flow->src = src;
+  p_flow->dst = dst;
+}
+
+/*******************************************************************************
+ *
+ * Function         pan_flow_cache_flush
+ *
+ * Description      Drop all learned flow forwarding decisions. Called
+ *                  whenever a PAN connection changes state, since both the
+ *                  bridge destinations and the host delivery verdicts may
+ *                  no longer hold.
+ *
+ * Returns          none
+ *
+ ******************************************************************************/
+void pan_flow_cache_flush(void) {
+  for (int i = 0; i < PAN_FLOW_CACHE_SIZE; i++)
+    pan_flow_cache[i].action = PAN_FLOW_ACTION_NONE;
+}
+
 /*******************************************************************************
  *
  * Function         pan_register_with_bnep
@@ -305,6 +373,7 @@ void pan_connect_state_cb(uint16_t handle,
       /* restore the original values */
       PAN_TRACE_EVENT("restoring the connection state to active");
       pcb->con_state = PAN_STATE_CONNECTED;
+      pan_flow_cache_flush();
       pcb->con_flags &= (~PAN_FLAGS_CONN_COMPLETED);
 
       pcb->src_uuid = pcb->prv_src_uuid;
@@ -340,6 +409,7 @@ void pan_connect_state_cb(uint16_t handle,
     peer_role = PAN_ROLE_NAP_SERVER;
 
   pcb->con_state = PAN_STATE_CONNECTED;
+  pan_flow_cache_flush();
 
   /* Inform the application that connection is down */
   if (pan_cb.pan_conn_state_cb)
@@ -409,8 +479,20 @@ void pan_data_buf_ind_cb(uint16_t handle, const RawAddress& src,
   else
     forward = false;
 
+  /* Repeat frames of an already classified flow take the fast path */
+  tPAN_FLOW* p_flow = pan_flow_cache_find(handle, src, dst, protocol);
+  if (p_flow != NULL && p_flow->action == PAN_FLOW_ACTION_BRIDGE) {
+    result =
+        BNEP_Write(p_flow->dst_handle, dst, p_data, len, protocol, &src, ext);
+    if (result != BNEP_SUCCESS && result != BNEP_IGNORE_CMD)
+      PAN_TRACE_ERROR("Failed to write data for PAN connection handle %d",
+                      p_flow->dst_handle);
+    osi_free(p_buf);
+    return;
+  }
+
   /* Check if it is broadcast or multicast packet */
-  if (pcb->src_uuid != UUID_SERVCLASS_PANU) {
+  if (p_flow == NULL && pcb->src_uuid != UUID_SERVCLASS_PANU) {
     if (dst.address[0] & 0x01) {
       PAN_TRACE_DEBUG(
           "PAN received broadcast packet on handle %d, src uuid 0x%x", handle,
@@ -442,6 +524,8 @@ void pan_data_buf_ind_cb(uint16_t handle, const RawAddress& src,
           "%s - destination PANU found on handle %d and sending data, len: %d",
           __func__, dst_pcb->handle, len);
 
+      pan_flow_cache_learn(handle, src, dst, protocol, PAN_FLOW_ACTION_BRIDGE,
+                           dst_pcb->handle);
       result =
           BNEP_Write(dst_pcb->handle, dst, p_data, len, protocol, &src, ext);
       if (result != BNEP_SUCCESS && result != BNEP_IGNORE_CMD)
@@ -450,6 +534,9 @@ void pan_data_buf_ind_cb(uint16_t handle, const RawAddress& src,
       osi_free(p_buf);
       return;
     }
+
+    /* No local bridge destination: repeat frames go to the host directly */
+    pan_flow_cache_learn(handle, src, dst, protocol, PAN_FLOW_ACTION_HOST, 0);
   }
 
   /* Send it over the LAN or give it to host software */
@@ -254,6 +254,7 @@ void pan_release_pcb(tPAN_CONN* p_pcb) {
   /* Drop any response pointer we may be holding */
   memset(p_pcb, 0, sizeof(tPAN_CONN));
   p_pcb->con_state = PAN_STATE_IDLE;
+  pan_flow_cache_flush();
 }
 
 /*******************************************************************************
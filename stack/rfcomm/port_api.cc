@@ -942,8 +942,9 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
     }
 
     /* continue with rfcomm data write */
-    p_buf = (BT_HDR*)osi_malloc(RFCOMM_DATA_BUF_SIZE);
-    p_buf->offset = L2CAP_MIN_OFFSET + RFCOMM_MIN_OFFSET;
+    p_buf = L2CA_AllocTxBuffer(
+        p_port->rfc.p_mcb ? p_port->rfc.p_mcb->lcid : 0, RFCOMM_DATA_BUF_SIZE);
+    p_buf->offset += RFCOMM_MIN_OFFSET;
     p_buf->layer_specific = handle;
 
     if (p_port->peer_mtu < length) length = p_port->peer_mtu;
@@ -1053,6 +1054,26 @@ int PORT_WriteData(uint16_t handle, const char* p_data, uint16_t max_len,
     return (PORT_SUCCESS);
   }
 
+  /* Gather the head of the write into the unfilled tail of the queue so
+   * that already queued frames go out at maximum size */
+  if (p_buf != NULL) {
+    uint16_t frame_max =
+        (p_port->peer_mtu < length) ? p_port->peer_mtu : length;
+    if (p_buf->len < frame_max) {
+      uint16_t gather_len = frame_max - p_buf->len;
+
+      memcpy((uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len, p_data,
+             gather_len);
+      p_port->tx.queue_size += gather_len;
+
+      *p_len = gather_len;
+      p_buf->len += gather_len;
+
+      p_data += gather_len;
+      max_len -= gather_len;
+    }
+  }
+
   mutex_global_unlock();
 
   while (max_len) {
@@ -1062,8 +1083,9 @@ int PORT_WriteData(uint16_t handle, const char* p_data, uint16_t max_len,
       break;
 
     /* continue with rfcomm data write */
-    p_buf = (BT_HDR*)osi_malloc(RFCOMM_DATA_BUF_SIZE);
-    p_buf->offset = L2CAP_MIN_OFFSET + RFCOMM_MIN_OFFSET;
+    p_buf = L2CA_AllocTxBuffer(
+        p_port->rfc.p_mcb ? p_port->rfc.p_mcb->lcid : 0, RFCOMM_DATA_BUF_SIZE);
+    p_buf->offset += RFCOMM_MIN_OFFSET;
     p_buf->layer_specific = handle;
 
     if (p_port->peer_mtu < length) length = p_port->peer_mtu;
@@ -1100,6 +1122,154 @@ int PORT_WriteData(uint16_t handle, const char* p_data, uint16_t max_len,
   return (PORT_SUCCESS);
 }
 
+/*******************************************************************************
+ *
+ * Function         port_gather_vec
+ *
+ * Description      Copies up to max_bytes from a fragment list into p_dest,
+ *                  advancing the caller's fragment cursor.
+ *
+ * Returns          Number of bytes copied
+ *
+ ******************************************************************************/
+static uint16_t port_gather_vec(const tPORT_DATA_VEC* p_vec, uint16_t num_vec,
+                                uint16_t* p_vec_index, uint16_t* p_vec_offset,
+                                uint8_t* p_dest, uint16_t max_bytes) {
+  uint16_t copied = 0;
+
+  while (copied < max_bytes && *p_vec_index < num_vec) {
+    const tPORT_DATA_VEC* p_cur = &p_vec[*p_vec_index];
+    uint16_t chunk = p_cur->len - *p_vec_offset;
+
+    if (chunk > max_bytes - copied) chunk = max_bytes - copied;
+
+    memcpy(p_dest + copied, p_cur->p_data + *p_vec_offset, chunk);
+    copied += chunk;
+    *p_vec_offset += chunk;
+
+    if (*p_vec_offset == p_cur->len) {
+      (*p_vec_index)++;
+      *p_vec_offset = 0;
+    }
+  }
+  return (copied);
+}
+
+/*******************************************************************************
+ *
+ * Function         PORT_WriteDatav
+ *
+ * Description      This function is called to send a list of data fragments.
+ *                  The fragments are gathered into maximum size RFCOMM frames
+ *                  so that throughput is not capped by the application's
+ *                  write granularity.
+ *
+ * Parameters:      handle     - Handle returned in the RFCOMM_CreateConnection
+ *                  p_vec       - Array of data fragments
+ *                  num_vec     - Number of fragments at p_vec
+ *                  p_len       - Bytes written
+ *
+ ******************************************************************************/
+int PORT_WriteDatav(uint16_t handle, const tPORT_DATA_VEC* p_vec,
+                    uint16_t num_vec, uint16_t* p_len) {
+  tPORT* p_port;
+  BT_HDR* p_buf;
+  uint32_t event = 0;
+  uint32_t remaining = 0;
+  int rc = 0;
+  uint16_t length, copied, xx;
+  uint16_t vec_index = 0, vec_offset = 0;
+
+  RFCOMM_TRACE_API("PORT_WriteDatav() num_vec:%d", num_vec);
+
+  *p_len = 0;
+
+  /* Check if handle is valid to avoid crashing */
+  if ((handle == 0) || (handle > MAX_RFC_PORTS)) {
+    return (PORT_BAD_HANDLE);
+  }
+  p_port = &rfc_cb.port.port[handle - 1];
+
+  if (!p_port->in_use || (p_port->state == PORT_STATE_CLOSED)) {
+    RFCOMM_TRACE_WARNING("PORT_WriteDatav() no port state:%d", p_port->state);
+    return (PORT_NOT_OPENED);
+  }
+
+  for (xx = 0; xx < num_vec; xx++) remaining += p_vec[xx].len;
+
+  if (!remaining || !p_port->peer_mtu) {
+    RFCOMM_TRACE_ERROR("PORT_WriteDatav() peer_mtu:%d", p_port->peer_mtu);
+    return (PORT_UNKNOWN_ERROR);
+  }
+
+  /* Length for each buffer is the smaller of GKI buffer and peer MTU */
+  length = RFCOMM_DATA_BUF_SIZE -
+           (uint16_t)(sizeof(BT_HDR) + L2CAP_MIN_OFFSET + RFCOMM_DATA_OVERHEAD);
+  if (p_port->peer_mtu < length) length = p_port->peer_mtu;
+
+  /* Gather the head of the write into the unfilled tail of the queue so
+   * that already queued frames go out at maximum size */
+  mutex_global_lock();
+
+  p_buf = (BT_HDR*)fixed_queue_try_peek_last(p_port->tx.queue);
+  if ((p_buf != NULL) && (p_buf->len < length)) {
+    copied = port_gather_vec(p_vec, num_vec, &vec_index, &vec_offset,
+                             (uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len,
+                             length - p_buf->len);
+    p_port->tx.queue_size += copied;
+
+    *p_len += copied;
+    p_buf->len += copied;
+    remaining -= copied;
+  }
+
+  mutex_global_unlock();
+
+  if (!remaining) return (PORT_SUCCESS);
+
+  while (remaining) {
+    /* if we're over buffer high water mark, we're done */
+    if ((p_port->tx.queue_size > PORT_TX_HIGH_WM) ||
+        (fixed_queue_length(p_port->tx.queue) > PORT_TX_BUF_HIGH_WM))
+      break;
+
+    /* continue with rfcomm data write */
+    p_buf = L2CA_AllocTxBuffer(
+        p_port->rfc.p_mcb ? p_port->rfc.p_mcb->lcid : 0, RFCOMM_DATA_BUF_SIZE);
+    p_buf->offset += RFCOMM_MIN_OFFSET;
+    p_buf->layer_specific = handle;
+    p_buf->event = BT_EVT_TO_BTU_SP_DATA;
+
+    copied = port_gather_vec(p_vec, num_vec, &vec_index, &vec_offset,
+                             (uint8_t*)(p_buf + 1) + p_buf->offset, length);
+    p_buf->len = copied;
+
+    RFCOMM_TRACE_EVENT("PORT_WriteDatav %d bytes", copied);
+
+    rc = port_write(p_port, p_buf);
+
+    /* If queue went below the threashold need to send flow control */
+    event |= port_flow_control_user(p_port);
+
+    if (rc == PORT_SUCCESS) event |= PORT_EV_TXCHAR;
+
+    if ((rc != PORT_SUCCESS) && (rc != PORT_CMD_PENDING)) break;
+
+    *p_len += copied;
+    remaining -= copied;
+  }
+  if (!remaining && (rc != PORT_CMD_PENDING) && (rc != PORT_TX_QUEUE_DISABLED))
+    event |= PORT_EV_TXEMPTY;
+
+  /* Mask out all events that are not of interest to user */
+  event &= p_port->ev_mask;
+
+  /* Send event to the application */
+  if (p_port->p_callback && event) (p_port->p_callback)(event, p_port->handle);
+
+  return (PORT_SUCCESS);
+}
+
 /*******************************************************************************
  *
  * Function         RFCOMM_Init
@@ -65,13 +65,25 @@ tSDP_RECORD* sdp_db_service_search(tSDP_RECORD* p_rec, tSDP_UUID_SEQ* p_seq) {
   /* the record contains all the passed UUIDs in it.                */
   for (; p_rec < p_end; p_rec++) {
     for (yy = 0; yy < p_seq->num_uids; yy++) {
+      /* Compress the target UUID once; almost all searches are for 16-bit
+       * SIG UUIDs, and this avoids expanding it against every attribute */
+      uint16_t target_u16 = 0;
+      bool target_is_u16 = sdpu_uuid16_from_array(
+          &p_seq->uuid_entry[yy].value[0], p_seq->uuid_entry[yy].len,
+          &target_u16);
+
       p_attr = &p_rec->attribute[0];
       for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
         if (p_attr->type == UUID_DESC_TYPE) {
-          if (sdpu_compare_uuid_arrays(p_attr->value_ptr, p_attr->len,
-                                       &p_seq->uuid_entry[yy].value[0],
-                                       p_seq->uuid_entry[yy].len))
+          if (target_is_u16 && p_attr->len == 2) {
+            if (((((uint16_t)p_attr->value_ptr[0]) << 8) |
+                 p_attr->value_ptr[1]) == target_u16)
+              break;
+          } else if (sdpu_compare_uuid_arrays(p_attr->value_ptr, p_attr->len,
+                                              &p_seq->uuid_entry[yy].value[0],
+                                              p_seq->uuid_entry[yy].len)) {
             break;
+          }
         } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
           if (find_uuid_in_seq(p_attr->value_ptr, p_attr->len,
                                &p_seq->uuid_entry[yy].value[0],
@@ -252,12 +264,10 @@ uint32_t SDP_CreateRecord(void) {
   if (p_db->num_records < SDP_MAX_RECORDS) {
     memset(&p_db->record[p_db->num_records], 0, sizeof(tSDP_RECORD));
 
-    /* We will use a handle of the first unreserved handle plus last record
-    ** number + 1 */
-    if (p_db->num_records)
-      handle = p_db->record[p_db->num_records - 1].record_handle + 1;
-    else
-      handle = 0x10000;
+    /* Handles start at the first unreserved value and only ever count up,
+    ** so a record moved during teardown can never alias a live handle */
+    if (p_db->next_handle < 0x10000) p_db->next_handle = 0x10000;
+    handle = p_db->next_handle++;
 
     p_db->record[p_db->num_records].record_handle = handle;
 
@@ -289,7 +299,7 @@ uint32_t SDP_CreateRecord(void) {
  *
  ******************************************************************************/
 bool SDP_DeleteRecord(uint32_t handle) {
-  uint16_t xx, yy, zz;
+  uint16_t xx, zz;
   tSDP_RECORD* p_rec = &sdp_cb.server_db.record[0];
 
   if (handle == 0 || sdp_cb.server_db.num_records == 0) {
@@ -299,18 +309,28 @@ bool SDP_DeleteRecord(uint32_t handle) {
     /* require new DI record to be created in SDP_SetLocalDiRecord */
     sdp_cb.server_db.di_primary_handle = 0;
 
+    sdp_server_cache_invalidate();
+
     return (true);
   } else {
     /* Find the record in the database */
     for (xx = 0; xx < sdp_cb.server_db.num_records; xx++, p_rec++) {
       if (p_rec->record_handle == handle) {
-        /* Found it. Shift everything up one */
-        for (yy = xx; yy < sdp_cb.server_db.num_records - 1; yy++, p_rec++) {
-          *p_rec = *(p_rec + 1);
-
-          /* Adjust the attribute value pointer for each attribute */
-          for (zz = 0; zz < p_rec->num_attributes; zz++)
-            p_rec->attribute[zz].value_ptr -= sizeof(tSDP_RECORD);
+        tSDP_RECORD* p_last =
+            &sdp_cb.server_db.record[sdp_cb.server_db.num_records - 1];
+
+        /* Found it. Move the last record into the hole; each record's
+        ** attribute values live in its own pad, so only the moved record's
+        ** value pointers need rebasing */
+        if (p_rec != p_last) {
+          *p_rec = *p_last;
+
+          for (zz = 0; zz < p_rec->num_attributes; zz++) {
+            if (p_rec->attribute[zz].value_ptr)
+              p_rec->attribute[zz].value_ptr =
+                  &p_rec->attr_pad[p_rec->attribute[zz].value_ptr -
+                                   &p_last->attr_pad[0]];
+          }
         }
 
         sdp_cb.server_db.num_records--;
@@ -323,6 +343,8 @@ bool SDP_DeleteRecord(uint32_t handle) {
           sdp_cb.server_db.di_primary_handle = 0;
         }
 
+        sdp_server_cache_invalidate();
+
         return (true);
       }
     }
@@ -450,7 +472,9 @@ bool SDP_AddAttribute(uint32_t handle, uint16_t attr_id, uint8_t attr_type,
         p_attr->id = p_attr->type = p_attr->len = 0;
         return (false);
       }
+      p_rec->total_attr_len += sdpu_get_attrib_entry_len(p_attr);
       p_rec->num_attributes++;
+      sdp_server_cache_invalidate();
       return (true);
     }
   }
@@ -777,6 +801,7 @@ bool SDP_DeleteAttribute(uint32_t handle, uint16_t attr_id) {
         if (p_attr->id == attr_id) {
           pad_ptr = p_attr->value_ptr;
           len = p_attr->len;
+          p_rec->total_attr_len -= sdpu_get_attrib_entry_len(p_attr);
 
           if (len) {
             for (uint16_t zz = 0; zz < p_rec->num_attributes; zz++) {
@@ -801,6 +826,7 @@ bool SDP_DeleteAttribute(uint32_t handle, uint16_t attr_id) {
             }
             p_rec->free_pad_ptr -= len;
           }
+          sdp_server_cache_invalidate();
           return (true);
         }
       }
@@ -25,6 +25,8 @@
 
 #include <string.h>
 
+#include <vector>
+
 #include "bt_common.h"
 #include "bt_types.h"
 
@@ -40,6 +42,24 @@
 #define SDP_MAX_SERVATTR_RSPHDR_LEN 10
 #define SDP_MAX_ATTR_RSPHDR_LEN 10
 
+/* Preserialized ServiceSearchAttribute response streams, keyed by the
+ * (UUID sequence, attribute sequence) pair extracted from the request. Peers
+ * tend to replay the same discovery burst on every connection, so the record
+ * walk and attribute serialization are done once and repeat requests
+ * (including continuations) are served at copy cost. The cache is flushed
+ * whenever the local database changes. */
+#define SDP_RSP_CACHE_NUM_ENTRIES 8
+
+typedef struct {
+  bool in_use;
+  tSDP_UUID_SEQ uid_seq;
+  tSDP_ATTR_SEQ attr_seq;
+  std::vector<uint8_t> rsp_stream; /* bytes exactly as streamed to the peer */
+} tSDP_RSP_CACHE_ENTRY;
+
+static tSDP_RSP_CACHE_ENTRY sdp_rsp_cache[SDP_RSP_CACHE_NUM_ENTRIES];
+static uint8_t sdp_rsp_cache_next_victim;
+
 /******************************************************************************/
 /*            L O C A L    F U N C T I O N     P R O T O T Y P E S            */
 /******************************************************************************/
@@ -255,9 +275,8 @@ static void process_service_search(tCONN_CB* p_ccb, uint16_t trans_num,
   }
 
   /* Get a buffer to use to build the response */
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(SDP_DATA_BUF_SIZE);
-  p_buf->offset = L2CAP_MIN_OFFSET;
-  p_rsp = p_rsp_start = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  BT_HDR* p_buf = L2CA_AllocTxBuffer(p_ccb->connection_id, SDP_DATA_BUF_SIZE);
+  p_rsp = p_rsp_start = (uint8_t*)(p_buf + 1) + p_buf->offset;
 
   /* Start building a rsponse */
   UINT8_TO_BE_STREAM(p_rsp, SDP_PDU_SERVICE_SEARCH_RSP);
@@ -489,9 +508,8 @@ static void process_service_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
   }
 
   /* Get a buffer to use to build the response */
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(SDP_DATA_BUF_SIZE);
-  p_buf->offset = L2CAP_MIN_OFFSET;
-  p_rsp = p_rsp_start = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  BT_HDR* p_buf = L2CA_AllocTxBuffer(p_ccb->connection_id, SDP_DATA_BUF_SIZE);
+  p_rsp = p_rsp_start = (uint8_t*)(p_buf + 1) + p_buf->offset;
 
   /* Start building a rsponse */
   UINT8_TO_BE_STREAM(p_rsp, SDP_PDU_SERVICE_ATTR_RSP);
@@ -528,6 +546,214 @@ static void process_service_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
   L2CA_DataWrite(p_ccb->connection_id, p_buf);
 }
 
+/*******************************************************************************
+ *
+ * Function         sdp_server_cache_invalidate
+ *
+ * Description      Drops all preserialized ServiceSearchAttribute responses.
+ *                  Called whenever the local database changes so that no peer
+ *                  can be served a stale stream.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_server_cache_invalidate(void) {
+  for (size_t xx = 0; xx < SDP_RSP_CACHE_NUM_ENTRIES; xx++) {
+    sdp_rsp_cache[xx].in_use = false;
+    sdp_rsp_cache[xx].rsp_stream.clear();
+    sdp_rsp_cache[xx].rsp_stream.shrink_to_fit();
+  }
+}
+
+/* Compare only the used portion of two extracted UUID sequences */
+static bool sdp_uid_seq_equal(const tSDP_UUID_SEQ* p_a,
+                              const tSDP_UUID_SEQ* p_b) {
+  if (p_a->num_uids != p_b->num_uids) return (false);
+
+  for (uint16_t xx = 0; xx < p_a->num_uids; xx++) {
+    if (p_a->uuid_entry[xx].len != p_b->uuid_entry[xx].len) return (false);
+    if (memcmp(p_a->uuid_entry[xx].value, p_b->uuid_entry[xx].value,
+               p_a->uuid_entry[xx].len) != 0)
+      return (false);
+  }
+  return (true);
+}
+
+/* Compare only the used portion of two extracted attribute sequences */
+static bool sdp_attr_seq_equal(const tSDP_ATTR_SEQ* p_a,
+                               const tSDP_ATTR_SEQ* p_b) {
+  if (p_a->num_attr != p_b->num_attr) return (false);
+
+  for (uint16_t xx = 0; xx < p_a->num_attr; xx++) {
+    if (p_a->attr_entry[xx].start != p_b->attr_entry[xx].start ||
+        p_a->attr_entry[xx].end != p_b->attr_entry[xx].end)
+      return (false);
+  }
+  return (true);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_rsp_cache_find_or_build
+ *
+ * Description      Returns the preserialized attribute list stream for the
+ *                  given search pattern, building and caching it on a miss.
+ *                  The stream holds exactly the bytes streamed to the peer:
+ *                  the outer sequence header followed by one attribute
+ *                  sequence per matching record.
+ *
+ * Returns          Pointer to the cached stream, or NULL if the response is
+ *                  too large to address with a 16 bit continuation offset
+ *
+ ******************************************************************************/
+static const std::vector<uint8_t>* sdp_rsp_cache_find_or_build(
+    tSDP_UUID_SEQ* p_uid_seq, tSDP_ATTR_SEQ* p_attr_seq) {
+  tSDP_RECORD* p_rec;
+  tSDP_ATTR_SEQ attr_seq;
+  tSDP_ATTRIBUTE* p_attr;
+  uint16_t seq_len, attr_len, xx;
+
+  for (size_t yy = 0; yy < SDP_RSP_CACHE_NUM_ENTRIES; yy++) {
+    tSDP_RSP_CACHE_ENTRY& entry = sdp_rsp_cache[yy];
+    if (entry.in_use && sdp_uid_seq_equal(&entry.uid_seq, p_uid_seq) &&
+        sdp_attr_seq_equal(&entry.attr_seq, p_attr_seq))
+      return &entry.rsp_stream;
+  }
+
+  /* Miss; serialize every matching record the way the per-PDU path would */
+  std::vector<uint8_t> stream;
+
+  for (p_rec = sdp_db_service_search(NULL, p_uid_seq); p_rec;
+       p_rec = sdp_db_service_search(p_rec, p_uid_seq)) {
+    seq_len = sdpu_get_attrib_seq_len(p_rec, p_attr_seq);
+    if (seq_len == 0) continue;
+
+    /* Attribute sequence type and length */
+    stream.push_back((DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_WORD);
+    stream.push_back((uint8_t)(seq_len >> 8));
+    stream.push_back((uint8_t)seq_len);
+
+    memcpy(&attr_seq, p_attr_seq, sizeof(tSDP_ATTR_SEQ));
+
+    for (xx = 0; xx < attr_seq.num_attr; xx++) {
+      p_attr = sdp_db_find_attr_in_rec(p_rec, attr_seq.attr_entry[xx].start,
+                                       attr_seq.attr_entry[xx].end);
+      if (!p_attr) continue;
+
+      attr_len = sdpu_get_attrib_entry_len(p_attr);
+      size_t used = stream.size();
+      stream.resize(used + attr_len);
+      sdpu_build_attrib_entry(&stream[used], p_attr);
+
+      /* If doing a range, stick with this one till no more attributes found
+       */
+      if (attr_seq.attr_entry[xx].start != attr_seq.attr_entry[xx].end) {
+        attr_seq.attr_entry[xx].start = p_attr->id + 1;
+        xx--;
+      }
+    }
+  }
+
+  /* Put in the sequence header (2 or 3 bytes), matching the incremental
+   * path which compares the content length plus its 3 byte header to 255 */
+  size_t content_len = stream.size();
+  if (content_len + 3 > 255) {
+    uint8_t hdr[3] = {(DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_WORD,
+                      (uint8_t)(content_len >> 8), (uint8_t)content_len};
+    stream.insert(stream.begin(), hdr, hdr + 3);
+  } else {
+    uint8_t hdr[2] = {(DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_BYTE,
+                      (uint8_t)content_len};
+    stream.insert(stream.begin(), hdr, hdr + 2);
+  }
+
+  if (stream.size() > UINT16_MAX) return NULL;
+
+  tSDP_RSP_CACHE_ENTRY& victim = sdp_rsp_cache[sdp_rsp_cache_next_victim];
+  sdp_rsp_cache_next_victim =
+      (sdp_rsp_cache_next_victim + 1) % SDP_RSP_CACHE_NUM_ENTRIES;
+
+  victim.in_use = true;
+  memcpy(&victim.uid_seq, p_uid_seq, sizeof(tSDP_UUID_SEQ));
+  memcpy(&victim.attr_seq, p_attr_seq, sizeof(tSDP_ATTR_SEQ));
+  victim.rsp_stream = std::move(stream);
+
+  return &victim.rsp_stream;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_rsp_cache_send_slice
+ *
+ * Description      Sends the slice of a preserialized response stream that
+ *                  fits the current request window, using the same PDU
+ *                  framing and continuation state as the incremental path.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_rsp_cache_send_slice(tCONN_CB* p_ccb, uint16_t trans_num,
+                                     const std::vector<uint8_t>& stream,
+                                     uint16_t max_list_len, bool is_cont,
+                                     uint16_t cont_offset) {
+  uint8_t *p_rsp, *p_rsp_start, *p_rsp_param_len;
+  uint16_t rsp_param_len, len_to_send;
+
+  p_ccb->list_len = (uint16_t)stream.size();
+  p_ccb->cont_offset = cont_offset;
+
+  len_to_send = (cont_offset < stream.size())
+                    ? (uint16_t)(stream.size() - cont_offset)
+                    : 0;
+  if (len_to_send > max_list_len) len_to_send = max_list_len;
+
+  /* A continued request that cannot make forward progress means the database
+   * shrank under the peer; report an error exactly like the incremental path
+   * does to avoid an infinite request/response loop */
+  if (is_cont && len_to_send == 0) {
+    sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE, NULL);
+    return;
+  }
+
+  /* Get a buffer to use to build the response */
+  BT_HDR* p_buf = L2CA_AllocTxBuffer(p_ccb->connection_id, SDP_DATA_BUF_SIZE);
+  p_rsp = p_rsp_start = (uint8_t*)(p_buf + 1) + p_buf->offset;
+
+  /* Start building a rsponse */
+  UINT8_TO_BE_STREAM(p_rsp, SDP_PDU_SERVICE_SEARCH_ATTR_RSP);
+  UINT16_TO_BE_STREAM(p_rsp, trans_num);
+
+  /* Skip the parameter length, add it when we know the length */
+  p_rsp_param_len = p_rsp;
+  p_rsp += 2;
+
+  /* Stream the list length to send */
+  UINT16_TO_BE_STREAM(p_rsp, len_to_send);
+
+  /* copy from the cached stream to the actual buffer to be sent */
+  memcpy(p_rsp, stream.data() + cont_offset, len_to_send);
+  p_rsp += len_to_send;
+
+  p_ccb->cont_offset += len_to_send;
+
+  /* If anything left to send, continuation needed */
+  if (p_ccb->cont_offset < p_ccb->list_len) {
+    UINT8_TO_BE_STREAM(p_rsp, SDP_CONTINUATION_LEN);
+    UINT16_TO_BE_STREAM(p_rsp, p_ccb->cont_offset);
+  } else
+    UINT8_TO_BE_STREAM(p_rsp, 0);
+
+  /* Go back and put the parameter length into the buffer */
+  rsp_param_len = p_rsp - p_rsp_param_len - 2;
+  UINT16_TO_BE_STREAM(p_rsp_param_len, rsp_param_len);
+
+  /* Set the length of the SDP data in the buffer */
+  p_buf->len = p_rsp - p_rsp_start;
+
+  /* Send the buffer through L2CAP */
+  L2CA_DataWrite(p_ccb->connection_id, p_buf);
+}
+
 /*******************************************************************************
  *
  * Function         process_service_search_attr_req
@@ -591,6 +817,45 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
     return;
   }
 
+  /* Repeat discovery bursts are served from the preserialized response
+   * cache. Peers pinned to AVRCP 1.4 get their profile descriptor list
+   * patched per-device below, so they take the incremental path. */
+  if (!interop_match_addr(INTEROP_AVRCP_1_4_ONLY, &(p_ccb->device_address))) {
+    const std::vector<uint8_t>* p_stream =
+        sdp_rsp_cache_find_or_build(&uid_seq, &attr_seq_sav);
+    if (p_stream) {
+      cont_offset = 0;
+
+      /* Check if this is a continuation request */
+      if (*p_req) {
+        if (*p_req++ != SDP_CONTINUATION_LEN ||
+            (p_req + sizeof(uint16_t) > p_req_end)) {
+          sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
+                                  SDP_TEXT_BAD_CONT_LEN);
+          return;
+        }
+        BE_STREAM_TO_UINT16(cont_offset, p_req);
+
+        if (cont_offset != p_ccb->cont_offset) {
+          sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
+                                  SDP_TEXT_BAD_CONT_INX);
+          return;
+        }
+        is_cont = true;
+      } else {
+        /* Reset continuation parameters in p_ccb */
+        p_ccb->cont_info.prev_sdp_rec = NULL;
+        p_ccb->cont_info.next_attr_index = 0;
+        p_ccb->cont_info.last_attr_seq_desc_sent = false;
+        p_ccb->cont_info.attr_offset = 0;
+      }
+
+      sdp_rsp_cache_send_slice(p_ccb, trans_num, *p_stream, max_list_len,
+                               is_cont, cont_offset);
+      return;
+    }
+  }
+
   /* Free and reallocate buffer */
   osi_free(p_ccb->rsp_list);
   p_ccb->rsp_list = (uint8_t*)osi_malloc(max_list_len);
@@ -803,9 +1068,8 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
   }
 
   /* Get a buffer to use to build the response */
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(SDP_DATA_BUF_SIZE);
-  p_buf->offset = L2CAP_MIN_OFFSET;
-  p_rsp = p_rsp_start = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  BT_HDR* p_buf = L2CA_AllocTxBuffer(p_ccb->connection_id, SDP_DATA_BUF_SIZE);
+  p_rsp = p_rsp_start = (uint8_t*)(p_buf + 1) + p_buf->offset;
 
   /* Start building a rsponse */
   UINT8_TO_BE_STREAM(p_rsp, SDP_PDU_SERVICE_SEARCH_ATTR_RSP);
@@ -870,9 +870,6 @@ bool sdpu_is_base_uuid(uint8_t* p_uuid) {
  ******************************************************************************/
 bool sdpu_compare_uuid_arrays(uint8_t* p_uuid1, uint32_t len1, uint8_t* p_uuid2,
                               uint16_t len2) {
-  uint8_t nu1[Uuid::kNumBytes128];
-  uint8_t nu2[Uuid::kNumBytes128];
-
   if (((len1 != 2) && (len1 != 4) && (len1 != 16)) ||
       ((len2 != 2) && (len2 != 4) && (len2 != 16))) {
     SDP_TRACE_ERROR("%s: invalid length", __func__);
@@ -893,17 +890,15 @@ bool sdpu_compare_uuid_arrays(uint8_t* p_uuid1, uint32_t len1, uint8_t* p_uuid2,
     if (len1 == 4) {
       return ((p_uuid1[0] == 0) && (p_uuid1[1] == 0) &&
               (p_uuid1[2] == p_uuid2[0]) && (p_uuid1[3] == p_uuid2[1]));
+    } else if (len2 == 4) {
+      /* Len1 must be 16; match only if it is built on the base UUID */
+      return ((p_uuid1[0] == p_uuid2[0]) && (p_uuid1[1] == p_uuid2[1]) &&
+              (p_uuid1[2] == p_uuid2[2]) && (p_uuid1[3] == p_uuid2[3]) &&
+              sdpu_is_base_uuid(p_uuid1));
     } else {
-      /* Normalize UUIDs to 16-byte form, then compare. Len1 must be 16 */
-      memcpy(nu1, p_uuid1, Uuid::kNumBytes128);
-      memcpy(nu2, sdp_base_uuid, Uuid::kNumBytes128);
-
-      if (len2 == 4)
-        memcpy(nu2, p_uuid2, len2);
-      else if (len2 == 2)
-        memcpy(nu2 + 2, p_uuid2, len2);
-
-      return (memcmp(nu1, nu2, Uuid::kNumBytes128) == 0);
+      return ((p_uuid1[0] == 0) && (p_uuid1[1] == 0) &&
+              (p_uuid1[2] == p_uuid2[0]) && (p_uuid1[3] == p_uuid2[1]) &&
+              sdpu_is_base_uuid(p_uuid1));
     }
   } else {
     /* len2 is greater than len1 */
@@ -911,21 +906,45 @@ bool sdpu_compare_uuid_arrays(uint8_t* p_uuid1, uint32_t len1, uint8_t* p_uuid2,
     if (len2 == 4) {
       return ((p_uuid2[0] == 0) && (p_uuid2[1] == 0) &&
               (p_uuid2[2] == p_uuid1[0]) && (p_uuid2[3] == p_uuid1[1]));
+    } else if (len1 == 4) {
+      /* Len2 must be 16; match only if it is built on the base UUID */
+      return ((p_uuid2[0] == p_uuid1[0]) && (p_uuid2[1] == p_uuid1[1]) &&
+              (p_uuid2[2] == p_uuid1[2]) && (p_uuid2[3] == p_uuid1[3]) &&
+              sdpu_is_base_uuid(p_uuid2));
     } else {
-      /* Normalize UUIDs to 16-byte form, then compare. Len1 must be 16 */
-      memcpy(nu2, p_uuid2, Uuid::kNumBytes128);
-      memcpy(nu1, sdp_base_uuid, Uuid::kNumBytes128);
-
-      if (len1 == 4)
-        memcpy(nu1, p_uuid1, (size_t)len1);
-      else if (len1 == 2)
-        memcpy(nu1 + 2, p_uuid1, (size_t)len1);
-
-      return (memcmp(nu1, nu2, Uuid::kNumBytes128) == 0);
+      return ((p_uuid2[0] == 0) && (p_uuid2[1] == 0) &&
+              (p_uuid2[2] == p_uuid1[0]) && (p_uuid2[3] == p_uuid1[1]) &&
+              sdpu_is_base_uuid(p_uuid2));
     }
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         sdpu_uuid16_from_array
+ *
+ * Description      This function tries to compress a BE UUID array to its
+ *                  16-bit form. Used to hoist the per-attribute expansion out
+ *                  of the service search matching loops.
+ *
+ * Returns          true if the UUID fits in 16 bit, with *p_uuid16 set
+ *
+ ******************************************************************************/
+bool sdpu_uuid16_from_array(const uint8_t* p_uuid, uint16_t len,
+                            uint16_t* p_uuid16) {
+  if (len == 4 || len == 16) {
+    if (p_uuid[0] != 0 || p_uuid[1] != 0) return (false);
+    if (len == 16 && !sdpu_is_base_uuid(const_cast<uint8_t*>(p_uuid)))
+      return (false);
+    p_uuid += 2;
+  } else if (len != 2) {
+    return (false);
+  }
+
+  *p_uuid16 = (((uint16_t)p_uuid[0]) << 8) | p_uuid[1];
+  return (true);
+}
+
 /*******************************************************************************
  *
  * Function         sdpu_compare_uuid_with_attr
@@ -1034,6 +1053,12 @@ uint16_t sdpu_get_attrib_seq_len(tSDP_RECORD* p_rec, tSDP_ATTR_SEQ* attr_seq) {
   bool is_range = false;
   uint16_t start_id = 0, end_id = 0;
 
+  /* The whole-record request is the common case; the database maintains its
+   * size as attributes are added and deleted, so no walk is needed */
+  if (attr_seq->num_attr == 1 && attr_seq->attr_entry[0].start == 0 &&
+      attr_seq->attr_entry[0].end == 0xFFFF)
+    return (uint16_t)p_rec->total_attr_len;
+
   for (xx = 0; xx < attr_seq->num_attr; xx++) {
     if (!is_range) {
       start_id = attr_seq->attr_entry[xx].start;
@@ -93,6 +93,9 @@ typedef struct {
 typedef struct {
   uint32_t record_handle;
   uint32_t free_pad_ptr;
+  uint32_t total_attr_len; /* Sum of the on-the-wire entry lengths of all
+                              attributes, maintained on add/delete so server
+                              responses can be sized without a dry run */
   uint16_t num_attributes;
   tSDP_ATTRIBUTE attribute[SDP_MAX_REC_ATTR];
   uint8_t attr_pad[SDP_MAX_PAD_LEN];
@@ -102,6 +105,9 @@ typedef struct {
 typedef struct {
   uint32_t
       di_primary_handle; /* Device ID Primary record or NULL if nonexistent */
+  uint32_t next_handle;  /* Next record handle to hand out; monotonic so a
+                            record moved during teardown never aliases a
+                            live handle */
   uint16_t num_records;
   tSDP_RECORD record[SDP_MAX_RECORDS];
 } tSDP_DB;
@@ -214,6 +220,8 @@ extern uint8_t* sdpu_get_len_from_type(uint8_t* p, uint8_t* p_end, uint8_t type,
 extern bool sdpu_is_base_uuid(uint8_t* p_uuid);
 extern bool sdpu_compare_uuid_arrays(uint8_t* p_uuid1, uint32_t len1,
                                      uint8_t* p_uuid2, uint16_t len2);
+extern bool sdpu_uuid16_from_array(const uint8_t* p_uuid, uint16_t len,
+                                   uint16_t* p_uuid16);
 extern bool sdpu_compare_uuid_with_attr(const bluetooth::Uuid& uuid,
                                         tSDP_DISC_ATTR* p_attr);
 
@@ -240,6 +248,7 @@ extern tSDP_ATTRIBUTE* sdp_db_find_attr_in_rec(tSDP_RECORD* p_rec,
 /* Functions provided by sdp_server.cc
  */
 extern void sdp_server_handle_client_req(tCONN_CB* p_ccb, BT_HDR* p_msg);
+extern void sdp_server_cache_invalidate(void);
 
 /* Functions provided by sdp_discovery.cc
  */
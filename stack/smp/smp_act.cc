@@ -1557,13 +1557,12 @@ void smp_idle_terminate(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
 void smp_both_have_public_keys(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
   SMP_TRACE_DEBUG("%s", __func__);
 
-  /* invokes DHKey computation */
+  /* invokes DHKey computation on the crypto worker; SMP_SC_DHKEY_CMPLT_EVT
+   * is raised from the main thread once the result is posted back */
   smp_compute_dhkey(p_cb);
 
   /* on peripheral side invokes sending local public key to the peer */
   if (p_cb->role == HCI_ROLE_PERIPHERAL) smp_send_pair_public_key(p_cb, NULL);
-
-  smp_sm_event(p_cb, SMP_SC_DHKEY_CMPLT_EVT, NULL);
 }
 
 /*******************************************************************************
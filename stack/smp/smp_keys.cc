@@ -28,6 +28,7 @@
 #include "bt_utils.h"
 #include "btm_ble_api.h"
 #include "btm_ble_int.h"
+#include "common/message_loop_thread.h"
 #include "device/include/controller.h"
 #include "hcimsgs.h"
 #include "osi/include/osi.h"
@@ -37,8 +38,10 @@
 #include "stack/btm/btm_sec.h"
 #include "stack/crypto_toolbox/crypto_toolbox.h"
 #include "stack/include/acl_api.h"
+#include "stack/include/btu.h"
 
 #include <algorithm>
+#include <array>
 
 extern tBTM_CB btm_cb;  // TODO Remove
 
@@ -59,6 +62,18 @@ static void smp_process_private_key(tSMP_CB* p_cb);
 // This needs to be cleared on a successfult pairing using the oob data
 static tSMP_LOC_OOB_DATA saved_local_oob_data = {};
 
+/* Worker thread for P-256 point multiplications. ECDH takes tens of ms of
+ * pure computation, long enough to starve ACL traffic if run on the main
+ * thread, so those operations run here and post their results back as state
+ * machine events. The short AES based calculations (f4/f5/f6, CMAC) stay
+ * inline; they complete in microseconds. */
+static bluetooth::common::MessageLoopThread smp_crypto_thread("bt_smp_crypto");
+
+static void smp_schedule_on_crypto_worker(base::OnceClosure task) {
+  if (!smp_crypto_thread.IsRunning()) smp_crypto_thread.StartUp();
+  smp_crypto_thread.DoInThread(FROM_HERE, std::move(task));
+}
+
 void smp_save_local_oob_data(tSMP_CB* p_cb) {
   saved_local_oob_data = p_cb->sc_oob_data.loc_oob_data;
 }
@@ -694,23 +709,26 @@ void smp_use_oob_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
 
 /*******************************************************************************
  *
- * Function         smp_process_private_key
+ * Function         smp_public_key_computed
  *
- * Description      This function processes private key.
- *                  It calculates public key and notifies SM that private key /
- *                  public key pair is created.
+ * Description      Main thread continuation of smp_process_private_key.
+ *                  Saves the public key and notifies SM that private key /
+ *                  public key pair is created. Results of a pairing that was
+ *                  torn down while the worker ran are dropped.
  *
  * Returns          void
  *
  ******************************************************************************/
-void smp_process_private_key(tSMP_CB* p_cb) {
-  Point public_key;
-  BT_OCTET32 private_key;
+static void smp_public_key_computed(RawAddress pairing_bda, Point public_key) {
+  tSMP_CB* p_cb = &smp_cb;
 
   SMP_TRACE_DEBUG("%s", __func__);
 
-  memcpy(private_key, p_cb->private_key, BT_OCTET32_LEN);
-  ECC_PointMult(&public_key, &(curve_p256.G), (uint32_t*)private_key);
+  if (p_cb->pairing_bda != pairing_bda) {
+    SMP_TRACE_WARNING("%s: pairing gone, dropping stale public key", __func__);
+    return;
+  }
+
   memcpy(p_cb->loc_publ_key.x, public_key.x, BT_OCTET32_LEN);
   memcpy(p_cb->loc_publ_key.y, public_key.y, BT_OCTET32_LEN);
 
@@ -726,27 +744,55 @@ void smp_process_private_key(tSMP_CB* p_cb) {
 
 /*******************************************************************************
  *
- * Function         smp_compute_dhkey
+ * Function         smp_process_private_key
  *
- * Description      The function:
- *                  - calculates a new public key using as input local private
- *                    key and peer public key;
- *                  - saves the new public key x-coordinate as DHKey.
+ * Description      This function processes private key.
+ *                  It schedules the public key calculation on the crypto
+ *                  worker; SM is notified from the main thread once the
+ *                  private key / public key pair is created.
  *
  * Returns          void
  *
  ******************************************************************************/
-void smp_compute_dhkey(tSMP_CB* p_cb) {
-  Point peer_publ_key, new_publ_key;
-  BT_OCTET32 private_key;
-
+void smp_process_private_key(tSMP_CB* p_cb) {
   SMP_TRACE_DEBUG("%s", __func__);
 
-  memcpy(private_key, p_cb->private_key, BT_OCTET32_LEN);
-  memcpy(peer_publ_key.x, p_cb->peer_publ_key.x, BT_OCTET32_LEN);
-  memcpy(peer_publ_key.y, p_cb->peer_publ_key.y, BT_OCTET32_LEN);
+  std::array<uint8_t, BT_OCTET32_LEN> private_key;
+  memcpy(private_key.data(), p_cb->private_key, BT_OCTET32_LEN);
+
+  smp_schedule_on_crypto_worker(base::BindOnce(
+      [](std::array<uint8_t, BT_OCTET32_LEN> private_key,
+         RawAddress pairing_bda) {
+        Point public_key;
+        ECC_PointMult(&public_key, &(curve_p256.G),
+                      (uint32_t*)private_key.data());
+        do_in_main_thread(FROM_HERE, base::BindOnce(&smp_public_key_computed,
+                                                    pairing_bda, public_key));
+      },
+      private_key, p_cb->pairing_bda));
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_dhkey_computed
+ *
+ * Description      Main thread continuation of smp_compute_dhkey. Saves the
+ *                  DHKey and notifies SM that it is available. Results of a
+ *                  pairing that was torn down while the worker ran are
+ *                  dropped.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void smp_dhkey_computed(RawAddress pairing_bda, Point new_publ_key) {
+  tSMP_CB* p_cb = &smp_cb;
 
-  ECC_PointMult(&new_publ_key, &peer_publ_key, (uint32_t*)private_key);
+  SMP_TRACE_DEBUG("%s", __func__);
+
+  if (p_cb->pairing_bda != pairing_bda) {
+    SMP_TRACE_WARNING("%s: pairing gone, dropping stale DHKey", __func__);
+    return;
+  }
 
   memcpy(p_cb->dhkey, new_publ_key.x, BT_OCTET32_LEN);
 
@@ -760,6 +806,45 @@ void smp_compute_dhkey(tSMP_CB* p_cb) {
                                       BT_OCTET32_LEN);
   smp_debug_print_nbyte_little_endian(p_cb->dhkey, "Reverted DHKey",
                                       BT_OCTET32_LEN);
+
+  smp_sm_event(p_cb, SMP_SC_DHKEY_CMPLT_EVT, NULL);
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_compute_dhkey
+ *
+ * Description      The function schedules the DHKey computation on the
+ *                  crypto worker:
+ *                  - calculates a new public key using as input local private
+ *                    key and peer public key;
+ *                  - saves the new public key x-coordinate as DHKey.
+ *                  SMP_SC_DHKEY_CMPLT_EVT is raised from the main thread
+ *                  once the result is available.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_compute_dhkey(tSMP_CB* p_cb) {
+  SMP_TRACE_DEBUG("%s", __func__);
+
+  std::array<uint8_t, BT_OCTET32_LEN> private_key;
+  Point peer_publ_key;
+
+  memcpy(private_key.data(), p_cb->private_key, BT_OCTET32_LEN);
+  memcpy(peer_publ_key.x, p_cb->peer_publ_key.x, BT_OCTET32_LEN);
+  memcpy(peer_publ_key.y, p_cb->peer_publ_key.y, BT_OCTET32_LEN);
+
+  smp_schedule_on_crypto_worker(base::BindOnce(
+      [](std::array<uint8_t, BT_OCTET32_LEN> private_key, Point peer_publ_key,
+         RawAddress pairing_bda) {
+        Point new_publ_key;
+        ECC_PointMult(&new_publ_key, &peer_publ_key,
+                      (uint32_t*)private_key.data());
+        do_in_main_thread(FROM_HERE, base::BindOnce(&smp_dhkey_computed,
+                                                    pairing_bda, new_publ_key));
+      },
+      private_key, peer_publ_key, p_cb->pairing_bda));
 }
 
 /** The function calculates and saves local commmitment in CB. */
@@ -174,4 +174,64 @@ TEST(AdvertiseDataParserTest, RemoveTrailingZerosMalformed) {
   glued.insert(glued.end(), scan_resp.begin(), scan_resp.end());
 
   EXPECT_TRUE(AdvertiseDataParser::IsValid(glued));
-}
\ No newline at end of file
+}
+TEST(AdvertiseDataIndexTest, GetFieldByType) {
+  // Two fields.
+  const std::vector<uint8_t> data0{0x03, 0x02, 0x01, 0x02, 0x02, 0x03, 0x01};
+  AdvertiseDataIndex index0(data0);
+
+  uint8_t p_length;
+  const uint8_t* data = index0.GetFieldByType(0x02, &p_length);
+  EXPECT_EQ(data0.data() + 2, data);
+  EXPECT_EQ(2, p_length);
+
+  data = index0.GetFieldByType(0x03, &p_length);
+  EXPECT_EQ(data0.data() + 6, data);
+  EXPECT_EQ(1, p_length);
+
+  // Absent type.
+  data = index0.GetFieldByType(0x09, &p_length);
+  EXPECT_EQ(nullptr, data);
+  EXPECT_EQ(0, p_length);
+
+  // Two fields, second field length too long; the index must stop walking
+  // exactly where GetFieldByType does.
+  const std::vector<uint8_t> data1{0x02, 0x02, 0x00, 0x03, 0x00};
+  AdvertiseDataIndex index1(data1);
+
+  data = index1.GetFieldByType(0x02, &p_length);
+  EXPECT_EQ(data1.data() + 2, data);
+  EXPECT_EQ(0x01, p_length);
+
+  data = index1.GetFieldByType(0x03, &p_length);
+  EXPECT_EQ(nullptr, data);
+  EXPECT_EQ(0, p_length);
+}
+
+TEST(AdvertiseDataIndexTest, MatchesParserForAllTypes) {
+  // Flags, 16-bit service UUIDs, complete name, manufacturer data, and a
+  // duplicated type; the first occurrence must win, same as the parser.
+  const std::vector<uint8_t> data0{0x02, 0x01, 0x06, 0x03, 0x03, 0x12,
+                                   0x18, 0x05, 0x09, 0x74, 0x65, 0x73,
+                                   0x74, 0x03, 0x03, 0x0f, 0x18};
+  AdvertiseDataIndex index(data0);
+
+  for (int type = 0; type <= 0xff; type++) {
+    uint8_t parser_length, index_length;
+    const uint8_t* parser_field = AdvertiseDataParser::GetFieldByType(
+        data0, (uint8_t)type, &parser_length);
+    const uint8_t* index_field =
+        index.GetFieldByType((uint8_t)type, &index_length);
+    EXPECT_EQ(parser_field, index_field) << "type " << type;
+    EXPECT_EQ(parser_length, index_length) << "type " << type;
+  }
+}
+
+TEST(AdvertiseDataIndexTest, EmptyData) {
+  const std::vector<uint8_t> data0;
+  AdvertiseDataIndex index(data0);
+
+  uint8_t p_length;
+  EXPECT_EQ(nullptr, index.GetFieldByType(0x01, &p_length));
+  EXPECT_EQ(0, p_length);
+}
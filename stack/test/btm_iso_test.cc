@@ -1934,8 +1934,8 @@ TEST_F(IsoManagerTest, SendIsoDataNoCredits) {
       kDefaultIsoDataPathParams);
 
   /* Try sending twice as much data as we can ignoring the credit limits and
-   * expect the redundant packets to be ignored and not propagated down to the
-   * HCI.
+   * expect the excess packets to be queued up instead of propagated down to
+   * the HCI.
    */
   EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
   for (uint8_t i = 0; i < (2 * num_buffers); i++) {
@@ -1944,7 +1944,10 @@ TEST_F(IsoManagerTest, SendIsoDataNoCredits) {
         data_vec.size());
   }
 
-  // Return all credits for this one handle
+  /* Return all credits for this one handle and expect the queued-up packets
+   * to get flushed down to the HCI.
+   */
+  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
   uint8_t mock_rsp[5];
   uint8_t* p = mock_rsp;
   UINT8_TO_STREAM(p, 1);
@@ -1958,16 +1961,26 @@ TEST_F(IsoManagerTest, SendIsoDataNoCredits) {
   IsoManager::GetInstance()->SetupIsoDataPath(
       volatile_test_big_params_evt_.conn_handles[0], kDefaultIsoDataPathParams);
 
-  /* Try sending twice as much data as we can ignoring the credit limits and
-   * expect the redundant packets to be ignored and not propagated down to the
-   * HCI.
+  /* All the credits were just consumed by the CIS queue flush, so every BIS
+   * packet should get queued up and nothing should reach the HCI.
    */
-  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers);
+  EXPECT_CALL(bte_interface_, HciSend).Times(0);
   for (uint8_t i = 0; i < (2 * num_buffers); i++) {
     IsoManager::GetInstance()->SendIsoData(
         volatile_test_big_params_evt_.conn_handles[0], data_vec.data(),
         data_vec.size());
   }
+
+  /* Return the credits again and expect the queued BIS packets on the HCI.
+   * The queue is bounded to the controller buffer count, so the surplus
+   * packets were dropped oldest-first while the credits were out.
+   */
+  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers);
+  p = mock_rsp;
+  UINT8_TO_STREAM(p, 1);
+  UINT16_TO_STREAM(p, volatile_test_cig_create_cmpl_evt_.conn_handles[0]);
+  UINT16_TO_STREAM(p, num_buffers);
+  IsoManager::GetInstance()->HandleNumComplDataPkts(mock_rsp, sizeof(mock_rsp));
 }
 
 TEST_F(IsoManagerTest, SendIsoDataCreditsReturned) {
@@ -1989,8 +2002,8 @@ TEST_F(IsoManagerTest, SendIsoDataCreditsReturned) {
       kDefaultIsoDataPathParams);
 
   /* Try sending twice as much data as we can, ignoring the credits limit and
-   * expect the redundant packets to be ignored and not propagated down to the
-   * HCI.
+   * expect the excess packets to be queued up instead of propagated down to
+   * the HCI.
    */
   EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
   for (uint8_t i = 0; i < (2 * num_buffers); i++) {
@@ -1999,7 +2012,10 @@ TEST_F(IsoManagerTest, SendIsoDataCreditsReturned) {
         data_vec.size());
   }
 
-  // Return all credits for this one handle
+  /* Return all credits for this one handle and expect the queued-up packets
+   * to get flushed down to the HCI.
+   */
+  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
   uint8_t mock_rsp[5];
   uint8_t* p = mock_rsp;
   UINT8_TO_STREAM(p, 1);
@@ -2007,15 +2023,17 @@ TEST_F(IsoManagerTest, SendIsoDataCreditsReturned) {
   UINT16_TO_STREAM(p, num_buffers);
   IsoManager::GetInstance()->HandleNumComplDataPkts(mock_rsp, sizeof(mock_rsp));
 
-  // Expect some more events go down the HCI
-  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
+  /* The flush consumed all the returned credits, so more data gets queued up
+   * again and reaches the HCI only once the credits come back.
+   */
+  EXPECT_CALL(bte_interface_, HciSend).Times(0);
   for (uint8_t i = 0; i < (2 * num_buffers); i++) {
     IsoManager::GetInstance()->SendIsoData(
         volatile_test_cig_create_cmpl_evt_.conn_handles[0], data_vec.data(),
         data_vec.size());
   }
 
-  // Return all credits for this one handle
+  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
   p = mock_rsp;
   UINT8_TO_STREAM(p, 1);
   UINT16_TO_STREAM(p, volatile_test_cig_create_cmpl_evt_.conn_handles[0]);
@@ -2028,27 +2046,35 @@ TEST_F(IsoManagerTest, SendIsoDataCreditsReturned) {
   IsoManager::GetInstance()->SetupIsoDataPath(
       volatile_test_big_params_evt_.conn_handles[0], kDefaultIsoDataPathParams);
 
-  /* Try sending twice as much data as we can, ignoring the credits limit and
-   * expect the redundant packets to be ignored and not propagated down to the
-   * HCI.
+  /* No credits are left after the CIS queue flush, so the BIS packets get
+   * queued up as well, with the surplus dropped oldest-first.
    */
-  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
+  EXPECT_CALL(bte_interface_, HciSend).Times(0);
   for (uint8_t i = 0; i < (2 * num_buffers); i++) {
     IsoManager::GetInstance()->SendIsoData(
         volatile_test_big_params_evt_.conn_handles[0], data_vec.data(),
         data_vec.size());
   }
 
-  // Return all credits for this one handle
+  /* Return all credits for the BIS handle and expect its queue on the HCI */
+  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
+  p = mock_rsp;
+  UINT8_TO_STREAM(p, 1);
+  UINT16_TO_STREAM(p, volatile_test_big_params_evt_.conn_handles[0]);
+  UINT16_TO_STREAM(p, num_buffers);
+  IsoManager::GetInstance()->HandleNumComplDataPkts(mock_rsp, sizeof(mock_rsp));
+
+  /* Return the credits once more - with the queues empty, new data goes down
+   * to the HCI immediately again.
+   */
   p = mock_rsp;
   UINT8_TO_STREAM(p, 1);
   UINT16_TO_STREAM(p, volatile_test_big_params_evt_.conn_handles[0]);
   UINT16_TO_STREAM(p, num_buffers);
   IsoManager::GetInstance()->HandleNumComplDataPkts(mock_rsp, sizeof(mock_rsp));
 
-  // Expect some more events go down the HCI
   EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
-  for (uint8_t i = 0; i < (2 * num_buffers); i++) {
+  for (uint8_t i = 0; i < num_buffers; i++) {
     IsoManager::GetInstance()->SendIsoData(
         volatile_test_big_params_evt_.conn_handles[0], data_vec.data(),
         data_vec.size());
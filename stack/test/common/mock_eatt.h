@@ -31,6 +31,7 @@ class MockEattExtension : public EattExtension {
   static MockEattExtension* GetInstance();
 
   MOCK_METHOD((void), Connect, (const RawAddress& bd_addr));
+  MOCK_METHOD((void), EncryptionComplete, (const RawAddress& bd_addr));
   MOCK_METHOD((void), Disconnect, (const RawAddress& bd_addr));
   MOCK_METHOD((void), Reconfigure,
               (const RawAddress& bd_addr, uint16_t cid, uint16_t mtu));
@@ -397,4 +397,56 @@ TEST(CryptoToolboxTest, bt_spec_example_d_12_test) {
   EXPECT_EQ(expected_ltk, ltk);
 }
 
+TEST(CryptoToolboxTest, aes_128_context_matches_aes_128) {
+  Octet16 k{0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+            0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  Octet16 m{0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+            0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a};
+
+  Aes128Context ctx(k);
+  EXPECT_EQ(ctx.encrypt(m), aes_128(k, m));
+
+  // the cached key schedule must survive repeated use
+  EXPECT_EQ(ctx.encrypt(m), aes_128(k, m));
+}
+
+TEST(CryptoToolboxTest, aes_128_batch_matches_aes_128) {
+  Octet16 k{0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+            0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+  std::vector<Octet16> messages;
+  for (uint8_t i = 0; i < 8; i++) {
+    Octet16 m{};
+    m.fill(i);
+    messages.push_back(m);
+  }
+
+  std::vector<Octet16> outputs = aes_128_batch(k, messages);
+  ASSERT_EQ(outputs.size(), messages.size());
+  for (size_t i = 0; i < messages.size(); i++) {
+    EXPECT_EQ(outputs[i], aes_128(k, messages[i]));
+  }
+}
+
+TEST(CryptoToolboxTest, aes_128_backend_fallback) {
+  Octet16 k{0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+            0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  Octet16 m{};
+
+  Octet16 expected = aes_128(k, m);
+
+  // a backend that always refuses must fall back to the software cipher
+  static tAES_128_BACKEND refusing_backend = {
+      "refusing_backend",
+      [](const uint8_t* /* key */, const uint8_t* /* in */, uint8_t* /* out */,
+         size_t /* num_blocks */) { return false; },
+  };
+  aes_128_set_backend(&refusing_backend);
+  EXPECT_EQ(aes_128(k, m), expected);
+  EXPECT_EQ(aes_128_batch(k, {m})[0], expected);
+
+  aes_128_set_backend(nullptr);
+  EXPECT_EQ(aes_128(k, m), expected);
+}
+
 }  // namespace crypto_toolbox
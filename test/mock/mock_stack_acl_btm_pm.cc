@@ -48,6 +48,10 @@ bool BTM_ReadPowerMode(const RawAddress& remote_bda, tBTM_PM_MODE* p_mode) {
   mock_function_count_map[__func__]++;
   return false;
 }
+uint16_t BTM_GetSniffInterval(const RawAddress& remote_bda) {
+  mock_function_count_map[__func__]++;
+  return 0;
+}
 bool BTM_SetLinkPolicyActiveMode(const RawAddress& remote_bda) {
   mock_function_count_map[__func__]++;
   return false;
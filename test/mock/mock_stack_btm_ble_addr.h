@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:10
+ *   Functions generated:11
  *
  *  mockcify.pl ver 0.2
  */
@@ -114,6 +114,14 @@ struct btm_ble_resolve_random_addr {
   };
 };
 extern struct btm_ble_resolve_random_addr btm_ble_resolve_random_addr;
+// Name: btm_ble_resolve_cache_invalidate
+// Params: void
+// Returns: void
+struct btm_ble_resolve_cache_invalidate {
+  std::function<void(void)> body{[](void) {}};
+  void operator()(void) { body(); };
+};
+extern struct btm_ble_resolve_cache_invalidate btm_ble_resolve_cache_invalidate;
 // Name: btm_identity_addr_to_random_pseudo
 // Params: RawAddress* bd_addr, uint8_t* p_addr_type, bool refresh
 // Returns: bool
@@ -81,6 +81,7 @@ struct L2CA_SetIdleTimeoutByBdAddr L2CA_SetIdleTimeoutByBdAddr;
 struct L2CA_SetTraceLevel L2CA_SetTraceLevel;
 struct L2CA_SetAclPriority L2CA_SetAclPriority;
 struct L2CA_SetTxPriority L2CA_SetTxPriority;
+struct L2CA_SetChnlTxQuota L2CA_SetChnlTxQuota;
 struct L2CA_GetPeerFeatures L2CA_GetPeerFeatures;
 struct L2CA_RegisterFixedChannel L2CA_RegisterFixedChannel;
 struct L2CA_ConnectFixedChnl L2CA_ConnectFixedChnl;
@@ -214,6 +215,10 @@ bool L2CA_SetTxPriority(uint16_t cid, tL2CAP_CHNL_PRIORITY priority) {
   mock_function_count_map[__func__]++;
   return test::mock::stack_l2cap_api::L2CA_SetTxPriority(cid, priority);
 }
+bool L2CA_SetChnlTxQuota(uint16_t cid, uint8_t quota) {
+  mock_function_count_map[__func__]++;
+  return test::mock::stack_l2cap_api::L2CA_SetChnlTxQuota(cid, quota);
+}
 bool L2CA_GetPeerFeatures(const RawAddress& bd_addr, uint32_t* p_ext_feat,
                           uint8_t* p_chnl_mask) {
   mock_function_count_map[__func__]++;
@@ -322,6 +322,15 @@ struct L2CA_SetTxPriority {
   };
 };
 extern struct L2CA_SetTxPriority L2CA_SetTxPriority;
+// Name: L2CA_SetChnlTxQuota
+// Params: uint16_t cid, uint8_t quota
+// Returns: bool
+struct L2CA_SetChnlTxQuota {
+  std::function<bool(uint16_t cid, uint8_t quota)> body{
+      [](uint16_t cid, uint8_t quota) { return false; }};
+  bool operator()(uint16_t cid, uint8_t quota) { return body(cid, quota); };
+};
+extern struct L2CA_SetChnlTxQuota L2CA_SetChnlTxQuota;
 // Name: L2CA_GetPeerFeatures
 // Params: const RawAddress& bd_addr, uint32_t* p_ext_feat, uint8_t* p_chnl_mask
 // Returns: bool
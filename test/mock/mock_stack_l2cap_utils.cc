@@ -75,6 +75,14 @@ tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid) {
   mock_function_count_map[__func__]++;
   return nullptr;
 }
+tL2C_CCB* l2cu_get_ccb_by_index(uint16_t ccb_index) {
+  mock_function_count_map[__func__]++;
+  return nullptr;
+}
+bool l2cu_grow_ccb_pool(void) {
+  mock_function_count_map[__func__]++;
+  return false;
+}
 tL2C_CCB* l2cu_find_ccb_by_cid(tL2C_LCB* p_lcb, uint16_t local_cid) {
   mock_function_count_map[__func__]++;
   return nullptr;
@@ -278,6 +286,9 @@ void l2cu_set_lcb_handle(struct t_l2c_linkcb& p_lcb, uint16_t handle) {
 void l2cu_set_non_flushable_pbf(bool is_supported) {
   mock_function_count_map[__func__]++;
 }
+void l2cu_set_remote_cid(tL2C_CCB* p_ccb, uint16_t remote_cid) {
+  mock_function_count_map[__func__]++;
+}
 void l2cu_update_lcb_4_bonding(const RawAddress& p_bd_addr, bool is_bonding) {
   mock_function_count_map[__func__]++;
 }
@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:20
+ *   Functions generated:21
  */
 
 #include <map>
@@ -97,6 +97,11 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
   mock_function_count_map[__func__]++;
   return 0;
 }
+int PORT_WriteDatav(uint16_t handle, const tPORT_DATA_VEC* p_vec,
+                    uint16_t num_vec, uint16_t* p_len) {
+  mock_function_count_map[__func__]++;
+  return 0;
+}
 int RFCOMM_CreateConnection(uint16_t uuid, uint8_t scn, bool is_server,
                             uint16_t mtu, const RawAddress& bd_addr,
                             uint16_t* p_handle, tPORT_CALLBACK* p_mgmt_cb) {
@@ -8,6 +8,7 @@
 #   $ ./test/run_benchmarks.sh bluetooth_benchmark_example
 
 known_benchmarks=(
+  bluetooth_benchmark_a2dp_up_sample
   bluetooth_benchmark_thread_performance
   bluetooth_benchmark_timer_performance
 )
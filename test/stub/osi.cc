@@ -300,6 +300,14 @@ void* osi_malloc(size_t size) {
   mock_function_count_map[__func__]++;
   return nullptr;
 }
+void* osi_calloc_tagged(size_t size, alloc_tag_t tag) {
+  mock_function_count_map[__func__]++;
+  return nullptr;
+}
+void* osi_malloc_tagged(size_t size, alloc_tag_t tag) {
+  mock_function_count_map[__func__]++;
+  return nullptr;
+}
 
 bool fixed_queue_is_empty(fixed_queue_t* queue) {
   mock_function_count_map[__func__]++;
@@ -35,11 +35,21 @@ namespace {
 constexpr Uuid kBase = Uuid::From128BitBE(
     UUID128Bit{{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
                 0x00, 0x80, 0x5f, 0x9b, 0x34, 0xfb}});
+
+// Loads 8 bytes of a UUID as a native word so that equality checks compile
+// down to word compares instead of byte loops. Only valid for equality -
+// the host byte order is irrelevant when both sides are loaded the same way.
+uint64_t uuid_word(const UUID128Bit& uu, size_t offset) {
+  uint64_t word;
+  memcpy(&word, uu.data() + offset, sizeof(word));
+  return word;
+}
 }  // namespace
 
 size_t Uuid::GetShortestRepresentationSize() const {
-  if (memcmp(uu.data() + kNumBytes32, kBase.uu.data() + kNumBytes32,
-             kNumBytes128 - kNumBytes32) != 0) {
+  if (uuid_word(uu, 8) != uuid_word(kBase.uu, 8) ||
+      memcmp(uu.data() + kNumBytes32, kBase.uu.data() + kNumBytes32,
+             kNumBytes32) != 0) {
     return kNumBytes128;
   }
 
@@ -160,13 +170,16 @@ void Uuid::UpdateUuid(const Uuid& uuid) {
 }
 
 bool Uuid::operator<(const Uuid& rhs) const {
-  return std::lexicographical_compare(uu.begin(), uu.end(), rhs.uu.begin(),
-                                      rhs.uu.end());
+  // Bytes are kept Big Endian, so memcmp order is lexicographical order.
+  return memcmp(uu.data(), rhs.uu.data(), kNumBytes128) < 0;
 }
 
-bool Uuid::operator==(const Uuid& rhs) const { return uu == rhs.uu; }
+bool Uuid::operator==(const Uuid& rhs) const {
+  return uuid_word(uu, 0) == uuid_word(rhs.uu, 0) &&
+         uuid_word(uu, 8) == uuid_word(rhs.uu, 8);
+}
 
-bool Uuid::operator!=(const Uuid& rhs) const { return uu != rhs.uu; }
+bool Uuid::operator!=(const Uuid& rhs) const { return !(*this == rhs); }
 
 std::string Uuid::ToString() const {
   return base::StringPrintf(
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 #include <array>
+#include <cstring>
 #include <string>
 
 namespace bluetooth {
@@ -133,10 +134,14 @@ namespace std {
 template <>
 struct hash<bluetooth::Uuid> {
   std::size_t operator()(const bluetooth::Uuid& key) const {
+    // Mix the two 64-bit halves instead of hashing the bytes through a
+    // temporary std::string, which allocated on every lookup.
     const auto& uuid_bytes = key.To128BitBE();
-    std::hash<std::string> hash_fn;
-    return hash_fn(std::string(reinterpret_cast<const char*>(uuid_bytes.data()),
-                               uuid_bytes.size()));
+    uint64_t msb, lsb;
+    std::memcpy(&msb, uuid_bytes.data(), sizeof(msb));
+    std::memcpy(&lsb, uuid_bytes.data() + sizeof(msb), sizeof(lsb));
+    std::hash<uint64_t> hash_fn;
+    return hash_fn(msb ^ (lsb + 0x9e3779b97f4a7c15 + (msb << 6) + (msb >> 2)));
   }
 };
 
@@ -121,6 +121,25 @@ TEST(UuidTest, ToString) {
   EXPECT_EQ("12345678-0000-1000-8000-00805f9b34fb", uuid.ToString());
 }
 
+TEST(UuidTest, CompareOperators) {
+  EXPECT_TRUE(ONES == ONES);
+  EXPECT_FALSE(ONES == SEQUENTIAL);
+  EXPECT_TRUE(ONES != SEQUENTIAL);
+  EXPECT_FALSE(ONES != ONES);
+
+  // Uuid keeps bytes Big Endian, so ordering follows the byte array.
+  EXPECT_TRUE(Uuid::kEmpty < kBase);
+  EXPECT_TRUE(SEQUENTIAL < ONES);
+  EXPECT_FALSE(ONES < ONES);
+
+  // UUIDs differing only in the last 8 bytes must not compare equal.
+  Uuid almost_ones = Uuid::From128BitBE(
+      Uuid::UUID128Bit{{0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x12}});
+  EXPECT_FALSE(ONES == almost_ones);
+  EXPECT_TRUE(ONES < almost_ones);
+}
+
 TEST(BtifStorageTest, test_string_to_uuid) {
   const uint8_t u1[] = {0xe3, 0x9c, 0x62, 0x85, 0x86, 0x7f, 0x4b, 0x1d,
                         0x9d, 0xb0, 0x35, 0xfb, 0xd9, 0xae, 0xbf, 0x22};
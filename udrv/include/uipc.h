@@ -127,6 +127,14 @@ bool UIPC_Send(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint16_t msg_evt,
 uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint16_t* p_msg_evt,
                    uint8_t* p_buf, uint32_t len);
 
+/**
+ * Receive a file descriptor passed as SCM_RIGHTS ancillary data over UIPC
+ *
+ * @param ch_id Channel ID
+ * @return the received file descriptor on success, otherwise -1
+ */
+int UIPC_RecvFd(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id);
+
 /**
  * Control the UIPC parameter
  *
@@ -687,6 +687,58 @@ uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
   return n_read;
 }
 
+/*******************************************************************************
+ **
+ ** Function         UIPC_RecvFd
+ **
+ ** Description      Called to receive a file descriptor passed as SCM_RIGHTS
+ **                  ancillary data over UIPC.
+ **
+ ** Returns          the received file descriptor, or -1 on failure.
+ **
+ ******************************************************************************/
+
+int UIPC_RecvFd(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
+  if (ch_id >= UIPC_CH_NUM) {
+    BTIF_TRACE_ERROR("UIPC_RecvFd : invalid ch id %d", ch_id);
+    return -1;
+  }
+
+  int fd = uipc.ch[ch_id].fd;
+  if (fd == UIPC_DISCONNECTED) {
+    BTIF_TRACE_ERROR("UIPC_RecvFd : channel %d closed", ch_id);
+    return -1;
+  }
+
+  char payload;
+  struct iovec iov = {&payload, sizeof(payload)};
+  char cmsg_buf[CMSG_SPACE(sizeof(int))];
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = cmsg_buf;
+  msg.msg_controllen = sizeof(cmsg_buf);
+
+  ssize_t ret;
+  OSI_NO_INTR(ret = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC));
+  if (ret <= 0) {
+    BTIF_TRACE_ERROR("UIPC_RecvFd : recvmsg failed (%s)", strerror(errno));
+    return -1;
+  }
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (cmsg == NULL || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(sizeof(int))) {
+    BTIF_TRACE_ERROR("UIPC_RecvFd : no file descriptor received");
+    return -1;
+  }
+
+  int received_fd;
+  memcpy(&received_fd, CMSG_DATA(cmsg), sizeof(received_fd));
+  return received_fd;
+}
+
 /*******************************************************************************
  *
  * Function         UIPC_Ioctl
@@ -37,6 +37,10 @@ void TestEnvironment::initialize(std::promise<void> barrier) {
 
   barrier_ = std::move(barrier);
 
+  test_model_.RegisterVirtualTimeControl([this](bool enabled) {
+    async_manager_.SetVirtualTimeMode(enabled);
+  });
+
   auto user_id = async_manager_.GetNextUserId();
   test_channel_transport_.RegisterCommandHandler(
       [this, user_id](const std::string& name,
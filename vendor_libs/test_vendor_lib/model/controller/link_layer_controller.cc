@@ -46,19 +46,60 @@ static uint8_t GetRssi() {
 
 void LinkLayerController::SendLeLinkLayerPacket(
     std::unique_ptr<model::packets::LinkLayerPacketBuilder> packet) {
-  std::shared_ptr<model::packets::LinkLayerPacketBuilder> shared_packet =
-      std::move(packet);
-  ScheduleTask(milliseconds(50), [this, shared_packet]() {
-    send_to_remote_(shared_packet, Phy::Type::LOW_ENERGY);
-  });
+  pending_le_packets_.emplace_back(std::move(packet));
+  if (le_flush_scheduled_) return;
+  le_flush_scheduled_ = true;
+  ScheduleTask(milliseconds(50),
+               [this]() { FlushPendingPackets(Phy::Type::LOW_ENERGY); });
 }
 
 void LinkLayerController::SendLinkLayerPacket(
     std::unique_ptr<model::packets::LinkLayerPacketBuilder> packet) {
-  std::shared_ptr<model::packets::LinkLayerPacketBuilder> shared_packet =
-      std::move(packet);
-  ScheduleTask(milliseconds(50), [this, shared_packet]() {
-    send_to_remote_(shared_packet, Phy::Type::BR_EDR);
+  pending_classic_packets_.emplace_back(std::move(packet));
+  if (classic_flush_scheduled_) return;
+  classic_flush_scheduled_ = true;
+  ScheduleTask(milliseconds(50),
+               [this]() { FlushPendingPackets(Phy::Type::BR_EDR); });
+}
+
+void LinkLayerController::FlushPendingPackets(Phy::Type phy) {
+  auto& pending = (phy == Phy::Type::LOW_ENERGY) ? pending_le_packets_
+                                                 : pending_classic_packets_;
+  // Detach the batch first: send_to_remote_ delivers to the other devices
+  // synchronously and their responses can land back here and start a new one.
+  std::vector<std::shared_ptr<model::packets::LinkLayerPacketBuilder>> batch =
+      std::move(pending);
+  pending.clear();
+  if (phy == Phy::Type::LOW_ENERGY) {
+    le_flush_scheduled_ = false;
+  } else {
+    classic_flush_scheduled_ = false;
+  }
+  for (auto& packet : batch) {
+    send_to_remote_(packet, phy);
+  }
+}
+
+void LinkLayerController::QueueCompletedPacket(uint16_t handle) {
+  for (auto& cp : pending_completed_packets_) {
+    if (cp.connection_handle_ == handle) {
+      cp.host_num_of_completed_packets_ += kNumCommandPackets;
+      return;
+    }
+  }
+  bluetooth::hci::CompletedPackets cp;
+  cp.connection_handle_ = handle;
+  cp.host_num_of_completed_packets_ = kNumCommandPackets;
+  pending_completed_packets_.push_back(cp);
+
+  if (completed_packets_flush_scheduled_) return;
+  completed_packets_flush_scheduled_ = true;
+  ScheduleTask(milliseconds(1), [this]() {
+    completed_packets_flush_scheduled_ = false;
+    if (pending_completed_packets_.empty()) return;
+    send_event_(bluetooth::hci::NumberOfCompletedPacketsBuilder::Create(
+        pending_completed_packets_));
+    pending_completed_packets_.clear();
   });
 }
 
@@ -150,30 +191,30 @@ ErrorCode LinkLayerController::SendAclToRemote(
   AddressWithType destination = connections_.GetAddress(handle);
   Phy::Type phy = connections_.GetPhyType(handle);
 
-  ScheduleTask(milliseconds(1), [this, handle]() {
-    std::vector<bluetooth::hci::CompletedPackets> completed_packets;
-    bluetooth::hci::CompletedPackets cp;
-    cp.connection_handle_ = handle;
-    cp.host_num_of_completed_packets_ = kNumCommandPackets;
-    completed_packets.push_back(cp);
-    auto packet = bluetooth::hci::NumberOfCompletedPacketsBuilder::Create(
-        completed_packets);
-    send_event_(std::move(packet));
-  });
+  QueueCompletedPacket(handle);
 
   auto acl_payload = acl_packet.GetPayload();
 
-  std::unique_ptr<bluetooth::packet::RawBuilder> raw_builder_ptr =
-      std::make_unique<bluetooth::packet::RawBuilder>();
-  std::vector<uint8_t> payload_bytes(acl_payload.begin(), acl_payload.end());
-
   uint16_t first_two_bytes =
       static_cast<uint16_t>(acl_packet.GetHandle()) +
       (static_cast<uint16_t>(acl_packet.GetPacketBoundaryFlag()) << 12) +
       (static_cast<uint16_t>(acl_packet.GetBroadcastFlag()) << 14);
-  raw_builder_ptr->AddOctets2(first_two_bytes);
-  raw_builder_ptr->AddOctets2(static_cast<uint16_t>(payload_bytes.size()));
-  raw_builder_ptr->AddOctets(payload_bytes);
+  uint16_t payload_size = static_cast<uint16_t>(acl_payload.size());
+
+  // Build the forwarded bytes in a single buffer instead of copying the
+  // payload into a scratch vector and again into the builder.
+  std::vector<uint8_t> payload_bytes;
+  payload_bytes.reserve(acl_payload.size() + 4);
+  payload_bytes.push_back(first_two_bytes & 0xff);
+  payload_bytes.push_back(first_two_bytes >> 8);
+  payload_bytes.push_back(payload_size & 0xff);
+  payload_bytes.push_back(payload_size >> 8);
+  payload_bytes.insert(payload_bytes.end(), acl_payload.begin(),
+                       acl_payload.end());
+
+  std::unique_ptr<bluetooth::packet::RawBuilder> raw_builder_ptr =
+      std::make_unique<bluetooth::packet::RawBuilder>(
+          std::move(payload_bytes));
 
   auto acl = model::packets::AclBuilder::Create(my_address.GetAddress(),
                                                 destination.GetAddress(),
@@ -386,11 +427,10 @@ void LinkLayerController::IncomingAclPacket(
       connections_.GetHandleOnlyAddress(incoming.GetSourceAddress());
   LOG_INFO("Local handle 0x%x", local_handle);
 
-  std::vector<uint8_t> payload_data(acl_view.GetPayload().begin(),
-                                    acl_view.GetPayload().end());
+  auto acl_payload = acl_view.GetPayload();
+  size_t payload_size = acl_payload.size();
   uint16_t acl_buffer_size = properties_.GetAclDataPacketSize();
-  int num_packets =
-      (payload_data.size() + acl_buffer_size - 1) / acl_buffer_size;
+  int num_packets = (payload_size + acl_buffer_size - 1) / acl_buffer_size;
 
   auto pb_flag_controller_to_host = acl_view.GetPacketBoundaryFlag();
   if (pb_flag_controller_to_host ==
@@ -398,14 +438,15 @@ void LinkLayerController::IncomingAclPacket(
     pb_flag_controller_to_host =
         bluetooth::hci::PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE;
   }
+  // Fragment straight out of the view; each fragment is the only copy made
+  // of its slice of the payload.
   for (int i = 0; i < num_packets; i++) {
     size_t start_index = acl_buffer_size * i;
-    size_t end_index =
-        std::min(start_index + acl_buffer_size, payload_data.size());
-    std::vector<uint8_t> fragment(&payload_data[start_index],
-                                  &payload_data[end_index]);
+    size_t end_index = std::min(start_index + acl_buffer_size, payload_size);
+    std::vector<uint8_t> fragment(acl_payload.begin() + start_index,
+                                  acl_payload.begin() + end_index);
     std::unique_ptr<bluetooth::packet::RawBuilder> raw_builder_ptr =
-        std::make_unique<bluetooth::packet::RawBuilder>(fragment);
+        std::make_unique<bluetooth::packet::RawBuilder>(std::move(fragment));
     auto acl_packet = bluetooth::hci::AclBuilder::Create(
         local_handle, pb_flag_controller_to_host, acl_view.GetBroadcastFlag(),
         std::move(raw_builder_ptr));
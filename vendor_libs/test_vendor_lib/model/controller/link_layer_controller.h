@@ -406,6 +406,9 @@ class LinkLayerController {
       model::packets::LinkLayerPacketView packet);
 
  private:
+  void FlushPendingPackets(Phy::Type phy);
+  void QueueCompletedPacket(uint16_t handle);
+
   const DeviceProperties& properties_;
   AclConnectionHandler connections_;
   // Add timestamps?
@@ -435,6 +438,20 @@ class LinkLayerController {
                      Phy::Type phy_type)>
       send_to_remote_;
 
+  // Outgoing link layer packets accumulated while a flush task is pending,
+  // so a burst of traffic costs one scheduled task instead of one per packet.
+  std::vector<std::shared_ptr<model::packets::LinkLayerPacketBuilder>>
+      pending_classic_packets_;
+  std::vector<std::shared_ptr<model::packets::LinkLayerPacketBuilder>>
+      pending_le_packets_;
+  bool classic_flush_scheduled_{false};
+  bool le_flush_scheduled_{false};
+
+  // ACL credits to return to the host, coalesced into a single
+  // Number Of Completed Packets event per flush.
+  std::vector<bluetooth::hci::CompletedPackets> pending_completed_packets_;
+  bool completed_packets_flush_scheduled_{false};
+
   uint32_t oob_id_ = 1;
   uint32_t key_id_ = 1;
 
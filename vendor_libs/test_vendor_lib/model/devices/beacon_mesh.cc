@@ -0,0 +1,142 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "beacon_mesh.h"
+
+#include "model/setup/device_boutique.h"
+
+using std::vector;
+
+namespace test_vendor_lib {
+
+bool BeaconMesh::registered_ =
+    DeviceBoutique::Register("beacon_mesh", &BeaconMesh::Create);
+
+BeaconMesh::BeaconMesh() {
+  advertising_interval_ms_ = std::chrono::milliseconds(1280);
+  properties_.SetLeAdvertisementType(0x03 /* NON_CONNECT */);
+  properties_.SetLeAdvertisement({
+      0x14,  // Length
+      0x09 /* TYPE_NAME_CMPL */,
+      'g',
+      'D',
+      'e',
+      'v',
+      'i',
+      'c',
+      'e',
+      '-',
+      'b',
+      'e',
+      'a',
+      'c',
+      'o',
+      'n',
+      '_',
+      'm',
+      'e',
+      's',
+      'h',
+      0x02,  // Length
+      0x01 /* TYPE_FLAG */,
+      0x4 /* BREDR_NOT_SPT */ | 0x2 /* GEN_DISC_FLAG */,
+  });
+
+  properties_.SetLeScanResponse({0x06,  // Length
+                                 0x08 /* TYPE_NAME_SHORT */, 'm', 'b', 'e', 'a',
+                                 'c'});
+}
+
+std::string BeaconMesh::ToString() const {
+  std::string dev = GetTypeString() + "@" +
+                    properties_.GetLeAddress().ToString() + " x" +
+                    std::to_string(beacon_count_);
+
+  return dev;
+}
+
+void BeaconMesh::Initialize(const vector<std::string>& args) {
+  if (args.size() < 2) return;
+
+  Address addr{};
+  if (Address::FromString(args[1], addr)) properties_.SetLeAddress(addr);
+
+  if (args.size() < 3) return;
+
+  beacon_count_ = std::stoi(args[2]);
+  if (beacon_count_ == 0) beacon_count_ = 1;
+
+  if (args.size() < 4) return;
+
+  SetAdvertisementInterval(std::chrono::milliseconds(std::stoi(args[3])));
+}
+
+Address BeaconMesh::BeaconAddress(size_t index) const {
+  Address addr = properties_.GetLeAddress();
+  uint8_t* addr_bytes = (uint8_t*)(&addr);
+  // Add |index| to the low-order bytes, carrying into the next octet.
+  size_t carry = index;
+  for (size_t octet = 0; octet < Address::kLength && carry != 0; octet++) {
+    carry += addr_bytes[octet];
+    addr_bytes[octet] = carry & 0xff;
+    carry >>= 8;
+  }
+  return addr;
+}
+
+size_t BeaconMesh::IndexOfAddress(const Address& address) const {
+  for (size_t index = 0; index < beacon_count_; index++) {
+    if (BeaconAddress(index) == address) return index;
+  }
+  return beacon_count_;
+}
+
+void BeaconMesh::TimerTick() {
+  if (IsAdvertisementAvailable()) {
+    last_advertisement_ = std::chrono::steady_clock::now();
+    for (size_t index = 0; index < beacon_count_; index++) {
+      auto ad = model::packets::LeAdvertisementBuilder::Create(
+          BeaconAddress(index), Address::kEmpty,
+          model::packets::AddressType::PUBLIC,
+          static_cast<model::packets::AdvertisementType>(
+              properties_.GetLeAdvertisementType()),
+          properties_.GetLeAdvertisement());
+      std::shared_ptr<model::packets::LinkLayerPacketBuilder> to_send =
+          std::move(ad);
+
+      SendLinkLayerPacket(to_send, Phy::Type::LOW_ENERGY);
+    }
+  }
+}
+
+void BeaconMesh::IncomingPacket(model::packets::LinkLayerPacketView packet) {
+  if (packet.GetType() != model::packets::PacketType::LE_SCAN) return;
+
+  size_t index = IndexOfAddress(packet.GetDestinationAddress());
+  if (index == beacon_count_) return;
+
+  auto scan_response = model::packets::LeScanResponseBuilder::Create(
+      BeaconAddress(index), packet.GetSourceAddress(),
+      model::packets::AddressType::PUBLIC,
+      model::packets::AdvertisementType::SCAN_RESPONSE,
+      properties_.GetLeScanResponse());
+  std::shared_ptr<model::packets::LinkLayerPacketBuilder> to_send =
+      std::move(scan_response);
+
+  SendLinkLayerPacket(to_send, Phy::Type::LOW_ENERGY);
+}
+
+}  // namespace test_vendor_lib
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "beacon.h"
+
+namespace test_vendor_lib {
+
+// A whole fleet of beacons behind one device instance. Each advertising
+// interval it emits one advertisement per simulated beacon, with addresses
+// counting up from the base address, and it answers scans for any address
+// in that range. Unlike adding hundreds of individual beacon devices this
+// costs a single device and phy registration, so beacon-dense deployments
+// can be simulated at scale.
+class BeaconMesh : public Beacon {
+ public:
+  BeaconMesh();
+  virtual ~BeaconMesh() = default;
+
+  static std::shared_ptr<Device> Create() {
+    return std::make_shared<BeaconMesh>();
+  }
+
+  // Return a string representation of the type of device.
+  virtual std::string GetTypeString() const override {
+    return "beacon_mesh";
+  }
+
+  // Return a string representation of the device.
+  virtual std::string ToString() const override;
+
+  // Set the base address, beacon count and advertising interval from string
+  // args: "beacon_mesh <base_address> <count> [interval_ms]".
+  virtual void Initialize(const std::vector<std::string>& args) override;
+
+  virtual void IncomingPacket(
+      model::packets::LinkLayerPacketView packet) override;
+
+  virtual void TimerTick() override;
+
+ private:
+  static bool registered_;
+
+  // Address of the |index|th beacon in the mesh.
+  Address BeaconAddress(size_t index) const;
+
+  // Index of |address| in the mesh, or |beacon_count_| when it is not ours.
+  size_t IndexOfAddress(const Address& address) const;
+
+  size_t beacon_count_{1};
+};
+
+}  // namespace test_vendor_lib
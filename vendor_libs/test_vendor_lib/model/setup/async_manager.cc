@@ -272,16 +272,27 @@ class AsyncManager::AsyncTaskManager {
 
   AsyncTaskId ExecAsync(AsyncUserId user_id, std::chrono::milliseconds delay,
                         const TaskCallback& callback) {
-    return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, callback, user_id));
+    return scheduleTask(
+        std::make_shared<Task>(currentTime() + delay, callback, user_id));
   }
 
   AsyncTaskId ExecAsyncPeriodically(AsyncUserId user_id,
                                     std::chrono::milliseconds delay,
                                     std::chrono::milliseconds period,
                                     const TaskCallback& callback) {
-    return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, period, callback, user_id));
+    return scheduleTask(std::make_shared<Task>(currentTime() + delay, period,
+                                               callback, user_id));
+  }
+
+  void SetVirtualTimeMode(bool enabled) {
+    std::unique_lock<std::mutex> guard(internal_mutex_);
+    if (enabled && !virtual_time_enabled_) {
+      // Start the virtual clock where the real one is so that tasks that are
+      // already scheduled keep their relative deadlines.
+      virtual_now_ = std::chrono::steady_clock::now();
+    }
+    virtual_time_enabled_ = enabled;
+    internal_cond_var_.notify_one();
   }
 
   bool CancelAsyncTask(AsyncTaskId async_task_id) {
@@ -416,6 +427,16 @@ class AsyncManager::AsyncTaskManager {
     return tasks_by_id_.count(task_id) != 0;
   }
 
+  std::chrono::steady_clock::time_point currentTime() {
+    std::unique_lock<std::mutex> guard(internal_mutex_);
+    return currentTimeWithLockHeld();
+  }
+
+  std::chrono::steady_clock::time_point currentTimeWithLockHeld() const {
+    return virtual_time_enabled_ ? virtual_now_
+                                 : std::chrono::steady_clock::now();
+  }
+
   int tryStartThread() {
     // need the lock because of the running flag and the cond var
     std::unique_lock<std::mutex> guard(internal_mutex_);
@@ -441,7 +462,12 @@ class AsyncManager::AsyncTaskManager {
         std::unique_lock<std::mutex> guard(internal_mutex_);
         if (!task_queue_.empty()) {
           std::shared_ptr<Task> task_p = *(task_queue_.begin());
-          if (task_p->time < std::chrono::steady_clock::now()) {
+          // In virtual time mode the clock is event driven: jump straight to
+          // the earliest deadline instead of waiting for it to come around.
+          if (virtual_time_enabled_ && task_p->time > virtual_now_) {
+            virtual_now_ = task_p->time;
+          }
+          if (task_p->time <= currentTimeWithLockHeld()) {
             run_it = true;
             callback = task_p->callback;
             task_queue_.erase(task_p);  // need to remove and add again if
@@ -465,6 +491,10 @@ class AsyncManager::AsyncTaskManager {
         if (!running_) break;
         // wait until time for the next task (if any)
         if (task_queue_.size() > 0) {
+          if (virtual_time_enabled_) {
+            // The clock will jump to the next deadline; no waiting needed.
+            continue;
+          }
           // Make a copy of the time_point because wait_until takes a reference
           // to it and may read it after waiting, by which time the task may
           // have been freed (e.g. via CancelAsyncTask).
@@ -485,6 +515,8 @@ class AsyncManager::AsyncTaskManager {
 
   AsyncTaskId lastTaskId_ = kInvalidTaskId;
   AsyncUserId lastUserId_{1};
+  bool virtual_time_enabled_ = false;
+  std::chrono::steady_clock::time_point virtual_now_;
   std::map<AsyncTaskId, std::shared_ptr<Task> > tasks_by_id_;
   std::map<AsyncUserId, std::set<AsyncTaskId>> tasks_by_user_id_;
   std::set<std::shared_ptr<Task>, task_p_comparator> task_queue_;
@@ -538,6 +570,10 @@ bool AsyncManager::CancelAsyncTasksFromUser(
   return taskManager_p_->CancelAsyncTasksFromUser(user_id);
 }
 
+void AsyncManager::SetVirtualTimeMode(bool enabled) {
+  taskManager_p_->SetVirtualTimeMode(enabled);
+}
+
 void AsyncManager::Synchronize(const CriticalCallback& critical) {
   std::unique_lock<std::mutex> guard(synchronization_mutex_);
   critical();
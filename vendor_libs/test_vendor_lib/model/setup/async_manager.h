@@ -89,6 +89,16 @@ class AsyncManager {
   // cancellation.
   bool CancelAsyncTasksFromUser(AsyncUserId user_id);
 
+  // Switches the task scheduler between real time and virtual time. In
+  // virtual time mode the clock is event driven: whenever the scheduler has
+  // pending tasks it jumps straight to the earliest deadline instead of
+  // sleeping until it, so long simulated scenarios run as fast as their
+  // callbacks execute. Tasks that are already scheduled keep their relative
+  // deadlines. The mode is meant to be selected once per simulation run;
+  // switching back to real time leaves pending virtual deadlines in the
+  // future of the real clock.
+  void SetVirtualTimeMode(bool enabled);
+
   // Execs the given code in a synchronized manner. It is guaranteed that code
   // given on (possibly)concurrent calls to this member function on the same
   // AsyncManager object will never be executed simultaneously. It is the
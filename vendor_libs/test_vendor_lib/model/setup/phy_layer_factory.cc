@@ -77,6 +77,10 @@ void PhyLayerFactory::Send(
 
 void PhyLayerFactory::Send(model::packets::LinkLayerPacketView packet,
                            uint32_t id) {
+  if (batching_) {
+    pending_packets_.emplace_back(packet, id);
+    return;
+  }
   for (const auto& phy : phy_layers_) {
     if (id != phy->GetId()) {
       phy->Receive(packet);
@@ -84,6 +88,22 @@ void PhyLayerFactory::Send(model::packets::LinkLayerPacketView packet,
   }
 }
 
+void PhyLayerFactory::StartBatch() {
+  batching_ = true;
+}
+
+void PhyLayerFactory::FlushBatch() {
+  batching_ = false;
+  // Deliver from a local copy so that packets sent from Receive() go out
+  // immediately rather than growing the batch.
+  std::vector<std::pair<model::packets::LinkLayerPacketView, uint32_t>>
+      pending;
+  pending.swap(pending_packets_);
+  for (auto& packet : pending) {
+    Send(packet.first, packet.second);
+  }
+}
+
 void PhyLayerFactory::TimerTick() {
   for (auto& phy : phy_layers_) {
     phy->TimerTick();
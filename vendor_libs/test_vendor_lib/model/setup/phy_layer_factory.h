@@ -49,6 +49,14 @@ class PhyLayerFactory {
 
   virtual void TimerTick();
 
+  // Queue packets sent between StartBatch() and FlushBatch() instead of
+  // delivering each one as it is sent.  Ticking a dense population of
+  // devices (e.g. a beacon_mesh) then costs one delivery pass per tick
+  // rather than one per packet.  Packets sent while flushing (responses)
+  // are delivered immediately.
+  void StartBatch();
+  void FlushBatch();
+
   virtual std::string ToString() const;
 
  protected:
@@ -60,6 +68,9 @@ class PhyLayerFactory {
  private:
   Phy::Type phy_type_;
   std::list<std::shared_ptr<PhyLayer>> phy_layers_;
+  bool batching_{false};
+  std::vector<std::pair<model::packets::LinkLayerPacketView, uint32_t>>
+      pending_packets_;
   uint32_t next_id_{1};
   const uint32_t factory_id_;
 };
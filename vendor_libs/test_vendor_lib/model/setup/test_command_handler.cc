@@ -49,6 +49,7 @@ TestCommandHandler::TestCommandHandler(TestModel& test_model) : model_(test_mode
   SET_HANDLER("set_timer_period", SetTimerPeriod);
   SET_HANDLER("start_timer", StartTimer);
   SET_HANDLER("stop_timer", StopTimer);
+  SET_HANDLER("set_virtual_time", SetVirtualTime);
   SET_HANDLER("reset", Reset);
 #undef SET_HANDLER
 }
@@ -285,6 +286,20 @@ void TestCommandHandler::StopTimer(const vector<std::string>& args) {
   send_response_(response_string_);
 }
 
+void TestCommandHandler::SetVirtualTime(const vector<std::string>& args) {
+  if (args.size() != 1) {
+    LOG_INFO("SetVirtualTime takes 1 argument");
+    response_string_ = "set_virtual_time takes 1 argument";
+    send_response_(response_string_);
+    return;
+  }
+  bool enabled = std::stoi(args[0]) != 0;
+  model_.SetVirtualTimeMode(enabled);
+  response_string_ =
+      enabled ? "virtual time enabled" : "virtual time disabled";
+  send_response_(response_string_);
+}
+
 void TestCommandHandler::Reset(const std::vector<std::string>& args) {
   if (args.size() > 0) {
     LOG_INFO("Unused args: arg[0] = %s", args[0].c_str());
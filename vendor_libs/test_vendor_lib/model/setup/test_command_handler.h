@@ -82,6 +82,9 @@ class TestCommandHandler {
 
   void StopTimer(const std::vector<std::string>& args);
 
+  // Switch the scheduler between real time and event-driven virtual time
+  void SetVirtualTime(const std::vector<std::string>& args);
+
   void Reset(const std::vector<std::string>& args);
 
   // For manual testing
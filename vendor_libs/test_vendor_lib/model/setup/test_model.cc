@@ -97,6 +97,16 @@ void TestModel::StopTimer() {
   timer_tick_task_ = kInvalidTaskId;
 }
 
+void TestModel::RegisterVirtualTimeControl(
+    std::function<void(bool)> set_virtual_time) {
+  set_virtual_time_ = std::move(set_virtual_time);
+}
+
+void TestModel::SetVirtualTimeMode(bool enabled) {
+  LOG_INFO("SetVirtualTimeMode(%d)", enabled);
+  set_virtual_time_(enabled);
+}
+
 size_t TestModel::Add(std::shared_ptr<Device> new_dev) {
   devices_.push_back(std::move(new_dev));
   return devices_.size() - 1;
@@ -256,11 +266,19 @@ const std::string& TestModel::List() {
 }
 
 void TestModel::TimerTick() {
+  // Batch the packets sent while ticking so a dense device population does
+  // one delivery pass per phy per tick instead of one per packet.
+  for (auto& phy : phys_) {
+    phy.StartBatch();
+  }
   for (size_t i = 0; i < devices_.size(); i++) {
     if (devices_[i] != nullptr) {
       devices_[i]->TimerTick();
     }
   }
+  for (auto& phy : phys_) {
+    phy.FlushBatch();
+  }
 }
 
 void TestModel::Reset() {
@@ -88,6 +88,14 @@ class TestModel {
   void StopTimer();
   void SetTimerPeriod(std::chrono::milliseconds new_period);
 
+  // Register the scheduler's virtual time toggle so the test channel can
+  // switch it at runtime. Without a registered control the command is a
+  // no-op.
+  void RegisterVirtualTimeControl(std::function<void(bool)> set_virtual_time);
+
+  // Switch the scheduler between real time and event-driven virtual time.
+  void SetVirtualTimeMode(bool enabled);
+
   // List the devices that the test knows about
   const std::string& List();
 
@@ -110,6 +118,7 @@ class TestModel {
   std::function<void(AsyncTaskId)> cancel_task_;
   std::function<void(AsyncUserId)> cancel_tasks_from_user_;
   std::function<int(const std::string&, int)> connect_to_remote_;
+  std::function<void(bool)> set_virtual_time_{[](bool) {}};
 
   AsyncUserId model_user_id_;
   AsyncTaskId timer_tick_task_{kInvalidTaskId};
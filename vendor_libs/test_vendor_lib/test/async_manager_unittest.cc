@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 #include <cstdint>
 #include <cstring>
+#include <future>
 #include <vector>
 #include <netdb.h>
 #include <netinet/in.h>
@@ -251,4 +252,41 @@ TEST_F(AsyncManagerTest, TestCancelAsyncTasksFromUser) {
   ASSERT_FALSE(async_manager_.CancelAsyncTask(task5_id));
 }
 
+TEST_F(AsyncManagerTest, TestVirtualTimeRunsLongDelaysImmediately) {
+  async_manager_.SetVirtualTimeMode(true);
+  AsyncUserId user1 = async_manager_.GetNextUserId();
+  std::promise<void> promise;
+  std::future<void> future = promise.get_future();
+  // An hour of simulated delay should elapse in well under a second.
+  async_manager_.ExecAsync(user1, std::chrono::hours(1),
+                           [&promise]() { promise.set_value(); });
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(10)),
+            std::future_status::ready);
+  async_manager_.SetVirtualTimeMode(false);
+}
+
+TEST_F(AsyncManagerTest, TestVirtualTimePreservesTaskOrder) {
+  async_manager_.SetVirtualTimeMode(true);
+  AsyncUserId user1 = async_manager_.GetNextUserId();
+  std::vector<int> order;
+  std::promise<void> promise;
+  std::future<void> future = promise.get_future();
+  // Schedule from inside a task so all three are queued before the virtual
+  // clock jumps to the first deadline.
+  async_manager_.ExecAsync(user1, std::chrono::milliseconds(0), [&]() {
+    async_manager_.ExecAsync(user1, std::chrono::minutes(45),
+                             [&order]() { order.push_back(2); });
+    async_manager_.ExecAsync(user1, std::chrono::minutes(30),
+                             [&order]() { order.push_back(1); });
+    async_manager_.ExecAsync(user1, std::chrono::minutes(60), [&]() {
+      order.push_back(3);
+      promise.set_value();
+    });
+  });
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(10)),
+            std::future_status::ready);
+  ASSERT_EQ(order, (std::vector<int>{1, 2, 3}));
+  async_manager_.SetVirtualTimeMode(false);
+}
+
 }  // namespace test_vendor_lib